@@ -5,8 +5,12 @@
 #pragma once
 
 #include "app/App.h"
+#include "core/Common.h"
+#include "core/SharedPtr.h"
+#include "core/concurrent/Atomic.h"
 #include "core/concurrent/ThreadPool.h"
 #include <future>
+#include <thread>
 
 namespace app {
 
@@ -16,4 +20,54 @@ auto async(F &&f, Args &&...args) -> std::future<typename std::invoke_result<F,
 	return app::App::getInstance()->threadPool().enqueue(core::forward<F>(f), core::forward<Args>(args)...);
 }
 
+/**
+ * @brief Split the range @c [start, end) into chunks and execute the given functor for each of them on the thread
+ * pool of the application. The functor is called as @c f(chunkStart, chunkEnd) with @c chunkEnd being exclusive.
+ *
+ * The calling thread is processing chunks, too - and the function only returns once all chunks were processed. As
+ * the caller doesn't wait for the pool tasks themselves, this is also safe to call from within a task of the pool.
+ */
+template<class F>
+void for_parallel(int start, int end, F &&f) {
+	const int n = end - start;
+	if (n <= 0) {
+		return;
+	}
+	App *app = App::getInstance();
+	const int threads = app == nullptr ? 1 : (int)app->threadPool().size();
+	if (threads <= 1 || n == 1) {
+		f(start, end);
+		return;
+	}
+	struct State {
+		core::AtomicInt next{0};
+		core::AtomicInt done{0};
+	};
+	const int chunks = core_min(n, threads * 4);
+	const int chunkSize = (n + chunks - 1) / chunks;
+	const int chunkCount = (n + chunkSize - 1) / chunkSize;
+	core::SharedPtr<State> state = core::make_shared<State>();
+	// the functor is only accessed for claimed chunks - the caller doesn't return before they are done
+	F *func = &f;
+	auto work = [state, func, start, end, chunkSize, chunkCount]() {
+		for (;;) {
+			const int chunk = state->next.increment(1);
+			if (chunk >= chunkCount) {
+				return;
+			}
+			const int chunkStart = start + chunk * chunkSize;
+			(*func)(chunkStart, core_min(chunkStart + chunkSize, end));
+			state->done.increment(1);
+		}
+	};
+	const int helpers = core_min(threads, chunkCount) - 1;
+	for (int i = 0; i < helpers; ++i) {
+		app->threadPool().enqueue(work);
+	}
+	work();
+	while (state->done < chunkCount) {
+		std::this_thread::yield();
+	}
+}
+
 } // namespace app
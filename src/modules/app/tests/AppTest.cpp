@@ -3,6 +3,7 @@
  */
 
 #include "app/App.h"
+#include "app/Async.h"
 #include "core/TimeProvider.h"
 #include "core/ArrayLength.h"
 #include "io/Filesystem.h"
@@ -12,9 +13,9 @@ namespace app {
 
 class TestApp : public App {
 public:
-	TestApp(int argc = 0, const char *args[] = nullptr)
+	TestApp(int argc = 0, const char *args[] = nullptr, size_t threadPoolSize = 1)
 		: App(core::make_shared<io::Filesystem>(),
-			  core::make_shared<core::TimeProvider>()) {
+			  core::make_shared<core::TimeProvider>(), threadPoolSize) {
 		setArgs(argc, (char **)args);
 	}
 	bool createPid() override {
@@ -76,4 +77,23 @@ TEST(AppTest, testArgumentDefaultValue) {
 	EXPECT_EQ("defaultval", app.getArgVal("--test"));
 }
 
+TEST(AppTest, testForParallel) {
+	TestApp app(0, nullptr, 4);
+	ASSERT_EQ(app::AppState::Init, app.onConstruct());
+	ASSERT_EQ(app::AppState::Running, app.onInit());
+	core::AtomicInt visited[1000];
+	app::for_parallel(0, lengthof(visited), [&](int start, int end) {
+		for (int i = start; i < end; ++i) {
+			visited[i].increment(1);
+		}
+	});
+	for (int i = 0; i < lengthof(visited); ++i) {
+		ASSERT_EQ(1, (int)visited[i]) << "index " << i;
+	}
+	int calls = 0;
+	app::for_parallel(5, 5, [&](int, int) { ++calls; });
+	EXPECT_EQ(0, calls);
+	app.onCleanup();
+}
+
 } // namespace app
@@ -23,6 +23,7 @@
 #define GLM_ENABLE_EXPERIMENTAL
 #endif
 #include <glm/gtx/color_space.hpp>
+#include <glm/gtx/norm.hpp>
 #include <glm/gtx/type_aligned.hpp>
 
 #include <SDL.h>
@@ -159,24 +160,72 @@ Color::ColorReductionType Color::toColorReductionType(const char *str) {
 	return ColorReductionType::Max;
 }
 
+struct WeightedRGBA {
+	RGBA color;
+	uint32_t weight;
+};
+
 struct ColorBox {
 	RGBA min, max;
-	core::Buffer<RGBA> pixels;
+	core::Buffer<WeightedRGBA> pixels;
+	// the sum of the weights of all pixels
+	uint64_t weight = 0u;
+
+	void add(const WeightedRGBA &pixel) {
+		pixels.push_back(pixel);
+		weight += pixel.weight;
+	}
 };
 
-static int medianCutFindMedian(const core::Buffer<RGBA> &colors, int axis) {
-	core::Buffer<int> values;
-	for (const core::RGBA &color : colors) {
-		if (axis == 0) {
-			values.push_back(color.r);
-		} else if (axis == 1) {
-			values.push_back(color.g);
-		} else {
-			values.push_back(color.b);
+static ColorBox createColorBox(const RGBA *inputBuf, const uint32_t *inputWeights, size_t inputBufColors) {
+	ColorBox box;
+	box.min = RGBA(0, 0, 0, 255);
+	box.max = RGBA(255, 255, 255, 255);
+	box.pixels.reserve(inputBufColors);
+	for (size_t i = 0; i < inputBufColors; ++i) {
+		box.add({inputBuf[i], inputWeights == nullptr ? 1u : inputWeights[i]});
+	}
+	return box;
+}
+
+static RGBA weightedAverage(const ColorBox &box) {
+	uint64_t r = 0, g = 0, b = 0, a = 0;
+	for (const WeightedRGBA &pixel : box.pixels) {
+		r += (uint64_t)pixel.color.r * pixel.weight;
+		g += (uint64_t)pixel.color.g * pixel.weight;
+		b += (uint64_t)pixel.color.b * pixel.weight;
+		a += (uint64_t)pixel.color.a * pixel.weight;
+	}
+	const uint64_t weight = core_max(box.weight, (uint64_t)1u);
+	return RGBA((uint8_t)(r / weight), (uint8_t)(g / weight), (uint8_t)(b / weight), (uint8_t)(a / weight));
+}
+
+static inline uint8_t colorComponent(const RGBA &color, int axis) {
+	if (axis == 0) {
+		return color.r;
+	}
+	if (axis == 1) {
+		return color.g;
+	}
+	return color.b;
+}
+
+/**
+ * @return The weighted median of the given color component - the channel histogram replaces sorting the pixels
+ */
+static int medianCutFindMedian(const ColorBox &box, int axis) {
+	uint64_t histogram[256]{};
+	for (const WeightedRGBA &pixel : box.pixels) {
+		histogram[colorComponent(pixel.color, axis)] += pixel.weight;
+	}
+	uint64_t sum = 0u;
+	for (int i = 0; i < 256; ++i) {
+		sum += histogram[i];
+		if (sum * 2u > box.weight) {
+			return i;
 		}
 	}
-	core::sort(values.begin(), values.end(), core::Less<int>());
-	return values[values.size() / 2];
+	return 255;
 }
 
 static core::Pair<ColorBox, ColorBox> medianCutSplitBox(const ColorBox &box) {
@@ -188,27 +237,22 @@ static core::Pair<ColorBox, ColorBox> medianCutSplitBox(const ColorBox &box) {
 		longestAxis = 2;
 	}
 
-	int median = medianCutFindMedian(box.pixels, longestAxis);
+	// a single heavy color may hold the weighted median at the lower end - keep both boxes populated
+	int minValue = 255;
+	int maxValue = 0;
+	for (const WeightedRGBA &pixel : box.pixels) {
+		const int v = colorComponent(pixel.color, longestAxis);
+		minValue = core_min(minValue, v);
+		maxValue = core_max(maxValue, v);
+	}
+	const int median =
+		glm::clamp(medianCutFindMedian(box, longestAxis), minValue + 1, core_max(minValue + 1, maxValue));
 	ColorBox box1, box2;
-	for (const core::RGBA &color : box.pixels) {
-		if (longestAxis == 0) {
-			if (color.r < median) {
-				box1.pixels.push_back(color);
-			} else {
-				box2.pixels.push_back(color);
-			}
-		} else if (longestAxis == 1) {
-			if (color.g < median) {
-				box1.pixels.push_back(color);
-			} else {
-				box2.pixels.push_back(color);
-			}
+	for (const WeightedRGBA &pixel : box.pixels) {
+		if (colorComponent(pixel.color, longestAxis) < median) {
+			box1.add(pixel);
 		} else {
-			if (color.b < median) {
-				box1.pixels.push_back(color);
-			} else {
-				box2.pixels.push_back(color);
-			}
+			box2.add(pixel);
 		}
 	}
 
@@ -240,22 +284,24 @@ static core::Pair<ColorBox, ColorBox> medianCutSplitBox(const ColorBox &box) {
 	return core::Pair{box1, box2};
 }
 
-static int quantizeMedianCut(RGBA *targetBuf, size_t maxTargetBufColors, const RGBA *inputBuf, size_t inputBufColors) {
-	core::Buffer<RGBA> pixels;
-	pixels.append(inputBuf, inputBufColors);
-
+static int quantizeMedianCut(RGBA *targetBuf, size_t maxTargetBufColors, const RGBA *inputBuf,
+							 const uint32_t *inputWeights, size_t inputBufColors) {
 	core::DynamicArray<ColorBox> boxes;
-	boxes.emplace_back(ColorBox{{0, 0, 0, 255}, {255, 255, 255, 255}, pixels});
+	boxes.emplace_back(createColorBox(inputBuf, inputWeights, inputBufColors));
 
 	while (boxes.size() < maxTargetBufColors) {
-		size_t maxSize = 0;
-		size_t maxIndex = 0;
+		uint64_t maxWeight = 0;
+		int maxIndex = -1;
 		for (size_t i = 0; i < boxes.size(); ++i) {
-			if (boxes[i].pixels.size() > maxSize) {
-				maxSize = boxes[i].pixels.size();
-				maxIndex = i;
+			// a box with only one unique color can't get split any further
+			if (boxes[i].pixels.size() > 1 && boxes[i].weight > maxWeight) {
+				maxWeight = boxes[i].weight;
+				maxIndex = (int)i;
 			}
 		}
+		if (maxIndex == -1) {
+			break;
+		}
 
 		// Split the most populated box.
 		core::Pair<ColorBox, ColorBox> boxesPair = medianCutSplitBox(boxes[maxIndex]);
@@ -269,18 +315,7 @@ static int quantizeMedianCut(RGBA *targetBuf, size_t maxTargetBufColors, const R
 		if (box.pixels.empty()) {
 			continue;
 		}
-		uint32_t r = 0, g = 0, b = 0, a = 0;
-		for (const core::RGBA &color : box.pixels) {
-			r += color.r;
-			g += color.g;
-			b += color.b;
-			a += color.a;
-		}
-		r /= box.pixels.size();
-		g /= box.pixels.size();
-		b /= box.pixels.size();
-		a /= box.pixels.size();
-		targetBuf[n++] = core::RGBA(r, g, b, a);
+		targetBuf[n++] = weightedAverage(box);
 		if (n >= maxTargetBufColors) {
 			return (int)n;
 		}
@@ -291,12 +326,14 @@ static int quantizeMedianCut(RGBA *targetBuf, size_t maxTargetBufColors, const R
 	return (int)n;
 }
 
-static int quantizeOctree(RGBA *targetBuf, size_t maxTargetBufColors, const RGBA *inputBuf, size_t inputBufColors) {
+static int quantizeOctree(RGBA *targetBuf, size_t maxTargetBufColors, const RGBA *inputBuf,
+						  const uint32_t *inputWeights, size_t inputBufColors) {
 	core_assert(glm::isPowerOfTwo(maxTargetBufColors));
 	using BBox = math::AABB<uint8_t>;
 	struct ColorNode {
-		inline ColorNode(core::RGBA c) : color(c){};
+		inline ColorNode(core::RGBA c, uint32_t w) : color(c), weight(w){};
 		core::RGBA color;
+		uint32_t weight;
 		inline BBox aabb() const {
 			return BBox(color.r, color.g, color.b, color.r + 1, color.g + 1, color.b + 1);
 		}
@@ -305,7 +342,7 @@ static int quantizeOctree(RGBA *targetBuf, size_t maxTargetBufColors, const RGBA
 	using Tree = math::Octree<ColorNode, uint8_t>;
 	Tree octree(aabb, 32);
 	for (size_t i = 0; i < inputBufColors; ++i) {
-		octree.insert(inputBuf[i]);
+		octree.insert(ColorNode(inputBuf[i], inputWeights == nullptr ? 1u : inputWeights[i]));
 	}
 	size_t n = 0;
 	const glm::ivec3 dim(8);
@@ -322,7 +359,14 @@ static int quantizeOctree(RGBA *targetBuf, size_t maxTargetBufColors, const RGBA
 				if (k == 0) {
 					continue;
 				}
-				targetBuf[n++] = contents.front().color;
+				// the most frequent color of the cell represents it
+				const ColorNode *best = &contents.front();
+				for (const ColorNode &node : contents) {
+					if (node.weight > best->weight) {
+						best = &node;
+					}
+				}
+				targetBuf[n++] = best->color;
 				if (n >= maxTargetBufColors) {
 					return (int)n;
 				}
@@ -339,42 +383,100 @@ static inline float getDistance(const glm::vec4 &p1, const glm::vec4 &p2) {
 	return glm::length(p1 - p2);
 }
 
-static int quantizeKMeans(RGBA *targetBuf, size_t maxTargetBufColors, const RGBA *inputBuf, size_t inputBufColors) {
+struct KMeansCluster {
+	glm::dvec4 sum{0.0};
+	double weight = 0.0;
+};
+using KMeansClusters = core::DynamicArray<KMeansCluster>;
+
+/**
+ * @brief Assigns the points of the given range to their closest center and accumulates the weighted sums per cluster
+ */
+static void kmeansAssign(const core::DynamicArray<glm::vec4> &points, const uint32_t *inputWeights,
+						 const core::DynamicArray<glm::vec4> &centers, size_t start, size_t end,
+						 KMeansClusters &clusters) {
+	clusters.resize(centers.size());
+	clusters.fill(KMeansCluster());
+	for (size_t i = start; i < end; ++i) {
+		const glm::vec4 &point = points[i];
+		int closest = 0;
+		// the squared distance is enough to find the closest center
+		float closestDistance = glm::length2(point - centers[0]);
+		for (int n = 1; n < (int)centers.size(); n++) {
+			float d = glm::length2(point - centers[n]);
+			if (d < closestDistance) {
+				closest = n;
+				closestDistance = d;
+			}
+		}
+		const double weight = inputWeights == nullptr ? 1.0 : (double)inputWeights[i];
+		clusters[closest].sum += glm::dvec4(point) * weight;
+		clusters[closest].weight += weight;
+	}
+}
+
+struct KMeansTasks {
+	const core::DynamicArray<glm::vec4> &points;
+	const uint32_t *inputWeights;
+	const core::DynamicArray<glm::vec4> &centers;
+	core::DynamicArray<KMeansClusters> &taskClusters;
+	size_t pointsPerTask;
+};
+
+static void kmeansAssignTasks(int start, int end, void *userdata) {
+	KMeansTasks *ctx = (KMeansTasks *)userdata;
+	const size_t pointCount = ctx->points.size();
+	for (int t = start; t < end; ++t) {
+		const size_t pointsStart = (size_t)t * ctx->pointsPerTask;
+		const size_t pointsEnd = core_min(pointsStart + ctx->pointsPerTask, pointCount);
+		kmeansAssign(ctx->points, ctx->inputWeights, ctx->centers, pointsStart, pointsEnd, ctx->taskClusters[t]);
+	}
+}
+
+static int quantizeKMeans(RGBA *targetBuf, size_t maxTargetBufColors, const RGBA *inputBuf,
+						  const uint32_t *inputWeights, size_t inputBufColors, Color::ParallelFor parallelFor) {
 	core::DynamicArray<glm::vec4> centers;
 	centers.resize(maxTargetBufColors);
-	std::random_device rd;
-	std::mt19937 gen(rd());
+	// a fixed seed - the same input must always give the same palette
+	std::mt19937 gen(5489u);
 	std::uniform_int_distribution<> dis(0, (int)inputBufColors - 1);
 	for (int i = 0; i < (int)maxTargetBufColors; i++) {
 		centers[i] = core::Color::fromRGBA(inputBuf[dis(gen)]);
 	}
+	core::DynamicArray<glm::vec4> points;
+	points.reserve(inputBufColors);
+	for (size_t i = 0; i < inputBufColors; ++i) {
+		points.push_back(core::Color::fromRGBA(inputBuf[i]));
+	}
+
+	// the assignment step is the expensive part - the points are split into blocks of a fixed size that are merged
+	// in a fixed order. The blocks don't depend on the amount of threads to get the same sums with and without the
+	// parallel for.
+	const size_t pointsPerTask = 4096;
+	const size_t tasks = core_max((inputBufColors + pointsPerTask - 1) / pointsPerTask, (size_t)1);
+	core::DynamicArray<KMeansClusters> taskClusters(tasks);
+	KMeansTasks ctx{points, inputWeights, centers, taskClusters, pointsPerTask};
 
 	bool changed = true;
 	while (changed) {
 		changed = false;
-		core::DynamicArray<core::DynamicArray<glm::vec4>> clusters(maxTargetBufColors);
-		for (size_t i = 0; i < inputBufColors; ++i) {
-			const glm::vec4 point = core::Color::fromRGBA(inputBuf[i]);
-			int closest = 0;
-			float closestDistance = getDistance(point, centers[0]);
-			for (int n = 1; n < (int)maxTargetBufColors; n++) {
-				float d = getDistance(point, centers[n]);
-				if (d < closestDistance) {
-					closest = n;
-					closestDistance = d;
-				}
+		if (tasks > 1 && parallelFor != nullptr) {
+			parallelFor(0, (int)tasks, kmeansAssignTasks, &ctx);
+		} else {
+			kmeansAssignTasks(0, (int)tasks, &ctx);
+		}
+		for (size_t t = 1; t < tasks; ++t) {
+			for (int i = 0; i < (int)maxTargetBufColors; i++) {
+				taskClusters[0][i].sum += taskClusters[t][i].sum;
+				taskClusters[0][i].weight += taskClusters[t][i].weight;
 			}
-			clusters[closest].push_back(point);
 		}
 		for (int i = 0; i < (int)maxTargetBufColors; i++) {
-			if (clusters[i].empty()) {
+			const KMeansCluster &cluster = taskClusters[0][i];
+			if (cluster.weight <= 0.0) {
 				continue;
 			}
-			glm::vec4 newCenter(0.0f);
-			for (const glm::vec4 &point : clusters[i]) {
-				newCenter += point;
-			}
-			newCenter /= clusters[i].size();
+			const glm::vec4 newCenter(cluster.sum / cluster.weight);
 			if (getDistance(newCenter, centers[i]) > 0.0001f) {
 				centers[i] = newCenter;
 				changed = true;
@@ -393,11 +495,41 @@ static int quantizeKMeans(RGBA *targetBuf, size_t maxTargetBufColors, const RGBA
 }
 
 // Based on NeuQuant algorithm from jo_gif_quantize
-static int quantizeNeuQuant(RGBA *targetBuf, size_t maxTargetBufColors, const RGBA *inputBuf, size_t inputBufColors) {
+static int quantizeNeuQuant(RGBA *targetBuf, size_t maxTargetBufColors, const RGBA *inputBuf,
+							const uint32_t *inputWeights, size_t inputBufColors) {
 	const int numColors = (int)maxTargetBufColors;
 	const int rgbaSize = (int)inputBufColors;
 	int sample = 1;
 
+	// with weights the samples are picked proportional to the weights of the colors instead of stepping through the
+	// unique colors - the amount of samples doesn't change
+	core::DynamicArray<uint64_t> cumulativeWeights;
+	if (inputWeights != nullptr) {
+		cumulativeWeights.reserve(inputBufColors);
+		uint64_t sum = 0u;
+		for (size_t i = 0; i < inputBufColors; ++i) {
+			sum += inputWeights[i];
+			cumulativeWeights.push_back(sum);
+		}
+	}
+	auto sampleColor = [&](int pix) -> const RGBA & {
+		if (cumulativeWeights.empty()) {
+			return inputBuf[pix];
+		}
+		const uint64_t pos = (uint64_t)((double)pix / (double)rgbaSize * (double)cumulativeWeights.back());
+		size_t lo = 0;
+		size_t hi = cumulativeWeights.size();
+		while (lo < hi) {
+			const size_t mid = (lo + hi) / 2;
+			if (cumulativeWeights[mid] <= pos) {
+				lo = mid + 1;
+			} else {
+				hi = mid;
+			}
+		}
+		return inputBuf[core_min(lo, inputBufColors - 1)];
+	};
+
 	// defs for freq and bias
 	const int intbiasshift = 16; /* bias for fractions */
 	const int intbias = (((int)1) << intbiasshift);
@@ -457,9 +589,10 @@ static int quantizeNeuQuant(RGBA *targetBuf, size_t maxTargetBufColors, const RG
 
 		// Randomly walk through the pixels and relax neurons to the "optimal" target.
 		for (int i = 0, pix = 0; i < samplepixels;) {
-			int r = inputBuf[pix].r << 4;
-			int g = inputBuf[pix].g << 4;
-			int b = inputBuf[pix].b << 4;
+			const RGBA &color = sampleColor(pix);
+			int r = color.r << 4;
+			int g = color.g << 4;
+			int b = color.b << 4;
 			int j = -1;
 			{
 				// finds closest neuron (min dist) and updates freq
@@ -538,13 +671,11 @@ static int quantizeNeuQuant(RGBA *targetBuf, size_t maxTargetBufColors, const RG
 	return numColors;
 }
 
-static int quantizeWu(RGBA *targetBuf, size_t maxTargetBufColors, const RGBA *inputBuf, size_t inputBufColors) {
-	core::Buffer<RGBA> pixels;
-	pixels.append(inputBuf, inputBufColors);
-
+static int quantizeWu(RGBA *targetBuf, size_t maxTargetBufColors, const RGBA *inputBuf, const uint32_t *inputWeights,
+					  size_t inputBufColors) {
 	// Initialize the set of boxes with the full color range
 	core::DynamicArray<ColorBox> boxes;
-	boxes.emplace_back(ColorBox{{0, 0, 0, 255}, {255, 255, 255, 255}, pixels});
+	boxes.emplace_back(createColorBox(inputBuf, inputWeights, inputBufColors));
 
 	// Iterate until we reach the desired number of boxes
 	while (boxes.size() < maxTargetBufColors) {
@@ -590,11 +721,11 @@ static int quantizeWu(RGBA *targetBuf, size_t maxTargetBufColors, const RGBA *in
 			box1.max = RGBA(midpoint, box.max.g, box.max.b, 255);
 			box2.min = RGBA(midpoint + 1, box.min.g, box.min.b, 255);
 			box2.max = box.max;
-			for (const RGBA &pixel : box.pixels) {
-				if (pixel.r <= midpoint) {
-					box1.pixels.push_back(pixel);
+			for (const WeightedRGBA &pixel : box.pixels) {
+				if (pixel.color.r <= midpoint) {
+					box1.add(pixel);
 				} else {
-					box2.pixels.push_back(pixel);
+					box2.add(pixel);
 				}
 			}
 			break;
@@ -603,11 +734,11 @@ static int quantizeWu(RGBA *targetBuf, size_t maxTargetBufColors, const RGBA *in
 			box1.max = RGBA(box.max.r, midpoint, box.max.b, 255);
 			box2.min = RGBA(box.min.r, midpoint + 1, box.min.b, 255);
 			box2.max = box.max;
-			for (const RGBA &pixel : box.pixels) {
-				if (pixel.g <= midpoint) {
-					box1.pixels.push_back(pixel);
+			for (const WeightedRGBA &pixel : box.pixels) {
+				if (pixel.color.g <= midpoint) {
+					box1.add(pixel);
 				} else {
-					box2.pixels.push_back(pixel);
+					box2.add(pixel);
 				}
 			}
 			break;
@@ -616,11 +747,11 @@ static int quantizeWu(RGBA *targetBuf, size_t maxTargetBufColors, const RGBA *in
 			box1.max = RGBA(box.max.r, box.max.g, midpoint);
 			box2.min = RGBA(box.min.r, box.min.g, midpoint + 1);
 			box2.max = box.max;
-			for (const RGBA &pixel : box.pixels) {
-				if (pixel.b <= midpoint) {
-					box1.pixels.push_back(pixel);
+			for (const WeightedRGBA &pixel : box.pixels) {
+				if (pixel.color.b <= midpoint) {
+					box1.add(pixel);
 				} else {
-					box2.pixels.push_back(pixel);
+					box2.add(pixel);
 				}
 			}
 			break;
@@ -637,15 +768,8 @@ static int quantizeWu(RGBA *targetBuf, size_t maxTargetBufColors, const RGBA *in
 		if (box.pixels.empty()) {
 			continue;
 		}
-		RGBA average(0, 0, 0, 255);
-		for (const RGBA &pixel : box.pixels) {
-			average.r += pixel.r;
-			average.g += pixel.g;
-			average.b += pixel.b;
-		}
-		average.r /= box.pixels.size();
-		average.g /= box.pixels.size();
-		average.b /= box.pixels.size();
+		RGBA average = weightedAverage(box);
+		average.a = 255;
 		targetBuf[n++] = average;
 	}
 
@@ -657,6 +781,11 @@ static int quantizeWu(RGBA *targetBuf, size_t maxTargetBufColors, const RGBA *in
 
 int Color::quantize(RGBA *targetBuf, size_t maxTargetBufColors, const RGBA *inputBuf, size_t inputBufColors,
 					ColorReductionType type) {
+	return quantize(targetBuf, maxTargetBufColors, inputBuf, nullptr, inputBufColors, type);
+}
+
+int Color::quantize(RGBA *targetBuf, size_t maxTargetBufColors, const RGBA *inputBuf, const uint32_t *inputWeights,
+					size_t inputBufColors, ColorReductionType type, ParallelFor parallelFor) {
 	if (inputBufColors <= maxTargetBufColors) {
 		size_t n;
 		for (n = 0; n < inputBufColors; ++n) {
@@ -669,15 +798,15 @@ int Color::quantize(RGBA *targetBuf, size_t maxTargetBufColors, const RGBA *inpu
 	}
 	switch (type) {
 	case ColorReductionType::Wu:
-		return quantizeWu(targetBuf, maxTargetBufColors, inputBuf, inputBufColors);
+		return quantizeWu(targetBuf, maxTargetBufColors, inputBuf, inputWeights, inputBufColors);
 	case ColorReductionType::KMeans:
-		return quantizeKMeans(targetBuf, maxTargetBufColors, inputBuf, inputBufColors);
+		return quantizeKMeans(targetBuf, maxTargetBufColors, inputBuf, inputWeights, inputBufColors, parallelFor);
 	case ColorReductionType::NeuQuant:
-		return quantizeNeuQuant(targetBuf, maxTargetBufColors, inputBuf, inputBufColors);
+		return quantizeNeuQuant(targetBuf, maxTargetBufColors, inputBuf, inputWeights, inputBufColors);
 	case ColorReductionType::Octree:
-		return quantizeOctree(targetBuf, maxTargetBufColors, inputBuf, inputBufColors);
+		return quantizeOctree(targetBuf, maxTargetBufColors, inputBuf, inputWeights, inputBufColors);
 	case ColorReductionType::MedianCut:
-		return quantizeMedianCut(targetBuf, maxTargetBufColors, inputBuf, inputBufColors);
+		return quantizeMedianCut(targetBuf, maxTargetBufColors, inputBuf, inputWeights, inputBufColors);
 	default:
 		break;
 	}
@@ -76,6 +76,23 @@ public:
 	 * @return @c -1 on error or the amount of @code colors <= maxTargetBufColors @endcode
 	 */
 	static int quantize(RGBA* targetBuf, size_t maxTargetBufColors, const RGBA* inputBuf, size_t inputBufColors, ColorReductionType type = ColorReductionType::MedianCut);
+	/**
+	 * @brief Calls @c func(chunkStart, chunkEnd, userdata) for chunks of the range @c [start, end) and only returns
+	 * once all of them are done
+	 */
+	typedef void (*ParallelForChunk)(int start, int end, void *userdata);
+	typedef void (*ParallelFor)(int start, int end, ParallelForChunk func, void *userdata);
+
+	/**
+	 * @param inputWeights The frequencies of the (unique) input colors - e.g. the amount of pixels or voxels with that
+	 * color. Frequent colors get more influence on the resulting colors than rare colors. @c nullptr weights all
+	 * colors equally.
+	 * @param parallelFor Used to split the work of the expensive quantizers - e.g. over the thread pool of the app.
+	 * @c nullptr runs everything on the calling thread.
+	 * @return @c -1 on error or the amount of @code colors <= maxTargetBufColors @endcode
+	 */
+	static int quantize(RGBA *targetBuf, size_t maxTargetBufColors, const RGBA *inputBuf, const uint32_t *inputWeights,
+						size_t inputBufColors, ColorReductionType type, ParallelFor parallelFor = nullptr);
 
 	static inline glm::vec4 fromRGBA(const RGBA rgba) {
 		return fromRGBA(rgba.r, rgba.g, rgba.b, rgba.a);
@@ -55,6 +55,10 @@ constexpr const char *CoreLanguage = "core_language";
 // The size of the mesh chunk
 constexpr const char *VoxelMeshSize = "voxel_meshsize";
 constexpr const char *VoxelMeshMode = "voxel_meshmode";
+// Extract lower resolution meshes of the chunks for far away geometry
+constexpr const char *VoxelMeshLod = "voxel_meshlod";
+// The distance at which the first lower resolution chunk meshes are rendered - doubled for every further level
+constexpr const char *VoxelMeshLodDistance = "voxel_meshloddistance";
 
 constexpr const char *AppHomePath = "app_homepath";
 constexpr const char *AppVersion = "app_version";
@@ -98,5 +102,7 @@ constexpr const char *VoxformatQBSaveLeftHanded = "voxformat_qbsavelefthanded";
 constexpr const char *VoxformatQBSaveCompressed = "voxformat_qbsavecompressed";
 constexpr const char *VoxFormatGLTF_KHR_materials_pbrSpecularGlossiness = "voxformat_gltf_khr_materials_pbrspecularglossiness";
 constexpr const char *VoxFormatGLTF_KHR_materials_specular = "voxformat_gltf_khr_materials_specular";
+constexpr const char *VoxFormatGLTF_KHR_mesh_quantization = "voxformat_gltf_khr_mesh_quantization";
+constexpr const char *VoxFormatGLTF_EXT_meshopt_compression = "voxformat_gltf_ext_meshopt_compression";
 
 }
@@ -0,0 +1,47 @@
+/**
+ * @file
+ * @brief Quantization of a weighted color histogram into a palette of 256 colors for every reduction type
+ */
+
+#include "app/benchmark/AbstractBenchmark.h"
+#include "core/ArrayLength.h"
+#include "core/Color.h"
+#include "core/collection/Buffer.h"
+
+class ColorBenchmark : public app::AbstractBenchmark {
+protected:
+	core::Buffer<core::RGBA> _colors;
+	core::Buffer<uint32_t> _weights;
+
+public:
+	void SetUp(::benchmark::State &state) override {
+		app::AbstractBenchmark::SetUp(state);
+		// a few dominant colors with a lot of rare shades - like the histogram of a texture
+		const int n = (int)state.range(0);
+		_colors.clear();
+		_weights.clear();
+		for (int i = 0; i < n; ++i) {
+			const int base = (i % 8) * 32;
+			_colors.push_back(core::RGBA(base + (i >> 3) % 32, base + (i >> 5) % 32, base + (i >> 7) % 32));
+			_weights.push_back(i < 64 ? 10000u : 1u + (uint32_t)(i % 7));
+		}
+	}
+};
+
+BENCHMARK_DEFINE_F(ColorBenchmark, Quantize)(benchmark::State &state) {
+	const core::Color::ColorReductionType type = (core::Color::ColorReductionType)state.range(1);
+	core::RGBA targetBuf[256];
+	for (auto _ : state) {
+		int n = core::Color::quantize(targetBuf, lengthof(targetBuf), _colors.data(), _weights.data(),
+									  _colors.size(), type);
+		benchmark::DoNotOptimize(n);
+	}
+	state.SetLabel(core::Color::toColorReductionTypeString(type));
+}
+
+BENCHMARK_REGISTER_F(ColorBenchmark, Quantize)
+	->ArgsProduct({{8192, 32768},
+				   {(int)core::Color::ColorReductionType::Octree, (int)core::Color::ColorReductionType::Wu,
+					(int)core::Color::ColorReductionType::MedianCut, (int)core::Color::ColorReductionType::KMeans,
+					(int)core::Color::ColorReductionType::NeuQuant}})
+	->Unit(benchmark::kMillisecond);
@@ -71,8 +71,8 @@ public:
 		return (T*)SDL_AtomicSetPtr(&_ptr, (void*)value);
 	}
 
-	T* compare_exchange(T* expectedPtr, T* newPtr) {
-		return (T*)SDL_AtomicCASPtr(&_ptr, (void*)expectedPtr, (void*)newPtr);
+	bool compare_exchange(T* expectedPtr, T* newPtr) {
+		return SDL_AtomicCASPtr(&_ptr, (void*)expectedPtr, (void*)newPtr) == SDL_TRUE;
 	}
 
 	void operator=(T* value) {
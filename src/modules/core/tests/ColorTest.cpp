@@ -7,8 +7,11 @@
 #include "core/RGBA.h"
 #include "core/ArrayLength.h"
 #include "core/StringUtil.h"
+#include "core/collection/Buffer.h"
 #include "core/collection/BufferView.h"
 #include <SDL_endian.h>
+#include <thread>
+#include <vector>
 
 namespace core {
 
@@ -119,6 +122,80 @@ TEST(ColorTest, testQuantize) {
 	EXPECT_EQ(256, n) << "Failed with k-means.\n" << core::BufferView<RGBA>(targetBuf, n) << "\n" << core::BufferView<RGBA>(buf, lengthof(buf));
 }
 
+TEST(ColorTest, testQuantizeWeighted) {
+	const core::RGBA buf[]{core::RGBA(0, 0, 0), core::RGBA(200, 200, 200)};
+	const uint32_t weights[]{1u, 3u};
+	const core::Color::ColorReductionType types[]{core::Color::ColorReductionType::MedianCut,
+												  core::Color::ColorReductionType::Wu,
+												  core::Color::ColorReductionType::KMeans};
+	for (core::Color::ColorReductionType type : types) {
+		core::RGBA targetBuf[1]{};
+		// the single color is the weighted average of the input colors
+		ASSERT_EQ(1, core::Color::quantize(targetBuf, lengthof(targetBuf), buf, weights, lengthof(buf), type))
+			<< core::Color::toColorReductionTypeString(type);
+		EXPECT_NEAR(150, targetBuf[0].r, 1) << core::Color::toColorReductionTypeString(type);
+		EXPECT_NEAR(150, targetBuf[0].b, 1) << core::Color::toColorReductionTypeString(type);
+
+		ASSERT_EQ(1, core::Color::quantize(targetBuf, lengthof(targetBuf), buf, nullptr, lengthof(buf), type))
+			<< core::Color::toColorReductionTypeString(type);
+		EXPECT_NEAR(100, targetBuf[0].r, 1) << core::Color::toColorReductionTypeString(type);
+	}
+}
+
+TEST(ColorTest, testQuantizeWeightedOctree) {
+	// both colors are in the same octree cell - the more frequent one represents the cell
+	const core::RGBA buf[]{core::RGBA(1, 1, 1), core::RGBA(2, 2, 2)};
+	const uint32_t weights[]{1u, 5u};
+	core::RGBA targetBuf[1]{};
+	ASSERT_EQ(1, core::Color::quantize(targetBuf, lengthof(targetBuf), buf, weights, lengthof(buf),
+									   core::Color::ColorReductionType::Octree));
+	EXPECT_EQ(core::RGBA(2, 2, 2), targetBuf[0]);
+}
+
+static int parallelForCalls = 0;
+
+/**
+ * @brief Runs every index of the range on its own thread
+ */
+static void parallelForThreads(int start, int end, core::Color::ParallelForChunk func, void *userdata) {
+	++parallelForCalls;
+	std::vector<std::thread> threads;
+	for (int i = start; i < end; ++i) {
+		threads.emplace_back([=]() { func(i, i + 1, userdata); });
+	}
+	for (std::thread &thread : threads) {
+		thread.join();
+	}
+}
+
+TEST(ColorTest, testQuantizeKMeansLarge) {
+	// large enough to split the assignment step over several threads
+	core::Buffer<core::RGBA> buf;
+	core::Buffer<uint32_t> weights;
+	for (int i = 0; i < 16384; ++i) {
+		buf.push_back(core::RGBA(i & 0xFF, (i >> 8) & 0xFF, (i * 7) & 0xFF));
+		weights.push_back(1u + (i % 13));
+	}
+	core::RGBA serialBuf[4]{};
+	ASSERT_EQ(4, core::Color::quantize(serialBuf, lengthof(serialBuf), buf.data(), weights.data(), buf.size(),
+									   core::Color::ColorReductionType::KMeans));
+	parallelForCalls = 0;
+	core::RGBA parallelBuf[4]{};
+	ASSERT_EQ(4, core::Color::quantize(parallelBuf, lengthof(parallelBuf), buf.data(), weights.data(), buf.size(),
+									   core::Color::ColorReductionType::KMeans, parallelForThreads));
+	EXPECT_GT(parallelForCalls, 0) << "The assignment step was not split";
+	for (int i = 0; i < lengthof(serialBuf); ++i) {
+		EXPECT_EQ(serialBuf[i], parallelBuf[i]) << "color " << i;
+	}
+	// the seed is fixed - another run must give the same palette
+	core::RGBA secondBuf[4]{};
+	ASSERT_EQ(4, core::Color::quantize(secondBuf, lengthof(secondBuf), buf.data(), weights.data(), buf.size(),
+									   core::Color::ColorReductionType::KMeans, parallelForThreads));
+	for (int i = 0; i < lengthof(serialBuf); ++i) {
+		EXPECT_EQ(serialBuf[i], secondBuf[i]) << "color " << i;
+	}
+}
+
 TEST(ColorTest, testDistanceMin) {
 	const core::RGBA color1(255, 0, 0, 255);
 	const core::RGBA color2(255, 0, 0, 255);
@@ -0,0 +1,98 @@
+/**
+ * @file
+ */
+
+#include "BufferedReadStream.h"
+#include "core/Common.h"
+
+namespace io {
+
+BufferedReadStream::BufferedReadStream(SeekableReadStream &stream, int bufferedBytes)
+	: _stream(stream), _capacity(core_max(1, bufferedBytes)), _bufferStart(stream.pos()) {
+	_buffer = (uint8_t *)core_malloc(_capacity);
+}
+
+BufferedReadStream::~BufferedReadStream() {
+	// hand the position that was really consumed back to the wrapped stream
+	if (_stream.pos() != pos()) {
+		_stream.seek(pos());
+	}
+	core_free(_buffer);
+}
+
+bool BufferedReadStream::fill() {
+	_bufferStart += (int64_t)_bufferSize;
+	_bufferPos = 0u;
+	_bufferSize = 0u;
+	const int n = _stream.read(_buffer, _capacity);
+	if (n <= 0) {
+		return false;
+	}
+	_bufferSize = (size_t)n;
+	return true;
+}
+
+int BufferedReadStream::read(void *dataPtr, size_t dataSize) {
+	uint8_t *out = (uint8_t *)dataPtr;
+	size_t remaining = dataSize;
+	while (remaining > 0u) {
+		const size_t available = _bufferSize - _bufferPos;
+		if (available == 0u) {
+			if (remaining >= _capacity) {
+				// large reads bypass the buffer
+				_bufferStart += (int64_t)_bufferSize;
+				_bufferPos = _bufferSize = 0u;
+				const int n = _stream.read(out, remaining);
+				if (n <= 0) {
+					break;
+				}
+				_bufferStart += n;
+				remaining -= (size_t)n;
+				break;
+			}
+			if (!fill()) {
+				break;
+			}
+			continue;
+		}
+		const size_t n = core_min(available, remaining);
+		core_memcpy(out, _buffer + _bufferPos, n);
+		_bufferPos += n;
+		out += n;
+		remaining -= n;
+	}
+	if (remaining == dataSize && dataSize > 0u) {
+		return -1;
+	}
+	return (int)(dataSize - remaining);
+}
+
+int64_t BufferedReadStream::seek(int64_t position, int whence) {
+	int64_t newPos;
+	switch (whence) {
+	case SEEK_SET:
+		newPos = position;
+		break;
+	case SEEK_CUR:
+		newPos = pos() + position;
+		break;
+	case SEEK_END:
+		newPos = size() + position;
+		break;
+	default:
+		return -1;
+	}
+	if (newPos >= _bufferStart && newPos <= _bufferStart + (int64_t)_bufferSize) {
+		_bufferPos = (size_t)(newPos - _bufferStart);
+		return newPos;
+	}
+	const int64_t p = _stream.seek(newPos);
+	if (p == -1) {
+		return -1;
+	}
+	_bufferStart = p;
+	_bufferPos = _bufferSize = 0u;
+	return p;
+}
+
+} // namespace io
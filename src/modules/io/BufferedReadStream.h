@@ -0,0 +1,125 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "Stream.h"
+#include "core/StandardLib.h"
+#include <SDL_endian.h>
+
+namespace io {
+
+/**
+ * @brief Read-ahead buffer for another stream.
+ *
+ * The wrapped stream is read in blocks of the given size. The primitive read functions of this class shadow the ones
+ * of @c ReadStream and are inlined - they only go through the virtual @c read() if a value crosses the end of the
+ * buffered block. Use the concrete type to benefit from this.
+ *
+ * @note The wrapped stream must not be used while this stream is alive. Its position is set to the position of this
+ * stream again on destruction.
+ * @see BufferedWriteStream
+ * @ingroup IO
+ */
+class BufferedReadStream : public SeekableReadStream {
+private:
+	SeekableReadStream &_stream;
+	uint8_t *_buffer;
+	size_t _capacity;
+	/** the stream position of the first byte in the buffer */
+	int64_t _bufferStart;
+	size_t _bufferPos = 0u;
+	size_t _bufferSize = 0u;
+
+	bool fill();
+
+	template<typename T>
+	inline int readValue(T &val) {
+		if (_bufferPos + sizeof(T) > _bufferSize) {
+			return read(&val, sizeof(T)) == (int)sizeof(T) ? 0 : -1;
+		}
+		core_memcpy(&val, _buffer + _bufferPos, sizeof(T));
+		_bufferPos += sizeof(T);
+		return 0;
+	}
+
+public:
+	/**
+	 * @param[in] bufferedBytes The amount of bytes that are read from the wrapped stream at once
+	 */
+	BufferedReadStream(SeekableReadStream &stream, int bufferedBytes = 64 * 1024);
+	virtual ~BufferedReadStream();
+
+	int read(void *dataPtr, size_t dataSize) override;
+	int64_t seek(int64_t position, int whence = SEEK_SET) override;
+	int64_t size() const override;
+	int64_t pos() const override;
+	const uint8_t *data() const override;
+
+	inline int readUInt8(uint8_t &val) {
+		return readValue(val);
+	}
+	inline int readInt8(int8_t &val) {
+		return readValue(val);
+	}
+	inline int readUInt16(uint16_t &val) {
+		const int ret = readValue(val);
+		val = SDL_SwapLE16(val);
+		return ret;
+	}
+	inline int readInt16(int16_t &val) {
+		const int ret = readValue(val);
+		val = (int16_t)SDL_SwapLE16(val);
+		return ret;
+	}
+	inline int readUInt32(uint32_t &val) {
+		const int ret = readValue(val);
+		val = SDL_SwapLE32(val);
+		return ret;
+	}
+	inline int readInt32(int32_t &val) {
+		const int ret = readValue(val);
+		val = (int32_t)SDL_SwapLE32(val);
+		return ret;
+	}
+	inline int readUInt64(uint64_t &val) {
+		const int ret = readValue(val);
+		val = SDL_SwapLE64(val);
+		return ret;
+	}
+	inline int readInt64(int64_t &val) {
+		const int ret = readValue(val);
+		val = (int64_t)SDL_SwapLE64(val);
+		return ret;
+	}
+	inline int readFloat(float &val) {
+		const int ret = readValue(val);
+		val = SDL_SwapFloatLE(val);
+		return ret;
+	}
+	inline int readUInt16BE(uint16_t &val) {
+		const int ret = readValue(val);
+		val = SDL_SwapBE16(val);
+		return ret;
+	}
+	inline int readUInt32BE(uint32_t &val) {
+		const int ret = readValue(val);
+		val = SDL_SwapBE32(val);
+		return ret;
+	}
+};
+
+inline int64_t BufferedReadStream::size() const {
+	return _stream.size();
+}
+
+inline const uint8_t *BufferedReadStream::data() const {
+	return _stream.data();
+}
+
+inline int64_t BufferedReadStream::pos() const {
+	return _bufferStart + (int64_t)_bufferPos;
+}
+
+} // namespace io
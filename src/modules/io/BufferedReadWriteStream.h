@@ -55,8 +55,13 @@ public:
 	int64_t pos() const override;
 	int64_t size() const override;
 	int64_t capacity() const;
+	const uint8_t *data() const override;
 };
 
+inline const uint8_t *BufferedReadWriteStream::data() const {
+	return _buffer;
+}
+
 inline int64_t BufferedReadWriteStream::capacity() const {
 	return _capacity;
 }
@@ -2,60 +2,121 @@
  * @file
  */
 
+#pragma once
+
 #include "Stream.h"
-#include "core/collection/Buffer.h"
+#include "core/StandardLib.h"
+#include <SDL_endian.h>
 
 namespace io {
 
 /**
+ * @brief Write-behind buffer for another stream.
+ *
+ * The primitive write functions of this class shadow the ones of @c WriteStream and are inlined. They only go through
+ * the virtual @c write() of the wrapped stream if the buffer is full. Use the concrete type to benefit from this.
+ *
  * @note This buffer must be flushed
  */
 class BufferedWriteStream : public WriteStream {
 private:
 	WriteStream &_stream;
-	core::Buffer<uint8_t> _buffer;
+	uint8_t *_buffer;
+	size_t _capacity;
+	size_t _size = 0u;
+
+	template<typename T>
+	inline bool writeValue(T val) {
+		if (_size + sizeof(T) > _capacity) {
+			return write(&val, sizeof(T)) != -1;
+		}
+		core_memcpy(_buffer + _size, &val, sizeof(T));
+		_size += sizeof(T);
+		return true;
+	}
 
 public:
 	/**
 	 * @param[in] bufferedBytes The amount of bytes to buffer before the write is executed on the real buffer.
-	 * @note The buffered bytes are 32 byte aligned
 	 */
-	BufferedWriteStream(WriteStream &stream, int bufferedBytes = 1 * 1024 * 1024) : _stream(stream) {
-		_buffer.reserve(bufferedBytes);
+	BufferedWriteStream(WriteStream &stream, int bufferedBytes = 1 * 1024 * 1024)
+		: _stream(stream), _capacity(core_max(1, bufferedBytes)) {
+		_buffer = (uint8_t *)core_malloc(_capacity);
 	}
 	virtual ~BufferedWriteStream() {
 		BufferedWriteStream::flush();
+		core_free(_buffer);
 	}
 
 	inline size_t reservedBytes() const {
-		return _buffer.capacity();
+		return _capacity;
 	}
 
 	int write(const void *buf, size_t size) override {
-		if (_buffer.capacity() < size) {
-			flush();
+		if (_size + size <= _capacity) {
+			core_memcpy(_buffer + _size, buf, size);
+			_size += size;
+			return (int)size;
+		}
+		if (!flush()) {
+			return -1;
+		}
+		if (size > _capacity) {
 			if (_stream.write(buf, size) != (int)size) {
 				return -1;
 			}
 			return (int)size;
 		}
-
-		const size_t freeBytes = _buffer.capacity() - _buffer.size();
-		const size_t remaining = freeBytes >= size ? 0 : freeBytes - size;
-		if (remaining == 0) {
-			_buffer.append((const uint8_t *)buf, size);
-		} else {
-			flush();
-			_buffer.append((const uint8_t *)buf, size);
-		}
+		core_memcpy(_buffer, buf, size);
+		_size = size;
 		return (int)size;
 	}
 
 	bool flush() override {
-		_stream.write(_buffer.data(), _buffer.size());
-		_buffer.reset();
+		if (_size > 0u) {
+			const int written = _stream.write(_buffer, _size);
+			const bool success = written == (int)_size;
+			_size = 0u;
+			if (!success) {
+				return false;
+			}
+		}
 		return _stream.flush();
 	}
+
+	inline bool writeUInt8(uint8_t val) {
+		return writeValue(val);
+	}
+	inline bool writeInt8(int8_t val) {
+		return writeValue(val);
+	}
+	inline bool writeUInt16(uint16_t val) {
+		return writeValue((uint16_t)SDL_SwapLE16(val));
+	}
+	inline bool writeInt16(int16_t val) {
+		return writeValue((int16_t)SDL_SwapLE16(val));
+	}
+	inline bool writeUInt32(uint32_t val) {
+		return writeValue((uint32_t)SDL_SwapLE32(val));
+	}
+	inline bool writeInt32(int32_t val) {
+		return writeValue((int32_t)SDL_SwapLE32(val));
+	}
+	inline bool writeUInt64(uint64_t val) {
+		return writeValue((uint64_t)SDL_SwapLE64(val));
+	}
+	inline bool writeInt64(int64_t val) {
+		return writeValue((int64_t)SDL_SwapLE64(val));
+	}
+	inline bool writeFloat(float val) {
+		return writeValue(SDL_SwapFloatLE(val));
+	}
+	inline bool writeUInt16BE(uint16_t val) {
+		return writeValue((uint16_t)SDL_SwapBE16(val));
+	}
+	inline bool writeUInt32BE(uint32_t val) {
+		return writeValue((uint32_t)SDL_SwapBE32(val));
+	}
 };
 
 } // namespace io
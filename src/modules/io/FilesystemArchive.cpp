@@ -9,6 +9,7 @@
 #include "io/File.h"
 #include "io/FileStream.h"
 #include "io/Filesystem.h"
+#include "io/MMapReadStream.h"
 
 namespace io {
 
@@ -79,7 +80,16 @@ void FilesystemArchive::list(const core::String &basePath, ArchiveFiles &out, co
 }
 
 SeekableReadStream *FilesystemArchive::readStream(const core::String &filePath) {
-	io::FileStream *stream = new io::FileStream(open(filePath, _sysmode ? FileMode::SysRead : FileMode::Read));
+	const io::FilePtr &file = open(filePath, _sysmode ? FileMode::SysRead : FileMode::Read);
+	if (file && file->validHandle()) {
+		// prefer the mapped file - this allows the loaders to access the content without copying it
+		io::MMapReadStream *mappedStream = new io::MMapReadStream(file->name());
+		if (mappedStream->valid()) {
+			return mappedStream;
+		}
+		delete mappedStream;
+	}
+	io::FileStream *stream = new io::FileStream(file);
 	if (!stream->valid()) {
 		delete stream;
 		return nullptr;
@@ -0,0 +1,27 @@
+/**
+ * @file
+ */
+
+#include "MMapReadStream.h"
+#include "core/String.h"
+
+namespace io {
+
+extern void *fs_mmap(const char *path, size_t &size);
+extern void fs_munmap(void *data, size_t size);
+
+MMapReadStream::MMapReadStream(const core::String &path) : MemoryReadStream(nullptr, 0u) {
+	_mapping = fs_mmap(path.c_str(), _mappingSize);
+	if (_mapping != nullptr) {
+		_buf = (const uint8_t *)_mapping;
+		_size = (int64_t)_mappingSize;
+	}
+}
+
+MMapReadStream::~MMapReadStream() {
+	if (_mapping != nullptr) {
+		fs_munmap(_mapping, _mappingSize);
+	}
+}
+
+} // namespace io
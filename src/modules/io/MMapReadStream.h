@@ -0,0 +1,38 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "io/MemoryReadStream.h"
+
+namespace io {
+
+/**
+ * @brief Read-only stream on a memory mapped file
+ *
+ * The file content is not copied - use @c data() to get access to the whole file without reading it into another
+ * buffer.
+ *
+ * @note Mapping might fail (e.g. for empty files or on platforms without support for it) - check @c valid() and fall
+ * back to a @c FileStream in that case.
+ * @ingroup IO
+ * @see FilesystemArchive::readStream()
+ */
+class MMapReadStream : public MemoryReadStream {
+private:
+	void *_mapping = nullptr;
+	size_t _mappingSize = 0u;
+
+public:
+	MMapReadStream(const core::String &path);
+	virtual ~MMapReadStream();
+
+	bool valid() const;
+};
+
+inline bool MMapReadStream::valid() const {
+	return _mapping != nullptr;
+}
+
+} // namespace io
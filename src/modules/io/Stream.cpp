@@ -41,15 +41,9 @@ bool WriteStream::writeStringFormat(bool terminate, const char *fmt, ...) {
 	text[sizeof(text) - 1] = '\0';
 	va_end(ap);
 	const size_t length = SDL_strlen(text);
-	for (size_t i = 0u; i < length; i++) {
-		if (!writeUInt8(uint8_t(text[i]))) {
-			return false;
-		}
-	}
-	if (!terminate) {
-		return true;
-	}
-	return writeUInt8(uint8_t('\0'));
+	// include the null byte in the same write call if requested
+	const size_t writeLength = terminate ? length + 1 : length;
+	return write(text, writeLength) == (int)writeLength;
 }
 
 bool WriteStream::writeFormat(const char *fmt, ...) {
@@ -102,16 +96,12 @@ bool WriteStream::writeUInt8(uint8_t val) {
 }
 
 bool WriteStream::writeString(const core::String &string, bool terminate) {
-	const size_t length = string.size();
-	for (size_t i = 0u; i < length; i++) {
-		if (!writeUInt8(uint8_t(string[i]))) {
-			return false;
-		}
-	}
-	if (!terminate) {
+	// the string is always null terminated
+	const size_t writeLength = terminate ? string.size() + 1 : string.size();
+	if (writeLength == 0u) {
 		return true;
 	}
-	return writeUInt8(uint8_t('\0'));
+	return write(string.c_str(), writeLength) == (int)writeLength;
 }
 
 bool WriteStream::writeLine(const core::String &string, const char *lineEnding) {
@@ -344,6 +334,12 @@ bool ReadStream::readFormat(const char *fmt, ...) {
 }
 
 bool ReadStream::readString(int length, char *strbuff, bool terminated) {
+	if (!terminated) {
+		if (length <= 0) {
+			return true;
+		}
+		return read(strbuff, length) == length;
+	}
 	for (int i = 0; i < length; ++i) {
 		uint8_t chr;
 		if (readUInt8(chr) != 0) {
@@ -359,6 +355,17 @@ bool ReadStream::readString(int length, char *strbuff, bool terminated) {
 
 bool ReadStream::readString(int length, core::String &str, bool terminated) {
 	str.clear();
+	if (!terminated) {
+		if (length <= 0) {
+			return true;
+		}
+		core::String buf(length, ' ');
+		if (read(buf.c_str(), length) != length) {
+			return false;
+		}
+		str = core::move(buf);
+		return true;
+	}
 	str.reserve(length);
 	for (int i = 0; i < length; ++i) {
 		uint8_t chr;
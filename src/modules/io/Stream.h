@@ -212,6 +212,15 @@ public:
 	bool readLine(int length, char *strbuff);
 	bool readLine(core::String &str);
 
+	/**
+	 * @brief Zero-copy access for streams that are backed by a contiguous memory block
+	 * @return The whole content of the stream (@c size() bytes from offset @c 0) or @c nullptr if the content is not
+	 * available in memory and must be read.
+	 */
+	virtual const uint8_t *data() const {
+		return nullptr;
+	}
+
 	/**
 	 * @return The amount of bytes left in the stream to read
 	 * @sa size()
@@ -369,6 +378,13 @@ public:
 		return -1;
 	}
 
+	const uint8_t *data() const override {
+		if (_rs) {
+			return _rs->data();
+		}
+		return nullptr;
+	}
+
 	int64_t seek(int64_t position, int whence = SEEK_SET) override {
 		if (_rs) {
 			return _rs->seek(position, whence);
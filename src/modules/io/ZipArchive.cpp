@@ -3,9 +3,13 @@
  */
 
 #include "ZipArchive.h"
+#include "core/Common.h"
 #include "core/Log.h"
 #include "core/StandardLib.h"
 #include "core/StringUtil.h"
+#include "core/Trace.h"
+#include "core/concurrent/Concurrency.h"
+#include "core/concurrent/ThreadPool.h"
 #include "io/BufferedReadWriteStream.h"
 #define MINIZ_NO_STDIO
 #include "io/external/miniz.h"
@@ -47,6 +51,46 @@ static size_t ziparchive_write(void *userdata, mz_uint64 offset, const void *tar
 	return written;
 }
 
+static size_t ziparchive_writearchive(void *userdata, mz_uint64 offset, const void *targetBuf, size_t targetBufSize) {
+	io::SeekableWriteStream *out = (io::SeekableWriteStream *)userdata;
+	if (out->pos() != (int64_t)offset && out->seek((int64_t)offset, SEEK_SET) == -1) {
+		Log::error("ziparchive_writearchive: Failed to seek");
+		return 0u;
+	}
+	const int written = out->write(targetBuf, targetBufSize);
+	if (written != (int)targetBufSize) {
+		Log::error("Failed to write %i bytes into archive stream", (int)targetBufSize);
+		return 0u;
+	}
+	return targetBufSize;
+}
+
+static mz_bool ziparchive_putbuf(const void *buf, int len, void *userdata) {
+	io::BufferedReadWriteStream *out = (io::BufferedReadWriteStream *)userdata;
+	return out->write(buf, len) == len;
+}
+
+/**
+ * The blocks are deflated without sharing a dictionary - every block but the last ends with a sync flush on a byte
+ * boundary. This allows to just concatenate the compressed blocks to get a valid raw deflate stream.
+ */
+static bool ziparchive_deflate(const uint8_t *data, size_t size, bool last, int level, io::BufferedReadWriteStream &out) {
+	core_trace_scoped(ZipArchiveDeflate);
+	tdefl_compressor *comp = tdefl_compressor_alloc();
+	if (comp == nullptr) {
+		return false;
+	}
+	// negative window bits for a raw deflate stream without zlib header
+	const mz_uint flags = tdefl_create_comp_flags_from_zip_params(level, -MZ_DEFAULT_WINDOW_BITS, MZ_DEFAULT_STRATEGY);
+	bool success = tdefl_init(comp, ziparchive_putbuf, &out, (int)flags) == TDEFL_STATUS_OKAY;
+	if (success) {
+		const tdefl_status status = tdefl_compress_buffer(comp, data, size, last ? TDEFL_FINISH : TDEFL_SYNC_FLUSH);
+		success = status == (last ? TDEFL_STATUS_DONE : TDEFL_STATUS_OKAY);
+	}
+	tdefl_compressor_free(comp);
+	return success;
+}
+
 static void *ziparchive_malloc(void *opaque, size_t items, size_t size) {
 	return core_malloc(items * size);
 }
@@ -67,10 +111,18 @@ ZipArchive::~ZipArchive() {
 }
 
 void ZipArchive::shutdown() {
+	if (_writeStream != nullptr) {
+		flush();
+	}
 	reset();
 }
 
 void ZipArchive::reset() {
+	for (WriteEntry &entry : _writeEntries) {
+		delete entry.stream;
+	}
+	_writeEntries.clear();
+	_writeStream = nullptr;
 	if (_zip == nullptr) {
 		return;
 	}
@@ -169,9 +221,164 @@ SeekableReadStream* ZipArchive::readStream(const core::String &filePath) {
 	return stream;
 }
 
+bool ZipArchive::initWrite(io::SeekableWriteStream *stream, int level) {
+	if (stream == nullptr) {
+		Log::error("No stream given");
+		return false;
+	}
+	reset();
+	mz_zip_archive *zip = (mz_zip_archive *)core_malloc(sizeof(mz_zip_archive));
+	_zip = zip;
+	mz_zip_zero_struct(zip);
+	zip->m_pAlloc = ziparchive_malloc;
+	zip->m_pRealloc = ziparchive_realloc;
+	zip->m_pFree = ziparchive_free;
+	zip->m_pWrite = ziparchive_writearchive;
+	zip->m_pIO_opaque = stream;
+	_files.clear();
+	if (!mz_zip_writer_init(zip, 0)) {
+		const mz_zip_error error = mz_zip_get_last_error(zip);
+		const char *err = mz_zip_get_error_string(error);
+		Log::error("Failed to initialize the zip writer: %s", err);
+		reset();
+		return false;
+	}
+	_writeStream = stream;
+	_level = core_max(0, core_min(level, (int)MZ_UBER_COMPRESSION));
+	return true;
+}
+
 SeekableWriteStream* ZipArchive::writeStream(const core::String &filePath) {
-	// TODO: implement me
-	return nullptr;
+	if (_writeStream == nullptr) {
+		Log::error("Zip archive is not opened for writing");
+		return nullptr;
+	}
+	for (WriteEntry &entry : _writeEntries) {
+		if (entry.name == filePath) {
+			// the entry is written again - the data of the previous write must not leak into the archive
+			entry.stream->reset();
+			return new SeekableReadWriteStreamWrapper((io::SeekableWriteStream *)entry.stream);
+		}
+	}
+	BufferedReadWriteStream *stream = new BufferedReadWriteStream(512 * 1024);
+	_writeEntries.push_back({filePath, stream});
+	FilesystemEntry entry;
+	entry.fullPath = filePath;
+	entry.name = core::string::extractFilenameWithExtension(filePath);
+	entry.type = FilesystemEntry::Type::file;
+	_files.emplace_back(core::move(entry));
+	return new SeekableReadWriteStreamWrapper((io::SeekableWriteStream *)stream);
+}
+
+bool ZipArchive::flush() {
+	if (_writeStream == nullptr) {
+		return false;
+	}
+	core_trace_scoped(ZipArchiveFlush);
+	mz_zip_archive *zip = (mz_zip_archive *)_zip;
+
+	struct Block {
+		int entry;
+		size_t offset;
+		size_t size;
+		bool last;
+		BufferedReadWriteStream *out;
+	};
+	const int entryCount = (int)_writeEntries.size();
+	core::DynamicArray<int> firstBlock;
+	firstBlock.resize(entryCount + 1);
+	size_t blockCount = 0u;
+	for (int i = 0; i < entryCount; ++i) {
+		firstBlock[i] = (int)blockCount;
+		const size_t size = (size_t)_writeEntries[i].stream->size();
+		if (_level > 0 && size > 0u) {
+			blockCount += (size + BlockSize - 1) / BlockSize;
+		}
+	}
+	firstBlock[entryCount] = (int)blockCount;
+
+	core::DynamicArray<Block> blocks;
+	blocks.resize(blockCount);
+	for (int i = 0; i < entryCount; ++i) {
+		const size_t size = (size_t)_writeEntries[i].stream->size();
+		for (int b = firstBlock[i]; b < firstBlock[i + 1]; ++b) {
+			Block &block = blocks[b];
+			block.entry = i;
+			block.offset = (size_t)(b - firstBlock[i]) * BlockSize;
+			block.size = core_min(BlockSize, size - block.offset);
+			block.last = b == firstBlock[i + 1] - 1;
+			block.out = new BufferedReadWriteStream(block.size / 2);
+		}
+	}
+
+	core::DynamicArray<uint32_t> crcs;
+	crcs.resize(entryCount);
+	bool success = true;
+	if (blockCount > 0u) {
+		core::ThreadPool pool(core_min((size_t)core::cpus(), blockCount), "ZipArchive");
+		pool.init();
+		core::DynamicArray<std::future<bool>> futures;
+		futures.reserve(blockCount);
+		const int level = _level;
+		for (size_t b = 0; b < blockCount; ++b) {
+			Block *block = &blocks[b];
+			const uint8_t *data = _writeEntries[block->entry].stream->getBuffer();
+			uint32_t *crc = &crcs[block->entry];
+			futures.emplace_back(pool.enqueue([block, data, crc, level]() {
+				// the checksum of the whole entry is calculated along with the last block
+				if (block->last) {
+					*crc = (uint32_t)mz_crc32(MZ_CRC32_INIT, data, block->offset + block->size);
+				}
+				return ziparchive_deflate(data + block->offset, block->size, block->last, level, *block->out);
+			}));
+		}
+		for (std::future<bool> &future : futures) {
+			if (!future.get()) {
+				success = false;
+			}
+		}
+	}
+
+	BufferedReadWriteStream compressed;
+	for (int i = 0; success && i < entryCount; ++i) {
+		const WriteEntry &entry = _writeEntries[i];
+		const size_t size = (size_t)entry.stream->size();
+		if (firstBlock[i] == firstBlock[i + 1]) {
+			// stored or empty entries don't benefit from the block compression
+			if (!mz_zip_writer_add_mem(zip, entry.name.c_str(), entry.stream->getBuffer(), size, _level)) {
+				success = false;
+			}
+			continue;
+		}
+		compressed.reset();
+		for (int b = firstBlock[i]; b < firstBlock[i + 1]; ++b) {
+			const BufferedReadWriteStream *out = blocks[b].out;
+			compressed.write(out->getBuffer(), out->size());
+		}
+		if (!mz_zip_writer_add_mem_ex(zip, entry.name.c_str(), compressed.getBuffer(), compressed.size(), nullptr, 0,
+									  _level | MZ_ZIP_FLAG_COMPRESSED_DATA, size, crcs[i])) {
+			success = false;
+		}
+	}
+	if (success && !mz_zip_writer_finalize_archive(zip)) {
+		success = false;
+	}
+	if (!success) {
+		const mz_zip_error error = mz_zip_get_last_error(zip);
+		Log::error("Failed to write the zip archive: %s", mz_zip_get_error_string(error));
+	}
+	for (Block &block : blocks) {
+		delete block.out;
+	}
+	mz_zip_writer_end(zip);
+	core_free(_zip);
+	_zip = nullptr;
+	for (WriteEntry &entry : _writeEntries) {
+		delete entry.stream;
+	}
+	_writeEntries.clear();
+	_writeStream = nullptr;
+	return success;
 }
 
 ArchivePtr openZipArchive(io::SeekableReadStream *stream) {
@@ -183,4 +390,12 @@ ArchivePtr openZipArchive(io::SeekableReadStream *stream) {
 	return za;
 }
 
+ZipArchivePtr createZipArchive(io::SeekableWriteStream *stream, int level) {
+	core::SharedPtr<ZipArchive> za = core::make_shared<ZipArchive>();
+	if (!za->initWrite(stream, level)) {
+		return ZipArchivePtr{};
+	}
+	return za;
+}
+
 } // namespace io
@@ -4,31 +4,72 @@
 
 #pragma once
 
+#include "core/collection/DynamicArray.h"
 #include "io/Archive.h"
 #include "io/Stream.h"
 
 namespace io {
 
+class BufferedReadWriteStream;
+
 /**
+ * @brief Reads zip archives - or writes them if initialized with @c initWrite()
+ *
+ * In write mode the streams returned by @c writeStream() are collected in memory. The entries are deflated on
+ * @c flush() - every entry is split into independent blocks that are compressed in parallel and concatenated
+ * afterwards. The local headers and the central directory are written sequentially.
+ *
  * @ingroup IO
  */
 class ZipArchive : public Archive {
 private:
+	struct WriteEntry {
+		core::String name;
+		BufferedReadWriteStream *stream;
+	};
 	void *_zip = nullptr;
+	io::SeekableWriteStream *_writeStream = nullptr;
+	core::DynamicArray<WriteEntry> _writeEntries;
+	int _level = 6;
 	void reset();
 
 public:
+	/**
+	 * @brief The amount of uncompressed bytes that are deflated as one unit
+	 */
+	static constexpr size_t BlockSize = 1024 * 1024;
+
 	ZipArchive();
 	virtual ~ZipArchive();
 
 	static bool validStream(io::SeekableReadStream &stream);
 	SeekableReadStream* readStream(const core::String &filePath) override;
+	/**
+	 * @note Only available in write mode - the returned stream stays valid until @c flush() is called
+	 * @sa initWrite()
+	 */
 	SeekableWriteStream* writeStream(const core::String &filePath) override;
 
 	bool init(const core::String &path, io::SeekableReadStream *stream) override;
+	/**
+	 * @brief Initialize the archive for writing into the given stream
+	 * @param[in] level The compression level 0-10 - 0 means the entries are stored uncompressed
+	 */
+	bool initWrite(io::SeekableWriteStream *stream, int level = 6);
+	/**
+	 * @brief Compress all written entries and finalize the archive
+	 * @note No further entries can be added after this was called
+	 */
+	bool flush();
 	void shutdown() override;
 };
 
+using ZipArchivePtr = core::SharedPtr<ZipArchive>;
+
 ArchivePtr openZipArchive(io::SeekableReadStream *stream);
+/**
+ * @sa ZipArchive::initWrite()
+ */
+ZipArchivePtr createZipArchive(io::SeekableWriteStream *stream, int level = 6);
 
 } // namespace io
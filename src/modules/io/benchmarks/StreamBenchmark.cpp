@@ -0,0 +1,138 @@
+/**
+ * @file
+ */
+
+#include "app/benchmark/AbstractBenchmark.h"
+#include "core/ScopedPtr.h"
+#include "io/BufferedReadStream.h"
+#include "io/BufferedReadWriteStream.h"
+#include "io/BufferedWriteStream.h"
+#include "io/FileStream.h"
+#include "io/ZipWriteStream.h"
+
+enum StreamType { Memory, File, Zip, Max };
+
+static constexpr int Values = 64 * 1024;
+
+class StreamBenchmark : public app::AbstractBenchmark {
+protected:
+	io::BufferedReadWriteStream _memory;
+	io::FilePtr _file;
+	core::ScopedPtr<io::FileStream> _fileStream;
+	core::ScopedPtr<io::ZipWriteStream> _zipStream;
+
+	io::WriteStream *writeStream(StreamType type) {
+		// the zip stream flushes into the memory stream on destruction
+		_zipStream = nullptr;
+		_fileStream = nullptr;
+		_memory.reset();
+		switch (type) {
+		case StreamType::File:
+			_file = io::filesystem()->open("streambenchmark.bin", io::FileMode::Write);
+			_fileStream = new io::FileStream(_file);
+			return _fileStream;
+		case StreamType::Zip:
+			_zipStream = new io::ZipWriteStream(_memory, 1);
+			return _zipStream;
+		default:
+			break;
+		}
+		return &_memory;
+	}
+
+	io::SeekableReadStream *readStream(StreamType type) {
+		io::WriteStream *stream = writeStream(type);
+		for (uint32_t i = 0; i < Values; ++i) {
+			stream->writeUInt32(i);
+		}
+		stream->flush();
+		if (type == StreamType::File) {
+			_file->close();
+			_file = io::filesystem()->open("streambenchmark.bin", io::FileMode::Read);
+			_fileStream = new io::FileStream(_file);
+			return _fileStream;
+		}
+		_memory.seek(0);
+		return &_memory;
+	}
+
+public:
+	void TearDown(::benchmark::State &state) override {
+		_zipStream = nullptr;
+		_fileStream = nullptr;
+		_file = io::FilePtr();
+		app::AbstractBenchmark::TearDown(state);
+	}
+};
+
+BENCHMARK_DEFINE_F(StreamBenchmark, WriteUInt32)(benchmark::State &state) {
+	for (auto _ : state) {
+		io::WriteStream *stream = writeStream((StreamType)state.range(0));
+		for (uint32_t i = 0; i < Values; ++i) {
+			stream->writeUInt32(i);
+		}
+		stream->flush();
+	}
+}
+
+BENCHMARK_DEFINE_F(StreamBenchmark, WriteUInt32Buffered)(benchmark::State &state) {
+	for (auto _ : state) {
+		io::BufferedWriteStream stream(*writeStream((StreamType)state.range(0)), 64 * 1024);
+		for (uint32_t i = 0; i < Values; ++i) {
+			stream.writeUInt32(i);
+		}
+		stream.flush();
+	}
+}
+
+BENCHMARK_DEFINE_F(StreamBenchmark, WriteStringFormat)(benchmark::State &state) {
+	for (auto _ : state) {
+		io::WriteStream *stream = writeStream((StreamType)state.range(0));
+		for (int i = 0; i < Values / 16; ++i) {
+			stream->writeStringFormat(false, "v %.04f %.04f %.04f\n", (float)i, (float)i * 0.5f, (float)i * 2.0f);
+		}
+		stream->flush();
+	}
+}
+
+BENCHMARK_DEFINE_F(StreamBenchmark, WriteStringFormatBuffered)(benchmark::State &state) {
+	for (auto _ : state) {
+		io::BufferedWriteStream stream(*writeStream((StreamType)state.range(0)), 64 * 1024);
+		for (int i = 0; i < Values / 16; ++i) {
+			stream.writeStringFormat(false, "v %.04f %.04f %.04f\n", (float)i, (float)i * 0.5f, (float)i * 2.0f);
+		}
+		stream.flush();
+	}
+}
+
+BENCHMARK_DEFINE_F(StreamBenchmark, ReadUInt32)(benchmark::State &state) {
+	io::SeekableReadStream *stream = readStream((StreamType)state.range(0));
+	for (auto _ : state) {
+		stream->seek(0);
+		uint32_t val;
+		for (uint32_t i = 0; i < Values; ++i) {
+			stream->readUInt32(val);
+		}
+	}
+}
+
+BENCHMARK_DEFINE_F(StreamBenchmark, ReadUInt32Buffered)(benchmark::State &state) {
+	io::SeekableReadStream *source = readStream((StreamType)state.range(0));
+	for (auto _ : state) {
+		source->seek(0);
+		io::BufferedReadStream stream(*source);
+		uint32_t val;
+		for (uint32_t i = 0; i < Values; ++i) {
+			stream.readUInt32(val);
+		}
+	}
+}
+
+BENCHMARK_REGISTER_F(StreamBenchmark, WriteUInt32)->DenseRange(0, StreamType::Max - 1);
+BENCHMARK_REGISTER_F(StreamBenchmark, WriteUInt32Buffered)->DenseRange(0, StreamType::Max - 1);
+BENCHMARK_REGISTER_F(StreamBenchmark, WriteStringFormat)->DenseRange(0, StreamType::Max - 1);
+BENCHMARK_REGISTER_F(StreamBenchmark, WriteStringFormatBuffered)->DenseRange(0, StreamType::Max - 1);
+BENCHMARK_REGISTER_F(StreamBenchmark, ReadUInt32)->DenseRange(0, StreamType::File);
+BENCHMARK_REGISTER_F(StreamBenchmark, ReadUInt32Buffered)->DenseRange(0, StreamType::File);
+
+BENCHMARK_MAIN();
@@ -46,6 +46,13 @@ core::DynamicArray<FilesystemEntry> fs_scandir(const char *path) {
 	return foo;
 }
 
+void *fs_mmap(const char *path, size_t &size) {
+	return nullptr;
+}
+
+void fs_munmap(void *data, size_t size) {
+}
+
 core::String fs_readlink(const char *path) {
 	return path;
 }
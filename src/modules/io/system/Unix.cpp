@@ -16,7 +16,9 @@
 #include <dirent.h>
 #include <errno.h>
 #include <pwd.h>
+#include <fcntl.h>
 #include <stdlib.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
@@ -267,6 +269,32 @@ bool fs_stat(const char *path, FilesystemEntry &entry) {
 	return true;
 }
 
+void *fs_mmap(const char *path, size_t &size) {
+	const int fd = ::open(path, O_RDONLY);
+	if (fd == -1) {
+		Log::debug("Failed to open %s for mapping: %s", path, strerror(errno));
+		return nullptr;
+	}
+	struct stat s;
+	if (fstat(fd, &s) != 0 || s.st_size <= 0) {
+		::close(fd);
+		return nullptr;
+	}
+	void *data = mmap(nullptr, (size_t)s.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	// the mapping stays valid after closing the descriptor
+	::close(fd);
+	if (data == MAP_FAILED) {
+		Log::debug("Failed to map %s: %s", path, strerror(errno));
+		return nullptr;
+	}
+	size = (size_t)s.st_size;
+	return data;
+}
+
+void fs_munmap(void *data, size_t size) {
+	munmap(data, size);
+}
+
 core::String fs_readlink(const char *path) {
 	char buf[4096];
 	ssize_t len = readlink(path, buf, lengthof(buf));
@@ -183,6 +183,41 @@ bool fs_stat(const char *path, FilesystemEntry &entry) {
 	return false;
 }
 
+void *fs_mmap(const char *path, size_t &size) {
+	WCHAR *wpath = io_UTF8ToStringW(path);
+	priv::denormalizePath(wpath);
+	HANDLE file = CreateFileW(wpath, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	SDL_free(wpath);
+	if (file == INVALID_HANDLE_VALUE) {
+		Log::debug("Failed to open %s for mapping", path);
+		return nullptr;
+	}
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0) {
+		CloseHandle(file);
+		return nullptr;
+	}
+	HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(file);
+	if (mapping == nullptr) {
+		Log::debug("Failed to create file mapping for %s", path);
+		return nullptr;
+	}
+	// the view keeps the mapping alive
+	void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+	if (data == nullptr) {
+		Log::debug("Failed to map %s", path);
+		return nullptr;
+	}
+	size = (size_t)fileSize.QuadPart;
+	return data;
+}
+
+void fs_munmap(void *data, size_t size) {
+	UnmapViewOfFile(data);
+}
+
 core::String fs_readlink(const char *path) {
 	return "";
 }
@@ -0,0 +1,87 @@
+/**
+ * @file
+ */
+
+#include "io/BufferedReadStream.h"
+#include "core/ArrayLength.h"
+#include "io/BufferedReadWriteStream.h"
+#include "io/MemoryReadStream.h"
+#include <gtest/gtest.h>
+
+namespace io {
+
+class BufferedReadStreamTest : public testing::Test {};
+
+TEST_F(BufferedReadStreamTest, testReadAcrossBufferBorders) {
+	BufferedReadWriteStream source;
+	for (uint32_t i = 0; i < 16; ++i) {
+		ASSERT_TRUE(source.writeUInt32(i));
+		ASSERT_TRUE(source.writeUInt8((uint8_t)i));
+	}
+	source.seek(0);
+	BufferedReadStream stream(source, 7);
+	EXPECT_EQ(source.size(), stream.size());
+	for (uint32_t i = 0; i < 16; ++i) {
+		uint32_t val;
+		ASSERT_EQ(0, stream.readUInt32(val));
+		EXPECT_EQ(i, val);
+		uint8_t byte;
+		ASSERT_EQ(0, stream.readUInt8(byte));
+		EXPECT_EQ((uint8_t)i, byte);
+	}
+	EXPECT_TRUE(stream.eos());
+	uint8_t byte;
+	EXPECT_EQ(-1, stream.readUInt8(byte));
+}
+
+TEST_F(BufferedReadStreamTest, testSeek) {
+	uint8_t buf[64];
+	for (int i = 0; i < lengthof(buf); ++i) {
+		buf[i] = (uint8_t)i;
+	}
+	MemoryReadStream source(buf, sizeof(buf));
+	{
+		BufferedReadStream stream(source, 16);
+		uint8_t byte;
+		EXPECT_EQ(0, stream.readUInt8(byte));
+		EXPECT_EQ(10, stream.seek(10));
+		EXPECT_EQ(0, stream.readUInt8(byte));
+		EXPECT_EQ(10u, byte);
+		EXPECT_EQ(40, stream.seek(29, SEEK_CUR));
+		EXPECT_EQ(0, stream.readUInt8(byte));
+		EXPECT_EQ(40u, byte);
+		EXPECT_EQ(2, stream.seek(2));
+		EXPECT_EQ(0, stream.readUInt8(byte));
+		EXPECT_EQ(2u, byte);
+		EXPECT_EQ(60, stream.seek(-4, SEEK_END));
+		uint32_t val;
+		EXPECT_EQ(0, stream.readUInt32BE(val));
+		EXPECT_EQ(0x3c3d3e3fu, val);
+		EXPECT_EQ(20, stream.seek(20));
+	}
+	EXPECT_EQ(20, source.pos()) << "The wrapped stream should continue at the position of the buffered stream";
+}
+
+TEST_F(BufferedReadStreamTest, testLargeRead) {
+	uint8_t buf[64];
+	for (int i = 0; i < lengthof(buf); ++i) {
+		buf[i] = (uint8_t)i;
+	}
+	MemoryReadStream source(buf, sizeof(buf));
+	BufferedReadStream stream(source, 8);
+	uint8_t byte;
+	EXPECT_EQ(0, stream.readUInt8(byte));
+	uint8_t target[40];
+	EXPECT_EQ((int)sizeof(target), stream.read(target, sizeof(target)));
+	for (int i = 0; i < lengthof(target); ++i) {
+		EXPECT_EQ((uint8_t)(i + 1), target[i]);
+	}
+	EXPECT_EQ(41, stream.pos());
+	core::String str;
+	EXPECT_TRUE(stream.readString(4, str));
+	EXPECT_EQ(4u, str.size());
+	EXPECT_EQ(41, (uint8_t)str[0]);
+	EXPECT_EQ(19, stream.remaining());
+}
+
+} // namespace io
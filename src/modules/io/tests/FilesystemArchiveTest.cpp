@@ -47,4 +47,16 @@ TEST_F(FilesystemArchiveTest, testFilesytemArchiveNoDir) {
 	EXPECT_TRUE(fsa.exists("iotest.txt"));
 }
 
+TEST_F(FilesystemArchiveTest, testReadStreamData) {
+	io::FilesystemArchive fsa(fs);
+	core::ScopedPtr<io::SeekableReadStream> rs(fsa.readStream("iotest.txt"));
+	ASSERT_TRUE(rs);
+	const uint8_t *data = rs->data();
+	ASSERT_NE(nullptr, data) << "Expected the file to be memory mapped";
+	EXPECT_EQ(0, SDL_memcmp(data, "WindowInfo", 10));
+	core::String str;
+	EXPECT_TRUE(rs->readString(10, str));
+	EXPECT_EQ("WindowInfo", str);
+}
+
 } // namespace io
@@ -6,6 +6,7 @@
 #include "app/tests/AbstractTest.h"
 #include "core/ArrayLength.h"
 #include "core/ScopedPtr.h"
+#include "io/BufferedReadWriteStream.h"
 #include "io/FileStream.h"
 #include "io/Filesystem.h"
 #include "io/Stream.h"
@@ -37,4 +38,101 @@ TEST_F(ZipArchiveTest, testZipArchive) {
 	EXPECT_EQ("dir/file.txt", files[2].fullPath);
 }
 
+TEST_F(ZipArchiveTest, testZipArchiveWrite) {
+	// more than one block to check that the independently compressed blocks are concatenated properly
+	const size_t bigSize = ZipArchive::BlockSize * 2 + 1234;
+	BufferedReadWriteStream zipStream;
+	{
+		ZipArchivePtr archive = createZipArchive(&zipStream);
+		ASSERT_TRUE(archive);
+		{
+			core::ScopedPtr<io::SeekableWriteStream> ws(archive->writeStream("dir/big.bin"));
+			ASSERT_TRUE(ws);
+			for (size_t i = 0; i < bigSize / 4; ++i) {
+				ASSERT_TRUE(ws->writeUInt32((uint32_t)(i * 2654435761u) >> (i % 13)));
+			}
+		}
+		{
+			core::ScopedPtr<io::SeekableWriteStream> ws(archive->writeStream("small.txt"));
+			ASSERT_TRUE(ws);
+			ASSERT_TRUE(ws->writeString("small file", false));
+		}
+		core::ScopedPtr<io::SeekableWriteStream> empty(archive->writeStream("empty.txt"));
+		ASSERT_TRUE(empty);
+		EXPECT_EQ(3u, archive->files().size());
+		ASSERT_TRUE(archive->flush());
+	}
+
+	zipStream.seek(0);
+	ArchivePtr archive = openZipArchive(&zipStream);
+	ASSERT_TRUE(archive);
+	ASSERT_EQ(3u, archive->files().size());
+	{
+		core::ScopedPtr<io::SeekableReadStream> rs(archive->readStream("dir/big.bin"));
+		ASSERT_TRUE(rs);
+		ASSERT_EQ((int64_t)(bigSize / 4 * 4), rs->size());
+		for (size_t i = 0; i < bigSize / 4; ++i) {
+			uint32_t val;
+			ASSERT_EQ(0, rs->readUInt32(val));
+			ASSERT_EQ((uint32_t)(i * 2654435761u) >> (i % 13), val) << "at " << i;
+		}
+	}
+	{
+		core::ScopedPtr<io::SeekableReadStream> rs(archive->readStream("small.txt"));
+		ASSERT_TRUE(rs);
+		core::String str;
+		ASSERT_TRUE(rs->readString((int)rs->size(), str));
+		EXPECT_EQ("small file", str);
+	}
+	core::ScopedPtr<io::SeekableReadStream> rs(archive->readStream("empty.txt"));
+	ASSERT_TRUE(rs);
+	EXPECT_EQ(0, rs->size());
+}
+
+TEST_F(ZipArchiveTest, testZipArchiveWriteStored) {
+	BufferedReadWriteStream zipStream;
+	ZipArchivePtr archive = createZipArchive(&zipStream, 0);
+	ASSERT_TRUE(archive);
+	{
+		core::ScopedPtr<io::SeekableWriteStream> ws(archive->writeStream("file.txt"));
+		ASSERT_TRUE(ws->writeString("stored", false));
+	}
+	ASSERT_TRUE(archive->flush());
+	EXPECT_EQ(nullptr, archive->writeStream("other.txt")) << "The archive was finalized";
+
+	zipStream.seek(0);
+	ArchivePtr readArchive = openZipArchive(&zipStream);
+	ASSERT_TRUE(readArchive);
+	core::ScopedPtr<io::SeekableReadStream> rs(readArchive->readStream("file.txt"));
+	ASSERT_TRUE(rs);
+	core::String str;
+	ASSERT_TRUE(rs->readString((int)rs->size(), str));
+	EXPECT_EQ("stored", str);
+}
+
+TEST_F(ZipArchiveTest, testZipArchiveRewriteEntry) {
+	BufferedReadWriteStream zipStream;
+	ZipArchivePtr archive = createZipArchive(&zipStream);
+	ASSERT_TRUE(archive);
+	{
+		core::ScopedPtr<io::SeekableWriteStream> ws(archive->writeStream("file.txt"));
+		ASSERT_TRUE(ws->writeString("a longer content", false));
+	}
+	{
+		core::ScopedPtr<io::SeekableWriteStream> ws(archive->writeStream("file.txt"));
+		ASSERT_TRUE(ws->writeString("short", false));
+	}
+	ASSERT_TRUE(archive->flush());
+
+	zipStream.seek(0);
+	ArchivePtr readArchive = openZipArchive(&zipStream);
+	ASSERT_TRUE(readArchive);
+	ASSERT_EQ(1u, readArchive->files().size());
+	core::ScopedPtr<io::SeekableReadStream> rs(readArchive->readStream("file.txt"));
+	ASSERT_TRUE(rs);
+	core::String str;
+	ASSERT_TRUE(rs->readString((int)rs->size(), str));
+	EXPECT_EQ("short", str);
+}
+
 } // namespace io
@@ -0,0 +1,51 @@
+/**
+ * @file
+ */
+
+#include "ColorHistogram.h"
+#include "core/Algorithm.h"
+
+namespace palette {
+
+void addColor(ColorHistogram &histogram, core::RGBA rgba, uint32_t count) {
+	auto iter = histogram.find(rgba);
+	if (iter == histogram.end()) {
+		histogram.put(rgba, count);
+	} else {
+		iter->value += count;
+	}
+}
+
+void addColors(ColorHistogram &histogram, const ColorHistogram &other) {
+	for (const auto &e : other) {
+		addColor(histogram, e->first, e->second);
+	}
+}
+
+void sortedColors(const ColorHistogram &histogram, core::Buffer<core::RGBA> &colors, core::Buffer<uint32_t> &weights) {
+	struct Entry {
+		core::RGBA color;
+		uint32_t weight;
+	};
+	core::Buffer<Entry> entries;
+	entries.reserve(histogram.size());
+	for (const auto &e : histogram) {
+		entries.push_back({e->first, e->second});
+	}
+	core::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) {
+		if (a.color.rgba != b.color.rgba) {
+			return a.color.rgba < b.color.rgba;
+		}
+		return a.weight < b.weight;
+	});
+	colors.clear();
+	weights.clear();
+	colors.reserve(entries.size());
+	weights.reserve(entries.size());
+	for (const Entry &e : entries) {
+		colors.push_back(e.color);
+		weights.push_back(e.weight);
+	}
+}
+
+} // namespace palette
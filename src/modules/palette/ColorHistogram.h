@@ -0,0 +1,36 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/RGBA.h"
+#include "core/collection/Buffer.h"
+#include "core/collection/DynamicMap.h"
+#include <stdint.h>
+
+namespace palette {
+
+/**
+ * @brief Color histogram - the value is the amount of pixels or voxels with the color
+ * @sa Palette::quantize()
+ */
+using ColorHistogram = core::DynamicMap<core::RGBA, uint32_t, 1031, core::RGBAHasher>;
+
+/**
+ * @brief Counts the given color in the histogram
+ */
+void addColor(ColorHistogram &histogram, core::RGBA rgba, uint32_t count = 1u);
+/**
+ * @brief Merges the counts of another histogram - e.g. one that was built by another thread
+ */
+void addColors(ColorHistogram &histogram, const ColorHistogram &other);
+/**
+ * @brief Fills the colors and their counts sorted by the color value and then by the count
+ *
+ * The iteration order of the map depends on the order the colors were inserted in - which isn't stable if the
+ * histogram was merged from several threads. The quantizers depend on the input order.
+ */
+void sortedColors(const ColorHistogram &histogram, core::Buffer<core::RGBA> &colors, core::Buffer<uint32_t> &weights);
+
+} // namespace palette
@@ -4,6 +4,7 @@
 
 #include "Palette.h"
 #include "app/App.h"
+#include "app/Async.h"
 #include "core/ArrayLength.h"
 #include "core/Color.h"
 #include "core/Common.h"
@@ -12,9 +13,11 @@
 #include "core/StandardLib.h"
 #include "core/String.h"
 #include "core/StringUtil.h"
+#include "core/Trace.h"
 #include "core/Var.h"
 #include "core/collection/Buffer.h"
-#include "core/collection/Set.h"
+#include "core/collection/DynamicMap.h"
+#include "core/concurrent/Lock.h"
 #include "engine-config.h"
 #include "http/HttpCacheStream.h"
 #include "image/Image.h"
@@ -123,13 +126,31 @@ void Palette::reduce(uint8_t targetColors) {
 }
 
 void Palette::quantize(const core::RGBA *inputColors, const size_t inputColorCount) {
+	quantize(inputColors, nullptr, inputColorCount);
+}
+
+void Palette::quantize(const core::RGBA *inputColors, const uint32_t *weights, const size_t inputColorCount) {
+	core_trace_scoped(PaletteQuantize);
 	Log::debug("quantize %i colors", (int)inputColorCount);
 	core::Color::ColorReductionType reductionType =
 		core::Color::toColorReductionType(core::Var::getSafe(cfg::CoreColorReduction)->strVal().c_str());
-	_colorCount = core::Color::quantize(_colors, lengthof(_colors), inputColors, inputColorCount, reductionType);
+	auto parallelFor = [](int start, int end, core::Color::ParallelForChunk func, void *userdata) {
+		app::for_parallel(start, end, [func, userdata](int chunkStart, int chunkEnd) {
+			func(chunkStart, chunkEnd, userdata);
+		});
+	};
+	_colorCount = core::Color::quantize(_colors, lengthof(_colors), inputColors, weights, inputColorCount,
+										reductionType, parallelFor);
 	markDirty();
 }
 
+void Palette::quantize(const ColorHistogram &histogram) {
+	core::Buffer<core::RGBA> colors;
+	core::Buffer<uint32_t> weights;
+	sortedColors(histogram, colors, weights);
+	quantize(colors.data(), weights.data(), colors.size());
+}
+
 bool Palette::hasColor(core::RGBA rgba) {
 	for (int i = 0; i < _colorCount; ++i) {
 		if (_colors[i] == rgba) {
@@ -935,22 +956,23 @@ bool Palette::createPalette(const image::ImagePtr &image, palette::Palette &pale
 		Log::error("Failed to convert image to palette - scale it down to max 512:512");
 		return false;
 	}
-	core::Set<core::RGBA> colorSet((size_t)(imageWidth * imageHeight));
 	Log::debug("Create palette for image: %s (%i:%i)", image->name().c_str(), imageWidth, imageHeight);
-	for (int x = 0; x < imageWidth; ++x) {
-		for (int y = 0; y < imageHeight; ++y) {
-			const core::RGBA data = image->colorAt(x, y);
-			colorSet.insert(data);
+	// the amount of pixels per color is used to weight the colors in the quantization
+	ColorHistogram histogram;
+	core_trace_mutex(core::Lock, lock, "CreatePalette");
+	app::for_parallel(0, imageHeight, [&image, &histogram, &lock, imageWidth](int start, int end) {
+		ColorHistogram local;
+		for (int y = start; y < end; ++y) {
+			for (int x = 0; x < imageWidth; ++x) {
+				addColor(local, image->colorAt(x, y));
+			}
 		}
-	}
+		core::ScopedLock scoped(lock);
+		addColors(histogram, local);
+	});
 
-	core::Buffer<core::RGBA, 1024> colors;
-	colors.reserve(colorSet.size());
-	for (const auto &e : colorSet) {
-		colors.push_back(e->first);
-	}
 	palette.setName(image->name());
-	palette.quantize(colors.data(), colors.size());
+	palette.quantize(histogram);
 	palette.markDirty();
 	return true;
 }
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include "ColorHistogram.h"
 #include "core/ArrayLength.h"
 #include "core/DirtyState.h"
 #include "core/String.h"
@@ -273,6 +274,15 @@ public:
 				int skipSlotIndex = -1);
 	bool hasColor(core::RGBA rgba);
 	void quantize(const core::RGBA *inputColors, const size_t inputColorCount);
+	/**
+	 * @param weights The amount of pixels or voxels of each input color - frequent colors get more influence on the
+	 * palette than rare colors
+	 */
+	void quantize(const core::RGBA *inputColors, const uint32_t *weights, const size_t inputColorCount);
+	/**
+	 * @brief Quantizes the colors of the histogram - the counts are used as weights
+	 */
+	void quantize(const ColorHistogram &histogram);
 
 	static const char* getDefaultPaletteName();
 	static core::String extractPaletteName(const core::String& file);
@@ -227,4 +227,33 @@ TEST_F(PaletteTest, testMaterialPropertyByName) {
 	EXPECT_FLOAT_EQ(palette.materialProperty(0, "emit"), 1.0f);
 }
 
+TEST_F(PaletteTest, testColorHistogramSortedColors) {
+	// the same histogram merged in a different order must give the same input for the quantizers
+	ColorHistogram a;
+	ColorHistogram b;
+	for (uint32_t i = 0; i < 2000; ++i) {
+		palette::addColor(a, core::RGBA(i * 7919u), i % 5 + 1);
+	}
+	for (uint32_t i = 2000; i > 0; --i) {
+		ColorHistogram local;
+		palette::addColor(local, core::RGBA((i - 1) * 7919u), (i - 1) % 5 + 1);
+		palette::addColors(b, local);
+	}
+	core::Buffer<core::RGBA> colorsA;
+	core::Buffer<uint32_t> weightsA;
+	core::Buffer<core::RGBA> colorsB;
+	core::Buffer<uint32_t> weightsB;
+	sortedColors(a, colorsA, weightsA);
+	sortedColors(b, colorsB, weightsB);
+	ASSERT_EQ(2000u, colorsA.size());
+	ASSERT_EQ(colorsA.size(), colorsB.size());
+	for (size_t i = 0; i < colorsA.size(); ++i) {
+		EXPECT_EQ(colorsA[i], colorsB[i]);
+		EXPECT_EQ(weightsA[i], weightsB[i]);
+		if (i > 0) {
+			EXPECT_LT(colorsA[i - 1].rgba, colorsA[i].rgba);
+		}
+	}
+}
+
 } // namespace voxel
@@ -63,6 +63,8 @@ SceneGraph &SceneGraph::operator=(SceneGraph &&other) noexcept {
 		_animations = core::move(other._animations);
 		_activeAnimation = core::move(other._activeAnimation);
 		_cachedMaxFrame = other._cachedMaxFrame;
+		markAnimationDirty();
+		other.markAnimationDirty();
 		_dirty = other.dirty();
 	}
 	return *this;
@@ -108,6 +110,7 @@ bool SceneGraph::duplicateAnimation(const core::String &animation, const core::S
 		}
 	}
 	updateTransforms_r(node(0));
+	markAnimationDirty();
 	return true;
 }
 
@@ -131,6 +134,7 @@ bool SceneGraph::removeAnimation(const core::String &animation) {
 	for (const auto &entry : _nodes) {
 		entry->value.removeAnimation(animation);
 	}
+	markAnimationDirty();
 	if (_animations.empty()) {
 		addAnimation(DEFAULT_ANIMATION);
 		setAnimation(DEFAULT_ANIMATION);
@@ -157,6 +161,25 @@ const core::String &SceneGraph::activeAnimation() const {
 
 void SceneGraph::markMaxFramesDirty() {
 	_cachedMaxFrame = -1;
+	markAnimationDirty();
+}
+
+void SceneGraph::markDirty() {
+	core::DirtyState::markDirty();
+	markAnimationDirty();
+}
+
+void SceneGraph::markAnimationDirty() const {
+	_animationCache.invalidate();
+	++_changeCounter;
+}
+
+uint32_t SceneGraph::changeCounter() const {
+	return _changeCounter;
+}
+
+void SceneGraph::bakeAnimation(const core::String &animation) const {
+	_animationCache.bake(*this, animation);
 }
 
 FrameIndex SceneGraph::maxFrames(const core::String &animation) const {
@@ -381,20 +404,15 @@ FrameTransform SceneGraph::transformForFrame(const SceneGraphNode &node, const c
 	// and https://github.com/vengi-voxel/vengi/issues/265
 	// TODO: solve flipping of child transforms if parent has rotation applied - see
 	// https://github.com/vengi-voxel/vengi/issues/420
+	core_assert(frameIdx >= 0);
+	FrameTransform transform;
+	if (_animationCache.transformForFrame(*this, node, animation, frameIdx, transform)) {
+		return transform;
+	}
+	// the node is not part of the hierarchy (yet)
 	const AnimState source = transformFrameSource_r(node, animation, frameIdx);
 	const AnimState target = transformFrameTarget_r(node, animation, frameIdx);
-	const FrameIndex startFrameIdx = source.frameIdx;
-	const InterpolationType interpolationType = source.interpolation;
-	const FrameIndex endFrameIdx = target.frameIdx;
-	const double deltaFrameSeconds =
-		scenegraph::interpolate(interpolationType, (double)frameIdx, (double)startFrameIdx, (double)endFrameIdx);
-	const float factor = glm::clamp((float)(deltaFrameSeconds - (double)startFrameIdx), 0.0f, 1.0f);
-
-	FrameTransform transform;
-	transform.translation = glm::mix(source.transform.translation, target.transform.translation, factor);
-	transform.orientation = glm::slerp(source.transform.orientation, target.transform.orientation, factor);
-	transform.scale = glm::mix(source.transform.scale, target.transform.scale, factor);
-	return transform;
+	return SceneGraphAnimationCache::interpolate(source, target, frameIdx);
 }
 
 void SceneGraph::updateTransforms_r(SceneGraphNode &n) {
@@ -407,6 +425,7 @@ void SceneGraph::updateTransforms_r(SceneGraphNode &n) {
 }
 
 void SceneGraph::updateTransforms() {
+	markAnimationDirty();
 	const core::String animId = _activeAnimation;
 	for (const core::String &animation : animations()) {
 		core_assert_always(setAnimation(animation));
@@ -604,6 +623,7 @@ bool SceneGraph::changeParent(int nodeId, int newParentId, bool updateTransform)
 		return false;
 	}
 	n.setParent(newParentId);
+	markAnimationDirty();
 	if (updateTransform) {
 		const SceneGraphNode &parentNode = node(newParentId);
 		for (const core::String &animation : animations()) {
@@ -654,6 +674,7 @@ bool SceneGraph::removeNode(int nodeId, bool recursive) {
 		}
 	}
 	core_assert_always(_nodes.erase(iter));
+	markAnimationDirty();
 	if (_activeNodeId == nodeId) {
 		if (!empty(SceneGraphNodeType::Model)) {
 			// get the first model node
@@ -700,6 +721,7 @@ void SceneGraph::clear() {
 	}
 	_nodes.clear();
 	_nextNodeId = 1;
+	markAnimationDirty();
 
 	SceneGraphNode node(SceneGraphNodeType::Root);
 	node.setName("root");
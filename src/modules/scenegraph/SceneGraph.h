@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "SceneGraphAnimationCache.h"
 #include "SceneGraphNode.h"
 #include "core/DirtyState.h"
 #include "core/Pair.h"
@@ -22,20 +23,6 @@ namespace scenegraph {
 using SceneGraphAnimationIds = core::DynamicArray<core::String>;
 using SceneGraphNodes = core::Map<int, SceneGraphNode, 251>;
 
-struct FrameTransform {
-	glm::mat4 worldMatrix() const;
-	glm::quat orientation;
-	glm::vec3 translation;
-	glm::vec3 scale;
-};
-
-struct AnimState {
-	FrameTransform transform;
-	FrameIndex frameIdx = 0;
-	InterpolationType interpolation = InterpolationType::Linear;
-	bool longRotation = false;
-};
-
 /**
  * @brief The internal format for the save/load methods.
  *
@@ -50,6 +37,8 @@ protected:
 	SceneGraphAnimationIds _animations;
 	core::String _activeAnimation;
 	mutable FrameIndex _cachedMaxFrame = -1;
+	mutable SceneGraphAnimationCache _animationCache;
+	mutable uint32_t _changeCounter = 0u;
 
 	void updateTransforms_r(SceneGraphNode &node);
 	AnimState transformFrameSource_r(const SceneGraphNode &node, const core::String &animation,
@@ -133,6 +122,24 @@ public:
 	 */
 	FrameTransform transformForFrame(const SceneGraphNode &node, FrameIndex frameIdx) const;
 	FrameTransform transformForFrame(const SceneGraphNode &node, const core::String &animation, FrameIndex frameIdx) const;
+	/**
+	 * @brief Evaluates the transforms of all nodes for every frame of the given animation - @c transformForFrame() is a
+	 * table lookup afterwards until the key frames or the hierarchy are modified
+	 * @sa SceneGraphAnimationCache
+	 */
+	void bakeAnimation(const core::String &animation) const;
+	/**
+	 * @brief Drops the compiled and baked animations
+	 * @note Called for every change of the key frames that the scene graph knows about - the cache is not observable
+	 * from the outside, that's why this is @c const
+	 */
+	void markAnimationDirty() const;
+	/**
+	 * @brief Increased for every change of the hierarchy, the key frames or the transforms that the scene graph knows
+	 * about - consumers like the renderer can compare it to skip their work for unchanged scenes
+	 * @note Changes of the node properties (e.g. the visibility) are not tracked
+	 */
+	uint32_t changeCounter() const;
 
 	/**
 	 * @brief Change the active animation for all nodes to the given animation
@@ -142,7 +149,11 @@ public:
 	const core::String &activeAnimation() const;
 
 	void updateTransforms();
+	/**
+	 * @brief Must be called after the key frames were modified - this also drops the compiled animations
+	 */
 	void markMaxFramesDirty();
+	void markDirty() override;
 
 	/**
 	 * @brief We move into the scene graph to make it clear who is owning the volume.
@@ -0,0 +1,215 @@
+/**
+ * @file
+ */
+
+#include "SceneGraphAnimationCache.h"
+#include "SceneGraph.h"
+#include "SceneGraphNode.h"
+#include "SceneGraphUtil.h"
+#include <glm/common.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+namespace scenegraph {
+
+/**
+ * @return The index of the first key frame with a frame index greater than the given frame index - or the amount of
+ * key frames if there is none
+ */
+static int upperBound(const FrameIndex *frames, int n, FrameIndex frameIdx) {
+	int lo = 0;
+	int hi = n;
+	while (lo < hi) {
+		const int mid = (lo + hi) / 2;
+		if (frames[mid] <= frameIdx) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	return lo;
+}
+
+static inline void toFrameTransform(const SceneGraphTransform &transform, FrameTransform &world,
+									FrameTransform &local) {
+	world.orientation = transform.worldOrientation();
+	world.translation = transform.worldTranslation();
+	world.scale = transform.worldScale();
+	local.orientation = transform.localOrientation();
+	local.translation = transform.localTranslation();
+	local.scale = transform.localScale();
+}
+
+FrameTransform SceneGraphAnimationCache::interpolate(const AnimState &source, const AnimState &target,
+													 FrameIndex frameIdx) {
+	const FrameIndex startFrameIdx = source.frameIdx;
+	const InterpolationType interpolationType = source.interpolation;
+	const FrameIndex endFrameIdx = target.frameIdx;
+	const double deltaFrameSeconds =
+		scenegraph::interpolate(interpolationType, (double)frameIdx, (double)startFrameIdx, (double)endFrameIdx);
+	const float factor = glm::clamp((float)(deltaFrameSeconds - (double)startFrameIdx), 0.0f, 1.0f);
+
+	FrameTransform transform;
+	transform.translation = glm::mix(source.transform.translation, target.transform.translation, factor);
+	transform.orientation = glm::slerp(source.transform.orientation, target.transform.orientation, factor);
+	transform.scale = glm::mix(source.transform.scale, target.transform.scale, factor);
+	return transform;
+}
+
+void SceneGraphAnimationCache::invalidate() {
+	core::ScopedLock lock(_lock);
+	_animations.clear();
+}
+
+SceneGraphAnimationCache::CompiledAnimation &SceneGraphAnimationCache::compile(const SceneGraph &sceneGraph,
+																			   const core::String &animation) {
+	for (CompiledAnimation &compiled : _animations) {
+		if (compiled.animation == animation) {
+			return compiled;
+		}
+	}
+	core_trace_scoped(CompileAnimation);
+	_animations.emplace_back();
+	CompiledAnimation &compiled = _animations.back();
+	compiled.animation = animation;
+	int maxNodeId = 0;
+	for (auto entry : sceneGraph.nodes()) {
+		maxNodeId = core_max(maxNodeId, entry->key);
+	}
+	compiled.nodeIndex.resize(maxNodeId + 1);
+	compiled.nodeIndex.fill(-1);
+
+	// breadth first to have the parents before their children
+	const SceneGraphNode &root = sceneGraph.root();
+	compiled.nodes.push_back({root.id(), -1, 0, 0});
+	for (size_t i = 0; i < compiled.nodes.size(); ++i) {
+		const int nodeId = compiled.nodes[i].nodeId;
+		compiled.nodeIndex[nodeId] = (int)i;
+		for (int childId : sceneGraph.node(nodeId).children()) {
+			compiled.nodes.push_back({childId, (int)i, 0, 0});
+		}
+	}
+
+	for (CompiledNode &compiledNode : compiled.nodes) {
+		const SceneGraphNode &node = sceneGraph.node(compiledNode.nodeId);
+		core_assert(node.keyFramesValidate());
+		// a node without key frames behaves like a node with one default key frame
+		static const SceneGraphKeyFrames defaultKeyFrames{SceneGraphKeyFrame{}};
+		const SceneGraphKeyFrames &nodeKeyFrames = node.keyFrames(animation);
+		const SceneGraphKeyFrames &keyFrames = nodeKeyFrames.empty() ? defaultKeyFrames : nodeKeyFrames;
+		compiledNode.firstKeyFrame = (int)compiled.frames.size();
+		compiledNode.keyFrameCount = (int)keyFrames.size();
+		for (const SceneGraphKeyFrame &keyFrame : keyFrames) {
+			KeyFrameState state;
+			toFrameTransform(keyFrame.transform(), state.world, state.local);
+			state.interpolation = keyFrame.interpolation;
+			state.longRotation = keyFrame.longRotation;
+			compiled.frames.push_back(keyFrame.frameIdx);
+			compiled.keyFrames.push_back(state);
+			compiled.maxFrame = core_max(compiled.maxFrame, keyFrame.frameIdx);
+		}
+	}
+	compiled.memo.resize(compiled.nodes.size());
+	compiled.sources.resize(compiled.nodes.size());
+	compiled.targets.resize(compiled.nodes.size());
+	return compiled;
+}
+
+void SceneGraphAnimationCache::evaluate(CompiledAnimation &compiled, FrameIndex frameIdx, FrameTransform *out) const {
+	core_trace_scoped(EvaluateAnimation);
+	auto setState = [](AnimState &state, const KeyFrameState &keyFrame, FrameIndex keyFrameIdx) {
+		state.transform = keyFrame.world;
+		state.frameIdx = keyFrameIdx;
+		state.interpolation = keyFrame.interpolation;
+		state.longRotation = keyFrame.longRotation;
+	};
+	auto applyLocal = [](AnimState &state, const KeyFrameState &keyFrame) {
+		state.transform.orientation *= keyFrame.local.orientation;
+		state.transform.translation += keyFrame.local.translation;
+		state.transform.scale *= keyFrame.local.scale;
+	};
+	const int n = (int)compiled.nodes.size();
+	for (int i = 0; i < n; ++i) {
+		const CompiledNode &compiledNode = compiled.nodes[i];
+		const int count = compiledNode.keyFrameCount;
+		const FrameIndex *frames = compiled.frames.data() + compiledNode.firstKeyFrame;
+		const KeyFrameState *keyFrames = compiled.keyFrames.data() + compiledNode.firstKeyFrame;
+		const int next = upperBound(frames, count, frameIdx);
+
+		// the source is the key frame at or before the given frame - the parent transforms are applied if there is
+		// no exact match
+		AnimState &source = compiled.sources[i];
+		if (next > 0 && frames[next - 1] == frameIdx) {
+			setState(source, keyFrames[next - 1], frames[next - 1]);
+		} else {
+			const int bestFit = next > 0 ? next - 1 : 0;
+			if (compiledNode.parentIdx == -1) {
+				setState(source, keyFrames[bestFit], frames[bestFit]);
+			} else {
+				source = compiled.sources[compiledNode.parentIdx];
+				applyLocal(source, keyFrames[bestFit]);
+			}
+		}
+
+		// the target is the first key frame after the given frame - the parent transforms are applied if there is
+		// none
+		AnimState &target = compiled.targets[i];
+		if (next < count) {
+			setState(target, keyFrames[next], frames[next]);
+		} else if (compiledNode.parentIdx == -1) {
+			setState(target, keyFrames[count - 1], frames[count - 1]);
+		} else {
+			target = compiled.targets[compiledNode.parentIdx];
+			applyLocal(target, keyFrames[count - 1]);
+		}
+		out[i] = interpolate(source, target, frameIdx);
+	}
+}
+
+bool SceneGraphAnimationCache::transformForFrame(const SceneGraph &sceneGraph, const SceneGraphNode &node,
+												 const core::String &animation, FrameIndex frameIdx,
+												 FrameTransform &transform) {
+	core::ScopedLock lock(_lock);
+	CompiledAnimation &compiled = compile(sceneGraph, animation);
+	const int nodeId = node.id();
+	if (nodeId < 0 || nodeId >= (int)compiled.nodeIndex.size() || compiled.nodeIndex[nodeId] == -1) {
+		return false;
+	}
+	const int idx = compiled.nodeIndex[nodeId];
+	const size_t n = compiled.nodes.size();
+	if (!compiled.baked.empty() && frameIdx <= compiled.maxFrame) {
+		transform = compiled.baked[(size_t)frameIdx * n + idx];
+		return true;
+	}
+	if (compiled.memoFrameIdx != frameIdx) {
+		evaluate(compiled, frameIdx, compiled.memo.data());
+		compiled.memoFrameIdx = frameIdx;
+	}
+	transform = compiled.memo[idx];
+	return true;
+}
+
+void SceneGraphAnimationCache::bake(const SceneGraph &sceneGraph, const core::String &animation) {
+	core::ScopedLock lock(_lock);
+	CompiledAnimation &compiled = compile(sceneGraph, animation);
+	if (!compiled.baked.empty()) {
+		return;
+	}
+	core_trace_scoped(BakeAnimation);
+	const size_t n = compiled.nodes.size();
+	compiled.baked.resize((size_t)(compiled.maxFrame + 1) * n);
+	for (FrameIndex frameIdx = 0; frameIdx <= compiled.maxFrame; ++frameIdx) {
+		evaluate(compiled, frameIdx, compiled.baked.data() + (size_t)frameIdx * n);
+	}
+}
+
+bool SceneGraphAnimationCache::baked(const core::String &animation) const {
+	core::ScopedLock lock(_lock);
+	for (const CompiledAnimation &compiled : _animations) {
+		if (compiled.animation == animation) {
+			return !compiled.baked.empty();
+		}
+	}
+	return false;
+}
+
+} // namespace scenegraph
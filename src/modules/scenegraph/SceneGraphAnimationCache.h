@@ -0,0 +1,101 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "SceneGraphKeyFrame.h"
+#include "core/String.h"
+#include "core/Trace.h"
+#include "core/collection/DynamicArray.h"
+#include "core/concurrent/Lock.h"
+
+namespace scenegraph {
+
+class SceneGraph;
+class SceneGraphNode;
+
+/**
+ * @brief Compiled key frames of all nodes to evaluate the transforms of the whole scene graph for a frame in one pass
+ *
+ * The key frames of every animation are flattened into arrays in a parent-before-child order of the nodes. Looking up
+ * the key frames for a frame is a binary search. The transforms of all nodes are evaluated at once and memoized for
+ * the last requested frame of each animation. An animation can optionally be baked into a table of transforms for
+ * every frame - e.g. for the playback in the timeline.
+ *
+ * @note The cache doesn't observe the nodes - @c invalidate() must be called for every modification of the key frames
+ * or the hierarchy. The @c SceneGraph does this in @c markDirty() and @c markMaxFramesDirty().
+ * @sa SceneGraph::transformForFrame()
+ * @ingroup SceneGraph
+ */
+class SceneGraphAnimationCache {
+private:
+	struct KeyFrameState {
+		FrameTransform world;
+		FrameTransform local;
+		InterpolationType interpolation;
+		bool longRotation;
+	};
+
+	struct CompiledNode {
+		int nodeId;
+		// index into the compiled nodes - -1 for the root node
+		int parentIdx;
+		// the key frame range in the flattened key frame arrays
+		int firstKeyFrame;
+		int keyFrameCount;
+	};
+
+	struct CompiledAnimation {
+		core::String animation;
+		core::DynamicArray<CompiledNode> nodes;
+		// node id to compiled node index - -1 if the node isn't part of the hierarchy
+		core::DynamicArray<int> nodeIndex;
+		// the frame indices of the key frames - sorted per node for the binary search
+		core::DynamicArray<FrameIndex> frames;
+		core::DynamicArray<KeyFrameState> keyFrames;
+		FrameIndex maxFrame = 0;
+
+		FrameIndex memoFrameIdx = InvalidFrame;
+		core::DynamicArray<FrameTransform> memo;
+		core::DynamicArray<AnimState> sources;
+		core::DynamicArray<AnimState> targets;
+
+		// (maxFrame + 1) * nodes.size() transforms - empty if the animation is not baked
+		core::DynamicArray<FrameTransform> baked;
+	};
+
+	// there are only a few animations per scene - a linear search is fine here
+	core::DynamicArray<CompiledAnimation> _animations;
+	mutable core_trace_mutex(core::Lock, _lock, "SceneGraphAnimationCache");
+
+	CompiledAnimation &compile(const SceneGraph &sceneGraph, const core::String &animation);
+	void evaluate(CompiledAnimation &compiled, FrameIndex frameIdx, FrameTransform *out) const;
+
+public:
+	/**
+	 * @brief Interpolates between the key frame states around the given frame
+	 */
+	static FrameTransform interpolate(const AnimState &source, const AnimState &target, FrameIndex frameIdx);
+
+	/**
+	 * @brief Drops all compiled, memoized and baked animations
+	 */
+	void invalidate();
+
+	/**
+	 * @param[out] transform The interpolated world transform of the node
+	 * @return @c false if the node is not part of the scene graph hierarchy
+	 */
+	bool transformForFrame(const SceneGraph &sceneGraph, const SceneGraphNode &node, const core::String &animation,
+						   FrameIndex frameIdx, FrameTransform &transform);
+
+	/**
+	 * @brief Evaluates the transforms of all nodes for all frames of the given animation
+	 * @note The table is dropped with the next call to @c invalidate()
+	 */
+	void bake(const SceneGraph &sceneGraph, const core::String &animation);
+	bool baked(const core::String &animation) const;
+};
+
+} // namespace scenegraph
@@ -57,4 +57,18 @@ public:
 using SceneGraphKeyFrames = core::DynamicArray<SceneGraphKeyFrame>;
 using SceneGraphKeyFramesMap = core::StringMap<SceneGraphKeyFrames>;
 
+struct FrameTransform {
+	glm::mat4 worldMatrix() const;
+	glm::quat orientation;
+	glm::vec3 translation;
+	glm::vec3 scale;
+};
+
+struct AnimState {
+	FrameTransform transform;
+	FrameIndex frameIdx = 0;
+	InterpolationType interpolation = InterpolationType::Linear;
+	bool longRotation = false;
+};
+
 }; // namespace scenegraph
@@ -251,6 +251,8 @@ void SceneGraphTransform::update(const SceneGraph &sceneGraph, SceneGraphNode &n
 		Log::warn("Node not yet part of the scene graph - don't perform any update");
 		return;
 	}
+	// the compiled animations are based on the old values
+	sceneGraph.markAnimationDirty();
 
 	if (_dirty & DIRTY_WORLDVALUES) {
 		core_assert_msg((_dirty & DIRTY_LOCALVALUES) == 0u, "local and world were modified");
@@ -7,9 +7,11 @@
 #include "app/tests/AbstractTest.h"
 #include "palette/Palette.h"
 #include "scenegraph/SceneGraphNode.h"
+#include "scenegraph/SceneGraphUtil.h"
 #include "voxel/RawVolume.h"
 #include "voxel/Region.h"
 #include "voxel/Voxel.h"
+#include <glm/gtc/epsilon.hpp>
 #include <glm/gtc/quaternion.hpp>
 
 namespace scenegraph {
@@ -586,6 +588,121 @@ TEST_F(SceneGraphTest, testKeyFrameTransformParentRotation2) {
 	}
 }
 
+TEST_F(SceneGraphTest, testKeyFrameTransformInvalidate) {
+	SceneGraph sceneGraph;
+	voxel::RawVolume v(voxel::Region(0, 0));
+	int nodeId;
+	{
+		SceneGraphNode node(SceneGraphNodeType::Model);
+		node.setVolume(&v, false);
+		nodeId = sceneGraph.emplace(core::move(node));
+	}
+	SceneGraphNode &node = sceneGraph.node(nodeId);
+	EXPECT_EQ(1, node.addKeyFrame(10));
+	node.keyFrame(1).transform().setWorldTranslation(glm::vec3(10.0f, 0.0f, 0.0f));
+	sceneGraph.updateTransforms();
+	EXPECT_FLOAT_EQ(5.0f, sceneGraph.transformForFrame(node, 5).translation.x);
+
+	node.keyFrame(1).transform().setWorldTranslation(glm::vec3(20.0f, 0.0f, 0.0f));
+	sceneGraph.updateTransforms();
+	EXPECT_FLOAT_EQ(10.0f, sceneGraph.transformForFrame(node, 5).translation.x)
+		<< "The compiled animation wasn't invalidated";
+
+	EXPECT_FLOAT_EQ(20.0f, sceneGraph.transformForFrame(node, 20).translation.x);
+	EXPECT_EQ(2, node.addKeyFrame(20));
+	node.keyFrame(2).transform().setWorldTranslation(glm::vec3(40.0f, 0.0f, 0.0f));
+	sceneGraph.updateTransforms();
+	EXPECT_FLOAT_EQ(40.0f, sceneGraph.transformForFrame(node, 20).translation.x);
+}
+
+/**
+ * @brief Exposes the recursive key frame evaluation that was used before the animation cache was introduced
+ */
+class LegacySceneGraph : public SceneGraph {
+public:
+	FrameTransform legacyTransformForFrame(const SceneGraphNode &node, FrameIndex frameIdx) const {
+		const AnimState source = transformFrameSource_r(node, activeAnimation(), frameIdx);
+		const AnimState target = transformFrameTarget_r(node, activeAnimation(), frameIdx);
+		const FrameIndex startFrameIdx = source.frameIdx;
+		const FrameIndex endFrameIdx = target.frameIdx;
+		const double deltaFrameSeconds =
+			interpolate(source.interpolation, (double)frameIdx, (double)startFrameIdx, (double)endFrameIdx);
+		const float factor = glm::clamp((float)(deltaFrameSeconds - (double)startFrameIdx), 0.0f, 1.0f);
+		FrameTransform transform;
+		transform.translation = glm::mix(source.transform.translation, target.transform.translation, factor);
+		transform.orientation = glm::slerp(source.transform.orientation, target.transform.orientation, factor);
+		transform.scale = glm::mix(source.transform.scale, target.transform.scale, factor);
+		return transform;
+	}
+};
+
+static void expectLegacyTransforms(const LegacySceneGraph &sceneGraph, FrameIndex maxFrame) {
+	for (FrameIndex frameIdx = 0; frameIdx <= maxFrame; ++frameIdx) {
+		for (auto iter = sceneGraph.beginModel(); iter != sceneGraph.end(); ++iter) {
+			const FrameTransform &expected = sceneGraph.legacyTransformForFrame(*iter, frameIdx);
+			const FrameTransform &transform = sceneGraph.transformForFrame(*iter, frameIdx);
+			EXPECT_TRUE(glm::all(glm::epsilonEqual(expected.translation, transform.translation, 0.0001f)))
+				<< "node " << (*iter).id() << " frame " << frameIdx << ": " << expected.translation << " vs "
+				<< transform.translation;
+			EXPECT_TRUE(glm::all(glm::epsilonEqual(expected.scale, transform.scale, 0.0001f)))
+				<< "node " << (*iter).id() << " frame " << frameIdx << ": " << expected.scale << " vs "
+				<< transform.scale;
+			EXPECT_TRUE(glm::all(glm::epsilonEqual(expected.orientation, transform.orientation, 0.0001f)))
+				<< "node " << (*iter).id() << " frame " << frameIdx;
+		}
+	}
+}
+
+TEST_F(SceneGraphTest, testKeyFrameTransformBake) {
+	LegacySceneGraph sceneGraph;
+	voxel::RawVolume v(voxel::Region(0, 0));
+	int parent = sceneGraph.root().id();
+	for (int i = 0; i < 8; ++i) {
+		SceneGraphNode node(SceneGraphNodeType::Model);
+		node.setVolume(&v, false);
+		SceneGraphTransform transform;
+		transform.setLocalTranslation(glm::vec3((float)i, 0.0f, 0.0f));
+		node.setTransform(0, transform);
+		node.keyFrame(0).interpolation = (InterpolationType)(i % (int)InterpolationType::Max);
+		// the key frames of the nodes don't line up - children have to interpolate their parents key frames
+		for (int k = 1; k <= 3; ++k) {
+			const KeyFrameIndex keyFrameIdx = node.addKeyFrame(k * (3 + i));
+			SceneGraphKeyFrame &keyFrame = node.keyFrame(keyFrameIdx);
+			keyFrame.interpolation = (InterpolationType)((i + k) % (int)InterpolationType::Max);
+			SceneGraphTransform &keyFrameTransform = keyFrame.transform();
+			keyFrameTransform.setLocalTranslation(glm::vec3((float)i, (float)(i * k), (float)-k));
+			keyFrameTransform.setLocalOrientation(glm::quat(glm::vec3(0.0f, glm::radians(10.0f * (float)k), 0.0f)));
+			keyFrameTransform.setLocalScale(glm::vec3(1.0f + 0.1f * (float)k));
+		}
+		parent = sceneGraph.emplace(core::move(node), parent);
+	}
+	sceneGraph.updateTransforms();
+
+	const FrameIndex maxFrame = sceneGraph.maxFrames(sceneGraph.activeAnimation()) + 5;
+	// evaluated on demand by the cache
+	expectLegacyTransforms(sceneGraph, maxFrame);
+	// evaluated from the baked table
+	sceneGraph.bakeAnimation(sceneGraph.activeAnimation());
+	expectLegacyTransforms(sceneGraph, maxFrame);
+}
+
+TEST_F(SceneGraphTest, testChangeCounter) {
+	SceneGraph sceneGraph;
+	voxel::RawVolume v(voxel::Region(0, 0));
+	uint32_t changes = sceneGraph.changeCounter();
+	SceneGraphNode node(SceneGraphNodeType::Model);
+	node.setVolume(&v, false);
+	const int nodeId = sceneGraph.emplace(core::move(node));
+	EXPECT_NE(changes, sceneGraph.changeCounter()) << "Adding a node must be detected";
+	changes = sceneGraph.changeCounter();
+	EXPECT_EQ(changes, sceneGraph.changeCounter());
+	sceneGraph.updateTransforms();
+	EXPECT_NE(changes, sceneGraph.changeCounter()) << "Updating the transforms must be detected";
+	changes = sceneGraph.changeCounter();
+	ASSERT_TRUE(sceneGraph.removeNode(nodeId, false));
+	EXPECT_NE(changes, sceneGraph.changeCounter()) << "Removing a node must be detected";
+}
+
 TEST_F(SceneGraphTest, testSceneRegion) {
 	SceneGraph sceneGraph;
 	voxel::RawVolume v(voxel::Region(-3, 3));
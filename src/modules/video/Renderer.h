@@ -124,6 +124,16 @@ inline void drawElements(Primitive mode, size_t numIndices, size_t indexSize, vo
 	drawElements(mode, numIndices, mapIndexTypeBySize(indexSize), offset);
 }
 
+inline void drawElementsInstanced(Primitive mode, size_t numIndices, size_t indexSize, size_t amount,
+								  void *offset = nullptr) {
+	drawElementsInstanced(mode, numIndices, mapIndexTypeBySize(indexSize), amount, offset);
+}
+
+inline void drawElementsInstancedBaseVertex(Primitive mode, size_t numIndices, size_t indexSize, size_t amount,
+											int baseVertex, void *offset = nullptr) {
+	drawElementsInstancedBaseVertex(mode, numIndices, mapIndexTypeBySize(indexSize), amount, baseVertex, offset);
+}
+
 inline bool hasFeature(Feature feature) {
 	return renderState().supports(feature);
 }
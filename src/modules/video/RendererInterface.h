@@ -152,6 +152,15 @@ void setupTexture(const TextureConfig &config);
 void uploadTexture(video::TextureType type, video::TextureFormat format, int width, int height, const uint8_t *data,
 				   int index, int samples);
 void drawElements(Primitive mode, size_t numIndices, DataType type, void *offset = nullptr);
+/**
+ * @brief Renders the bound indices @c amount times - the shaders can use @c gl_InstanceID to look up per instance data
+ */
+void drawElementsInstanced(Primitive mode, size_t numIndices, DataType type, size_t amount, void *offset = nullptr);
+/**
+ * @brief Like @c drawElementsInstanced() - but @c baseVertex is added to every index before the vertex is fetched
+ */
+void drawElementsInstancedBaseVertex(Primitive mode, size_t numIndices, DataType type, size_t amount, int baseVertex,
+									 void *offset = nullptr);
 void drawArrays(Primitive mode, size_t count);
 void enableDebug(DebugSeverity severity);
 bool compileShader(Id id, ShaderType shaderType, const core::String &source, const core::String &name = "unknown-shader");
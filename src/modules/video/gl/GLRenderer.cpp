@@ -1364,6 +1364,40 @@ void drawElements(Primitive mode, size_t numIndices, DataType type, void *offset
 	checkError();
 }
 
+void drawElementsInstanced(Primitive mode, size_t numIndices, DataType type, size_t amount, void *offset) {
+	video_trace_scoped(DrawElementsInstanced);
+	if (numIndices <= 0 || amount <= 0) {
+		return;
+	}
+	core_assert_msg(glstate().vertexArrayHandle != InvalidId, "No vertex buffer is bound for this draw call");
+	const GLenum glMode = _priv::Primitives[core::enumVal(mode)];
+	const GLenum glType = _priv::DataTypes[core::enumVal(type)];
+	video::validate(glstate().programHandle);
+	core_assert(glDrawElementsInstanced != nullptr);
+	glDrawElementsInstanced(glMode, (GLsizei)numIndices, glType, (GLvoid *)offset, (GLsizei)amount);
+	checkError();
+}
+
+void drawElementsInstancedBaseVertex(Primitive mode, size_t numIndices, DataType type, size_t amount, int baseVertex,
+									 void *offset) {
+	if (baseVertex == 0) {
+		drawElementsInstanced(mode, numIndices, type, amount, offset);
+		return;
+	}
+	video_trace_scoped(DrawElementsInstancedBaseVertex);
+	if (numIndices <= 0 || amount <= 0) {
+		return;
+	}
+	core_assert_msg(glstate().vertexArrayHandle != InvalidId, "No vertex buffer is bound for this draw call");
+	const GLenum glMode = _priv::Primitives[core::enumVal(mode)];
+	const GLenum glType = _priv::DataTypes[core::enumVal(type)];
+	video::validate(glstate().programHandle);
+	core_assert(glDrawElementsInstancedBaseVertex != nullptr);
+	glDrawElementsInstancedBaseVertex(glMode, (GLsizei)numIndices, glType, (GLvoid *)offset, (GLsizei)amount,
+									  (GLint)baseVertex);
+	checkError();
+}
+
 void drawArrays(Primitive mode, size_t count) {
 	video_trace_scoped(DrawArrays);
 	const GLenum glMode = _priv::Primitives[core::enumVal(mode)];
@@ -394,6 +394,13 @@ void uploadTexture(video::TextureType type, video::TextureFormat format, int wid
 void drawElements(Primitive mode, size_t numIndices, DataType type, void *offset) {
 }
 
+void drawElementsInstanced(Primitive mode, size_t numIndices, DataType type, size_t amount, void *offset) {
+}
+
+void drawElementsInstancedBaseVertex(Primitive mode, size_t numIndices, DataType type, size_t amount, int baseVertex,
+									 void *offset) {
+}
+
 void drawArrays(Primitive mode, size_t count) {
 }
 
@@ -0,0 +1,311 @@
+/**
+ * @file
+ */
+
+#include "BitVolume.h"
+#include "core/collection/DynamicArray.h"
+#include <glm/common.hpp>
+#include <limits>
+
+namespace voxel {
+
+bool BitVolume::isEmpty(const Brick &brick) {
+	for (int z = 0; z < BrickSize; ++z) {
+		if (brick.words[z] != 0u) {
+			return false;
+		}
+	}
+	return true;
+}
+
+uint64_t BitVolume::sliceMask(int x0, int x1, int y0, int y1) {
+	const uint64_t row = (((uint64_t)1 << (x1 - x0 + 1)) - 1u) << x0;
+	uint64_t mask = 0u;
+	for (int y = y0; y <= y1; ++y) {
+		mask |= row << (y << BrickShift);
+	}
+	return mask;
+}
+
+BitVolume::Brick &BitVolume::writeBrick(const glm::ivec3 &brickPos) {
+	auto iter = _bricks.find(brickPos);
+	if (iter == _bricks.end()) {
+		_bricks.put(brickPos, Brick{});
+		iter = _bricks.find(brickPos);
+	}
+	return iter->value;
+}
+
+void BitVolume::set(int x, int y, int z, bool value) {
+	const glm::ivec3 brickPos(x >> BrickShift, y >> BrickShift, z >> BrickShift);
+	const int bit = (x & (BrickSize - 1)) + ((y & (BrickSize - 1)) << BrickShift);
+	const uint64_t mask = (uint64_t)1 << bit;
+	if (value) {
+		writeBrick(brickPos).words[z & (BrickSize - 1)] |= mask;
+		return;
+	}
+	auto iter = _bricks.find(brickPos);
+	if (iter == _bricks.end()) {
+		return;
+	}
+	iter->value.words[z & (BrickSize - 1)] &= ~mask;
+	if (isEmpty(iter->value)) {
+		_bricks.remove(brickPos);
+	}
+}
+
+/**
+ * @brief Calls the given functor for every brick that intersects the region with the brick local z range and the
+ * slice mask of the intersection
+ */
+template<class FUNC>
+static void visitRegionBricks(const Region &region, FUNC &&func) {
+	const glm::ivec3 &mins = region.getLowerCorner();
+	const glm::ivec3 &maxs = region.getUpperCorner();
+	const glm::ivec3 brickMins = mins >> BitVolume::BrickShift;
+	const glm::ivec3 brickMaxs = maxs >> BitVolume::BrickShift;
+	for (int bz = brickMins.z; bz <= brickMaxs.z; ++bz) {
+		const int z0 = glm::max(mins.z - bz * BitVolume::BrickSize, 0);
+		const int z1 = glm::min(maxs.z - bz * BitVolume::BrickSize, BitVolume::BrickSize - 1);
+		for (int by = brickMins.y; by <= brickMaxs.y; ++by) {
+			const int y0 = glm::max(mins.y - by * BitVolume::BrickSize, 0);
+			const int y1 = glm::min(maxs.y - by * BitVolume::BrickSize, BitVolume::BrickSize - 1);
+			for (int bx = brickMins.x; bx <= brickMaxs.x; ++bx) {
+				const int x0 = glm::max(mins.x - bx * BitVolume::BrickSize, 0);
+				const int x1 = glm::min(maxs.x - bx * BitVolume::BrickSize, BitVolume::BrickSize - 1);
+				func(glm::ivec3(bx, by, bz), z0, z1, x0, x1, y0, y1);
+			}
+		}
+	}
+}
+
+void BitVolume::add(const Region &region) {
+	if (!region.isValid()) {
+		return;
+	}
+	visitRegionBricks(region, [this](const glm::ivec3 &brickPos, int z0, int z1, int x0, int x1, int y0, int y1) {
+		const uint64_t mask = sliceMask(x0, x1, y0, y1);
+		Brick &brick = writeBrick(brickPos);
+		for (int z = z0; z <= z1; ++z) {
+			brick.words[z] |= mask;
+		}
+	});
+}
+
+void BitVolume::subtract(const Region &region) {
+	if (!region.isValid() || _bricks.empty()) {
+		return;
+	}
+	visitRegionBricks(region, [this](const glm::ivec3 &brickPos, int z0, int z1, int x0, int x1, int y0, int y1) {
+		auto iter = _bricks.find(brickPos);
+		if (iter == _bricks.end()) {
+			return;
+		}
+		const uint64_t mask = ~sliceMask(x0, x1, y0, y1);
+		Brick &brick = iter->value;
+		for (int z = z0; z <= z1; ++z) {
+			brick.words[z] &= mask;
+		}
+		if (isEmpty(brick)) {
+			_bricks.remove(brickPos);
+		}
+	});
+}
+
+void BitVolume::intersect(const Region &region) {
+	if (!region.isValid()) {
+		clear();
+		return;
+	}
+	core::DynamicArray<glm::ivec3> emptyBricks;
+	for (auto iter = _bricks.begin(); iter != _bricks.end(); ++iter) {
+		const Region brickRegion(iter->key * BrickSize, iter->key * BrickSize + (BrickSize - 1));
+		Region r = brickRegion;
+		if (!r.cropTo(region)) {
+			emptyBricks.push_back(iter->key);
+			continue;
+		}
+		const glm::ivec3 localMins = r.getLowerCorner() - brickRegion.getLowerCorner();
+		const glm::ivec3 localMaxs = r.getUpperCorner() - brickRegion.getLowerCorner();
+		const uint64_t mask = sliceMask(localMins.x, localMaxs.x, localMins.y, localMaxs.y);
+		Brick &brick = iter->value;
+		for (int z = 0; z < BrickSize; ++z) {
+			if (z < localMins.z || z > localMaxs.z) {
+				brick.words[z] = 0u;
+			} else {
+				brick.words[z] &= mask;
+			}
+		}
+		if (isEmpty(brick)) {
+			emptyBricks.push_back(iter->key);
+		}
+	}
+	for (const glm::ivec3 &brickPos : emptyBricks) {
+		_bricks.remove(brickPos);
+	}
+}
+
+void BitVolume::invert(const Region &region) {
+	if (!region.isValid()) {
+		return;
+	}
+	visitRegionBricks(region, [this](const glm::ivec3 &brickPos, int z0, int z1, int x0, int x1, int y0, int y1) {
+		const uint64_t mask = sliceMask(x0, x1, y0, y1);
+		Brick &brick = writeBrick(brickPos);
+		for (int z = z0; z <= z1; ++z) {
+			brick.words[z] ^= mask;
+		}
+		if (isEmpty(brick)) {
+			_bricks.remove(brickPos);
+		}
+	});
+}
+
+void BitVolume::add(const BitVolume &other) {
+	for (auto iter = other._bricks.begin(); iter != other._bricks.end(); ++iter) {
+		Brick &brick = writeBrick(iter->key);
+		for (int z = 0; z < BrickSize; ++z) {
+			brick.words[z] |= iter->value.words[z];
+		}
+	}
+}
+
+void BitVolume::subtract(const BitVolume &other) {
+	for (auto iter = other._bricks.begin(); iter != other._bricks.end(); ++iter) {
+		auto own = _bricks.find(iter->key);
+		if (own == _bricks.end()) {
+			continue;
+		}
+		Brick &brick = own->value;
+		for (int z = 0; z < BrickSize; ++z) {
+			brick.words[z] &= ~iter->value.words[z];
+		}
+		if (isEmpty(brick)) {
+			_bricks.remove(iter->key);
+		}
+	}
+}
+
+void BitVolume::intersect(const BitVolume &other) {
+	core::DynamicArray<glm::ivec3> emptyBricks;
+	for (auto iter = _bricks.begin(); iter != _bricks.end(); ++iter) {
+		auto otherIter = other._bricks.find(iter->key);
+		if (otherIter == other._bricks.end()) {
+			emptyBricks.push_back(iter->key);
+			continue;
+		}
+		Brick &brick = iter->value;
+		for (int z = 0; z < BrickSize; ++z) {
+			brick.words[z] &= otherIter->value.words[z];
+		}
+		if (isEmpty(brick)) {
+			emptyBricks.push_back(iter->key);
+		}
+	}
+	for (const glm::ivec3 &brickPos : emptyBricks) {
+		_bricks.remove(brickPos);
+	}
+}
+
+void BitVolume::clear() {
+	_bricks.clear();
+}
+
+Region BitVolume::calculateRegion() const {
+	if (_bricks.empty()) {
+		return Region::InvalidRegion;
+	}
+	glm::ivec3 mins((std::numeric_limits<int>::max)());
+	glm::ivec3 maxs((std::numeric_limits<int>::min)());
+	for (auto iter = _bricks.begin(); iter != _bricks.end(); ++iter) {
+		const glm::ivec3 brickMins = iter->key * BrickSize;
+		const Brick &brick = iter->value;
+		for (int z = 0; z < BrickSize; ++z) {
+			const uint64_t word = brick.words[z];
+			if (word == 0u) {
+				continue;
+			}
+			for (int y = 0; y < BrickSize; ++y) {
+				const uint64_t row = (word >> (y << BrickShift)) & RowMask;
+				if (row == 0u) {
+					continue;
+				}
+				for (int x = 0; x < BrickSize; ++x) {
+					if (row & ((uint64_t)1 << x)) {
+						const glm::ivec3 pos = brickMins + glm::ivec3(x, y, z);
+						mins = glm::min(mins, pos);
+						maxs = glm::max(maxs, pos);
+					}
+				}
+			}
+		}
+	}
+	return Region(mins, maxs);
+}
+
+void BitVolume::regions(core::DynamicArray<Region> &out) const {
+	out.clear();
+	const Region &region = calculateRegion();
+	if (!region.isValid()) {
+		return;
+	}
+	const glm::ivec3 &mins = region.getLowerCorner();
+	const glm::ivec3 &maxs = region.getUpperCorner();
+	// boxes that reached the previous z slice and might be extended by the current one
+	core::DynamicArray<Region> open;
+	core::DynamicArray<Region> next;
+	// rectangles of the current z slice - x and y extents, z is the current slice
+	core::DynamicArray<Region> rects;
+	core::DynamicArray<Region> active;
+	for (int z = mins.z; z <= maxs.z; ++z) {
+		rects.clear();
+		active.clear();
+		for (int y = mins.y; y <= maxs.y; ++y) {
+			size_t activeCount = active.size();
+			visitSpan(mins.x, maxs.x, y, z, [&](int x0, int x1) {
+				for (size_t i = 0; i < activeCount; ++i) {
+					Region &r = active[i];
+					if (r.getLowerX() == x0 && r.getUpperX() == x1 && r.getUpperY() == y - 1) {
+						r.setUpperCorner(glm::ivec3(x1, y, z));
+						return;
+					}
+				}
+				active.emplace_back(x0, y, z, x1, y, z);
+			});
+			for (size_t i = 0; i < active.size();) {
+				if (active[i].getUpperY() < y) {
+					rects.push_back(active[i]);
+					active.erase(i);
+				} else {
+					++i;
+				}
+			}
+		}
+		rects.append(active);
+
+		next.clear();
+		for (const Region &rect : rects) {
+			bool extended = false;
+			for (size_t i = 0; i < open.size(); ++i) {
+				Region &box = open[i];
+				if (box.getLowerX() == rect.getLowerX() && box.getUpperX() == rect.getUpperX() &&
+					box.getLowerY() == rect.getLowerY() && box.getUpperY() == rect.getUpperY()) {
+					box.setUpperCorner(rect.getUpperCorner());
+					next.push_back(box);
+					open.erase(i);
+					extended = true;
+					break;
+				}
+			}
+			if (!extended) {
+				next.push_back(rect);
+			}
+		}
+		// the remaining boxes didn't continue in this slice
+		out.append(open);
+		open = core::move(next);
+	}
+	out.append(open);
+}
+
+} // namespace voxel
@@ -0,0 +1,228 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "Region.h"
+#include "core/GLM.h"
+#include "core/collection/DynamicArray.h"
+#include "core/collection/DynamicMap.h"
+#include <glm/common.hpp>
+#include <glm/vec3.hpp>
+#include <stdint.h>
+
+namespace voxel {
+
+/**
+ * @brief Sparse bitmask volume - e.g. for selections of arbitrary shape
+ *
+ * The volume is split into bricks of @c BrickSize voxels per axis. Each brick stores one bit per voxel and only bricks
+ * with at least one bit set are allocated. The membership test is a single hash map lookup and bit test - independent
+ * of the amount of regions that were added. Regions and other bit volumes are combined brick wise on whole words.
+ */
+class BitVolume {
+public:
+	static constexpr int BrickShift = 3;
+	static constexpr int BrickSize = 1 << BrickShift;
+	static constexpr uint64_t RowMask = ((uint64_t)1 << BrickSize) - 1u;
+
+private:
+	/**
+	 * @brief One word per z slice - the bit index is @code x + y * BrickSize @endcode
+	 */
+	struct Brick {
+		uint64_t words[BrickSize];
+	};
+	using BrickMap = core::DynamicMap<glm::ivec3, Brick, 1031, glm::hash<glm::ivec3>>;
+	BrickMap _bricks;
+
+	static bool isEmpty(const Brick &brick);
+	/**
+	 * @return The mask of the given x and y range (brick local and inclusive) for a single z slice word
+	 */
+	static uint64_t sliceMask(int x0, int x1, int y0, int y1);
+	Brick &writeBrick(const glm::ivec3 &brickPos);
+
+	/**
+	 * @brief Emits the runs of set voxels in the given span - the bricks of the span are resolved by @c brickAt
+	 */
+	template<class BRICKAT, class FUNC>
+	static void visitRow(int x0, int x1, int y, int z, BRICKAT &&brickAt, FUNC &&func) {
+		const int rowShift = (y & (BrickSize - 1)) << BrickShift;
+		const int slice = z & (BrickSize - 1);
+		int runStart = x1 + 1;
+		for (int bx = x0 >> BrickShift; bx <= x1 >> BrickShift; ++bx) {
+			const int brickMinX = bx * BrickSize;
+			const Brick *brick = brickAt(bx);
+			const uint64_t row = brick == nullptr ? 0u : (brick->words[slice] >> rowShift) & RowMask;
+			const int lx0 = glm::max(x0 - brickMinX, 0);
+			const int lx1 = glm::min(x1 - brickMinX, BrickSize - 1);
+			if (row == RowMask && runStart <= x1) {
+				// the whole brick row is set - the current run continues
+				continue;
+			}
+			for (int lx = lx0; lx <= lx1; ++lx) {
+				const int x = brickMinX + lx;
+				if (row & ((uint64_t)1 << lx)) {
+					if (runStart > x1) {
+						runStart = x;
+					}
+				} else if (runStart <= x1) {
+					func(runStart, x - 1);
+					runStart = x1 + 1;
+				}
+			}
+		}
+		if (runStart <= x1) {
+			func(runStart, x1);
+		}
+	}
+
+public:
+	/**
+	 * @return @c true if the voxel at the given position is set
+	 */
+	bool contains(int x, int y, int z) const;
+	bool contains(const glm::ivec3 &pos) const;
+	void set(int x, int y, int z, bool value);
+
+	/**
+	 * @brief Set all voxels of the given region
+	 */
+	void add(const Region &region);
+	/**
+	 * @brief Unset all voxels of the given region
+	 */
+	void subtract(const Region &region);
+	/**
+	 * @brief Unset all voxels outside of the given region
+	 */
+	void intersect(const Region &region);
+	/**
+	 * @brief Flip all voxels of the given region
+	 */
+	void invert(const Region &region);
+
+	void add(const BitVolume &other);
+	void subtract(const BitVolume &other);
+	void intersect(const BitVolume &other);
+
+	void clear();
+	bool empty() const;
+	/**
+	 * @return The amount of allocated bricks
+	 */
+	size_t bricks() const;
+	/**
+	 * @return The bounding box of all set voxels or @c Region::InvalidRegion if the volume is empty
+	 */
+	Region calculateRegion() const;
+	/**
+	 * @brief Splits the set voxels into disjoint boxes - runs along x are merged along y and then along z
+	 * @note The given list is cleared before the boxes are added
+	 */
+	void regions(core::DynamicArray<Region> &out) const;
+
+	/**
+	 * @brief Calls the given functor with the position (x, y, z) of every set voxel - the order is unspecified
+	 */
+	template<class FUNC>
+	void visit(FUNC &&func) const {
+		for (auto iter = _bricks.begin(); iter != _bricks.end(); ++iter) {
+			const glm::ivec3 mins = iter->key * BrickSize;
+			const Brick &brick = iter->value;
+			for (int z = 0; z < BrickSize; ++z) {
+				const uint64_t word = brick.words[z];
+				if (word == 0u) {
+					continue;
+				}
+				for (int bit = 0; bit < BrickSize * BrickSize; ++bit) {
+					if (word & ((uint64_t)1 << bit)) {
+						func(mins.x + (bit & (BrickSize - 1)), mins.y + (bit >> BrickShift), mins.z + z);
+					}
+				}
+			}
+		}
+	}
+
+	/**
+	 * @brief Calls the given functor with the inclusive x range (x0, x1) of every run of set voxels in the given span
+	 * along the x axis - only one lookup per brick is needed
+	 */
+	template<class FUNC>
+	void visitSpan(int x0, int x1, int y, int z, FUNC &&func) const {
+		const glm::ivec3 brickPos(0, y >> BrickShift, z >> BrickShift);
+		visitRow(
+			x0, x1, y, z,
+			[&](int bx) {
+				auto iter = _bricks.find(glm::ivec3(bx, brickPos.y, brickPos.z));
+				return iter == _bricks.end() ? nullptr : &iter->value;
+			},
+			func);
+	}
+
+	/**
+	 * @brief Calls the given functor with the inclusive x range (x0, x1) and the y and z coordinates of every run of
+	 * set voxels in the given region - every brick is only looked up once
+	 */
+	template<class FUNC>
+	void visitSpans(const Region &region, FUNC &&func) const {
+		if (!region.isValid() || _bricks.empty()) {
+			return;
+		}
+		const glm::ivec3 &mins = region.getLowerCorner();
+		const glm::ivec3 &maxs = region.getUpperCorner();
+		const int bx0 = mins.x >> BrickShift;
+		const int bx1 = maxs.x >> BrickShift;
+		core::DynamicArray<const Brick *> row;
+		row.resize(bx1 - bx0 + 1);
+		for (int bz = mins.z >> BrickShift; bz <= maxs.z >> BrickShift; ++bz) {
+			const int z0 = glm::max(mins.z, bz * BrickSize);
+			const int z1 = glm::min(maxs.z, bz * BrickSize + BrickSize - 1);
+			for (int by = mins.y >> BrickShift; by <= maxs.y >> BrickShift; ++by) {
+				bool found = false;
+				for (int bx = bx0; bx <= bx1; ++bx) {
+					auto iter = _bricks.find(glm::ivec3(bx, by, bz));
+					row[bx - bx0] = iter == _bricks.end() ? nullptr : &iter->value;
+					found |= row[bx - bx0] != nullptr;
+				}
+				if (!found) {
+					continue;
+				}
+				const int y0 = glm::max(mins.y, by * BrickSize);
+				const int y1 = glm::min(maxs.y, by * BrickSize + BrickSize - 1);
+				for (int z = z0; z <= z1; ++z) {
+					for (int y = y0; y <= y1; ++y) {
+						visitRow(
+							mins.x, maxs.x, y, z, [&](int bx) { return row[bx - bx0]; },
+							[&](int runX0, int runX1) { func(runX0, runX1, y, z); });
+					}
+				}
+			}
+		}
+	}
+};
+
+inline bool BitVolume::contains(int x, int y, int z) const {
+	auto iter = _bricks.find(glm::ivec3(x >> BrickShift, y >> BrickShift, z >> BrickShift));
+	if (iter == _bricks.end()) {
+		return false;
+	}
+	const int bit = (x & (BrickSize - 1)) + ((y & (BrickSize - 1)) << BrickShift);
+	return (iter->value.words[z & (BrickSize - 1)] & ((uint64_t)1 << bit)) != 0u;
+}
+
+inline bool BitVolume::contains(const glm::ivec3 &pos) const {
+	return contains(pos.x, pos.y, pos.z);
+}
+
+inline bool BitVolume::empty() const {
+	return _bricks.empty();
+}
+
+inline size_t BitVolume::bricks() const {
+	return _bricks.size();
+}
+
+} // namespace voxel
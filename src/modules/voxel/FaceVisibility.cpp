@@ -0,0 +1,71 @@
+/**
+ * @file
+ */
+
+#include "FaceVisibility.h"
+#include "RawVolume.h"
+#include "core/Trace.h"
+
+namespace voxel {
+
+FaceVisibility::FaceVisibility(const Region &extractRegion) {
+	// the extractor looks at the left, lower and front neighbours - the upper corner is extended, too, because
+	// the extractor shifts it by one if the whole volume is extracted
+	_region = Region(extractRegion.getLowerCorner() - 1, extractRegion.getUpperCorner() + 1);
+	_dimensions = _region.getDimensionsInVoxels();
+	const size_t voxels = (size_t)_dimensions.x * _dimensions.y * _dimensions.z;
+	_words = (voxels + 63u) / 64u;
+	_planes.resize(_words * Faces);
+	_planes.fill(0u);
+}
+
+void FaceVisibility::clear() {
+	_planes.fill(0u);
+}
+
+void FaceVisibility::build(const RawVolume &volume) {
+	clear();
+	update(volume, _region);
+}
+
+void FaceVisibility::update(const RawVolume &volume, const Region &modifiedRegion) {
+	core_trace_scoped(FaceVisibilityUpdate);
+	// the faces of the neighbours depend on the modified voxels, too
+	Region region(modifiedRegion.getLowerCorner() - 1, modifiedRegion.getUpperCorner() + 1);
+	if (!region.cropTo(_region)) {
+		return;
+	}
+	const glm::ivec3 &mins = region.getLowerCorner();
+	const glm::ivec3 &maxs = region.getUpperCorner();
+	RawVolume::Sampler sampler(volume);
+	for (int z = mins.z; z <= maxs.z; ++z) {
+		for (int y = mins.y; y <= maxs.y; ++y) {
+			sampler.setPosition(mins.x, y, z);
+			int voxelIndex = index(mins.x, y, z);
+			for (int x = mins.x; x <= maxs.x; ++x, ++voxelIndex) {
+				const VoxelType current = sampler.voxel().getMaterial();
+				if (isAir(current)) {
+					for (int face = 0; face < Faces; ++face) {
+						set((FaceNames)face, voxelIndex, false);
+					}
+				} else {
+					set(FaceNames::PositiveX, voxelIndex,
+						isFaceVisible(current, sampler.peekVoxel1px0py0pz().getMaterial()));
+					set(FaceNames::PositiveY, voxelIndex,
+						isFaceVisible(current, sampler.peekVoxel0px1py0pz().getMaterial()));
+					set(FaceNames::PositiveZ, voxelIndex,
+						isFaceVisible(current, sampler.peekVoxel0px0py1pz().getMaterial()));
+					set(FaceNames::NegativeX, voxelIndex,
+						isFaceVisible(current, sampler.peekVoxel1nx0py0pz().getMaterial()));
+					set(FaceNames::NegativeY, voxelIndex,
+						isFaceVisible(current, sampler.peekVoxel0px1ny0pz().getMaterial()));
+					set(FaceNames::NegativeZ, voxelIndex,
+						isFaceVisible(current, sampler.peekVoxel0px0py1nz().getMaterial()));
+				}
+				sampler.movePositiveX();
+			}
+		}
+	}
+}
+
+} // namespace voxel
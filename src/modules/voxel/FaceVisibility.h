@@ -0,0 +1,146 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "Face.h"
+#include "Region.h"
+#include "Voxel.h"
+#include "core/collection/Buffer.h"
+#include <glm/vec3.hpp>
+
+namespace voxel {
+
+class RawVolume;
+
+/**
+ * @return @c true if the cubic extractor generates a quad (opaque or transparent) for the face of the @c back voxel
+ * that touches the @c front voxel
+ */
+inline bool isFaceVisible(VoxelType back, VoxelType front) {
+	if (isAir(back)) {
+		return false;
+	}
+	return isAir(front) || isTransparent(front) != isTransparent(back);
+}
+
+/**
+ * @brief Caches the visible faces of every voxel of a chunk as one bit plane per @c FaceNames
+ *
+ * The cubic extractor takes the quads of a cell straight from the bits instead of comparing the voxel with its
+ * neighbours - the neighbours are only sampled for the ambient occlusion of the emitted quads. The masks only have to
+ * be recalculated for the modified voxels and their direct neighbours.
+ *
+ * @note The masks don't observe the volume. It's the callers responsibility to call @c update() for every modified
+ * region.
+ * @sa SurfaceExtractionContext::faceVisibility
+ */
+class FaceVisibility {
+private:
+	static constexpr int Faces = (int)FaceNames::Max;
+	Region _region = Region::InvalidRegion;
+	glm::ivec3 _dimensions{0};
+	/** the amount of 64 bit words of one plane */
+	size_t _words = 0u;
+	/** the bit planes of all faces - one after another */
+	core::Buffer<uint64_t> _planes;
+
+	inline int index(int x, int y, int z) const {
+		return (x - _region.getLowerX()) + (y - _region.getLowerY()) * _dimensions.x +
+			   (z - _region.getLowerZ()) * _dimensions.x * _dimensions.y;
+	}
+
+	inline bool isSet(FaceNames face, int voxelIndex) const {
+		const uint64_t word = _planes[(size_t)face * _words + (voxelIndex >> 6)];
+		return (word >> (voxelIndex & 63)) & 1u;
+	}
+
+	inline void set(FaceNames face, int voxelIndex, bool visible) {
+		uint64_t &word = _planes[(size_t)face * _words + (voxelIndex >> 6)];
+		const uint64_t bit = (uint64_t)1u << (voxelIndex & 63);
+		word = visible ? (word | bit) : (word & ~bit);
+	}
+
+public:
+	FaceVisibility() {
+	}
+	/**
+	 * @param extractRegion The region the cubic extractor is going to extract - the masks also cover the neighbours
+	 * that the extractor is looking at
+	 */
+	explicit FaceVisibility(const Region &extractRegion);
+
+	/**
+	 * @brief Calculates the masks of all voxels
+	 */
+	void build(const RawVolume &volume);
+	/**
+	 * @brief Recalculates the masks of the voxels in the given modified region and their neighbours
+	 */
+	void update(const RawVolume &volume, const Region &modifiedRegion);
+	/**
+	 * @brief Resets all masks - e.g. for a chunk without any solid voxel
+	 */
+	void clear();
+
+	const Region &region() const;
+	/**
+	 * @return @c false if the masks were not yet allocated
+	 */
+	bool isValid() const;
+
+	/**
+	 * @return The bitmask of visible faces of the given voxel - the bit index is the @c FaceNames value
+	 */
+	uint8_t faces(int x, int y, int z) const;
+	/**
+	 * @return @c true if the masks cover the given cell and its left, lower and front neighbours
+	 */
+	bool containsCell(int x, int y, int z) const;
+	/**
+	 * @brief The cubic extractor generates the negative faces of the voxel at the given position and the positive
+	 * faces of the left, lower and front neighbours
+	 * @return The bitmask of quads of the cell - the bit index is the @c FaceNames value. The negative faces belong to
+	 * the voxel at the given position, the positive faces to its left, lower and front neighbours.
+	 * @note The cell must be covered by the masks - see @c containsCell()
+	 */
+	uint8_t cellFaces(int x, int y, int z) const;
+};
+
+inline const Region &FaceVisibility::region() const {
+	return _region;
+}
+
+inline bool FaceVisibility::isValid() const {
+	return _words > 0u;
+}
+
+inline bool FaceVisibility::containsCell(int x, int y, int z) const {
+	return _region.containsPoint(x, y, z) && _region.containsPoint(x - 1, y - 1, z - 1);
+}
+
+inline uint8_t FaceVisibility::faces(int x, int y, int z) const {
+	const int voxelIndex = index(x, y, z);
+	uint8_t mask = 0u;
+	for (int face = 0; face < Faces; ++face) {
+		mask |= (uint8_t)(isSet((FaceNames)face, voxelIndex) << face);
+	}
+	return mask;
+}
+
+inline uint8_t FaceVisibility::cellFaces(int x, int y, int z) const {
+	const int voxelIndex = index(x, y, z);
+	const int rowStride = _dimensions.x;
+	const int sliceStride = _dimensions.x * _dimensions.y;
+	uint8_t mask = 0u;
+	mask |= (uint8_t)(isSet(FaceNames::NegativeX, voxelIndex) << (int)FaceNames::NegativeX);
+	mask |= (uint8_t)(isSet(FaceNames::NegativeY, voxelIndex) << (int)FaceNames::NegativeY);
+	mask |= (uint8_t)(isSet(FaceNames::NegativeZ, voxelIndex) << (int)FaceNames::NegativeZ);
+	mask |= (uint8_t)(isSet(FaceNames::PositiveX, voxelIndex - 1) << (int)FaceNames::PositiveX);
+	mask |= (uint8_t)(isSet(FaceNames::PositiveY, voxelIndex - rowStride) << (int)FaceNames::PositiveY);
+	mask |= (uint8_t)(isSet(FaceNames::PositiveZ, voxelIndex - sliceStride) << (int)FaceNames::PositiveZ);
+	return mask;
+}
+
+} // namespace voxel
@@ -3,10 +3,12 @@
  */
 
 #include "MeshState.h"
+#include "app/I18N.h"
 #include "core/Log.h"
 #include "voxel/MaterialColor.h"
 #include "voxel/Mesh.h"
 #include "voxel/SurfaceExtractor.h"
+#include "voxel/VolumeDownsampler.h"
 #include <SDL.h>
 
 namespace voxel {
@@ -14,6 +16,8 @@ namespace voxel {
 bool MeshState::init() {
 	_meshMode = core::Var::getSafe(cfg::VoxelMeshMode);
 	_meshMode->markClean();
+	_meshLod = core::Var::getSafe(cfg::VoxelMeshLod);
+	_meshLod->markClean();
 
 	_threadPool.init();
 	Log::debug("Threadpool size: %i", (int)_threadPool.size());
@@ -22,6 +26,21 @@ bool MeshState::init() {
 
 void MeshState::construct() {
 	_meshSize = core::Var::get(cfg::VoxelMeshSize, "64", core::CV_READONLY);
+	core::Var::get(cfg::VoxelMeshLod, "false", _("Extract lower resolution meshes of the chunks for far away geometry"),
+				   core::Var::boolValidator);
+}
+
+bool MeshState::lodEnabled() const {
+	// the chunk boundaries must be multiples of the downsampling factor of the lowest detail level
+	return _meshLod->boolVal() && _meshSize->intVal() % (1 << (MaxLods - 1)) == 0;
+}
+
+MeshState::~MeshState() {
+	clear();
+	for (VolumeData *data : _volumeData) {
+		delete data;
+	}
+	_volumeData.clear();
 }
 
 glm::vec3 MeshState::VolumeData::centerPos() const {
@@ -30,123 +49,301 @@ glm::vec3 MeshState::VolumeData::centerPos() const {
 	return pos;
 }
 
+const MeshState::VolumeData &MeshState::emptyVolumeData() {
+	static const VolumeData data;
+	return data;
+}
+
+MeshState::VolumeData *MeshState::allocVolumeData(int idx) {
+	if (idx < 0) {
+		return nullptr;
+	}
+	if (idx >= (int)_volumeData.size()) {
+		_volumeData.resize(idx + 1);
+	}
+	VolumeData *&data = _volumeData[idx];
+	if (data == nullptr) {
+		data = new VolumeData();
+	}
+	return data;
+}
+
+void MeshState::freeVolumeData(int idx) {
+	VolumeData *data = volumeData(idx);
+	if (data == nullptr) {
+		return;
+	}
+	deleteMeshes(idx);
+	delete data;
+	_volumeData[idx] = nullptr;
+	// shrink the table to the highest slot that is still in use
+	while (!_volumeData.empty() && _volumeData.back() == nullptr) {
+		_volumeData.pop();
+	}
+}
+
 const glm::vec3 &MeshState::mins(int idx) const {
-	return _volumeData[idx]._mins;
+	const VolumeData *data = volumeData(idx);
+	return data == nullptr ? emptyVolumeData()._mins : data->_mins;
 }
 
 const glm::vec3 &MeshState::maxs(int idx) const {
-	return _volumeData[idx]._maxs;
+	const VolumeData *data = volumeData(idx);
+	return data == nullptr ? emptyVolumeData()._maxs : data->_maxs;
 }
 
 glm::vec3 MeshState::centerPos(int idx) const {
-	return _volumeData[idx].centerPos();
+	const VolumeData *data = volumeData(idx);
+	return data == nullptr ? emptyVolumeData().centerPos() : data->centerPos();
 }
 
 const glm::mat4 &MeshState::model(int idx) const {
-	return _volumeData[idx]._model;
+	const VolumeData *data = volumeData(idx);
+	return data == nullptr ? emptyVolumeData()._model : data->_model;
 }
 
 const glm::vec3 &MeshState::pivot(int idx) const {
-	return _volumeData[idx]._pivot;
+	const VolumeData *data = volumeData(idx);
+	return data == nullptr ? emptyVolumeData()._pivot : data->_pivot;
 }
 
 void MeshState::setModel(int idx, const glm::mat4 &model) {
-	_volumeData[idx]._model = model;
+	if (VolumeData *data = volumeData(idx)) {
+		data->_model = model;
+	}
 }
 
 bool MeshState::setModelMatrix(int idx, const glm::mat4 &model, const glm::vec3 &pivot, const glm::vec3 &mins,
 									   const glm::vec3 &maxs) {
-	if (idx < 0 || idx >= MAX_VOLUMES) {
-		Log::error("Given id %i is out of bounds", idx);
-		return false;
-	}
-	if (reference(idx) == -1 && volume(idx) == nullptr) {
+	VolumeData *state = volumeData(idx);
+	if (state == nullptr || (state->_reference == -1 && state->_rawVolume == nullptr)) {
 		Log::error("No volume found at: %i", idx);
 		return false;
 	}
-	VolumeData &state = _volumeData[idx];
-	state._model = model;
-	state._pivot = pivot;
-	state._mins = mins;
-	state._maxs = maxs;
+	state->_model = model;
+	state->_pivot = pivot;
+	state->_mins = mins;
+	state->_maxs = maxs;
 	return true;
 }
 
 void MeshState::clear() {
-	for (int i = 0; i < MeshType_Max; ++i) {
-		for (const auto &iter : _meshes[i]) {
-			for (voxel::Mesh *mesh : iter->value) {
-				delete mesh;
-			}
-		}
-		_meshes[i].clear();
+	for (int idx = 0; idx < (int)_volumeData.size(); ++idx) {
+		deleteMeshes(idx);
+	}
+}
+
+MeshState::ChunkFaces *MeshState::chunkFaces(const glm::ivec3 &pos, int idx) {
+	VolumeData *data = volumeData(idx);
+	core_assert(data != nullptr);
+	auto iter = data->_chunkFaces.find(pos);
+	if (iter != data->_chunkFaces.end()) {
+		return iter->value;
 	}
+	// the masks are allocated by the first extraction task of the chunk
+	ChunkFaces *chunk = new ChunkFaces();
+	data->_chunkFaces.put(pos, chunk);
+	return chunk;
 }
 
-void MeshState::addOrReplaceMeshes(MeshState::ExtractionCtx &result, MeshType type) {
-	auto iter = _meshes[type].find(result.mins);
-	if (iter != _meshes[type].end()) {
-		delete iter->value[result.idx];
-		iter->value[result.idx] = new voxel::Mesh(core::move(result.mesh.mesh[type]));
+void MeshState::deleteChunkFaces(const glm::ivec3 &pos, int idx) {
+	VolumeData *data = volumeData(idx);
+	if (data == nullptr) {
 		return;
 	}
-	_meshes[type].emplace(result.mins, Meshes());
-	auto newIter = _meshes[type].find(result.mins);
-	newIter->value[result.idx] = new voxel::Mesh(core::move(result.mesh.mesh[type]));
+	auto iter = data->_chunkFaces.find(pos);
+	if (iter == data->_chunkFaces.end()) {
+		return;
+	}
+	delete iter->value;
+	data->_chunkFaces.erase(iter);
+}
+
+void MeshState::deleteChunkFaces(int idx) {
+	VolumeData *data = volumeData(idx);
+	if (data == nullptr) {
+		return;
+	}
+	for (const auto &iter : data->_chunkFaces) {
+		delete iter->value;
+	}
+	data->_chunkFaces.clear();
+}
+
+void MeshState::clearChunkFaces() {
+	for (int idx = 0; idx < (int)_volumeData.size(); ++idx) {
+		deleteChunkFaces(idx);
+	}
+}
+
+template<class MeshesMapType>
+static bool deleteMesh(MeshesMapType &meshes, const glm::ivec3 &mins) {
+	auto iter = meshes.find(mins);
+	if (iter == meshes.end()) {
+		return false;
+	}
+	delete iter->value;
+	meshes.erase(iter);
+	return true;
+}
+
+template<class MeshesMapType>
+static bool deleteAllMeshes(MeshesMapType &meshes) {
+	const bool deleted = !meshes.empty();
+	for (const auto &iter : meshes) {
+		delete iter->value;
+	}
+	meshes.clear();
+	return deleted;
+}
+
+template<class MeshesMapType, class MeshClass>
+static void addOrReplaceMesh(MeshesMapType &meshes, const glm::ivec3 &mins, MeshClass &&mesh) {
+	MeshClass *newMesh = new MeshClass(core::move(mesh));
+	auto iter = meshes.find(mins);
+	if (iter != meshes.end()) {
+		delete iter->value;
+		iter->value = newMesh;
+		return;
+	}
+	meshes.put(mins, newMesh);
+}
+
+bool MeshState::ExtractionCtx::pack() {
+	if (!packedMesh.pack(mesh)) {
+		return false;
+	}
+	packedLods.resize(lods.size());
+	for (size_t i = 0; i < lods.size(); ++i) {
+		if (!packedLods[i].pack(lods[i])) {
+			packedMesh = voxel::PackedChunkMesh();
+			packedLods.clear();
+			return false;
+		}
+	}
+	mesh = voxel::ChunkMesh(0, 0);
+	lods.clear();
+	packed = true;
+	return true;
+}
+
+void MeshState::addOrReplaceLodMeshes(MeshState::ExtractionCtx &result) {
+	VolumeData *data = _volumeData[result.idx];
+	const int levels = (int)(result.packed ? result.packedLods.size() : result.lods.size());
+	for (int i = 0; i < MaxLods - 1; ++i) {
+		MeshesMap &meshes = data->_lodMeshes[i];
+		PackedMeshesMap &packedMeshes = data->_packedLodMeshes[i];
+		if (i >= levels) {
+			// no detail levels were extracted for this chunk - don't keep outdated ones
+			deleteMesh(meshes, result.mins);
+			deleteMesh(packedMeshes, result.mins);
+		} else if (result.packed) {
+			deleteMesh(meshes, result.mins);
+			addOrReplaceMesh(packedMeshes, result.mins, core::move(result.packedLods[i]));
+		} else {
+			deleteMesh(packedMeshes, result.mins);
+			addOrReplaceMesh(meshes, result.mins, core::move(result.lods[i]));
+		}
+	}
 }
 
 int MeshState::pop() {
 	MeshState::ExtractionCtx result;
 	while (_pendingQueue.pop(result)) {
-		if (_volumeData[result.idx]._rawVolume == nullptr) {
+		// the volume might have been removed while the extraction was running
+		if (volume(result.idx) == nullptr) {
 			continue;
 		}
-		addOrReplaceMeshes(result, MeshType_Opaque);
-		addOrReplaceMeshes(result, MeshType_Transparency);
+		VolumeData *data = _volumeData[result.idx];
+		for (int i = 0; i < MeshType_Max; ++i) {
+			if (result.packed) {
+				deleteMesh(data->_meshes[i], result.mins);
+				addOrReplaceMesh(data->_packedMeshes[i], result.mins, core::move(result.packedMesh.mesh[i]));
+			} else {
+				deleteMesh(data->_packedMeshes[i], result.mins);
+				addOrReplaceMesh(data->_meshes[i], result.mins, core::move(result.mesh.mesh[i]));
+			}
+		}
+		addOrReplaceLodMeshes(result);
+		if (result.hasFaces) {
+			ChunkFacesMap &chunkFacesMap = data->_chunkFaces;
+			auto iter = chunkFacesMap.find(result.mins);
+			if (iter != chunkFacesMap.end()) {
+				ChunkFaces *chunk = iter->value;
+				if (chunk->generation == result.generation) {
+					chunk->faces = core::move(result.faces);
+					chunk->valid = true;
+				}
+			}
+		}
 		return result.idx;
 	}
 	return -1;
 }
 
 bool MeshState::deleteMeshes(const glm::ivec3 &pos, int idx) {
+	VolumeData *data = volumeData(idx);
+	if (data == nullptr) {
+		return false;
+	}
 	bool d = false;
 	for (int i = 0; i < MeshType_Max; ++i) {
-		auto &meshes = _meshes[i];
-		auto iter = meshes.find(pos);
-		if (iter != meshes.end()) {
-			MeshState::Meshes &array = iter->value;
-			voxel::Mesh *mesh = array[idx];
-			delete mesh;
-			array[idx] = nullptr;
-			d = true;
-		}
+		d |= deleteMesh(data->_meshes[i], pos);
+		d |= deleteMesh(data->_packedMeshes[i], pos);
+	}
+	for (int i = 0; i < MaxLods - 1; ++i) {
+		deleteMesh(data->_lodMeshes[i], pos);
+		deleteMesh(data->_packedLodMeshes[i], pos);
 	}
+	deleteChunkFaces(pos, idx);
 	return d;
 }
 
 bool MeshState::deleteMeshes(int idx) {
+	VolumeData *data = volumeData(idx);
+	if (data == nullptr) {
+		return false;
+	}
 	bool d = false;
 	for (int i = 0; i < MeshType_Max; ++i) {
-		auto &meshes = _meshes[i];
-		for (const auto &iter : meshes) {
-			MeshState::Meshes &array = iter->value;
-			voxel::Mesh *mesh = array[idx];
-			delete mesh;
-			array[idx] = nullptr;
-			d = true;
-		}
+		d |= deleteAllMeshes(data->_meshes[i]);
+		d |= deleteAllMeshes(data->_packedMeshes[i]);
 	}
+	for (int i = 0; i < MaxLods - 1; ++i) {
+		deleteAllMeshes(data->_lodMeshes[i]);
+		deleteAllMeshes(data->_packedLodMeshes[i]);
+	}
+	deleteChunkFaces(idx);
 	return d;
 }
 
-const MeshState::MeshesMap &MeshState::meshes(MeshType type) const {
-	return _meshes[type];
+const MeshState::MeshesMap &MeshState::meshes(MeshType type, int idx, int lod) const {
+	core_assert(lod >= 0 && lod < MaxLods);
+	const VolumeData *data = volumeData(idx);
+	if (data == nullptr || (lod > 0 && type != MeshType_Opaque)) {
+		return emptyVolumeData()._meshes[type];
+	}
+	if (lod > 0) {
+		return data->_lodMeshes[lod - 1];
+	}
+	return data->_meshes[type];
+}
+
+const MeshState::PackedMeshesMap &MeshState::packedMeshes(MeshType type, int idx, int lod) const {
+	core_assert(lod >= 0 && lod < MaxLods);
+	const VolumeData *data = volumeData(idx);
+	if (data == nullptr || (lod > 0 && type != MeshType_Opaque)) {
+		return emptyVolumeData()._packedMeshes[type];
+	}
+	if (lod > 0) {
+		return data->_packedLodMeshes[lod - 1];
+	}
+	return data->_packedMeshes[type];
 }
 
 void MeshState::count(MeshType meshType, int idx, size_t &vertCount, size_t &normalsCount, size_t &indCount) const {
-	for (const auto &i : _meshes[meshType]) {
-		const MeshState::Meshes &meshes = i->value;
-		const voxel::Mesh *mesh = meshes[idx];
+	for (const auto &i : meshes(meshType, idx)) {
+		const voxel::Mesh *mesh = i->value;
 		if (mesh == nullptr || mesh->getNoOfIndices() <= 0) {
 			continue;
 		}
@@ -157,13 +354,19 @@ void MeshState::count(MeshType meshType, int idx, size_t &vertCount, size_t &nor
 		normalsCount += normalVector.size();
 		indCount += indexVector.size();
 	}
+	for (const auto &i : packedMeshes(meshType, idx)) {
+		const voxel::PackedMesh *mesh = i->value;
+		vertCount += mesh->getNoOfVertices();
+		indCount += mesh->getNoOfIndices();
+	}
 }
 
 const palette::Palette &MeshState::palette(int idx) const {
-	if (idx < 0 || idx > MAX_VOLUMES || !_volumeData[idx]._palette.hasValue()) {
+	const VolumeData *data = volumeData(idx);
+	if (data == nullptr || !data->_palette.hasValue()) {
 		return voxel::getPalette();
 	}
-	return *_volumeData[idx]._palette.value();
+	return *data->_palette.value();
 }
 
 voxel::Region MeshState::calculateExtractRegion(int x, int y, int z, const glm::ivec3 &meshSize) const {
@@ -172,6 +375,31 @@ voxel::Region MeshState::calculateExtractRegion(int x, int y, int z, const glm::
 	return voxel::Region{mins, maxs};
 }
 
+/**
+ * @brief Extracts the opaque mesh of a chunk from a downsampled copy of the chunk
+ * @param[in] volume The copy of the chunk - including a border of at least one downsampled voxel
+ * @return The mesh in the coordinates of the full resolution volume
+ */
+static voxel::Mesh extractLod(voxel::SurfaceExtractionType type, const voxel::RawVolume &volume,
+							  const voxel::Region &region, const palette::Palette &palette, int lod) {
+	const int factor = 1 << lod;
+	// the chunk boundaries are multiples of the factor - see MeshState::lodEnabled()
+	const glm::ivec3 mins = region.getLowerCorner() / factor;
+	const glm::ivec3 maxs = (region.getUpperCorner() + 1) / factor - 1;
+	const voxel::Region lodRegion(mins, maxs);
+	voxel::RawVolume lodVolume(voxel::Region(mins - 1, maxs + 1));
+	voxel::downsample(volume, factor, lodVolume);
+
+	voxel::ChunkMesh mesh(4096, 4096, true);
+	voxel::SurfaceExtractionContext ctx = voxel::createContext(type, &lodVolume, lodRegion, palette, mesh, mins);
+	voxel::extractSurface(ctx);
+	voxel::Mesh &lodMesh = mesh.mesh[MeshType_Opaque];
+	for (voxel::VoxelVertex &vertex : lodMesh.getVertexVector()) {
+		vertex.position *= (float)factor;
+	}
+	return core::move(lodMesh);
+}
+
 bool MeshState::runScheduledExtractions(size_t maxExtraction) {
 	const size_t n = _extractRegions.size();
 	if (n == 0) {
@@ -181,6 +409,9 @@ bool MeshState::runScheduledExtractions(size_t maxExtraction) {
 		return true;
 	}
 	voxel::SurfaceExtractionType type = (voxel::SurfaceExtractionType)_meshMode->intVal();
+	const bool lods = lodEnabled();
+	// the lower detail levels need the neighbours of a whole downsampled voxel
+	const int border = lods ? core_max(2, 1 << (MaxLods - 1)) : 2;
 	size_t i;
 	for (i = 0; i < n; ++i) {
 		ExtractRegion extractRegion;
@@ -194,28 +425,82 @@ bool MeshState::runScheduledExtractions(size_t maxExtraction) {
 		}
 		const voxel::Region &finalRegion = extractRegion.region;
 		bool onlyAir = true;
-		const voxel::Region copyRegion(finalRegion.getLowerCorner() - 2, finalRegion.getUpperCorner() + 2);
+		const voxel::Region copyRegion(finalRegion.getLowerCorner() - border, finalRegion.getUpperCorner() + border);
 		if (!copyRegion.isValid()) {
 			continue;
 		}
 		voxel::RawVolume copy(v, copyRegion, &onlyAir);
 		const glm::ivec3 &mins = finalRegion.getLowerCorner();
+		ChunkFaces *chunk = nullptr;
+		if (type == voxel::SurfaceExtractionType::Cubic) {
+			chunk = chunkFaces(mins, idx);
+			++chunk->generation;
+		}
 		if (!onlyAir) {
 			const palette::Palette &pal = palette(resolveIdx(idx));
+			// the cached face masks are handed over to the extraction task - it updates them for the modified voxels
+			// on its own volume copy or rebuilds them. They are taken back by pop() if no other extraction of the chunk
+			// was scheduled in the meantime.
+			voxel::FaceVisibility faces;
+			bool buildFaces = false;
+			uint32_t generation = 0u;
+			const voxel::Region modified = extractRegion.modified;
+			if (chunk != nullptr) {
+				buildFaces = !chunk->valid || !modified.isValid() || modified.containsRegion(finalRegion);
+				if (!buildFaces) {
+					faces = core::move(chunk->faces);
+				}
+				chunk->faces = voxel::FaceVisibility();
+				chunk->valid = false;
+				generation = chunk->generation;
+			}
+			const bool useFaces = chunk != nullptr;
 			++_pendingExtractorTasks;
 			_threadPool.enqueue([type, movedPal = core::move(pal), movedCopy = core::move(copy), mins, idx,
-								 finalRegion, this]() {
+								 finalRegion, movedFaces = core::move(faces), useFaces, buildFaces, modified,
+								 generation, lods, this]() mutable {
 				++_runningExtractorTasks;
 				voxel::ChunkMesh mesh(65536, 65536, true);
 				voxel::SurfaceExtractionContext ctx = voxel::createContext(type, &movedCopy, finalRegion, movedPal, mesh, mins);
+				if (buildFaces) {
+					movedFaces = voxel::FaceVisibility(finalRegion);
+					movedFaces.build(movedCopy);
+				} else if (useFaces) {
+					movedFaces.update(movedCopy, modified);
+				}
+				if (useFaces) {
+					ctx.faceVisibility = &movedFaces;
+				}
 				voxel::extractSurface(ctx);
-				_pendingQueue.emplace(mins, idx, core::move(mesh));
+				ExtractionCtx result =
+					useFaces ? ExtractionCtx(mins, idx, core::move(mesh), generation, core::move(movedFaces))
+							 : ExtractionCtx(mins, idx, core::move(mesh));
+				if (lods) {
+					result.lods.reserve(MaxLods - 1);
+					for (int lod = 1; lod < MaxLods; ++lod) {
+						result.lods.emplace_back(extractLod(type, movedCopy, finalRegion, movedPal, lod));
+					}
+				}
+				if (type == voxel::SurfaceExtractionType::Cubic) {
+					// the cubic meshes are kept packed - they only need half of the memory
+					result.pack();
+				}
+				_pendingQueue.push(core::move(result));
 				Log::debug("Enqueue mesh for idx: %i (%i:%i:%i)", idx, mins.x, mins.y, mins.z);
 				--_runningExtractorTasks;
 				--_pendingExtractorTasks;
 			});
 		} else {
-			_pendingQueue.emplace(mins, idx, core::move(voxel::ChunkMesh(0, 0)));
+			if (chunk != nullptr) {
+				// the masks of an empty chunk are released - the next extraction rebuilds them
+				chunk->faces = voxel::FaceVisibility();
+				chunk->valid = false;
+			}
+			ExtractionCtx result(mins, idx, core::move(voxel::ChunkMesh(0, 0)));
+			if (type == voxel::SurfaceExtractionType::Cubic) {
+				result.pack();
+			}
+			_pendingQueue.push(core::move(result));
 		}
 		--maxExtraction;
 		if (maxExtraction == 0) {
@@ -228,11 +513,14 @@ bool MeshState::runScheduledExtractions(size_t maxExtraction) {
 
 bool MeshState::update() {
 	bool triggerClear = false;
-	if (_meshMode->isDirty()) {
+	if (_meshMode->isDirty() || _meshLod->isDirty()) {
 		_meshMode->markClean();
+		_meshLod->markClean();
 		clearPendingExtractions();
+		// the face masks are not maintained for the other extractors
+		clearChunkFaces();
 
-		for (int i = 0; i < MAX_VOLUMES; ++i) {
+		for (int i = 0; i < volumeSlots(); ++i) {
 			if (voxel::RawVolume *v = volume(i)) {
 				scheduleRegionExtraction(i, v->region());
 			}
@@ -278,7 +566,7 @@ bool MeshState::scheduleRegionExtraction(int idx, const voxel::Region &region) {
 				}
 
 				Log::debug("extract region: %s", finalRegion.toString().c_str());
-				_extractRegions.emplace(finalRegion, bufferIndex, hidden(bufferIndex));
+				_extractRegions.emplace(finalRegion, bufferIndex, hidden(bufferIndex), region);
 			}
 		}
 	}
@@ -311,6 +599,10 @@ voxel::SurfaceExtractionType MeshState::meshMode() const {
 	return (voxel::SurfaceExtractionType)_meshMode->intVal();
 }
 
+int MeshState::meshSize() const {
+	return _meshSize->intVal();
+}
+
 int MeshState::resolveIdx(int idx) const {
 	const int ref = reference(idx);
 	if (ref != -1) {
@@ -322,26 +614,34 @@ int MeshState::resolveIdx(int idx) const {
 voxel::RawVolume *MeshState::setVolume(int idx, voxel::RawVolume *v, palette::Palette *palette, bool meshDelete,
 									   bool &meshDeleted) {
 	meshDeleted = false;
-	if (idx < 0 || idx >= MAX_VOLUMES) {
+	// removing a volume releases the slot - there is no need to allocate one for it
+	VolumeData *data = v == nullptr ? volumeData(idx) : allocVolumeData(idx);
+	if (data == nullptr) {
 		return nullptr;
 	}
-	_volumeData[idx]._palette.setValue(palette);
-	voxel::RawVolume *old = volume(idx);
-	if (old == v) {
+	data->_palette.setValue(palette);
+	voxel::RawVolume *old = data->_rawVolume;
+	if (old == v && v != nullptr) {
 		return nullptr;
 	}
 	core_trace_scoped(RawVolumeRendererSetVolume);
-	_volumeData[idx]._rawVolume = v;
-	if (meshDelete) {
-		deleteMeshes(idx);
-		meshDeleted = true;
-	}
 	const size_t n = _extractRegions.size();
 	for (size_t i = 0; i < n; ++i) {
 		if (_extractRegions[i].idx == idx) {
 			_extractRegions[i].idx = -1;
 		}
 	}
+	if (v == nullptr) {
+		freeVolumeData(idx);
+		meshDeleted = true;
+		return old;
+	}
+	data->_rawVolume = v;
+	deleteChunkFaces(idx);
+	if (meshDelete) {
+		deleteMeshes(idx);
+		meshDeleted = true;
+	}
 
 	return old;
 }
@@ -349,77 +649,84 @@ voxel::RawVolume *MeshState::setVolume(int idx, voxel::RawVolume *v, palette::Pa
 core::DynamicArray<voxel::RawVolume *> MeshState::shutdown() {
 	_threadPool.shutdown();
 	clear();
-	core::DynamicArray<voxel::RawVolume *> old(MAX_VOLUMES);
-	for (int idx = 0; idx < MAX_VOLUMES; ++idx) {
-		VolumeData &state = _volumeData[idx];
+	core::DynamicArray<voxel::RawVolume *> old;
+	old.reserve(_volumeData.size());
+	for (VolumeData *data : _volumeData) {
+		if (data == nullptr) {
+			continue;
+		}
 		// hand over the ownership to the caller
-		old.push_back(state._rawVolume);
-		state._rawVolume = nullptr;
+		old.push_back(data->_rawVolume);
+		delete data;
 	}
+	_volumeData.clear();
 	return old;
 }
 
 void MeshState::resetReferences() {
-	for (auto &s : _volumeData) {
-		s._reference = -1;
+	for (VolumeData *data : _volumeData) {
+		if (data != nullptr) {
+			data->_reference = -1;
+		}
 	}
 }
 
 int MeshState::reference(int idx) const {
-	if (idx < 0 || idx >= MAX_VOLUMES) {
+	const VolumeData *data = volumeData(idx);
+	if (data == nullptr) {
 		return -1;
 	}
-	return _volumeData[idx]._reference;
+	return data->_reference;
 }
 
 void MeshState::setReference(int idx, int referencedIdx) {
-	if (idx < 0 || idx >= MAX_VOLUMES) {
+	VolumeData *data = allocVolumeData(idx);
+	if (data == nullptr) {
 		return;
 	}
-	VolumeData &state = _volumeData[idx];
-	state._reference = referencedIdx;
+	data->_reference = referencedIdx;
 }
 
 bool MeshState::hidden(int idx) const {
-	if (idx < 0 || idx >= MAX_VOLUMES) {
+	const VolumeData *data = volumeData(idx);
+	if (data == nullptr) {
 		return true;
 	}
-	return _volumeData[idx]._hidden;
+	return data->_hidden;
 }
 
 void MeshState::hide(int idx, bool hide) {
-	if (idx < 0 || idx >= MAX_VOLUMES) {
-		return;
+	if (VolumeData *data = volumeData(idx)) {
+		data->_hidden = hide;
 	}
-	_volumeData[idx]._hidden = hide;
 }
 
 video::Face MeshState::cullFace(int idx) const {
-	if (idx < 0 || idx >= MAX_VOLUMES) {
+	const VolumeData *data = volumeData(idx);
+	if (data == nullptr) {
 		return video::Face::Back;
 	}
-	return _volumeData[idx]._cullFace;
+	return data->_cullFace;
 }
 
 void MeshState::setCullFace(int idx, video::Face face) {
-	if (idx < 0 || idx >= MAX_VOLUMES) {
-		return;
+	if (VolumeData *data = volumeData(idx)) {
+		data->_cullFace = face;
 	}
-	_volumeData[idx]._cullFace = face;
 }
 
 bool MeshState::grayed(int idx) const {
-	if (idx < 0 || idx >= MAX_VOLUMES) {
+	const VolumeData *data = volumeData(idx);
+	if (data == nullptr) {
 		return true;
 	}
-	return _volumeData[idx]._gray;
+	return data->_gray;
 }
 
 void MeshState::gray(int idx, bool gray) {
-	if (idx < 0 || idx >= MAX_VOLUMES) {
-		return;
+	if (VolumeData *data = volumeData(idx)) {
+		data->_gray = gray;
 	}
-	_volumeData[idx]._gray = gray;
 }
 
 } // namespace voxel
@@ -7,15 +7,17 @@
 #include "core/Optional.h"
 #include "core/SharedPtr.h"
 #include "core/Var.h"
-#include "core/collection/Array.h"
 #include "core/collection/ConcurrentPriorityQueue.h"
+#include "core/collection/DynamicArray.h"
 #include "core/collection/DynamicMap.h"
 #include "core/collection/PriorityQueue.h"
 #include "core/concurrent/ThreadPool.h"
 #include "palette/Palette.h"
 #include "video/Types.h"
 #include "voxel/ChunkMesh.h"
+#include "voxel/FaceVisibility.h"
 #include "voxel/Mesh.h"
+#include "voxel/PackedMesh.h"
 
 #include "core/GLM.h"
 #include "voxel/RawVolume.h"
@@ -24,8 +26,6 @@
 
 namespace voxel {
 
-static constexpr int MAX_VOLUMES = 2048;
-
 enum MeshType { MeshType_Opaque, MeshType_Transparency, MeshType_Max };
 
 /**
@@ -36,12 +36,42 @@ enum MeshType { MeshType_Opaque, MeshType_Transparency, MeshType_Max };
  */
 class MeshState {
 public:
-	typedef core::Array<voxel::Mesh *, MAX_VOLUMES> Meshes;
-	typedef core::DynamicMap<glm::ivec3, Meshes, 531, glm::hash<glm::ivec3>> MeshesMap;
+	/**
+	 * @brief The chunk meshes of a single volume - the key is the lower corner of the chunk region
+	 */
+	typedef core::DynamicMap<glm::ivec3, voxel::Mesh *, 531, glm::hash<glm::ivec3>> MeshesMap;
+	/**
+	 * @brief The packed chunk meshes of a single volume - a chunk is either in this map or in the @c MeshesMap
+	 * @sa voxel::PackedMesh
+	 */
+	typedef core::DynamicMap<glm::ivec3, voxel::PackedMesh *, 531, glm::hash<glm::ivec3>> PackedMeshesMap;
+	/**
+	 * @brief The amount of detail levels of the opaque chunk meshes - level @c n is extracted at @c 1/2^n of the
+	 * full resolution
+	 */
+	static constexpr int MaxLods = 4;
 
 private:
+	/**
+	 * @brief The cached face visibility of a chunk for the cubic extractor
+	 */
+	struct ChunkFaces {
+		voxel::FaceVisibility faces;
+		/**
+		 * incremented for every scheduled extraction - the masks that are returned by an extraction task are only
+		 * taken over if no other extraction was scheduled in the meantime
+		 */
+		uint32_t generation = 0u;
+		/**
+		 * the masks are up to date and can be handed over to the next extraction task to update them incrementally
+		 * for the modified voxels
+		 */
+		bool valid = false;
+	};
+	typedef core::DynamicMap<glm::ivec3, ChunkFaces *, 531, glm::hash<glm::ivec3>> ChunkFacesMap;
+
 	struct VolumeData {
-		voxel::RawVolume *_rawVolume;
+		voxel::RawVolume *_rawVolume = nullptr;
 		core::Optional<palette::Palette> _palette;
 		bool _hidden = false;
 		bool _gray = false;
@@ -53,12 +83,22 @@ private:
 		glm::vec3 _pivot{0.0f};
 		glm::vec3 _mins{0.0f};
 		glm::vec3 _maxs{0.0f};
+		MeshesMap _meshes[MeshType_Max];
+		/** the opaque chunk meshes of the lower detail levels - starting at level 1 */
+		MeshesMap _lodMeshes[MaxLods - 1];
+		/** the cubic chunk meshes are kept packed - only chunks that are not packable end up in the maps above */
+		PackedMeshesMap _packedMeshes[MeshType_Max];
+		PackedMeshesMap _packedLodMeshes[MaxLods - 1];
+		ChunkFacesMap _chunkFaces;
 		/**
 		 * @brief Applies the pivot and the model matrix
 		 */
 		glm::vec3 centerPos() const;
 	};
-	typedef core::Array<VolumeData, MAX_VOLUMES> Volumes;
+	/**
+	 * @brief Sparse handle table - the slots are allocated on first use and released if the volume is removed
+	 */
+	typedef core::DynamicArray<VolumeData *> Volumes;
 
 	struct ExtractionCtx {
 		ExtractionCtx() {
@@ -66,28 +106,71 @@ private:
 		ExtractionCtx(const glm::ivec3 &_mins, int _idx, voxel::ChunkMesh &&_mesh)
 			: mins(_mins), idx(_idx), mesh(_mesh) {
 		}
+		ExtractionCtx(const glm::ivec3 &_mins, int _idx, voxel::ChunkMesh &&_mesh, uint32_t _generation,
+					  voxel::FaceVisibility &&_faces)
+			: mins(_mins), idx(_idx), mesh(_mesh), generation(_generation), faces(core::move(_faces)),
+			  hasFaces(true) {
+		}
 		glm::ivec3 mins{};
 		int idx = -1;
 		voxel::ChunkMesh mesh;
+		/** the face masks that were built or updated by the extraction task - see ChunkFaces::generation */
+		uint32_t generation = 0u;
+		voxel::FaceVisibility faces;
+		bool hasFaces = false;
+		/** the opaque meshes of the lower detail levels - empty if no levels were extracted */
+		core::DynamicArray<voxel::Mesh> lods;
+		/** the packed meshes - only valid if @c packed is @c true */
+		voxel::PackedChunkMesh packedMesh;
+		core::DynamicArray<voxel::PackedMesh> packedLods;
+		bool packed = false;
+
+		/**
+		 * @brief Converts the extracted meshes into packed meshes and releases the extracted ones
+		 * @return @c false if one of the meshes is not packable - the extracted meshes are kept in this case
+		 */
+		bool pack();
 
 		inline bool operator<(const ExtractionCtx &rhs) const {
 			return idx < rhs.idx;
 		}
 	};
 
-	MeshesMap _meshes[MeshType_Max];
 	Volumes _volumeData;
 	core::VarPtr _meshSize;
 
+	/**
+	 * @return The volume data of the given slot or @c nullptr if the slot is not in use
+	 */
+	VolumeData *volumeData(int idx);
+	const VolumeData *volumeData(int idx) const;
+	/**
+	 * @return The volume data of the given slot - the slot is allocated if it is not yet in use. @c nullptr for
+	 * invalid indices.
+	 */
+	VolumeData *allocVolumeData(int idx);
+	void freeVolumeData(int idx);
+	/**
+	 * @brief The defaults for slots that are not in use
+	 */
+	static const VolumeData &emptyVolumeData();
+
+	ChunkFaces *chunkFaces(const glm::ivec3 &pos, int idx);
+	void deleteChunkFaces(const glm::ivec3 &pos, int idx);
+	void deleteChunkFaces(int idx);
+	void clearChunkFaces();
+
 	struct ExtractRegion {
-		ExtractRegion(const voxel::Region &_region, int _idx, bool _visible)
-			: region(_region), idx(_idx), visible(_visible) {
+		ExtractRegion(const voxel::Region &_region, int _idx, bool _visible, const voxel::Region &_modified)
+			: region(_region), idx(_idx), visible(_visible), modified(_modified) {
 		}
 		ExtractRegion() {
 		}
 		voxel::Region region{};
 		int idx = 0;
 		bool visible = false;
+		/** the modified voxels - used to update the cached face visibility of the chunk */
+		voxel::Region modified{};
 
 		inline bool operator<(const ExtractRegion &rhs) const {
 			return idx < rhs.idx && visible < rhs.visible;
@@ -102,15 +185,41 @@ private:
 	core::ThreadPool _threadPool{core::halfcpus(), "VolumeRndr"};
 	core::ConcurrentPriorityQueue<MeshState::ExtractionCtx> _pendingQueue;
 	core::VarPtr _meshMode;
+	core::VarPtr _meshLod;
 	bool deleteMeshes(const glm::ivec3 &pos, int idx);
 	void clear();
 	bool runScheduledExtractions(size_t maxExtraction = 1);
 	void waitForPendingExtractions();
 	bool deleteMeshes(int idx);
-	void addOrReplaceMeshes(MeshState::ExtractionCtx &result, MeshType type);
+	void addOrReplaceLodMeshes(MeshState::ExtractionCtx &result);
 
 public:
-	const MeshesMap &meshes(MeshType type) const;
+	~MeshState();
+
+	/**
+	 * @return The chunk meshes of the given volume
+	 * @param lod The detail level - only the opaque meshes have lower detail levels
+	 * @sa lodEnabled()
+	 */
+	const MeshesMap &meshes(MeshType type, int idx, int lod = 0) const;
+	/**
+	 * @return The packed chunk meshes of the given volume - see @c meshes() for the chunks that are not packed
+	 * @param lod The detail level - only the opaque meshes have lower detail levels
+	 */
+	const PackedMeshesMap &packedMeshes(MeshType type, int idx, int lod = 0) const;
+	/**
+	 * @return @c true if the lower detail levels of the opaque chunk meshes are extracted
+	 */
+	bool lodEnabled() const;
+	/**
+	 * @return The amount of volume slots - the valid volume indices are in the range [0, volumeSlots())
+	 * @note Not every slot is in use - see hasVolumeData()
+	 */
+	int volumeSlots() const;
+	/**
+	 * @return @c true if the given slot is in use - either by a volume or a reference
+	 */
+	bool hasVolumeData(int idx) const;
 	/**
 	 * @brief This will transfer the extracted meshes into the mesh state and make
 	 * it available to others
@@ -156,6 +265,10 @@ public:
 	 * @sa update()
 	 */
 	voxel::SurfaceExtractionType meshMode() const;
+	/**
+	 * @return The edge length of the chunks that are extracted as separate meshes
+	 */
+	int meshSize() const;
 
 	/**
 	 * @brief Split the region according to the configured mesh size
@@ -207,18 +320,42 @@ inline int MeshState::pendingExtractions() const {
 	return (int)_extractRegions.size();
 }
 
+inline int MeshState::volumeSlots() const {
+	return (int)_volumeData.size();
+}
+
+inline MeshState::VolumeData *MeshState::volumeData(int idx) {
+	if (idx < 0 || idx >= (int)_volumeData.size()) {
+		return nullptr;
+	}
+	return _volumeData[idx];
+}
+
+inline const MeshState::VolumeData *MeshState::volumeData(int idx) const {
+	if (idx < 0 || idx >= (int)_volumeData.size()) {
+		return nullptr;
+	}
+	return _volumeData[idx];
+}
+
+inline bool MeshState::hasVolumeData(int idx) const {
+	return volumeData(idx) != nullptr;
+}
+
 inline voxel::RawVolume *MeshState::volume(int idx) {
-	if (idx < 0 || idx >= MAX_VOLUMES) {
+	VolumeData *data = volumeData(idx);
+	if (data == nullptr) {
 		return nullptr;
 	}
-	return _volumeData[idx]._rawVolume;
+	return data->_rawVolume;
 }
 
 inline const voxel::RawVolume *MeshState::volume(int idx) const {
-	if (idx < 0 || idx >= MAX_VOLUMES) {
+	const VolumeData *data = volumeData(idx);
+	if (data == nullptr) {
 		return nullptr;
 	}
-	return _volumeData[idx]._rawVolume;
+	return data->_rawVolume;
 }
 
 } // namespace voxel
@@ -0,0 +1,204 @@
+/**
+ * @file
+ */
+
+#include "OccupancyPyramid.h"
+#include "RawVolume.h"
+#include "core/Assert.h"
+#include "core/Trace.h"
+#include <glm/common.hpp>
+
+namespace voxel {
+
+OccupancyPyramid::OccupancyPyramid(const RawVolume &volume) {
+	build(volume);
+}
+
+void OccupancyPyramid::clear() {
+	_region = Region::InvalidRegion;
+	_counts.release();
+	_levels.release();
+}
+
+int OccupancyPyramid::brickVoxels(int level, const glm::ivec3 &brick) const {
+	const int shift = _levels[level].shift;
+	const glm::ivec3 mins = _region.getLowerCorner() + (brick << shift);
+	const glm::ivec3 maxs = glm::min(mins + ((1 << shift) - 1), _region.getUpperCorner());
+	const glm::ivec3 dim = maxs - mins + 1;
+	return dim.x * dim.y * dim.z;
+}
+
+void OccupancyPyramid::build(const RawVolume &volume) {
+	core_trace_scoped(OccupancyPyramidBuild);
+	clear();
+	_region = volume.region();
+	const glm::ivec3 &dim = _region.getDimensionsInVoxels();
+	for (int shift = BrickShift;; ++shift) {
+		Level level;
+		level.shift = shift;
+		level.dimensions = (dim + ((1 << shift) - 1)) >> shift;
+		const int bricks = level.dimensions.x * level.dimensions.y * level.dimensions.z;
+		level.flags.resize(bricks);
+		level.flags.fill(0u);
+		_levels.push_back(level);
+		if (bricks == 1) {
+			break;
+		}
+	}
+	const glm::ivec3 &baseDim = _levels[0].dimensions;
+	_counts.resize(baseDim.x * baseDim.y * baseDim.z);
+	_counts.fill(0u);
+	countBricks(volume, _region);
+}
+
+void OccupancyPyramid::update(const RawVolume &volume, const Region &region) {
+	if (!isValid() || volume.region() != _region) {
+		build(volume);
+		return;
+	}
+	Region cropped = region;
+	if (!cropped.isValid() || !cropped.cropTo(_region)) {
+		return;
+	}
+	core_trace_scoped(OccupancyPyramidUpdate);
+	// extend the region to the full bricks - as they are recounted
+	const glm::ivec3 &lower = _region.getLowerCorner();
+	const glm::ivec3 brickMins = (cropped.getLowerCorner() - lower) >> BrickShift;
+	const glm::ivec3 brickMaxs = (cropped.getUpperCorner() - lower) >> BrickShift;
+	Region brickAligned(lower + (brickMins << BrickShift), lower + ((brickMaxs + 1) << BrickShift) - 1);
+	brickAligned.cropTo(_region);
+	const Level &base = _levels[0];
+	for (int z = brickMins.z; z <= brickMaxs.z; ++z) {
+		for (int y = brickMins.y; y <= brickMaxs.y; ++y) {
+			for (int x = brickMins.x; x <= brickMaxs.x; ++x) {
+				_counts[base.index(x, y, z)] = 0u;
+			}
+		}
+	}
+	countBricks(volume, brickAligned);
+}
+
+void OccupancyPyramid::countBricks(const RawVolume &volume, const Region &region) {
+	const Level &base = _levels[0];
+	const glm::ivec3 &lower = _region.getLowerCorner();
+	const glm::ivec3 &mins = region.getLowerCorner();
+	const glm::ivec3 &maxs = region.getUpperCorner();
+	RawVolume::Sampler sampler(volume);
+	for (int z = mins.z; z <= maxs.z; ++z) {
+		const int bz = (z - lower.z) >> BrickShift;
+		for (int y = mins.y; y <= maxs.y; ++y) {
+			const int by = (y - lower.y) >> BrickShift;
+			sampler.setPosition(mins.x, y, z);
+			for (int x = mins.x; x <= maxs.x; ++x) {
+				if (!isAir(sampler.voxel().getMaterial())) {
+					const int bx = (x - lower.x) >> BrickShift;
+					++_counts[base.index(bx, by, bz)];
+				}
+				sampler.movePositiveX();
+			}
+		}
+	}
+	const glm::ivec3 brickMins = (mins - lower) >> BrickShift;
+	const glm::ivec3 brickMaxs = (maxs - lower) >> BrickShift;
+	for (int z = brickMins.z; z <= brickMaxs.z; ++z) {
+		for (int y = brickMins.y; y <= brickMaxs.y; ++y) {
+			for (int x = brickMins.x; x <= brickMaxs.x; ++x) {
+				updateFlags(0, glm::ivec3(x, y, z));
+			}
+		}
+	}
+	updateParents(brickMins, brickMaxs);
+}
+
+void OccupancyPyramid::updateFlags(int level, const glm::ivec3 &brick) {
+	Level &l = _levels[level];
+	uint8_t flags = 0u;
+	if (level == 0) {
+		const int count = _counts[l.index(brick.x, brick.y, brick.z)];
+		if (count > 0) {
+			flags |= BrickOccupied;
+			if (count == brickVoxels(0, brick)) {
+				flags |= BrickFull;
+			}
+		}
+	} else {
+		const Level &child = _levels[level - 1];
+		const glm::ivec3 childMins = brick * 2;
+		const glm::ivec3 childMaxs = glm::min(childMins + 1, child.dimensions - 1);
+		flags = (uint8_t)BrickFull;
+		for (int z = childMins.z; z <= childMaxs.z; ++z) {
+			for (int y = childMins.y; y <= childMaxs.y; ++y) {
+				for (int x = childMins.x; x <= childMaxs.x; ++x) {
+					const uint8_t childFlags = child.flags[child.index(x, y, z)];
+					flags |= (uint8_t)(childFlags & BrickOccupied);
+					if ((childFlags & BrickFull) == 0) {
+						flags &= (uint8_t)~BrickFull;
+					}
+				}
+			}
+		}
+	}
+	l.flags[l.index(brick.x, brick.y, brick.z)] = flags;
+}
+
+void OccupancyPyramid::updateParents(const glm::ivec3 &brickMins, const glm::ivec3 &brickMaxs) {
+	glm::ivec3 mins = brickMins;
+	glm::ivec3 maxs = brickMaxs;
+	for (int level = 1; level < (int)_levels.size(); ++level) {
+		mins >>= 1;
+		maxs >>= 1;
+		for (int z = mins.z; z <= maxs.z; ++z) {
+			for (int y = mins.y; y <= maxs.y; ++y) {
+				for (int x = mins.x; x <= maxs.x; ++x) {
+					updateFlags(level, glm::ivec3(x, y, z));
+				}
+			}
+		}
+	}
+}
+
+void OccupancyPyramid::setVoxel(const glm::ivec3 &pos, const Voxel &oldVoxel, const Voxel &newVoxel) {
+	if (!isValid() || !_region.containsPoint(pos)) {
+		return;
+	}
+	const bool wasSolid = !isAir(oldVoxel.getMaterial());
+	const bool isSolid = !isAir(newVoxel.getMaterial());
+	if (wasSolid == isSolid) {
+		return;
+	}
+	const glm::ivec3 brick = (pos - _region.getLowerCorner()) >> BrickShift;
+	uint16_t &count = _counts[_levels[0].index(brick.x, brick.y, brick.z)];
+	if (isSolid) {
+		++count;
+	} else {
+		core_assert(count > 0u);
+		--count;
+	}
+	updateFlags(0, brick);
+	updateParents(brick, brick);
+}
+
+int OccupancyPyramid::emptyLevel(const glm::ivec3 &pos) const {
+	if (!isValid() || !_region.containsPoint(pos)) {
+		return -1;
+	}
+	int level = -1;
+	for (int i = 0; i < (int)_levels.size(); ++i) {
+		if (flags(i, pos) & BrickOccupied) {
+			break;
+		}
+		level = i;
+	}
+	return level;
+}
+
+Region OccupancyPyramid::brickRegion(int level, const glm::ivec3 &pos) const {
+	const int shift = _levels[level].shift;
+	const glm::ivec3 &lower = _region.getLowerCorner();
+	const glm::ivec3 mins = lower + (((pos - lower) >> shift) << shift);
+	Region region(mins, mins + ((1 << shift) - 1));
+	region.cropTo(_region);
+	return region;
+}
+
+} // namespace voxel
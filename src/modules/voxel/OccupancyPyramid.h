@@ -0,0 +1,146 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "Region.h"
+#include "Voxel.h"
+#include "core/collection/Buffer.h"
+#include "core/collection/DynamicArray.h"
+#include <glm/vec3.hpp>
+
+namespace voxel {
+
+class RawVolume;
+
+/**
+ * @brief Hierarchical occupancy information for a @c RawVolume
+ *
+ * The volume is split into bricks of @c BrickSize voxels per axis. For each brick the amount of solid voxels is
+ * tracked, which allows to update the occupancy incrementally for every single voxel change. On top of these bricks
+ * a mip-pyramid of occupancy flags is maintained - where each level doubles the brick size. A brick on any level is
+ * only flagged as empty if none of the voxels that it covers is solid.
+ *
+ * This allows e.g. a raycast to skip large empty areas of a volume without visiting every single voxel.
+ *
+ * @note The pyramid doesn't observe the volume. It's the callers responsibility to call @c update() or @c setVoxel()
+ * whenever the volume is modified.
+ * @sa voxelutil::raycastWithEndpoints()
+ */
+class OccupancyPyramid {
+public:
+	static constexpr int BrickShift = 3;
+	static constexpr int BrickSize = 1 << BrickShift;
+
+	enum BrickFlags : uint8_t {
+		/** at least one voxel in the brick is solid */
+		BrickOccupied = 1 << 0,
+		/** all voxels in the brick are solid */
+		BrickFull = 1 << 1
+	};
+
+private:
+	struct Level {
+		glm::ivec3 dimensions{0};
+		int shift = 0;
+		core::Buffer<uint8_t> flags;
+
+		inline int index(int x, int y, int z) const {
+			return x + y * dimensions.x + z * dimensions.x * dimensions.y;
+		}
+	};
+
+	Region _region = Region::InvalidRegion;
+	/** amount of solid voxels per brick of the first level */
+	core::Buffer<uint16_t> _counts;
+	core::DynamicArray<Level> _levels;
+
+	/**
+	 * @return The amount of voxels of the brick that are inside the volume region
+	 */
+	int brickVoxels(int level, const glm::ivec3 &brick) const;
+	void updateFlags(int level, const glm::ivec3 &brick);
+	void updateParents(const glm::ivec3 &brickMins, const glm::ivec3 &brickMaxs);
+	void countBricks(const RawVolume &volume, const Region &region);
+
+public:
+	OccupancyPyramid() {
+	}
+	explicit OccupancyPyramid(const RawVolume &volume);
+
+	/**
+	 * @brief (Re-)build the whole pyramid for the given volume
+	 */
+	void build(const RawVolume &volume);
+	/**
+	 * @brief Update the occupancy for all bricks that intersect the given region
+	 * @note If the volume region changed, the pyramid is rebuilt
+	 */
+	void update(const RawVolume &volume, const Region &region);
+	/**
+	 * @brief Incrementally update the occupancy for a single voxel change
+	 */
+	void setVoxel(const glm::ivec3 &pos, const Voxel &oldVoxel, const Voxel &newVoxel);
+	void clear();
+
+	bool isValid() const;
+	const Region &region() const;
+	int levels() const;
+
+	/**
+	 * @return The brick size of the given level in voxels
+	 */
+	int brickSize(int level) const;
+	/**
+	 * @return The flags of the brick on the given level that contains the given volume position
+	 * @sa BrickFlags
+	 */
+	uint8_t flags(int level, const glm::ivec3 &pos) const;
+	/**
+	 * @return @c true if no voxel of the brick on the given level that contains the given volume position is solid.
+	 * Positions outside the volume region are reported as occupied.
+	 */
+	bool empty(int level, const glm::ivec3 &pos) const;
+	/**
+	 * @return The highest level of an empty brick that contains the given volume position or @c -1 if the brick on
+	 * the first level is already occupied.
+	 */
+	int emptyLevel(const glm::ivec3 &pos) const;
+	/**
+	 * @return The region of the brick on the given level that contains the given volume position - cropped to the
+	 * volume region
+	 */
+	Region brickRegion(int level, const glm::ivec3 &pos) const;
+};
+
+inline bool OccupancyPyramid::isValid() const {
+	return !_levels.empty();
+}
+
+inline const Region &OccupancyPyramid::region() const {
+	return _region;
+}
+
+inline int OccupancyPyramid::levels() const {
+	return (int)_levels.size();
+}
+
+inline int OccupancyPyramid::brickSize(int level) const {
+	return BrickSize << level;
+}
+
+inline uint8_t OccupancyPyramid::flags(int level, const glm::ivec3 &pos) const {
+	const Level &l = _levels[level];
+	const glm::ivec3 brick = (pos - _region.getLowerCorner()) >> l.shift;
+	return l.flags[l.index(brick.x, brick.y, brick.z)];
+}
+
+inline bool OccupancyPyramid::empty(int level, const glm::ivec3 &pos) const {
+	if (!_region.containsPoint(pos)) {
+		return false;
+	}
+	return (flags(level, pos) & BrickOccupied) == 0;
+}
+
+} // namespace voxel
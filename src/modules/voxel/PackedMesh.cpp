@@ -0,0 +1,139 @@
+/**
+ * @file
+ */
+
+#include "PackedMesh.h"
+#include "core/Algorithm.h"
+#include "core/Trace.h"
+#include "voxel/Mesh.h"
+#include <glm/geometric.hpp>
+#include <glm/gtc/epsilon.hpp>
+#include <glm/vector_relational.hpp>
+
+namespace voxel {
+
+bool PackedMesh::isPackable(const Mesh &mesh) {
+	if (!mesh.getNormalVector().empty()) {
+		return false;
+	}
+	const VertexArray &vertices = mesh.getVertexVector();
+	if (vertices.size() > (size_t)UINT16_MAX + 1u) {
+		return false;
+	}
+	for (const VoxelVertex &vertex : vertices) {
+		if (!voxel::isPackable(vertex)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool PackedMesh::pack(const Mesh &mesh) {
+	core_trace_scoped(PackedMeshPack);
+	clear();
+	if (!isPackable(mesh)) {
+		return false;
+	}
+	const VertexArray &vertices = mesh.getVertexVector();
+	const IndexArray &indices = mesh.getIndexVector();
+	_vertices.reserve(vertices.size());
+	for (const VoxelVertex &vertex : vertices) {
+		_vertices.push_back(packVertex(vertex));
+	}
+	_indices.reserve(indices.size());
+	for (IndexType index : indices) {
+		_indices.push_back((PackedIndexType)index);
+	}
+	_offset = mesh.getOffset();
+	return true;
+}
+
+void PackedMesh::unpack(Mesh &mesh) const {
+	core_trace_scoped(PackedMeshUnpack);
+	mesh.clear();
+	mesh.getNormalVector().clear();
+	VertexArray &vertices = mesh.getVertexVector();
+	vertices.reserve(_vertices.size());
+	for (const PackedVoxelVertex &packed : _vertices) {
+		vertices.push_back(unpackVertex(packed));
+	}
+	IndexArray &indices = mesh.getIndexVector();
+	indices.reserve(_indices.size());
+	for (PackedIndexType index : _indices) {
+		indices.push_back((IndexType)index);
+	}
+	mesh.setOffset(_offset);
+	mesh.calculateBounds();
+}
+
+void PackedMesh::clear() {
+	_vertices.clear();
+	_indices.clear();
+	_offset = glm::ivec3(0);
+}
+
+bool PackedMesh::sort(const glm::vec3 &cameraPos) {
+	if (glm::all(glm::epsilonEqual(cameraPos, _lastCameraPos, glm::vec3(0.5f)))) {
+		return false;
+	}
+	_lastCameraPos = cameraPos;
+	core_trace_scoped(PackedMeshSort);
+	struct TriangleDistance {
+		float distance;
+		int triangle;
+	};
+	const int triangles = (int)_indices.size() / 3;
+	core::DynamicArray<TriangleDistance> distances;
+	distances.reserve(triangles);
+	for (int i = 0; i < triangles; ++i) {
+		const glm::vec3 p0 = _vertices[_indices[i * 3 + 0]].position();
+		const glm::vec3 p1 = _vertices[_indices[i * 3 + 1]].position();
+		const glm::vec3 p2 = _vertices[_indices[i * 3 + 2]].position();
+		const glm::vec3 center = (p0 + p1 + p2) / 3.0f;
+		distances.push_back({glm::distance(center, cameraPos), i});
+	}
+	core::sort(distances.begin(), distances.end(),
+			   [](const TriangleDistance &lhs, const TriangleDistance &rhs) { return lhs.distance < rhs.distance; });
+	PackedIndexArray sorted;
+	sorted.reserve(_indices.size());
+	for (const TriangleDistance &d : distances) {
+		sorted.push_back(_indices[d.triangle * 3 + 0]);
+		sorted.push_back(_indices[d.triangle * 3 + 1]);
+		sorted.push_back(_indices[d.triangle * 3 + 2]);
+	}
+	_indices = core::move(sorted);
+	return true;
+}
+
+size_t PackedMesh::dataSize() const {
+	return _vertices.size() * sizeof(PackedVoxelVertex) + _indices.size() * sizeof(PackedIndexType);
+}
+
+bool PackedChunkMesh::pack(const ChunkMesh &chunkMesh) {
+	for (int i = 0; i < ChunkMesh::Meshes; ++i) {
+		if (!mesh[i].pack(chunkMesh.mesh[i])) {
+			for (int j = 0; j < i; ++j) {
+				mesh[j].clear();
+			}
+			return false;
+		}
+	}
+	return true;
+}
+
+void PackedChunkMesh::unpack(ChunkMesh &chunkMesh) const {
+	for (int i = 0; i < ChunkMesh::Meshes; ++i) {
+		mesh[i].unpack(chunkMesh.mesh[i]);
+	}
+}
+
+bool PackedChunkMesh::isEmpty() const {
+	for (int i = 0; i < ChunkMesh::Meshes; ++i) {
+		if (!mesh[i].isEmpty()) {
+			return false;
+		}
+	}
+	return true;
+}
+
+} // namespace voxel
@@ -0,0 +1,108 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "VoxelVertex.h"
+#include "core/collection/DynamicArray.h"
+#include "voxel/ChunkMesh.h"
+#include <glm/vec3.hpp>
+
+namespace voxel {
+
+using PackedVertexArray = core::DynamicArray<voxel::PackedVoxelVertex, 1024>;
+using PackedIndexArray = core::DynamicArray<voxel::PackedIndexType, 1024>;
+
+/**
+ * @brief Compact representation of a cubic chunk mesh with 8 byte vertices and 16 bit indices - half the size of a
+ * @c Mesh
+ *
+ * Meshes with normals (marching cubes), non-integral positions or more than 65536 vertices can't be packed.
+ */
+class PackedMesh {
+private:
+	PackedVertexArray _vertices;
+	PackedIndexArray _indices;
+	glm::ivec3 _offset{0};
+	glm::vec3 _lastCameraPos{0.0f};
+
+public:
+	/**
+	 * @return @c true if the given mesh can be converted into a packed mesh without losing information
+	 */
+	static bool isPackable(const Mesh &mesh);
+
+	/**
+	 * @return @c false if the mesh is not packable - the packed mesh is cleared in this case
+	 * @sa isPackable()
+	 */
+	bool pack(const Mesh &mesh);
+	/**
+	 * @brief Converts the packed data back into the given mesh - e.g. for the mesh exporters
+	 */
+	void unpack(Mesh &mesh) const;
+
+	void clear();
+	bool isEmpty() const;
+	/**
+	 * @brief Sorts the triangles by their distance to the camera - see @c Mesh::sort()
+	 * @return @c true if sorting was needed
+	 */
+	bool sort(const glm::vec3 &cameraPos);
+	size_t getNoOfVertices() const;
+	size_t getNoOfIndices() const;
+	/**
+	 * @return The amount of bytes the vertex and index data occupy
+	 */
+	size_t dataSize() const;
+
+	VoxelVertex getVertex(PackedIndexType index) const;
+	const PackedVertexArray &getVertexVector() const;
+	const PackedIndexArray &getIndexVector() const;
+	const glm::ivec3 &getOffset() const;
+};
+
+inline bool PackedMesh::isEmpty() const {
+	return _indices.empty();
+}
+
+inline size_t PackedMesh::getNoOfVertices() const {
+	return _vertices.size();
+}
+
+inline size_t PackedMesh::getNoOfIndices() const {
+	return _indices.size();
+}
+
+inline VoxelVertex PackedMesh::getVertex(PackedIndexType index) const {
+	return unpackVertex(_vertices[index]);
+}
+
+inline const PackedVertexArray &PackedMesh::getVertexVector() const {
+	return _vertices;
+}
+
+inline const PackedIndexArray &PackedMesh::getIndexVector() const {
+	return _indices;
+}
+
+inline const glm::ivec3 &PackedMesh::getOffset() const {
+	return _offset;
+}
+
+/**
+ * @brief The packed meshes of a @c ChunkMesh - the opaque and the transparent mesh of the cubic extractor
+ */
+struct PackedChunkMesh {
+	PackedMesh mesh[ChunkMesh::Meshes];
+
+	/**
+	 * @return @c false if one of the meshes is not packable - the packed chunk mesh is cleared in this case
+	 */
+	bool pack(const ChunkMesh &chunkMesh);
+	void unpack(ChunkMesh &chunkMesh) const;
+	bool isEmpty() const;
+};
+
+} // namespace voxel
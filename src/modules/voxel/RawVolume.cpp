@@ -10,6 +10,28 @@
 
 namespace voxel {
 
+void RawVolume::setLayout(VolumeLayout layout) {
+	_layout = layout;
+	switch (layout) {
+	case VolumeLayout::Brick4:
+		_brickShift = 2;
+		break;
+	case VolumeLayout::Brick8:
+		_brickShift = 3;
+		break;
+	default:
+		_layout = VolumeLayout::Linear;
+		_brickShift = 0;
+		break;
+	}
+	const int brickSize = 1 << _brickShift;
+	_bricks = (_region.getDimensionsInVoxels() + (brickSize - 1)) >> _brickShift;
+}
+
+size_t RawVolume::dataSize() const {
+	return (size_t)_bricks.x * (size_t)_bricks.y * (size_t)_bricks.z * ((size_t)1 << (3 * _brickShift)) * sizeof(Voxel);
+}
+
 size_t RawVolume::size(const Region &region) {
 	const size_t w = region.getWidthInVoxels();
 	const size_t h = region.getHeightInVoxels();
@@ -18,8 +40,8 @@ size_t RawVolume::size(const Region &region) {
 	return size;
 }
 
-RawVolume::RawVolume(const Region& regValid) :
-		_region(regValid) {
+RawVolume::RawVolume(const Region& regValid, VolumeLayout layout) :
+		_region(regValid), _layout(layout) {
 	//Create a volume of the right size.
 	initialise(regValid);
 }
@@ -27,19 +49,66 @@ RawVolume::RawVolume(const Region& regValid) :
 RawVolume::RawVolume(const RawVolume* copy) :
 		_region(copy->region()) {
 	setBorderValue(copy->borderValue());
-	const size_t size = width() * height() * depth() * sizeof(Voxel);
-	_data = (Voxel*)core_malloc(size);
-	_borderVoxel = copy->_borderVoxel;
-	core_memcpy((void*)_data, (void*)copy->_data, size);
+	setLayout(copy->_layout);
+	share(*copy);
 }
 
 RawVolume::RawVolume(const RawVolume& copy) :
 		_region(copy.region()) {
 	setBorderValue(copy.borderValue());
-	const size_t size = width() * height() * depth() * sizeof(Voxel);
-	_data = (Voxel*)core_malloc(size);
-	_borderVoxel = copy._borderVoxel;
-	core_memcpy((void*)_data, (void*)copy._data, size);
+	setLayout(copy._layout);
+	share(copy);
+}
+
+void RawVolume::share(const RawVolume &src) {
+	core::AtomicInt *shared = src._shared;
+	if (shared == nullptr) {
+		// the source is const and might get shared from several threads at the same time - only one counter wins
+		core::AtomicInt *counter = new core::AtomicInt(1);
+		if (src._shared.compare_exchange(nullptr, counter)) {
+			shared = counter;
+		} else {
+			delete counter;
+			shared = src._shared;
+		}
+	}
+	shared->increment();
+	_shared = shared;
+	_data = src._data;
+}
+
+bool RawVolume::isShared() const {
+	const core::AtomicInt *shared = _shared;
+	return shared != nullptr && *shared > 1;
+}
+
+void RawVolume::detachShared() {
+	core::AtomicInt *shared = _shared;
+	if (*shared == 1) {
+		// all other volumes that shared the data are gone
+		delete shared;
+		_shared = nullptr;
+		return;
+	}
+	const size_t size = dataSize();
+	Voxel *data = (Voxel *)core_malloc(size);
+	core_memcpy((void *)data, (const void *)_data, size);
+	release();
+	_data = data;
+}
+
+void RawVolume::release() {
+	if (_shared == nullptr) {
+		core_free(_data);
+	} else {
+		core::AtomicInt *shared = _shared;
+		if (shared->decrement() == 1) {
+			core_free(_data);
+			delete shared;
+		}
+		_shared = nullptr;
+	}
+	_data = nullptr;
 }
 
 static inline voxel::Region accumulate(const core::DynamicArray<Region>& regions) {
@@ -55,7 +124,7 @@ static inline voxel::Region accumulate(const core::DynamicArray<Region>& regions
 }
 
 RawVolume::RawVolume(const RawVolume &src, const core::DynamicArray<Region> &copyRegions)
-	: _region(accumulate(copyRegions)) {
+	: _region(accumulate(copyRegions)), _layout(src._layout) {
 	_region.cropTo(src.region());
 	setBorderValue(src.borderValue());
 	initialise(_region);
@@ -80,25 +149,49 @@ RawVolume::RawVolume(const RawVolume &src, const core::DynamicArray<Region> &cop
 
 RawVolume::RawVolume(const RawVolume& src, const Region& region, bool *onlyAir) : _region(region) {
 	setBorderValue(src.borderValue());
-	const size_t size = width() * height() * depth() * sizeof(Voxel);
+	setLayout(src._layout);
+	if (src.region() == _region) {
+		share(src);
+		if (onlyAir) {
+			*onlyAir = false;
+		}
+		return;
+	}
+	const size_t size = dataSize();
 	_data = (Voxel *)core_malloc(size);
 	if (!intersects(src.region(), _region)) {
 		if (onlyAir) {
 			*onlyAir = true;
 		}
 		core_memset((void *)_data, 0, size);
-	} else if (src.region() == _region) {
-		core_memcpy((void *)_data, (void *)src._data, size);
-		if (onlyAir) {
-			*onlyAir = false;
-		}
 	} else {
 		if (!src.region().containsRegion(_region)) {
 			_region.cropTo(src._region);
+			setLayout(_layout);
 		}
 		if (onlyAir) {
 			*onlyAir = true;
 		}
+		if (_layout != VolumeLayout::Linear) {
+			core_memset((void *)_data, 0, size);
+			const glm::ivec3 &tgtMins = _region.getLowerCorner();
+			const glm::ivec3 &tgtMaxs = _region.getUpperCorner();
+			const glm::ivec3 srcOffset = tgtMins - src._region.getLowerCorner();
+			const glm::ivec3 dim = tgtMaxs - tgtMins;
+			for (int z = 0; z <= dim.z; ++z) {
+				for (int y = 0; y <= dim.y; ++y) {
+					for (int x = 0; x <= dim.x; ++x) {
+						const Voxel &voxel = src._data[src.index(x + srcOffset.x, y + srcOffset.y, z + srcOffset.z)];
+						_data[index(x, y, z)] = voxel;
+						if (onlyAir && !voxel::isAir(voxel.getMaterial())) {
+							*onlyAir = false;
+							onlyAir = nullptr;
+						}
+					}
+				}
+			}
+			return;
+		}
 		const glm::ivec3 &tgtMins = _region.getLowerCorner();
 		const glm::ivec3 &tgtMaxs = _region.getUpperCorner();
 		const glm::ivec3 &srcMins = src._region.getLowerCorner();
@@ -133,7 +226,13 @@ RawVolume::RawVolume(const RawVolume& src, const Region& region, bool *onlyAir)
 RawVolume::RawVolume(RawVolume&& move) noexcept {
 	_data = move._data;
 	move._data = nullptr;
+	_shared = move._shared;
+	move._shared = nullptr;
+	_borderVoxel = move._borderVoxel;
 	_region = move._region;
+	_layout = move._layout;
+	_brickShift = move._brickShift;
+	_bricks = move._bricks;
 }
 
 RawVolume::RawVolume(const Voxel* data, const voxel::Region& region) {
@@ -147,11 +246,11 @@ RawVolume::RawVolume(Voxel* data, const voxel::Region& region) :
 	core_assert_msg(width() > 0, "Volume width must be greater than zero.");
 	core_assert_msg(height() > 0, "Volume height must be greater than zero.");
 	core_assert_msg(depth() > 0, "Volume depth must be greater than zero.");
+	setLayout(VolumeLayout::Linear);
 }
 
 RawVolume::~RawVolume() {
-	core_free(_data);
-	_data = nullptr;
+	release();
 }
 
 bool RawVolume::move(const glm::ivec3 &shift) {
@@ -164,6 +263,21 @@ bool RawVolume::move(const glm::ivec3 &shift) {
 	t.y = (t.y % h + h) % h;
 	t.z = (t.z % d + d) % d;
 
+	detach();
+	if (_layout != VolumeLayout::Linear) {
+		Voxel *linear = copyVoxels();
+		for (int z = 0; z < d; ++z) {
+			for (int y = 0; y < h; ++y) {
+				for (int x = 0; x < w; ++x) {
+					const int srcIndex = (x + t.x) % w + ((y + t.y) % h) * w + ((z + t.z) % d) * w * h;
+					_data[index(x, y, z)] = linear[srcIndex];
+				}
+			}
+		}
+		core_free(linear);
+		return true;
+	}
+
 	const int hwstride = h * w;
 	for (int z = 0; z < d; ++z) {
 		const int zhwstride = z * hwstride;
@@ -186,7 +300,20 @@ bool RawVolume::move(const glm::ivec3 &shift) {
 Voxel* RawVolume::copyVoxels() const {
 	const size_t size = width() * height() * depth() * sizeof(Voxel);
 	Voxel* rawCopy = (Voxel*)core_malloc(size);
-	core_memcpy((void*)rawCopy, (void*)_data, size);
+	if (_layout == VolumeLayout::Linear) {
+		core_memcpy((void*)rawCopy, (void*)_data, size);
+		return rawCopy;
+	}
+	const int w = width();
+	const int h = height();
+	const int d = depth();
+	for (int z = 0; z < d; ++z) {
+		for (int y = 0; y < h; ++y) {
+			for (int x = 0; x < w; ++x) {
+				rawCopy[x + y * w + z * w * h] = _data[index(x, y, z)];
+			}
+		}
+	}
 	return rawCopy;
 }
 
@@ -204,7 +331,7 @@ const Voxel& RawVolume::voxel(int32_t x, int32_t y, int32_t z) const {
 		const int32_t iLocalYPos = y - _region.getLowerY();
 		const int32_t iLocalZPos = z - _region.getLowerZ();
 
-		return _data[iLocalXPos + iLocalYPos * width() + iLocalZPos * width() * height()];
+		return _data[index(iLocalXPos, iLocalYPos, iLocalZPos)];
 	}
 	return _borderVoxel;
 }
@@ -242,19 +369,20 @@ bool RawVolume::setVoxel(const glm::ivec3& pos, const Voxel& voxel) {
 	}
 	const glm::ivec3& lowerCorner = _region.getLowerCorner();
 	const glm::ivec3 localPos = pos - lowerCorner;
-	const int index = localPos.x + localPos.y * width() + localPos.z * width() * height();
-	if (_data[index].isSame(voxel)) {
+	const int idx = index(localPos.x, localPos.y, localPos.z);
+	if (_data[idx].isSame(voxel)) {
 		return false;
 	}
-	_data[index] = voxel;
+	detach();
+	_data[idx] = voxel;
 	return true;
 }
 
 void RawVolume::setVoxelUnsafe(const glm::ivec3 &pos, const Voxel &voxel) {
+	detach();
 	const glm::ivec3& lowerCorner = _region.getLowerCorner();
 	const glm::ivec3 localPos = pos - lowerCorner;
-	const int index = localPos.x + localPos.y * width() + localPos.z * width() * height();
-	_data[index] = voxel;
+	_data[index(localPos.x, localPos.y, localPos.z)] = voxel;
 }
 
 /**
@@ -268,7 +396,8 @@ void RawVolume::initialise(const Region& regValidRegion) {
 	core_assert_msg(depth() > 0, "Volume depth must be greater than zero.");
 
 	//Create the data
-	const size_t size = width() * height() * depth() * sizeof(Voxel);
+	setLayout(_layout);
+	const size_t size = dataSize();
 	_data = (Voxel*)core_malloc(size);
 	core_assert_msg_always(_data != nullptr, "Failed to allocate the memory for a volume with the dimensions %i:%i:%i", width(),  height(), depth());
 
@@ -277,16 +406,20 @@ void RawVolume::initialise(const Region& regValidRegion) {
 }
 
 void RawVolume::clear() {
-	const size_t size = width() * height() * depth() * sizeof(Voxel);
-	core_memset(_data, 0, size);
+	if (_shared != nullptr) {
+		// no need to copy the shared data that is overwritten anyway
+		release();
+		_data = (Voxel *)core_malloc(dataSize());
+	}
+	core_memset(_data, 0, dataSize());
 }
 
 RawVolume::Sampler::Sampler(const RawVolume* volume) :
-		_volume(const_cast<RawVolume*>(volume)), _region(volume->region()) {
+		_volume(const_cast<RawVolume*>(volume)), _region(volume->region()), _linear(volume->_layout == VolumeLayout::Linear) {
 }
 
 RawVolume::Sampler::Sampler(const RawVolume& volume) :
-		_volume(const_cast<RawVolume*>(&volume)), _region(volume.region()) {
+		_volume(const_cast<RawVolume*>(&volume)), _region(volume.region()), _linear(volume._layout == VolumeLayout::Linear) {
 }
 
 RawVolume::Sampler::~Sampler() {
@@ -296,10 +429,24 @@ bool RawVolume::Sampler::setVoxel(const Voxel& voxel) {
 	if (_currentPositionInvalid) {
 		return false;
 	}
+	_volume->detach();
+	if (_data != _volume->_data) {
+		setPosition(_posInVolume);
+	}
 	*_currentVoxel = voxel;
 	return true;
 }
 
+void RawVolume::Sampler::resolveCurrentVoxel() const {
+	_data = _volume->_data;
+	if (_currentVoxel == nullptr) {
+		return;
+	}
+	const glm::ivec3 &lowerCorner = region().getLowerCorner();
+	const glm::ivec3 localPos = _posInVolume - lowerCorner;
+	_currentVoxel = _data + _volume->index(localPos.x, localPos.y, localPos.z);
+}
+
 bool RawVolume::Sampler::setPosition(int32_t xPos, int32_t yPos, int32_t zPos) {
 	_posInVolume.x = xPos;
 	_posInVolume.y = yPos;
@@ -323,9 +470,10 @@ bool RawVolume::Sampler::setPosition(int32_t xPos, int32_t yPos, int32_t zPos) {
 		const int32_t iLocalXPos = xPos - v3dLowerCorner.x;
 		const int32_t iLocalYPos = yPos - v3dLowerCorner.y;
 		const int32_t iLocalZPos = zPos - v3dLowerCorner.z;
-		const int32_t uVoxelIndex = iLocalXPos + iLocalYPos * _volume->width() + iLocalZPos * _volume->width() * _volume->height();
+		const int32_t uVoxelIndex = _volume->index(iLocalXPos, iLocalYPos, iLocalZPos);
 
-		_currentVoxel = _volume->_data + uVoxelIndex;
+		_data = _volume->_data;
+		_currentVoxel = _data + uVoxelIndex;
 		return true;
 	}
 	_currentVoxel = nullptr;
@@ -360,7 +508,7 @@ void RawVolume::Sampler::movePositiveX(uint32_t offset) {
 	}
 
 	// Then we update the voxel pointer
-	if (!bIsOldPositionValid) {
+	if (!bIsOldPositionValid || !_linear || _data != _volume->_data) {
 		setPosition(_posInVolume);
 	} else if (currentPositionValid()) {
 		_currentVoxel += (intptr_t)offset;
@@ -381,7 +529,7 @@ void RawVolume::Sampler::movePositiveY(uint32_t offset) {
 	}
 
 	// Then we update the voxel pointer
-	if (!bIsOldPositionValid) {
+	if (!bIsOldPositionValid || !_linear || _data != _volume->_data) {
 		setPosition(_posInVolume);
 	} else if (currentPositionValid()) {
 		_currentVoxel += (intptr_t)(_volume->width() * offset);
@@ -402,7 +550,7 @@ void RawVolume::Sampler::movePositiveZ(uint32_t offset) {
 	}
 
 	// Then we update the voxel pointer
-	if (!bIsOldPositionValid) {
+	if (!bIsOldPositionValid || !_linear || _data != _volume->_data) {
 		setPosition(_posInVolume);
 	} else if (currentPositionValid()) {
 		_currentVoxel += (intptr_t)(_volume->width() * _volume->height() * offset);
@@ -439,7 +587,7 @@ void RawVolume::Sampler::moveNegativeX(uint32_t offset) {
 	}
 
 	// Then we update the voxel pointer
-	if (!bIsOldPositionValid) {
+	if (!bIsOldPositionValid || !_linear || _data != _volume->_data) {
 		setPosition(_posInVolume);
 	} else if (currentPositionValid()) {
 		_currentVoxel -= (intptr_t)offset;
@@ -460,7 +608,7 @@ void RawVolume::Sampler::moveNegativeY(uint32_t offset) {
 	}
 
 	// Then we update the voxel pointer
-	if (!bIsOldPositionValid) {
+	if (!bIsOldPositionValid || !_linear || _data != _volume->_data) {
 		setPosition(_posInVolume);
 	} else if (currentPositionValid()) {
 		_currentVoxel -= (intptr_t)(_volume->width() * offset);
@@ -481,7 +629,7 @@ void RawVolume::Sampler::moveNegativeZ(uint32_t offset) {
 	}
 
 	// Then we update the voxel pointer
-	if (!bIsOldPositionValid) {
+	if (!bIsOldPositionValid || !_linear || _data != _volume->_data) {
 		setPosition(_posInVolume);
 	} else if (currentPositionValid()) {
 		_currentVoxel -= (intptr_t)(_volume->width() * _volume->height() * offset);
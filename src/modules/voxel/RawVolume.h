@@ -4,16 +4,45 @@
 
 #pragma once
 
+#include "Morton.h"
 #include "Region.h"
 #include "Voxel.h"
 #include "core/collection/DynamicArray.h"
+#include "core/concurrent/Atomic.h"
 #include "math/Axis.h"
 #include <glm/vec3.hpp>
 
 namespace voxel {
 
+/**
+ * @brief The memory layout of the voxels of a @c RawVolume
+ *
+ * The linear layout stores the voxels row by row (x-major) and slice by slice. Neighbours in y or z direction are
+ * far away from each other in memory for large volumes. The brick layouts store cubes of voxels (bricks) in one
+ * continuous memory block - the voxels inside of a brick are stored in morton order. This keeps all neighbours of a
+ * voxel close together and is more cache friendly for algorithms that look at the neighbours of a voxel (like the
+ * surface extraction) on large volumes.
+ *
+ * @note The raw data (see @c RawVolume::data()) is only usable as a plain 3D array with the linear layout.
+ */
+enum class VolumeLayout : uint8_t {
+	Linear,
+	/** 4x4x4 voxel bricks */
+	Brick4,
+	/** 8x8x8 voxel bricks */
+	Brick8,
+
+	Max
+};
+
 /**
  * Simple volume implementation which stores data in a single large 3D array.
+ *
+ * Copies of a volume share the voxel data until one of them is modified - the modified volume gets its own copy of
+ * the voxel data on the first write (copy on write). This makes duplicating a volume cheap. Several threads may copy
+ * the same const volume at the same time. Writing to a volume while it is copied or written by another thread is not
+ * supported.
+ * @sa VolumeLayout
  */
 class RawVolume {
 public:
@@ -79,15 +108,34 @@ public:
 		const Voxel &peekVoxel1px1py1pz() const;
 
 	protected:
+		/**
+		 * @brief Resolves the current voxel pointer again if the voxel data of the volume was detached
+		 */
+		void resolveCurrentVoxel() const;
+		inline const Voxel *currentVoxel() const {
+			if (_data != _volume->_data) {
+				resolveCurrentVoxel();
+			}
+			return _currentVoxel;
+		}
+
 		RawVolume *_volume;
 
 		voxel::Region _region;
 
+		/** the sampler can use pointer arithmetic to move and peek */
+		bool _linear;
+
 		// The current position in the volume
 		glm::ivec3 _posInVolume{0, 0, 0};
 
 		/** Other current position information */
-		Voxel *_currentVoxel = nullptr;
+		mutable Voxel *_currentVoxel = nullptr;
+		/**
+		 * the voxel data the current position points into - a modification of a shared volume detaches the voxel
+		 * data and the position must be resolved again
+		 */
+		mutable Voxel *_data = nullptr;
 
 		/** Whether the current position is inside the volume */
 		uint8_t _currentPositionInvalid = 0u;
@@ -98,7 +146,7 @@ public:
 
 public:
 	/// Constructor for creating a fixed size volume.
-	RawVolume(const Region &region);
+	RawVolume(const Region &region, VolumeLayout layout = VolumeLayout::Linear);
 	RawVolume(const RawVolume *copy);
 	RawVolume(const RawVolume &copy);
 	RawVolume(RawVolume &&move) noexcept;
@@ -121,11 +169,29 @@ public:
 	~RawVolume();
 
 	/**
-	 * Copy the raw data of the volume
+	 * @return @c true if the voxel data is shared with copies of this volume
+	 */
+	bool isShared() const;
+	/**
+	 * @brief Gives the volume its own copy of the voxel data if the data is shared
+	 *
+	 * This is done automatically by the modifying functions. Call it once before modifying the volume from several
+	 * threads at the same time.
+	 */
+	inline void detach() {
+		if (_shared != nullptr) {
+			detachShared();
+		}
+	}
+
+	/**
+	 * Copy the raw data of the volume - the copy is always in the linear layout
 	 * @note It's the callers responsibility to properly release the memory.
 	 */
 	Voxel *copyVoxels() const;
 
+	VolumeLayout layout() const;
+
 	/**
 	 * The border value is returned whenever an attempt is made to read a voxel which
 	 * is outside the extents of the volume.
@@ -203,6 +269,10 @@ public:
 
 	void clear();
 
+	/**
+	 * @note The data is only a plain 3D array for @c VolumeLayout::Linear
+	 * @sa copyVoxels()
+	 */
 	inline const uint8_t *data() const {
 		return (const uint8_t *)_data;
 	}
@@ -223,15 +293,44 @@ public:
 
 private:
 	void initialise(const Region &region);
+	/**
+	 * @brief Updates the brick information for the current region
+	 */
+	void setLayout(VolumeLayout layout);
+	/**
+	 * @return The size of the voxel data in bytes - including the padding of the bricks
+	 */
+	size_t dataSize() const;
+	/**
+	 * @return The index into the voxel data for the given position relative to the lower corner of the region
+	 */
+	int index(int32_t x, int32_t y, int32_t z) const;
+	/**
+	 * @brief Shares the voxel data of the given volume with this volume
+	 */
+	void share(const RawVolume &src);
+	void detachShared();
+	/**
+	 * @brief Releases the reference to the voxel data - the memory is freed if no other volume uses it anymore
+	 */
+	void release();
 
 	/** The size of the volume */
 	Region _region;
 
+	VolumeLayout _layout = VolumeLayout::Linear;
+	/** The brick size is 1 << _brickShift - 0 for the linear layout */
+	int _brickShift = 0;
+	/** The amount of bricks per axis */
+	glm::ivec3 _bricks{0};
+
 	/** The border value */
 	Voxel _borderVoxel;
 
 	/** The voxel data */
-	Voxel *_data;
+	Voxel *_data = nullptr;
+	/** The reference counter of the voxel data - @c nullptr as long as the data was never shared */
+	mutable core::AtomicPtr<core::AtomicInt> _shared;
 };
 
 inline const Region &RawVolume::region() const {
@@ -242,6 +341,10 @@ inline const Voxel &RawVolume::borderValue() const {
 	return _borderVoxel;
 }
 
+inline VolumeLayout RawVolume::layout() const {
+	return _layout;
+}
+
 inline int32_t RawVolume::width() const {
 	return _region.getWidthInVoxels();
 }
@@ -254,6 +357,16 @@ inline int32_t RawVolume::depth() const {
 	return _region.getDepthInVoxels();
 }
 
+inline int RawVolume::index(int32_t x, int32_t y, int32_t z) const {
+	if (_layout == VolumeLayout::Linear) {
+		return x + y * width() + z * _region.stride();
+	}
+	const int mask = (1 << _brickShift) - 1;
+	const int brick = (x >> _brickShift) + ((y >> _brickShift) + (z >> _brickShift) * _bricks.y) * _bricks.x;
+	const uint32_t inner = priv::morton256_x[x & mask] | priv::morton256_y[y & mask] | priv::morton256_z[z & mask];
+	return (brick << (3 * _brickShift)) + (int)inner;
+}
+
 inline const Voxel &RawVolume::voxel(const glm::ivec3 &pos) const {
 	return voxel(pos.x, pos.y, pos.z);
 }
@@ -275,7 +388,7 @@ inline const glm::ivec3 &RawVolume::Sampler::position() const {
 
 inline const Voxel &RawVolume::Sampler::voxel() const {
 	if (this->currentPositionValid()) {
-		return *_currentVoxel;
+		return *currentVoxel();
 	}
 	return this->_volume->voxel(this->_posInVolume.x, this->_posInVolume.y, this->_posInVolume.z);
 }
@@ -290,223 +403,223 @@ inline bool RawVolume::Sampler::setPosition(const glm::ivec3 &v3dNewPos) {
 
 inline const Voxel &RawVolume::Sampler::peekVoxel1nx1ny1nz() const {
 	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_NEG_X(this->_posInVolume.x) && CAN_GO_NEG_Y(this->_posInVolume.y) &&
+	if (_linear && this->currentPositionValid() && CAN_GO_NEG_X(this->_posInVolume.x) && CAN_GO_NEG_Y(this->_posInVolume.y) &&
 		CAN_GO_NEG_Z(this->_posInVolume.z)) {
-		return *(_currentVoxel - 1 - region.getWidthInVoxels() - region.stride());
+		return *(currentVoxel() - 1 - region.getWidthInVoxels() - region.stride());
 	}
 	return this->_volume->voxel(this->_posInVolume.x - 1, this->_posInVolume.y - 1, this->_posInVolume.z - 1);
 }
 
 inline const Voxel &RawVolume::Sampler::peekVoxel1nx1ny0pz() const {
 	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_NEG_X(this->_posInVolume.x) && CAN_GO_NEG_Y(this->_posInVolume.y)) {
-		return *(_currentVoxel - 1 - region.getWidthInVoxels());
+	if (_linear && this->currentPositionValid() && CAN_GO_NEG_X(this->_posInVolume.x) && CAN_GO_NEG_Y(this->_posInVolume.y)) {
+		return *(currentVoxel() - 1 - region.getWidthInVoxels());
 	}
 	return this->_volume->voxel(this->_posInVolume.x - 1, this->_posInVolume.y - 1, this->_posInVolume.z);
 }
 
 inline const Voxel &RawVolume::Sampler::peekVoxel1nx1ny1pz() const {
 	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_NEG_X(this->_posInVolume.x) && CAN_GO_NEG_Y(this->_posInVolume.y) &&
+	if (_linear && this->currentPositionValid() && CAN_GO_NEG_X(this->_posInVolume.x) && CAN_GO_NEG_Y(this->_posInVolume.y) &&
 		CAN_GO_POS_Z(this->_posInVolume.z)) {
-		return *(_currentVoxel - 1 - region.getWidthInVoxels() + region.stride());
+		return *(currentVoxel() - 1 - region.getWidthInVoxels() + region.stride());
 	}
 	return this->_volume->voxel(this->_posInVolume.x - 1, this->_posInVolume.y - 1, this->_posInVolume.z + 1);
 }
 
 inline const Voxel &RawVolume::Sampler::peekVoxel1nx0py1nz() const {
 	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_NEG_X(this->_posInVolume.x) && CAN_GO_NEG_Z(this->_posInVolume.z)) {
-		return *(_currentVoxel - 1 - region.stride());
+	if (_linear && this->currentPositionValid() && CAN_GO_NEG_X(this->_posInVolume.x) && CAN_GO_NEG_Z(this->_posInVolume.z)) {
+		return *(currentVoxel() - 1 - region.stride());
 	}
 	return this->_volume->voxel(this->_posInVolume.x - 1, this->_posInVolume.y, this->_posInVolume.z - 1);
 }
 
 inline const Voxel &RawVolume::Sampler::peekVoxel1nx0py0pz() const {
 	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_NEG_X(this->_posInVolume.x)) {
-		return *(_currentVoxel - 1);
+	if (_linear && this->currentPositionValid() && CAN_GO_NEG_X(this->_posInVolume.x)) {
+		return *(currentVoxel() - 1);
 	}
 	return this->_volume->voxel(this->_posInVolume.x - 1, this->_posInVolume.y, this->_posInVolume.z);
 }
 
 inline const Voxel &RawVolume::Sampler::peekVoxel1nx0py1pz() const {
 	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_NEG_X(this->_posInVolume.x) && CAN_GO_POS_Z(this->_posInVolume.z)) {
-		return *(_currentVoxel - 1 + region.stride());
+	if (_linear && this->currentPositionValid() && CAN_GO_NEG_X(this->_posInVolume.x) && CAN_GO_POS_Z(this->_posInVolume.z)) {
+		return *(currentVoxel() - 1 + region.stride());
 	}
 	return this->_volume->voxel(this->_posInVolume.x - 1, this->_posInVolume.y, this->_posInVolume.z + 1);
 }
 
 inline const Voxel &RawVolume::Sampler::peekVoxel1nx1py1nz() const {
 	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_NEG_X(this->_posInVolume.x) && CAN_GO_POS_Y(this->_posInVolume.y) &&
+	if (_linear && this->currentPositionValid() && CAN_GO_NEG_X(this->_posInVolume.x) && CAN_GO_POS_Y(this->_posInVolume.y) &&
 		CAN_GO_NEG_Z(this->_posInVolume.z)) {
-		return *(_currentVoxel - 1 + region.getWidthInVoxels() - region.stride());
+		return *(currentVoxel() - 1 + region.getWidthInVoxels() - region.stride());
 	}
 	return this->_volume->voxel(this->_posInVolume.x - 1, this->_posInVolume.y + 1, this->_posInVolume.z - 1);
 }
 
 inline const Voxel &RawVolume::Sampler::peekVoxel1nx1py0pz() const {
 	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_NEG_X(this->_posInVolume.x) && CAN_GO_POS_Y(this->_posInVolume.y)) {
-		return *(_currentVoxel - 1 + region.getWidthInVoxels());
+	if (_linear && this->currentPositionValid() && CAN_GO_NEG_X(this->_posInVolume.x) && CAN_GO_POS_Y(this->_posInVolume.y)) {
+		return *(currentVoxel() - 1 + region.getWidthInVoxels());
 	}
 	return this->_volume->voxel(this->_posInVolume.x - 1, this->_posInVolume.y + 1, this->_posInVolume.z);
 }
 
 inline const Voxel &RawVolume::Sampler::peekVoxel1nx1py1pz() const {
 	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_NEG_X(this->_posInVolume.x) && CAN_GO_POS_Y(this->_posInVolume.y) &&
+	if (_linear && this->currentPositionValid() && CAN_GO_NEG_X(this->_posInVolume.x) && CAN_GO_POS_Y(this->_posInVolume.y) &&
 		CAN_GO_POS_Z(this->_posInVolume.z)) {
-		return *(_currentVoxel - 1 + region.getWidthInVoxels() + region.stride());
+		return *(currentVoxel() - 1 + region.getWidthInVoxels() + region.stride());
 	}
 	return this->_volume->voxel(this->_posInVolume.x - 1, this->_posInVolume.y + 1, this->_posInVolume.z + 1);
 }
 
 inline const Voxel &RawVolume::Sampler::peekVoxel0px1ny1nz() const {
 	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_NEG_Y(this->_posInVolume.y) && CAN_GO_NEG_Z(this->_posInVolume.z)) {
-		return *(_currentVoxel - region.getWidthInVoxels() - region.stride());
+	if (_linear && this->currentPositionValid() && CAN_GO_NEG_Y(this->_posInVolume.y) && CAN_GO_NEG_Z(this->_posInVolume.z)) {
+		return *(currentVoxel() - region.getWidthInVoxels() - region.stride());
 	}
 	return this->_volume->voxel(this->_posInVolume.x, this->_posInVolume.y - 1, this->_posInVolume.z - 1);
 }
 
 inline const Voxel &RawVolume::Sampler::peekVoxel0px1ny0pz() const {
 	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_NEG_Y(this->_posInVolume.y)) {
-		return *(_currentVoxel - region.getWidthInVoxels());
+	if (_linear && this->currentPositionValid() && CAN_GO_NEG_Y(this->_posInVolume.y)) {
+		return *(currentVoxel() - region.getWidthInVoxels());
 	}
 	return this->_volume->voxel(this->_posInVolume.x, this->_posInVolume.y - 1, this->_posInVolume.z);
 }
 
 inline const Voxel &RawVolume::Sampler::peekVoxel0px1ny1pz() const {
 	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_NEG_Y(this->_posInVolume.y) && CAN_GO_POS_Z(this->_posInVolume.z)) {
-		return *(_currentVoxel - region.getWidthInVoxels() + region.stride());
+	if (_linear && this->currentPositionValid() && CAN_GO_NEG_Y(this->_posInVolume.y) && CAN_GO_POS_Z(this->_posInVolume.z)) {
+		return *(currentVoxel() - region.getWidthInVoxels() + region.stride());
 	}
 	return this->_volume->voxel(this->_posInVolume.x, this->_posInVolume.y - 1, this->_posInVolume.z + 1);
 }
 
 inline const Voxel &RawVolume::Sampler::peekVoxel0px0py1nz() const {
 	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_NEG_Z(this->_posInVolume.z)) {
-		return *(_currentVoxel - region.stride());
+	if (_linear && this->currentPositionValid() && CAN_GO_NEG_Z(this->_posInVolume.z)) {
+		return *(currentVoxel() - region.stride());
 	}
 	return this->_volume->voxel(this->_posInVolume.x, this->_posInVolume.y, this->_posInVolume.z - 1);
 }
 
 inline const Voxel &RawVolume::Sampler::peekVoxel0px0py0pz() const {
 	if (this->currentPositionValid()) {
-		return *_currentVoxel;
+		return *currentVoxel();
 	}
 	return this->_volume->voxel(this->_posInVolume.x, this->_posInVolume.y, this->_posInVolume.z);
 }
 
 inline const Voxel &RawVolume::Sampler::peekVoxel0px0py1pz() const {
 	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_POS_Z(this->_posInVolume.z)) {
-		return *(_currentVoxel + region.stride());
+	if (_linear && this->currentPositionValid() && CAN_GO_POS_Z(this->_posInVolume.z)) {
+		return *(currentVoxel() + region.stride());
 	}
 	return this->_volume->voxel(this->_posInVolume.x, this->_posInVolume.y, this->_posInVolume.z + 1);
 }
 
 inline const Voxel &RawVolume::Sampler::peekVoxel0px1py1nz() const {
 	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_POS_Y(this->_posInVolume.y) && CAN_GO_NEG_Z(this->_posInVolume.z)) {
-		return *(_currentVoxel + region.getWidthInVoxels() - region.stride());
+	if (_linear && this->currentPositionValid() && CAN_GO_POS_Y(this->_posInVolume.y) && CAN_GO_NEG_Z(this->_posInVolume.z)) {
+		return *(currentVoxel() + region.getWidthInVoxels() - region.stride());
 	}
 	return this->_volume->voxel(this->_posInVolume.x, this->_posInVolume.y + 1, this->_posInVolume.z - 1);
 }
 
 inline const Voxel &RawVolume::Sampler::peekVoxel0px1py0pz() const {
 	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_POS_Y(this->_posInVolume.y)) {
-		return *(_currentVoxel + region.getWidthInVoxels());
+	if (_linear && this->currentPositionValid() && CAN_GO_POS_Y(this->_posInVolume.y)) {
+		return *(currentVoxel() + region.getWidthInVoxels());
 	}
 	return this->_volume->voxel(this->_posInVolume.x, this->_posInVolume.y + 1, this->_posInVolume.z);
 }
 
 inline const Voxel &RawVolume::Sampler::peekVoxel0px1py1pz() const {
 	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_POS_Y(this->_posInVolume.y) && CAN_GO_POS_Z(this->_posInVolume.z)) {
-		return *(_currentVoxel + region.getWidthInVoxels() + region.stride());
+	if (_linear && this->currentPositionValid() && CAN_GO_POS_Y(this->_posInVolume.y) && CAN_GO_POS_Z(this->_posInVolume.z)) {
+		return *(currentVoxel() + region.getWidthInVoxels() + region.stride());
 	}
 	return this->_volume->voxel(this->_posInVolume.x, this->_posInVolume.y + 1, this->_posInVolume.z + 1);
 }
 
 inline const Voxel &RawVolume::Sampler::peekVoxel1px1ny1nz() const {
 	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_POS_X(this->_posInVolume.x) && CAN_GO_NEG_Y(this->_posInVolume.y) &&
+	if (_linear && this->currentPositionValid() && CAN_GO_POS_X(this->_posInVolume.x) && CAN_GO_NEG_Y(this->_posInVolume.y) &&
 		CAN_GO_NEG_Z(this->_posInVolume.z)) {
-		return *(_currentVoxel + 1 - region.getWidthInVoxels() - region.stride());
+		return *(currentVoxel() + 1 - region.getWidthInVoxels() - region.stride());
 	}
 	return this->_volume->voxel(this->_posInVolume.x + 1, this->_posInVolume.y - 1, this->_posInVolume.z - 1);
 }
 
 inline const Voxel &RawVolume::Sampler::peekVoxel1px1ny0pz() const {
 	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_POS_X(this->_posInVolume.x) && CAN_GO_NEG_Y(this->_posInVolume.y)) {
-		return *(_currentVoxel + 1 - region.getWidthInVoxels());
+	if (_linear && this->currentPositionValid() && CAN_GO_POS_X(this->_posInVolume.x) && CAN_GO_NEG_Y(this->_posInVolume.y)) {
+		return *(currentVoxel() + 1 - region.getWidthInVoxels());
 	}
 	return this->_volume->voxel(this->_posInVolume.x + 1, this->_posInVolume.y - 1, this->_posInVolume.z);
 }
 
 inline const Voxel &RawVolume::Sampler::peekVoxel1px1ny1pz() const {
 	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_POS_X(this->_posInVolume.x) && CAN_GO_NEG_Y(this->_posInVolume.y) &&
+	if (_linear && this->currentPositionValid() && CAN_GO_POS_X(this->_posInVolume.x) && CAN_GO_NEG_Y(this->_posInVolume.y) &&
 		CAN_GO_POS_Z(this->_posInVolume.z)) {
-		return *(_currentVoxel + 1 - region.getWidthInVoxels() + region.stride());
+		return *(currentVoxel() + 1 - region.getWidthInVoxels() + region.stride());
 	}
 	return this->_volume->voxel(this->_posInVolume.x + 1, this->_posInVolume.y - 1, this->_posInVolume.z + 1);
 }
 
 inline const Voxel &RawVolume::Sampler::peekVoxel1px0py1nz() const {
 	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_POS_X(this->_posInVolume.x) && CAN_GO_NEG_Z(this->_posInVolume.z)) {
-		return *(_currentVoxel + 1 - region.stride());
+	if (_linear && this->currentPositionValid() && CAN_GO_POS_X(this->_posInVolume.x) && CAN_GO_NEG_Z(this->_posInVolume.z)) {
+		return *(currentVoxel() + 1 - region.stride());
 	}
 	return this->_volume->voxel(this->_posInVolume.x + 1, this->_posInVolume.y, this->_posInVolume.z - 1);
 }
 
 inline const Voxel &RawVolume::Sampler::peekVoxel1px0py0pz() const {
 	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_POS_X(this->_posInVolume.x)) {
-		return *(_currentVoxel + 1);
+	if (_linear && this->currentPositionValid() && CAN_GO_POS_X(this->_posInVolume.x)) {
+		return *(currentVoxel() + 1);
 	}
 	return this->_volume->voxel(this->_posInVolume.x + 1, this->_posInVolume.y, this->_posInVolume.z);
 }
 
 inline const Voxel &RawVolume::Sampler::peekVoxel1px0py1pz() const {
 	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_POS_X(this->_posInVolume.x) && CAN_GO_POS_Z(this->_posInVolume.z)) {
-		return *(_currentVoxel + 1 + region.stride());
+	if (_linear && this->currentPositionValid() && CAN_GO_POS_X(this->_posInVolume.x) && CAN_GO_POS_Z(this->_posInVolume.z)) {
+		return *(currentVoxel() + 1 + region.stride());
 	}
 	return this->_volume->voxel(this->_posInVolume.x + 1, this->_posInVolume.y, this->_posInVolume.z + 1);
 }
 
 inline const Voxel &RawVolume::Sampler::peekVoxel1px1py1nz() const {
 	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_POS_X(this->_posInVolume.x) && CAN_GO_POS_Y(this->_posInVolume.y) &&
+	if (_linear && this->currentPositionValid() && CAN_GO_POS_X(this->_posInVolume.x) && CAN_GO_POS_Y(this->_posInVolume.y) &&
 		CAN_GO_NEG_Z(this->_posInVolume.z)) {
-		return *(_currentVoxel + 1 + region.getWidthInVoxels() - region.stride());
+		return *(currentVoxel() + 1 + region.getWidthInVoxels() - region.stride());
 	}
 	return this->_volume->voxel(this->_posInVolume.x + 1, this->_posInVolume.y + 1, this->_posInVolume.z - 1);
 }
 
 inline const Voxel &RawVolume::Sampler::peekVoxel1px1py0pz() const {
 	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_POS_X(this->_posInVolume.x) && CAN_GO_POS_Y(this->_posInVolume.y)) {
-		return *(_currentVoxel + 1 + region.getWidthInVoxels());
+	if (_linear && this->currentPositionValid() && CAN_GO_POS_X(this->_posInVolume.x) && CAN_GO_POS_Y(this->_posInVolume.y)) {
+		return *(currentVoxel() + 1 + region.getWidthInVoxels());
 	}
 	return this->_volume->voxel(this->_posInVolume.x + 1, this->_posInVolume.y + 1, this->_posInVolume.z);
 }
 
 inline const Voxel &RawVolume::Sampler::peekVoxel1px1py1pz() const {
 	const Region &region = this->region();
-	if (this->currentPositionValid() && CAN_GO_POS_X(this->_posInVolume.x) && CAN_GO_POS_Y(this->_posInVolume.y) &&
+	if (_linear && this->currentPositionValid() && CAN_GO_POS_X(this->_posInVolume.x) && CAN_GO_POS_Y(this->_posInVolume.y) &&
 		CAN_GO_POS_Z(this->_posInVolume.z)) {
-		return *(_currentVoxel + 1 + region.getWidthInVoxels() + region.stride());
+		return *(currentVoxel() + 1 + region.getWidthInVoxels() + region.stride());
 	}
 	return this->_volume->voxel(this->_posInVolume.x + 1, this->_posInVolume.y + 1, this->_posInVolume.z + 1);
 }
@@ -3,6 +3,10 @@
  */
 
 #include "SurfaceExtractor.h"
+#include "app/Async.h"
+#include "core/Trace.h"
+#include "core/collection/DynamicArray.h"
+#include "voxel/ChunkMesh.h"
 #include "voxel/MaterialColor.h"
 #include "voxel/Region.h"
 #include "voxel/RawVolume.h"
@@ -35,10 +39,115 @@ void extractSurface(SurfaceExtractionContext &ctx) {
 			extractRegion.shiftUpperCorner(1, 1, 1);
 		}
 		voxel::extractCubicMesh(ctx.volume, extractRegion, &ctx.mesh, ctx.translate, ctx.mergeQuads, ctx.reuseVertices,
-								ctx.ambientOcclusion, ctx.optimize);
+								ctx.ambientOcclusion, ctx.optimize, ctx.faceVisibility);
 	}
 }
 
+/**
+ * @brief The cubic extractor generates the faces between a voxel and its left, lower and front neighbours. A tile
+ * without faces is thus one where neither the voxels of the tile nor these neighbours are solid.
+ */
+static bool isAirTile(const RawVolume *volume, const Region &tile) {
+	Region region(tile.getLowerCorner() - 1, tile.getUpperCorner());
+	if (!region.cropTo(volume->region())) {
+		return true;
+	}
+	const glm::ivec3 &mins = region.getLowerCorner();
+	const glm::ivec3 &maxs = region.getUpperCorner();
+	RawVolume::Sampler sampler(volume);
+	for (int z = mins.z; z <= maxs.z; ++z) {
+		for (int y = mins.y; y <= maxs.y; ++y) {
+			sampler.setPosition(mins.x, y, z);
+			for (int x = mins.x; x <= maxs.x; ++x) {
+				if (!isAir(sampler.voxel().getMaterial())) {
+					return false;
+				}
+				sampler.movePositiveX();
+			}
+		}
+	}
+	return true;
+}
+
+static void appendMesh(Mesh &target, const Mesh &source) {
+	const IndexType base = (IndexType)target.getNoOfVertices();
+	target.getVertexVector().append(source.getVertexVector());
+	target.getNormalVector().append(source.getNormalVector());
+	const IndexArray &indices = source.getIndexVector();
+	target.getIndexVector().append(indices.size(), [&](size_t i) { return indices[i] + base; });
+}
+
+void extractSurfaceParallel(SurfaceExtractionContext &ctx, int tileSize) {
+	if (ctx.type != SurfaceExtractionType::Cubic || tileSize <= 0) {
+		extractSurface(ctx);
+		return;
+	}
+	core_trace_scoped(ExtractSurfaceParallel);
+	voxel::Region extractRegion = ctx.region;
+	if (ctx.volume->region() == extractRegion) {
+		extractRegion.shiftUpperCorner(1, 1, 1);
+	}
+	const glm::ivec3 &lower = extractRegion.getLowerCorner();
+	const glm::ivec3 tiles = (extractRegion.getDimensionsInVoxels() + (tileSize - 1)) / tileSize;
+	if (tiles.x * tiles.y * tiles.z <= 1) {
+		voxel::extractCubicMesh(ctx.volume, extractRegion, &ctx.mesh, ctx.translate, ctx.mergeQuads, ctx.reuseVertices,
+								ctx.ambientOcclusion, ctx.optimize, ctx.faceVisibility);
+		return;
+	}
+
+	const int tileCount = tiles.x * tiles.y * tiles.z;
+	core::DynamicArray<ChunkMesh *> tileMeshes;
+	tileMeshes.resize(tileCount);
+	app::for_parallel(0, tileCount, [&](int start, int end) {
+		for (int i = start; i < end; ++i) {
+			tileMeshes[i] = nullptr;
+			const glm::ivec3 tile(i % tiles.x, (i / tiles.x) % tiles.y, i / (tiles.x * tiles.y));
+			const glm::ivec3 mins = lower + tile * tileSize;
+			const glm::ivec3 maxs = glm::min(mins + (tileSize - 1), extractRegion.getUpperCorner());
+			const Region tileRegion(mins, maxs);
+			if (isAirTile(ctx.volume, tileRegion)) {
+				continue;
+			}
+			ChunkMesh *mesh = new ChunkMesh();
+			// keep the vertices relative to the lower corner of the whole region
+			const glm::ivec3 translate = ctx.translate + (mins - lower);
+			voxel::extractCubicMesh(ctx.volume, tileRegion, mesh, translate, ctx.mergeQuads, ctx.reuseVertices,
+									ctx.ambientOcclusion, false, ctx.faceVisibility);
+			tileMeshes[i] = mesh;
+		}
+	});
+
+	core_trace_scoped(MergeTiles);
+	ctx.mesh.clear();
+	for (int m = 0; m < ChunkMesh::Meshes; ++m) {
+		size_t vertices = 0;
+		size_t indices = 0;
+		for (const ChunkMesh *mesh : tileMeshes) {
+			if (mesh != nullptr) {
+				vertices += mesh->mesh[m].getNoOfVertices();
+				indices += mesh->mesh[m].getNoOfIndices();
+			}
+		}
+		ctx.mesh.mesh[m].getVertexVector().reserve(vertices);
+		ctx.mesh.mesh[m].getIndexVector().reserve(indices);
+	}
+	for (ChunkMesh *mesh : tileMeshes) {
+		if (mesh == nullptr) {
+			continue;
+		}
+		for (int m = 0; m < ChunkMesh::Meshes; ++m) {
+			appendMesh(ctx.mesh.mesh[m], mesh->mesh[m]);
+		}
+		delete mesh;
+	}
+	ctx.mesh.setOffset(lower);
+	if (ctx.optimize) {
+		ctx.mesh.optimize();
+	}
+	ctx.mesh.removeUnusedVertices();
+	ctx.mesh.compressIndices();
+}
+
 voxel::SurfaceExtractionContext createContext(voxel::SurfaceExtractionType type, const voxel::RawVolume *volume,
 											  const voxel::Region &region, const palette::Palette &palette,
 											  voxel::ChunkMesh &mesh, const glm::ivec3 &translate, bool mergeQuads,
@@ -13,6 +13,7 @@ class Palette;
 namespace voxel {
 class RawVolume;
 class Region;
+class FaceVisibility;
 struct ChunkMesh;
 
 enum class SurfaceExtractionType { Cubic, MarchingCubes, Max };
@@ -34,6 +35,11 @@ struct SurfaceExtractionContext {
 	const bool reuseVertices;	 // used only for Cubic
 	const bool ambientOcclusion; // used only for Cubic
 	const bool optimize;
+	/**
+	 * optional cached face masks for the region - used only for Cubic
+	 * @sa FaceVisibility
+	 */
+	const FaceVisibility *faceVisibility = nullptr;
 };
 
 SurfaceExtractionContext buildCubicContext(const RawVolume *volume, const Region &region, ChunkMesh &mesh,
@@ -44,6 +50,17 @@ SurfaceExtractionContext buildMarchingCubesContext(const RawVolume *volume, cons
 
 void extractSurface(SurfaceExtractionContext &ctx);
 
+/**
+ * @brief Extracts the surface of the whole region of the given context by splitting it into tiles of @c tileSize
+ * voxels per axis. Tiles without any solid voxel are skipped, the others are extracted on the thread pool and merged
+ * into the mesh of the context afterwards.
+ *
+ * The vertex positions are the same as for @c extractSurface() - just quads are not merged across tile borders.
+ * This is meant for whole-model extractions like exports - interactive meshing is done by @c MeshState.
+ * @note Only the cubic extractor is split into tiles - marching cubes is extracted in one piece.
+ */
+void extractSurfaceParallel(SurfaceExtractionContext &ctx, int tileSize = 64);
+
 voxel::SurfaceExtractionContext createContext(voxel::SurfaceExtractionType type, const voxel::RawVolume *volume,
 											  const voxel::Region &region, const palette::Palette &palette,
 											  voxel::ChunkMesh &mesh, const glm::ivec3 &translate,
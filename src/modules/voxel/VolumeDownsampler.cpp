@@ -0,0 +1,68 @@
+/**
+ * @file
+ */
+
+#include "VolumeDownsampler.h"
+#include "core/Assert.h"
+#include "core/Trace.h"
+#include "palette/Palette.h"
+#include "voxel/RawVolume.h"
+
+namespace voxel {
+
+void downsample(const RawVolume &source, int factor, RawVolume &target) {
+	core_trace_scoped(VolumeDownsample);
+	core_assert(factor >= 1);
+	const Region &targetRegion = target.region();
+	const Region &sourceRegion = source.region();
+	const int cellVoxels = factor * factor * factor;
+
+	// the voxel counts per color of the current cell - only the touched colors are reset
+	uint16_t counts[palette::PaletteMaxColors]{};
+	Voxel voxels[palette::PaletteMaxColors];
+	uint8_t touched[palette::PaletteMaxColors];
+
+	for (int32_t z = targetRegion.getLowerZ(); z <= targetRegion.getUpperZ(); ++z) {
+		for (int32_t y = targetRegion.getLowerY(); y <= targetRegion.getUpperY(); ++y) {
+			for (int32_t x = targetRegion.getLowerX(); x <= targetRegion.getUpperX(); ++x) {
+				const glm::ivec3 mins(x * factor, y * factor, z * factor);
+				const glm::ivec3 maxs = mins + factor - 1;
+				if (!voxel::intersects(sourceRegion, Region(mins, maxs))) {
+					continue;
+				}
+				int solid = 0;
+				int touchedColors = 0;
+				for (int32_t sz = mins.z; sz <= maxs.z; ++sz) {
+					for (int32_t sy = mins.y; sy <= maxs.y; ++sy) {
+						for (int32_t sx = mins.x; sx <= maxs.x; ++sx) {
+							const Voxel &voxel = source.voxel(sx, sy, sz);
+							if (isAir(voxel.getMaterial())) {
+								continue;
+							}
+							++solid;
+							const uint8_t color = voxel.getColor();
+							if (counts[color]++ == 0) {
+								voxels[color] = voxel;
+								touched[touchedColors++] = color;
+							}
+						}
+					}
+				}
+				if (solid * 2 >= cellVoxels) {
+					uint8_t best = touched[0];
+					for (int i = 1; i < touchedColors; ++i) {
+						if (counts[touched[i]] > counts[best]) {
+							best = touched[i];
+						}
+					}
+					target.setVoxel(x, y, z, voxels[best]);
+				}
+				for (int i = 0; i < touchedColors; ++i) {
+					counts[touched[i]] = 0;
+				}
+			}
+		}
+	}
+}
+
+} // namespace voxel
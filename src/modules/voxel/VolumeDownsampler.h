@@ -0,0 +1,25 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+namespace voxel {
+
+class RawVolume;
+
+/**
+ * @brief Builds a lower resolution version of a volume - used for the detail levels of the chunk meshes
+ *
+ * Every voxel of the target volume represents a cube of @c factor^3 voxels of the source volume. The voxel at
+ * @c (x,y,z) of the target volume covers the source voxels @c (x*factor,y*factor,z*factor) up to
+ * @c ((x+1)*factor-1,...). It gets solid if at least half of these voxels are solid and takes the most frequent
+ * color of the solid voxels. Source voxels outside of the source region count as air.
+ *
+ * @param[in] source The full resolution volume
+ * @param[in] factor The amount of source voxels per target voxel on each axis
+ * @param[out] target The volume to fill - its region is given in downsampled coordinates
+ */
+void downsample(const RawVolume &source, int factor, RawVolume &target);
+
+} // namespace voxel
@@ -5,7 +5,9 @@
 #pragma once
 
 #include "Voxel.h"
+#include <glm/common.hpp>
 #include <glm/vec3.hpp>
+#include <stdint.h>
 
 namespace voxel {
 
@@ -28,7 +30,71 @@ struct VoxelVertex {
 };
 static_assert(sizeof(VoxelVertex) == 16, "Unexpected size of the vertex struct");
 
-// TODO: maybe reduce to uint16_t and use glDrawElementsBaseVertex
 typedef uint32_t IndexType;
 
+/**
+ * @brief Compact variant of @c VoxelVertex for the cubic meshes - the positions of the cubic extractor are always
+ * integral and are stored as shorts.
+ *
+ * @sa PackedMesh
+ */
+struct PackedVoxelVertex {
+	int16_t x;
+	int16_t y;
+	int16_t z;
+	union {
+		struct {
+			uint8_t ambientOcclusion:2;
+			uint8_t flags:3;
+			uint8_t padding:3;
+		};
+		uint8_t info;
+	};
+	uint8_t colorIndex;
+
+	inline glm::vec3 position() const {
+		return glm::vec3(x, y, z);
+	}
+};
+static_assert(sizeof(PackedVoxelVertex) == 8, "Unexpected size of the packed vertex struct");
+
+/**
+ * @brief The indices of a @c PackedMesh - a single packed mesh can't address more than 65536 vertices
+ */
+typedef uint16_t PackedIndexType;
+
+/**
+ * @return @c true if the position of the given vertex can be stored in a @c PackedVoxelVertex without losing
+ * precision
+ */
+inline bool isPackable(const VoxelVertex &vertex) {
+	const glm::vec3 &pos = vertex.position;
+	if (glm::floor(pos) != pos) {
+		return false;
+	}
+	return pos.x >= INT16_MIN && pos.x <= INT16_MAX && pos.y >= INT16_MIN && pos.y <= INT16_MAX &&
+		   pos.z >= INT16_MIN && pos.z <= INT16_MAX;
+}
+
+/**
+ * @note Only valid if @c isPackable() returned @c true for the given vertex
+ */
+inline PackedVoxelVertex packVertex(const VoxelVertex &vertex) {
+	PackedVoxelVertex packed;
+	packed.x = (int16_t)vertex.position.x;
+	packed.y = (int16_t)vertex.position.y;
+	packed.z = (int16_t)vertex.position.z;
+	packed.info = vertex.info;
+	packed.colorIndex = vertex.colorIndex;
+	return packed;
+}
+
+inline VoxelVertex unpackVertex(const PackedVoxelVertex &packed) {
+	VoxelVertex vertex;
+	vertex.position = packed.position();
+	vertex.info = packed.info;
+	vertex.colorIndex = packed.colorIndex;
+	return vertex;
+}
+
 }
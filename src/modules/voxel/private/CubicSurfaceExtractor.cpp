@@ -5,6 +5,7 @@
 #include "CubicSurfaceExtractor.h"
 #include "core/Common.h"
 #include "voxel/ChunkMesh.h"
+#include "voxel/FaceVisibility.h"
 #include "voxel/RawVolume.h"
 #include "voxel/Voxel.h"
 #include "voxel/VoxelVertex.h"
@@ -104,24 +105,25 @@ typedef std::vector<QuadList> QuadListVector;
  * space) while the voxel behind the potential quad would have a value
  * greater than zero (typically indicating it is solid).
  */
-CORE_FORCE_INLINE bool isQuadNeeded(VoxelType back, VoxelType front, FaceNames face) {
-	if (isAir(back) || isTransparent(back)) {
-		return false;
-	}
-	if (!isAir(front) && !isTransparent(front)) {
-		return false;
-	}
-	return true;
+/**
+ * @brief The quads of a cell - the negative faces of the current voxel and the positive faces of the left, lower and
+ * front neighbours. A quad is transparent if the voxel that it belongs to is transparent.
+ * @return The bitmask of quads - the bit index is the @c FaceNames value
+ * @sa FaceVisibility::cellFaces()
+ */
+CORE_FORCE_INLINE uint8_t cellFaces(VoxelType current, VoxelType left, VoxelType below, VoxelType before) {
+	uint8_t mask = 0u;
+	mask |= (uint8_t)(isFaceVisible(current, left) << core::enumVal(FaceNames::NegativeX));
+	mask |= (uint8_t)(isFaceVisible(current, below) << core::enumVal(FaceNames::NegativeY));
+	mask |= (uint8_t)(isFaceVisible(current, before) << core::enumVal(FaceNames::NegativeZ));
+	mask |= (uint8_t)(isFaceVisible(left, current) << core::enumVal(FaceNames::PositiveX));
+	mask |= (uint8_t)(isFaceVisible(below, current) << core::enumVal(FaceNames::PositiveY));
+	mask |= (uint8_t)(isFaceVisible(before, current) << core::enumVal(FaceNames::PositiveZ));
+	return mask;
 }
 
-CORE_FORCE_INLINE bool isTransparentQuadNeeded(VoxelType back, VoxelType front, FaceNames face) {
-	if (isAir(back) || !isTransparent(back)) {
-		return false;
-	}
-	if (!isAir(front) && isTransparent(front)) {
-		return false;
-	}
-	return true;
+CORE_FORCE_INLINE bool hasFace(uint8_t faces, FaceNames face) {
+	return (faces >> core::enumVal(face)) & 1u;
 }
 
 static CORE_FORCE_INLINE bool isSameVertex(const VoxelVertex& v1, const VoxelVertex& v2) {
@@ -388,7 +390,7 @@ static IndexType addVertex(bool reuseVertices, uint32_t x, uint32_t y, uint32_t
 	return 0; //Should never happen.
 }
 
-void extractCubicMesh(const voxel::RawVolume* volData, const Region& region, ChunkMesh* result, const glm::ivec3& translate, bool mergeQuads, bool reuseVertices, bool ambientOcclusion, bool optimize) {
+void extractCubicMesh(const voxel::RawVolume* volData, const Region& region, ChunkMesh* result, const glm::ivec3& translate, bool mergeQuads, bool reuseVertices, bool ambientOcclusion, bool optimize, const FaceVisibility* faceVisibility) {
 	core_trace_scoped(ExtractCubicMesh);
 
 	result->clear();
@@ -441,6 +443,23 @@ void extractCubicMesh(const voxel::RawVolume* volData, const Region& region, Chu
 			voxel::RawVolume::Sampler volumeSampler3 = volumeSampler2;
 			for (int32_t y = offset.y; y <= upper.y; ++y) {
 				const uint32_t regY = y - offset.y;
+				const Voxel& voxelCurrent          = volumeSampler3.voxel();
+				const Voxel& voxelLeft             = volumeSampler3.peekVoxel1nx0py0pz();
+				const Voxel& voxelBefore           = volumeSampler3.peekVoxel0px0py1nz();
+				const Voxel& voxelBelow            = volumeSampler3.peekVoxel0px1ny0pz();
+
+				// the quads are taken from the cached masks - the neighbours are only sampled for the ambient occlusion
+				uint8_t faces;
+				if (faceVisibility != nullptr && faceVisibility->containsCell(x, y, z)) {
+					faces = faceVisibility->cellFaces(x, y, z);
+				} else {
+					faces = cellFaces(voxelCurrent.getMaterial(), voxelLeft.getMaterial(), voxelBelow.getMaterial(),
+							voxelBefore.getMaterial());
+				}
+				if (faces == 0u) {
+					volumeSampler3.movePositiveY();
+					continue;
+				}
 
 				/**
 				 *
@@ -460,9 +479,6 @@ void extractCubicMesh(const voxel::RawVolume* volData, const Region& region, Chu
 				 *               [C]
 				 */
 
-				const Voxel& voxelCurrent          = volumeSampler3.voxel();
-				const Voxel& voxelLeft             = volumeSampler3.peekVoxel1nx0py0pz();
-				const Voxel& voxelBefore           = volumeSampler3.peekVoxel0px0py1nz();
 				const Voxel& voxelLeftBefore       = volumeSampler3.peekVoxel1nx0py1nz();
 				const Voxel& voxelRightBefore      = volumeSampler3.peekVoxel1px0py1nz();
 				const Voxel& voxelLeftBehind       = volumeSampler3.peekVoxel1nx0py1pz();
@@ -473,7 +489,6 @@ void extractCubicMesh(const voxel::RawVolume* volData, const Region& region, Chu
 				const Voxel& voxelAboveRightBefore = volumeSampler3.peekVoxel1px1py1nz();
 				const Voxel& voxelAboveLeftBehind  = volumeSampler3.peekVoxel1nx1py1pz();
 
-				const Voxel& voxelBelow            = volumeSampler3.peekVoxel0px1ny0pz();
 				const Voxel& voxelBelowLeft        = volumeSampler3.peekVoxel1nx1ny0pz();
 				const Voxel& voxelBelowBefore      = volumeSampler3.peekVoxel0px1ny1nz();
 				const Voxel& voxelBelowLeftBefore  = volumeSampler3.peekVoxel1nx1ny1nz();
@@ -494,7 +509,7 @@ void extractCubicMesh(const voxel::RawVolume* volData, const Region& region, Chu
 				const VoxelType voxelAboveLeftBeforeMaterial  = voxelAboveLeftBefore.getMaterial();
 
 				// X [A] LEFT
-				if (isQuadNeeded(voxelCurrentMaterial, voxelLeftMaterial, FaceNames::NegativeX)) {
+				if (hasFace(faces, FaceNames::NegativeX) && !isTransparent(voxelCurrentMaterial)) {
 					const IndexType v_0_1 = addVertex(reuseVertices, regX, regY,     regZ,     voxelCurrent, previousSliceVertices, &result->mesh[0],
 							voxelLeftBeforeMaterial, voxelBelowLeftMaterial, voxelBelowLeftBeforeMaterial, translate);
 					const IndexType v_1_4 = addVertex(reuseVertices, regX, regY,     regZ + 1, voxelCurrent, currentSliceVertices,  &result->mesh[0],
@@ -504,7 +519,7 @@ void extractCubicMesh(const voxel::RawVolume* volData, const Region& region, Chu
 					const IndexType v_3_5 = addVertex(reuseVertices, regX, regY + 1, regZ,     voxelCurrent, previousSliceVertices, &result->mesh[0],
 							voxelAboveLeftMaterial, voxelLeftBeforeMaterial, voxelAboveLeftBeforeMaterial, translate);
 					vecQuads[core::enumVal(FaceNames::NegativeX)][regX].emplace_back(v_0_1, v_1_4, v_2_8, v_3_5);
-				} else if (isTransparentQuadNeeded(voxelCurrentMaterial, voxelLeftMaterial, FaceNames::NegativeX)) {
+				} else if (hasFace(faces, FaceNames::NegativeX)) {
 					const IndexType v_0_1 = addVertex(reuseVertices, regX, regY,     regZ,     voxelCurrent, previousSliceVerticesT, &result->mesh[1],
 							voxelLeftBeforeMaterial, voxelBelowLeftMaterial, voxelBelowLeftBeforeMaterial, translate);
 					const IndexType v_1_4 = addVertex(reuseVertices, regX, regY,     regZ + 1, voxelCurrent, currentSliceVerticesT,  &result->mesh[1],
@@ -517,7 +532,7 @@ void extractCubicMesh(const voxel::RawVolume* volData, const Region& region, Chu
 				}
 
 				// X [B] RIGHT
-				if (isQuadNeeded(voxelLeftMaterial, voxelCurrentMaterial, FaceNames::PositiveX)) {
+				if (hasFace(faces, FaceNames::PositiveX) && !isTransparent(voxelLeftMaterial)) {
 					const VoxelType _voxelRightBehind      = volumeSampler3.peekVoxel0px0py1pz().getMaterial();
 					const VoxelType _voxelAboveRight       = volumeSampler3.peekVoxel0px1py0pz().getMaterial();
 					const VoxelType _voxelAboveRightBehind = volumeSampler3.peekVoxel0px1py1pz().getMaterial();
@@ -535,7 +550,7 @@ void extractCubicMesh(const voxel::RawVolume* volData, const Region& region, Chu
 					const IndexType v_3_6 = addVertex(reuseVertices, regX, regY + 1, regZ,     voxelLeft, previousSliceVertices, &result->mesh[0],
 							_voxelAboveRight, voxelBeforeMaterial, _voxelAboveRightBefore, translate);
 					vecQuads[core::enumVal(FaceNames::PositiveX)][regX].emplace_back(v_0_2, v_3_6, v_2_7, v_1_3);
-				} else if (isTransparentQuadNeeded(voxelLeftMaterial, voxelCurrentMaterial, FaceNames::PositiveX)) {
+				} else if (hasFace(faces, FaceNames::PositiveX)) {
 					const VoxelType _voxelRightBehind      = volumeSampler3.peekVoxel0px0py1pz().getMaterial();
 					const VoxelType _voxelAboveRight       = volumeSampler3.peekVoxel0px1py0pz().getMaterial();
 					const VoxelType _voxelAboveRightBehind = volumeSampler3.peekVoxel0px1py1pz().getMaterial();
@@ -556,7 +571,7 @@ void extractCubicMesh(const voxel::RawVolume* volData, const Region& region, Chu
 				}
 
 				// Y [C] BELOW
-				if (isQuadNeeded(voxelCurrentMaterial, voxelBelowMaterial, FaceNames::NegativeY)) {
+				if (hasFace(faces, FaceNames::NegativeY) && !isTransparent(voxelCurrentMaterial)) {
 					const Voxel& voxelBelowRightBehind = volumeSampler3.peekVoxel1px1ny1pz();
 					const Voxel& voxelBelowRight       = volumeSampler3.peekVoxel1px1ny0pz();
 					const Voxel& voxelBelowBehind      = volumeSampler3.peekVoxel0px1ny1pz();
@@ -576,7 +591,7 @@ void extractCubicMesh(const voxel::RawVolume* volData, const Region& region, Chu
 					const IndexType v_3_4 = addVertex(reuseVertices, regX,     regY, regZ + 1, voxelCurrent, currentSliceVertices,  &result->mesh[0],
 							voxelBelowLeftMaterial, voxelBelowBehindMaterial, voxelBelowLeftBehindMaterial, translate);
 					vecQuads[core::enumVal(FaceNames::NegativeY)][regY].emplace_back(v_0_1, v_1_2, v_2_3, v_3_4);
-				} else if (isTransparentQuadNeeded(voxelCurrentMaterial, voxelBelowMaterial, FaceNames::NegativeY)) {
+				} else if (hasFace(faces, FaceNames::NegativeY)) {
 					const Voxel& voxelBelowRightBehind = volumeSampler3.peekVoxel1px1ny1pz();
 					const Voxel& voxelBelowRight       = volumeSampler3.peekVoxel1px1ny0pz();
 					const Voxel& voxelBelowBehind      = volumeSampler3.peekVoxel0px1ny1pz();
@@ -600,7 +615,7 @@ void extractCubicMesh(const voxel::RawVolume* volData, const Region& region, Chu
 
 
 				// Y [D] ABOVE
-				if (isQuadNeeded(voxelBelowMaterial, voxelCurrentMaterial, FaceNames::PositiveY)) {
+				if (hasFace(faces, FaceNames::PositiveY) && !isTransparent(voxelBelowMaterial)) {
 					const VoxelType _voxelAboveRight       = volumeSampler3.peekVoxel1px0py0pz().getMaterial();
 					const VoxelType _voxelAboveBehind      = volumeSampler3.peekVoxel0px0py1pz().getMaterial();
 					const VoxelType _voxelAboveRightBehind = volumeSampler3.peekVoxel1px0py1pz().getMaterial();
@@ -617,7 +632,7 @@ void extractCubicMesh(const voxel::RawVolume* volData, const Region& region, Chu
 					const IndexType v_3_8 = addVertex(reuseVertices, regX,     regY, regZ + 1, voxelBelow, currentSliceVertices,  &result->mesh[0],
 							voxelLeftMaterial, _voxelAboveBehind, _voxelAboveLeftBehind, translate);
 					vecQuads[core::enumVal(FaceNames::PositiveY)][regY].emplace_back(v_0_5, v_3_8, v_2_7, v_1_6);
-				} else if (isTransparentQuadNeeded(voxelBelowMaterial, voxelCurrentMaterial, FaceNames::PositiveY)) {
+				} else if (hasFace(faces, FaceNames::PositiveY)) {
 					const VoxelType _voxelAboveRight       = volumeSampler3.peekVoxel1px0py0pz().getMaterial();
 					const VoxelType _voxelAboveBehind      = volumeSampler3.peekVoxel0px0py1pz().getMaterial();
 					const VoxelType _voxelAboveRightBehind = volumeSampler3.peekVoxel1px0py1pz().getMaterial();
@@ -637,7 +652,7 @@ void extractCubicMesh(const voxel::RawVolume* volData, const Region& region, Chu
 				}
 
 				// Z [E] BEFORE
-				if (isQuadNeeded(voxelCurrentMaterial, voxelBeforeMaterial, FaceNames::NegativeZ)) {
+				if (hasFace(faces, FaceNames::NegativeZ) && !isTransparent(voxelCurrentMaterial)) {
 					const VoxelType voxelBelowBeforeMaterial = voxelBelowBefore.getMaterial();
 					const VoxelType voxelAboveBeforeMaterial = voxelAboveBefore.getMaterial();
 					const VoxelType voxelRightBeforeMaterial = voxelRightBefore.getMaterial();
@@ -653,7 +668,7 @@ void extractCubicMesh(const voxel::RawVolume* volData, const Region& region, Chu
 					const IndexType v_3_2 = addVertex(reuseVertices, regX + 1, regY,     regZ, voxelCurrent, previousSliceVertices, &result->mesh[0],
 							voxelBelowBeforeMaterial, voxelRightBeforeMaterial, voxelBelowRightBeforeMaterial, translate); //2
 					vecQuads[core::enumVal(FaceNames::NegativeZ)][regZ].emplace_back(v_0_1, v_1_5, v_2_6, v_3_2);
-				} else if (isTransparentQuadNeeded(voxelCurrentMaterial, voxelBeforeMaterial, FaceNames::NegativeZ)) {
+				} else if (hasFace(faces, FaceNames::NegativeZ)) {
 					const VoxelType voxelBelowBeforeMaterial = voxelBelowBefore.getMaterial();
 					const VoxelType voxelAboveBeforeMaterial = voxelAboveBefore.getMaterial();
 					const VoxelType voxelRightBeforeMaterial = voxelRightBefore.getMaterial();
@@ -672,7 +687,7 @@ void extractCubicMesh(const voxel::RawVolume* volData, const Region& region, Chu
 				}
 
 				// Z [F] BEHIND
-				if (isQuadNeeded(voxelBeforeMaterial, voxelCurrentMaterial, FaceNames::PositiveZ)) {
+				if (hasFace(faces, FaceNames::PositiveZ) && !isTransparent(voxelBeforeMaterial)) {
 					const VoxelType _voxelRightBehind      = volumeSampler3.peekVoxel1px0py1pz().getMaterial();
 					const VoxelType _voxelAboveBehind      = volumeSampler3.peekVoxel0px1py0pz().getMaterial();
 					const VoxelType _voxelAboveRightBehind = volumeSampler3.peekVoxel1px1py0pz().getMaterial();
@@ -687,7 +702,7 @@ void extractCubicMesh(const voxel::RawVolume* volData, const Region& region, Chu
 					const IndexType v_3_3 = addVertex(reuseVertices, regX + 1, regY,     regZ, voxelBefore, previousSliceVertices, &result->mesh[0],
 							voxelBelowMaterial, _voxelRightBehind, _voxelBelowRightBehind, translate); //3
 					vecQuads[core::enumVal(FaceNames::PositiveZ)][regZ].emplace_back(v_0_4, v_3_3, v_2_7, v_1_8);
-				} else if (isTransparentQuadNeeded(voxelBeforeMaterial, voxelCurrentMaterial, FaceNames::PositiveZ)) {
+				} else if (hasFace(faces, FaceNames::PositiveZ)) {
 					const VoxelType _voxelRightBehind      = volumeSampler3.peekVoxel1px0py1pz().getMaterial();
 					const VoxelType _voxelAboveBehind      = volumeSampler3.peekVoxel0px1py0pz().getMaterial();
 					const VoxelType _voxelAboveRightBehind = volumeSampler3.peekVoxel1px1py0pz().getMaterial();
@@ -14,6 +14,7 @@ namespace voxel {
 
 class RawVolume;
 class Region;
+class FaceVisibility;
 struct ChunkMesh;
 
 /**
@@ -101,8 +102,11 @@ struct ChunkMesh;
  * @li It leaves the user in control of memory allocation and would allow them to implement e.g. a mesh pooling system.
  * @li The user-provided mesh could have a different index type (e.g. 16-bit indices) to reduce memory usage.
  * @li The user could provide a custom mesh class, e.g a thin wrapper around an openGL VBO to allow direct writing into this structure.
+ *
+ * @param faceVisibility Optional cached face masks of the region - the quads of a cell are taken from the masks and
+ * the cells without visible faces are skipped without sampling their neighbours.
  */
-void extractCubicMesh(const voxel::RawVolume* volData, const Region& region, ChunkMesh* result, const glm::ivec3& translate, bool mergeQuads = true, bool reuseVertices = true, bool ambientOcclusion = true, bool optimize = false);
+void extractCubicMesh(const voxel::RawVolume* volData, const Region& region, ChunkMesh* result, const glm::ivec3& translate, bool mergeQuads = true, bool reuseVertices = true, bool ambientOcclusion = true, bool optimize = false, const FaceVisibility* faceVisibility = nullptr);
 
 }
 
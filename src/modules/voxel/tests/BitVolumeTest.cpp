@@ -0,0 +1,182 @@
+/**
+ * @file
+ */
+
+#include "voxel/BitVolume.h"
+#include "app/tests/AbstractTest.h"
+#include "core/collection/DynamicArray.h"
+
+namespace voxel {
+
+class BitVolumeTest : public app::AbstractTest {
+protected:
+	static int count(const BitVolume &volume) {
+		int n = 0;
+		volume.visit([&](int, int, int) { ++n; });
+		return n;
+	}
+
+	/**
+	 * @brief Compares the bit volume against the given membership function for every voxel of the given region
+	 */
+	template<class FUNC>
+	static void expectEquals(const BitVolume &volume, const Region &region, FUNC &&func) {
+		for (int z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+			for (int y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+				for (int x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+					ASSERT_EQ(func(x, y, z), volume.contains(x, y, z)) << x << ":" << y << ":" << z;
+				}
+			}
+		}
+	}
+};
+
+TEST_F(BitVolumeTest, testSet) {
+	BitVolume volume;
+	EXPECT_TRUE(volume.empty());
+	volume.set(-1, -9, 17, true);
+	EXPECT_TRUE(volume.contains(-1, -9, 17));
+	EXPECT_FALSE(volume.contains(0, -9, 17));
+	EXPECT_EQ(1u, volume.bricks());
+	EXPECT_EQ(Region(glm::ivec3(-1, -9, 17), glm::ivec3(-1, -9, 17)), volume.calculateRegion());
+	volume.set(-1, -9, 17, false);
+	EXPECT_TRUE(volume.empty()) << "Empty bricks should get removed";
+	EXPECT_FALSE(volume.calculateRegion().isValid());
+}
+
+TEST_F(BitVolumeTest, testAddRegion) {
+	const Region a(glm::ivec3(-5, 2, 3), glm::ivec3(12, 9, 20));
+	BitVolume volume;
+	volume.add(a);
+	EXPECT_EQ(a, volume.calculateRegion());
+	EXPECT_EQ(a.voxels(), count(volume));
+	expectEquals(volume, Region(glm::ivec3(-10), glm::ivec3(25)),
+				 [&](int x, int y, int z) { return a.containsPoint(x, y, z); });
+}
+
+TEST_F(BitVolumeTest, testRegionOperations) {
+	const Region a(glm::ivec3(-5, 2, 3), glm::ivec3(12, 9, 20));
+	const Region b(glm::ivec3(0, -3, 7), glm::ivec3(20, 4, 9));
+	const Region c(glm::ivec3(-2, 0, 0), glm::ivec3(3, 20, 30));
+	const Region check(glm::ivec3(-10), glm::ivec3(32));
+
+	BitVolume volume;
+	volume.add(a);
+	volume.add(b);
+	expectEquals(volume, check,
+				 [&](int x, int y, int z) { return a.containsPoint(x, y, z) || b.containsPoint(x, y, z); });
+
+	volume.subtract(c);
+	expectEquals(volume, check, [&](int x, int y, int z) {
+		return (a.containsPoint(x, y, z) || b.containsPoint(x, y, z)) && !c.containsPoint(x, y, z);
+	});
+
+	volume.intersect(b);
+	expectEquals(volume, check,
+				 [&](int x, int y, int z) { return b.containsPoint(x, y, z) && !c.containsPoint(x, y, z); });
+
+	volume.invert(a);
+	expectEquals(volume, check, [&](int x, int y, int z) {
+		const bool before = b.containsPoint(x, y, z) && !c.containsPoint(x, y, z);
+		return a.containsPoint(x, y, z) ? !before : before;
+	});
+}
+
+TEST_F(BitVolumeTest, testVolumeOperations) {
+	const Region a(glm::ivec3(0), glm::ivec3(15));
+	const Region b(glm::ivec3(8, 3, -4), glm::ivec3(30, 12, 9));
+	const Region check(glm::ivec3(-8), glm::ivec3(32));
+	BitVolume va;
+	va.add(a);
+	BitVolume vb;
+	vb.add(b);
+
+	BitVolume united = va;
+	united.add(vb);
+	expectEquals(united, check,
+				 [&](int x, int y, int z) { return a.containsPoint(x, y, z) || b.containsPoint(x, y, z); });
+
+	BitVolume subtracted = va;
+	subtracted.subtract(vb);
+	expectEquals(subtracted, check,
+				 [&](int x, int y, int z) { return a.containsPoint(x, y, z) && !b.containsPoint(x, y, z); });
+
+	BitVolume intersected = va;
+	intersected.intersect(vb);
+	expectEquals(intersected, check,
+				 [&](int x, int y, int z) { return a.containsPoint(x, y, z) && b.containsPoint(x, y, z); });
+	Region expected = a;
+	expected.cropTo(b);
+	EXPECT_EQ(expected, intersected.calculateRegion());
+
+	intersected.intersect(BitVolume());
+	EXPECT_TRUE(intersected.empty());
+}
+
+TEST_F(BitVolumeTest, testVisitSpan) {
+	BitVolume volume;
+	volume.add(Region(glm::ivec3(-5, 2, 3), glm::ivec3(3, 2, 3)));
+	volume.add(Region(glm::ivec3(7, 2, 3), glm::ivec3(20, 2, 3)));
+	volume.set(0, 2, 3, false);
+	core::DynamicArray<glm::ivec2> runs;
+	volume.visitSpan(-10, 30, 2, 3, [&](int x0, int x1) { runs.push_back(glm::ivec2(x0, x1)); });
+	ASSERT_EQ(3u, runs.size());
+	EXPECT_EQ(glm::ivec2(-5, -1), runs[0]);
+	EXPECT_EQ(glm::ivec2(1, 3), runs[1]);
+	EXPECT_EQ(glm::ivec2(7, 20), runs[2]);
+
+	runs.clear();
+	volume.visitSpan(10, 12, 2, 3, [&](int x0, int x1) { runs.push_back(glm::ivec2(x0, x1)); });
+	ASSERT_EQ(1u, runs.size());
+	EXPECT_EQ(glm::ivec2(10, 12), runs[0]);
+
+	runs.clear();
+	volume.visitSpan(-10, 30, 3, 3, [&](int x0, int x1) { runs.push_back(glm::ivec2(x0, x1)); });
+	EXPECT_TRUE(runs.empty());
+}
+
+TEST_F(BitVolumeTest, testVisitSpans) {
+	BitVolume volume;
+	volume.add(Region(glm::ivec3(-7, -3, 2), glm::ivec3(12, 9, 11)));
+	volume.subtract(Region(glm::ivec3(0, 0, 5), glm::ivec3(3, 4, 6)));
+	volume.set(20, 1, 3, true);
+	const Region region(glm::ivec3(-4, -1, 0), glm::ivec3(25, 6, 9));
+	BitVolume visited;
+	volume.visitSpans(region, [&](int x0, int x1, int y, int z) {
+		for (int x = x0; x <= x1; ++x) {
+			EXPECT_FALSE(visited.contains(x, y, z));
+			visited.set(x, y, z, true);
+		}
+	});
+	expectEquals(visited, Region(glm::ivec3(-10), glm::ivec3(30)),
+				 [&](int x, int y, int z) { return region.containsPoint(x, y, z) && volume.contains(x, y, z); });
+}
+
+TEST_F(BitVolumeTest, testRegions) {
+	BitVolume volume;
+	volume.add(Region(glm::ivec3(-7, -3, 2), glm::ivec3(12, 9, 11)));
+	volume.subtract(Region(glm::ivec3(0, 0, 5), glm::ivec3(3, 4, 6)));
+	volume.set(20, 1, 3, true);
+	core::DynamicArray<Region> regions;
+	volume.regions(regions);
+	BitVolume rebuilt;
+	for (const Region &r : regions) {
+		for (int z = r.getLowerZ(); z <= r.getUpperZ(); ++z) {
+			for (int y = r.getLowerY(); y <= r.getUpperY(); ++y) {
+				for (int x = r.getLowerX(); x <= r.getUpperX(); ++x) {
+					EXPECT_FALSE(rebuilt.contains(x, y, z)) << "regions overlap at " << x << ":" << y << ":" << z;
+					rebuilt.set(x, y, z, true);
+				}
+			}
+		}
+	}
+	expectEquals(rebuilt, Region(glm::ivec3(-10), glm::ivec3(30)),
+				 [&](int x, int y, int z) { return volume.contains(x, y, z); });
+	EXPECT_LE(regions.size(), 8u);
+
+	volume.clear();
+	volume.regions(regions);
+	EXPECT_TRUE(regions.empty());
+}
+
+} // namespace voxel
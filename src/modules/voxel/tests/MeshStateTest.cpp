@@ -21,6 +21,46 @@ protected:
 		core::Var::get(cfg::VoxelMeshSize, "16", core::CV_READONLY);
 		core::Var::get(cfg::VoxelMeshMode, core::string::toString((int)voxel::SurfaceExtractionType::Cubic));
 	}
+
+	void extractAll(MeshState &meshState) {
+		meshState.extractAllPending();
+		while (meshState.pop() != -1) {
+		}
+	}
+
+	template<class MeshesMapType>
+	void expectSameMeshes(const MeshesMapType &expectedMeshes, const MeshesMapType &actualMeshes) {
+		ASSERT_EQ(expectedMeshes.size(), actualMeshes.size());
+		for (const auto &e : expectedMeshes) {
+			auto iter = actualMeshes.find(e->key);
+			ASSERT_NE(iter, actualMeshes.end());
+			const auto *expectedMesh = e->value;
+			const auto *actualMesh = iter->value;
+			ASSERT_EQ(expectedMesh == nullptr, actualMesh == nullptr);
+			if (expectedMesh == nullptr) {
+				continue;
+			}
+			ASSERT_EQ(expectedMesh->getNoOfVertices(), actualMesh->getNoOfVertices());
+			ASSERT_EQ(expectedMesh->getNoOfIndices(), actualMesh->getNoOfIndices());
+			for (size_t i = 0; i < expectedMesh->getNoOfVertices(); ++i) {
+				ASSERT_EQ(expectedMesh->getVertex(i).position, actualMesh->getVertex(i).position);
+				ASSERT_EQ(expectedMesh->getVertex(i).info, actualMesh->getVertex(i).info);
+				ASSERT_EQ(expectedMesh->getVertex(i).colorIndex, actualMesh->getVertex(i).colorIndex);
+			}
+			const auto &expectedIndices = expectedMesh->getIndexVector();
+			const auto &actualIndices = actualMesh->getIndexVector();
+			for (size_t i = 0; i < expectedIndices.size(); ++i) {
+				ASSERT_EQ(expectedIndices[i], actualIndices[i]);
+			}
+		}
+	}
+
+	void expectSameMeshes(const MeshState &expected, const MeshState &actual) {
+		for (int type = 0; type < MeshType_Max; ++type) {
+			expectSameMeshes(expected.meshes((MeshType)type, 0), actual.meshes((MeshType)type, 0));
+			expectSameMeshes(expected.packedMeshes((MeshType)type, 0), actual.packedMeshes((MeshType)type, 0));
+		}
+	}
 };
 
 TEST_F(MeshStateTest, testExtractRegion) {
@@ -65,4 +105,178 @@ TEST_F(MeshStateTest, testExtractRegionBoundary) {
 	(void)meshState.shutdown();
 }
 
+TEST_F(MeshStateTest, testVolumeSlots) {
+	voxel::RawVolume v(voxel::Region(0, 15));
+	v.setVoxel(1, 1, 1, voxel::createVoxel(voxel::VoxelType::Generic, 1));
+	palette::Palette pal;
+	pal.nippon();
+
+	MeshState meshState;
+	meshState.construct();
+	meshState.init();
+	EXPECT_EQ(0, meshState.volumeSlots());
+
+	// slot indices are not limited - but only the used slots are allocated
+	const int idx = 5000;
+	bool deleted = false;
+	(void)meshState.setVolume(idx, &v, &pal, true, deleted);
+	EXPECT_EQ(idx + 1, meshState.volumeSlots());
+	EXPECT_TRUE(meshState.hasVolumeData(idx));
+	EXPECT_FALSE(meshState.hasVolumeData(idx - 1));
+	meshState.scheduleRegionExtraction(idx, v.region());
+	extractAll(meshState);
+	EXPECT_EQ(1u, meshState.packedMeshes(MeshType_Opaque, idx).size());
+	EXPECT_EQ(0u, meshState.packedMeshes(MeshType_Opaque, idx - 1).size());
+
+	// removing the volume releases the slot
+	EXPECT_EQ(&v, meshState.setVolume(idx, nullptr, nullptr, true, deleted));
+	EXPECT_TRUE(deleted);
+	EXPECT_EQ(0, meshState.volumeSlots());
+	EXPECT_EQ(0u, meshState.packedMeshes(MeshType_Opaque, idx).size());
+	(void)meshState.shutdown();
+}
+
+TEST_F(MeshStateTest, testIncrementalFaceVisibility) {
+	voxel::RawVolume v(voxel::Region(0, 31));
+	for (int x = 0; x <= 31; ++x) {
+		for (int z = 0; z <= 31; ++z) {
+			const int height = (x * 7 + z * 3) % 23;
+			for (int y = 0; y <= height; ++y) {
+				v.setVoxel(x, y, z, voxel::createVoxel(voxel::VoxelType::Generic, (x + z) % 5));
+			}
+		}
+	}
+	palette::Palette pal;
+	pal.nippon();
+
+	MeshState meshState;
+	meshState.construct();
+	meshState.init();
+	bool deleted = false;
+	(void)meshState.setVolume(0, &v, &pal, true, deleted);
+	meshState.scheduleRegionExtraction(0, v.region());
+	extractAll(meshState);
+
+	// modify a few voxels at the chunk borders - the neighbouring chunks are affected, too
+	const glm::ivec3 modified[] = {{15, 20, 15}, {16, 0, 16}, {0, 0, 0}, {31, 25, 31}, {8, 22, 9}};
+	for (const glm::ivec3 &pos : modified) {
+		const bool air = voxel::isAir(v.voxel(pos).getMaterial());
+		v.setVoxel(pos, air ? voxel::createVoxel(voxel::VoxelType::Generic, 3) : voxel::Voxel());
+		meshState.scheduleRegionExtraction(0, voxel::Region(pos, pos));
+		extractAll(meshState);
+	}
+
+	// compare with a mesh state that never saw the old volume state
+	MeshState expected;
+	expected.construct();
+	expected.init();
+	(void)expected.setVolume(0, &v, &pal, true, deleted);
+	expected.scheduleRegionExtraction(0, v.region());
+	extractAll(expected);
+
+	expectSameMeshes(expected, meshState);
+	(void)expected.shutdown();
+	(void)meshState.shutdown();
+}
+
+TEST_F(MeshStateTest, testPackedMeshes) {
+	voxel::RawVolume v(voxel::Region(0, 31));
+	for (int x = 0; x <= 31; ++x) {
+		for (int z = 0; z <= 31; ++z) {
+			const int height = (x * 7 + z * 3) % 23;
+			for (int y = 0; y <= height; ++y) {
+				v.setVoxel(x, y, z, voxel::createVoxel(voxel::VoxelType::Generic, (x + z) % 5));
+			}
+		}
+	}
+	palette::Palette pal;
+	pal.nippon();
+
+	MeshState meshState;
+	meshState.construct();
+	meshState.init();
+	bool deleted = false;
+	(void)meshState.setVolume(0, &v, &pal, true, deleted);
+	meshState.scheduleRegionExtraction(0, v.region());
+	extractAll(meshState);
+
+	EXPECT_EQ(0u, meshState.meshes(MeshType_Opaque, 0).size());
+	const MeshState::PackedMeshesMap &packedMeshes = meshState.packedMeshes(MeshType_Opaque, 0);
+	ASSERT_EQ(8u, packedMeshes.size());
+	size_t packedVertices = 0u;
+	size_t packedIndices = 0u;
+	for (const auto &e : packedMeshes) {
+		packedVertices += e->value->getNoOfVertices();
+		packedIndices += e->value->getNoOfIndices();
+	}
+	size_t vertCount = 0u;
+	size_t normalsCount = 0u;
+	size_t indCount = 0u;
+	meshState.count(MeshType_Opaque, 0, vertCount, normalsCount, indCount);
+	EXPECT_GT(vertCount, 0u);
+	EXPECT_EQ(packedVertices, vertCount);
+	EXPECT_EQ(packedIndices, indCount);
+	EXPECT_EQ(0u, normalsCount);
+
+	// the marching cubes meshes are not packable - they replace the packed meshes of the chunks
+	const core::VarPtr &meshMode = core::Var::getSafe(cfg::VoxelMeshMode);
+	meshMode->setVal((int)voxel::SurfaceExtractionType::MarchingCubes);
+	EXPECT_TRUE(meshState.update());
+	extractAll(meshState);
+	EXPECT_EQ(0u, meshState.packedMeshes(MeshType_Opaque, 0).size());
+	EXPECT_EQ(8u, meshState.meshes(MeshType_Opaque, 0).size());
+	meshMode->setVal((int)voxel::SurfaceExtractionType::Cubic);
+	(void)meshState.shutdown();
+}
+
+TEST_F(MeshStateTest, testLodMeshes) {
+	voxel::RawVolume v(voxel::Region(0, 31));
+	for (int x = 0; x <= 31; ++x) {
+		for (int z = 0; z <= 31; ++z) {
+			for (int y = 0; y <= 20; ++y) {
+				v.setVoxel(x, y, z, voxel::createVoxel(voxel::VoxelType::Generic, 1));
+			}
+		}
+	}
+	palette::Palette pal;
+	pal.nippon();
+
+	MeshState meshState;
+	meshState.construct();
+	meshState.init();
+	EXPECT_FALSE(meshState.lodEnabled());
+	core::Var::getSafe(cfg::VoxelMeshLod)->setVal(true);
+	EXPECT_TRUE(meshState.lodEnabled());
+	bool deleted = false;
+	(void)meshState.setVolume(0, &v, &pal, true, deleted);
+	meshState.scheduleRegionExtraction(0, v.region());
+	extractAll(meshState);
+
+	// the cubic meshes are kept packed
+	EXPECT_EQ(0u, meshState.meshes(MeshType_Opaque, 0).size());
+	const MeshState::PackedMeshesMap &meshes = meshState.packedMeshes(MeshType_Opaque, 0);
+	ASSERT_EQ(8u, meshes.size());
+	for (int lod = 1; lod < MeshState::MaxLods; ++lod) {
+		EXPECT_EQ(0u, meshState.meshes(MeshType_Opaque, 0, lod).size());
+		const MeshState::PackedMeshesMap &lodMeshes = meshState.packedMeshes(MeshType_Opaque, 0, lod);
+		ASSERT_EQ(meshes.size(), lodMeshes.size()) << "lod " << lod;
+		EXPECT_EQ(0u, meshState.packedMeshes(MeshType_Transparency, 0, lod).size());
+		for (const auto &e : lodMeshes) {
+			const voxel::PackedMesh *mesh = e->value;
+			ASSERT_NE(nullptr, mesh);
+			const glm::ivec3 &mins = e->key;
+			if (mins.y == 0) {
+				EXPECT_GT(mesh->getNoOfIndices(), 0u) << "lod " << lod;
+			}
+			// the lower detail levels cover the same region as the chunk
+			for (size_t i = 0; i < mesh->getNoOfVertices(); ++i) {
+				const glm::vec3 pos = mesh->getVertex(i).position;
+				EXPECT_TRUE(glm::all(glm::greaterThanEqual(pos, glm::vec3(mins))));
+				EXPECT_TRUE(glm::all(glm::lessThanEqual(pos, glm::vec3(mins + 16))));
+			}
+		}
+	}
+	(void)meshState.shutdown();
+}
+
 } // namespace voxelrender
@@ -0,0 +1,84 @@
+/**
+ * @file
+ */
+
+#include "voxel/OccupancyPyramid.h"
+#include "AbstractVoxelTest.h"
+#include "voxel/RawVolume.h"
+
+namespace voxel {
+
+class OccupancyPyramidTest : public AbstractVoxelTest {};
+
+TEST_F(OccupancyPyramidTest, testBuildEmpty) {
+	RawVolume v(Region(glm::ivec3(0), glm::ivec3(40)));
+	OccupancyPyramid occupancy(v);
+	ASSERT_TRUE(occupancy.isValid());
+	EXPECT_EQ(4, occupancy.levels());
+	EXPECT_EQ(3, occupancy.emptyLevel(glm::ivec3(20)));
+	EXPECT_TRUE(occupancy.empty(0, glm::ivec3(40)));
+	EXPECT_FALSE(occupancy.empty(0, glm::ivec3(41))) << "Positions outside the volume are not reported as empty";
+}
+
+TEST_F(OccupancyPyramidTest, testBuild) {
+	RawVolume v(Region(glm::ivec3(-5), glm::ivec3(30)));
+	v.setVoxel(glm::ivec3(12, 12, 12), createVoxel(VoxelType::Generic, 1));
+	OccupancyPyramid occupancy(v);
+	EXPECT_FALSE(occupancy.empty(0, glm::ivec3(11, 11, 11)));
+	EXPECT_TRUE(occupancy.empty(0, glm::ivec3(10, 10, 10)));
+	EXPECT_EQ(1, occupancy.emptyLevel(glm::ivec3(10, 10, 10)));
+	EXPECT_EQ(-1, occupancy.emptyLevel(glm::ivec3(12, 12, 12)));
+	EXPECT_EQ(1, occupancy.emptyLevel(glm::ivec3(-5, -5, 25)));
+	EXPECT_EQ(Region(glm::ivec3(11), glm::ivec3(18)), occupancy.brickRegion(0, glm::ivec3(12)));
+	EXPECT_EQ(Region(glm::ivec3(27), glm::ivec3(30)), occupancy.brickRegion(0, glm::ivec3(28)));
+}
+
+TEST_F(OccupancyPyramidTest, testSetVoxel) {
+	RawVolume v(Region(glm::ivec3(0), glm::ivec3(63)));
+	OccupancyPyramid occupancy(v);
+	const glm::ivec3 pos(33, 2, 60);
+	EXPECT_TRUE(occupancy.empty(occupancy.levels() - 1, pos));
+	occupancy.setVoxel(pos, Voxel(), createVoxel(VoxelType::Generic, 1));
+	for (int i = 0; i < occupancy.levels(); ++i) {
+		EXPECT_FALSE(occupancy.empty(i, pos)) << "level " << i;
+	}
+	EXPECT_TRUE(occupancy.empty(0, glm::ivec3(0)));
+	EXPECT_FALSE(occupancy.empty(occupancy.levels() - 1, glm::ivec3(0)));
+	occupancy.setVoxel(pos, createVoxel(VoxelType::Generic, 1), Voxel());
+	for (int i = 0; i < occupancy.levels(); ++i) {
+		EXPECT_TRUE(occupancy.empty(i, pos)) << "level " << i;
+	}
+}
+
+TEST_F(OccupancyPyramidTest, testUpdate) {
+	RawVolume v(Region(glm::ivec3(0), glm::ivec3(63)));
+	OccupancyPyramid occupancy(v);
+	const Region filled(glm::ivec3(8), glm::ivec3(15));
+	for (int z = filled.getLowerZ(); z <= filled.getUpperZ(); ++z) {
+		for (int y = filled.getLowerY(); y <= filled.getUpperY(); ++y) {
+			for (int x = filled.getLowerX(); x <= filled.getUpperX(); ++x) {
+				v.setVoxel(x, y, z, createVoxel(VoxelType::Generic, 1));
+			}
+		}
+	}
+	occupancy.update(v, filled);
+	EXPECT_EQ(OccupancyPyramid::BrickOccupied | OccupancyPyramid::BrickFull, occupancy.flags(0, glm::ivec3(10)));
+	EXPECT_EQ(OccupancyPyramid::BrickOccupied, occupancy.flags(1, glm::ivec3(10)));
+	EXPECT_TRUE(occupancy.empty(0, glm::ivec3(16)));
+
+	v.setVoxel(glm::ivec3(8), Voxel());
+	occupancy.update(v, Region(glm::ivec3(8), glm::ivec3(8)));
+	EXPECT_EQ(OccupancyPyramid::BrickOccupied, occupancy.flags(0, glm::ivec3(10)));
+}
+
+TEST_F(OccupancyPyramidTest, testUpdateChangedRegion) {
+	RawVolume v(Region(glm::ivec3(0), glm::ivec3(15)));
+	OccupancyPyramid occupancy(v);
+	RawVolume v2(Region(glm::ivec3(0), glm::ivec3(31)));
+	v2.setVoxel(glm::ivec3(31), createVoxel(VoxelType::Generic, 1));
+	occupancy.update(v2, Region(glm::ivec3(0), glm::ivec3(0)));
+	EXPECT_EQ(v2.region(), occupancy.region());
+	EXPECT_FALSE(occupancy.empty(0, glm::ivec3(31)));
+}
+
+} // namespace voxel
@@ -0,0 +1,128 @@
+/**
+ * @file
+ */
+
+#include "voxel/PackedMesh.h"
+#include "app/tests/AbstractTest.h"
+#include "palette/Palette.h"
+#include "voxel/ChunkMesh.h"
+#include "voxel/RawVolume.h"
+#include "voxel/SurfaceExtractor.h"
+#include <glm/geometric.hpp>
+
+namespace voxel {
+
+class PackedMeshTest : public app::AbstractTest {
+protected:
+	void fillVolume(voxel::RawVolume &v) {
+		const voxel::Region &region = v.region();
+		for (int x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+			for (int z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+				const int height = region.getLowerY() + (x * 7 + z * 3) % 11;
+				for (int y = region.getLowerY(); y <= height; ++y) {
+					v.setVoxel(x, y, z, voxel::createVoxel(voxel::VoxelType::Generic, (x + z) % 5));
+				}
+			}
+		}
+	}
+};
+
+TEST_F(PackedMeshTest, testPackUnpack) {
+	voxel::Region region(glm::ivec3(-10, 0, 5), glm::ivec3(20, 15, 30));
+	voxel::RawVolume v(region);
+	fillVolume(v);
+	voxel::ChunkMesh chunkMesh;
+	SurfaceExtractionContext ctx = voxel::buildCubicContext(&v, region, chunkMesh, glm::ivec3(2, 3, 4));
+	voxel::extractSurface(ctx);
+	const voxel::Mesh &mesh = chunkMesh.mesh[0];
+	ASSERT_FALSE(mesh.isEmpty());
+
+	PackedMesh packed;
+	ASSERT_TRUE(packed.pack(mesh));
+	EXPECT_EQ(mesh.getNoOfVertices(), packed.getVertexVector().size());
+	EXPECT_EQ(mesh.getNoOfIndices(), packed.getIndexVector().size());
+	EXPECT_EQ(mesh.getOffset(), packed.getOffset());
+	const size_t meshSize =
+		mesh.getNoOfVertices() * sizeof(VoxelVertex) + mesh.getNoOfIndices() * sizeof(IndexType);
+	EXPECT_EQ(meshSize / 2u, packed.dataSize());
+
+	voxel::Mesh unpacked;
+	packed.unpack(unpacked);
+	ASSERT_EQ(mesh.getNoOfVertices(), unpacked.getNoOfVertices());
+	ASSERT_EQ(mesh.getNoOfIndices(), unpacked.getNoOfIndices());
+	EXPECT_EQ(mesh.getOffset(), unpacked.getOffset());
+	for (size_t i = 0; i < mesh.getNoOfVertices(); ++i) {
+		const VoxelVertex &expected = mesh.getVertex(i);
+		const VoxelVertex &actual = unpacked.getVertex(i);
+		ASSERT_EQ(expected.position, actual.position) << "vertex " << i;
+		ASSERT_EQ(expected.info, actual.info) << "vertex " << i;
+		ASSERT_EQ(expected.colorIndex, actual.colorIndex) << "vertex " << i;
+		ASSERT_EQ(expected.position, packed.getVertex(i).position) << "vertex " << i;
+	}
+	for (size_t i = 0; i < mesh.getNoOfIndices(); ++i) {
+		ASSERT_EQ(mesh.getIndex(i), unpacked.getIndex(i)) << "index " << i;
+	}
+}
+
+TEST_F(PackedMeshTest, testMarchingCubesIsNotPackable) {
+	voxel::Region region(glm::ivec3(0), glm::ivec3(7));
+	voxel::RawVolume v(region);
+	fillVolume(v);
+	palette::Palette pal;
+	pal.nippon();
+	voxel::ChunkMesh chunkMesh;
+	SurfaceExtractionContext ctx = voxel::buildMarchingCubesContext(&v, region, chunkMesh, pal);
+	voxel::extractSurface(ctx);
+	ASSERT_FALSE(chunkMesh.mesh[0].isEmpty());
+	EXPECT_FALSE(PackedMesh::isPackable(chunkMesh.mesh[0]));
+	PackedMesh packed;
+	EXPECT_FALSE(packed.pack(chunkMesh.mesh[0]));
+	EXPECT_TRUE(packed.isEmpty());
+}
+
+TEST_F(PackedMeshTest, testOutOfRangeIsNotPackable) {
+	voxel::Mesh mesh;
+	VoxelVertex vertex;
+	vertex.info = 0;
+	vertex.colorIndex = 1;
+	vertex.position = glm::vec3(0.0f, 40000.0f, 0.0f);
+	mesh.addVertex(vertex);
+	mesh.addVertex(vertex);
+	mesh.addVertex(vertex);
+	mesh.addTriangle(0, 1, 2);
+	EXPECT_FALSE(PackedMesh::isPackable(mesh));
+}
+
+TEST_F(PackedMeshTest, testSortMatchesMesh) {
+	voxel::Region region(glm::ivec3(0), glm::ivec3(15));
+	voxel::RawVolume v(region);
+	fillVolume(v);
+	voxel::ChunkMesh chunkMesh;
+	SurfaceExtractionContext ctx = voxel::buildCubicContext(&v, region, chunkMesh, glm::ivec3(0));
+	voxel::extractSurface(ctx);
+	voxel::Mesh &mesh = chunkMesh.mesh[0];
+	PackedMesh packed;
+	ASSERT_TRUE(packed.pack(mesh));
+
+	const glm::vec3 cameraPos(-20.0f, 30.0f, 7.0f);
+	EXPECT_TRUE(packed.sort(cameraPos));
+	EXPECT_FALSE(packed.sort(cameraPos)) << "no sorting needed for the same camera position";
+	ASSERT_TRUE(mesh.sort(cameraPos));
+	ASSERT_EQ(mesh.getNoOfIndices(), packed.getNoOfIndices());
+	// the triangles are in the same distance order - compare the distances as the order of equal ones is not stable
+	for (size_t i = 0; i < mesh.getNoOfIndices(); i += 3) {
+		const glm::vec3 meshCenter = (mesh.getVertex(mesh.getIndex(i)).position +
+									  mesh.getVertex(mesh.getIndex(i + 1)).position +
+									  mesh.getVertex(mesh.getIndex(i + 2)).position) /
+									 3.0f;
+		const PackedIndexArray &indices = packed.getIndexVector();
+		const glm::vec3 packedCenter = (packed.getVertex(indices[i]).position +
+										packed.getVertex(indices[i + 1]).position +
+										packed.getVertex(indices[i + 2]).position) /
+									   3.0f;
+		ASSERT_FLOAT_EQ(glm::distance(meshCenter, cameraPos), glm::distance(packedCenter, cameraPos))
+			<< "triangle " << i / 3;
+	}
+}
+
+} // namespace voxel
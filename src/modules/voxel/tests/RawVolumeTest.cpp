@@ -3,7 +3,9 @@
  */
 
 #include "AbstractVoxelTest.h"
+#include "core/ScopedPtr.h"
 #include "core/collection/DynamicArray.h"
+#include "core/concurrent/ThreadPool.h"
 #include "voxel/RawVolume.h"
 #include "voxel/Voxel.h"
 
@@ -105,6 +107,142 @@ TEST_F(RawVolumeTest, testMove) {
 	EXPECT_EQ((int)v.voxel(1, 0, 0).getMaterial(), (int)VoxelType::Generic);
 }
 
+TEST_F(RawVolumeTest, testLayouts) {
+	const Region region(glm::ivec3(-3, 0, 5), glm::ivec3(12, 9, 21));
+	RawVolume linear(region);
+	for (int i = 0; i < 300; ++i) {
+		linear.setVoxel(region.getRandomPosition(_random), createVoxel(VoxelType::Generic, i % 255));
+	}
+	core::ScopedPtr<Voxel> linearVoxels(linear.copyVoxels());
+	for (int l = 0; l < (int)VolumeLayout::Max; ++l) {
+		const VolumeLayout layout = (VolumeLayout)l;
+		RawVolume v(region, layout);
+		ASSERT_EQ(layout, v.layout());
+		for (int z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+			for (int y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+				for (int x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+					v.setVoxel(x, y, z, linear.voxel(x, y, z));
+				}
+			}
+		}
+		RawVolume::Sampler expected(linear);
+		RawVolume::Sampler sampler(v);
+		for (int z = region.getLowerZ() - 1; z <= region.getUpperZ() + 1; ++z) {
+			for (int y = region.getLowerY() - 1; y <= region.getUpperY() + 1; ++y) {
+				expected.setPosition(region.getLowerX() - 1, y, z);
+				sampler.setPosition(region.getLowerX() - 1, y, z);
+				for (int x = region.getLowerX() - 1; x <= region.getUpperX() + 1; ++x) {
+					ASSERT_TRUE(expected.voxel().isSame(sampler.voxel())) << "layout " << l << " at " << x << ":" << y << ":" << z;
+					ASSERT_TRUE(expected.peekVoxel1nx1ny1nz().isSame(sampler.peekVoxel1nx1ny1nz()));
+					ASSERT_TRUE(expected.peekVoxel1px0py1nz().isSame(sampler.peekVoxel1px0py1nz()));
+					ASSERT_TRUE(expected.peekVoxel0px1py1pz().isSame(sampler.peekVoxel0px1py1pz()));
+					ASSERT_TRUE(expected.peekVoxel1px1py1pz().isSame(sampler.peekVoxel1px1py1pz()));
+					expected.movePositiveX();
+					sampler.movePositiveX();
+				}
+			}
+		}
+		core::ScopedPtr<Voxel> voxels(v.copyVoxels());
+		ASSERT_EQ(0, core_memcmp(linearVoxels, voxels, RawVolume::size(region))) << "layout " << l;
+
+		const Region subRegion(glm::ivec3(0, 1, 6), glm::ivec3(9, 9, 15));
+		const RawVolume linearCopy(linear, subRegion);
+		const RawVolume copy(v, subRegion);
+		ASSERT_EQ(layout, copy.layout());
+		core::ScopedPtr<Voxel> linearCopyVoxels(linearCopy.copyVoxels());
+		core::ScopedPtr<Voxel> copyVoxels(copy.copyVoxels());
+		ASSERT_EQ(0, core_memcmp(linearCopyVoxels, copyVoxels, RawVolume::size(subRegion))) << "layout " << l;
+
+		RawVolume moved(v);
+		RawVolume linearMoved(linear);
+		moved.move(glm::ivec3(3, -2, 7));
+		linearMoved.move(glm::ivec3(3, -2, 7));
+		core::ScopedPtr<Voxel> linearMovedVoxels(linearMoved.copyVoxels());
+		core::ScopedPtr<Voxel> movedVoxels(moved.copyVoxels());
+		ASSERT_EQ(0, core_memcmp(linearMovedVoxels, movedVoxels, RawVolume::size(region))) << "layout " << l;
+	}
+}
+
+TEST_F(RawVolumeTest, testCopyOnWrite) {
+	RawVolume v(_region);
+	pageIn(v.region(), v);
+	EXPECT_FALSE(v.isShared());
+	RawVolume copy(v);
+	EXPECT_TRUE(v.isShared());
+	EXPECT_TRUE(copy.isShared());
+	EXPECT_EQ(v.data(), copy.data());
+
+	// writing the same voxel again doesn't detach the data
+	EXPECT_FALSE(copy.setVoxel(0, 0, 0, v.voxel(0, 0, 0)));
+	EXPECT_TRUE(copy.isShared());
+
+	EXPECT_TRUE(copy.setVoxel(0, 0, 0, createVoxel(VoxelType::Generic, 42)));
+	EXPECT_FALSE(v.isShared());
+	EXPECT_FALSE(copy.isShared());
+	EXPECT_NE(v.data(), copy.data());
+	EXPECT_EQ(1, v.voxel(0, 0, 0).getColor());
+	EXPECT_EQ(42, copy.voxel(0, 0, 0).getColor());
+	EXPECT_EQ(9, copy.voxel(2, 0, 2).getColor());
+}
+
+TEST_F(RawVolumeTest, testCopyOnWriteOriginalDeleted) {
+	RawVolume *v = new RawVolume(_region);
+	pageIn(v->region(), *v);
+	RawVolume copy(v);
+	RawVolume regionCopy(*v, v->region());
+	EXPECT_EQ(v->data(), regionCopy.data());
+	delete v;
+	EXPECT_TRUE(copy.isShared());
+	regionCopy.clear();
+	EXPECT_FALSE(copy.isShared());
+	EXPECT_TRUE(isAir(regionCopy.voxel(0, 0, 0).getMaterial()));
+	EXPECT_EQ(1, copy.voxel(0, 0, 0).getColor());
+	EXPECT_TRUE(copy.setVoxel(0, 0, 0, createVoxel(VoxelType::Generic, 42)));
+	EXPECT_EQ(42, copy.voxel(0, 0, 0).getColor());
+}
+
+TEST_F(RawVolumeTest, testCopyOnWriteSampler) {
+	RawVolume v(_region);
+	pageIn(v.region(), v);
+	RawVolume copy(v);
+	RawVolume::Sampler reader(copy);
+	reader.setPosition(0, 0, 0);
+	RawVolume::Sampler writer(copy);
+	writer.setPosition(1, 0, 0);
+	EXPECT_TRUE(writer.setVoxel(createVoxel(VoxelType::Generic, 42)));
+	EXPECT_EQ(42, writer.voxel().getColor());
+	EXPECT_EQ(42, copy.voxel(1, 0, 0).getColor());
+	EXPECT_EQ(2, v.voxel(1, 0, 0).getColor());
+	// the reader is resolved against the detached data without moving it
+	EXPECT_EQ(1, reader.voxel().getColor());
+	EXPECT_EQ(42, reader.peekVoxel1px0py0pz().getColor());
+	reader.movePositiveX();
+	EXPECT_EQ(42, reader.voxel().getColor());
+}
+
+TEST_F(RawVolumeTest, testShareFromSeveralThreads) {
+	RawVolume v(_region);
+	pageIn(v.region(), v);
+	const RawVolume &src = v;
+	const int copies = 64;
+	core::DynamicArray<RawVolume *> volumes;
+	volumes.resize(copies);
+	core::ThreadPool pool(4);
+	pool.init();
+	for (int i = 0; i < copies; ++i) {
+		pool.enqueue([&src, &volumes, i]() { volumes[i] = new RawVolume(src); });
+	}
+	pool.shutdown(true);
+	EXPECT_TRUE(v.isShared());
+	for (RawVolume *copy : volumes) {
+		EXPECT_EQ(v.data(), copy->data());
+		delete copy;
+	}
+	EXPECT_FALSE(v.isShared());
+	EXPECT_TRUE(v.setVoxel(0, 0, 0, createVoxel(VoxelType::Generic, 42)));
+	EXPECT_EQ(42, v.voxel(0, 0, 0).getColor());
+}
+
 TEST_F(RawVolumeTest, testFullSamplerLoop) {
 	RawVolume v(_region);
 	pageIn(v.region(), v);
@@ -5,6 +5,7 @@
 #include "voxel/SurfaceExtractor.h"
 #include "app/tests/AbstractTest.h"
 #include "voxel/ChunkMesh.h"
+#include "voxel/FaceVisibility.h"
 #include "voxel/RawVolume.h"
 
 namespace voxel {
@@ -132,4 +133,130 @@ TEST_F(SurfaceExtractorTest, testMeshExtractionIssue445) {
 	EXPECT_EQ(8, (int)mesh.mesh[0].getNoOfVertices());
 }
 
+static glm::vec3 triangleCenterSum(const Mesh &mesh) {
+	glm::vec3 sum(0.0f);
+	for (IndexType index : mesh.getIndexVector()) {
+		sum += mesh.getVertex(index).position;
+	}
+	return sum;
+}
+
+TEST_F(SurfaceExtractorTest, testExtractSurfaceParallel) {
+	voxel::Region region(glm::ivec3(-3, 0, 2), glm::ivec3(40, 21, 37));
+	voxel::RawVolume v(region);
+	for (int x = 0; x <= 30; ++x) {
+		for (int z = 2; z <= 30; ++z) {
+			const int height = (x * 7 + z * 3) % 19;
+			for (int y = 0; y <= height; ++y) {
+				v.setVoxel(x, y, z, voxel::createVoxel(voxel::VoxelType::Generic, (x + z) % 5));
+			}
+		}
+	}
+	// without quad merging and vertex reuse the tiles must produce the same triangles
+	voxel::ChunkMesh serial;
+	SurfaceExtractionContext serialCtx =
+		voxel::buildCubicContext(&v, region, serial, glm::ivec3(1, 2, 3), false, false, false);
+	voxel::extractSurface(serialCtx);
+
+	voxel::ChunkMesh parallel;
+	SurfaceExtractionContext parallelCtx =
+		voxel::buildCubicContext(&v, region, parallel, glm::ivec3(1, 2, 3), false, false, false);
+	voxel::extractSurfaceParallel(parallelCtx, 8);
+
+	EXPECT_EQ(serial.mesh[0].getOffset(), parallel.mesh[0].getOffset());
+	ASSERT_EQ(serial.mesh[0].getNoOfIndices(), parallel.mesh[0].getNoOfIndices());
+	EXPECT_EQ(triangleCenterSum(serial.mesh[0]), triangleCenterSum(parallel.mesh[0]));
+}
+
+TEST_F(SurfaceExtractorTest, testExtractSurfaceParallelAirTiles) {
+	voxel::Region region(glm::ivec3(0), glm::ivec3(31));
+	voxel::RawVolume v(region);
+	// the faces of this voxel belong to the neighbouring tiles, too
+	v.setVoxel(15, 15, 15, voxel::createVoxel(voxel::VoxelType::Generic, 1));
+
+	voxel::ChunkMesh mesh;
+	SurfaceExtractionContext ctx = voxel::buildCubicContext(&v, region, mesh, glm::ivec3(0), false, false, false);
+	voxel::extractSurfaceParallel(ctx, 16);
+	EXPECT_EQ(36u, mesh.mesh[0].getNoOfIndices());
+	const Mesh &m = mesh.mesh[0];
+	glm::vec3 mins(1000.0f), maxs(-1000.0f);
+	for (const VoxelVertex &vertex : m.getVertexVector()) {
+		mins = glm::min(mins, vertex.position);
+		maxs = glm::max(maxs, vertex.position);
+	}
+	EXPECT_EQ(glm::vec3(15.0f), mins);
+	EXPECT_EQ(glm::vec3(16.0f), maxs);
+}
+
+static void expectSameMesh(const Mesh &expected, const Mesh &actual) {
+	ASSERT_EQ(expected.getNoOfVertices(), actual.getNoOfVertices());
+	ASSERT_EQ(expected.getNoOfIndices(), actual.getNoOfIndices());
+	for (size_t i = 0; i < expected.getNoOfIndices(); ++i) {
+		const VoxelVertex &e = expected.getVertex(expected.getIndexVector()[i]);
+		const VoxelVertex &a = actual.getVertex(actual.getIndexVector()[i]);
+		ASSERT_EQ(e.position, a.position) << "index " << i;
+		ASSERT_EQ(e.colorIndex, a.colorIndex) << "index " << i;
+		ASSERT_EQ(e.ambientOcclusion, a.ambientOcclusion) << "index " << i;
+	}
+}
+
+TEST_F(SurfaceExtractorTest, testExtractSurfaceFaceVisibility) {
+	voxel::Region region(glm::ivec3(-3, 0, 2), glm::ivec3(40, 21, 37));
+	voxel::RawVolume v(region);
+	for (int x = 0; x <= 30; ++x) {
+		for (int z = 2; z <= 30; ++z) {
+			const int height = (x * 7 + z * 3) % 19;
+			for (int y = 0; y <= height; ++y) {
+				// some transparent columns to get quads between opaque and transparent voxels
+				const voxel::VoxelType type =
+					(x + z) % 7 == 0 ? voxel::VoxelType::Transparent : voxel::VoxelType::Generic;
+				v.setVoxel(x, y, z, voxel::createVoxel(type, (x + z) % 5));
+			}
+		}
+	}
+	const voxel::Region extractRegion(glm::ivec3(0, 0, 2), glm::ivec3(15, 15, 17));
+	voxel::ChunkMesh expected;
+	SurfaceExtractionContext expectedCtx = voxel::buildCubicContext(&v, extractRegion, expected);
+	voxel::extractSurface(expectedCtx);
+
+	voxel::FaceVisibility faces(extractRegion);
+	faces.build(v);
+	voxel::ChunkMesh actual;
+	SurfaceExtractionContext actualCtx = voxel::buildCubicContext(&v, extractRegion, actual);
+	actualCtx.faceVisibility = &faces;
+	voxel::extractSurface(actualCtx);
+
+	ASSERT_FALSE(expected.mesh[0].isEmpty());
+	ASSERT_FALSE(expected.mesh[1].isEmpty());
+	expectSameMesh(expected.mesh[0], actual.mesh[0]);
+	expectSameMesh(expected.mesh[1], actual.mesh[1]);
+
+	// an incremental update must give the same masks as a rebuild
+	v.setVoxel(5, 19, 5, voxel::createVoxel(voxel::VoxelType::Generic, 1));
+	v.setVoxel(6, 0, 6, voxel::Voxel());
+	v.setVoxel(7, 1, 7, voxel::createVoxel(voxel::VoxelType::Transparent, 2));
+	faces.update(v, voxel::Region(glm::ivec3(5, 0, 5), glm::ivec3(7, 19, 7)));
+	voxel::FaceVisibility rebuilt(extractRegion);
+	rebuilt.build(v);
+	const voxel::Region &facesRegion = faces.region();
+	for (int z = facesRegion.getLowerZ(); z <= facesRegion.getUpperZ(); ++z) {
+		for (int y = facesRegion.getLowerY(); y <= facesRegion.getUpperY(); ++y) {
+			for (int x = facesRegion.getLowerX(); x <= facesRegion.getUpperX(); ++x) {
+				ASSERT_EQ(rebuilt.faces(x, y, z), faces.faces(x, y, z)) << x << ":" << y << ":" << z;
+			}
+		}
+	}
+
+	// and the quads of the updated masks must match a full extraction of the modified volume
+	voxel::ChunkMesh modifiedExpected;
+	SurfaceExtractionContext modifiedExpectedCtx = voxel::buildCubicContext(&v, extractRegion, modifiedExpected);
+	voxel::extractSurface(modifiedExpectedCtx);
+	voxel::ChunkMesh modifiedActual;
+	SurfaceExtractionContext modifiedActualCtx = voxel::buildCubicContext(&v, extractRegion, modifiedActual);
+	modifiedActualCtx.faceVisibility = &faces;
+	voxel::extractSurface(modifiedActualCtx);
+	expectSameMesh(modifiedExpected.mesh[0], modifiedActual.mesh[0]);
+	expectSameMesh(modifiedExpected.mesh[1], modifiedActual.mesh[1]);
+}
+
 } // namespace voxel
@@ -0,0 +1,67 @@
+/**
+ * @file
+ */
+
+#include "voxel/VolumeDownsampler.h"
+#include "app/tests/AbstractTest.h"
+#include "voxel/RawVolume.h"
+#include "voxel/Voxel.h"
+
+namespace voxel {
+
+class VolumeDownsamplerTest : public app::AbstractTest {};
+
+TEST_F(VolumeDownsamplerTest, testMajorityColor) {
+	RawVolume source(Region(0, 1));
+	for (int z = 0; z <= 1; ++z) {
+		for (int y = 0; y <= 1; ++y) {
+			for (int x = 0; x <= 1; ++x) {
+				const uint8_t color = (x == 0 && y == 0) ? 2 : 5;
+				source.setVoxel(x, y, z, createVoxel(VoxelType::Generic, color));
+			}
+		}
+	}
+	RawVolume target(Region(0, 0));
+	downsample(source, 2, target);
+	EXPECT_EQ(VoxelType::Generic, target.voxel(0, 0, 0).getMaterial());
+	EXPECT_EQ(5, target.voxel(0, 0, 0).getColor());
+}
+
+TEST_F(VolumeDownsamplerTest, testHalfSolidThreshold) {
+	RawVolume source(Region(0, 3));
+	// the first cell is half solid - the second cell has three of eight voxels set
+	for (int z = 0; z <= 1; ++z) {
+		for (int x = 0; x <= 1; ++x) {
+			source.setVoxel(x, 0, z, createVoxel(VoxelType::Generic, 1));
+		}
+	}
+	source.setVoxel(2, 0, 0, createVoxel(VoxelType::Generic, 1));
+	source.setVoxel(3, 0, 0, createVoxel(VoxelType::Generic, 1));
+	source.setVoxel(2, 1, 0, createVoxel(VoxelType::Generic, 1));
+	RawVolume target(Region(0, 1));
+	downsample(source, 2, target);
+	EXPECT_EQ(VoxelType::Generic, target.voxel(0, 0, 0).getMaterial());
+	EXPECT_TRUE(isAir(target.voxel(1, 0, 0).getMaterial()));
+	EXPECT_TRUE(isAir(target.voxel(0, 1, 0).getMaterial()));
+}
+
+TEST_F(VolumeDownsamplerTest, testOutsideSourceRegionIsAir) {
+	RawVolume source(Region(0, 2));
+	for (int z = 0; z <= 2; ++z) {
+		for (int y = 0; y <= 2; ++y) {
+			for (int x = 0; x <= 2; ++x) {
+				source.setVoxel(x, y, z, createVoxel(VoxelType::Generic, 3));
+			}
+		}
+	}
+	// the cell at (1,1,1) covers (2,2,2) up to (3,3,3) - only one of eight voxels is inside the source region
+	RawVolume target(Region(-1, 2));
+	downsample(source, 2, target);
+	EXPECT_EQ(3, target.voxel(0, 0, 0).getColor());
+	EXPECT_EQ(VoxelType::Generic, target.voxel(0, 0, 0).getMaterial());
+	EXPECT_TRUE(isAir(target.voxel(1, 1, 1).getMaterial()));
+	EXPECT_TRUE(isAir(target.voxel(-1, -1, -1).getMaterial()));
+	EXPECT_TRUE(isAir(target.voxel(2, 2, 2).getMaterial()));
+}
+
+} // namespace voxel
@@ -8,6 +8,9 @@
 #include "core/StringUtil.h"
 #include "http/HttpCacheStream.h"
 #include "io/Archive.h"
+#include "io/BufferedReadStream.h"
+#include "io/BufferedWriteStream.h"
+#include "io/FileStream.h"
 #include "io/FilesystemArchive.h"
 #include "voxelcollection/Downloader.h"
 #include "voxelformat/VolumeFormat.h"
@@ -40,6 +43,45 @@ void CollectionManager::shutdown() {
 	}
 }
 
+VoxelFile CollectionManager::localVoxelFile(const core::String &docs, const core::String &fullPath) const {
+	VoxelFile voxelFile;
+	voxelFile.name = fullPath.substr(docs.size());
+	voxelFile.fullPath = fullPath;
+	voxelFile.url = "file://" + fullPath;
+	voxelFile.source = "local";
+	voxelFile.license = "unknown";
+	// voxelFile.licenseUrl = "";
+	// voxelFile.thumbnailUrl = "";
+	voxelFile.downloaded = true;
+	return voxelFile;
+}
+
+void CollectionManager::loadLocalIndex(const core::String &indexFile) {
+	const io::FilePtr &file = _filesystem->open(indexFile, io::FileMode::SysRead);
+	if (!file->validHandle()) {
+		return;
+	}
+	io::FileStream fileStream(file);
+	io::BufferedReadStream stream(fileStream);
+	_localIndex.load(stream);
+}
+
+void CollectionManager::saveLocalIndex(const core::String &indexFile) {
+	if (!_localIndex.dirty()) {
+		return;
+	}
+	const io::FilePtr &file = _filesystem->open(indexFile, io::FileMode::SysWrite);
+	if (!file->validHandle()) {
+		Log::warn("Failed to open the local collection index %s for writing", indexFile.c_str());
+		return;
+	}
+	io::FileStream fileStream(file);
+	io::BufferedWriteStream stream(fileStream);
+	if (!_localIndex.save(stream)) {
+		Log::warn("Failed to write the local collection index %s", indexFile.c_str());
+	}
+}
+
 void CollectionManager::local() {
 	if (_local.valid()) {
 		return;
@@ -48,29 +90,71 @@ void CollectionManager::local() {
 		if (_shouldQuit) {
 			return;
 		}
-		core::DynamicArray<io::FilesystemEntry> entities;
 		const core::String docs = _filesystem->specialDir(io::FilesystemDirectories::FS_Dir_Documents);
-		Log::info("Local document scanning (%s)...", docs.c_str());
+		const core::String &indexFile = _filesystem->writePath("local-collection.idx");
+		loadLocalIndex(indexFile);
+		// the files of the last scan are shown right away - the rescan only reports the differences
+		for (const auto &e : _localIndex.entries()) {
+			const LocalIndex::Entry &indexed = e->value;
+			if (indexed.format.empty() || !core::string::startsWith(indexed.fullPath, docs)) {
+				continue;
+			}
+			_newVoxelFiles.push(localVoxelFile(docs, indexed.fullPath));
+		}
+		Log::info("Local document scanning (%s) with %i indexed files...", docs.c_str(), (int)_localIndex.size());
+		core::DynamicArray<io::FilesystemEntry> entities;
 		_filesystem->list(docs, entities, "", 2);
 
+		int added = 0;
+		int modified = 0;
+		int removedFormat = 0;
 		for (const io::FilesystemEntry &entry : entities) {
 			if (_shouldQuit) {
 				return;
 			}
-			if (!io::isA(entry.name, voxelformat::voxelLoad())) {
+			if (entry.isDirectory()) {
+				continue;
+			}
+			core::String format;
+			if (_localIndex.validate(entry, format)) {
+				continue;
+			}
+			const io::FormatDescription *desc = io::getDescription(entry.name, 0, voxelformat::voxelLoad());
+			const LocalIndex::Change change = _localIndex.update(entry, desc != nullptr ? desc->name : "");
+			if (change == LocalIndex::Change::None) {
+				continue;
+			}
+			if (change == LocalIndex::Change::Removed) {
+				// the file was modified and isn't detected as voxel file anymore
+				_removedVoxelFiles.push(localVoxelFile(docs, entry.fullPath));
+				++removedFormat;
 				continue;
 			}
-			VoxelFile voxelFile;
-			voxelFile.name = entry.fullPath.substr(docs.size());
-			voxelFile.fullPath = entry.fullPath;
-			voxelFile.url = "file://" + entry.fullPath;
-			voxelFile.source = "local";
-			voxelFile.license = "unknown";
-			// voxelFile.licenseUrl = "";
-			// voxelFile.thumbnailUrl = "";
-			voxelFile.downloaded = true;
-			_newVoxelFiles.push(voxelFile);
+			if (change == LocalIndex::Change::Modified) {
+				// the voxel file is already part of the collection - but the thumbnail must get re-created
+				const VoxelFile &voxelFile = localVoxelFile(docs, entry.fullPath);
+				const core::String &thumbnailFile = _filesystem->writePath(voxelFile.targetFile() + ".png");
+				if (_filesystem->exists(thumbnailFile)) {
+					_filesystem->removeFile(thumbnailFile);
+				}
+				++modified;
+				continue;
+			}
+			_newVoxelFiles.push(localVoxelFile(docs, entry.fullPath));
+			++added;
 		}
+
+		core::DynamicArray<LocalIndex::Entry> removed;
+		_localIndex.removeUnseen(removed);
+		for (const LocalIndex::Entry &indexed : removed) {
+			if (indexed.format.empty() || !core::string::startsWith(indexed.fullPath, docs)) {
+				continue;
+			}
+			_removedVoxelFiles.push(localVoxelFile(docs, indexed.fullPath));
+		}
+		Log::info("Local document scan done: %i new, %i modified and %i removed files", added, modified,
+				  (int)removed.size() + removedFormat);
+		saveLocalIndex(indexFile);
 	});
 }
 
@@ -188,6 +272,26 @@ void CollectionManager::update(double nowSeconds, int n) {
 	VoxelFiles voxelFiles;
 	_newVoxelFiles.pop(voxelFiles, n);
 
+	// removals are only reported for files that were queued before - wait until they were added
+	if (voxelFiles.empty() && _newVoxelFiles.empty()) {
+		VoxelFiles removedVoxelFiles;
+		_removedVoxelFiles.popAll(removedVoxelFiles);
+		for (const VoxelFile &voxelFile : removedVoxelFiles) {
+			auto iter = _voxelFilesMap.find(voxelFile.source);
+			if (iter == _voxelFilesMap.end()) {
+				continue;
+			}
+			VoxelFiles &files = iter->value.files;
+			for (size_t i = 0; i < files.size(); ++i) {
+				if (files[i] == voxelFile) {
+					files.erase(i);
+					--_count;
+					break;
+				}
+			}
+		}
+	}
+
 	for (VoxelFile &voxelFile : voxelFiles) {
 		loadThumbnail(voxelFile);
 		auto iter = _voxelFilesMap.find(voxelFile.source);
@@ -12,6 +12,7 @@
 #include "video/Texture.h"
 #include "video/TexturePool.h"
 #include "voxelcollection/Downloader.h"
+#include "voxelcollection/LocalIndex.h"
 #include <future>
 
 namespace voxelcollection {
@@ -20,6 +21,7 @@ class CollectionManager : public core::IComponent {
 private:
 	io::FilesystemPtr _filesystem;
 	core::ConcurrentQueue<VoxelFile> _newVoxelFiles;
+	core::ConcurrentQueue<VoxelFile> _removedVoxelFiles;
 	VoxelFileMap _voxelFilesMap;
 
 	core::ConcurrentQueue<image::ImagePtr> _imageQueue;
@@ -30,6 +32,14 @@ private:
 	int _count = 0;
 
 	std::future<void> _local;
+	/**
+	 * @brief Only accessed by the local scanning task
+	 */
+	LocalIndex _localIndex;
+
+	VoxelFile localVoxelFile(const core::String &docs, const core::String &fullPath) const;
+	void loadLocalIndex(const core::String &indexFile);
+	void saveLocalIndex(const core::String &indexFile);
 
 	core::StringSet _onlineResolvedSources;
 	std::future<VoxelFiles> _onlineResolve;
@@ -47,6 +57,10 @@ public:
 	void update(double nowSeconds, int n = 100);
 	void shutdown() override;
 
+	/**
+	 * @brief Populates the local collection from the persisted index and rescans the documents directory in the
+	 * background. Only new, modified and removed files are reported by the rescan.
+	 */
 	void local();
 	void online(bool resolve = true);
 	void resolve(const VoxelSource &source);
@@ -0,0 +1,122 @@
+/**
+ * @file
+ */
+
+#include "LocalIndex.h"
+#include "core/FourCC.h"
+#include "core/Log.h"
+#include "io/FilesystemEntry.h"
+#include "io/Stream.h"
+
+namespace voxelcollection {
+
+static const uint32_t IndexMagic = FourCC('V', 'C', 'L', 'I');
+static const uint32_t IndexVersion = 1u;
+
+bool LocalIndex::load(io::ReadStream &stream) {
+	_entries.clear();
+	_dirty = false;
+	uint32_t magic = 0u;
+	uint32_t version = 0u;
+	uint32_t count = 0u;
+	if (stream.readUInt32(magic) != 0 || magic != IndexMagic) {
+		Log::warn("Invalid local collection index");
+		return false;
+	}
+	if (stream.readUInt32(version) != 0 || version != IndexVersion) {
+		Log::info("Local collection index version %u is outdated", version);
+		return false;
+	}
+	if (stream.readUInt32(count) != 0) {
+		return false;
+	}
+	for (uint32_t i = 0u; i < count; ++i) {
+		Entry entry;
+		if (!stream.readPascalStringUInt16LE(entry.fullPath) || stream.readUInt64(entry.size) != 0 ||
+			stream.readUInt64(entry.mtime) != 0 || !stream.readPascalStringUInt8(entry.format)) {
+			Log::warn("Failed to read local collection index entry %u of %u", i, count);
+			_entries.clear();
+			return false;
+		}
+		_entries.put(entry.fullPath, entry);
+	}
+	Log::debug("Loaded %u entries from the local collection index", count);
+	return true;
+}
+
+bool LocalIndex::save(io::WriteStream &stream) {
+	if (!stream.writeUInt32(IndexMagic) || !stream.writeUInt32(IndexVersion) ||
+		!stream.writeUInt32((uint32_t)_entries.size())) {
+		return false;
+	}
+	for (const auto &e : _entries) {
+		const Entry &entry = e->value;
+		if (!stream.writePascalStringUInt16LE(entry.fullPath) || !stream.writeUInt64(entry.size) ||
+			!stream.writeUInt64(entry.mtime) || !stream.writePascalStringUInt8(entry.format)) {
+			return false;
+		}
+	}
+	_dirty = false;
+	return true;
+}
+
+bool LocalIndex::validate(const io::FilesystemEntry &entry, core::String &format) {
+	auto iter = _entries.find(entry.fullPath);
+	if (iter == _entries.end()) {
+		return false;
+	}
+	Entry &indexed = iter->value;
+	indexed.seen = true;
+	if (indexed.size != entry.size || indexed.mtime != entry.mtime) {
+		return false;
+	}
+	format = indexed.format;
+	return true;
+}
+
+bool LocalIndex::has(const core::String &fullPath) const {
+	return _entries.hasKey(fullPath);
+}
+
+void LocalIndex::put(const io::FilesystemEntry &entry, const core::String &format) {
+	Entry indexed;
+	indexed.fullPath = entry.fullPath;
+	indexed.size = entry.size;
+	indexed.mtime = entry.mtime;
+	indexed.format = format;
+	indexed.seen = true;
+	_entries.put(indexed.fullPath, indexed);
+	_dirty = true;
+}
+
+LocalIndex::Change LocalIndex::update(const io::FilesystemEntry &entry, const core::String &format) {
+	bool wasVoxelFile = false;
+	auto iter = _entries.find(entry.fullPath);
+	if (iter != _entries.end()) {
+		wasVoxelFile = !iter->value.format.empty();
+	}
+	put(entry, format);
+	if (format.empty()) {
+		return wasVoxelFile ? Change::Removed : Change::None;
+	}
+	return wasVoxelFile ? Change::Modified : Change::Added;
+}
+
+void LocalIndex::removeUnseen(core::DynamicArray<Entry> &removed) {
+	for (auto e : _entries) {
+		Entry &entry = e->value;
+		if (entry.seen) {
+			entry.seen = false;
+			continue;
+		}
+		removed.push_back(entry);
+	}
+	for (const Entry &entry : removed) {
+		_entries.remove(entry.fullPath);
+	}
+	if (!removed.empty()) {
+		_dirty = true;
+	}
+}
+
+} // namespace voxelcollection
@@ -0,0 +1,100 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/String.h"
+#include "core/collection/DynamicArray.h"
+#include "core/collection/DynamicStringMap.h"
+
+namespace io {
+struct FilesystemEntry;
+class ReadStream;
+class WriteStream;
+} // namespace io
+
+namespace voxelcollection {
+
+/**
+ * @brief Persistent index of the local files that were found in previous scans
+ *
+ * The files are identified by their full path and validated by size and modification time. This allows to populate
+ * the local collection without detecting the format of every file again and to only report the differences of a
+ * rescan.
+ */
+class LocalIndex {
+public:
+	struct Entry {
+		core::String fullPath;
+		uint64_t size = 0u;
+		uint64_t mtime = 0u;
+		/**
+		 * @brief The name of the detected voxel format - empty if the file is not a supported voxel format
+		 */
+		core::String format;
+		/**
+		 * @brief Transient marker for @c removeUnseen() - not persisted
+		 */
+		bool seen = false;
+	};
+	using Entries = core::DynamicStringMap<Entry, 4096>;
+
+	/**
+	 * @brief How a rescanned file changed for the collection
+	 * @sa update()
+	 */
+	enum class Change { None, Added, Modified, Removed };
+
+private:
+	Entries _entries;
+	bool _dirty = false;
+
+public:
+	bool load(io::ReadStream &stream);
+	bool save(io::WriteStream &stream);
+
+	/**
+	 * @brief Checks whether the given file is indexed with the same size and modification time
+	 * @param[out] format The name of the indexed format
+	 * @return @c false if the file isn't known or was modified since it was indexed
+	 */
+	bool validate(const io::FilesystemEntry &entry, core::String &format);
+	/**
+	 * @return @c true if the given path is part of the index - regardless of its state on disc
+	 */
+	bool has(const core::String &fullPath) const;
+	void put(const io::FilesystemEntry &entry, const core::String &format);
+	/**
+	 * @brief Puts a file that failed the validation into the index
+	 * @param format The name of the detected voxel format - empty if the file is not a supported voxel format
+	 * @return @c Change::Removed if the file was a voxel file before, but its format isn't detected anymore
+	 */
+	Change update(const io::FilesystemEntry &entry, const core::String &format);
+	/**
+	 * @brief Removes all entries that were neither validated nor put since the last call of this function
+	 * @param[out] removed The entries that were removed
+	 */
+	void removeUnseen(core::DynamicArray<Entry> &removed);
+
+	const Entries &entries() const;
+	size_t size() const;
+	/**
+	 * @return @c true if the index was modified since it was loaded or saved
+	 */
+	bool dirty() const;
+};
+
+inline const LocalIndex::Entries &LocalIndex::entries() const {
+	return _entries;
+}
+
+inline size_t LocalIndex::size() const {
+	return _entries.size();
+}
+
+inline bool LocalIndex::dirty() const {
+	return _dirty;
+}
+
+} // namespace voxelcollection
@@ -0,0 +1,106 @@
+/**
+ * @file
+ */
+
+#include "voxelcollection/LocalIndex.h"
+#include "app/tests/AbstractTest.h"
+#include "io/BufferedReadWriteStream.h"
+#include "io/FilesystemEntry.h"
+
+namespace voxelcollection {
+
+class LocalIndexTest : public app::AbstractTest {
+protected:
+	io::FilesystemEntry entry(const core::String &fullPath, uint64_t size, uint64_t mtime) const {
+		io::FilesystemEntry e;
+		e.fullPath = fullPath;
+		e.name = fullPath;
+		e.type = io::FilesystemEntry::Type::file;
+		e.size = size;
+		e.mtime = mtime;
+		return e;
+	}
+};
+
+TEST_F(LocalIndexTest, testSaveLoad) {
+	LocalIndex index;
+	index.put(entry("/docs/a.vox", 100u, 1000u), "MagicaVoxel");
+	index.put(entry("/docs/readme.txt", 10u, 2000u), "");
+	EXPECT_TRUE(index.dirty());
+	io::BufferedReadWriteStream stream;
+	ASSERT_TRUE(index.save(stream));
+	EXPECT_FALSE(index.dirty());
+
+	stream.seek(0);
+	LocalIndex loaded;
+	ASSERT_TRUE(loaded.load(stream));
+	ASSERT_EQ(2u, loaded.size());
+	EXPECT_FALSE(loaded.dirty());
+	core::String format;
+	EXPECT_TRUE(loaded.validate(entry("/docs/a.vox", 100u, 1000u), format));
+	EXPECT_EQ("MagicaVoxel", format);
+	EXPECT_TRUE(loaded.validate(entry("/docs/readme.txt", 10u, 2000u), format));
+	EXPECT_EQ("", format);
+}
+
+TEST_F(LocalIndexTest, testValidate) {
+	LocalIndex index;
+	index.put(entry("/docs/a.vox", 100u, 1000u), "MagicaVoxel");
+	core::String format;
+	EXPECT_FALSE(index.validate(entry("/docs/a.vox", 100u, 1001u), format)) << "modification time changed";
+	EXPECT_FALSE(index.validate(entry("/docs/a.vox", 101u, 1000u), format)) << "size changed";
+	EXPECT_FALSE(index.validate(entry("/docs/b.vox", 100u, 1000u), format)) << "not indexed";
+	EXPECT_TRUE(index.has("/docs/a.vox"));
+	EXPECT_FALSE(index.has("/docs/b.vox"));
+}
+
+TEST_F(LocalIndexTest, testRemoveUnseen) {
+	LocalIndex index;
+	index.put(entry("/docs/a.vox", 1u, 1u), "MagicaVoxel");
+	index.put(entry("/docs/b.vox", 1u, 1u), "MagicaVoxel");
+	core::DynamicArray<LocalIndex::Entry> removed;
+	index.removeUnseen(removed);
+	EXPECT_TRUE(removed.empty()) << "Entries that were put are seen";
+
+	// rescan that only finds one of the files
+	core::String format;
+	EXPECT_TRUE(index.validate(entry("/docs/b.vox", 1u, 1u), format));
+	index.removeUnseen(removed);
+	ASSERT_EQ(1u, removed.size());
+	EXPECT_EQ("/docs/a.vox", removed[0].fullPath);
+	EXPECT_EQ(1u, index.size());
+}
+
+TEST_F(LocalIndexTest, testUpdate) {
+	LocalIndex index;
+	EXPECT_EQ(LocalIndex::Change::Added, index.update(entry("/docs/a.vox", 1u, 1u), "MagicaVoxel"));
+	EXPECT_EQ(LocalIndex::Change::None, index.update(entry("/docs/b.txt", 1u, 1u), ""));
+	EXPECT_EQ(LocalIndex::Change::Modified, index.update(entry("/docs/a.vox", 2u, 2u), "MagicaVoxel"));
+	EXPECT_EQ(LocalIndex::Change::Added, index.update(entry("/docs/b.txt", 2u, 2u), "Qubicle Binary"))
+		<< "A file that wasn't detected before is new to the collection";
+}
+
+TEST_F(LocalIndexTest, testUpdateFormatNotDetectedAnymore) {
+	LocalIndex index;
+	index.put(entry("/docs/a.vox", 1u, 1u), "MagicaVoxel");
+	EXPECT_EQ(LocalIndex::Change::Removed, index.update(entry("/docs/a.vox", 2u, 2u), ""));
+	ASSERT_TRUE(index.has("/docs/a.vox")) << "The file is still indexed to not detect it again";
+	core::String format = "invalid";
+	EXPECT_TRUE(index.validate(entry("/docs/a.vox", 2u, 2u), format));
+	EXPECT_EQ("", format);
+	core::DynamicArray<LocalIndex::Entry> removed;
+	index.removeUnseen(removed);
+	EXPECT_TRUE(removed.empty());
+	EXPECT_EQ(LocalIndex::Change::None, index.update(entry("/docs/a.vox", 3u, 3u), ""));
+}
+
+TEST_F(LocalIndexTest, testLoadInvalid) {
+	io::BufferedReadWriteStream stream;
+	stream.writeUInt32(0u);
+	stream.seek(0);
+	LocalIndex index;
+	EXPECT_FALSE(index.load(stream));
+	EXPECT_EQ(0u, index.size());
+}
+
+} // namespace voxelcollection
@@ -5,12 +5,15 @@
 #include "Format.h"
 #include "VolumeFormat.h"
 #include "app/App.h"
+#include "app/Async.h"
 #include "core/Color.h"
 #include "core/Common.h"
 #include "core/Log.h"
 #include "core/StringUtil.h"
 #include "core/Var.h"
+#include "core/collection/Buffer.h"
 #include "core/collection/DynamicArray.h"
+#include "core/concurrent/Atomic.h"
 #include "image/Image.h"
 #include "io/Archive.h"
 #include "math/Math.h"
@@ -188,10 +191,44 @@ bool Format::load(const core::String &filename, const io::ArchivePtr &archive, s
 	return true;
 }
 
+bool LoadContext::streamNodes(scenegraph::SceneGraph &sceneGraph) const {
+	if (!flush || memoryLimit == 0u) {
+		return true;
+	}
+	size_t bytes = 0u;
+	for (auto iter = sceneGraph.beginModel(); iter != sceneGraph.end(); ++iter) {
+		const voxel::RawVolume *volume = (*iter).volume();
+		if (volume != nullptr) {
+			bytes += voxel::RawVolume::size(volume->region());
+		}
+	}
+	if (bytes < memoryLimit) {
+		return true;
+	}
+	Log::debug("Flush %i models with %" PRIu64 " bytes of voxel data",
+			   (int)sceneGraph.size(scenegraph::SceneGraphNodeType::Model), (uint64_t)bytes);
+	sceneGraph.updateTransforms();
+	++flushed;
+	return flush(sceneGraph);
+}
+
 bool Format::stopExecution() {
 	return app::App::getInstance()->shouldQuit();
 }
 
+bool Format::decodeVolumes(VolumeDecodeJobs &jobs) {
+	core::AtomicBool failed(false);
+	app::for_parallel(0, (int)jobs.size(), [&jobs, &failed](int start, int end) {
+		for (int i = start; i < end; ++i) {
+			if (!jobs[i]()) {
+				failed = true;
+			}
+		}
+	});
+	jobs.clear();
+	return !failed;
+}
+
 bool PaletteFormat::loadGroups(const core::String &filename, const io::ArchivePtr &archive,
 							   scenegraph::SceneGraph &sceneGraph, const LoadContext &ctx) {
 	palette::Palette palette;
@@ -8,12 +8,15 @@
 
 #pragma once
 
+#include "core/collection/DynamicArray.h"
 #include "core/collection/DynamicMap.h"
 #include "image/Image.h"
 #include "io/Archive.h"
 #include "io/Stream.h"
+#include "palette/ColorHistogram.h"
 #include "voxel/RawVolume.h"
 #include "voxelformat/FormatThumbnail.h"
+#include <functional>
 #include <glm/fwd.hpp>
 
 namespace palette {
@@ -31,18 +34,55 @@ class SceneGraphNode;
 
 namespace voxelformat {
 
-using RGBAMap = core::DynamicMap<core::RGBA, bool, 1031, core::RGBAHasher>;
+/**
+ * @brief Color histogram - the value is the amount of pixels or voxels with the color
+ * @sa palette::addColor()
+ * @sa palette::Palette::quantize()
+ */
+using RGBAMap = palette::ColorHistogram;
 
 typedef void (*ProgressMonitor)(const char *name, int cur, int max);
+/**
+ * @brief Callback that receives the model nodes of a scene graph that is still loading. The callback has to remove
+ * the model nodes that it consumed from the scene graph.
+ * @return @c false if the nodes could not get processed - this aborts the loading
+ * @sa LoadContext::streamNodes()
+ */
+typedef std::function<bool(scenegraph::SceneGraph &sceneGraph)> NodeFlushCallback;
+
+/**
+ * @brief Decodes the voxel payload of a single model into the volume of its node
+ * @return @c false if the payload is invalid
+ * @sa Format::decodeVolumes()
+ */
+typedef std::function<bool()> VolumeDecodeJob;
+using VolumeDecodeJobs = core::DynamicArray<VolumeDecodeJob>;
 
 struct LoadContext {
 	ProgressMonitor monitor = nullptr;
+	/**
+	 * Formats that are able to produce their models in pieces (e.g. minecraft regions) hand over the already
+	 * loaded model nodes to this callback whenever the volumes of the scene graph exceed the @c memoryLimit
+	 */
+	NodeFlushCallback flush;
+	/** the amount of voxel memory in bytes that may be kept in the scene graph before the nodes are flushed */
+	size_t memoryLimit = 0;
+	/** the amount of flush callback invocations */
+	mutable int flushed = 0;
+
 	inline void progress(const char *name, int cur, int max) const {
 		if (monitor == nullptr) {
 			return;
 		}
 		monitor(name, cur, max);
 	}
+
+	/**
+	 * @brief Called by streaming capable formats after they added model nodes to the scene graph. Hands the model
+	 * nodes over to the @c flush callback if the memory limit is exceeded.
+	 * @return @c false if the flush callback failed
+	 */
+	bool streamNodes(scenegraph::SceneGraph &sceneGraph) const;
 };
 struct SaveContext {
 	ProgressMonitor monitor = nullptr;
@@ -112,6 +152,17 @@ protected:
 	 */
 	static bool stopExecution();
 
+	/**
+	 * @brief Runs the given jobs on the thread pool and waits for them to finish
+	 *
+	 * Formats with many independent models parse the structure of the file sequentially and add the model nodes
+	 * with their still empty volumes to the scene graph - this keeps the node order deterministic. The voxel payloads
+	 * are only copied and decoded afterwards - in parallel. A job may only touch the volume of its own node.
+	 *
+	 * @return @c false if one of the jobs failed
+	 */
+	static bool decodeVolumes(VolumeDecodeJobs &jobs);
+
 	static core::String stringProperty(const scenegraph::SceneGraphNode *node, const core::String &name,
 									   const core::String &defaultVal = "");
 	static bool boolProperty(const scenegraph::SceneGraphNode *node, const core::String &name, bool defaultVal = false);
@@ -94,6 +94,10 @@ bool FormatConfig::init() {
 				   core::Var::boolValidator);
 	core::Var::get(cfg::VoxFormatGLTF_KHR_materials_specular, "false", core::CV_NOPERSIST,
 				   "Apply KHR_materials_specular when saving into the gltf format", core::Var::boolValidator);
+	core::Var::get(cfg::VoxFormatGLTF_KHR_mesh_quantization, "false", core::CV_NOPERSIST,
+				   "Apply KHR_mesh_quantization when saving into the gltf format", core::Var::boolValidator);
+	core::Var::get(cfg::VoxFormatGLTF_EXT_meshopt_compression, "false", core::CV_NOPERSIST,
+				   "Apply EXT_meshopt_compression when saving into the glb format", core::Var::boolValidator);
 	core::Var::get(cfg::VoxFormatWithMaterials, "true", core::CV_NOPERSIST,
 				   "Try to export material properties if the formats support it", core::Var::boolValidator);
 	return true;
@@ -595,6 +595,7 @@ bool loadFormat(const io::FileDescription &fileDesc, const io::ArchivePtr &archi
 		if (!f->load(filename, archive, newSceneGraph, ctx)) {
 			Log::error("Error while loading %s", filename.c_str());
 			newSceneGraph.clear();
+			return false;
 		}
 	} else {
 		Log::error("Failed to load model file %s - unsupported "
@@ -604,7 +605,7 @@ bool loadFormat(const io::FileDescription &fileDesc, const io::ArchivePtr &archi
 	}
 	const int models = (int)newSceneGraph.size(scenegraph::SceneGraphNodeType::Model);
 	const int points = (int)newSceneGraph.size(scenegraph::SceneGraphNodeType::Point);
-	if (models == 0 && points == 0) {
+	if (models == 0 && points == 0 && ctx.flushed == 0) {
 		Log::error("Failed to load model file %s. Scene graph "
 				"doesn't contain models.",
 				filename.c_str());
@@ -3,9 +3,12 @@
  */
 
 #include "AoSVXLFormat.h"
+#include "app/Async.h"
 #include "core/Log.h"
 #include "core/ScopedPtr.h"
+#include "core/Trace.h"
 #include "core/collection/DynamicMap.h"
+#include "core/concurrent/Lock.h"
 #include "scenegraph/SceneGraph.h"
 #include "scenegraph/SceneGraphNode.h"
 #include "palette/Palette.h"
@@ -135,28 +138,28 @@ size_t AoSVXLFormat::loadPalette(const core::String &filename, const io::Archive
 	}
 
 	RGBAMap colors;
-	for (int x = 0; x < (int)mapSize; x++) {
-		for (int y = 0; y < (int)mapSize; y++) {
-			for (int z = 0; z < (int)mapHeight; z++) {
-				if (!libvxl_map_issolid(&map, x, y, z)) {
-					continue;
+	core_trace_mutex(core::Lock, lock, "AoSVXLPalette");
+	// the map is only read - every thread counts the colors of its own columns
+	app::for_parallel(0, (int)mapSize, [&](int start, int end) {
+		RGBAMap local;
+		for (int x = start; x < end; x++) {
+			for (int y = 0; y < (int)mapSize; y++) {
+				for (int z = 0; z < (int)mapHeight; z++) {
+					if (!libvxl_map_issolid(&map, x, y, z)) {
+						continue;
+					}
+					const uint32_t color = libvxl_map_get(&map, x, y, z);
+					palette::addColor(local, flattenRGB(vxl_red(color), vxl_green(color), vxl_blue(color)));
 				}
-				const uint32_t color = libvxl_map_get(&map, x, y, z);
-				const core::RGBA rgba = flattenRGB(vxl_red(color), vxl_green(color), vxl_blue(color));
-				colors.put(rgba, true);
 			}
 		}
-	}
+		core::ScopedLock scoped(lock);
+		palette::addColors(colors, local);
+	});
 	libvxl_free(&map);
 	core_free(data);
 
-	const size_t colorCount = colors.size();
-	core::Buffer<core::RGBA> colorBuffer;
-	colorBuffer.reserve(colorCount);
-	for (const auto &e : colors) {
-		colorBuffer.push_back(e->first);
-	}
-	palette.quantize(colorBuffer.data(), colorBuffer.size());
+	palette.quantize(colors);
 	return palette.size();
 }
 
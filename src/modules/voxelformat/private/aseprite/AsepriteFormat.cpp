@@ -54,13 +54,18 @@ static ase_t *loadAseprite(const core::String &filename, const io::ArchivePtr &a
 		return nullptr;
 	}
 	const size_t size = stream->size();
-	core::Buffer<uint8_t> buffer(size);
-	if (stream->read(buffer.data(), size) != (int)size) {
-		Log::error("Failed to read file '%s'", filename.c_str());
-		return nullptr;
+	const uint8_t *data = stream->data();
+	core::Buffer<uint8_t> buffer;
+	if (data == nullptr) {
+		buffer.resize(size);
+		if (stream->read(buffer.data(), size) != (int)size) {
+			Log::error("Failed to read file '%s'", filename.c_str());
+			return nullptr;
+		}
+		data = buffer.data();
 	}
 
-	ase_t *ase = cute_aseprite_load_from_memory(buffer.data(), buffer.size(), nullptr);
+	ase_t *ase = cute_aseprite_load_from_memory(data, (int)size, nullptr);
 	if (ase == nullptr) {
 		Log::error("Failed to load Aseprite file '%s'", filename.c_str());
 		return nullptr;
@@ -40,18 +40,24 @@ size_t VoxFormat::loadPalette(const core::String &filename, const io::ArchivePtr
 		return 0;
 	}
 	const size_t size = stream->size();
-	uint8_t *buffer = (uint8_t *)core_malloc(size);
-	if (stream->read(buffer, size) == -1) {
-		core_free(buffer);
-		return 0;
+	const uint8_t *data = stream->data();
+	uint8_t *buffer = nullptr;
+	if (data == nullptr) {
+		buffer = (uint8_t *)core_malloc(size);
+		if (stream->read(buffer, size) == -1) {
+			core_free(buffer);
+			return 0;
+		}
+		data = buffer;
 	}
-	loadPaletteFromBuffer(buffer, size, palette);
+	loadPaletteFromBuffer(data, size, palette);
 	core_free(buffer);
 	return palette.colorCount();
 }
 
 bool VoxFormat::loadInstance(const ogt_vox_scene *scene, uint32_t ogt_instanceIdx, scenegraph::SceneGraph &sceneGraph,
-							 int parent, core::DynamicArray<MVModelToNode> &models, const palette::Palette &palette) {
+							 int parent, core::DynamicArray<MVModelToNode> &models, const palette::Palette &palette,
+							 VolumeDecodeJobs &jobs) {
 	const ogt_vox_instance &ogtInstance = scene->instances[ogt_instanceIdx];
 	const ogt_vox_model *ogtModel = scene->models[ogtInstance.model_index];
 	const glm::mat4 &ogtMat = ogtTransformToMat(ogtInstance, 0, scene, ogtModel);
@@ -66,20 +72,24 @@ bool VoxFormat::loadInstance(const ogt_vox_scene *scene, uint32_t ogt_instanceId
 	scenegraph::SceneGraphTransform transform;
 	transform.setWorldTranslation(shift);
 
-	const uint8_t *ogtVoxel = ogtModel->voxel_data;
-	for (uint32_t k = 0; k < ogtModel->size_z; ++k) {
-		for (uint32_t j = 0; j < ogtModel->size_y; ++j) {
-			for (uint32_t i = 0; i < ogtModel->size_x; ++i, ++ogtVoxel) {
-				if (ogtVoxel[0] == 0) {
-					continue;
+	// the scene is alive until all jobs are done
+	jobs.emplace_back([ogtModel, ogtMat, shift, v, &palette]() {
+		const uint8_t *ogtVoxel = ogtModel->voxel_data;
+		for (uint32_t k = 0; k < ogtModel->size_z; ++k) {
+			for (uint32_t j = 0; j < ogtModel->size_y; ++j) {
+				for (uint32_t i = 0; i < ogtModel->size_x; ++i, ++ogtVoxel) {
+					if (ogtVoxel[0] == 0) {
+						continue;
+					}
+					const voxel::Voxel voxel = voxel::createVoxel(palette, ogtVoxel[0] - 1);
+					const glm::ivec3 &ogtPos = calcTransform(ogtMat, glm::vec3(i, j, k));
+					const glm::ivec3 pos(-(ogtPos.x + 1), ogtPos.z, ogtPos.y);
+					v->setVoxel(pos - shift, voxel);
 				}
-				const voxel::Voxel voxel = voxel::createVoxel(palette, ogtVoxel[0] - 1);
-				const glm::ivec3 &ogtPos = calcTransform(ogtMat, glm::vec3(i, j, k));
-				const glm::ivec3 pos(-(ogtPos.x + 1), ogtPos.z, ogtPos.y);
-				v->setVoxel(pos - shift, voxel);
 			}
 		}
-	}
+		return true;
+	});
 
 	scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
 	loadKeyFrames(sceneGraph, node, ogtInstance, scene);
@@ -108,7 +118,7 @@ bool VoxFormat::loadInstance(const ogt_vox_scene *scene, uint32_t ogt_instanceId
 
 bool VoxFormat::loadGroup(const ogt_vox_scene *scene, uint32_t ogt_groupIdx, scenegraph::SceneGraph &sceneGraph,
 						  int parent, core::DynamicArray<MVModelToNode> &models, core::Set<uint32_t> &addedInstances,
-						  const palette::Palette &palette) {
+						  const palette::Palette &palette, VolumeDecodeJobs &jobs) {
 	const ogt_vox_group &ogt_group = scene->groups[ogt_groupIdx];
 	bool hidden = ogt_group.hidden;
 	const char *name = ogt_group.name ? ogt_group.name : "Group";
@@ -138,7 +148,7 @@ bool VoxFormat::loadGroup(const ogt_vox_scene *scene, uint32_t ogt_groupIdx, sce
 			continue;
 		}
 		Log::debug("Found matching group (%u) with scene graph parent: %i", groupIdx, groupId);
-		if (!loadGroup(scene, groupIdx, sceneGraph, groupId, models, addedInstances, palette)) {
+		if (!loadGroup(scene, groupIdx, sceneGraph, groupId, models, addedInstances, palette, jobs)) {
 			return false;
 		}
 	}
@@ -151,7 +161,7 @@ bool VoxFormat::loadGroup(const ogt_vox_scene *scene, uint32_t ogt_groupIdx, sce
 		if (!addedInstances.insert(n)) {
 			continue;
 		}
-		if (!loadInstance(scene, n, sceneGraph, groupId, models, palette)) {
+		if (!loadInstance(scene, n, sceneGraph, groupId, models, palette, jobs)) {
 			return false;
 		}
 	}
@@ -167,15 +177,21 @@ bool VoxFormat::loadGroupsPalette(const core::String &filename, const io::Archiv
 		return 0;
 	}
 	const size_t size = stream->size();
-	uint8_t *buffer = (uint8_t *)core_malloc(size);
-	if (stream->read(buffer, size) == -1) {
-		core_free(buffer);
-		return false;
+	// no need to copy the file content if the stream is memory based already
+	const uint8_t *data = stream->data();
+	uint8_t *buffer = nullptr;
+	if (data == nullptr) {
+		buffer = (uint8_t *)core_malloc(size);
+		if (stream->read(buffer, size) == -1) {
+			core_free(buffer);
+			return false;
+		}
+		data = buffer;
 	}
 	const uint32_t ogt_vox_flags = k_read_scene_flags_keyframes | k_read_scene_flags_groups |
 								   k_read_scene_flags_keep_empty_models_instances |
 								   k_read_scene_flags_keep_duplicate_models;
-	const ogt_vox_scene *scene = ogt_vox_read_scene_with_flags(buffer, (uint32_t)size, ogt_vox_flags);
+	const ogt_vox_scene *scene = ogt_vox_read_scene_with_flags(data, (uint32_t)size, ogt_vox_flags);
 	core_free(buffer);
 	if (scene == nullptr) {
 		Log::error("Could not load scene %s", filename.c_str());
@@ -205,6 +221,7 @@ bool VoxFormat::loadScene(const ogt_vox_scene *scene, scenegraph::SceneGraph &sc
 						  const palette::Palette &palette) {
 	core::DynamicArray<MVModelToNode> models = loadModels(scene, palette);
 	core::Set<uint32_t> addedInstances;
+	VolumeDecodeJobs jobs;
 	for (uint32_t i = 0; i < scene->num_groups; ++i) {
 		const ogt_vox_group &group = scene->groups[i];
 		// find the main group nodes
@@ -212,7 +229,7 @@ bool VoxFormat::loadScene(const ogt_vox_scene *scene, scenegraph::SceneGraph &sc
 			continue;
 		}
 		Log::debug("Add root group %u/%u", i, scene->num_groups);
-		if (!loadGroup(scene, i, sceneGraph, -1, models, addedInstances, palette)) {
+		if (!loadGroup(scene, i, sceneGraph, -1, models, addedInstances, palette, jobs)) {
 			return false;
 		}
 		break;
@@ -222,10 +239,13 @@ bool VoxFormat::loadScene(const ogt_vox_scene *scene, scenegraph::SceneGraph &sc
 			continue;
 		}
 		// TODO: the parent is wrong
-		if (!loadInstance(scene, n, sceneGraph, sceneGraph.root().id(), models, palette)) {
+		if (!loadInstance(scene, n, sceneGraph, sceneGraph.root().id(), models, palette, jobs)) {
 			return false;
 		}
 	}
+	if (!decodeVolumes(jobs)) {
+		return false;
+	}
 	if (scene->num_instances == 0 && scene->num_models > 0) {
 		for (MVModelToNode &m : models) {
 			scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
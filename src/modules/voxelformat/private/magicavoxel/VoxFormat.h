@@ -34,10 +34,11 @@ private:
 					 uint32_t parentGroupIdx, uint32_t layerIdx, uint32_t modelIdx);
 	bool loadScene(const ogt_vox_scene *scene, scenegraph::SceneGraph &sceneGraph, const palette::Palette &palette);
 	bool loadInstance(const ogt_vox_scene *scene, uint32_t ogt_instanceIdx, scenegraph::SceneGraph &sceneGraph,
-					  int parent, core::DynamicArray<MVModelToNode> &models, const palette::Palette &palette);
+					  int parent, core::DynamicArray<MVModelToNode> &models, const palette::Palette &palette,
+					  VolumeDecodeJobs &jobs);
 	bool loadGroup(const ogt_vox_scene *scene, uint32_t ogt_parentGroupIdx, scenegraph::SceneGraph &sceneGraph,
 				   int parent, core::DynamicArray<MVModelToNode> &models, core::Set<uint32_t> &addedInstances,
-				   const palette::Palette &palette);
+				   const palette::Palette &palette, VolumeDecodeJobs &jobs);
 	bool loadGroupsPalette(const core::String &filename, const io::ArchivePtr &archive,
 						   scenegraph::SceneGraph &sceneGraph, palette::Palette &palette,
 						   const LoadContext &ctx) override;
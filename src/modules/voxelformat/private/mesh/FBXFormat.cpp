@@ -80,9 +80,8 @@ bool FBXFormat::saveMeshesAscii(const Meshes &meshes, const core::String &filena
 								const scenegraph::SceneGraph &sceneGraph) {
 	int meshCount = 0;
 	for (const MeshExt &meshExt : meshes) {
-		for (int i = 0; i < 2; ++i) {
-			const voxel::Mesh *mesh = &meshExt.mesh->mesh[i];
-			if (mesh->isEmpty()) {
+		for (int i = 0; i < voxel::ChunkMesh::Meshes; ++i) {
+			if (meshExt.isEmpty(i)) {
 				continue;
 			}
 			++meshCount;
@@ -122,8 +121,10 @@ Objects: {
 	// https://github.com/libgdx/fbx-conv/blob/master/samples/blender/cube.fbx
 
 	for (const MeshExt &meshExt : meshes) {
+		voxel::ChunkMesh unpacked(0, 0);
+		const voxel::ChunkMesh &chunkMesh = meshExt.unpack(unpacked);
 		for (int i = 0; i < voxel::ChunkMesh::Meshes; ++i) {
-			const voxel::Mesh *mesh = &meshExt.mesh->mesh[i];
+			const voxel::Mesh *mesh = &chunkMesh.mesh[i];
 			if (mesh->isEmpty()) {
 				continue;
 			}
@@ -506,7 +507,12 @@ bool FBXFormat::voxelizeGroups(const core::String &filename, const io::ArchivePt
 
 	ufbx_error ufbxerror;
 
-	ufbx_scene *ufbxscene = ufbx_load_stream(&ufbxstream, &ufbxopts, &ufbxerror);
+	ufbx_scene *ufbxscene;
+	if (const uint8_t *data = stream->data()) {
+		ufbxscene = ufbx_load_memory(data, (size_t)stream->size(), &ufbxopts, &ufbxerror);
+	} else {
+		ufbxscene = ufbx_load_stream(&ufbxstream, &ufbxopts, &ufbxerror);
+	}
 	if (!ufbxscene) {
 		Log::error("Failed to load: %s", ufbxerror.description.data);
 		return false;
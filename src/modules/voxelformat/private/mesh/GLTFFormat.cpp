@@ -4,6 +4,7 @@
 
 #include "GLTFFormat.h"
 #include "app/App.h"
+#include "app/Async.h"
 #include "core/Color.h"
 #include "core/FourCC.h"
 #include "core/GameConfig.h"
@@ -17,6 +18,7 @@
 #include "engine-config.h"
 #include "image/Image.h"
 #include "io/BufferedReadWriteStream.h"
+#include "io/BufferedWriteStream.h"
 #include "io/MemoryReadStream.h"
 #include "io/StdStreamBuf.h"
 #include "io/Stream.h"
@@ -32,6 +34,9 @@
 #include <glm/gtc/quaternion.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <limits.h>
+#include <sstream>
+
+#include "meshoptimizer.h"
 
 #define TINYGLTF_IMPLEMENTATION
 // #define TINYGLTF_NO_FS // TODO: use our own file abstraction
@@ -44,6 +49,10 @@ namespace _priv {
 
 const float FPS = 24.0f;
 
+static inline size_t align4(size_t size) {
+	return (size + 3u) & ~(size_t)3u;
+}
+
 static int addBuffer(tinygltf::Model &gltfModel, io::BufferedReadWriteStream &stream, const char *name) {
 	tinygltf::Buffer gltfBuffer;
 	gltfBuffer.name = name;
@@ -52,6 +61,50 @@ static int addBuffer(tinygltf::Model &gltfModel, io::BufferedReadWriteStream &st
 	return (int)(gltfModel.buffers.size() - 1);
 }
 
+// KHR_mesh_quantization allows integer types for the positions and texture coordinates
+static bool isSupportedComponentType(int componentType) {
+	switch (componentType) {
+	case TINYGLTF_COMPONENT_TYPE_FLOAT:
+	case TINYGLTF_COMPONENT_TYPE_BYTE:
+	case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+	case TINYGLTF_COMPONENT_TYPE_SHORT:
+	case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+		return true;
+	default:
+		return false;
+	}
+}
+
+static float readComponent(const tinygltf::Accessor *gltfAccessor, const uint8_t *buf, int idx) {
+	switch (gltfAccessor->componentType) {
+	case TINYGLTF_COMPONENT_TYPE_FLOAT: {
+		float v;
+		core_memcpy(&v, buf + idx * sizeof(float), sizeof(v));
+		return v;
+	}
+	case TINYGLTF_COMPONENT_TYPE_BYTE: {
+		const int8_t v = (int8_t)buf[idx];
+		return gltfAccessor->normalized ? glm::max((float)v / 127.0f, -1.0f) : (float)v;
+	}
+	case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE: {
+		const uint8_t v = buf[idx];
+		return gltfAccessor->normalized ? (float)v / 255.0f : (float)v;
+	}
+	case TINYGLTF_COMPONENT_TYPE_SHORT: {
+		int16_t v;
+		core_memcpy(&v, buf + idx * sizeof(int16_t), sizeof(v));
+		return gltfAccessor->normalized ? glm::max((float)v / 32767.0f, -1.0f) : (float)v;
+	}
+	case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT: {
+		uint16_t v;
+		core_memcpy(&v, buf + idx * sizeof(uint16_t), sizeof(v));
+		return gltfAccessor->normalized ? (float)v / 65535.0f : (float)v;
+	}
+	default:
+		return 0.0f;
+	}
+}
+
 static image::TextureWrap convertTextureWrap(int wrap) {
 	if (wrap == TINYGLTF_TEXTURE_WRAP_REPEAT) {
 		return image::TextureWrap::Repeat;
@@ -266,127 +319,332 @@ void GLTFFormat::saveGltfNode(core::Map<int, int> &nodeMapping, tinygltf::Model
 	}
 }
 
-uint32_t GLTFFormat::writeBuffer(const voxel::Mesh *mesh, uint8_t idx, io::SeekableWriteStream &os, bool withColor,
-								 bool withTexCoords, bool colorAsFloat, bool exportNormals, bool applyTransform,
-								 const glm::vec3 &pivotOffset, const palette::Palette &palette, Bounds &bounds) {
-	const int nv = (int)mesh->getNoOfVertices();
-	const int ni = (int)mesh->getNoOfIndices();
+static void addExtension(tinygltf::Model &gltfModel, const core::String &extension) {
+	std::string ext = extension.c_str();
+	if (core::find(gltfModel.extensionsUsed.begin(), gltfModel.extensionsUsed.end(), ext) ==
+		gltfModel.extensionsUsed.end()) {
+		gltfModel.extensionsUsed.push_back(ext);
+	}
+}
 
-	const voxel::VertexArray &vertices = mesh->getVertexVector();
-	const voxel::NormalArray &normals = mesh->getNormalVector();
-	const voxel::IndexArray &indices = mesh->getIndexVector();
+static void addRequiredExtension(tinygltf::Model &gltfModel, const core::String &extension) {
+	addExtension(gltfModel, extension);
+	std::string ext = extension.c_str();
+	if (core::find(gltfModel.extensionsRequired.begin(), gltfModel.extensionsRequired.end(), ext) ==
+		gltfModel.extensionsRequired.end()) {
+		gltfModel.extensionsRequired.push_back(ext);
+	}
+}
 
-	for (int i = 0; i < ni; i++) {
-		if (vertices[indices[i]].colorIndex != idx) {
+struct GLTFFormat::GltfPrimitive {
+	uint8_t colorIndex = 0u;
+	/** the mesh vertex indices of the vertices that are part of this primitive */
+	core::DynamicArray<uint32_t> vertices;
+	/** the triangle indices into @c vertices */
+	core::DynamicArray<uint32_t> indices;
+	Bounds bounds;
+	bool shortPositions = false;
+	bool shortIndices = false;
+	uint32_t stride = 0u;
+	/** the size of the uncompressed index data - padded to 4 bytes */
+	size_t indexBytes = 0u;
+	size_t vertexBytes = 0u;
+	/** the sizes of the meshopt compressed index and vertex data */
+	size_t compressedIndexBytes = 0u;
+	size_t compressedVertexBytes = 0u;
+	/** the encoded index data followed by the encoded vertex data */
+	std::vector<uint8_t> data;
+};
+
+struct GLTFFormat::GltfMeshJob {
+	const voxel::Mesh *mesh = nullptr;
+	const palette::Palette *palette = nullptr;
+	glm::vec3 pivotOffset{0.0f};
+	bool exportNormals = false;
+	bool applyTransform = false;
+	int gltfMesh = -1;
+	int texcoordIndex = 0;
+	core::DynamicArray<GltfPrimitive> primitives;
+};
+
+struct GLTFFormat::MeshoptView {
+	int bufferView = -1;
+	/** the buffer of the compressed data - the buffer view itself is pointing into the fallback buffer */
+	int buffer = -1;
+	size_t byteOffset = 0u;
+	size_t byteLength = 0u;
+	uint32_t byteStride = 0u;
+	uint32_t count = 0u;
+	const char *mode = "";
+};
+
+void GLTFFormat::splitPrimitives(GltfMeshJob &job) const {
+	const voxel::VertexArray &vertices = job.mesh->getVertexVector();
+	const voxel::IndexArray &indices = job.mesh->getIndexVector();
+	const palette::Palette &palette = *job.palette;
+	const size_t nv = vertices.size();
+	const size_t ni = indices.size() - indices.size() % 3;
+
+	uint32_t triangles[palette::PaletteMaxColors];
+	uint32_t vertexCounts[palette::PaletteMaxColors];
+	core_memset(triangles, 0, sizeof(triangles));
+	core_memset(vertexCounts, 0, sizeof(vertexCounts));
+	for (size_t i = 0; i < ni; i += 3) {
+		++triangles[vertices[indices[i]].colorIndex];
+	}
+	for (size_t i = 0; i < nv; ++i) {
+		++vertexCounts[vertices[i].colorIndex];
+	}
+	int primitiveIndices[palette::PaletteMaxColors];
+	for (int i = 0; i < palette::PaletteMaxColors; ++i) {
+		primitiveIndices[i] = -1;
+		if (triangles[i] == 0u || i >= palette.colorCount() || palette.color(i).a == 0) {
 			continue;
 		}
-		if (bounds.maxIndex < indices[i]) {
-			bounds.maxIndex = indices[i];
+		primitiveIndices[i] = (int)job.primitives.size();
+		GltfPrimitive primitive;
+		primitive.colorIndex = (uint8_t)i;
+		primitive.indices.reserve((size_t)triangles[i] * 3u);
+		primitive.vertices.reserve(vertexCounts[i]);
+		job.primitives.emplace_back(core::move(primitive));
+	}
+
+	// the local vertex index + 1 in the primitive of the color the vertex was first used with
+	core::DynamicArray<uint32_t> remap(nv);
+	for (size_t i = 0; i < ni; i += 3) {
+		const uint8_t colorIndex = vertices[indices[i]].colorIndex;
+		const int primitiveIdx = primitiveIndices[colorIndex];
+		if (primitiveIdx == -1) {
+			continue;
 		}
-		if (indices[i] < bounds.minIndex) {
-			bounds.minIndex = indices[i];
+		GltfPrimitive &primitive = job.primitives[primitiveIdx];
+		for (size_t j = i; j < i + 3; ++j) {
+			const uint32_t v = indices[j];
+			uint32_t local;
+			if (remap[v] != 0u && vertices[v].colorIndex == colorIndex) {
+				local = remap[v] - 1u;
+			} else {
+				// vertices are not shared between colors - but if they are, they are duplicated
+				local = (uint32_t)primitive.vertices.size();
+				primitive.vertices.push_back(v);
+				if (remap[v] == 0u && vertices[v].colorIndex == colorIndex) {
+					remap[v] = local + 1u;
+				}
+			}
+			primitive.indices.push_back(local);
 		}
-		os.writeUInt32(indices[i]);
-		++bounds.ni;
 	}
-	static_assert(sizeof(voxel::IndexType) == 4, "if not 4 bytes - we might need padding here");
-	const uint32_t indexOffset = (uint32_t)os.size();
+}
 
-	for (int i = 0; i < nv; i++) {
-		glm::vec3 pos = vertices[i].position;
-		if (applyTransform) {
-			pos += pivotOffset;
+void GLTFFormat::encodePrimitive(const GltfMeshJob &job, GltfPrimitive &primitive,
+								 const EncodeSettings &settings) const {
+	const voxel::VertexArray &meshVertices = job.mesh->getVertexVector();
+	const voxel::NormalArray &normals = job.mesh->getNormalVector();
+	const palette::Palette &palette = *job.palette;
+	const uint32_t nv = (uint32_t)primitive.vertices.size();
+	const uint32_t ni = (uint32_t)primitive.indices.size();
+
+	Bounds &bounds = primitive.bounds;
+	bounds.ni = ni;
+	bounds.nv = nv;
+	bounds.minIndex = 0u;
+	bounds.maxIndex = nv > 0u ? nv - 1u : 0u;
+	bounds.maxVertex = glm::vec3{-FLT_MAX};
+	bounds.minVertex = glm::vec3{FLT_MAX};
+	bool integral = true;
+	for (uint32_t i = 0; i < nv; ++i) {
+		glm::vec3 pos = meshVertices[primitive.vertices[i]].position;
+		if (job.applyTransform) {
+			pos += job.pivotOffset;
+		}
+		bounds.maxVertex = glm::max(bounds.maxVertex, pos);
+		bounds.minVertex = glm::min(bounds.minVertex, pos);
+		if (integral && glm::floor(pos) != pos) {
+			integral = false;
+		}
+	}
+	// voxel positions are usually integers - they can be stored as shorts without losing precision
+	const bool inShortRange = glm::all(glm::greaterThanEqual(bounds.minVertex, glm::vec3(INT16_MIN))) &&
+							  glm::all(glm::lessThanEqual(bounds.maxVertex, glm::vec3(INT16_MAX)));
+	primitive.shortPositions = settings.quantize && integral && inShortRange;
+	// 65535 is not allowed as index value for unsigned short indices
+	primitive.shortIndices = settings.quantize && nv < 65535u;
+
+	const uint32_t positionSize = primitive.shortPositions ? 4 * sizeof(int16_t) : 3 * sizeof(float);
+	const uint32_t normalSize = job.exportNormals ? (settings.quantize ? 4 * sizeof(int8_t) : 3 * sizeof(float)) : 0u;
+	uint32_t attributeSize = 0u;
+	if (settings.withTexCoords) {
+		attributeSize = settings.quantize ? 2 * sizeof(uint16_t) : 2 * sizeof(float);
+	} else if (settings.withColor) {
+		attributeSize = settings.colorAsFloat && !settings.quantize ? 4 * sizeof(float) : 4 * sizeof(uint8_t);
+	}
+	primitive.stride = positionSize + normalSize + attributeSize;
+	const size_t indexSize = primitive.shortIndices ? sizeof(uint16_t) : sizeof(uint32_t);
+	primitive.indexBytes = _priv::align4(ni * indexSize);
+	primitive.vertexBytes = (size_t)nv * primitive.stride;
+
+	std::vector<uint8_t> raw(primitive.indexBytes + primitive.vertexBytes, 0u);
+	if (primitive.shortIndices) {
+		uint16_t *out = (uint16_t *)raw.data();
+		for (uint32_t i = 0; i < ni; ++i) {
+			out[i] = (uint16_t)primitive.indices[i];
 		}
+	} else {
+		core_memcpy(raw.data(), primitive.indices.data(), ni * sizeof(uint32_t));
+	}
 
-		for (int coordIndex = 0; coordIndex < glm::vec3::length(); coordIndex++) {
-			os.writeFloat(pos[coordIndex]);
-			if (bounds.maxVertex[coordIndex] < pos[coordIndex]) {
-				bounds.maxVertex[coordIndex] = pos[coordIndex];
-			}
-			if (bounds.minVertex[coordIndex] > pos[coordIndex]) {
-				bounds.minVertex[coordIndex] = pos[coordIndex];
-			}
+	uint8_t *out = raw.data() + primitive.indexBytes;
+	for (uint32_t i = 0; i < nv; ++i, out += primitive.stride) {
+		const uint32_t v = primitive.vertices[i];
+		const voxel::VoxelVertex &vertex = meshVertices[v];
+		glm::vec3 pos = vertex.position;
+		if (job.applyTransform) {
+			pos += job.pivotOffset;
 		}
-		++bounds.nv;
-
-		if (exportNormals) {
-			for (int coordIndex = 0; coordIndex < glm::vec3::length(); coordIndex++) {
-				os.writeFloat(normals[i][coordIndex]);
+		uint8_t *attr = out;
+		if (primitive.shortPositions) {
+			const int16_t p[3]{(int16_t)pos.x, (int16_t)pos.y, (int16_t)pos.z};
+			core_memcpy(attr, p, sizeof(p));
+		} else {
+			core_memcpy(attr, &pos, sizeof(pos));
+		}
+		attr += positionSize;
+		if (job.exportNormals) {
+			const glm::vec3 &normal = normals[v];
+			if (settings.quantize) {
+				const int8_t n[3]{(int8_t)meshopt_quantizeSnorm(normal.x, 8), (int8_t)meshopt_quantizeSnorm(normal.y, 8),
+								  (int8_t)meshopt_quantizeSnorm(normal.z, 8)};
+				core_memcpy(attr, n, sizeof(n));
+			} else {
+				core_memcpy(attr, &normal, sizeof(normal));
 			}
+			attr += normalSize;
 		}
-
-		if (withTexCoords) {
-			const glm::vec2 &uv = paletteUV(vertices[i].colorIndex);
-			os.writeFloat(uv.x);
-			os.writeFloat(uv.y);
-		} else if (withColor) {
-			const core::RGBA paletteColor = palette.color(vertices[i].colorIndex);
-			if (colorAsFloat) {
+		if (settings.withTexCoords) {
+			const glm::vec2 &uv = paletteUV(vertex.colorIndex);
+			if (settings.quantize) {
+				const uint16_t q[2]{(uint16_t)meshopt_quantizeUnorm(uv.x, 16), (uint16_t)meshopt_quantizeUnorm(uv.y, 16)};
+				core_memcpy(attr, q, sizeof(q));
+			} else {
+				core_memcpy(attr, &uv, sizeof(uv));
+			}
+		} else if (settings.withColor) {
+			const core::RGBA paletteColor = palette.color(vertex.colorIndex);
+			if (settings.colorAsFloat && !settings.quantize) {
 				const glm::vec4 &color = core::Color::fromRGBA(paletteColor);
-				for (int colorIdx = 0; colorIdx < glm::vec4::length(); colorIdx++) {
-					os.writeFloat(color[colorIdx]);
-				}
+				core_memcpy(attr, &color, sizeof(color));
 			} else {
-				os.writeUInt8(paletteColor.r);
-				os.writeUInt8(paletteColor.g);
-				os.writeUInt8(paletteColor.b);
-				os.writeUInt8(paletteColor.a);
+				const uint8_t c[4]{paletteColor.r, paletteColor.g, paletteColor.b, paletteColor.a};
+				core_memcpy(attr, c, sizeof(c));
 			}
 		}
 	}
-	return indexOffset;
-}
 
-bool GLTFFormat::savePrimitivesPerMaterial(uint8_t idx, const glm::vec3 &pivotOffset, tinygltf::Model &gltfModel,
-										   tinygltf::Mesh &gltfMesh, const voxel::Mesh *mesh,
-										   const palette::Palette &palette, bool withColor, bool withTexCoords,
-										   bool colorAsFloat, bool exportNormals, bool applyTransform,
-										   int texcoordIndex, const MaterialMap &paletteMaterialIndices) {
-
-	const size_t expectedSize =
-		mesh->getNoOfIndices() * sizeof(voxel::IndexType) + mesh->getNoOfVertices() * 10 * sizeof(float);
-	io::BufferedReadWriteStream os((int64_t)expectedSize);
+	if (settings.meshopt && ni > 0u) {
+		const size_t indexBound = _priv::align4(meshopt_encodeIndexBufferBound(ni, nv));
+		const size_t vertexBound = meshopt_encodeVertexBufferBound(nv, primitive.stride);
+		std::vector<uint8_t> encoded(indexBound + vertexBound, 0u);
+		primitive.compressedIndexBytes =
+			meshopt_encodeIndexBuffer(encoded.data(), indexBound, primitive.indices.data(), ni);
+		const size_t vertexOffset = _priv::align4(primitive.compressedIndexBytes);
+		primitive.compressedVertexBytes =
+			meshopt_encodeVertexBuffer(encoded.data() + vertexOffset, encoded.size() - vertexOffset,
+									   raw.data() + primitive.indexBytes, nv, primitive.stride);
+		encoded.resize(vertexOffset + _priv::align4(primitive.compressedVertexBytes));
+		primitive.data = core::move(encoded);
+	} else {
+		primitive.data = core::move(raw);
+	}
+	primitive.indices.release();
+	primitive.vertices.release();
+}
 
-	Bounds bounds;
-	bounds.minIndex = UINT_MAX;
-	bounds.maxVertex = glm::vec3{-FLT_MAX};
-	bounds.minVertex = glm::vec3{FLT_MAX};
+size_t GLTFFormat::encodeJobs(core::DynamicArray<GltfMeshJob> &jobs, size_t first,
+							  const EncodeSettings &settings) const {
+	app::for_parallel((int)first, (int)jobs.size(), [&](int start, int end) {
+		for (int i = start; i < end; ++i) {
+			splitPrimitives(jobs[i]);
+		}
+	});
+	core::DynamicArray<core::Pair<int, int>> primitives;
+	for (size_t i = first; i < jobs.size(); ++i) {
+		for (size_t j = 0; j < jobs[i].primitives.size(); ++j) {
+			primitives.emplace_back((int)i, (int)j);
+		}
+	}
+	app::for_parallel(0, (int)primitives.size(), [&](int start, int end) {
+		for (int i = start; i < end; ++i) {
+			GltfMeshJob &job = jobs[primitives[i].first];
+			encodePrimitive(job, job.primitives[primitives[i].second], settings);
+		}
+	});
+	for (size_t i = first; i < jobs.size(); ++i) {
+		jobs[i].mesh = nullptr;
+	}
+	return primitives.size();
+}
 
-	const uint32_t indicesBufferByteLen = writeBuffer(mesh, idx, os, withColor, withTexCoords, colorAsFloat,
-													  exportNormals, applyTransform, pivotOffset, palette, bounds);
-	if (indicesBufferByteLen == 0u) {
-		return false;
+void GLTFFormat::addPrimitive(tinygltf::Model &gltfModel, tinygltf::Mesh &gltfMesh, const GltfMeshJob &job,
+							  GltfPrimitive &primitive, const EncodeSettings &settings, bool writeBinary,
+							  const MaterialMap &paletteMaterialIndices, core::DynamicArray<GltfPrimitive *> &blobs,
+							  core::DynamicArray<MeshoptView> &meshoptViews) const {
+	const Bounds &bounds = primitive.bounds;
+	const int bufferIdx = (int)gltfModel.buffers.size();
+	{
+		// the glb writer streams the blobs directly - only the gltf text format needs them in the model
+		tinygltf::Buffer gltfBuffer;
+		if (writeBinary) {
+			blobs.resize(bufferIdx + 1);
+			blobs[bufferIdx] = &primitive;
+		} else {
+			gltfBuffer.data = core::move(primitive.data);
+		}
+		gltfModel.buffers.emplace_back(core::move(gltfBuffer));
 	}
+
+	const int indicesBufferViewIdx = (int)gltfModel.bufferViews.size();
+	const uint32_t indexSize = primitive.shortIndices ? sizeof(uint16_t) : sizeof(uint32_t);
 	tinygltf::BufferView gltfIndicesBufferView;
-	gltfIndicesBufferView.buffer = (int)gltfModel.buffers.size();
+	gltfIndicesBufferView.buffer = bufferIdx;
 	gltfIndicesBufferView.byteOffset = 0;
-	gltfIndicesBufferView.byteLength = indicesBufferByteLen;
+	gltfIndicesBufferView.byteLength = (size_t)bounds.ni * indexSize;
 	gltfIndicesBufferView.target = TINYGLTF_TARGET_ELEMENT_ARRAY_BUFFER;
 
 	tinygltf::BufferView gltfVerticesBufferView;
-	gltfVerticesBufferView.buffer = (int)gltfModel.buffers.size();
-	gltfVerticesBufferView.byteOffset = indicesBufferByteLen;
-	gltfVerticesBufferView.byteLength = os.size() - indicesBufferByteLen;
-	gltfVerticesBufferView.byteStride = 3 * sizeof(float);
-	if (exportNormals) {
-		gltfVerticesBufferView.byteStride += 3 * sizeof(float);
-	}
-	if (withTexCoords) {
-		gltfVerticesBufferView.byteStride += 2 * sizeof(float);
-	} else if (withColor) {
-		if (colorAsFloat) {
-			gltfVerticesBufferView.byteStride += 4 * sizeof(float);
-		} else {
-			gltfVerticesBufferView.byteStride += 4 * sizeof(uint8_t);
-		}
-	}
+	gltfVerticesBufferView.buffer = bufferIdx;
+	gltfVerticesBufferView.byteOffset = primitive.indexBytes;
+	gltfVerticesBufferView.byteLength = primitive.vertexBytes;
+	gltfVerticesBufferView.byteStride = primitive.stride;
 	gltfVerticesBufferView.target = TINYGLTF_TARGET_ARRAY_BUFFER;
 
+	if (settings.meshopt) {
+		MeshoptView indicesView;
+		indicesView.bufferView = indicesBufferViewIdx;
+		indicesView.buffer = bufferIdx;
+		indicesView.byteOffset = 0u;
+		indicesView.byteLength = primitive.compressedIndexBytes;
+		indicesView.byteStride = indexSize;
+		indicesView.count = bounds.ni;
+		indicesView.mode = "TRIANGLES";
+		meshoptViews.push_back(indicesView);
+
+		MeshoptView verticesView;
+		verticesView.bufferView = indicesBufferViewIdx + 1;
+		verticesView.buffer = bufferIdx;
+		verticesView.byteOffset = _priv::align4(primitive.compressedIndexBytes);
+		verticesView.byteLength = primitive.compressedVertexBytes;
+		verticesView.byteStride = primitive.stride;
+		verticesView.count = bounds.nv;
+		verticesView.mode = "ATTRIBUTES";
+		meshoptViews.push_back(verticesView);
+	}
+
 	// Describe the layout of indicesBufferView, the indices of the vertices
 	tinygltf::Accessor gltfIndicesAccessor;
-	gltfIndicesAccessor.bufferView = (int)gltfModel.bufferViews.size();
+	gltfIndicesAccessor.bufferView = indicesBufferViewIdx;
 	gltfIndicesAccessor.byteOffset = 0;
-	gltfIndicesAccessor.componentType = TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT;
+	gltfIndicesAccessor.componentType =
+		primitive.shortIndices ? TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT : TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT;
 	gltfIndicesAccessor.count = bounds.ni;
 	gltfIndicesAccessor.type = TINYGLTF_TYPE_SCALAR;
 	gltfIndicesAccessor.maxValues.push_back(bounds.maxIndex);
@@ -394,38 +652,55 @@ bool GLTFFormat::savePrimitivesPerMaterial(uint8_t idx, const glm::vec3 &pivotOf
 
 	// Describe the layout of verticesUvBufferView, the vertices themself
 	tinygltf::Accessor gltfVerticesAccessor;
-	gltfVerticesAccessor.bufferView = (int)gltfModel.bufferViews.size() + 1;
+	gltfVerticesAccessor.bufferView = indicesBufferViewIdx + 1;
 	gltfVerticesAccessor.byteOffset = 0;
-	gltfVerticesAccessor.componentType = TINYGLTF_COMPONENT_TYPE_FLOAT;
+	gltfVerticesAccessor.componentType =
+		primitive.shortPositions ? TINYGLTF_COMPONENT_TYPE_SHORT : TINYGLTF_COMPONENT_TYPE_FLOAT;
 	gltfVerticesAccessor.count = bounds.nv;
 	gltfVerticesAccessor.type = TINYGLTF_TYPE_VEC3;
 	gltfVerticesAccessor.maxValues = {bounds.maxVertex[0], bounds.maxVertex[1], bounds.maxVertex[2]};
 	gltfVerticesAccessor.minValues = {bounds.minVertex[0], bounds.minVertex[1], bounds.minVertex[2]};
+	size_t attributeOffset = primitive.shortPositions ? 4 * sizeof(int16_t) : 3 * sizeof(float);
 
 	// Describe the layout of normals - they are followed
 	tinygltf::Accessor gltfNormalAccessor;
-	gltfNormalAccessor.bufferView = (int)gltfModel.bufferViews.size() + 1;
-	gltfNormalAccessor.byteOffset = 3 * sizeof(float);
-	gltfNormalAccessor.componentType = TINYGLTF_COMPONENT_TYPE_FLOAT;
-	gltfNormalAccessor.count = bounds.nv;
-	gltfNormalAccessor.type = TINYGLTF_TYPE_VEC3;
+	if (job.exportNormals) {
+		gltfNormalAccessor.bufferView = indicesBufferViewIdx + 1;
+		gltfNormalAccessor.byteOffset = attributeOffset;
+		if (settings.quantize) {
+			gltfNormalAccessor.componentType = TINYGLTF_COMPONENT_TYPE_BYTE;
+			gltfNormalAccessor.normalized = true;
+			attributeOffset += 4 * sizeof(int8_t);
+		} else {
+			gltfNormalAccessor.componentType = TINYGLTF_COMPONENT_TYPE_FLOAT;
+			attributeOffset += 3 * sizeof(float);
+		}
+		gltfNormalAccessor.count = bounds.nv;
+		gltfNormalAccessor.type = TINYGLTF_TYPE_VEC3;
+	}
 
 	tinygltf::Accessor gltfColorAccessor;
-	if (withTexCoords) {
-		gltfColorAccessor.bufferView = (int)gltfModel.bufferViews.size() + 1;
-		gltfColorAccessor.componentType = TINYGLTF_COMPONENT_TYPE_FLOAT;
+	if (settings.withTexCoords) {
+		gltfColorAccessor.bufferView = indicesBufferViewIdx + 1;
+		if (settings.quantize) {
+			gltfColorAccessor.componentType = TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT;
+			gltfColorAccessor.normalized = true;
+		} else {
+			gltfColorAccessor.componentType = TINYGLTF_COMPONENT_TYPE_FLOAT;
+		}
 		gltfColorAccessor.count = bounds.nv;
-		gltfColorAccessor.byteOffset = (exportNormals ? 2 : 1) * 3 * sizeof(float);
+		gltfColorAccessor.byteOffset = attributeOffset;
 		gltfColorAccessor.type = TINYGLTF_TYPE_VEC2;
-	} else if (withColor) {
-		gltfColorAccessor.bufferView = (int)gltfModel.bufferViews.size() + 1;
+	} else if (settings.withColor) {
+		gltfColorAccessor.bufferView = indicesBufferViewIdx + 1;
 		gltfColorAccessor.count = bounds.nv;
 		gltfColorAccessor.type = TINYGLTF_TYPE_VEC4;
-		gltfColorAccessor.byteOffset = (exportNormals ? 2 : 1) * 3 * sizeof(float);
-		if (colorAsFloat) {
+		gltfColorAccessor.byteOffset = attributeOffset;
+		if (settings.colorAsFloat && !settings.quantize) {
 			gltfColorAccessor.componentType = TINYGLTF_COMPONENT_TYPE_FLOAT;
 		} else {
 			gltfColorAccessor.componentType = TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE;
+			gltfColorAccessor.normalized = true;
 		}
 	}
 
@@ -436,54 +711,156 @@ bool GLTFFormat::savePrimitivesPerMaterial(uint8_t idx, const glm::vec3 &pivotOf
 		gltfMeshPrimitive.indices = (int)gltfModel.accessors.size();
 		// The index of the accessor for positions
 		gltfMeshPrimitive.attributes["POSITION"] = (int)gltfModel.accessors.size() + 1;
-		if (exportNormals) {
+		if (job.exportNormals) {
 			gltfMeshPrimitive.attributes["NORMAL"] = (int)gltfModel.accessors.size() + 2;
 		}
-		if (withTexCoords) {
-			const core::String &texcoordsKey = core::String::format("TEXCOORD_%i", texcoordIndex);
+		if (settings.withTexCoords) {
+			const core::String &texcoordsKey = core::String::format("TEXCOORD_%i", job.texcoordIndex);
 			gltfMeshPrimitive.attributes[texcoordsKey.c_str()] =
-				(int)gltfModel.accessors.size() + (exportNormals ? 3 : 2);
-		} else if (withColor) {
-			gltfMeshPrimitive.attributes["COLOR_0"] = (int)gltfModel.accessors.size() + (exportNormals ? 3 : 2);
+				(int)gltfModel.accessors.size() + (job.exportNormals ? 3 : 2);
+		} else if (settings.withColor) {
+			gltfMeshPrimitive.attributes["COLOR_0"] = (int)gltfModel.accessors.size() + (job.exportNormals ? 3 : 2);
 		}
-		auto paletteMaterialIter = paletteMaterialIndices.find(palette.hash());
+		auto paletteMaterialIter = paletteMaterialIndices.find(job.palette->hash());
 		core_assert(paletteMaterialIter != paletteMaterialIndices.end());
-		const int material = paletteMaterialIter->value[idx];
+		const int material = paletteMaterialIter->value[primitive.colorIndex];
 		core_assert(material >= 0);
 		gltfMeshPrimitive.material = material;
 		gltfMeshPrimitive.mode = TINYGLTF_MODE_TRIANGLES;
 		gltfMesh.primitives.emplace_back(core::move(gltfMeshPrimitive));
 	}
 
-	{
-		// indices and vertices
-		tinygltf::Buffer gltfBuffer;
-		gltfBuffer.data.insert(gltfBuffer.data.end(), os.getBuffer(), os.getBuffer() + os.size());
-		gltfModel.buffers.emplace_back(core::move(gltfBuffer));
-	}
-
 	Log::debug("Index buffer view at %i", (int)gltfModel.bufferViews.size());
 	gltfModel.bufferViews.emplace_back(core::move(gltfIndicesBufferView));
 	Log::debug("vertex buffer view at %i", (int)gltfModel.bufferViews.size());
 	gltfModel.bufferViews.emplace_back(core::move(gltfVerticesBufferView));
 	gltfModel.accessors.emplace_back(core::move(gltfIndicesAccessor));
 	gltfModel.accessors.emplace_back(core::move(gltfVerticesAccessor));
-	if (exportNormals) {
+	if (job.exportNormals) {
 		gltfModel.accessors.emplace_back(core::move(gltfNormalAccessor));
 	}
-	if (withTexCoords || withColor) {
+	if (settings.withTexCoords || settings.withColor) {
 		gltfModel.accessors.emplace_back(core::move(gltfColorAccessor));
 	}
-
-	return true;
 }
 
-static void addExtension(tinygltf::Model &gltfModel, const core::String &extension) {
-	std::string ext = extension.c_str();
-	if (core::find(gltfModel.extensionsUsed.begin(), gltfModel.extensionsUsed.end(), ext) ==
-		gltfModel.extensionsUsed.end()) {
-		gltfModel.extensionsUsed.push_back(ext);
+bool GLTFFormat::writeGlb(io::SeekableWriteStream &stream, tinygltf::Model &gltfModel,
+						  const core::DynamicArray<GltfPrimitive *> &blobs,
+						  const core::DynamicArray<MeshoptView> &meshoptViews) const {
+	// all buffers are merged into the binary chunk of the glb
+	std::vector<tinygltf::Buffer> buffers;
+	buffers.swap(gltfModel.buffers);
+	auto bufferData = [&](size_t idx, size_t &size) -> const uint8_t * {
+		if (idx < blobs.size() && blobs[idx] != nullptr) {
+			size = blobs[idx]->data.size();
+			return blobs[idx]->data.data();
+		}
+		size = buffers[idx].data.size();
+		return buffers[idx].data.data();
+	};
+	core::DynamicArray<size_t> bufferOffsets(buffers.size());
+	size_t binSize = 0u;
+	for (size_t i = 0; i < buffers.size(); ++i) {
+		size_t size;
+		bufferData(i, size);
+		bufferOffsets[i] = binSize;
+		binSize += _priv::align4(size);
+	}
+	for (tinygltf::BufferView &gltfBufferView : gltfModel.bufferViews) {
+		gltfBufferView.byteOffset += bufferOffsets[gltfBufferView.buffer];
+		gltfBufferView.buffer = 0;
+	}
+
+	// the uncompressed data only exists in a fallback buffer without any data
+	size_t fallbackSize = 0u;
+	core::DynamicArray<size_t> meshoptOffsets;
+	meshoptOffsets.reserve(meshoptViews.size());
+	for (const MeshoptView &view : meshoptViews) {
+		tinygltf::BufferView &gltfBufferView = gltfModel.bufferViews[view.bufferView];
+		meshoptOffsets.push_back(bufferOffsets[view.buffer] + view.byteOffset);
+		gltfBufferView.buffer = 1;
+		gltfBufferView.byteOffset = fallbackSize;
+		fallbackSize += _priv::align4(gltfBufferView.byteLength);
+	}
+	if (!meshoptViews.empty()) {
+		addRequiredExtension(gltfModel, "EXT_meshopt_compression");
+	}
+
+	tinygltf::TinyGLTF gltf;
+	std::ostringstream jsonStream;
+	if (!gltf.WriteGltfSceneToStream(&gltfModel, jsonStream, false, false)) {
+		Log::error("Could not serialize the gltf json");
+		return false;
+	}
+	// the buffers and the meshopt entries are added to the json document afterwards: tinygltf derives the buffer
+	// length from the buffer data and its extension values only store 32 bit integers
+	nlohmann::json document = nlohmann::json::parse(jsonStream.str(), nullptr, false);
+	if (document.is_discarded() || !document.is_object()) {
+		Log::error("Invalid gltf json");
+		return false;
 	}
+	for (size_t i = 0; i < meshoptViews.size(); ++i) {
+		const MeshoptView &view = meshoptViews[i];
+		nlohmann::json meshopt;
+		meshopt["buffer"] = 0;
+		meshopt["byteOffset"] = (uint64_t)meshoptOffsets[i];
+		meshopt["byteLength"] = (uint64_t)view.byteLength;
+		meshopt["byteStride"] = (uint64_t)view.byteStride;
+		meshopt["count"] = (uint64_t)view.count;
+		meshopt["mode"] = view.mode;
+		document["bufferViews"][view.bufferView]["extensions"]["EXT_meshopt_compression"] = core::move(meshopt);
+	}
+	if (binSize > 0u) {
+		nlohmann::json &jsonBuffers = document["buffers"];
+		jsonBuffers = nlohmann::json::array();
+		nlohmann::json binBuffer;
+		binBuffer["byteLength"] = (uint64_t)binSize;
+		jsonBuffers.push_back(core::move(binBuffer));
+		if (!meshoptViews.empty()) {
+			nlohmann::json fallbackBuffer;
+			fallbackBuffer["byteLength"] = (uint64_t)fallbackSize;
+			fallbackBuffer["extensions"]["EXT_meshopt_compression"]["fallback"] = true;
+			jsonBuffers.push_back(core::move(fallbackBuffer));
+		}
+	}
+	std::string json = document.dump();
+	const size_t jsonPadding = _priv::align4(json.size()) - json.size();
+	json.append(jsonPadding, ' ');
+
+	const uint64_t length = 12u + 8u + json.size() + (binSize > 0u ? 8u + binSize : 0u);
+	if (length > UINT32_MAX) {
+		Log::error("The glb file exceeds the maximum size of 4GB");
+		return false;
+	}
+	io::BufferedWriteStream out(stream);
+	out.writeUInt32(FourCC('g', 'l', 'T', 'F'));
+	out.writeUInt32(2);
+	out.writeUInt32((uint32_t)length);
+	out.writeUInt32((uint32_t)json.size());
+	out.writeUInt32(FourCC('J', 'S', 'O', 'N'));
+	if (out.write(json.data(), json.size()) != (int)json.size()) {
+		Log::error("Failed to write the glb json chunk");
+		return false;
+	}
+	if (binSize == 0u) {
+		return out.flush();
+	}
+	out.writeUInt32((uint32_t)binSize);
+	out.writeUInt32(FourCC('B', 'I', 'N', '\0'));
+	const uint8_t padding[4]{0u, 0u, 0u, 0u};
+	for (size_t i = 0; i < buffers.size(); ++i) {
+		size_t size;
+		const uint8_t *data = bufferData(i, size);
+		if (size > 0u && out.write(data, size) != (int)size) {
+			Log::error("Failed to write the glb binary chunk");
+			return false;
+		}
+		const size_t paddingSize = _priv::align4(size) - size;
+		if (paddingSize > 0u && out.write(padding, paddingSize) != (int)paddingSize) {
+			return false;
+		}
+	}
+	return out.flush();
 }
 
 void GLTFFormat::save_KHR_materials_emissive_strength(const palette::Material &material,
@@ -721,12 +1098,22 @@ bool GLTFFormat::saveMeshes(const core::Map<int, int> &meshIdxNodeMap, const sce
 	tinygltf::Model gltfModel;
 	tinygltf::Scene gltfScene;
 
-	const bool colorAsFloat = core::Var::get(cfg::VoxformatColorAsFloat)->boolVal();
-	if (colorAsFloat) {
+	EncodeSettings settings;
+	settings.withColor = withColor;
+	settings.withTexCoords = withTexCoords;
+	settings.colorAsFloat = core::Var::get(cfg::VoxformatColorAsFloat)->boolVal();
+	settings.quantize = core::Var::getSafe(cfg::VoxFormatGLTF_KHR_mesh_quantization)->boolVal();
+	settings.meshopt = core::Var::getSafe(cfg::VoxFormatGLTF_EXT_meshopt_compression)->boolVal();
+	if (settings.colorAsFloat) {
 		Log::debug("Export colors as float");
 	} else {
 		Log::debug("Export colors as byte");
 	}
+	if (settings.meshopt && !writeBinary) {
+		// the compressed data needs a fallback buffer without data - this is only possible for glb files
+		Log::warn("EXT_meshopt_compression is only supported for glb files");
+		settings.meshopt = false;
+	}
 
 	const size_t modelNodes = meshes.size();
 	const core::String &appname = app::App::getInstance()->fullAppname();
@@ -744,6 +1131,12 @@ bool GLTFFormat::saveMeshes(const core::Map<int, int> &meshIdxNodeMap, const sce
 
 	MaterialMap paletteMaterialIndices((int)sceneGraph.size());
 	core::Map<int, int> nodeMapping((int)sceneGraph.nodeSize());
+	core::DynamicArray<GltfMeshJob> jobs;
+	jobs.reserve(meshes.size() * voxel::ChunkMesh::Meshes);
+	// the jobs are encoded in batches - a batch is flushed once a packed mesh was unpacked for it to not keep the
+	// unpacked meshes of all nodes in memory
+	size_t pendingJobs = 0u;
+	size_t encodedPrimitives = 0u;
 	while (!stack.empty()) {
 		const int nodeId = stack.back().first;
 		const scenegraph::SceneGraphNode &node = sceneGraph.node(nodeId);
@@ -762,16 +1155,17 @@ bool GLTFFormat::saveMeshes(const core::Map<int, int> &meshIdxNodeMap, const sce
 		int texcoordIndex = 0;
 		if (node.isAnyModelNode()) {
 			for (int i = 0; i < voxel::ChunkMesh::Meshes; ++i) {
-				const voxel::Mesh *mesh = &meshExt.mesh->mesh[i];
-				if (mesh->isEmpty()) {
+				if (meshExt.isEmpty(i)) {
 					continue;
 				}
 				generateMaterials(withTexCoords, gltfModel, paletteMaterialIndices, node, palette, texcoordIndex);
 			}
 		}
 
+		voxel::ChunkMesh unpacked(0, 0);
+		const voxel::ChunkMesh *chunkMesh = &meshExt.unpack(unpacked);
 		for (int i = 0; i < voxel::ChunkMesh::Meshes; ++i) {
-			const voxel::Mesh *mesh = &meshExt.mesh->mesh[i];
+			const voxel::Mesh *mesh = &chunkMesh->mesh[i];
 			if (mesh->isEmpty()) {
 				continue;
 			}
@@ -799,19 +1193,39 @@ bool GLTFFormat::saveMeshes(const core::Map<int, int> &meshIdxNodeMap, const sce
 
 			tinygltf::Mesh gltfMesh;
 			gltfMesh.name = objectName;
-			for (int i = 0; i < palette.colorCount(); ++i) {
-				if (palette.color(i).a == 0) {
-					continue;
-				}
-				savePrimitivesPerMaterial(i, pivotOffset, gltfModel, gltfMesh, mesh, palette, withColor, withTexCoords,
-										  colorAsFloat, exportNormals, meshExt.applyTransform, texcoordIndex,
-										  paletteMaterialIndices);
-			}
+			// the primitives are added once the mesh data was encoded
+			GltfMeshJob job;
+			job.mesh = mesh;
+			job.palette = &node.palette();
+			job.pivotOffset = pivotOffset;
+			job.exportNormals = exportNormals;
+			job.applyTransform = meshExt.applyTransform;
+			job.texcoordIndex = texcoordIndex;
 			saveGltfNode(nodeMapping, gltfModel, gltfScene, node, stack, sceneGraph, scale,
 							exportAnimations);
+			job.gltfMesh = (int)gltfModel.meshes.size();
 			gltfModel.meshes.emplace_back(core::move(gltfMesh));
+			jobs.emplace_back(core::move(job));
+		}
+		if (chunkMesh == &unpacked) {
+			encodedPrimitives += encodeJobs(jobs, pendingJobs, settings);
+			pendingJobs = jobs.size();
 		}
 	}
+	encodedPrimitives += encodeJobs(jobs, pendingJobs, settings);
+
+	core::DynamicArray<GltfPrimitive *> blobs;
+	core::DynamicArray<MeshoptView> meshoptViews;
+	for (GltfMeshJob &job : jobs) {
+		tinygltf::Mesh &gltfMesh = gltfModel.meshes[job.gltfMesh];
+		for (GltfPrimitive &primitive : job.primitives) {
+			addPrimitive(gltfModel, gltfMesh, job, primitive, settings, writeBinary, paletteMaterialIndices, blobs,
+						 meshoptViews);
+		}
+	}
+	if (settings.quantize && encodedPrimitives > 0u) {
+		addRequiredExtension(gltfModel, "KHR_mesh_quantization");
+	}
 
 	if (exportAnimations) {
 		Log::debug("Export %i animations for %i nodes", (int)sceneGraph.animations().size(), (int)nodeMapping.size());
@@ -839,9 +1253,13 @@ bool GLTFFormat::saveMeshes(const core::Map<int, int> &meshIdxNodeMap, const sce
 		gltfModel.cameras.push_back(gltfCamera);
 	}
 
+	if (writeBinary) {
+		return writeGlb(*stream, gltfModel, blobs, meshoptViews);
+	}
+
 	io::StdOStreamBuf buf(*stream);
 	std::ostream gltfStream(&buf);
-	if (!gltf.WriteGltfSceneToStream(&gltfModel, gltfStream, false, writeBinary)) {
+	if (!gltf.WriteGltfSceneToStream(&gltfModel, gltfStream, false, false)) {
 		Log::error("Could not save to file");
 		return false;
 	}
@@ -1355,34 +1773,33 @@ bool GLTFFormat::loadAttributes(const core::String &filename, core::StringMap<im
 				   (int)stride);
 		const uint8_t *buf = gltfAttributeBuffer.data.data() + offset;
 		if (attrType == "POSITION") {
-			if (gltfAttributeAccessor->componentType != TINYGLTF_COMPONENT_TYPE_FLOAT) {
-				Log::debug("Skip non float type for %s", attrType.c_str());
+			if (!_priv::isSupportedComponentType(gltfAttributeAccessor->componentType)) {
+				Log::debug("Skip unsupported component type for %s", attrType.c_str());
 				continue;
 			}
 			foundPosition = true;
 			core_assert(gltfAttributeAccessor->type == TINYGLTF_TYPE_VEC3);
 			for (size_t i = 0; i < gltfAttributeAccessor->count; i++) {
-				io::MemoryReadStream posStream(buf, stride);
 				glm::vec3 pos;
-				posStream.readFloat(pos.x);
-				posStream.readFloat(pos.y);
-				posStream.readFloat(pos.z);
+				pos.x = _priv::readComponent(gltfAttributeAccessor, buf, 0);
+				pos.y = _priv::readComponent(gltfAttributeAccessor, buf, 1);
+				pos.z = _priv::readComponent(gltfAttributeAccessor, buf, 2);
 				vertices[verticesOffset + i].pos = pos;
 				vertices[verticesOffset + i].texture = gltfMaterial.diffuseTexture;
 				vertices[verticesOffset + i].color = gltfMaterial.baseColor;
 				buf += stride;
 			}
 		} else if (attrType == gltfMaterial.texCoordAttribute.c_str()) {
-			if (gltfAttributeAccessor->componentType != TINYGLTF_COMPONENT_TYPE_FLOAT) {
-				Log::debug("Skip non float type (%i) for %s", gltfAttributeAccessor->componentType, attrType.c_str());
+			if (!_priv::isSupportedComponentType(gltfAttributeAccessor->componentType)) {
+				Log::debug("Skip unsupported component type (%i) for %s", gltfAttributeAccessor->componentType,
+						   attrType.c_str());
 				continue;
 			}
 			core_assert(gltfAttributeAccessor->type == TINYGLTF_TYPE_VEC2);
 			for (size_t i = 0; i < gltfAttributeAccessor->count; i++) {
-				io::MemoryReadStream uvStream(buf, stride);
 				glm::vec2 uv;
-				uvStream.readFloat(uv.x);
-				uvStream.readFloat(uv.y);
+				uv.x = _priv::readComponent(gltfAttributeAccessor, buf, 0);
+				uv.y = _priv::readComponent(gltfAttributeAccessor, buf, 1);
 				if (!gltfAttributeAccessor->normalized) {
 					uv.y = 1.0f - uv.y;
 				}
@@ -1624,7 +2041,8 @@ bool GLTFFormat::loadNode_r(const core::String &filename, scenegraph::SceneGraph
 					pointCloud[i].position = vertices[i].pos;
 					pointCloud[i].color = vertices[i].color;
 				}
-				voxelizePointCloud(filename, sceneGraph, pointCloud);
+				// the nodes are still referenced while loading the gltf scene - thus no streaming here
+				voxelizePointCloud(filename, sceneGraph, pointCloud, LoadContext());
 			}
 			scenegraph::SceneGraphNode &node = sceneGraph.node(nodeId);
 			if (!loadAnimations(sceneGraph, gltfModel, gltfNodeIdx, node)) {
@@ -1725,11 +2143,16 @@ bool GLTFFormat::voxelizeGroups(const core::String &filename, const io::ArchiveP
 	uint32_t magic;
 	stream->peekUInt32(magic);
 	const int64_t size = stream->size();
-	uint8_t *data = (uint8_t *)core_malloc(size);
-	if (stream->read(data, size) == -1) {
-		Log::error("Failed to read gltf stream for %s of size %i", filename.c_str(), (int)size);
-		core_free(data);
-		return false;
+	const uint8_t *data = stream->data();
+	uint8_t *buffer = nullptr;
+	if (data == nullptr) {
+		buffer = (uint8_t *)core_malloc(size);
+		if (stream->read(buffer, size) == -1) {
+			Log::error("Failed to read gltf stream for %s of size %i", filename.c_str(), (int)size);
+			core_free(buffer);
+			return false;
+		}
+		data = buffer;
 	}
 
 	std::string err;
@@ -1753,7 +2176,7 @@ bool GLTFFormat::voxelizeGroups(const core::String &filename, const io::ArchiveP
 			Log::error("Failed to load ascii gltf file: %s", err.c_str());
 		}
 	}
-	core_free(data);
+	core_free(buffer);
 	if (!state) {
 		return false;
 	}
@@ -85,18 +85,57 @@ private:
 	void saveGltfNode(core::Map<int, int> &nodeMapping, tinygltf::Model &gltfModel, tinygltf::Scene &gltfScene,
 					  const scenegraph::SceneGraphNode &graphNode, Stack &stack,
 					  const scenegraph::SceneGraph &sceneGraph, const glm::vec3 &scale, bool exportAnimations);
-	uint32_t writeBuffer(const voxel::Mesh *mesh, uint8_t idx, io::SeekableWriteStream &os, bool withColor,
-						 bool withTexCoords, bool colorAsFloat, bool exportNormals, bool applyTransform,
-						 const glm::vec3 &pivotOffset, const palette::Palette &palette, Bounds &bounds);
 	int saveEmissiveTexture(tinygltf::Model &gltfModel, const palette::Palette &palette) const;
 	int saveTexture(tinygltf::Model &gltfModel, const palette::Palette &palette) const;
 	void generateMaterials(bool withTexCoords, tinygltf::Model &gltfModel, MaterialMap &paletteMaterialIndices,
 						   const scenegraph::SceneGraphNode &node, const palette::Palette &palette,
 						   int &texcoordIndex) const;
-	bool savePrimitivesPerMaterial(uint8_t idx, const glm::vec3 &pivotOffset, tinygltf::Model &gltfModel,
-								   tinygltf::Mesh &gltfMesh, const voxel::Mesh *mesh, const palette::Palette &palette,
-								   bool withColor, bool withTexCoords, bool colorAsFloat, bool exportNormals,
-								   bool applyTransform, int texcoordIndex, const MaterialMap &paletteMaterialIndices);
+	/**
+	 * @brief The options for encoding the vertex and index data of the exported meshes
+	 */
+	struct EncodeSettings {
+		bool withColor = false;
+		bool withTexCoords = false;
+		bool colorAsFloat = false;
+		/**
+		 * https://github.com/KhronosGroup/glTF/tree/main/extensions/2.0/Khronos/KHR_mesh_quantization
+		 */
+		bool quantize = false;
+		/**
+		 * https://github.com/KhronosGroup/glTF/tree/main/extensions/2.0/Vendor/EXT_meshopt_compression
+		 */
+		bool meshopt = false;
+	};
+	struct GltfPrimitive;
+	struct GltfMeshJob;
+	struct MeshoptView;
+	/**
+	 * @brief Splits the triangles of the mesh into one primitive per palette color. Only the vertices that are used by
+	 * a primitive are part of it.
+	 */
+	void splitPrimitives(GltfMeshJob &job) const;
+	/**
+	 * @brief Encodes the index and vertex data of the primitive into its own binary blob. This is executed in
+	 * parallel for all primitives of the scene.
+	 */
+	void encodePrimitive(const GltfMeshJob &job, GltfPrimitive &primitive, const EncodeSettings &settings) const;
+	/**
+	 * @brief Splits and encodes the jobs starting at the given index in parallel. The meshes of the jobs are no
+	 * longer needed afterwards.
+	 * @return The amount of encoded primitives
+	 */
+	size_t encodeJobs(core::DynamicArray<GltfMeshJob> &jobs, size_t first, const EncodeSettings &settings) const;
+	void addPrimitive(tinygltf::Model &gltfModel, tinygltf::Mesh &gltfMesh, const GltfMeshJob &job,
+					  GltfPrimitive &primitive, const EncodeSettings &settings, bool writeBinary,
+					  const MaterialMap &paletteMaterialIndices, core::DynamicArray<GltfPrimitive *> &blobs,
+					  core::DynamicArray<MeshoptView> &meshoptViews) const;
+	/**
+	 * @brief Streams the glb file to the given stream. The binary data is not copied into the tinygltf model, the
+	 * model is only used to serialize the json chunk.
+	 */
+	bool writeGlb(io::SeekableWriteStream &stream, tinygltf::Model &gltfModel,
+				  const core::DynamicArray<GltfPrimitive *> &blobs,
+				  const core::DynamicArray<MeshoptView> &meshoptViews) const;
 
 	void saveAnimation(int targetNode, tinygltf::Model &m, const scenegraph::SceneGraphNode &node,
 					   tinygltf::Animation &gltfAnimation);
@@ -12,6 +12,7 @@
 #include "core/RGBA.h"
 #include "core/StringUtil.h"
 #include "core/Var.h"
+#include "core/collection/Buffer.h"
 #include "core/collection/DynamicArray.h"
 #include "core/collection/DynamicMap.h"
 #include "core/collection/Map.h"
@@ -312,20 +313,19 @@ int MeshFormat::voxelizeNode(const core::String &name, scenegraph::SceneGraph &s
 		if (createPalette) {
 			RGBAMap colors;
 			Log::debug("create palette");
-			for (const voxelformat::TexturedTri &tri : tris) {
-				voxelizeTriangle(trisMins, tri, [this, &colors] (const voxelformat::TexturedTri &tri, const glm::vec2 &uv, int x, int y, int z) {
-					const core::RGBA rgba = flattenRGB(tri.colorAt(uv));
-					colors.put(rgba, true);
-				});
-			}
-
-			const size_t colorCount = colors.size();
-			core::Buffer<core::RGBA> colorBuffer;
-			colorBuffer.reserve(colorCount);
-			for (const auto &e : colors) {
-				colorBuffer.push_back(e->first);
-			}
-			palette.quantize(colorBuffer.data(), colorBuffer.size());
+			core_trace_mutex(core::Lock, lock, "VoxelizeColors");
+			// the texture lookups are the expensive part - every thread counts the colors of its own triangles
+			app::for_parallel(0, (int)tris.size(), [&](int start, int end) {
+				RGBAMap local;
+				for (int i = start; i < end; ++i) {
+					auto func = [this, &local](const voxelformat::TexturedTri &tri, const glm::vec2 &uv, int x, int y,
+											   int z) { palette::addColor(local, flattenRGB(tri.colorAt(uv))); };
+					voxelizeTriangle(trisMins, tris[i], func);
+				}
+				core::ScopedLock scoped(lock);
+				palette::addColors(colors, local);
+			});
+			palette.quantize(colors);
 		} else {
 			palette = voxel::getPalette();
 		}
@@ -424,15 +424,9 @@ void MeshFormat::voxelizeTris(scenegraph::SceneGraphNode &node, const PosMap &po
 			if (rgba.a <= AlphaThreshold) {
 				continue;
 			}
-			colors.put(rgba, true);
+			palette::addColor(colors, rgba);
 		}
-		const size_t colorCount = colors.size();
-		core::Buffer<core::RGBA> colorBuffer;
-		colorBuffer.reserve(colorCount);
-		for (const auto &e : colors) {
-			colorBuffer.push_back(e->first);
-		}
-		palette.quantize(colorBuffer.data(), colorBuffer.size());
+		palette.quantize(colors);
 	} else {
 		palette = voxel::getPalette();
 	}
@@ -473,6 +467,48 @@ MeshFormat::MeshExt::MeshExt(voxel::ChunkMesh *_mesh, const scenegraph::SceneGra
 	  pivot(node.pivot()), nodeId(node.id()) {
 }
 
+void MeshFormat::MeshExt::pack() {
+	voxel::PackedChunkMesh *packedMesh = new voxel::PackedChunkMesh();
+	if (!packedMesh->pack(*mesh)) {
+		delete packedMesh;
+		return;
+	}
+	delete mesh;
+	mesh = nullptr;
+	packed = packedMesh;
+}
+
+void MeshFormat::MeshExt::release() {
+	delete mesh;
+	mesh = nullptr;
+	delete packed;
+	packed = nullptr;
+}
+
+bool MeshFormat::MeshExt::isEmpty() const {
+	return packed != nullptr ? packed->isEmpty() : mesh->isEmpty();
+}
+
+bool MeshFormat::MeshExt::isEmpty(int meshIdx) const {
+	return packed != nullptr ? packed->mesh[meshIdx].isEmpty() : mesh->mesh[meshIdx].isEmpty();
+}
+
+size_t MeshFormat::MeshExt::vertices(int meshIdx) const {
+	return packed != nullptr ? packed->mesh[meshIdx].getNoOfVertices() : mesh->mesh[meshIdx].getNoOfVertices();
+}
+
+size_t MeshFormat::MeshExt::indices(int meshIdx) const {
+	return packed != nullptr ? packed->mesh[meshIdx].getNoOfIndices() : mesh->mesh[meshIdx].getNoOfIndices();
+}
+
+const voxel::ChunkMesh &MeshFormat::MeshExt::unpack(voxel::ChunkMesh &unpacked) const {
+	if (packed == nullptr) {
+		return *mesh;
+	}
+	packed->unpack(unpacked);
+	return unpacked;
+}
+
 bool MeshFormat::loadGroups(const core::String &filename, const io::ArchivePtr &archive,
 							scenegraph::SceneGraph &sceneGraph, const LoadContext &ctx) {
 	const bool retVal = voxelizeGroups(filename, archive, sceneGraph, ctx);
@@ -480,7 +516,8 @@ bool MeshFormat::loadGroups(const core::String &filename, const io::ArchivePtr &
 	return retVal;
 }
 
-bool MeshFormat::voxelizePointCloud(const core::String &filename, scenegraph::SceneGraph &sceneGraph, const core::DynamicArray<PointCloudVertex> &vertices) const {
+bool MeshFormat::voxelizePointCloud(const core::String &filename, scenegraph::SceneGraph &sceneGraph,
+									const core::DynamicArray<PointCloudVertex> &vertices, const LoadContext &ctx) const {
 	glm::vec3 mins{std::numeric_limits<float>::max()};
 	glm::vec3 maxs{std::numeric_limits<float>::min()};
 	const glm::vec3 scale = getInputScale();
@@ -492,24 +529,85 @@ bool MeshFormat::voxelizePointCloud(const core::String &filename, scenegraph::Sc
 
 	const int pointSize = core_max(1, core::Var::getSafe(cfg::VoxformatPointCloudSize)->intVal());
 	const voxel::Region region(glm::floor(mins), glm::ceil(maxs) + glm::vec3((float)(pointSize - 1)));
-	voxel::RawVolume *v = new voxel::RawVolume(region);
+	const int depth = region.getDepthInVoxels();
+	int slabDepth = depth;
+	if (ctx.flush && ctx.memoryLimit > 0u) {
+		// keep each slab well below the memory limit - the flush is only triggered once the limit is reached
+		const size_t sliceBytes = voxel::RawVolume::size(
+			voxel::Region(0, 0, 0, region.getWidthInVoxels() - 1, region.getHeightInVoxels() - 1, 0));
+		slabDepth = (int)glm::clamp(ctx.memoryLimit / 2u / sliceBytes, (size_t)1u, (size_t)depth);
+	}
+	const int slabs = (depth + slabDepth - 1) / slabDepth;
 	const palette::Palette &palette = voxel::getPalette();
+
+	// sort the points into the slabs they are touching - a point can cover several voxels and might reach into
+	// the next slab
+	core::Buffer<int> offsets;
+	offsets.resize(slabs + 1);
+	offsets.fill(0);
+	const int lowerZ = region.getLowerZ();
+	auto slabRange = [&](const PointCloudVertex &vertex, int &first, int &last) {
+		const int z = (int)glm::round(vertex.position.z) - lowerZ;
+		first = z / slabDepth;
+		last = core_min((z + pointSize - 1) / slabDepth, slabs - 1);
+	};
 	for (const PointCloudVertex &vertex : vertices) {
-		const glm::ivec3 pos = glm::round(vertex.position);
-		const voxel::Voxel voxel = voxel::createVoxel(palette, palette.getClosestMatch(vertex.color));
-		for (int x = 0; x < pointSize; ++x) {
-			for (int y = 0; y < pointSize; ++y) {
-				for (int z = 0; z < pointSize; ++z) {
-					v->setVoxel(pos + glm::ivec3(x, y, z), voxel);
+		int first, last;
+		slabRange(vertex, first, last);
+		for (int slab = first; slab <= last; ++slab) {
+			++offsets[slab + 1];
+		}
+	}
+	for (int slab = 0; slab < slabs; ++slab) {
+		offsets[slab + 1] += offsets[slab];
+	}
+	core::Buffer<int> indices;
+	indices.resize(offsets[slabs]);
+	core::Buffer<int> fill;
+	fill.resize(slabs);
+	for (int slab = 0; slab < slabs; ++slab) {
+		fill[slab] = offsets[slab];
+	}
+	for (int i = 0; i < (int)vertices.size(); ++i) {
+		int first, last;
+		slabRange(vertices[i], first, last);
+		for (int slab = first; slab <= last; ++slab) {
+			indices[fill[slab]++] = i;
+		}
+	}
+
+	for (int slab = 0; slab < slabs; ++slab) {
+		const voxel::Region slabRegion(region.getLowerX(), region.getLowerY(), lowerZ + slab * slabDepth,
+									   region.getUpperX(), region.getUpperY(),
+									   core_min(lowerZ + (slab + 1) * slabDepth - 1, region.getUpperZ()));
+		voxel::RawVolume *v = new voxel::RawVolume(slabRegion);
+		for (int i = offsets[slab]; i < offsets[slab + 1]; ++i) {
+			const PointCloudVertex &vertex = vertices[indices[i]];
+			const glm::ivec3 pos = glm::round(vertex.position);
+			const voxel::Voxel voxel = voxel::createVoxel(palette, palette.getClosestMatch(vertex.color));
+			for (int x = 0; x < pointSize; ++x) {
+				for (int y = 0; y < pointSize; ++y) {
+					for (int z = 0; z < pointSize; ++z) {
+						const glm::ivec3 p = pos + glm::ivec3(x, y, z);
+						if (slabRegion.containsPoint(p)) {
+							v->setVoxel(p, voxel);
+						}
+					}
 				}
 			}
 		}
-	}
 
-	scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
-	node.setVolume(v, true);
-	node.setName(filename);
-	return sceneGraph.emplace(core::move(node)) != InvalidNodeId;
+		scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
+		node.setVolume(v, true);
+		node.setName(slabs == 1 ? filename : core::string::format("%s-%i", filename.c_str(), slab));
+		if (sceneGraph.emplace(core::move(node)) == InvalidNodeId) {
+			return false;
+		}
+		if (!ctx.streamNodes(sceneGraph)) {
+			return false;
+		}
+	}
+	return true;
 }
 
 bool MeshFormat::voxelizeGroups(const core::String &filename, const io::ArchivePtr &, scenegraph::SceneGraph &,
@@ -613,7 +711,7 @@ bool MeshFormat::saveGroups(const scenegraph::SceneGraph &sceneGraph, const core
 			voxel::SurfaceExtractionContext ctx =
 				voxel::createContext(type, volume, region, node.palette(), *mesh, {0, 0, 0}, mergeQuads,
 									 reuseVertices, ambientOcclusion);
-			voxel::extractSurface(ctx);
+			voxel::extractSurfaceParallel(ctx);
 			if (withNormals) {
 				Log::debug("Calculate normals");
 				mesh->calculateNormals();
@@ -621,9 +719,13 @@ bool MeshFormat::saveGroups(const scenegraph::SceneGraph &sceneGraph, const core
 			if (optimizeMesh) {
 				mesh->optimize();
 			}
+			MeshExt meshExt(mesh, node, applyTransform);
+			if (type == voxel::SurfaceExtractionType::Cubic) {
+				meshExt.pack();
+			}
 
 			core::ScopedLock scoped(lock);
-			meshes.emplace_back(mesh, node, applyTransform);
+			meshes.emplace_back(meshExt);
 		});
 	}
 	for (;;) {
@@ -641,7 +743,7 @@ bool MeshFormat::saveGroups(const scenegraph::SceneGraph &sceneGraph, const core
 
 	// filter out empty meshes
 	for (auto iter = meshes.begin(); iter != meshes.end(); ++iter) {
-		if (iter->mesh->isEmpty()) {
+		if (iter->isEmpty()) {
 			continue;
 		}
 		nonEmptyMeshes.emplace_back(*iter);
@@ -657,7 +759,7 @@ bool MeshFormat::saveGroups(const scenegraph::SceneGraph &sceneGraph, const core
 						   type == voxel::SurfaceExtractionType::Cubic ? quads : false, withColor, withTexCoords);
 	}
 	for (MeshExt &meshext : meshes) {
-		delete meshext.mesh;
+		meshext.release();
 	}
 	return state;
 }
@@ -10,6 +10,7 @@
 #include "core/collection/Map.h"
 #include "TexturedTri.h"
 #include "voxel/ChunkMesh.h"
+#include "voxel/PackedMesh.h"
 
 namespace voxelformat {
 
@@ -49,13 +50,31 @@ protected:
 
 	struct MeshExt {
 		MeshExt(voxel::ChunkMesh *mesh, const scenegraph::SceneGraphNode &node, bool applyTransform);
+		/** the extracted meshes - @c nullptr if they were packed */
 		voxel::ChunkMesh *mesh;
+		/** the packed meshes of the cubic extractor - @c nullptr if the extracted meshes are not packable */
+		voxel::PackedChunkMesh *packed = nullptr;
 		core::String name;
 		bool applyTransform = false;
 
 		glm::vec3 size{0.0f};
 		glm::vec3 pivot{0.0f};
 		int nodeId = -1;
+
+		/**
+		 * @brief Replaces the extracted meshes by packed meshes if they are packable - they only need half of the
+		 * memory until they are written
+		 */
+		void pack();
+		void release();
+		bool isEmpty() const;
+		bool isEmpty(int meshIdx) const;
+		size_t vertices(int meshIdx) const;
+		size_t indices(int meshIdx) const;
+		/**
+		 * @return The extracted meshes - or the packed meshes unpacked into the given chunk mesh
+		 */
+		const voxel::ChunkMesh &unpack(voxel::ChunkMesh &unpacked) const;
 	};
 	using Meshes = core::DynamicArray<MeshExt>;
 	virtual bool saveMeshes(const core::Map<int, int> &meshIdxNodeMap, const scenegraph::SceneGraph &sceneGraph,
@@ -74,8 +93,14 @@ protected:
 	 */
 	virtual bool voxelizeGroups(const core::String &filename, const io::ArchivePtr &archive,
 								scenegraph::SceneGraph &sceneGraph, const LoadContext &ctx);
+	/**
+	 * @brief Voxelizes the given points into model nodes
+	 *
+	 * If a memory limit is configured in the given @c LoadContext, the points are split into several slabs that are
+	 * handed over to the flush callback as soon as the memory limit is reached.
+	 */
 	bool voxelizePointCloud(const core::String &filename, scenegraph::SceneGraph &sceneGraph,
-							const core::DynamicArray<PointCloudVertex> &vertices) const;
+							const core::DynamicArray<PointCloudVertex> &vertices, const LoadContext &ctx) const;
 
 	/**
 	 * @return A particular uv value for the palette image for the given color index
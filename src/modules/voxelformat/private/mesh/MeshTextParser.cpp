@@ -0,0 +1,157 @@
+/**
+ * @file
+ */
+
+#include "MeshTextParser.h"
+#include "app/App.h"
+#include "core/Common.h"
+#include "core/concurrent/ThreadPool.h"
+#include "io/Stream.h"
+#include <SDL_stdinc.h>
+#include <math.h>
+#include <string.h>
+
+namespace voxelformat {
+namespace meshtext {
+
+// smaller chunks are not worth the merge overhead
+static const size_t MinChunkSize = 256 * 1024;
+// the stream api reports the read bytes as int - larger inputs are read in several steps
+static const size_t MaxReadSize = 64 * 1024 * 1024;
+
+bool remaining(io::SeekableReadStream &stream, core::Buffer<char> &buffer, Chunk &out) {
+	const int64_t pos = stream.pos();
+	const int64_t size = stream.size();
+	if (pos < 0 || size < pos) {
+		return false;
+	}
+	const size_t bytes = (size_t)(size - pos);
+	if (const uint8_t *data = stream.data()) {
+		out.start = (const char *)data + pos;
+		out.end = out.start + bytes;
+		return true;
+	}
+	buffer.resize(bytes);
+	size_t offset = 0u;
+	while (offset < bytes) {
+		const size_t readSize = core_min(bytes - offset, MaxReadSize);
+		const int read = stream.read(buffer.data() + offset, readSize);
+		if (read <= 0) {
+			return false;
+		}
+		offset += (size_t)read;
+	}
+	out.start = buffer.data();
+	out.end = out.start + bytes;
+	return true;
+}
+
+void splitLines(const Chunk &input, core::DynamicArray<Chunk> &chunks) {
+	const size_t size = (size_t)(input.end - input.start);
+	app::App *app = app::App::getInstance();
+	const size_t threads = app == nullptr ? 1u : core_max((size_t)1u, app->threadPool().size());
+	const size_t n = core_max((size_t)1u, core_min(threads * 4u, size / MinChunkSize));
+	const size_t chunkSize = size / n;
+	chunks.reserve(chunks.size() + n);
+	const char *start = input.start;
+	for (size_t i = 0; i < n && start < input.end; ++i) {
+		const char *end = i == n - 1 ? input.end : nextLine(core_min(start + chunkSize, input.end), input.end);
+		chunks.push_back({start, end});
+		start = end;
+	}
+}
+
+int countLines(const Chunk &chunk) {
+	int lines = 0;
+	const char *p = chunk.start;
+	while (p < chunk.end) {
+		const char *nl = (const char *)memchr(p, '\n', chunk.end - p);
+		++lines;
+		if (nl == nullptr) {
+			break;
+		}
+		p = nl + 1;
+	}
+	return lines;
+}
+
+static const double Pow10[] = {1e0,	 1e1,  1e2,	 1e3,  1e4,	 1e5,  1e6,	 1e7,  1e8,	 1e9,  1e10, 1e11,
+							   1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+bool parseFloat(const char *&p, const char *end, float &out) {
+	const char *s = skipSpaces(p, end);
+	bool negative = false;
+	if (s < end && (*s == '-' || *s == '+')) {
+		negative = *s == '-';
+		++s;
+	}
+	uint64_t mantissa = 0u;
+	int exponent = 0;
+	int digits = 0;
+	bool found = false;
+	while (s < end && *s >= '0' && *s <= '9') {
+		// more digits than a double can represent only change the magnitude
+		if (digits < 19) {
+			mantissa = mantissa * 10u + (uint64_t)(*s - '0');
+			if (mantissa != 0u) {
+				++digits;
+			}
+		} else {
+			++exponent;
+		}
+		found = true;
+		++s;
+	}
+	if (s < end && *s == '.') {
+		++s;
+		while (s < end && *s >= '0' && *s <= '9') {
+			if (digits < 19) {
+				mantissa = mantissa * 10u + (uint64_t)(*s - '0');
+				if (mantissa != 0u) {
+					++digits;
+				}
+				--exponent;
+			}
+			found = true;
+			++s;
+		}
+	}
+	if (!found) {
+		// nan and inf are not expected in mesh files - but let the libc handle them
+		if (s >= end || (*s != 'n' && *s != 'N' && *s != 'i' && *s != 'I')) {
+			return false;
+		}
+		char buf[16];
+		const size_t len = core_min((size_t)(end - s), sizeof(buf) - 1);
+		SDL_memcpy(buf, s, len);
+		buf[len] = '\0';
+		char *parsedEnd = nullptr;
+		const double val = SDL_strtod(buf, &parsedEnd);
+		if (parsedEnd == buf) {
+			return false;
+		}
+		out = (float)(negative ? -val : val);
+		p = s + (parsedEnd - buf);
+		return true;
+	}
+	if (s < end && (*s == 'e' || *s == 'E')) {
+		const char *e = s + 1;
+		int exp = 0;
+		if (e < end && !isSpace(*e) && parseInt(e, end, exp)) {
+			exponent += exp;
+			s = e;
+		}
+	}
+	double val = (double)mantissa;
+	if (exponent < 0) {
+		val = -exponent <= 22 ? val / Pow10[-exponent] : val * pow(10.0, exponent);
+	} else if (exponent > 0) {
+		val = exponent <= 22 ? val * Pow10[exponent] : val * pow(10.0, exponent);
+	}
+	out = (float)(negative ? -val : val);
+	p = s;
+	return true;
+}
+
+} // namespace meshtext
+} // namespace voxelformat
@@ -0,0 +1,116 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/collection/Buffer.h"
+#include "core/collection/DynamicArray.h"
+#include <stddef.h>
+#include <stdint.h>
+
+namespace io {
+class SeekableReadStream;
+}
+
+namespace voxelformat {
+
+/**
+ * @brief Helpers for parsing huge ascii mesh files (obj, ply) in parallel
+ *
+ * The input is split into chunks at line boundaries. Each chunk is parsed on its own and the results are merged in
+ * the order of the chunks afterwards.
+ */
+namespace meshtext {
+
+struct Chunk {
+	const char *start;
+	const char *end;
+};
+
+/**
+ * @brief Gives access to the remaining bytes of the stream. If the stream is memory backed, the memory is used
+ * directly - otherwise the remaining bytes are read into the given buffer.
+ */
+bool remaining(io::SeekableReadStream &stream, core::Buffer<char> &buffer, Chunk &out);
+
+/**
+ * @brief Splits the given range into chunks that end at line boundaries. The amount of chunks depends on the size of
+ * the input and the available threads.
+ */
+void splitLines(const Chunk &input, core::DynamicArray<Chunk> &chunks);
+
+/**
+ * @return The amount of lines in the given chunk - a last line without line ending is counted, too
+ */
+int countLines(const Chunk &chunk);
+
+inline bool isSpace(char c) {
+	return c == ' ' || c == '\t' || c == '\r';
+}
+
+inline const char *skipSpaces(const char *p, const char *end) {
+	while (p < end && isSpace(*p)) {
+		++p;
+	}
+	return p;
+}
+
+/**
+ * @return The pointer to the first character after the line ending
+ */
+inline const char *nextLine(const char *p, const char *end) {
+	while (p < end && *p != '\n') {
+		++p;
+	}
+	return p < end ? p + 1 : end;
+}
+
+/**
+ * @return The pointer to the line ending or @c end - trailing spaces and carriage returns are excluded
+ */
+inline const char *lineEnd(const char *p, const char *end) {
+	const char *e = p;
+	while (e < end && *e != '\n') {
+		++e;
+	}
+	while (e > p && isSpace(e[-1])) {
+		--e;
+	}
+	return e;
+}
+
+/**
+ * @brief Parses a decimal number with optional fraction and exponent - leading spaces are skipped
+ * @note The value is computed in double precision from the decimal digits - this is not a correctly rounded parser
+ * for every input, but the error is way below the float precision for the values found in mesh files.
+ * @return @c false if no number was found at the given position - @c p is not modified in that case
+ */
+bool parseFloat(const char *&p, const char *end, float &out);
+
+/**
+ * @brief Parses a decimal integer with optional sign - leading spaces are skipped
+ * @return @c false if no number was found at the given position - @c p is not modified in that case
+ */
+inline bool parseInt(const char *&p, const char *end, int &out) {
+	const char *s = skipSpaces(p, end);
+	bool negative = false;
+	if (s < end && (*s == '-' || *s == '+')) {
+		negative = *s == '-';
+		++s;
+	}
+	if (s >= end || *s < '0' || *s > '9') {
+		return false;
+	}
+	int64_t val = 0;
+	while (s < end && *s >= '0' && *s <= '9') {
+		val = val * 10 + (*s - '0');
+		++s;
+	}
+	out = (int)(negative ? -val : val);
+	p = s;
+	return true;
+}
+
+} // namespace meshtext
+} // namespace voxelformat
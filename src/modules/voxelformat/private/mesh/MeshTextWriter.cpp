@@ -0,0 +1,105 @@
+/**
+ * @file
+ */
+
+#include "MeshTextWriter.h"
+#include "core/ArrayLength.h"
+#include "core/Common.h"
+#include "core/StandardLib.h"
+#include <SDL_stdinc.h>
+#include <math.h>
+
+namespace voxelformat {
+namespace meshtext {
+
+static const uint64_t Pow10[] = {1u, 10u, 100u, 1000u, 10000u, 100000u, 1000000u, 10000000u, 100000000u};
+
+TextBlock::TextBlock(TextBlock &&other) noexcept
+	: _buffer(other._buffer), _size(other._size), _capacity(other._capacity) {
+	other._buffer = nullptr;
+	other._size = 0u;
+	other._capacity = 0u;
+}
+
+TextBlock::~TextBlock() {
+	core_free(_buffer);
+}
+
+void TextBlock::grow(size_t bytes) {
+	const size_t capacity = core_max(_capacity * 2u, core_max(_size + bytes, (size_t)4096u));
+	char *buffer = (char *)core_malloc(capacity);
+	if (_buffer != nullptr) {
+		core_memcpy(buffer, _buffer, _size);
+		core_free(_buffer);
+	}
+	_buffer = buffer;
+	_capacity = capacity;
+}
+
+void TextBlock::addString(const char *str, size_t len) {
+	reserve(len);
+	core_memcpy(_buffer + _size, str, len);
+	_size += len;
+}
+
+void TextBlock::addString(const char *str) {
+	addString(str, SDL_strlen(str));
+}
+
+void TextBlock::addInt(int64_t value) {
+	char digits[24];
+	int n = 0;
+	uint64_t v = value < 0 ? (uint64_t)0 - (uint64_t)value : (uint64_t)value;
+	do {
+		digits[n++] = (char)('0' + v % 10u);
+		v /= 10u;
+	} while (v != 0u);
+	reserve((size_t)n + 1u);
+	if (value < 0) {
+		_buffer[_size++] = '-';
+	}
+	while (n > 0) {
+		_buffer[_size++] = digits[--n];
+	}
+}
+
+void TextBlock::addFloat(float value, int decimals) {
+	const double v = (double)value;
+	// out of the range of the fixed point conversion (or nan/inf) - let the libc handle this
+	if (decimals < 0 || decimals >= lengthof(Pow10) || !(fabs(v) < 1.0e10)) {
+		char buf[512];
+		const int len = SDL_snprintf(buf, sizeof(buf), "%.*f", decimals, v);
+		addString(buf, (size_t)core_min(core_max(len, 0), (int)sizeof(buf) - 1));
+		return;
+	}
+	const uint64_t scale = Pow10[decimals];
+	// a float has 24 bits of mantissa - multiplied by at most 10^8 this is exact in double precision, so the rounding
+	// can match printf exactly (round half to even for ties)
+	const double x = fabs(v) * (double)scale;
+	const double lower = floor(x);
+	uint64_t scaled = (uint64_t)lower;
+	const double rest = x - lower;
+	if (rest > 0.5 || (rest == 0.5 && (scaled & 1u) != 0u)) {
+		++scaled;
+	}
+	const uint64_t integer = scaled / scale;
+	uint64_t fraction = scaled % scale;
+	// printf keeps the sign for values that round to zero
+	if (signbit(v)) {
+		addChar('-');
+	}
+	addInt((int64_t)integer);
+	if (decimals == 0) {
+		return;
+	}
+	reserve((size_t)decimals + 1u);
+	_buffer[_size++] = '.';
+	for (int i = decimals - 1; i >= 0; --i) {
+		_buffer[_size + i] = (char)('0' + fraction % 10u);
+		fraction /= 10u;
+	}
+	_size += decimals;
+}
+
+} // namespace meshtext
+} // namespace voxelformat
@@ -0,0 +1,107 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "app/Async.h"
+#include "core/collection/DynamicArray.h"
+#include "io/Stream.h"
+#include <stddef.h>
+#include <stdint.h>
+
+namespace voxelformat {
+namespace meshtext {
+
+/**
+ * @brief Growing text buffer with a fast number formatter for the ascii mesh exporters
+ *
+ * The output of the float formatting is the same as printf's @c %.Nf
+ */
+class TextBlock {
+private:
+	char *_buffer = nullptr;
+	size_t _size = 0u;
+	size_t _capacity = 0u;
+
+	void grow(size_t bytes);
+
+public:
+	TextBlock() = default;
+	TextBlock(TextBlock &&other) noexcept;
+	TextBlock(const TextBlock &) = delete;
+	TextBlock &operator=(const TextBlock &) = delete;
+	~TextBlock();
+
+	inline void reserve(size_t bytes) {
+		if (_size + bytes > _capacity) {
+			grow(bytes);
+		}
+	}
+
+	inline void addChar(char c) {
+		reserve(1u);
+		_buffer[_size++] = c;
+	}
+
+	void addString(const char *str, size_t len);
+	void addString(const char *str);
+	void addInt(int64_t value);
+	/**
+	 * @param decimals The amount of digits after the decimal point - like @c %.Nf for printf
+	 */
+	void addFloat(float value, int decimals);
+
+	inline const char *data() const {
+		return _buffer;
+	}
+
+	inline size_t size() const {
+		return _size;
+	}
+
+	inline void clear() {
+		_size = 0u;
+	}
+};
+
+/**
+ * @brief Formats the items @c [0, count) in parallel blocks and writes the blocks in order to the given stream
+ *
+ * The functor is called as @c f(start, end, block) and has to append the text for the items @c [start, end) to the
+ * given @c TextBlock. Only a limited amount of blocks is kept in memory at the same time.
+ */
+template<class FUNC>
+bool writeParallel(io::WriteStream &stream, int count, FUNC &&func) {
+	// items per block - a few hundred kilobytes of text for the typical vertex or face line
+	const int itemsPerBlock = 8192;
+	const int blocks = (count + itemsPerBlock - 1) / itemsPerBlock;
+	if (blocks <= 0) {
+		return true;
+	}
+	app::App *app = app::App::getInstance();
+	const int threads = app == nullptr ? 1 : core_max(1, (int)app->threadPool().size());
+	const int window = core_min(blocks, threads * 4);
+	core::DynamicArray<TextBlock> texts(window);
+	for (int first = 0; first < blocks; first += window) {
+		const int n = core_min(window, blocks - first);
+		app::for_parallel(0, n, [&](int start, int end) {
+			for (int b = start; b < end; ++b) {
+				TextBlock &text = texts[b];
+				text.clear();
+				const int itemStart = (first + b) * itemsPerBlock;
+				func(itemStart, core_min(itemStart + itemsPerBlock, count), text);
+			}
+		});
+		for (int b = 0; b < n; ++b) {
+			const TextBlock &text = texts[b];
+			if (text.size() > 0u && stream.write(text.data(), text.size()) != (int)text.size()) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+} // namespace meshtext
+} // namespace voxelformat
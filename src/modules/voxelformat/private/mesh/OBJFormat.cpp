@@ -3,16 +3,20 @@
  */
 
 #include "OBJFormat.h"
+#include "MeshTextParser.h"
+#include "MeshTextWriter.h"
+#include "app/Async.h"
 #include "core/Color.h"
 #include "core/Log.h"
 #include "core/ScopedPtr.h"
 #include "core/StringUtil.h"
+#include "core/collection/Buffer.h"
 #include "core/collection/DynamicArray.h"
 #include "core/collection/StringMap.h"
 #include "engine-config.h"
 #include "image/Image.h"
 #include "io/Archive.h"
-#include "io/StdStreamBuf.h"
+#include "io/BufferedWriteStream.h"
 #include "scenegraph/SceneGraph.h"
 #include "scenegraph/SceneGraphNode.h"
 #include "voxel/ChunkMesh.h"
@@ -57,11 +61,14 @@ bool OBJFormat::writeMtlFile(io::SeekableWriteStream &stream, const core::String
 bool OBJFormat::saveMeshes(const core::Map<int, int> &, const scenegraph::SceneGraph &sceneGraph, const Meshes &meshes,
 						   const core::String &filename, const io::ArchivePtr &archive, const glm::vec3 &scale,
 						   bool quad, bool withColor, bool withTexCoords) {
-	core::ScopedPtr<io::SeekableWriteStream> stream(archive->writeStream(filename));
-	if (!stream) {
+	core::ScopedPtr<io::SeekableWriteStream> fileStream(archive->writeStream(filename));
+	if (!fileStream) {
 		Log::error("Could not open file %s", filename.c_str());
 		return false;
 	}
+	// the obj is written line by line - collect the lines before they hit the file
+	io::BufferedWriteStream bufferedStream(*fileStream);
+	io::BufferedWriteStream *stream = &bufferedStream;
 	stream->writeStringFormat(false, "# version " PROJECT_VERSION " github.com/vengi-voxel/vengi\n");
 	wrapBool(stream->writeStringFormat(false, "\n"))
 	wrapBool(stream->writeStringFormat(false, "g Model\n"))
@@ -80,8 +87,10 @@ bool OBJFormat::saveMeshes(const core::Map<int, int> &, const scenegraph::SceneG
 	int idxOffset = 0;
 	int texcoordOffset = 0;
 	for (const auto &meshExt : meshes) {
+		voxel::ChunkMesh unpacked(0, 0);
+		const voxel::ChunkMesh &chunkMesh = meshExt.unpack(unpacked);
 		for (int i = 0; i < voxel::ChunkMesh::Meshes; ++i) {
-			const voxel::Mesh *mesh = &meshExt.mesh->mesh[i];
+			const voxel::Mesh *mesh = &chunkMesh.mesh[i];
 			if (mesh->isEmpty()) {
 				continue;
 			}
@@ -114,104 +123,102 @@ bool OBJFormat::saveMeshes(const core::Map<int, int> &, const scenegraph::SceneG
 				return false;
 			}
 
-			for (int i = 0; i < nv; ++i) {
-				const voxel::VoxelVertex &v = vertices[i];
+			auto formatVertices = [&](int start, int end, meshtext::TextBlock &text) {
+				for (int i = start; i < end; ++i) {
+					const voxel::VoxelVertex &v = vertices[i];
 
-				glm::vec3 pos;
-				if (meshExt.applyTransform) {
-					pos = transform.apply(v.position, meshExt.pivot * meshExt.size);
-				} else {
-					pos = v.position;
-				}
-				pos *= scale;
-				stream->writeStringFormat(false, "v %.04f %.04f %.04f", pos.x, pos.y, pos.z);
-				if (withColor) {
-					const glm::vec4 &color = core::Color::fromRGBA(palette.color(v.colorIndex));
-					stream->writeStringFormat(false, " %.03f %.03f %.03f", color.r, color.g, color.b);
+					glm::vec3 pos;
+					if (meshExt.applyTransform) {
+						pos = transform.apply(v.position, meshExt.pivot * meshExt.size);
+					} else {
+						pos = v.position;
+					}
+					pos *= scale;
+					text.addString("v ", 2);
+					text.addFloat(pos.x, 4);
+					text.addChar(' ');
+					text.addFloat(pos.y, 4);
+					text.addChar(' ');
+					text.addFloat(pos.z, 4);
+					if (withColor) {
+						const glm::vec4 &color = core::Color::fromRGBA(palette.color(v.colorIndex));
+						text.addChar(' ');
+						text.addFloat(color.r, 3);
+						text.addChar(' ');
+						text.addFloat(color.g, 3);
+						text.addChar(' ');
+						text.addFloat(color.b, 3);
+					}
+					text.addChar('\n');
 				}
-				wrapBool(stream->writeStringFormat(false, "\n"))
-			}
+			};
+			wrapBool(meshtext::writeParallel(*stream, nv, formatVertices))
 			if (withNormals) {
-				for (int i = 0; i < nv; ++i) {
-					const glm::vec3 &norm = normals[i];
-					stream->writeStringFormat(false, "vn %.04f %.04f %.04f\n", norm.x, norm.y, norm.z);
-				}
+				auto formatNormals = [&](int start, int end, meshtext::TextBlock &text) {
+					for (int i = start; i < end; ++i) {
+						const glm::vec3 &norm = normals[i];
+						text.addString("vn ", 3);
+						text.addFloat(norm.x, 4);
+						text.addChar(' ');
+						text.addFloat(norm.y, 4);
+						text.addChar(' ');
+						text.addFloat(norm.z, 4);
+						text.addChar('\n');
+					}
+				};
+				wrapBool(meshtext::writeParallel(*stream, nv, formatNormals))
 			}
 
-			if (quad) {
-				if (withTexCoords) {
-					for (int i = 0; i < ni; i += 6) {
-						const voxel::VoxelVertex &v = vertices[indices[i]];
+			// the amount of indices per face and the amount of vertices that are written for each face
+			const int step = quad ? 6 : 3;
+			const int faceVertices = quad ? 4 : 3;
+			if (withTexCoords) {
+				const int uvFaces = (ni + step - 1) / step;
+				auto formatTexCoords = [&](int start, int end, meshtext::TextBlock &text) {
+					for (int f = start; f < end; ++f) {
+						const voxel::VoxelVertex &v = vertices[indices[f * step]];
 						const glm::vec2 &uv = paletteUV(v.colorIndex);
-						stream->writeStringFormat(false, "vt %f %f\n", uv.x, uv.y);
-						stream->writeStringFormat(false, "vt %f %f\n", uv.x, uv.y);
-						stream->writeStringFormat(false, "vt %f %f\n", uv.x, uv.y);
-						stream->writeStringFormat(false, "vt %f %f\n", uv.x, uv.y);
-					}
-				}
-
-				int uvi = texcoordOffset;
-				for (int i = 0; i < ni - 5; i += 6, uvi += 4) {
-					const uint32_t one = idxOffset + indices[i + 0] + 1;
-					const uint32_t two = idxOffset + indices[i + 1] + 1;
-					const uint32_t three = idxOffset + indices[i + 2] + 1;
-					const uint32_t four = idxOffset + indices[i + 5] + 1;
-					if (withTexCoords) {
-						if (withNormals) {
-							stream->writeStringFormat(false, "f %i/%i/%i %i/%i/%i %i/%i/%i %i/%i/%i\n", (int)one,
-													 uvi + 1, (int)one, (int)two, uvi + 2, (int)two, (int)three,
-													 uvi + 3, (int)three, (int)four, uvi + 4, (int)four);
-						} else {
-							stream->writeStringFormat(false, "f %i/%i %i/%i %i/%i %i/%i\n", (int)one, uvi + 1, (int)two,
-													 uvi + 2, (int)three, uvi + 3, (int)four, uvi + 4);
-						}
-					} else {
-						if (withNormals) {
-							stream->writeStringFormat(false, "f %i//%i %i//%i %i//%i %i//%i\n", (int)one, (int)two,
-													 (int)three, (int)four, (int)one, (int)two, (int)three, (int)four);
-						} else {
-							stream->writeStringFormat(false, "f %i %i %i %i\n", (int)one, (int)two, (int)three,
-													 (int)four);
+						for (int j = 0; j < faceVertices; ++j) {
+							text.addString("vt ", 3);
+							text.addFloat(uv.x, 6);
+							text.addChar(' ');
+							text.addFloat(uv.y, 6);
+							text.addChar('\n');
 						}
 					}
-				}
-				texcoordOffset += ni / 6 * 4;
-			} else {
-				if (withTexCoords) {
-					for (int i = 0; i < ni; i += 3) {
-						const voxel::VoxelVertex &v = vertices[indices[i]];
-						const glm::vec2 &uv = paletteUV(v.colorIndex);
-						stream->writeStringFormat(false, "vt %f %f\n", uv.x, uv.y);
-						stream->writeStringFormat(false, "vt %f %f\n", uv.x, uv.y);
-						stream->writeStringFormat(false, "vt %f %f\n", uv.x, uv.y);
-					}
-				}
+				};
+				wrapBool(meshtext::writeParallel(*stream, uvFaces, formatTexCoords))
+			}
 
-				for (int i = 0; i < ni; i += 3) {
-					const uint32_t one = idxOffset + indices[i + 0] + 1;
-					const uint32_t two = idxOffset + indices[i + 1] + 1;
-					const uint32_t three = idxOffset + indices[i + 2] + 1;
-					if (withTexCoords) {
-						if (withNormals) {
-							stream->writeStringFormat(false, "f %i/%i/%i %i/%i/%i %i/%i/%i\n", (int)one,
-													 texcoordOffset + i + 1, (int)one, (int)two, texcoordOffset + i + 2,
-													 (int)two, (int)three, texcoordOffset + i + 3, (int)three);
-						} else {
-							stream->writeStringFormat(false, "f %i/%i %i/%i %i/%i\n", (int)one, texcoordOffset + i + 1,
-													 (int)two, texcoordOffset + i + 2, (int)three,
-													 texcoordOffset + i + 3);
-						}
-					} else {
-						if (withNormals) {
-							stream->writeStringFormat(false, "f %i//%i %i//%i %i//%i\n", (int)one, (int)two, (int)three,
-													 (int)one, (int)two, (int)three);
-						} else {
-							stream->writeStringFormat(false, "f %i %i %i\n", (int)one, (int)two, (int)three);
+			auto formatFaces = [&](int start, int end, meshtext::TextBlock &text) {
+				for (int f = start; f < end; ++f) {
+					const int i = f * step;
+					int idx[4];
+					idx[0] = idxOffset + (int)indices[i + 0] + 1;
+					idx[1] = idxOffset + (int)indices[i + 1] + 1;
+					idx[2] = idxOffset + (int)indices[i + 2] + 1;
+					idx[3] = quad ? idxOffset + (int)indices[i + 5] + 1 : 0;
+					text.addChar('f');
+					for (int j = 0; j < faceVertices; ++j) {
+						text.addChar(' ');
+						text.addInt(idx[j]);
+						if (withTexCoords) {
+							text.addChar('/');
+							text.addInt(texcoordOffset + f * faceVertices + j + 1);
+							if (withNormals) {
+								text.addChar('/');
+								text.addInt(idx[j]);
+							}
+						} else if (withNormals) {
+							text.addString("//", 2);
+							text.addInt(idx[j]);
 						}
 					}
+					text.addChar('\n');
 				}
-				texcoordOffset += ni;
-			}
+			};
+			wrapBool(meshtext::writeParallel(*stream, ni / step, formatFaces))
+			texcoordOffset += ni / step * faceVertices;
 			idxOffset += nv;
 
 			if (paletteMaterialIndices.find(palette.hash()) == paletteMaterialIndices.end()) {
@@ -234,6 +241,192 @@ bool OBJFormat::saveMeshes(const core::Map<int, int> &, const scenegraph::SceneG
 
 #undef wrapBool
 
+namespace {
+
+struct ObjFaceVertex {
+	int v;
+	int vt;
+	/**
+	 * negative indices in the file are relative to the amount of vertices that were parsed so far - they are stored
+	 * relative to the start of the chunk and fixed up once the vertex offsets of the chunks are known
+	 */
+	bool vRelative;
+	bool vtRelative;
+};
+
+enum class ObjCommandType { Group, Object, UseMtl, MtlLib };
+
+struct ObjCommand {
+	ObjCommandType type;
+	/** the index of the first face of the chunk that is affected by this command */
+	int face;
+	core::String name;
+};
+
+struct ObjChunk {
+	core::DynamicArray<glm::vec3> positions;
+	core::DynamicArray<glm::vec3> colors;
+	core::DynamicArray<glm::vec2> texcoords;
+	core::DynamicArray<ObjFaceVertex> faceVertices;
+	/** index of the first face vertex of each face - with one extra element for the end */
+	core::DynamicArray<int> faceOffsets;
+	core::DynamicArray<ObjCommand> commands;
+	bool allColors = true;
+	int vertexOffset = 0;
+	int texcoordOffset = 0;
+};
+
+/**
+ * A range of faces in a chunk that share the target shape and the material
+ */
+struct ObjSegment {
+	int chunk;
+	int firstFace;
+	int endFace;
+	int shape;
+	int material;
+	/** the index of the first triangle in the shape */
+	size_t firstTri;
+};
+
+struct ObjShape {
+	core::String name;
+	size_t tris = 0u;
+};
+
+} // namespace
+
+static bool objKeyword(const char *p, const char *end, const char *keyword, size_t len) {
+	if ((size_t)(end - p) <= len || SDL_memcmp(p, keyword, len) != 0) {
+		return false;
+	}
+	return meshtext::isSpace(p[len]);
+}
+
+/**
+ * @return @c false if any of the vertex or texture coordinate indices of the face is out of bounds
+ */
+static bool validObjFace(const ObjChunk &chunk, int face, size_t vertexCount, size_t texcoordCount) {
+	for (int i = chunk.faceOffsets[face]; i < chunk.faceOffsets[face + 1]; ++i) {
+		const ObjFaceVertex &fv = chunk.faceVertices[i];
+		const int v = fv.vRelative ? fv.v + chunk.vertexOffset : fv.v;
+		const int vt = fv.vtRelative ? fv.vt + chunk.texcoordOffset : fv.vt;
+		if (v < 0 || (size_t)v >= vertexCount) {
+			return false;
+		}
+		// a texture coordinate index of -1 means that the vertex doesn't have one
+		if ((vt >= 0 && (size_t)vt >= texcoordCount) || (fv.vtRelative && vt < 0)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool parseObjFaceVertex(const char *&p, const char *end, const ObjChunk &chunk, ObjFaceVertex &fv) {
+	int v = 0;
+	if (!meshtext::parseInt(p, end, v) || v == 0) {
+		return false;
+	}
+	fv.vRelative = v < 0;
+	fv.v = v < 0 ? (int)chunk.positions.size() + v : v - 1;
+	fv.vt = -1;
+	fv.vtRelative = false;
+	if (p < end && *p == '/') {
+		++p;
+		int vt = 0;
+		if (p < end && *p != '/' && meshtext::parseInt(p, end, vt) && vt != 0) {
+			fv.vtRelative = vt < 0;
+			fv.vt = vt < 0 ? (int)chunk.texcoords.size() + vt : vt - 1;
+		}
+		if (p < end && *p == '/') {
+			++p;
+			int vn = 0;
+			meshtext::parseInt(p, end, vn);
+		}
+	}
+	return true;
+}
+
+static void parseObjChunk(const meshtext::Chunk &input, ObjChunk &chunk) {
+	const char *p = input.start;
+	const char *end = input.end;
+	while (p < end) {
+		const char *line = meshtext::skipSpaces(p, end);
+		const char *next = meshtext::nextLine(line, end);
+		const char *eol = meshtext::lineEnd(line, end);
+		p = next;
+		const ptrdiff_t len = eol - line;
+		if (len <= 0 || *line == '#') {
+			continue;
+		}
+		if (len > 1 && line[0] == 'v' && meshtext::isSpace(line[1])) {
+			const char *t = line + 2;
+			glm::vec3 pos(0.0f);
+			meshtext::parseFloat(t, eol, pos.x);
+			meshtext::parseFloat(t, eol, pos.y);
+			meshtext::parseFloat(t, eol, pos.z);
+			chunk.positions.push_back(pos);
+			glm::vec3 color(1.0f);
+			int components = 0;
+			for (int i = 0; i < 3 && meshtext::parseFloat(t, eol, color[i]); ++i) {
+				++components;
+			}
+			if (components == 3) {
+				chunk.colors.push_back(color);
+			} else {
+				chunk.allColors = false;
+				chunk.colors.push_back(glm::vec3(1.0f));
+			}
+		} else if (len > 2 && line[0] == 'v' && line[1] == 't' && meshtext::isSpace(line[2])) {
+			const char *t = line + 3;
+			glm::vec2 uv(0.0f);
+			meshtext::parseFloat(t, eol, uv.x);
+			meshtext::parseFloat(t, eol, uv.y);
+			chunk.texcoords.push_back(uv);
+		} else if (len > 1 && line[0] == 'f' && meshtext::isSpace(line[1])) {
+			const char *t = line + 2;
+			const size_t first = chunk.faceVertices.size();
+			ObjFaceVertex fv;
+			while (parseObjFaceVertex(t, eol, chunk, fv)) {
+				chunk.faceVertices.push_back(fv);
+			}
+			if (chunk.faceVertices.size() - first < 3) {
+				// degenerated face
+				chunk.faceVertices.erase(first, chunk.faceVertices.size() - first);
+				continue;
+			}
+			chunk.faceOffsets.push_back((int)first);
+		} else if (len > 1 && line[0] == 'g' && meshtext::isSpace(line[1])) {
+			// multiple group names are joined with a single space
+			core::String name;
+			const char *t = meshtext::skipSpaces(line + 2, eol);
+			while (t < eol) {
+				const char *tokenEnd = t;
+				while (tokenEnd < eol && !meshtext::isSpace(*tokenEnd)) {
+					++tokenEnd;
+				}
+				if (!name.empty()) {
+					name += " ";
+				}
+				name += core::String(t, tokenEnd - t);
+				t = meshtext::skipSpaces(tokenEnd, eol);
+			}
+			chunk.commands.push_back({ObjCommandType::Group, (int)chunk.faceOffsets.size(), name});
+		} else if (len > 1 && line[0] == 'o' && meshtext::isSpace(line[1])) {
+			const char *t = meshtext::skipSpaces(line + 2, eol);
+			chunk.commands.push_back({ObjCommandType::Object, (int)chunk.faceOffsets.size(), core::String(t, eol - t)});
+		} else if (objKeyword(line, eol, "usemtl", 6)) {
+			const char *t = meshtext::skipSpaces(line + 6, eol);
+			chunk.commands.push_back({ObjCommandType::UseMtl, (int)chunk.faceOffsets.size(), core::String(t, eol - t)});
+		} else if (objKeyword(line, eol, "mtllib", 6)) {
+			const char *t = meshtext::skipSpaces(line + 6, eol);
+			chunk.commands.push_back({ObjCommandType::MtlLib, (int)chunk.faceOffsets.size(), core::String(t, eol - t)});
+		}
+		// vn, l, p, s and others are not needed for voxelization
+	}
+	chunk.faceOffsets.push_back((int)chunk.faceVertices.size());
+}
+
 bool OBJFormat::voxelizeGroups(const core::String &filename, const io::ArchivePtr &archive,
 							   scenegraph::SceneGraph &sceneGraph, const LoadContext &ctx) {
 	core::ScopedPtr<io::SeekableReadStream> stream(archive->readStream(filename));
@@ -241,38 +434,112 @@ bool OBJFormat::voxelizeGroups(const core::String &filename, const io::ArchivePt
 		Log::error("Could not load file %s", filename.c_str());
 		return false;
 	}
-	tinyobj::attrib_t attrib;
-	std::vector<tinyobj::shape_t> shapes;
+	Log::debug("Load obj %s", filename.c_str());
+	core::Buffer<char> buffer;
+	meshtext::Chunk input;
+	if (!meshtext::remaining(*stream, buffer, input)) {
+		Log::error("Failed to read obj '%s'", filename.c_str());
+		return false;
+	}
+	core::DynamicArray<meshtext::Chunk> inputChunks;
+	meshtext::splitLines(input, inputChunks);
+	core::DynamicArray<ObjChunk> chunks;
+	chunks.resize(inputChunks.size());
+	app::for_parallel(0, (int)inputChunks.size(), [&inputChunks, &chunks](int start, int end) {
+		for (int i = start; i < end; ++i) {
+			parseObjChunk(inputChunks[i], chunks[i]);
+		}
+	});
+
+	// merge the vertex attributes of the chunks
+	core::DynamicArray<glm::vec3> positions;
+	core::DynamicArray<glm::vec3> colors;
+	core::DynamicArray<glm::vec2> texcoords;
+	bool allColors = true;
+	size_t vertexCount = 0u;
+	size_t texcoordCount = 0u;
+	for (ObjChunk &chunk : chunks) {
+		chunk.vertexOffset = (int)vertexCount;
+		chunk.texcoordOffset = (int)texcoordCount;
+		vertexCount += chunk.positions.size();
+		texcoordCount += chunk.texcoords.size();
+		allColors &= chunk.allColors;
+	}
+	positions.reserve(vertexCount);
+	texcoords.reserve(texcoordCount);
+	if (allColors) {
+		colors.reserve(vertexCount);
+	}
+	for (ObjChunk &chunk : chunks) {
+		positions.append(chunk.positions);
+		texcoords.append(chunk.texcoords);
+		if (allColors) {
+			colors.append(chunk.colors);
+		}
+		chunk.positions.release();
+		chunk.texcoords.release();
+		chunk.colors.release();
+	}
+
+	// the commands are executed in file order - this builds the shapes and loads the materials
 	std::vector<tinyobj::material_t> materials;
-	std::string warn;
-	std::string err;
+	std::map<std::string, int> materialMap;
 	const core::String &mtlbasedir = core::string::extractPath(filename);
-	io::StdIStreamBuf stdStreamBuf(*stream);
-	std::istream inputStream(&stdStreamBuf);
 	// TODO: use the archive
 	tinyobj::MaterialFileReader matFileReader(mtlbasedir.c_str());
-	Log::debug("Load obj %s", filename.c_str());
-	const bool ret =
-		tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, &inputStream, &matFileReader, true, false);
-	if (!warn.empty()) {
-		core::DynamicArray<core::String> lines;
-		core::string::splitString(warn.c_str(), lines, "\n");
-		for (const core::String &str : lines) {
-			Log::warn("%s", str.c_str());
+	core::DynamicArray<ObjShape> shapes;
+	core::DynamicArray<ObjSegment> segments;
+	core::String shapeName;
+	int shape = -1;
+	int material = -1;
+	auto addSegment = [&](int chunk, int firstFace, int endFace) {
+		if (firstFace >= endFace) {
+			return;
 		}
-	}
-	if (!err.empty()) {
-		core::DynamicArray<core::String> lines;
-		core::string::splitString(err.c_str(), lines, "\n");
-		for (const core::String &str : lines) {
-			Log::error("%s", str.c_str());
+		if (shape == -1) {
+			shapes.push_back({shapeName, 0u});
+			shape = (int)shapes.size() - 1;
 		}
+		segments.push_back({chunk, firstFace, endFace, shape, material, 0u});
+	};
+	for (int c = 0; c < (int)chunks.size(); ++c) {
+		const ObjChunk &chunk = chunks[c];
+		const int faceCount = (int)chunk.faceOffsets.size() - 1;
+		int face = 0;
+		for (const ObjCommand &cmd : chunk.commands) {
+			addSegment(c, face, cmd.face);
+			face = cmd.face;
+			if (cmd.type == ObjCommandType::Group || cmd.type == ObjCommandType::Object) {
+				shapeName = cmd.name;
+				shape = -1;
+			} else if (cmd.type == ObjCommandType::UseMtl) {
+				auto iter = materialMap.find(cmd.name.c_str());
+				if (iter == materialMap.end()) {
+					Log::warn("material [ '%s' ] not found in .mtl", cmd.name.c_str());
+					material = -1;
+				} else {
+					material = iter->second;
+				}
+			} else if (cmd.type == ObjCommandType::MtlLib) {
+				core::DynamicArray<core::String> mtlFiles;
+				core::string::splitString(cmd.name, mtlFiles);
+				for (const core::String &mtlFile : mtlFiles) {
+					std::string warn;
+					std::string err;
+					const bool loaded = matFileReader(mtlFile.c_str(), &materials, &materialMap, &warn, &err);
+					if (!warn.empty()) {
+						Log::warn("%s", warn.c_str());
+					}
+					if (loaded) {
+						break;
+					}
+					Log::warn("Failed to load material file %s: %s", mtlFile.c_str(), err.c_str());
+				}
+			}
+		}
+		addSegment(c, face, faceCount);
 	}
-	if (!ret) {
-		Log::error("Failed to load obj '%s': %s", filename.c_str(), err.c_str());
-		return false;
-	}
-	if (shapes.size() == 0) {
+	if (shapes.empty()) {
 		Log::error("No shapes found in the model");
 		return false;
 	}
@@ -311,62 +578,94 @@ bool OBJFormat::voxelizeGroups(const core::String &filename, const io::ArchivePt
 			Log::warn("Failed to load image %s from %s", name.c_str(), material.name.c_str());
 		}
 	}
+	core::DynamicArray<image::ImagePtr> materialTextures;
+	materialTextures.resize(materials.size());
+	for (size_t i = 0; i < materials.size(); ++i) {
+		const core::String diffuseTexture = materials[i].diffuse_texname.c_str();
+		if (diffuseTexture.empty()) {
+			continue;
+		}
+		auto textureIter = textures.find(diffuseTexture);
+		if (textureIter != textures.end()) {
+			materialTextures[i] = textureIter->second;
+		} else {
+			Log::warn("Failed to look up texture %s", diffuseTexture.c_str());
+		}
+	}
 
-	const glm::vec3 &scale = getInputScale();
-	for (tinyobj::shape_t &shape : shapes) {
-		int indexOffset = 0;
-		// TODO: shape.lines, shape.points
-		const tinyobj::mesh_t &mesh = shape.mesh;
-		for (const tinyobj::tag_t &tag : mesh.tags) {
-			Log::debug("tag: %s", tag.name.c_str());
+	// every face with n vertices is triangulated as a fan of n - 2 triangles
+	const size_t posCount = positions.size();
+	const size_t uvCount = texcoords.size();
+	int invalidFaces = 0;
+	for (ObjSegment &segment : segments) {
+		const ObjChunk &chunk = chunks[segment.chunk];
+		ObjShape &objShape = shapes[segment.shape];
+		segment.firstTri = objShape.tris;
+		for (int f = segment.firstFace; f < segment.endFace; ++f) {
+			if (!validObjFace(chunk, f, posCount, uvCount)) {
+				++invalidFaces;
+				continue;
+			}
+			objShape.tris += chunk.faceOffsets[f + 1] - chunk.faceOffsets[f] - 2;
 		}
-		TriCollection tris;
-		tris.reserve(mesh.num_face_vertices.size());
-		for (size_t faceNum = 0; faceNum < mesh.num_face_vertices.size(); ++faceNum) {
-			const int faceVertices = mesh.num_face_vertices[faceNum];
-			core_assert_msg(faceVertices == 3, "Unexpected indices for triangulated mesh: %i", faceVertices);
-			voxelformat::TexturedTri tri;
-			for (int i = 0; i < faceVertices; ++i) {
-				const tinyobj::index_t &idx = mesh.indices[indexOffset + i];
-				tri.vertices[i].x = attrib.vertices[3 * idx.vertex_index + 0] * scale.x;
-				tri.vertices[i].y = attrib.vertices[3 * idx.vertex_index + 1] * scale.y;
-				tri.vertices[i].z = attrib.vertices[3 * idx.vertex_index + 2] * scale.z;
-				if (!attrib.colors.empty()) {
-					const float r = attrib.colors[3 * idx.vertex_index + 0];
-					const float g = attrib.colors[3 * idx.vertex_index + 1];
-					const float b = attrib.colors[3 * idx.vertex_index + 2];
-					tri.color[i] = core::Color::getRGBA(glm::vec4(r, g, b, 1.0f));
-				}
-				if (idx.texcoord_index >= 0) {
-					tri.uv[i].x = attrib.texcoords[2 * idx.texcoord_index + 0];
-					tri.uv[i].y = attrib.texcoords[2 * idx.texcoord_index + 1];
-				}
+	}
+	if (invalidFaces > 0) {
+		Log::warn("Skipped %i faces with invalid vertex indices", invalidFaces);
+	}
+	core::DynamicArray<TriCollection> shapeTris;
+	shapeTris.resize(shapes.size());
+	for (size_t i = 0; i < shapes.size(); ++i) {
+		shapeTris[i].resize(shapes[i].tris);
+	}
+
+	const glm::vec3 &scale = getInputScale();
+	app::for_parallel(0, (int)segments.size(), [&](int start, int end) {
+		for (int s = start; s < end; ++s) {
+			const ObjSegment &segment = segments[s];
+			const ObjChunk &chunk = chunks[segment.chunk];
+			TriCollection &tris = shapeTris[segment.shape];
+			const tinyobj::material_t *mat = segment.material < 0 ? nullptr : &materials[segment.material];
+			core::RGBA diffuseColor(0, 0, 0, 255);
+			if (mat != nullptr) {
+				diffuseColor =
+					core::Color::getRGBA(glm::vec4(mat->diffuse[0], mat->diffuse[1], mat->diffuse[2], 1.0f));
 			}
-			const int materialIndex = mesh.material_ids[faceNum];
-			const tinyobj::material_t *material = materialIndex < 0 ? nullptr : &materials[materialIndex];
-			if (material != nullptr) {
-				const core::String diffuseTexture = material->diffuse_texname.c_str();
-				if (!diffuseTexture.empty()) {
-					auto textureIter = textures.find(diffuseTexture);
-					if (textureIter != textures.end()) {
-						tri.texture = textureIter->second;
-					} else {
-						Log::warn("Failed to look up texture %s", diffuseTexture.c_str());
-						textures.put(diffuseTexture, image::ImagePtr());
-					}
+			size_t triIdx = segment.firstTri;
+			for (int f = segment.firstFace; f < segment.endFace; ++f) {
+				if (!validObjFace(chunk, f, posCount, uvCount)) {
+					continue;
 				}
-				if (attrib.colors.empty()) {
-					const glm::vec4 diffuseColor(material->diffuse[0], material->diffuse[1], material->diffuse[2],
-												 1.0f);
-					tri.color[0] = tri.color[1] = tri.color[2] = core::Color::getRGBA(diffuseColor);
+				const int first = chunk.faceOffsets[f];
+				const int count = chunk.faceOffsets[f + 1] - first;
+				for (int t = 0; t < count - 2; ++t) {
+					const int corners[3] = {0, t + 1, t + 2};
+					voxelformat::TexturedTri &tri = tris[triIdx++];
+					for (int i = 0; i < 3; ++i) {
+						const ObjFaceVertex &fv = chunk.faceVertices[first + corners[i]];
+						const int vi = fv.vRelative ? fv.v + chunk.vertexOffset : fv.v;
+						const int vti = fv.vtRelative ? fv.vt + chunk.texcoordOffset : fv.vt;
+						tri.vertices[i] = positions[vi] * scale;
+						if (!colors.empty()) {
+							tri.color[i] = core::Color::getRGBA(glm::vec4(colors[vi], 1.0f));
+						}
+						if (vti >= 0) {
+							tri.uv[i] = texcoords[vti];
+						}
+					}
+					if (mat != nullptr) {
+						tri.texture = materialTextures[segment.material];
+						if (colors.empty()) {
+							tri.color[0] = tri.color[1] = tri.color[2] = diffuseColor;
+						}
+					}
 				}
 			}
-			tris.push_back(tri);
-
-			indexOffset += faceVertices;
 		}
-		if (voxelizeNode(shape.name.c_str(), sceneGraph, tris) < 0) {
-			Log::error("Failed to voxelize shape %s", shape.name.c_str());
+	});
+
+	for (size_t i = 0; i < shapes.size(); ++i) {
+		if (voxelizeNode(shapes[i].name, sceneGraph, shapeTris[i]) < 0) {
+			Log::error("Failed to voxelize shape %s", shapes[i].name.c_str());
 			return false;
 		}
 	}
@@ -3,12 +3,16 @@
  */
 
 #include "PLYFormat.h"
+#include "MeshTextParser.h"
+#include "MeshTextWriter.h"
+#include "app/Async.h"
 #include "core/Color.h"
 #include "core/GameConfig.h"
 #include "core/Log.h"
 #include "core/ScopedPtr.h"
 #include "core/StringUtil.h"
 #include "core/Var.h"
+#include "core/collection/Buffer.h"
 #include "core/collection/DynamicArray.h"
 #include "engine-config.h"
 #include "io/Archive.h"
@@ -282,115 +286,202 @@ bool PLYFormat::parseHeader(io::SeekableReadStream &stream, Header &header) {
 	return true;
 }
 
-bool PLYFormat::parseFacesAscii(const Element &element, io::SeekableReadStream &stream, core::DynamicArray<Face> &faces,
-								core::DynamicArray<Polygon> &polygons) const {
-	core::DynamicArray<core::String> tokens;
-	tokens.reserve(32);
+namespace {
 
-	faces.reserve(element.count);
-	for (int idx = 0; idx < element.count; ++idx) {
-		core::String line;
-		wrapBool(stream.readLine(line))
-		tokens.clear();
-		core::string::splitString(line, tokens);
-		if (tokens.size() < element.properties.size()) {
-			Log::error("Invalid ply face: %s", line.c_str());
+struct PlyAsciiChunk {
+	/** the index of the first line of the chunk in the ascii body */
+	int firstLine = 0;
+	int lines = 0;
+	core::DynamicArray<PLYFormat::Face> faces;
+	core::DynamicArray<PLYFormat::Polygon> polygons;
+	bool success = true;
+};
+
+} // namespace
+
+static bool parsePlyVertexAscii(const PLYFormat::Element &element, const char *p, const char *end,
+								PLYFormat::Vertex &vertex) {
+	for (const PLYFormat::Property &prop : element.properties) {
+		if (prop.isList) {
+			int n = 0;
+			if (!meshtext::parseInt(p, end, n)) {
+				return false;
+			}
+			float skip;
+			for (int i = 0; i < n; ++i) {
+				if (!meshtext::parseFloat(p, end, skip)) {
+					return false;
+				}
+			}
+			continue;
+		}
+		float val = 0.0f;
+		if (!meshtext::parseFloat(p, end, val)) {
 			return false;
 		}
-		const int indices = core::string::toInt(tokens[0]);
-		if (indices == 3) {
-			Face face;
-			face.indices[0] = core::string::toInt(tokens[1]);
-			face.indices[1] = core::string::toInt(tokens[2]);
-			face.indices[2] = core::string::toInt(tokens[3]);
-			faces.push_back(face);
-		} else if (indices == 4) {
-			// triangle fan
-			Face face1;
-			face1.indices[0] = core::string::toInt(tokens[1]);
-			face1.indices[1] = core::string::toInt(tokens[2]);
-			face1.indices[2] = core::string::toInt(tokens[3]);
-			faces.push_back(face1);
-
-			Face face2;
-			face2.indices[0] = core::string::toInt(tokens[1]);
-			face2.indices[1] = core::string::toInt(tokens[3]);
-			face2.indices[2] = core::string::toInt(tokens[4]);
-			faces.push_back(face2);
-		} else {
-			Polygon polygon;
-			polygon.indices.reserve(indices);
-			for (int64_t i = 0; i < indices; ++i) {
-				const int idx = core::string::toInt(tokens[i + 1]);
-				polygon.indices.push_back(idx);
+		switch (prop.use) {
+		case PLYFormat::PropertyUse::x:
+			vertex.position.x = val;
+			break;
+		case PLYFormat::PropertyUse::y:
+			vertex.position.y = val;
+			break;
+		case PLYFormat::PropertyUse::z:
+			vertex.position.z = val;
+			break;
+		case PLYFormat::PropertyUse::nx:
+			vertex.normal.x = val;
+			break;
+		case PLYFormat::PropertyUse::ny:
+			vertex.normal.y = val;
+			break;
+		case PLYFormat::PropertyUse::nz:
+			vertex.normal.z = val;
+			break;
+		case PLYFormat::PropertyUse::red:
+			vertex.color.r = (uint8_t)(int)val;
+			break;
+		case PLYFormat::PropertyUse::green:
+			vertex.color.g = (uint8_t)(int)val;
+			break;
+		case PLYFormat::PropertyUse::blue:
+			vertex.color.b = (uint8_t)(int)val;
+			break;
+		case PLYFormat::PropertyUse::alpha:
+			vertex.color.a = (uint8_t)(int)val;
+			break;
+		case PLYFormat::PropertyUse::s:
+			vertex.texCoord.x = val;
+			break;
+		case PLYFormat::PropertyUse::t:
+			vertex.texCoord.y = val;
+			break;
+		case PLYFormat::PropertyUse::Max:
+			break;
+		}
+	}
+	return true;
+}
+
+static bool parsePlyFaceAscii(const char *p, const char *end, PlyAsciiChunk &chunk) {
+	int indices = 0;
+	if (!meshtext::parseInt(p, end, indices) || indices < 0) {
+		return false;
+	}
+	int idx[4];
+	if (indices == 3 || indices == 4) {
+		for (int i = 0; i < indices; ++i) {
+			if (!meshtext::parseInt(p, end, idx[i])) {
+				return false;
 			}
-			polygons.push_back(polygon);
 		}
+		chunk.faces.push_back({{idx[0], idx[1], idx[2]}});
+		if (indices == 4) {
+			// triangle fan
+			chunk.faces.push_back({{idx[0], idx[2], idx[3]}});
+		}
+		return true;
 	}
+	PLYFormat::Polygon polygon;
+	polygon.indices.reserve(indices);
+	for (int i = 0; i < indices; ++i) {
+		int index;
+		if (!meshtext::parseInt(p, end, index)) {
+			return false;
+		}
+		polygon.indices.push_back(index);
+	}
+	chunk.polygons.push_back(polygon);
 	return true;
 }
 
-bool PLYFormat::parseVerticesAscii(const Element &element, io::SeekableReadStream &stream,
-								   core::DynamicArray<Vertex> &vertices) const {
-	core::DynamicArray<core::String> tokens;
-	tokens.reserve(32);
+bool PLYFormat::parseAscii(io::SeekableReadStream &stream, const Header &header, core::DynamicArray<Vertex> &vertices,
+						   core::DynamicArray<Face> *faces, core::DynamicArray<Polygon> *polygons) const {
+	core::Buffer<char> buffer;
+	meshtext::Chunk input;
+	if (!meshtext::remaining(stream, buffer, input)) {
+		Log::error("Failed to read the ply body");
+		return false;
+	}
+	core::DynamicArray<meshtext::Chunk> inputChunks;
+	meshtext::splitLines(input, inputChunks);
+	const int chunkCount = (int)inputChunks.size();
+	core::DynamicArray<PlyAsciiChunk> chunks;
+	chunks.resize(chunkCount);
+	app::for_parallel(0, chunkCount, [&inputChunks, &chunks](int start, int end) {
+		for (int i = start; i < end; ++i) {
+			chunks[i].lines = meshtext::countLines(inputChunks[i]);
+		}
+	});
+	int lines = 0;
+	for (PlyAsciiChunk &chunk : chunks) {
+		chunk.firstLine = lines;
+		lines += chunk.lines;
+	}
+
+	// every element occupies one line - the elements are stored one after another
+	int vertexLine = -1;
+	int faceLine = -1;
+	const Element *vertexElement = nullptr;
+	const Element *faceElement = nullptr;
+	int elementLines = 0;
+	for (const Element &element : header.elements) {
+		if (element.name == "vertex") {
+			vertexLine = elementLines;
+			vertexElement = &element;
+		} else if (element.name == "face") {
+			faceLine = elementLines;
+			faceElement = &element;
+		}
+		elementLines += element.count;
+	}
+	if (lines < elementLines) {
+		Log::error("Expected %i lines in the ply body but found %i", elementLines, lines);
+		return false;
+	}
+	if (vertexElement != nullptr) {
+		vertices.resize(vertexElement->count);
+	}
+	if (faces == nullptr) {
+		faceElement = nullptr;
+	}
+
+	app::for_parallel(0, chunkCount, [&](int start, int end) {
+		for (int i = start; i < end; ++i) {
+			PlyAsciiChunk &chunk = chunks[i];
+			const char *p = inputChunks[i].start;
+			const char *chunkEnd = inputChunks[i].end;
+			for (int line = chunk.firstLine; p < chunkEnd; ++line) {
+				const char *next = meshtext::nextLine(p, chunkEnd);
+				const char *eol = meshtext::lineEnd(p, chunkEnd);
+				if (vertexElement != nullptr && line >= vertexLine && line < vertexLine + vertexElement->count) {
+					if (!parsePlyVertexAscii(*vertexElement, p, eol, vertices[line - vertexLine])) {
+						Log::error("Invalid ply vertex: %s", core::String(p, eol - p).c_str());
+						chunk.success = false;
+						break;
+					}
+				} else if (faceElement != nullptr && line >= faceLine && line < faceLine + faceElement->count) {
+					if (!parsePlyFaceAscii(p, eol, chunk)) {
+						Log::error("Invalid ply face: %s", core::String(p, eol - p).c_str());
+						chunk.success = false;
+						break;
+					}
+				}
+				p = next;
+			}
+		}
+	});
 
-	vertices.reserve(element.count);
-	for (int idx = 0; idx < element.count; ++idx) {
-		core::String line;
-		wrapBool(stream.readLine(line))
-		tokens.clear();
-		core::string::splitString(line, tokens);
-		if (tokens.size() < element.properties.size()) {
-			Log::error("Invalid ply vertex: %s", line.c_str());
+	for (PlyAsciiChunk &chunk : chunks) {
+		if (!chunk.success) {
 			return false;
 		}
-		Vertex vertex;
-		for (size_t i = 0; i < element.properties.size(); ++i) {
-			const Property &prop = element.properties[i];
-			Log::trace("%s: %s", prop.name.c_str(), tokens[i].c_str());
-			switch (prop.use) {
-			case PropertyUse::x:
-				vertex.position.x = core::string::toFloat(tokens[i]);
-				break;
-			case PropertyUse::y:
-				vertex.position.y = core::string::toFloat(tokens[i]);
-				break;
-			case PropertyUse::z:
-				vertex.position.z = core::string::toFloat(tokens[i]);
-				break;
-			case PropertyUse::nx:
-				vertex.normal.x = core::string::toFloat(tokens[i]);
-				break;
-			case PropertyUse::ny:
-				vertex.normal.y = core::string::toFloat(tokens[i]);
-				break;
-			case PropertyUse::nz:
-				vertex.normal.z = core::string::toFloat(tokens[i]);
-				break;
-			case PropertyUse::red:
-				vertex.color.r = core::string::toInt(tokens[i]);
-				break;
-			case PropertyUse::green:
-				vertex.color.g = core::string::toInt(tokens[i]);
-				break;
-			case PropertyUse::blue:
-				vertex.color.b = core::string::toInt(tokens[i]);
-				break;
-			case PropertyUse::alpha:
-				vertex.color.a = core::string::toInt(tokens[i]);
-				break;
-			case PropertyUse::s:
-				vertex.texCoord.x = core::string::toFloat(tokens[i]);
-				break;
-			case PropertyUse::t:
-				vertex.texCoord.y = core::string::toFloat(tokens[i]);
-				break;
-			case PropertyUse::Max:
-				break;
-			}
+		if (faces != nullptr) {
+			faces->append(chunk.faces);
+		}
+		if (polygons != nullptr) {
+			polygons->append(chunk.polygons);
 		}
-		vertices.push_back(vertex);
 	}
 	return true;
 }
@@ -416,20 +507,7 @@ bool PLYFormat::parsePointCloudBinary(const core::String &filename, io::Seekable
 bool PLYFormat::parsePointCloudAscii(const core::String &filename, io::SeekableReadStream &stream,
 									 scenegraph::SceneGraph &sceneGraph, const Header &header,
 									 core::DynamicArray<Vertex> &vertices) const {
-	for (int i = 0; i < (int)header.elements.size(); ++i) {
-		const Element &element = header.elements[i];
-		if (element.name != "vertex") {
-			for (int skip = 0; skip < element.count; ++skip) {
-				core::String line;
-				wrapBool(stream.readLine(line))
-			}
-			continue;
-		}
-		if (!parseVerticesAscii(element, stream, vertices)) {
-			return false;
-		}
-	}
-	return true;
+	return parseAscii(stream, header, vertices, nullptr, nullptr);
 }
 
 bool PLYFormat::parsePointCloud(const core::String &filename, io::SeekableReadStream &stream,
@@ -447,27 +525,47 @@ bool PLYFormat::parsePointCloud(const core::String &filename, io::SeekableReadSt
 	}
 	core::DynamicArray<PointCloudVertex> pointCloud;
 	pointCloud.resize(vertices.size());
-	for (int i = 0; i < (int)vertices.size(); ++i) {
+	for (size_t i = 0; i < vertices.size(); ++i) {
 		pointCloud[i].position = vertices[i].position;
 		pointCloud[i].color = vertices[i].color;
 	}
-	return voxelizePointCloud(filename, sceneGraph, pointCloud);
+	return voxelizePointCloud(filename, sceneGraph, pointCloud, ctx);
 }
 
 void PLYFormat::convertToTris(TriCollection &tris, core::DynamicArray<Vertex> &vertices,
 							  core::DynamicArray<Face> &faces) const {
-	tris.reserve(tris.size() + faces.size());
-	for (int i = 0; i < (int)faces.size(); ++i) {
-		const Face &face = faces[i];
-		voxelformat::TexturedTri tri;
+	auto invalid = [&vertices](const Face &face) {
 		for (int j = 0; j < 3; ++j) {
-			const Vertex &vertex = vertices[face.indices[j]];
-			tri.vertices[j] = vertex.position;
-			tri.uv[j] = vertex.texCoord;
-			tri.color[j] = vertex.color;
+			if (face.indices[j] < 0 || (size_t)face.indices[j] >= vertices.size()) {
+				return true;
+			}
+		}
+		return false;
+	};
+	size_t validFaces = 0u;
+	for (size_t i = 0; i < faces.size(); ++i) {
+		if (!invalid(faces[i])) {
+			faces[validFaces++] = faces[i];
 		}
-		tris.push_back(tri);
 	}
+	if (validFaces != faces.size()) {
+		Log::warn("Skipped %i ply faces with invalid vertex indices", (int)(faces.size() - validFaces));
+		faces.erase(validFaces, faces.size() - validFaces);
+	}
+	const size_t offset = tris.size();
+	tris.resize(offset + faces.size());
+	app::for_parallel(0, (int)faces.size(), [&](int start, int end) {
+		for (int i = start; i < end; ++i) {
+			const Face &face = faces[i];
+			voxelformat::TexturedTri &tri = tris[offset + i];
+			for (int j = 0; j < 3; ++j) {
+				const Vertex &vertex = vertices[face.indices[j]];
+				tri.vertices[j] = vertex.position;
+				tri.uv[j] = vertex.texCoord;
+				tri.color[j] = vertex.color;
+			}
+		}
+	});
 }
 
 /**
@@ -527,8 +625,8 @@ void PLYFormat::triangulatePolygons(const core::DynamicArray<Polygon> &polygons,
 		polygon.push_back(polyline);
 
 		std::vector<int> indices = mapbox::earcut<int>(polygon);
-		core_assert((int)indices.size() % 3 == 0);
-		Log::debug("triangulated %i tris", (int)indices.size() / 3);
+		core_assert(indices.size() % 3 == 0);
+		Log::debug("triangulated %" PRIu64 " tris", (uint64_t)(indices.size() / 3));
 
 		for (size_t k = 0; k < indices.size() / 3; k++) {
 			const int idx0 = indices[3 * k + 0];
@@ -693,23 +791,8 @@ bool PLYFormat::parseMeshAscii(const core::String &filename, io::SeekableReadStr
 	core::DynamicArray<Vertex> vertices;
 	core::DynamicArray<Face> faces;
 	core::DynamicArray<Polygon> polygons;
-	for (int i = 0; i < (int)header.elements.size(); ++i) {
-		const Element &element = header.elements[i];
-		if (element.name == "vertex") {
-			if (!parseVerticesAscii(element, stream, vertices)) {
-				return false;
-			}
-		} else if (element.name == "face") {
-			if (!parseFacesAscii(element, stream, faces, polygons)) {
-				return false;
-			}
-		} else {
-			for (int skip = 0; skip < element.count; ++skip) {
-				core::String line;
-				wrapBool(stream.readLine(line))
-			}
-			continue;
-		}
+	if (!parseAscii(stream, header, vertices, &faces, &polygons)) {
+		return false;
 	}
 
 	triangulatePolygons(polygons, vertices, faces);
@@ -790,12 +873,11 @@ bool PLYFormat::saveMeshes(const core::Map<int, int> &, const scenegraph::SceneG
 	int indices = 0;
 	for (const auto &meshExt : meshes) {
 		for (int i = 0; i < voxel::ChunkMesh::Meshes; ++i) {
-			const voxel::Mesh &mesh = meshExt.mesh->mesh[i];
-			if (mesh.isEmpty()) {
+			if (meshExt.isEmpty(i)) {
 				continue;
 			}
-			elements += (int)mesh.getNoOfVertices();
-			indices += (int)mesh.getNoOfIndices();
+			elements += (int)meshExt.vertices(i);
+			indices += (int)meshExt.indices(i);
 		}
 	}
 
@@ -835,8 +917,10 @@ bool PLYFormat::saveMeshes(const core::Map<int, int> &, const scenegraph::SceneG
 	stream->writeStringFormat(false, "end_header\n");
 
 	for (const auto &meshExt : meshes) {
+		voxel::ChunkMesh unpacked(0, 0);
+		const voxel::ChunkMesh &chunkMesh = meshExt.unpack(unpacked);
 		for (int i = 0; i < voxel::ChunkMesh::Meshes; ++i) {
-			const voxel::Mesh &mesh = meshExt.mesh->mesh[i];
+			const voxel::Mesh &mesh = chunkMesh.mesh[i];
 			if (mesh.isEmpty()) {
 				continue;
 			}
@@ -847,33 +931,55 @@ bool PLYFormat::saveMeshes(const core::Map<int, int> &, const scenegraph::SceneG
 			const scenegraph::SceneGraphTransform &transform = graphNode.transform(keyFrameIdx);
 			const palette::Palette &palette = graphNode.palette();
 
-			for (int j = 0; j < nv; ++j) {
-				const voxel::VoxelVertex &v = vertices[j];
-				glm::vec3 pos;
-				if (meshExt.applyTransform) {
-					pos = transform.apply(v.position, meshExt.pivot * meshExt.size);
-				} else {
-					pos = v.position;
-				}
-				pos *= scale;
-				stream->writeStringFormat(false, "%f %f %f", pos.x, pos.y, pos.z);
-				if (withTexCoords) {
-					const glm::vec2 &uv = paletteUV(v.colorIndex);
-					stream->writeStringFormat(false, " %f %f", uv.x, uv.y);
+			auto formatVertices = [&](int start, int end, meshtext::TextBlock &text) {
+				for (int j = start; j < end; ++j) {
+					const voxel::VoxelVertex &v = vertices[j];
+					glm::vec3 pos;
+					if (meshExt.applyTransform) {
+						pos = transform.apply(v.position, meshExt.pivot * meshExt.size);
+					} else {
+						pos = v.position;
+					}
+					pos *= scale;
+					text.addFloat(pos.x, 6);
+					text.addChar(' ');
+					text.addFloat(pos.y, 6);
+					text.addChar(' ');
+					text.addFloat(pos.z, 6);
+					if (withTexCoords) {
+						const glm::vec2 &uv = paletteUV(v.colorIndex);
+						text.addChar(' ');
+						text.addFloat(uv.x, 6);
+						text.addChar(' ');
+						text.addFloat(uv.y, 6);
+					}
+					if (withColor) {
+						const core::RGBA color = palette.color(v.colorIndex);
+						text.addChar(' ');
+						text.addInt(color.r);
+						text.addChar(' ');
+						text.addInt(color.g);
+						text.addChar(' ');
+						text.addInt(color.b);
+						text.addChar(' ');
+						text.addInt(color.a);
+					}
+					text.addChar('\n');
 				}
-				if (withColor) {
-					const core::RGBA color = palette.color(v.colorIndex);
-					stream->writeStringFormat(false, " %u %u %u %u", color.r, color.g, color.b, color.a);
-				}
-				stream->writeStringFormat(false, "\n");
+			};
+			if (!meshtext::writeParallel(*stream, nv, formatVertices)) {
+				Log::error("Failed to write ply vertices");
+				return false;
 			}
 		}
 	}
 
 	int idxOffset = 0;
 	for (const auto &meshExt : meshes) {
+		voxel::ChunkMesh unpacked(0, 0);
+		const voxel::ChunkMesh &chunkMesh = meshExt.unpack(unpacked);
 		for (int i = 0; i < voxel::ChunkMesh::Meshes; ++i) {
-			const voxel::Mesh &mesh = meshExt.mesh->mesh[i];
+			const voxel::Mesh &mesh = chunkMesh.mesh[i];
 			if (mesh.isEmpty()) {
 				continue;
 			}
@@ -884,21 +990,26 @@ bool PLYFormat::saveMeshes(const core::Map<int, int> &, const scenegraph::SceneG
 				return false;
 			}
 			const voxel::IndexType *indices = mesh.getRawIndexData();
-			if (quad) {
-				for (int j = 0; j < ni; j += 6) {
-					const uint32_t one = idxOffset + indices[j + 0];
-					const uint32_t two = idxOffset + indices[j + 1];
-					const uint32_t three = idxOffset + indices[j + 2];
-					const uint32_t four = idxOffset + indices[j + 5];
-					stream->writeStringFormat(false, "4 %i %i %i %i\n", (int)one, (int)two, (int)three, (int)four);
-				}
-			} else {
-				for (int j = 0; j < ni; j += 3) {
-					const uint32_t one = idxOffset + indices[j + 0];
-					const uint32_t two = idxOffset + indices[j + 1];
-					const uint32_t three = idxOffset + indices[j + 2];
-					stream->writeStringFormat(false, "3 %i %i %i\n", (int)one, (int)two, (int)three);
+			const int step = quad ? 6 : 3;
+			auto formatFaces = [&](int start, int end, meshtext::TextBlock &text) {
+				for (int f = start; f < end; ++f) {
+					const int j = f * step;
+					text.addString(quad ? "4 " : "3 ", 2);
+					text.addInt(idxOffset + (int)indices[j + 0]);
+					text.addChar(' ');
+					text.addInt(idxOffset + (int)indices[j + 1]);
+					text.addChar(' ');
+					text.addInt(idxOffset + (int)indices[j + 2]);
+					if (quad) {
+						text.addChar(' ');
+						text.addInt(idxOffset + (int)indices[j + 5]);
+					}
+					text.addChar('\n');
 				}
+			};
+			if (!meshtext::writeParallel(*stream, (ni + step - 1) / step, formatFaces)) {
+				Log::error("Failed to write ply faces");
+				return false;
 			}
 			idxOffset += nv;
 		}
@@ -82,10 +82,12 @@ protected:
 	static DataType dataType(const core::String &in);
 	static PropertyUse use(const core::String &in);
 	static bool parseHeader(io::SeekableReadStream &stream, Header &header);
-	bool parseFacesAscii(const Element &element, io::SeekableReadStream &stream, core::DynamicArray<Face> &faces,
-						 core::DynamicArray<Polygon> &polygons) const;
-	bool parseVerticesAscii(const Element &element, io::SeekableReadStream &stream,
-							core::DynamicArray<Vertex> &vertices) const;
+	/**
+	 * @brief Parses the vertex and face elements of the ascii body in parallel chunks of lines
+	 * @param[out] faces The triangles and quads of the face element - can be @c nullptr to skip the faces
+	 */
+	bool parseAscii(io::SeekableReadStream &stream, const Header &header, core::DynamicArray<Vertex> &vertices,
+					core::DynamicArray<Face> *faces, core::DynamicArray<Polygon> *polygons) const;
 	void triangulatePolygons(const core::DynamicArray<Polygon> &polygons, const core::DynamicArray<Vertex> &vertices,
 							 core::DynamicArray<Face> &faces) const;
 	bool parseFacesBinary(const Element &element, io::SeekableReadStream &stream, core::DynamicArray<Face> &faces,
@@ -186,11 +186,10 @@ bool STLFormat::saveMeshes(const core::Map<int, int> &, const scenegraph::SceneG
 	int faceCount = 0;
 	for (const auto &meshExt : meshes) {
 		for (int i = 0; i < voxel::ChunkMesh::Meshes; ++i) {
-			const voxel::Mesh *mesh = &meshExt.mesh->mesh[i];
-			if (mesh->isEmpty()) {
+			if (meshExt.isEmpty(i)) {
 				continue;
 			}
-			const int ni = (int)mesh->getNoOfIndices();
+			const int ni = (int)meshExt.indices(i);
 			if (ni % 3 != 0) {
 				Log::error("Unexpected indices amount");
 				return false;
@@ -201,8 +200,10 @@ bool STLFormat::saveMeshes(const core::Map<int, int> &, const scenegraph::SceneG
 	stream->writeUInt32(faceCount);
 
 	for (const auto &meshExt : meshes) {
+		voxel::ChunkMesh unpacked(0, 0);
+		const voxel::ChunkMesh &chunkMesh = meshExt.unpack(unpacked);
 		for (int i = 0; i < voxel::ChunkMesh::Meshes; ++i) {
-			const voxel::Mesh *mesh = &meshExt.mesh->mesh[i];
+			const voxel::Mesh *mesh = &chunkMesh.mesh[i];
 			if (mesh->isEmpty()) {
 				continue;
 			}
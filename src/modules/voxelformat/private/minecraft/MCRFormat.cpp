@@ -86,7 +86,7 @@ bool MCRFormat::loadGroupsPalette(const core::String &filename, const io::Archiv
 			return false;
 		}
 
-		const bool success = loadMinecraftRegion(sceneGraph, *stream, palette);
+		const bool success = loadMinecraftRegion(sceneGraph, *stream, palette, ctx);
 		return success;
 	}
 	}
@@ -95,7 +95,7 @@ bool MCRFormat::loadGroupsPalette(const core::String &filename, const io::Archiv
 }
 
 bool MCRFormat::loadMinecraftRegion(scenegraph::SceneGraph &sceneGraph, io::SeekableReadStream &stream,
-									const palette::Palette &palette) {
+									const palette::Palette &palette, const LoadContext &ctx) {
 	for (int i = 0; i < SECTOR_INTS; ++i) {
 		if (_offsets[i].sectorCount == 0u || _offsets[i].offset < sizeof(_offsets)) {
 			continue;
@@ -110,6 +110,10 @@ bool MCRFormat::loadMinecraftRegion(scenegraph::SceneGraph &sceneGraph, io::Seek
 			Log::error("Failed to load minecraft chunk section %i for offset %u", i, (int)_offsets[i].offset);
 			return false;
 		}
+		if (!ctx.streamNodes(sceneGraph)) {
+			Log::error("Failed to flush the minecraft chunks");
+			return false;
+		}
 	}
 
 	return true;
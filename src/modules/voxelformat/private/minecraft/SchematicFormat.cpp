@@ -74,7 +74,7 @@ bool SchematicFormat::loadGroupsPalette(const core::String &filename, const io::
 			return true;
 		}
 	} else if (extension == "litematic") {
-		return loadLitematic(schematic, sceneGraph, palette);
+		return loadLitematic(schematic, sceneGraph, palette, loadctx);
 	}
 
 	const int version = schematic.get("Version").int32(-1);
@@ -160,7 +160,7 @@ bool SchematicFormat::readLitematicBlockStates(const glm::ivec3 &size, int bits,
 }
 
 bool SchematicFormat::loadLitematic(const priv::NamedBinaryTag &schematic, scenegraph::SceneGraph &sceneGraph,
-									palette::Palette &palette) {
+									palette::Palette &palette, const LoadContext &ctx) {
 	const priv::NamedBinaryTag &versionNbt = schematic.get("Version");
 	if (versionNbt.valid() && versionNbt.type() == priv::TagType::INT) {
 		const int version = versionNbt.int32();
@@ -219,6 +219,10 @@ bool SchematicFormat::loadLitematic(const priv::NamedBinaryTag &schematic, scene
 				Log::error("Failed to add node to the scenegraph");
 				return false;
 			}
+			if (!ctx.streamNodes(sceneGraph)) {
+				Log::error("Failed to flush the litematic regions");
+				return false;
+			}
 		}
 		return true;
 	}
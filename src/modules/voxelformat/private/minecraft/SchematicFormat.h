@@ -36,7 +36,7 @@ protected:
 	bool readLitematicBlockStates(const glm::ivec3 &size, int bits, const priv::NamedBinaryTag &blockStates,
 								  scenegraph::SceneGraphNode &node, const core::Buffer<int> &mcpal);
 	bool loadLitematic(const priv::NamedBinaryTag &schematic, scenegraph::SceneGraph &sceneGraph,
-					   palette::Palette &palette);
+					   palette::Palette &palette, const LoadContext &ctx);
 	bool loadSponge3(const priv::NamedBinaryTag &schematic, scenegraph::SceneGraph &sceneGraph,
 					 palette::Palette &palette, int version);
 	bool parseBlocks(const priv::NamedBinaryTag &schematic, scenegraph::SceneGraph &sceneGraph, palette::Palette &palette,
@@ -9,6 +9,7 @@
 #include "core/ScopedPtr.h"
 #include "core/Var.h"
 #include "core/collection/DynamicMap.h"
+#include "io/BufferedReadStream.h"
 #include "io/Stream.h"
 #include "scenegraph/SceneGraph.h"
 #include "scenegraph/SceneGraphNode.h"
@@ -217,7 +218,7 @@ bool QBFormat::saveGroups(const scenegraph::SceneGraph &sceneGraph, const core::
 	return true;
 }
 
-voxel::Voxel QBFormat::getVoxel(State &state, io::SeekableReadStream &stream, palette::PaletteLookup &palLookup) {
+voxel::Voxel QBFormat::getVoxel(State &state, io::BufferedReadStream &stream, palette::PaletteLookup &palLookup) {
 	core::RGBA color(0);
 	if (!readColor(state, stream, color)) {
 		return voxel::Voxel();
@@ -230,7 +231,7 @@ voxel::Voxel QBFormat::getVoxel(State &state, io::SeekableReadStream &stream, pa
 	return v;
 }
 
-bool QBFormat::readColor(State &state, io::SeekableReadStream &stream, core::RGBA &color) {
+bool QBFormat::readColor(State &state, io::BufferedReadStream &stream, core::RGBA &color) {
 	if (state._colorFormat == ColorFormat::RGBA) {
 		wrap(stream.readUInt8(color.r))
 		wrap(stream.readUInt8(color.g))
@@ -252,7 +253,7 @@ bool QBFormat::readColor(State &state, io::SeekableReadStream &stream, core::RGB
 	return true;
 }
 
-bool QBFormat::readMatrix(State &state, io::SeekableReadStream &stream, scenegraph::SceneGraph &sceneGraph,
+bool QBFormat::readMatrix(State &state, io::BufferedReadStream &stream, scenegraph::SceneGraph &sceneGraph,
 						  palette::PaletteLookup &palLookup) {
 	core::String name;
 	wrapBool(stream.readPascalStringUInt8(name))
@@ -380,7 +381,7 @@ bool QBFormat::readMatrix(State &state, io::SeekableReadStream &stream, scenegra
 	return true;
 }
 
-bool QBFormat::readPalette(State &state, io::SeekableReadStream &stream, RGBAMap &colors) {
+bool QBFormat::readPalette(State &state, io::BufferedReadStream &stream, RGBAMap &colors) {
 	uint8_t nameLength;
 	wrap(stream.readUInt8(nameLength));
 	if (stream.skip(nameLength) == -1) {
@@ -419,7 +420,7 @@ bool QBFormat::readPalette(State &state, io::SeekableReadStream &stream, RGBAMap
 					if (color.a == 0) {
 						continue;
 					}
-					colors.put(flattenRGB(color.r, color.g, color.b), true);
+					palette::addColor(colors, flattenRGB(color.r, color.g, color.b));
 				}
 			}
 		}
@@ -445,7 +446,7 @@ bool QBFormat::readPalette(State &state, io::SeekableReadStream &stream, RGBAMap
 					continue;
 				}
 				const core::RGBA flattened = flattenRGB(color.r, color.g, color.b);
-				colors.put(flattened, true);
+				palette::addColor(colors, flattened);
 			}
 			++z;
 		}
@@ -455,11 +456,13 @@ bool QBFormat::readPalette(State &state, io::SeekableReadStream &stream, RGBAMap
 
 size_t QBFormat::loadPalette(const core::String &filename, const io::ArchivePtr &archive, palette::Palette &palette,
 							 const LoadContext &ctx) {
-	core::ScopedPtr<io::SeekableReadStream> stream(archive->readStream(filename));
-	if (!stream) {
+	core::ScopedPtr<io::SeekableReadStream> fileStream(archive->readStream(filename));
+	if (!fileStream) {
 		Log::error("Could not load file %s", filename.c_str());
 		return 0;
 	}
+	io::BufferedReadStream bufferedStream(*fileStream);
+	io::BufferedReadStream *stream = &bufferedStream;
 
 	State state;
 	wrap(stream->readUInt32(state._version))
@@ -490,25 +493,21 @@ size_t QBFormat::loadPalette(const core::String &filename, const io::ArchivePtr
 			break;
 		}
 	}
-	const size_t colorCount = colors.size();
-	core::Buffer<core::RGBA> colorBuffer;
-	colorBuffer.reserve(colorCount);
-	for (const auto &e : colors) {
-		colorBuffer.push_back(e->first);
-	}
-	palette.quantize(colorBuffer.data(), colorBuffer.size());
-	Log::debug("%i colors loaded from %i individual rgb colors", palette.colorCount(), (int)colorBuffer.size());
+	palette.quantize(colors);
+	Log::debug("%i colors loaded from %i individual rgb colors", palette.colorCount(), (int)colors.size());
 	return palette.colorCount();
 }
 
 bool QBFormat::loadGroupsRGBA(const core::String &filename, const io::ArchivePtr &archive,
 							  scenegraph::SceneGraph &sceneGraph, const palette::Palette &palette,
 							  const LoadContext &ctx) {
-	core::ScopedPtr<io::SeekableReadStream> stream(archive->readStream(filename));
-	if (!stream) {
+	core::ScopedPtr<io::SeekableReadStream> fileStream(archive->readStream(filename));
+	if (!fileStream) {
 		Log::error("Could not load file %s", filename.c_str());
 		return false;
 	}
+	io::BufferedReadStream bufferedStream(*fileStream);
+	io::BufferedReadStream *stream = &bufferedStream;
 	State state;
 	wrap(stream->readUInt32(state._version))
 	uint32_t colorFormat;
@@ -6,6 +6,10 @@
 
 #include "voxelformat/Format.h"
 
+namespace io {
+class BufferedReadStream;
+}
+
 namespace palette {
 class PaletteLookup;
 }
@@ -43,11 +47,11 @@ private:
 	// left shift values for the vis mask for the single faces
 	enum class VisMaskSides : uint8_t { Invisble, Left, Right, Top, Bottom, Front, Back };
 
-	bool readColor(State &state, io::SeekableReadStream &stream, core::RGBA &color);
-	voxel::Voxel getVoxel(State &state, io::SeekableReadStream &stream, palette::PaletteLookup &palLookup);
-	bool readMatrix(State &state, io::SeekableReadStream &stream, scenegraph::SceneGraph &sceneGraph,
+	bool readColor(State &state, io::BufferedReadStream &stream, core::RGBA &color);
+	voxel::Voxel getVoxel(State &state, io::BufferedReadStream &stream, palette::PaletteLookup &palLookup);
+	bool readMatrix(State &state, io::BufferedReadStream &stream, scenegraph::SceneGraph &sceneGraph,
 					palette::PaletteLookup &palLookup);
-	bool readPalette(State &state, io::SeekableReadStream &stream, RGBAMap &colors);
+	bool readPalette(State &state, io::BufferedReadStream &stream, RGBAMap &colors);
 	bool loadGroupsRGBA(const core::String &filename, const io::ArchivePtr &archive,
 						scenegraph::SceneGraph &sceneGraph, const palette::Palette &palette,
 						const LoadContext &ctx) override;
@@ -12,6 +12,7 @@
 #include "core/ScopedPtr.h"
 #include "core/Var.h"
 #include "io/BufferedReadWriteStream.h"
+#include "io/MemoryReadStream.h"
 #include "io/Stream.h"
 #include "io/ZipReadStream.h"
 #include "io/ZipWriteStream.h"
@@ -381,6 +382,90 @@ bool QBTFormat::loadCompound(io::SeekableReadStream &stream, scenegraph::SceneGr
  * than 0 then the voxel is solid. Even when a voxel is solid is may not be needed to be rendered because it is a core
  * voxel that is surrounded by 6 other voxels and thus invisible. If M = 1 then the voxel is a core voxel.
  */
+bool QBTFormat::loadVoxels(const core::DynamicArray<uint8_t> &voxelData, voxel::RawVolume &volume,
+						   const palette::Palette &palette) const {
+	io::MemoryReadStream memStream(voxelData.data(), voxelData.size());
+	io::ZipReadStream zipStream(memStream, (int)voxelData.size());
+	const voxel::Region &region = volume.region();
+	const int width = region.getWidthInVoxels();
+	const int height = region.getHeightInVoxels();
+	const int depth = region.getDepthInVoxels();
+	for (int32_t x = 0; x < width; x++) {
+		for (int32_t z = 0; z < depth; z++) {
+			for (int32_t y = 0; y < height; y++) {
+				uint8_t red;
+				wrap(zipStream.readUInt8(red))
+				uint8_t green;
+				wrap(zipStream.readUInt8(green))
+				uint8_t blue;
+				wrap(zipStream.readUInt8(blue))
+				uint8_t mask;
+				wrap(zipStream.readUInt8(mask))
+				if (mask == 0u) {
+					continue;
+				}
+				const voxel::Voxel &voxel = voxel::createVoxel(palette, red);
+				volume.setVoxel(x, y, z, voxel);
+			}
+		}
+	}
+	return true;
+}
+
+bool QBTFormat::loadColors(const core::DynamicArray<uint8_t> &voxelData, const voxel::Region &region,
+						   core::DynamicArray<core::RGBA> &colors) const {
+	io::MemoryReadStream memStream(voxelData.data(), voxelData.size());
+	io::ZipReadStream zipStream(memStream, (int)voxelData.size());
+	colors.resize((size_t)region.voxels());
+	for (core::RGBA &color : colors) {
+		uint8_t red;
+		wrap(zipStream.readUInt8(red))
+		uint8_t green;
+		wrap(zipStream.readUInt8(green))
+		uint8_t blue;
+		wrap(zipStream.readUInt8(blue))
+		uint8_t mask;
+		wrap(zipStream.readUInt8(mask))
+		if (mask == 0u) {
+			color = core::RGBA(0, 0, 0, 0);
+		} else {
+			color = flattenRGB(red, green, blue);
+		}
+	}
+	return true;
+}
+
+bool QBTFormat::decodeMatrices(Header &state, palette::Palette &palette) const {
+	if (!decodeVolumes(state.decodeJobs)) {
+		state.colorMatrices.clear();
+		return false;
+	}
+	// the palette indices depend on the order the colors are added in - so this is done sequentially
+	for (ColorMatrix &matrix : state.colorMatrices) {
+		voxel::RawVolume &volume = *matrix.volume;
+		const voxel::Region &region = volume.region();
+		const int width = region.getWidthInVoxels();
+		const int height = region.getHeightInVoxels();
+		const int depth = region.getDepthInVoxels();
+		const core::RGBA *color = matrix.colors.data();
+		for (int32_t x = 0; x < width; x++) {
+			for (int32_t z = 0; z < depth; z++) {
+				for (int32_t y = 0; y < height; y++, ++color) {
+					if (color->a == 0u) {
+						continue;
+					}
+					uint8_t index = 1;
+					palette.tryAdd(*color, false, &index);
+					const voxel::Voxel &voxel = voxel::createVoxel(palette, index);
+					volume.setVoxel(x, y, z, voxel);
+				}
+			}
+		}
+	}
+	state.colorMatrices.clear();
+	return true;
+}
+
 bool QBTFormat::loadMatrix(io::SeekableReadStream &stream, scenegraph::SceneGraph &sceneGraph, int parent,
 						   palette::Palette &palette, Header &state) {
 	core::String name;
@@ -427,43 +512,34 @@ bool QBTFormat::loadMatrix(io::SeekableReadStream &stream, scenegraph::SceneGrap
 		Log::warn("Size of matrix results in empty space - voxelDataSize: %u", voxelDataSize);
 		return false;
 	}
-	io::ZipReadStream zipStream(stream, voxelDataSize);
+	core::DynamicArray<uint8_t> voxelData;
+	voxelData.resize(voxelDataSize);
+	if (stream.read(voxelData.data(), voxelDataSize) != (int)voxelDataSize) {
+		Log::error("Could not load qbt file: Not enough data in stream for the voxel data");
+		return false;
+	}
 
 	const voxel::Region region(glm::ivec3(0), glm::ivec3(size) - 1);
 	if (!region.isValid()) {
 		Log::error("Invalid region");
 		return false;
 	}
-	core::ScopedPtr<voxel::RawVolume> volume(new voxel::RawVolume(region));
-	for (int32_t x = 0; x < (int)size.x; x++) {
-		for (int32_t z = 0; z < (int)size.z; z++) {
-			for (int32_t y = 0; y < (int)size.y; y++) {
-				uint8_t red;
-				wrap(zipStream.readUInt8(red))
-				uint8_t green;
-				wrap(zipStream.readUInt8(green))
-				uint8_t blue;
-				wrap(zipStream.readUInt8(blue))
-				uint8_t mask;
-				wrap(zipStream.readUInt8(mask))
-				if (mask == 0u) {
-					continue;
-				}
-				if (state.colorFormat == ColorFormat::Palette) {
-					const voxel::Voxel &voxel = voxel::createVoxel(palette, red);
-					volume->setVoxel(x, y, z, voxel);
-				} else {
-					const core::RGBA color = flattenRGB(red, green, blue);
-					uint8_t index = 1;
-					palette.tryAdd(color, false, &index);
-					const voxel::Voxel &voxel = voxel::createVoxel(palette, index);
-					volume->setVoxel(x, y, z, voxel);
-				}
-			}
-		}
+	voxel::RawVolume *volume = new voxel::RawVolume(region);
+	if (state.colorFormat == ColorFormat::Palette) {
+		state.decodeJobs.emplace_back([this, voxelData = core::move(voxelData), volume, &palette]() {
+			return loadVoxels(voxelData, *volume, palette);
+		});
+	} else {
+		// in rgba mode the colors are added to the palette in the order they appear in the file - the jobs only
+		// decode the colors and decodeMatrices() adds them to the palette afterwards
+		const size_t matrixIdx = state.colorMatrices.size();
+		state.colorMatrices.emplace_back(ColorMatrix{volume, {}});
+		state.decodeJobs.emplace_back([this, voxelData = core::move(voxelData), region, matrixIdx, &state]() {
+			return loadColors(voxelData, region, state.colorMatrices[matrixIdx].colors);
+		});
 	}
 	scenegraph::SceneGraphNode node;
-	node.setVolume(volume.release(), true);
+	node.setVolume(volume, true);
 	node.setName(name);
 	node.setPivot(pivot);
 	node.setPalette(palette);
@@ -656,6 +732,10 @@ size_t QBTFormat::loadPalette(const core::String &filename, const io::ArchivePtr
 				Log::error("Failed to load node");
 				return 0u;
 			}
+			if (!decodeMatrices(state, palette)) {
+				Log::error("Failed to load the voxel data");
+				return 0u;
+			}
 		} else {
 			Log::error("Unknown section found: %c%c%c%c%c%c%c%c", buf[0], buf[1], buf[2], buf[3], buf[4], buf[5],
 					   buf[6], buf[7]);
@@ -697,6 +777,10 @@ bool QBTFormat::loadGroupsPalette(const core::String &filename, const io::Archiv
 				Log::error("Failed to load node");
 				return false;
 			}
+			if (!decodeMatrices(state, palette)) {
+				Log::error("Failed to load the voxel data");
+				return false;
+			}
 		} else {
 			Log::error("Unknown section found: %c%c%c%c%c%c%c%c", buf[0], buf[1], buf[2], buf[3], buf[4], buf[5],
 					   buf[6], buf[7]);
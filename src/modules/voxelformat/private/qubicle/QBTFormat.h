@@ -23,16 +23,42 @@ namespace voxelformat {
 class QBTFormat : public PaletteFormat {
 private:
 	enum class ColorFormat : uint8_t { RGBA, Palette };
+	/**
+	 * @brief A matrix without a color map - the decoded colors are added to the palette in file order
+	 */
+	struct ColorMatrix {
+		voxel::RawVolume *volume = nullptr;
+		/** one color per voxel in the order of the file - the alpha value is 0 for air */
+		core::DynamicArray<core::RGBA> colors;
+	};
 	struct Header {
 		uint8_t versionMajor = 0;
 		uint8_t versionMinor = 0;
 		ColorFormat colorFormat = ColorFormat::RGBA;
 		glm::vec3 globalScale{0};
+		/** the voxel data of the matrices is decoded after the data tree was parsed */
+		VolumeDecodeJobs decodeJobs;
+		core::DynamicArray<ColorMatrix> colorMatrices;
 	};
 
 	bool loadHeader(io::SeekableReadStream &stream, Header &state);
 
 	bool skipNode(io::SeekableReadStream &stream);
+	/**
+	 * @param voxelData The zlib compressed voxel data of a matrix that references the color map
+	 */
+	bool loadVoxels(const core::DynamicArray<uint8_t> &voxelData, voxel::RawVolume &volume,
+					const palette::Palette &palette) const;
+	/**
+	 * @param voxelData The zlib compressed voxel data of a matrix without color map
+	 */
+	bool loadColors(const core::DynamicArray<uint8_t> &voxelData, const voxel::Region &region,
+					core::DynamicArray<core::RGBA> &colors) const;
+	/**
+	 * @brief Decodes the voxel data of all matrices of the data tree in parallel - the colors of the rgba matrices
+	 * are afterwards added to the palette in the order of the file
+	 */
+	bool decodeMatrices(Header &state, palette::Palette &palette) const;
 	bool loadMatrix(io::SeekableReadStream &stream, scenegraph::SceneGraph &sceneGraph, int parent,
 					palette::Palette &palette, Header &state);
 	bool loadCompound(io::SeekableReadStream &stream, scenegraph::SceneGraph &sceneGraph, int parent,
@@ -163,8 +163,8 @@ size_t VBXFormat::loadPalette(const core::String &filename, const io::ArchivePtr
 	if (data == ini.end()) {
 		for (auto iter : data->second) {
 			if (iter->first == "voxels") {
-				if (!loadVoxels(iter->second,
-								[&colors](const glm::ivec3 &pos, const core::RGBA &color) { colors.put(color, true); })) {
+				auto fn = [&colors](const glm::ivec3 &pos, const core::RGBA &color) { palette::addColor(colors, color); };
+				if (!loadVoxels(iter->second, fn)) {
 					Log::error("Failed to load voxel volume dimensions from: %s", iter->second.c_str());
 					return 0;
 				}
@@ -172,13 +172,7 @@ size_t VBXFormat::loadPalette(const core::String &filename, const io::ArchivePtr
 		}
 	}
 
-	const size_t colorCount = colors.size();
-	core::Buffer<core::RGBA> colorBuffer;
-	colorBuffer.reserve(colorCount);
-	for (const auto &e : colors) {
-		colorBuffer.push_back(e->first);
-	}
-	palette.quantize(colorBuffer.data(), colorBuffer.size());
+	palette.quantize(colors);
 	return palette.colorCount();
 }
 
@@ -405,6 +405,49 @@ void AbstractFormatTest::testSaveMultipleModels(const core::String &filename, Fo
 	voxel::sceneGraphComparator(sceneGraph, sceneGraphLoad, flags);
 }
 
+void AbstractFormatTest::testSaveLoadModelOrder(const core::String &filename, Format *format) {
+	SCOPED_TRACE(filename.c_str());
+	const int models = 12;
+	palette::Palette pal;
+	for (int i = 0; i < models; ++i) {
+		pal.tryAdd(core::RGBA(20 * i, 255 - 20 * i, 100 + 10 * i, 255));
+	}
+	ASSERT_EQ(models, pal.colorCount());
+	scenegraph::SceneGraph sceneGraph;
+	for (int i = 0; i < models; ++i) {
+		// every model has its own size, voxel position and color
+		voxel::RawVolume *volume = new voxel::RawVolume(voxel::Region(0, 0, 0, i, 0, 0));
+		EXPECT_TRUE(volume->setVoxel(i, 0, 0, voxel::createVoxel(pal, i)));
+		scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
+		node.setVolume(volume, true);
+		node.setName(core::string::format("model %i", i));
+		node.setPalette(pal);
+		sceneGraph.emplace(core::move(node));
+	}
+
+	io::ArchivePtr archive = helper_archive();
+	ASSERT_TRUE(format->save(sceneGraph, filename, archive, testSaveCtx));
+	scenegraph::SceneGraph sceneGraphLoad;
+	ASSERT_TRUE(format->load(filename, archive, sceneGraphLoad, testLoadCtx));
+	ASSERT_EQ(models, (int)sceneGraphLoad.size(scenegraph::SceneGraphNodeType::Model));
+	int i = 0;
+	for (auto iter = sceneGraphLoad.beginModel(); iter != sceneGraphLoad.end(); ++iter, ++i) {
+		const scenegraph::SceneGraphNode &node = *iter;
+		EXPECT_EQ(core::string::format("model %i", i), node.name());
+		const voxel::RawVolume *volume = node.volume();
+		ASSERT_NE(nullptr, volume);
+		const voxel::Region &region = volume->region();
+		ASSERT_EQ(i + 1, region.getWidthInVoxels()) << "model " << i;
+		for (int x = 0; x < i; ++x) {
+			const voxel::Voxel &voxel = volume->voxel(region.getLowerX() + x, region.getLowerY(), region.getLowerZ());
+			EXPECT_TRUE(voxel::isAir(voxel.getMaterial())) << "model " << i << " at " << x;
+		}
+		const voxel::Voxel &voxel = volume->voxel(region.getLowerX() + i, region.getLowerY(), region.getLowerZ());
+		ASSERT_FALSE(voxel::isAir(voxel.getMaterial())) << "model " << i;
+		EXPECT_EQ(pal.color(i), node.palette().color(voxel.getColor())) << "model " << i;
+	}
+}
+
 void AbstractFormatTest::testSave(const core::String &filename, Format *format, const palette::Palette &palette,
 								  voxel::ValidateFlags flags) {
 	SCOPED_TRACE(filename.c_str());
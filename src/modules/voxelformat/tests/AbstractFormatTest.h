@@ -60,6 +60,10 @@ protected:
 
 	void testSaveMultipleModels(const core::String &filename, Format *format,
 								voxel::ValidateFlags flags = voxel::ValidateFlags::All);
+	/**
+	 * @brief Saves models that differ in size and color and expects them to load in the same order
+	 */
+	void testSaveLoadModelOrder(const core::String &filename, Format *format);
 	void testSaveSingleVoxel(const core::String &filename, Format *format,
 							 voxel::ValidateFlags flags = voxel::ValidateFlags::All);
 	void testSaveSmallVolume(const core::String &filename, Format *format,
@@ -0,0 +1,63 @@
+/**
+ * @file
+ */
+
+#include "app/tests/AbstractTest.h"
+#include "core/collection/DynamicArray.h"
+#include "core/concurrent/Atomic.h"
+#include "voxelformat/Format.h"
+
+namespace voxelformat {
+
+class FormatTest : public app::AbstractTest {
+protected:
+	/**
+	 * @brief Gives the tests access to the protected decode helper of the formats
+	 */
+	class DecodeFormat : public NoColorFormat {
+	public:
+		using Format::decodeVolumes;
+	};
+};
+
+TEST_F(FormatTest, testDecodeVolumes) {
+	const int n = 64;
+	core::DynamicArray<int> results;
+	results.resize(n);
+	VolumeDecodeJobs jobs;
+	for (int i = 0; i < n; ++i) {
+		results[i] = -1;
+		jobs.emplace_back([&results, i]() {
+			results[i] = i * 2;
+			return true;
+		});
+	}
+	EXPECT_TRUE(DecodeFormat::decodeVolumes(jobs));
+	EXPECT_TRUE(jobs.empty());
+	for (int i = 0; i < n; ++i) {
+		EXPECT_EQ(i * 2, results[i]) << "job " << i;
+	}
+}
+
+TEST_F(FormatTest, testDecodeVolumesEmpty) {
+	VolumeDecodeJobs jobs;
+	EXPECT_TRUE(DecodeFormat::decodeVolumes(jobs));
+}
+
+TEST_F(FormatTest, testDecodeVolumesFailingJob) {
+	const int n = 64;
+	core::AtomicInt executed(0);
+	VolumeDecodeJobs jobs;
+	for (int i = 0; i < n; ++i) {
+		jobs.emplace_back([&executed, i]() {
+			executed.increment();
+			return i != n / 2;
+		});
+	}
+	EXPECT_FALSE(DecodeFormat::decodeVolumes(jobs));
+	// a failing job doesn't cancel the others - they only touch the volumes of their own nodes
+	EXPECT_EQ(n, (int)executed);
+	EXPECT_TRUE(jobs.empty());
+}
+
+} // namespace voxelformat
@@ -4,9 +4,18 @@
 
 #include "voxelformat/private/mesh/GLTFFormat.h"
 #include "AbstractFormatTest.h"
+#include "core/FourCC.h"
+#include "core/GameConfig.h"
+#include "core/ScopedPtr.h"
+#include "io/MemoryArchive.h"
 #include "scenegraph/SceneGraph.h"
 #include "scenegraph/SceneGraphNode.h"
+#include "util/VarUtil.h"
 #include "voxel/Voxel.h"
+#include "voxelformat/VolumeFormat.h"
+#include <json.hpp>
+
+#include "meshoptimizer.h"
 
 namespace voxelformat {
 
@@ -54,6 +63,79 @@ TEST_F(GLTFFormatTest, testSaveLoadVoxel) {
 	testSaveLoadVoxel("bv-smallvolumesavetest.gltf", &f, 0, 10, flags);
 }
 
+TEST_F(GLTFFormatTest, testSaveLoadVoxelGlb) {
+	GLTFFormat f;
+	const voxel::ValidateFlags flags = voxel::ValidateFlags::All & ~voxel::ValidateFlags::Palette;
+	testSaveLoadVoxel("bv-smallvolumesavetest.glb", &f, 0, 10, flags);
+}
+
+TEST_F(GLTFFormatTest, testSaveLoadVoxelQuantized) {
+	util::ScopedVarChange quantization(cfg::VoxFormatGLTF_KHR_mesh_quantization, "true");
+	GLTFFormat f;
+	const voxel::ValidateFlags flags = voxel::ValidateFlags::All & ~voxel::ValidateFlags::Palette;
+	testSaveLoadVoxel("bv-smallvolumesavetest-quantized.glb", &f, 0, 10, flags);
+}
+
+TEST_F(GLTFFormatTest, testSaveMeshoptCompressed) {
+	util::ScopedVarChange quantization(cfg::VoxFormatGLTF_KHR_mesh_quantization, "true");
+	util::ScopedVarChange meshopt(cfg::VoxFormatGLTF_EXT_meshopt_compression, "true");
+	scenegraph::SceneGraph sceneGraph;
+	testLoad(sceneGraph, "rgb.qb");
+	io::MemoryArchivePtr archive = io::openMemoryArchive();
+	voxelformat::SaveContext saveCtx;
+	ASSERT_TRUE(voxelformat::saveFormat(sceneGraph, "meshopt.glb", nullptr, archive, saveCtx));
+	core::ScopedPtr<io::SeekableReadStream> stream(archive->readStream("meshopt.glb"));
+	ASSERT_TRUE(stream);
+
+	uint32_t magic, version, length, jsonLength, jsonMagic;
+	ASSERT_EQ(0, stream->readUInt32(magic));
+	ASSERT_EQ(0, stream->readUInt32(version));
+	ASSERT_EQ(0, stream->readUInt32(length));
+	EXPECT_EQ(FourCC('g', 'l', 'T', 'F'), magic);
+	EXPECT_EQ(2u, version);
+	EXPECT_EQ((uint32_t)stream->size(), length);
+	ASSERT_EQ(0, stream->readUInt32(jsonLength));
+	ASSERT_EQ(0, stream->readUInt32(jsonMagic));
+	EXPECT_EQ(FourCC('J', 'S', 'O', 'N'), jsonMagic);
+	std::string jsonStr(jsonLength, ' ');
+	ASSERT_EQ((int)jsonLength, stream->read(&jsonStr[0], jsonLength));
+	uint32_t binLength, binMagic;
+	ASSERT_EQ(0, stream->readUInt32(binLength));
+	ASSERT_EQ(0, stream->readUInt32(binMagic));
+	EXPECT_EQ(FourCC('B', 'I', 'N', '\0'), binMagic);
+	std::vector<uint8_t> bin(binLength);
+	ASSERT_EQ((int)binLength, stream->read(bin.data(), binLength));
+
+	const nlohmann::json json = nlohmann::json::parse(jsonStr);
+	const nlohmann::json &required = json["extensionsRequired"];
+	EXPECT_NE(required.end(), std::find(required.begin(), required.end(), "EXT_meshopt_compression"));
+	EXPECT_NE(required.end(), std::find(required.begin(), required.end(), "KHR_mesh_quantization"));
+	ASSERT_EQ(2u, json["buffers"].size());
+	EXPECT_EQ(binLength, json["buffers"][0]["byteLength"].get<uint32_t>());
+	EXPECT_TRUE(json["buffers"][1]["extensions"]["EXT_meshopt_compression"]["fallback"].get<bool>());
+
+	int decoded = 0;
+	for (const nlohmann::json &bufferView : json["bufferViews"]) {
+		const nlohmann::json &ext = bufferView["extensions"]["EXT_meshopt_compression"];
+		const size_t count = ext["count"].get<size_t>();
+		const size_t stride = ext["byteStride"].get<size_t>();
+		const size_t offset = ext["byteOffset"].get<size_t>();
+		const size_t size = ext["byteLength"].get<size_t>();
+		ASSERT_LE(offset + size, bin.size());
+		EXPECT_EQ(count * stride, bufferView["byteLength"].get<size_t>());
+		std::vector<uint8_t> out(count * stride);
+		const std::string mode = ext["mode"].get<std::string>();
+		if (mode == "TRIANGLES") {
+			EXPECT_EQ(0, meshopt_decodeIndexBuffer(out.data(), count, stride, &bin[offset], size));
+		} else {
+			EXPECT_EQ("ATTRIBUTES", mode);
+			EXPECT_EQ(0, meshopt_decodeVertexBuffer(out.data(), count, stride, &bin[offset], size));
+		}
+		++decoded;
+	}
+	EXPECT_GT(decoded, 0);
+}
+
 TEST_F(GLTFFormatTest, testVoxelizeLantern) {
 	scenegraph::SceneGraph sceneGraph;
 	testLoad(sceneGraph, "glTF/lantern/Lantern.gltf", 3u);
@@ -3,8 +3,10 @@
  */
 
 #include "AbstractFormatTest.h"
+#include "io/FormatDescription.h"
 #include "scenegraph/SceneGraphNode.h"
 #include "voxel/RawVolume.h"
+#include "voxelformat/VolumeFormat.h"
 #include "voxelutil/VolumeVisitor.h"
 
 namespace voxelformat {
@@ -26,6 +28,29 @@ TEST_F(MCRFormatTest, testLoad117) {
 	EXPECT_EQ(32512, cnt);
 }
 
+TEST_F(MCRFormatTest, testLoadStreamed) {
+	const core::String filename = "r.0.-2.mca";
+	const io::ArchivePtr &archive = helper_filesystemarchive();
+	if (!archive->exists(filename)) {
+		GTEST_SKIP() << "Could not open " << filename;
+	}
+	int models = 0;
+	LoadContext ctx;
+	ctx.memoryLimit = voxel::RawVolume::size(voxel::Region(0, 0, 0, 15, 383, 15)) * 4;
+	ctx.flush = [&](scenegraph::SceneGraph &graph) {
+		EXPECT_GE(graph.size(), 4u);
+		models += (int)graph.size();
+		graph.clear();
+		return true;
+	};
+	io::FileDescription fileDesc;
+	fileDesc.set(filename);
+	scenegraph::SceneGraph sceneGraph;
+	ASSERT_TRUE(voxelformat::loadFormat(fileDesc, archive, sceneGraph, ctx));
+	EXPECT_GT(ctx.flushed, 1);
+	EXPECT_EQ(128, models + (int)sceneGraph.size());
+}
+
 TEST_F(MCRFormatTest, testLoad110) {
 	scenegraph::SceneGraph sceneGraph;
 	testLoad(sceneGraph, "minecraft_110.mca", 1024);
@@ -0,0 +1,128 @@
+/**
+ * @file
+ */
+
+#include "voxelformat/private/mesh/MeshTextParser.h"
+#include "app/tests/AbstractTest.h"
+#include "core/StringUtil.h"
+#include "io/MemoryReadStream.h"
+
+namespace voxelformat {
+
+class MeshTextParserTest : public app::AbstractTest {
+protected:
+	static float parse(const char *str) {
+		const char *p = str;
+		float val = -1.0f;
+		EXPECT_TRUE(meshtext::parseFloat(p, str + SDL_strlen(str), val)) << str;
+		return val;
+	}
+};
+
+TEST_F(MeshTextParserTest, testParseFloat) {
+	EXPECT_FLOAT_EQ(0.0f, parse("0"));
+	EXPECT_FLOAT_EQ(1.5f, parse("  1.5"));
+	EXPECT_FLOAT_EQ(-0.468750f, parse("-0.468750"));
+	EXPECT_FLOAT_EQ(0.25f, parse("+.25"));
+	EXPECT_FLOAT_EQ(2.0f, parse("2."));
+	EXPECT_FLOAT_EQ(1.0e-5f, parse("1e-5"));
+	EXPECT_FLOAT_EQ(-3.25e10f, parse("-3.25E+10"));
+	EXPECT_FLOAT_EQ(123456789.0f, parse("123456789.000000000000000000001"));
+	EXPECT_FLOAT_EQ(core::string::toFloat("0.1234567890123456789"), parse("0.1234567890123456789"));
+	EXPECT_GT(parse("inf"), 1.0e30f);
+}
+
+TEST_F(MeshTextParserTest, testParseFloatSequence) {
+	const char *str = "v 1.0 -2.5 3e1\n4";
+	const char *end = str + SDL_strlen(str);
+	const char *lineEnd = meshtext::lineEnd(str, end);
+	const char *p = str + 2;
+	float x, y, z, w;
+	ASSERT_TRUE(meshtext::parseFloat(p, lineEnd, x));
+	ASSERT_TRUE(meshtext::parseFloat(p, lineEnd, y));
+	ASSERT_TRUE(meshtext::parseFloat(p, lineEnd, z));
+	EXPECT_FALSE(meshtext::parseFloat(p, lineEnd, w)) << "Parsing must stop at the end of the line";
+	EXPECT_FLOAT_EQ(1.0f, x);
+	EXPECT_FLOAT_EQ(-2.5f, y);
+	EXPECT_FLOAT_EQ(30.0f, z);
+	EXPECT_EQ(lineEnd, p);
+}
+
+TEST_F(MeshTextParserTest, testParseInt) {
+	const char *str = "f 1/2/3 -4//5";
+	const char *end = str + SDL_strlen(str);
+	const char *p = str + 1;
+	int v;
+	ASSERT_TRUE(meshtext::parseInt(p, end, v));
+	EXPECT_EQ(1, v);
+	EXPECT_EQ('/', *p);
+	++p;
+	ASSERT_TRUE(meshtext::parseInt(p, end, v));
+	EXPECT_EQ(2, v);
+	p += 1;
+	ASSERT_TRUE(meshtext::parseInt(p, end, v));
+	EXPECT_EQ(3, v);
+	ASSERT_TRUE(meshtext::parseInt(p, end, v));
+	EXPECT_EQ(-4, v);
+	EXPECT_FALSE(meshtext::parseInt(p, end, v)) << "A slash is not a number";
+}
+
+TEST_F(MeshTextParserTest, testSplitLines) {
+	core::String text;
+	for (int i = 0; i < 200000; ++i) {
+		text += core::string::format("%i 0.5 0.25\r\n", i);
+	}
+	// no line ending for the last line
+	text += "last";
+	const meshtext::Chunk input{text.c_str(), text.c_str() + text.size()};
+	core::DynamicArray<meshtext::Chunk> chunks;
+	meshtext::splitLines(input, chunks);
+	ASSERT_FALSE(chunks.empty());
+	EXPECT_EQ(input.start, chunks[0].start);
+	EXPECT_EQ(input.end, chunks.back().end);
+	int lines = 0;
+	for (size_t i = 0; i < chunks.size(); ++i) {
+		if (i > 0) {
+			EXPECT_EQ(chunks[i - 1].end, chunks[i].start);
+			EXPECT_EQ('\n', chunks[i].start[-1]) << "Chunk " << i << " doesn't start at a line boundary";
+		}
+		lines += meshtext::countLines(chunks[i]);
+	}
+	EXPECT_EQ(200001, lines);
+	EXPECT_STREQ("last", core::String(meshtext::lineEnd(chunks.back().end - 4, chunks.back().end) - 4, 4).c_str());
+}
+
+TEST_F(MeshTextParserTest, testRemaining) {
+	const char *str = "header\nbody";
+	io::MemoryReadStream stream(str, SDL_strlen(str));
+	stream.skip(7);
+	core::Buffer<char> buffer;
+	meshtext::Chunk chunk;
+	ASSERT_TRUE(meshtext::remaining(stream, buffer, chunk));
+	EXPECT_EQ(4, chunk.end - chunk.start);
+	EXPECT_EQ(0, SDL_memcmp("body", chunk.start, 4));
+}
+
+TEST_F(MeshTextParserTest, testRemainingPartialReads) {
+	// a stream that isn't memory backed and only returns a few bytes per read call
+	class PartialReadStream : public io::MemoryReadStream {
+	public:
+		using io::MemoryReadStream::MemoryReadStream;
+		const uint8_t *data() const override {
+			return nullptr;
+		}
+		int read(void *dataPtr, size_t dataSize) override {
+			return io::MemoryReadStream::read(dataPtr, core_min(dataSize, (size_t)3u));
+		}
+	};
+	const char *str = "header\nsome body";
+	PartialReadStream stream(str, SDL_strlen(str));
+	stream.skip(7);
+	core::Buffer<char> buffer;
+	meshtext::Chunk chunk;
+	ASSERT_TRUE(meshtext::remaining(stream, buffer, chunk));
+	EXPECT_EQ(9, chunk.end - chunk.start);
+	EXPECT_EQ(0, SDL_memcmp("some body", chunk.start, 9));
+}
+
+} // namespace voxelformat
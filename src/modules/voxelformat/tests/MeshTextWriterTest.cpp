@@ -0,0 +1,60 @@
+/**
+ * @file
+ */
+
+#include "voxelformat/private/mesh/MeshTextWriter.h"
+#include "app/tests/AbstractTest.h"
+#include "core/String.h"
+#include "io/BufferedReadWriteStream.h"
+
+namespace voxelformat {
+
+class MeshTextWriterTest : public app::AbstractTest {
+protected:
+	static core::String format(float value, int decimals) {
+		meshtext::TextBlock text;
+		text.addFloat(value, decimals);
+		return core::String(text.data(), text.size());
+	}
+};
+
+TEST_F(MeshTextWriterTest, testAddFloat) {
+	const float values[] = {0.0f,	  -0.0f,	 1.0f,		-1.0f,	  0.5f,		   0.00004f, -0.00004f, 123.456789f,
+							-17.625f, 1000.125f, 0.999999f, 1.0e9f,	  3.0e12f, -2.5e15f, 0.1f,		0.6f};
+	for (float value : values) {
+		for (int decimals : {0, 3, 4, 6}) {
+			EXPECT_EQ(core::String::format("%.*f", decimals, value), format(value, decimals))
+				<< "value " << value << " decimals " << decimals;
+		}
+	}
+}
+
+TEST_F(MeshTextWriterTest, testAddInt) {
+	meshtext::TextBlock text;
+	text.addInt(0);
+	text.addChar(' ');
+	text.addInt(-42);
+	text.addChar(' ');
+	text.addInt(2147483647);
+	EXPECT_EQ("0 -42 2147483647", core::String(text.data(), text.size()));
+}
+
+TEST_F(MeshTextWriterTest, testWriteParallel) {
+	const int count = 100000;
+	io::BufferedReadWriteStream stream;
+	auto formatLines = [](int start, int end, meshtext::TextBlock &text) {
+		for (int i = start; i < end; ++i) {
+			text.addInt(i);
+			text.addChar('\n');
+		}
+	};
+	ASSERT_TRUE(meshtext::writeParallel(stream, count, formatLines));
+	core::String expected;
+	for (int i = 0; i < count; ++i) {
+		expected += core::String::format("%i\n", i);
+	}
+	ASSERT_EQ(expected.size(), (size_t)stream.size());
+	EXPECT_EQ(0, SDL_memcmp(expected.c_str(), stream.getBuffer(), expected.size()));
+}
+
+} // namespace voxelformat
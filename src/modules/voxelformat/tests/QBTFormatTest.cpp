@@ -3,7 +3,9 @@
  */
 
 #include "AbstractFormatTest.h"
+#include "core/ArrayLength.h"
 #include "voxelformat/private/qubicle/QBTFormat.h"
+#include "voxelutil/VolumeVisitor.h"
 
 namespace voxelformat {
 
@@ -14,6 +16,46 @@ TEST_F(QBTFormatTest, testLoad) {
 	testLoad("qubicle.qbt", 17);
 }
 
+TEST_F(QBTFormatTest, testLoadMatrixOrder) {
+	// the matrices of the data tree in file order with their amount of solid voxels
+	const struct {
+		const char *name;
+		int voxels;
+	} matrices[] = {{"K_Foot_Right", 72}, {"K_Leg_Left", 48},	{"K_Leg_Right", 48},  {"K_Foot_Left", 72},
+					{"K_Knee_Left", 26},  {"K_Knee_Right", 26}, {"K_Arm_Left", 100},  {"K_Hand_Left", 30},
+					{"K_Hand_Right", 30}, {"K_Chest", 759},		{"K_Head", 781},	  {"K_Arm_Right", 100},
+					{"K_Cover", 95},	  {"K_Toe_Left", 36},	{"K_Toe_Right", 36},  {"K_Waist", 252},
+					{"K_Core", 210}};
+	// the file has no color map - the colors are added to the palette in the order they appear in the file
+	const core::RGBA colors[] = {
+		core::RGBA(221, 221, 221), core::RGBA(170, 170, 170), core::RGBA(130, 127, 127), core::RGBA(222, 178, 129),
+		core::RGBA(238, 201, 159), core::RGBA(199, 148, 92),  core::RGBA(119, 119, 119), core::RGBA(78, 77, 77),
+		core::RGBA(230, 228, 230), core::RGBA(181, 175, 181), core::RGBA(34, 34, 34),	  core::RGBA(158, 59, 59),
+		core::RGBA(186, 67, 67),   core::RGBA(113, 55, 50),	  core::RGBA(212, 134, 103), core::RGBA(80, 72, 72),
+		core::RGBA(56, 56, 56)};
+	scenegraph::SceneGraph sceneGraph;
+	testLoad(sceneGraph, "qubicle.qbt", lengthof(matrices));
+	int i = 0;
+	for (auto iter = sceneGraph.beginModel(); iter != sceneGraph.end(); ++iter, ++i) {
+		ASSERT_LT(i, lengthof(matrices));
+		const scenegraph::SceneGraphNode &node = *iter;
+		EXPECT_EQ(matrices[i].name, node.name());
+		const int voxels = voxelutil::visitVolume(*node.volume(), [](int, int, int, const voxel::Voxel &) {});
+		EXPECT_EQ(matrices[i].voxels, voxels) << matrices[i].name;
+		const palette::Palette &palette = node.palette();
+		ASSERT_EQ(lengthof(colors), palette.colorCount());
+		for (int c = 0; c < lengthof(colors); ++c) {
+			EXPECT_EQ(colors[c], palette.color(c)) << "color " << c;
+		}
+	}
+	EXPECT_EQ(lengthof(matrices), i);
+}
+
+TEST_F(QBTFormatTest, testSaveLoadModelOrder) {
+	QBTFormat f;
+	testSaveLoadModelOrder("qubicle-modelorder.qbt", &f);
+}
+
 TEST_F(QBTFormatTest, testLoadRGBSmall) {
 	testRGBSmall("rgb_small.qbt");
 }
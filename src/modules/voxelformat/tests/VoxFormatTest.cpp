@@ -124,6 +124,11 @@ TEST_F(VoxFormatTest, testLoad8OnTop) {
 	}
 }
 
+TEST_F(VoxFormatTest, testSaveLoadModelOrder) {
+	VoxFormat f;
+	testSaveLoadModelOrder("magicavoxel-modelorder.vox", &f);
+}
+
 TEST_F(VoxFormatTest, testLoadRGB) {
 	testRGB("rgb.vox");
 }
@@ -24,6 +24,7 @@
 #include "scenegraph/SceneGraphNode.h"
 #include "scenegraph/SceneGraphTransform.h"
 #include "scenegraph/SceneGraphUtil.h"
+#include "voxel/BitVolume.h"
 #include "voxel/MaterialColor.h"
 #include "voxel/RawVolume.h"
 #include "voxel/RawVolumeMoveWrapper.h"
@@ -66,8 +67,17 @@ class LuaRawVolumeWrapper : public voxel::RawVolumeWrapper {
 private:
 	using Super = voxel::RawVolumeWrapper;
 	scenegraph::SceneGraphNode *_node;
+	const voxel::BitVolume *_selection;
 public:
-	LuaRawVolumeWrapper(scenegraph::SceneGraphNode *node) : Super(node->volume()), _node(node) {
+	LuaRawVolumeWrapper(scenegraph::SceneGraphNode *node, const voxel::BitVolume *selection = nullptr)
+		: Super(node->volume()), _node(node), _selection(selection) {
+	}
+
+	bool setVoxel(int x, int y, int z, const voxel::Voxel &voxel) override {
+		if (_selection != nullptr && !_selection->contains(x, y, z)) {
+			return false;
+		}
+		return Super::setVoxel(x, y, z, voxel);
 	}
 
 	~LuaRawVolumeWrapper() {
@@ -94,6 +104,18 @@ static const char *luaVoxel_globalnodeid() {
 	return "__global_nodeid";
 }
 
+static const char *luaVoxel_globalselection() {
+	return "__global_selection";
+}
+
+/**
+ * @brief The selection mask is only read by the scripts - lua light userdata can't be const, so the
+ * mask pointer is wrapped instead of casting the constness away
+ */
+struct LuaSelection {
+	const voxel::BitVolume *mask;
+};
+
 static const char *luaVoxel_globalnoise() {
 	return "__global_noise";
 }
@@ -243,7 +265,14 @@ static int luaVoxel_pushvolumewrapper(lua_State* s, LuaSceneGraphNode* node) {
 	if (node == nullptr) {
 		return clua_error(s, "No node given - can't push");
 	}
-	LuaRawVolumeWrapper *wrapper = new LuaRawVolumeWrapper(node->node);
+	// the selection only limits the modifications of the node the script was executed for
+	const LuaSelection *luaSelection = lua::LUA::globalData<LuaSelection>(s, luaVoxel_globalselection());
+	const voxel::BitVolume *selection = luaSelection == nullptr ? nullptr : luaSelection->mask;
+	const int *nodeId = lua::LUA::globalData<int>(s, luaVoxel_globalnodeid());
+	if (nodeId == nullptr || node->node->id() != *nodeId) {
+		selection = nullptr;
+	}
+	LuaRawVolumeWrapper *wrapper = new LuaRawVolumeWrapper(node->node, selection);
 	return clua_pushudata(s, wrapper, luaVoxel_metavolumewrapper());
 }
 
@@ -1844,7 +1873,7 @@ core::DynamicArray<LUAScript> LUAApi::listScripts() const {
 
 bool LUAApi::exec(const core::String &luaScript, scenegraph::SceneGraph &sceneGraph, int nodeId,
 						const voxel::Region &region, const voxel::Voxel &voxel, voxel::Region &dirtyRegion,
-						const core::DynamicArray<core::String> &args) {
+						const core::DynamicArray<core::String> &args, const voxel::BitVolume *selection) {
 	core::DynamicArray<LUAParameterDescription> argsInfo;
 	if (!argumentInfo(luaScript, argsInfo)) {
 		Log::error("Failed to get argument details");
@@ -1866,10 +1895,14 @@ bool LUAApi::exec(const core::String &luaScript, scenegraph::SceneGraph &sceneGr
 		return false;
 	}
 
+	LuaSelection luaSelection{selection};
 	lua::LUA lua;
 	lua.newGlobalData<scenegraph::SceneGraph>(luaVoxel_globalscenegraph(), &sceneGraph);
 	lua.newGlobalData<voxel::Region>(luaVoxel_globaldirtyregion(), &dirtyRegion);
 	lua.newGlobalData<int>(luaVoxel_globalnodeid(), &nodeId);
+	if (selection != nullptr && !selection->empty()) {
+		lua.newGlobalData<LuaSelection>(luaVoxel_globalselection(), &luaSelection);
+	}
 	lua.newGlobalData<noise::Noise>(luaVoxel_globalnoise(), &_noise);
 	prepareState(lua);
 
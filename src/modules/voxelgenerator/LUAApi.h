@@ -18,6 +18,7 @@ class SceneGraph;
 }
 
 namespace voxel {
+class BitVolume;
 class Region;
 class RawVolumeWrapper;
 class Voxel;
@@ -86,11 +87,12 @@ public:
 	 * @param voxel The voxel color and material that is currently selected
 	 * @param dirtyRegion The region that was modified by the script
 	 * @param args The arguments to pass to the script
+	 * @param selection Optional selection mask - the script can only modify the selected voxels of the given node
 	 * @return @c true if the script was executed successfully, @c false otherwise
 	 */
 	bool exec(const core::String &luaScript, scenegraph::SceneGraph &sceneGraph, int nodeId,
 			  const voxel::Region &region, const voxel::Voxel &voxel, voxel::Region &dirtyRegion,
-			  const core::DynamicArray<core::String> &args = {});
+			  const core::DynamicArray<core::String> &args = {}, const voxel::BitVolume *selection = nullptr);
 };
 
 inline auto scriptCompleter(const io::FilesystemPtr& filesystem) {
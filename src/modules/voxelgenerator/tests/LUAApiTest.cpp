@@ -5,6 +5,7 @@
 #include "voxelgenerator/LUAApi.h"
 #include "app/tests/AbstractTest.h"
 #include "core/collection/DynamicArray.h"
+#include "voxel/BitVolume.h"
 #include "voxel/RawVolume.h"
 #include "voxel/Voxel.h"
 #include "scenegraph/SceneGraph.h"
@@ -40,7 +41,8 @@ protected:
 	}
 
 	void run(scenegraph::SceneGraph &sceneGraph, const core::String &script,
-			 const core::DynamicArray<core::String> &args = {}, bool validateDirtyRegion = false) {
+			 const core::DynamicArray<core::String> &args = {}, bool validateDirtyRegion = false,
+			 const voxel::BitVolume *selection = nullptr) {
 		const voxel::Voxel voxel = voxel::createVoxel(voxel::VoxelType::Generic, 42);
 		int nodeId;
 		{
@@ -64,7 +66,7 @@ protected:
 
 		LUAApi g(_testApp->filesystem());
 		ASSERT_TRUE(g.init());
-		EXPECT_TRUE(g.exec(script, sceneGraph, nodeId, _region, voxel, dirtyRegion, args));
+		EXPECT_TRUE(g.exec(script, sceneGraph, nodeId, _region, voxel, dirtyRegion, args, selection));
 		if (validateDirtyRegion) {
 			EXPECT_TRUE(dirtyRegion.isValid());
 		}
@@ -111,6 +113,40 @@ TEST_F(LUAApiTest, testExecute) {
 	EXPECT_NE(0u, volume->voxel(1, 0, 0).getColor());
 }
 
+TEST_F(LUAApiTest, testExecuteSelection) {
+	const core::String script = R"(
+		function main(node, region, color)
+			local mins = region:mins()
+			local maxs = region:maxs()
+			for x = mins.x, maxs.x do
+				for y = mins.y, maxs.y do
+					for z = mins.z, maxs.z do
+						node:volume():setVoxel(x, y, z, color)
+					end
+				end
+			end
+		end
+	)";
+
+	voxel::BitVolume selection;
+	selection.add(voxel::Region(glm::ivec3(4), glm::ivec3(5)));
+	selection.set(7, 7, 7, true);
+	scenegraph::SceneGraph sceneGraph;
+	run(sceneGraph, script, {}, true, &selection);
+	const voxel::RawVolume *volume = sceneGraph.node(sceneGraph.activeNode()).volume();
+	for (int x = _region.getLowerX(); x <= _region.getUpperX(); ++x) {
+		for (int y = _region.getLowerY(); y <= _region.getUpperY(); ++y) {
+			for (int z = _region.getLowerZ(); z <= _region.getUpperZ(); ++z) {
+				bool expected = selection.contains(x, y, z);
+				for (int i = 0; i < lengthof(voxels); ++i) {
+					expected |= voxels[i] == glm::ivec3(x, y, z);
+				}
+				EXPECT_EQ(expected, !voxel::isAir(volume->voxel(x, y, z).getMaterial())) << x << ":" << y << ":" << z;
+			}
+		}
+	}
+}
+
 TEST_F(LUAApiTest, testArgumentInfo) {
 	const core::String script = R"(
 		function arguments()
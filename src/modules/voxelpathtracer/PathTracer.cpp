@@ -286,7 +286,7 @@ bool PathTracer::createScene(const scenegraph::SceneGraph &sceneGraph, const vid
 		voxel::SurfaceExtractionContext ctx =
 			voxel::createContext(type, v, region, palette, mesh, region.getLowerCorner());
 
-		voxel::extractSurface(ctx);
+		voxel::extractSurfaceParallel(ctx);
 
 		// scenegraph::KeyFrameIndex keyFrameIdx = 0;
 		// const scenegraph::SceneGraphTransform &transform = node.transform(keyFrameIdx);
@@ -0,0 +1,46 @@
+/**
+ * @file
+ */
+
+#include "ChunkLod.h"
+
+namespace voxelrender {
+
+int selectLod(float distance, float lodDistance, int maxLods) {
+	if (lodDistance <= 0.0f) {
+		return 0;
+	}
+	int lod = 0;
+	float threshold = lodDistance;
+	while (lod < maxLods - 1 && distance >= threshold) {
+		++lod;
+		threshold *= 2.0f;
+	}
+	return lod;
+}
+
+void buildIndexRanges(const ChunkLods &chunks, const uint8_t *lods, IndexRanges &ranges) {
+	ranges.clear();
+	for (size_t i = 0; i < chunks.size(); ++i) {
+		const ChunkLod &chunk = chunks[i];
+		const uint8_t lod = lods[i];
+		const uint32_t count = chunk.count[lod];
+		if (count == 0u) {
+			continue;
+		}
+		const uint32_t offset = chunk.offset[lod];
+		const int32_t baseVertex = chunk.baseVertex[lod];
+		if (!ranges.empty() && ranges.back().offset + ranges.back().count == offset &&
+			ranges.back().baseVertex == baseVertex) {
+			ranges.back().count += count;
+			continue;
+		}
+		IndexRange range;
+		range.offset = offset;
+		range.count = count;
+		range.baseVertex = baseVertex;
+		ranges.push_back(range);
+	}
+}
+
+} // namespace voxelrender
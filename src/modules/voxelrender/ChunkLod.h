@@ -0,0 +1,52 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/collection/DynamicArray.h"
+#include "voxel/MeshState.h"
+#include <glm/vec3.hpp>
+
+namespace voxelrender {
+
+/**
+ * @brief The index ranges of a chunk mesh for every detail level
+ *
+ * All chunks of a volume share one index buffer. The full resolution meshes come first, followed by the chunks of
+ * every lower detail level in the same order.
+ */
+struct ChunkLod {
+	/** the center of the chunk in object space */
+	glm::vec3 center{0.0f};
+	uint32_t offset[voxel::MeshState::MaxLods]{};
+	uint32_t count[voxel::MeshState::MaxLods]{};
+	/** added to the indices of the chunk - the packed chunks keep their own 16 bit indices */
+	int32_t baseVertex[voxel::MeshState::MaxLods]{};
+};
+using ChunkLods = core::DynamicArray<ChunkLod>;
+
+struct IndexRange {
+	uint32_t offset = 0u;
+	uint32_t count = 0u;
+	int32_t baseVertex = 0;
+};
+using IndexRanges = core::DynamicArray<IndexRange>;
+
+/**
+ * @return The detail level for the given distance - level @c n is used from a distance of
+ * @c lodDistance*2^(n-1) on. A @c lodDistance of @c 0 disables the lower detail levels.
+ */
+int selectLod(float distance, float lodDistance, int maxLods = voxel::MeshState::MaxLods);
+
+/**
+ * @brief Collects the index ranges of the chunks for their selected detail levels
+ *
+ * Ranges that follow each other in the index buffer and share the same base vertex are merged - if all chunks use the
+ * same detail level and their indices were rebased, this is a single range.
+ *
+ * @param lods The selected detail level for every chunk
+ */
+void buildIndexRanges(const ChunkLods &chunks, const uint8_t *lods, IndexRanges &ranges);
+
+} // namespace voxelrender
@@ -0,0 +1,68 @@
+/**
+ * @file
+ */
+
+#include "InstanceBatcher.h"
+#include "core/Algorithm.h"
+#include "core/Assert.h"
+
+namespace voxelrender {
+
+void InstanceBatcher::clear() {
+	_entries.clear();
+	_order.clear();
+	_instances.clear();
+	_batches.clear();
+}
+
+void InstanceBatcher::add(int bufferIndex, video::Face cullFace, const glm::mat4 &model, const glm::vec3 &pivot,
+						  bool gray) {
+	Entry entry;
+	entry.bufferIndex = bufferIndex;
+	entry.cullFace = cullFace;
+	entry.instance.model = model;
+	entry.instance.pivot = glm::vec4(pivot, gray ? 1.0f : 0.0f);
+	_entries.push_back(entry);
+}
+
+void InstanceBatcher::build(int maxInstances, bool keepOrder) {
+	core_assert(maxInstances > 0);
+	_order.clear();
+	_instances.clear();
+	_batches.clear();
+	const int n = (int)_entries.size();
+	_order.reserve(n);
+	_instances.reserve(n);
+	for (int i = 0; i < n; ++i) {
+		_order.push_back(i);
+	}
+	if (!keepOrder) {
+		// the sort is unstable - the entry index keeps the instances in the order they were added
+		core::sort(_order.begin(), _order.end(), [this](int a, int b) {
+			const Entry &ea = _entries[a];
+			const Entry &eb = _entries[b];
+			if (ea.bufferIndex != eb.bufferIndex) {
+				return ea.bufferIndex < eb.bufferIndex;
+			}
+			if (ea.cullFace != eb.cullFace) {
+				return ea.cullFace < eb.cullFace;
+			}
+			return a < b;
+		});
+	}
+	for (int i : _order) {
+		const Entry &entry = _entries[i];
+		if (_batches.empty() || _batches.back().bufferIndex != entry.bufferIndex ||
+			_batches.back().cullFace != entry.cullFace || _batches.back().amount >= maxInstances) {
+			Batch batch;
+			batch.bufferIndex = entry.bufferIndex;
+			batch.cullFace = entry.cullFace;
+			batch.offset = (int)_instances.size();
+			_batches.push_back(batch);
+		}
+		_instances.push_back(entry.instance);
+		++_batches.back().amount;
+	}
+}
+
+} // namespace voxelrender
@@ -0,0 +1,96 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/collection/DynamicArray.h"
+#include "video/Types.h"
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+namespace voxelrender {
+
+/**
+ * @brief Groups the volume slots that share the same mesh buffers (like reference nodes and the node they
+ * reference) into instanced draw calls
+ *
+ * Each batch is one draw call. The per instance data of a batch is stored contiguous in the instance buffer
+ * and is uploaded to the @c u_instances uniform block of the voxel shaders.
+ */
+class InstanceBatcher {
+public:
+	/**
+	 * @brief The per instance data of a draw call
+	 */
+	struct Instance {
+		glm::mat4 model{1.0f};
+		/** the xyz components are the pivot - the w component is @c 1.0 for grayed instances */
+		glm::vec4 pivot{0.0f};
+	};
+
+	struct Batch {
+		/** the volume slot that holds the mesh buffers of all instances of this batch */
+		int bufferIndex = -1;
+		video::Face cullFace = video::Face::Back;
+		/** the index of the first instance of the batch in the instance buffer */
+		int offset = 0;
+		/** the amount of instances that are rendered with this batch */
+		int amount = 0;
+	};
+	using Batches = core::DynamicArray<Batch>;
+
+private:
+	struct Entry {
+		int bufferIndex;
+		video::Face cullFace;
+		Instance instance;
+	};
+	core::DynamicArray<Entry> _entries;
+	core::DynamicArray<int> _order;
+	core::DynamicArray<Instance> _instances;
+	Batches _batches;
+
+public:
+	/**
+	 * @brief Removes all entries and batches - the allocated memory is kept for the next frame
+	 */
+	void clear();
+	/**
+	 * @brief Adds a visible volume slot that should be rendered with the mesh buffers of the given slot
+	 */
+	void add(int bufferIndex, video::Face cullFace, const glm::mat4 &model, const glm::vec3 &pivot, bool gray);
+	/**
+	 * @brief Builds the batches and the instance buffer from the added entries
+	 * @param maxInstances The maximum amount of instances of a single draw call - larger groups are split
+	 * @param keepOrder If this is @c true, only consecutive entries are merged. This is needed for the back to
+	 * front sorted transparent meshes. Otherwise all entries with the same buffer slot and face culling are merged
+	 * in the order they were added.
+	 */
+	void build(int maxInstances, bool keepOrder = false);
+
+	const Batches &batches() const;
+	/**
+	 * @return The pointer to the first instance of the given batch - there are @c Batch::amount instances
+	 */
+	const Instance *instances(const Batch &batch) const;
+	/**
+	 * @return The amount of added entries
+	 */
+	int size() const;
+};
+
+inline const InstanceBatcher::Batches &InstanceBatcher::batches() const {
+	return _batches;
+}
+
+inline const InstanceBatcher::Instance *InstanceBatcher::instances(const Batch &batch) const {
+	return &_instances[batch.offset];
+}
+
+inline int InstanceBatcher::size() const {
+	return (int)_entries.size();
+}
+
+} // namespace voxelrender
@@ -4,6 +4,7 @@
 
 #include "RawVolumeRenderer.h"
 #include "ShaderAttribute.h"
+#include "app/I18N.h"
 #include "VoxelShaderConstants.h"
 #include "core/Algorithm.h"
 #include "core/ArrayLength.h"
@@ -98,78 +99,141 @@ RawVolumeRenderer::RawVolumeRenderer() : RawVolumeRenderer(core::make_shared<vox
 
 void RawVolumeRenderer::construct() {
 	_meshState->construct();
+	core::Var::get(cfg::VoxelMeshLodDistance, "256",
+				   _("The distance at which the first lower resolution chunk meshes are rendered"));
 }
 
-bool RawVolumeRenderer::initStateBuffers() {
-	const voxel::SurfaceExtractionType meshMode = _meshState->meshMode();
-	const bool normals = meshMode != voxel::SurfaceExtractionType::Cubic;
-	for (int idx = 0; idx < voxel::MAX_VOLUMES; ++idx) {
-		State &state = _state[idx];
-		_meshState->setModel(idx, glm::mat4(1.0f));
-		for (int i = 0; i < voxel::MeshType_Max; ++i) {
-			state._vertexBufferIndex[i] = state._vertexBuffer[i].create();
-			if (state._vertexBufferIndex[i] == -1) {
-				Log::error("Could not create the vertex buffer object");
-				return false;
-			}
+RawVolumeRenderer::State *RawVolumeRenderer::state(int idx) {
+	if (idx < 0 || idx >= (int)_state.size()) {
+		return nullptr;
+	}
+	return _state[idx];
+}
 
-			if (normals) {
-				state._normalBufferIndex[i] = state._vertexBuffer[i].create();
-				if (state._normalBufferIndex[i] == -1) {
-					Log::error("Could not create the normal buffer object");
-					return false;
-				}
-			}
+const RawVolumeRenderer::State *RawVolumeRenderer::state(int idx) const {
+	if (idx < 0 || idx >= (int)_state.size()) {
+		return nullptr;
+	}
+	return _state[idx];
+}
 
-			state._indexBufferIndex[i] = state._vertexBuffer[i].create(nullptr, 0, video::BufferType::IndexBuffer);
-			if (state._indexBufferIndex[i] == -1) {
-				Log::error("Could not create the vertex buffer object for the indices");
-				return false;
-			}
+RawVolumeRenderer::State *RawVolumeRenderer::createState(int idx) {
+	if (idx < 0) {
+		return nullptr;
+	}
+	if (idx >= (int)_state.size()) {
+		_state.resize(idx + 1);
+	}
+	if (_state[idx] == nullptr) {
+		State *state = new State();
+		if (!initStateBuffers(*state)) {
+			Log::error("Failed to initialize the buffers for slot %i", idx);
+			delete state;
+			return nullptr;
 		}
+		_state[idx] = state;
 	}
+	return _state[idx];
+}
 
-	if (normals) {
-		for (int idx = 0; idx < voxel::MAX_VOLUMES; ++idx) {
-			State &state = _state[idx];
-			for (int i = 0; i < voxel::MeshType_Max; ++i) {
-				const video::Attribute &attributePos =
-					getPositionVertexAttribute(state._vertexBufferIndex[i], _voxelNormShader.getLocationPos(),
-											   _voxelNormShader.getComponentsPos());
-				state._vertexBuffer[i].addAttribute(attributePos);
-
-				const video::Attribute &attributeInfo =
-					getInfoVertexAttribute(state._vertexBufferIndex[i], _voxelNormShader.getLocationInfo(),
-										   _voxelNormShader.getComponentsInfo());
-				state._vertexBuffer[i].addAttribute(attributeInfo);
-
-				const video::Attribute &attributeNormal =
-					getNormalVertexAttribute(state._normalBufferIndex[i], _voxelNormShader.getLocationNormal(),
-											 _voxelNormShader.getComponentsNormal());
-				state._vertexBuffer[i].addAttribute(attributeNormal);
-			}
+void RawVolumeRenderer::deleteState(int idx) {
+	State *state = this->state(idx);
+	if (state == nullptr) {
+		return;
+	}
+	for (int i = 0; i < voxel::MeshType_Max; ++i) {
+		state->_vertexBuffer[i].shutdown();
+	}
+	delete state;
+	_state[idx] = nullptr;
+	while (!_state.empty() && _state.back() == nullptr) {
+		_state.pop();
+	}
+}
+
+uint32_t RawVolumeRenderer::indices(int idx, voxel::MeshType type) const {
+	const State *state = this->state(idx);
+	if (state == nullptr) {
+		return 0u;
+	}
+	return state->indices(type);
+}
+
+bool RawVolumeRenderer::initStateBuffers(State &state) {
+	const voxel::SurfaceExtractionType meshMode = _meshState->meshMode();
+	const bool normals = meshMode != voxel::SurfaceExtractionType::Cubic;
+	for (int i = 0; i < voxel::MeshType_Max; ++i) {
+		state._vertexBufferIndex[i] = state._vertexBuffer[i].create();
+		if (state._vertexBufferIndex[i] == -1) {
+			Log::error("Could not create the vertex buffer object");
+			return false;
 		}
-	} else {
-		for (int idx = 0; idx < voxel::MAX_VOLUMES; ++idx) {
-			State &state = _state[idx];
-			for (int i = 0; i < voxel::MeshType_Max; ++i) {
-				const video::Attribute &attributePos = getPositionVertexAttribute(
-					state._vertexBufferIndex[i], _voxelShader.getLocationPos(), _voxelShader.getComponentsPos());
-				state._vertexBuffer[i].addAttribute(attributePos);
-
-				const video::Attribute &attributeInfo = getInfoVertexAttribute(
-					state._vertexBufferIndex[i], _voxelShader.getLocationInfo(), _voxelShader.getComponentsInfo());
-				state._vertexBuffer[i].addAttribute(attributeInfo);
+
+		if (normals) {
+			state._normalBufferIndex[i] = state._vertexBuffer[i].create();
+			if (state._normalBufferIndex[i] == -1) {
+				Log::error("Could not create the normal buffer object");
+				return false;
 			}
 		}
+
+		state._indexBufferIndex[i] = state._vertexBuffer[i].create(nullptr, 0, video::BufferType::IndexBuffer);
+		if (state._indexBufferIndex[i] == -1) {
+			Log::error("Could not create the vertex buffer object for the indices");
+			return false;
+		}
+	}
+
+	for (int i = 0; i < voxel::MeshType_Max; ++i) {
+		setupVertexAttributes(state, (voxel::MeshType)i, normals, false);
 	}
 
 	return true;
 }
 
+void RawVolumeRenderer::setupVertexAttributes(State &state, voxel::MeshType type, bool normals, bool packed) {
+	video::Buffer &buffer = state._vertexBuffer[type];
+	buffer.clearAttributes();
+	state._packed[type] = packed;
+	if (normals) {
+		core_assert(!packed);
+		const video::Attribute &attributePos = getPositionVertexAttribute(
+			state._vertexBufferIndex[type], _voxelNormShader.getLocationPos(), _voxelNormShader.getComponentsPos());
+		buffer.addAttribute(attributePos);
+
+		const video::Attribute &attributeInfo = getInfoVertexAttribute(
+			state._vertexBufferIndex[type], _voxelNormShader.getLocationInfo(), _voxelNormShader.getComponentsInfo());
+		buffer.addAttribute(attributeInfo);
+
+		const video::Attribute &attributeNormal =
+			getNormalVertexAttribute(state._normalBufferIndex[type], _voxelNormShader.getLocationNormal(),
+									 _voxelNormShader.getComponentsNormal());
+		buffer.addAttribute(attributeNormal);
+		return;
+	}
+	if (packed) {
+		const video::Attribute &attributePos = getPackedPositionVertexAttribute(
+			state._vertexBufferIndex[type], _voxelShader.getLocationPos(), _voxelShader.getComponentsPos());
+		buffer.addAttribute(attributePos);
+
+		const video::Attribute &attributeInfo = getPackedInfoVertexAttribute(
+			state._vertexBufferIndex[type], _voxelShader.getLocationInfo(), _voxelShader.getComponentsInfo());
+		buffer.addAttribute(attributeInfo);
+		return;
+	}
+	const video::Attribute &attributePos = getPositionVertexAttribute(
+		state._vertexBufferIndex[type], _voxelShader.getLocationPos(), _voxelShader.getComponentsPos());
+	buffer.addAttribute(attributePos);
+
+	const video::Attribute &attributeInfo = getInfoVertexAttribute(
+		state._vertexBufferIndex[type], _voxelShader.getLocationInfo(), _voxelShader.getComponentsInfo());
+	buffer.addAttribute(attributeInfo);
+}
+
 bool RawVolumeRenderer::init() {
 	_shadowMap = core::Var::getSafe(cfg::ClientShadowMap);
 	_bloom = core::Var::getSafe(cfg::ClientBloom);
+	_meshLodDistance = core::Var::getSafe(cfg::VoxelMeshLodDistance);
 
 	_meshState->init();
 
@@ -188,8 +252,10 @@ bool RawVolumeRenderer::init() {
 	alignas(16) shader::ShadowmapData::BlockData var;
 	_shadowMapUniformBlock.create(var);
 
-	if (!initStateBuffers()) {
-		Log::error("Failed to initialize the state buffers");
+	const int shaderInstancesArraySize = lengthof(shader::VoxelData::InstancesData::model);
+	if constexpr (shaderInstancesArraySize != shader::VoxelShaderConstants::getMaxInstances()) {
+		Log::error("Shader instance arrays and the max instances don't match in their size: %i - %i",
+				   shaderInstancesArraySize, shader::VoxelShaderConstants::getMaxInstances());
 		return false;
 	}
 
@@ -224,6 +290,7 @@ bool RawVolumeRenderer::init() {
 
 	_voxelData.create(_voxelShaderFragData);
 	_voxelData.create(_voxelShaderVertData);
+	_voxelData.create(_voxelShaderInstancesData);
 
 	return true;
 }
@@ -258,63 +325,225 @@ void RawVolumeRenderer::update() {
 	}
 }
 
+namespace {
+
+/**
+ * @brief A chunk mesh of the mesh state - the cubic chunk meshes are packed, the others are kept as they were
+ * extracted
+ */
+struct ChunkMeshRef {
+	const voxel::Mesh *mesh = nullptr;
+	const voxel::PackedMesh *packed = nullptr;
+
+	inline bool isValid() const {
+		return mesh != nullptr || packed != nullptr;
+	}
+
+	inline size_t vertices() const {
+		return packed != nullptr ? packed->getNoOfVertices() : mesh->getNoOfVertices();
+	}
+
+	inline size_t indices() const {
+		return packed != nullptr ? packed->getNoOfIndices() : mesh->getNoOfIndices();
+	}
+
+	inline size_t normals() const {
+		return packed != nullptr ? 0u : mesh->getNormalVector().size();
+	}
+};
+
+} // namespace
+
+static ChunkMeshRef findChunkMesh(const voxel::MeshState &meshState, voxel::MeshType type, int idx, int lod,
+								  const glm::ivec3 &mins) {
+	ChunkMeshRef ref;
+	const voxel::MeshState::MeshesMap &meshes = meshState.meshes(type, idx, lod);
+	auto iter = meshes.find(mins);
+	if (iter != meshes.end()) {
+		ref.mesh = iter->second;
+		return ref;
+	}
+	const voxel::MeshState::PackedMeshesMap &packedMeshes = meshState.packedMeshes(type, idx, lod);
+	auto packedIter = packedMeshes.find(mins);
+	if (packedIter != packedMeshes.end()) {
+		ref.packed = packedIter->second;
+	}
+	return ref;
+}
+
+/**
+ * @brief Writes the indices of a chunk mesh - rebased by the given vertex offset
+ */
+template<class IndexArrayType>
+static void copyIndices(const IndexArrayType &indexVector, uint32_t vertexOffset, bool shortIndices,
+						voxel::PackedIndexType *&indices16Pos, voxel::IndexType *&indices32Pos) {
+	if (shortIndices) {
+		for (const auto index : indexVector) {
+			*indices16Pos++ = (voxel::PackedIndexType)(index + vertexOffset);
+		}
+	} else {
+		for (const auto index : indexVector) {
+			*indices32Pos++ = (voxel::IndexType)index + vertexOffset;
+		}
+	}
+}
+
 bool RawVolumeRenderer::updateBufferForVolume(int idx, voxel::MeshType type) {
-	if (idx < 0 || idx >= voxel::MAX_VOLUMES) {
+	if (idx < 0 || idx >= _meshState->volumeSlots()) {
 		return false;
 	}
 	core_trace_scoped(RawVolumeRendererUpdate);
 
 	const int bufferIndex = _meshState->resolveIdx(idx);
+	// the chunks of the full resolution meshes - the lower detail levels follow in the same chunk order
+	core::DynamicArray<glm::ivec3> chunks;
+	core::DynamicArray<ChunkMeshRef> uploads;
+	for (const auto &i : _meshState->meshes(type, bufferIndex)) {
+		const voxel::Mesh *mesh = i->second;
+		if (mesh == nullptr || mesh->getNoOfIndices() <= 0) {
+			continue;
+		}
+		chunks.push_back(i->first);
+		ChunkMeshRef ref;
+		ref.mesh = mesh;
+		uploads.push_back(ref);
+	}
+	for (const auto &i : _meshState->packedMeshes(type, bufferIndex)) {
+		const voxel::PackedMesh *mesh = i->second;
+		if (mesh->isEmpty()) {
+			continue;
+		}
+		chunks.push_back(i->first);
+		ChunkMeshRef ref;
+		ref.packed = mesh;
+		uploads.push_back(ref);
+	}
+	const int lods = type == voxel::MeshType_Opaque && _meshState->lodEnabled() ? voxel::MeshState::MaxLods : 1;
+	for (int lod = 1; lod < lods; ++lod) {
+		for (const glm::ivec3 &mins : chunks) {
+			// a missing level is not yet extracted - the chunk falls back to the previous level
+			uploads.push_back(findChunkMesh(*_meshState.get(), type, bufferIndex, lod, mins));
+		}
+	}
+
+	// cubic meshes are uploaded as packed vertices - see voxel::PackedMesh
+	const bool normals = _meshState->meshMode() != voxel::SurfaceExtractionType::Cubic;
+	bool packed = !normals;
 	size_t vertCount = 0u;
 	size_t normalsCount = 0u;
 	size_t indCount = 0u;
-	_meshState->count(type, bufferIndex, vertCount, normalsCount, indCount);
+	for (const ChunkMeshRef &upload : uploads) {
+		if (!upload.isValid() || upload.indices() == 0u) {
+			continue;
+		}
+		vertCount += upload.vertices();
+		normalsCount += upload.normals();
+		indCount += upload.indices();
+		if (upload.packed == nullptr) {
+			// a chunk that is not packable - the whole volume is uploaded with the full vertex layout
+			packed = false;
+		}
+	}
 
-	State &state = _state[bufferIndex];
 	if (indCount == 0u || vertCount == 0u) {
 		Log::debug("clear vertexbuffer: %i", idx);
-		video::Buffer &buffer = state._vertexBuffer[type];
-		buffer.update(state._vertexBufferIndex[type], nullptr, 0);
-		buffer.update(state._normalBufferIndex[type], nullptr, 0);
-		buffer.update(state._indexBufferIndex[type], nullptr, 0);
+		deleteMesh(bufferIndex, type);
 		return true;
 	}
+	State *statePtr = createState(bufferIndex);
+	if (statePtr == nullptr) {
+		return false;
+	}
+	State &state = *statePtr;
 
-	const size_t verticesBufSize = vertCount * sizeof(voxel::VoxelVertex);
-	voxel::VoxelVertex *verticesBuf = (voxel::VoxelVertex *)core_malloc(verticesBufSize);
+	if (packed != state._packed[type]) {
+		setupVertexAttributes(state, type, normals, packed);
+	}
+	const size_t vertexSize = packed ? sizeof(voxel::PackedVoxelVertex) : sizeof(voxel::VoxelVertex);
+	// the indices are rebased into one range if all vertices of the volume can be addressed with 16 bit indices -
+	// otherwise the packed chunks keep their own indices and are drawn with a base vertex
+	const bool rebase = vertCount <= (size_t)UINT16_MAX + 1u;
+	const bool baseVertex = packed && !rebase;
+	const bool shortIndices = packed || rebase;
+	const size_t indexSize = shortIndices ? sizeof(voxel::PackedIndexType) : sizeof(voxel::IndexType);
+	state._indexSize[type] = (uint8_t)indexSize;
+
+	const size_t verticesBufSize = vertCount * vertexSize;
+	uint8_t *verticesBuf = (uint8_t *)core_malloc(verticesBufSize);
 	const size_t normalsBufSize = normalsCount * sizeof(glm::vec3);
 	glm::vec3 *normalsBuf = (glm::vec3 *)core_malloc(normalsBufSize);
-	const size_t indicesBufSize = indCount * sizeof(voxel::IndexType);
-	voxel::IndexType *indicesBuf = (voxel::IndexType *)core_malloc(indicesBufSize);
+	const size_t indicesBufSize = indCount * indexSize;
+	uint8_t *indicesBuf = (uint8_t *)core_malloc(indicesBufSize);
 
-	voxel::VoxelVertex *verticesPos = verticesBuf;
+	uint8_t *verticesPos = verticesBuf;
 	glm::vec3 *normalsPos = normalsBuf;
-	voxel::IndexType *indicesPos = indicesBuf;
+	voxel::PackedIndexType *indices16Pos = (voxel::PackedIndexType *)indicesBuf;
+	voxel::IndexType *indices32Pos = (voxel::IndexType *)indicesBuf;
+
+	// the chunk ranges are needed to select the detail levels and for the base vertex draws
+	ChunkLods &chunkLods = state._chunkLods[type];
+	chunkLods.clear();
+	state._lods[type] = (uint8_t)lods;
+	if (lods > 1 || baseVertex) {
+		const glm::vec3 halfChunk((float)_meshState->meshSize() / 2.0f);
+		chunkLods.resize(chunks.size());
+		for (size_t i = 0; i < chunks.size(); ++i) {
+			chunkLods[i].center = glm::vec3(chunks[i]) + halfChunk;
+		}
+	}
 
-	voxel::IndexType offset = (voxel::IndexType)0;
-	for (const auto &i : _meshState->meshes(type)) {
-		const voxel::MeshState::Meshes &meshes = i->second;
-		const voxel::Mesh *mesh = meshes[bufferIndex];
-		if (mesh == nullptr || mesh->getNoOfIndices() <= 0) {
-			continue;
+	uint32_t vertexOffset = 0u;
+	uint32_t indexOffset = 0u;
+	for (size_t u = 0; u < uploads.size(); ++u) {
+		const ChunkMeshRef &upload = uploads[u];
+		if (!chunkLods.empty()) {
+			ChunkLod &chunkLod = chunkLods[u % chunks.size()];
+			const int lod = (int)(u / chunks.size());
+			if (!upload.isValid()) {
+				chunkLod.offset[lod] = chunkLod.offset[lod - 1];
+				chunkLod.count[lod] = chunkLod.count[lod - 1];
+				chunkLod.baseVertex[lod] = chunkLod.baseVertex[lod - 1];
+				continue;
+			}
+			chunkLod.offset[lod] = indexOffset;
+			chunkLod.count[lod] = (uint32_t)upload.indices();
+			chunkLod.baseVertex[lod] = baseVertex ? (int32_t)vertexOffset : 0;
 		}
-		const voxel::VertexArray &vertexVector = mesh->getVertexVector();
-		const voxel::NormalArray &normalVector = mesh->getNormalVector();
-		const voxel::IndexArray &indexVector = mesh->getIndexVector();
-		core_memcpy(verticesPos, &vertexVector[0], vertexVector.size() * sizeof(voxel::VoxelVertex));
-		if (!normalVector.empty()) {
-			core_assert(vertexVector.size() == normalVector.size());
-			core_memcpy(normalsPos, &normalVector[0], normalVector.size() * sizeof(glm::vec3));
+		if (!upload.isValid() || upload.indices() == 0u) {
+			continue;
 		}
-		core_memcpy(indicesPos, &indexVector[0], indexVector.size() * sizeof(voxel::IndexType));
-
-		for (size_t j = 0; j < indexVector.size(); ++j) {
-			*indicesPos++ += offset;
+		indexOffset += (uint32_t)upload.indices();
+		if (upload.packed != nullptr) {
+			const voxel::PackedVertexArray &vertexVector = upload.packed->getVertexVector();
+			const voxel::PackedIndexArray &indexVector = upload.packed->getIndexVector();
+			if (packed) {
+				core_memcpy(verticesPos, vertexVector.data(), vertexVector.size() * sizeof(voxel::PackedVoxelVertex));
+			} else {
+				voxel::VoxelVertex *unpackedPos = (voxel::VoxelVertex *)verticesPos;
+				for (const voxel::PackedVoxelVertex &vertex : vertexVector) {
+					*unpackedPos++ = voxel::unpackVertex(vertex);
+				}
+			}
+			if (baseVertex) {
+				core_memcpy(indices16Pos, indexVector.data(), indexVector.size() * sizeof(voxel::PackedIndexType));
+				indices16Pos += indexVector.size();
+			} else {
+				copyIndices(indexVector, vertexOffset, shortIndices, indices16Pos, indices32Pos);
+			}
+		} else {
+			const voxel::VertexArray &vertexVector = upload.mesh->getVertexVector();
+			const voxel::NormalArray &normalVector = upload.mesh->getNormalVector();
+			core_memcpy(verticesPos, vertexVector.data(), vertexVector.size() * sizeof(voxel::VoxelVertex));
+			if (!normalVector.empty()) {
+				core_assert(vertexVector.size() == normalVector.size());
+				core_memcpy(normalsPos, normalVector.data(), normalVector.size() * sizeof(glm::vec3));
+				normalsPos += normalVector.size();
+			}
+			copyIndices(upload.mesh->getIndexVector(), vertexOffset, shortIndices, indices16Pos, indices32Pos);
 		}
 
-		verticesPos += vertexVector.size();
-		normalsPos += normalVector.size();
-		offset += vertexVector.size();
+		verticesPos += upload.vertices() * vertexSize;
+		vertexOffset += (uint32_t)upload.vertices();
 	}
 
 	Log::debug("update vertexbuffer: %i (type: %i)", idx, type);
@@ -356,6 +585,7 @@ void RawVolumeRenderer::setDiffuseColor(const glm::vec3 &color) {
 
 void RawVolumeRenderer::resetVolume(int idx) {
 	setVolume(idx, nullptr, nullptr, true);
+	deleteState(idx);
 }
 
 bool RawVolumeRenderer::updateBufferForVolume(int idx) {
@@ -371,15 +601,15 @@ bool RawVolumeRenderer::updateBufferForVolume(int idx) {
 
 void RawVolumeRenderer::clear() {
 	_meshState->clearPendingExtractions();
-	for (int i = 0; i < voxel::MAX_VOLUMES; ++i) {
-		// TODO: collect the old volumes and allow to let the caller delete them - they might not all be managed by a
-		// node
-		voxel::RawVolume *old = setVolume(i, nullptr, nullptr, true);
-		if (old != nullptr) {
-			updateBufferForVolume(i);
-		}
+	// TODO: collect the old volumes and allow to let the caller delete them - they might not all be managed by a
+	// node
+	for (int i = _meshState->volumeSlots() - 1; i >= 0; --i) {
+		resetVolume(i);
+	}
+	for (int i = (int)_state.size() - 1; i >= 0; --i) {
+		deleteState(i);
 	}
-	_meshState->resetReferences();
+	_culled.clear();
 }
 
 void RawVolumeRenderer::updatePalette(int idx) {
@@ -401,19 +631,15 @@ void RawVolumeRenderer::updatePalette(int idx) {
 
 void RawVolumeRenderer::updateCulling(int idx, const video::Camera &camera) {
 	if (_meshState->hidden(idx)) {
-		_state[idx]._culled = true;
+		_culled[idx] = true;
 		return;
 	}
-	_state[idx]._culled = false;
+	_culled[idx] = false;
 	// check a potentially referenced mesh here
 	const int bufferIndex = _meshState->resolveIdx(idx);
-	if (!_state[bufferIndex].hasData()) {
-#if 0
-		if (_state[bufferIndex]._rawVolume) {
-			Log::trace("No data, but volume: %i", bufferIndex);
-		}
-#endif
-		_state[idx]._culled = true;
+	const State *state = this->state(bufferIndex);
+	if (state == nullptr || !state->hasData()) {
+		_culled[idx] = true;
 		return;
 	}
 	const glm::ivec3 &mins = _meshState->mins(idx);
@@ -421,7 +647,7 @@ void RawVolumeRenderer::updateCulling(int idx, const video::Camera &camera) {
 	const glm::vec3 size = maxs - mins;
 	// if no mins/maxs were given, we can't cull
 	if (size.x >= 1.0f && size.y >= 1.0f && size.z >= 1.0f) {
-		_state[idx]._culled = !camera.isVisible(mins, maxs);
+		_culled[idx] = !camera.isVisible(mins, maxs);
 	}
 }
 
@@ -429,17 +655,31 @@ bool RawVolumeRenderer::isVisible(int idx) const {
 	if (_meshState->hidden(idx)) {
 		return false;
 	}
-	if (_state[idx]._culled) {
+	if (idx < (int)_culled.size() && _culled[idx]) {
 		return false;
 	}
 	return true;
 }
 
+void RawVolumeRenderer::uploadInstances(const InstanceBatcher &batcher, const InstanceBatcher::Batch &batch) {
+	const InstanceBatcher::Instance *instances = batcher.instances(batch);
+	for (int i = 0; i < batch.amount; ++i) {
+		_voxelShaderInstancesData.model[i] = instances[i].model;
+		_voxelShaderInstancesData.pivot[i] = instances[i].pivot;
+	}
+	core_assert_always(_voxelData.update(_voxelShaderInstancesData));
+}
+
 void RawVolumeRenderer::render(RenderContext &renderContext, const video::Camera &camera, bool shadow) {
 	core_trace_scoped(RawVolumeRendererRender);
+	renderContext.drawCalls = 0;
+	renderContext.instances = 0;
 
+	// only the slots that are in use are visited - the unused ones are hidden
+	const int slots = _meshState->volumeSlots();
+	_culled.resize(slots);
 	bool visible = false;
-	for (int idx = 0; idx < voxel::MAX_VOLUMES; ++idx) {
+	for (int idx = 0; idx < slots; ++idx) {
 		updateCulling(idx, camera);
 		if (!isVisible(idx)) {
 			continue;
@@ -449,15 +689,15 @@ void RawVolumeRenderer::render(RenderContext &renderContext, const video::Camera
 	if (!visible) {
 		return;
 	}
-	for (const auto &i : _meshState->meshes(voxel::MeshType_Transparency)) {
-		for (int idx = 0; idx < voxel::MAX_VOLUMES; ++idx) {
-			if (!isVisible(idx)) {
-				continue;
-			}
-			const int bufferIndex = _meshState->resolveIdx(idx);
+	for (int idx = 0; idx < slots; ++idx) {
+		if (!isVisible(idx)) {
+			continue;
+		}
+		const int bufferIndex = _meshState->resolveIdx(idx);
+		for (const auto &i : _meshState->meshes(voxel::MeshType_Transparency, bufferIndex)) {
 			// TODO: transform - vertices are in object space - eye in world space
 			// inverse of state._model - but take pivot into account
-			voxel::Mesh *mesh = i->second[bufferIndex];
+			voxel::Mesh *mesh = i->second;
 			if (!mesh || mesh->isEmpty()) {
 				continue;
 			}
@@ -465,7 +705,36 @@ void RawVolumeRenderer::render(RenderContext &renderContext, const video::Camera
 				updateBufferForVolume(bufferIndex, voxel::MeshType_Transparency);
 			}
 		}
+		for (const auto &i : _meshState->packedMeshes(voxel::MeshType_Transparency, bufferIndex)) {
+			voxel::PackedMesh *mesh = i->second;
+			if (mesh->isEmpty()) {
+				continue;
+			}
+			if (mesh->sort(camera.worldPosition())) {
+				updateBufferForVolume(bufferIndex, voxel::MeshType_Transparency);
+			}
+		}
+	}
+
+	// references share the buffers of the node they reference - all slots that resolve to the same buffers are
+	// rendered with one instanced draw call
+	const int maxInstances = shader::VoxelShaderConstants::getMaxInstances();
+	_opaqueBatcher.clear();
+	for (int idx = 0; idx < slots; ++idx) {
+		if (!isVisible(idx)) {
+			continue;
+		}
+		const int bufferIndex = _meshState->resolveIdx(idx);
+		if (indices(bufferIndex, voxel::MeshType_Opaque) == 0u) {
+			if (_meshState->volume(bufferIndex)) {
+				Log::debug("No indices but volume for idx %d: %d", idx, bufferIndex);
+			}
+			continue;
+		}
+		_opaqueBatcher.add(bufferIndex, _meshState->cullFace(idx), _meshState->model(idx), _meshState->pivot(idx),
+						   _meshState->grayed(idx));
 	}
+	_opaqueBatcher.build(maxInstances);
 
 	video::ScopedState scopedDepth(video::State::DepthTest);
 	video::depthFunc(video::CompareFunc::LessEqual);
@@ -478,28 +747,21 @@ void RawVolumeRenderer::render(RenderContext &renderContext, const video::Camera
 		if (shadow) {
 			video::ScopedShader scoped(_shadowMapShader);
 			_shadow.render(
-				[this](int depthBufferIndex, const glm::mat4 &lightViewProjection) {
+				[this, &renderContext, &camera](int depthBufferIndex, const glm::mat4 &lightViewProjection) {
 					alignas(16) shader::ShadowmapData::BlockData var;
 					var.lightviewprojection = lightViewProjection;
-
-					for (int idx = 0; idx < voxel::MAX_VOLUMES; ++idx) {
-						if (!isVisible(idx)) {
-							continue;
-						}
-						const int bufferIndex = _meshState->resolveIdx(idx);
-						for (int i = 0; i < voxel::MeshType_Transparency; ++i) { // TODO: do we want this for the transparent voxels, too?
-							const uint32_t indices = _state[bufferIndex].indices((voxel::MeshType)i);
-							if (indices > 0u) {
-								video::ScopedBuffer scopedBuf(_state[bufferIndex]._vertexBuffer[i]);
-								var.model = _meshState->model(idx);
-								var.pivot = _meshState->pivot(idx);
-								_shadowMapUniformBlock.update(var);
-								_shadowMapShader.setBlock(_shadowMapUniformBlock.getBlockUniformBuffer());
-								video::ScopedFaceCull scopedFaceCull(_meshState->cullFace(idx));
-								static_assert(sizeof(voxel::IndexType) == sizeof(uint32_t), "Index type doesn't match");
-								video::drawElements<voxel::IndexType>(video::Primitive::Triangles, indices);
-							}
-						}
+					_shadowMapUniformBlock.update(var);
+
+					// TODO: do we want this for the transparent voxels, too?
+					for (const InstanceBatcher::Batch &batch : _opaqueBatcher.batches()) {
+						const State &state = *_state[batch.bufferIndex];
+						video::ScopedBuffer scopedBuf(state._vertexBuffer[voxel::MeshType_Opaque]);
+						uploadInstances(_opaqueBatcher, batch);
+						_shadowMapShader.setBlock(_shadowMapUniformBlock.getBlockUniformBuffer());
+						_shadowMapShader.setInstances(_voxelData.getInstancesUniformBuffer());
+						video::ScopedFaceCull scopedFaceCull(batch.cullFace);
+						// the detail levels are selected by the view camera - the shadows match the rendered meshes
+						drawBatch(renderContext, camera, state, _opaqueBatcher, batch, voxel::MeshType_Opaque);
 					}
 					return true;
 				},
@@ -543,55 +805,20 @@ void RawVolumeRenderer::render(RenderContext &renderContext, const video::Camera
 
 	_paletteHash = 0;
 	// --- opaque pass
-	for (int idx = 0; idx < voxel::MAX_VOLUMES; ++idx) {
-		if (!isVisible(idx)) {
-			continue;
-		}
-		const int bufferIndex = _meshState->resolveIdx(idx);
-		const uint32_t indices = _state[bufferIndex].indices(voxel::MeshType_Opaque);
-		if (indices == 0u) {
-			if (_meshState->volume(bufferIndex)) {
-				Log::debug("No indices but volume for idx %d: %d", idx, bufferIndex);
-			}
-			continue;
-		}
-
-		updatePalette(bufferIndex);
-		_voxelShaderVertData.viewprojection = camera.viewProjectionMatrix();
-		_voxelShaderVertData.model = _meshState->model(idx);
-		_voxelShaderVertData.pivot = _meshState->pivot(idx);
-		_voxelShaderVertData.gray = _meshState->grayed(idx);
-		core_assert_always(_voxelData.update(_voxelShaderVertData));
-
-		video::ScopedPolygonMode polygonMode(mode);
-		video::ScopedFaceCull scopedFaceCull(_meshState->cullFace(idx));
-		video::ScopedBuffer scopedBuf(_state[bufferIndex]._vertexBuffer[voxel::MeshType_Opaque]);
-		if (normals) {
-			core_assert_always(_voxelNormShader.setFrag(_voxelData.getFragUniformBuffer()));
-			core_assert_always(_voxelNormShader.setVert(_voxelData.getVertUniformBuffer()));
-			if (_shadowMap->boolVal()) {
-				_voxelNormShader.setShadowmap(video::TextureUnit::One);
-			}
-		} else {
-			core_assert_always(_voxelShader.setFrag(_voxelData.getFragUniformBuffer()));
-			core_assert_always(_voxelShader.setVert(_voxelData.getVertUniformBuffer()));
-			if (_shadowMap->boolVal()) {
-				_voxelShader.setShadowmap(video::TextureUnit::One);
-			}
-		}
-		video::drawElements<voxel::IndexType>(video::Primitive::Triangles, indices);
+	for (const InstanceBatcher::Batch &batch : _opaqueBatcher.batches()) {
+		renderBatch(renderContext, camera, _opaqueBatcher, batch, voxel::MeshType_Opaque, normals);
 	}
 
 	// --- transparency pass
 	{
 		core::DynamicArray<int> sorted;
-		sorted.reserve(voxel::MAX_VOLUMES);
-		for (int idx = 0; idx < voxel::MAX_VOLUMES; ++idx) {
+		sorted.reserve(slots);
+		for (int idx = 0; idx < slots; ++idx) {
 			if (!isVisible(idx)) {
 				continue;
 			}
 			const int bufferIndex = _meshState->resolveIdx(idx);
-			const uint32_t indices = _state[bufferIndex].indices(voxel::MeshType_Transparency);
+			const uint32_t indices = this->indices(bufferIndex, voxel::MeshType_Transparency);
 			if (indices == 0u) {
 				continue;
 			}
@@ -608,34 +835,17 @@ void RawVolumeRenderer::render(RenderContext &renderContext, const video::Camera
 			return d1 > d2;
 		});
 
-		video::ScopedState scopedBlendTrans(video::State::Blend, true);
+		// only neighbours in the back to front order can share a draw call
+		_transparentBatcher.clear();
 		for (int idx : sorted) {
-			const int bufferIndex = _meshState->resolveIdx(idx);
-			const uint32_t indices = _state[bufferIndex].indices(voxel::MeshType_Transparency);
-			updatePalette(idx);
-			_voxelShaderVertData.viewprojection = camera.viewProjectionMatrix();
-			_voxelShaderVertData.model = _meshState->model(idx);
-			_voxelShaderVertData.pivot = _meshState->pivot(idx);
-			_voxelShaderVertData.gray = _meshState->grayed(idx);
-			core_assert_always(_voxelData.update(_voxelShaderVertData));
-
-			video::ScopedPolygonMode polygonMode(mode);
-			video::ScopedFaceCull scopedFaceCull(_meshState->cullFace(idx));
-			video::ScopedBuffer scopedBuf(_state[bufferIndex]._vertexBuffer[voxel::MeshType_Transparency]);
-			if (normals) {
-				core_assert_always(_voxelNormShader.setFrag(_voxelData.getFragUniformBuffer()));
-				core_assert_always(_voxelNormShader.setVert(_voxelData.getVertUniformBuffer()));
-				if (_shadowMap->boolVal()) {
-					_voxelNormShader.setShadowmap(video::TextureUnit::One);
-				}
-			} else {
-				core_assert_always(_voxelShader.setFrag(_voxelData.getFragUniformBuffer()));
-				core_assert_always(_voxelShader.setVert(_voxelData.getVertUniformBuffer()));
-				if (_shadowMap->boolVal()) {
-					_voxelShader.setShadowmap(video::TextureUnit::One);
-				}
-			}
-			video::drawElements<voxel::IndexType>(video::Primitive::Triangles, indices);
+			_transparentBatcher.add(_meshState->resolveIdx(idx), _meshState->cullFace(idx), _meshState->model(idx),
+									_meshState->pivot(idx), _meshState->grayed(idx));
+		}
+		_transparentBatcher.build(maxInstances, true);
+
+		video::ScopedState scopedBlendTrans(video::State::Blend, true);
+		for (const InstanceBatcher::Batch &batch : _transparentBatcher.batches()) {
+			renderBatch(renderContext, camera, _transparentBatcher, batch, voxel::MeshType_Transparency, normals);
 		}
 	}
 
@@ -660,6 +870,90 @@ void RawVolumeRenderer::render(RenderContext &renderContext, const video::Camera
 	video::useProgram(oldShader);
 }
 
+void RawVolumeRenderer::renderBatch(RenderContext &renderContext, const video::Camera &camera,
+									const InstanceBatcher &batcher, const InstanceBatcher::Batch &batch,
+									voxel::MeshType type, bool normals) {
+	const State &state = *_state[batch.bufferIndex];
+	updatePalette(batch.bufferIndex);
+	_voxelShaderVertData.viewprojection = camera.viewProjectionMatrix();
+	core_assert_always(_voxelData.update(_voxelShaderVertData));
+	uploadInstances(batcher, batch);
+
+	video::ScopedPolygonMode polygonMode(camera.polygonMode());
+	video::ScopedFaceCull scopedFaceCull(batch.cullFace);
+	video::ScopedBuffer scopedBuf(state._vertexBuffer[type]);
+	if (normals) {
+		core_assert_always(_voxelNormShader.setFrag(_voxelData.getFragUniformBuffer()));
+		core_assert_always(_voxelNormShader.setVert(_voxelData.getVertUniformBuffer()));
+		core_assert_always(_voxelNormShader.setInstances(_voxelData.getInstancesUniformBuffer()));
+		if (_shadowMap->boolVal()) {
+			_voxelNormShader.setShadowmap(video::TextureUnit::One);
+		}
+	} else {
+		core_assert_always(_voxelShader.setFrag(_voxelData.getFragUniformBuffer()));
+		core_assert_always(_voxelShader.setVert(_voxelData.getVertUniformBuffer()));
+		core_assert_always(_voxelShader.setInstances(_voxelData.getInstancesUniformBuffer()));
+		if (_shadowMap->boolVal()) {
+			_voxelShader.setShadowmap(video::TextureUnit::One);
+		}
+	}
+	drawBatch(renderContext, camera, state, batcher, batch, type);
+	renderContext.instances += batch.amount;
+}
+
+/**
+ * @brief Transforms an object space position of the mesh into world space - see the voxel vertex shader
+ */
+static inline glm::vec3 worldPos(const InstanceBatcher::Instance &instance, const glm::vec3 &pos) {
+	return glm::vec3(instance.model * glm::vec4(pos - glm::vec3(instance.pivot), 1.0f));
+}
+
+const IndexRanges &RawVolumeRenderer::indexRanges(const State &state, voxel::MeshType type,
+												  const video::Camera &camera, const InstanceBatcher &batcher,
+												  const InstanceBatcher::Batch &batch) {
+	_indexRanges.clear();
+	const ChunkLods &chunks = state._chunkLods[type];
+	if (chunks.empty()) {
+		IndexRange range;
+		range.count = state.indices(type);
+		_indexRanges.push_back(range);
+		return _indexRanges;
+	}
+	_selectedLods.resize(chunks.size());
+	if (state._lods[type] <= 1) {
+		// the chunks are only split for the base vertex draws
+		for (size_t i = 0; i < chunks.size(); ++i) {
+			_selectedLods[i] = 0;
+		}
+		buildIndexRanges(chunks, _selectedLods.data(), _indexRanges);
+		return _indexRanges;
+	}
+	const InstanceBatcher::Instance *instances = batcher.instances(batch);
+	const glm::vec3 &camPos = camera.worldPosition();
+	const float lodDistance = _meshLodDistance->floatVal();
+	for (size_t i = 0; i < chunks.size(); ++i) {
+		// the closest instance decides about the detail level of the chunk for all instances of the batch
+		float distance2 = glm::distance2(camPos, worldPos(instances[0], chunks[i].center));
+		for (int j = 1; j < batch.amount; ++j) {
+			distance2 = core_min(distance2, glm::distance2(camPos, worldPos(instances[j], chunks[i].center)));
+		}
+		_selectedLods[i] = (uint8_t)selectLod(glm::sqrt(distance2), lodDistance);
+	}
+	buildIndexRanges(chunks, _selectedLods.data(), _indexRanges);
+	return _indexRanges;
+}
+
+void RawVolumeRenderer::drawBatch(RenderContext &renderContext, const video::Camera &camera, const State &state,
+								  const InstanceBatcher &batcher, const InstanceBatcher::Batch &batch,
+								  voxel::MeshType type) {
+	const size_t indexSize = state._indexSize[type];
+	for (const IndexRange &range : indexRanges(state, type, camera, batcher, batch)) {
+		video::drawElementsInstancedBaseVertex(video::Primitive::Triangles, range.count, indexSize, batch.amount,
+											   range.baseVertex, (void *)(intptr_t)(range.offset * indexSize));
+		++renderContext.drawCalls;
+	}
+}
+
 void RawVolumeRenderer::setVolume(int idx, scenegraph::SceneGraphNode &node, bool deleteMesh) {
 	setVolume(idx, node.volume(), &node.palette(), deleteMesh);
 }
@@ -681,7 +975,11 @@ void RawVolumeRenderer::deleteMeshes(int idx) {
 }
 
 void RawVolumeRenderer::deleteMesh(int idx, voxel::MeshType meshType) {
-	State &state = _state[idx];
+	State *statePtr = state(idx);
+	if (statePtr == nullptr) {
+		return;
+	}
+	State &state = *statePtr;
 	video::Buffer &vertexBuffer = state._vertexBuffer[meshType];
 	Log::debug("clear vertexbuffer: %i", idx);
 
@@ -693,6 +991,7 @@ void RawVolumeRenderer::deleteMesh(int idx, voxel::MeshType meshType) {
 	}
 	vertexBuffer.update(state._indexBufferIndex[meshType], nullptr, 0);
 	core_assert(vertexBuffer.size(state._indexBufferIndex[meshType]) == 0);
+	state._chunkLods[meshType].clear();
 }
 
 void RawVolumeRenderer::setSunPosition(const glm::vec3 &eye, const glm::vec3 &center, const glm::vec3 &up) {
@@ -700,20 +999,32 @@ void RawVolumeRenderer::setSunPosition(const glm::vec3 &eye, const glm::vec3 &ce
 }
 
 void RawVolumeRenderer::shutdownStateBuffers() {
-	for (int idx = 0; idx < voxel::MAX_VOLUMES; ++idx) {
-		State &state = _state[idx];
+	for (State *state : _state) {
+		if (state == nullptr) {
+			continue;
+		}
 		for (int i = 0; i < voxel::MeshType_Max; ++i) {
-			state._vertexBuffer[i].shutdown();
-			state._vertexBufferIndex[i] = -1;
-			state._normalBufferIndex[i] = -1;
-			state._indexBufferIndex[i] = -1;
+			state->_vertexBuffer[i].shutdown();
+			state->_vertexBufferIndex[i] = -1;
+			state->_normalBufferIndex[i] = -1;
+			state->_indexBufferIndex[i] = -1;
+			state->_packed[i] = false;
+			state->_indexSize[i] = sizeof(voxel::IndexType);
 		}
 	}
 }
 
 bool RawVolumeRenderer::resetStateBuffers() {
 	shutdownStateBuffers();
-	return initStateBuffers();
+	for (State *state : _state) {
+		if (state == nullptr) {
+			continue;
+		}
+		if (!initStateBuffers(*state)) {
+			return false;
+		}
+	}
+	return true;
 }
 
 core::DynamicArray<voxel::RawVolume *> RawVolumeRenderer::shutdown() {
@@ -725,6 +1036,11 @@ core::DynamicArray<voxel::RawVolume *> RawVolumeRenderer::shutdown() {
 	_shadow.shutdown();
 	const core::DynamicArray<voxel::RawVolume *> &old = _meshState->shutdown();
 	shutdownStateBuffers();
+	for (State *state : _state) {
+		delete state;
+	}
+	_state.clear();
+	_culled.clear();
 	return old;
 }
 
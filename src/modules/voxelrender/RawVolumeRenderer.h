@@ -5,13 +5,15 @@
 #pragma once
 
 #include "voxel/MeshState.h"
+#include "ChunkLod.h"
+#include "InstanceBatcher.h"
 #include "ShadowmapData.h"
 #include "ShadowmapShader.h"
 #include "VoxelShader.h"
 #include "VoxelnormShader.h"
 #include "core/NonCopyable.h"
 #include "core/Var.h"
-#include "core/collection/Array.h"
+#include "core/collection/DynamicArray.h"
 #include "render/BloomRenderer.h"
 #include "scenegraph/SceneGraphAnimation.h"
 #include "video/Buffer.h"
@@ -47,6 +49,10 @@ struct RenderContext : public core::NonCopyable {
 	bool grayInactive = false;
 	bool sceneMode = false;
 	bool onlyModels = false;
+	/** the amount of voxel draw calls of the last render pass - including the shadow pass */
+	uint32_t drawCalls = 0;
+	/** the amount of rendered volume instances of the last render pass */
+	uint32_t instances = 0;
 
 	bool init(const glm::ivec2 &size);
 	void shutdown();
@@ -61,21 +67,38 @@ struct RenderContext : public core::NonCopyable {
 class RawVolumeRenderer : public core::NonCopyable {
 protected:
 	struct State {
-		bool _culled = false;
 		int32_t _vertexBufferIndex[voxel::MeshType_Max]{-1, -1};
 		int32_t _normalBufferIndex[voxel::MeshType_Max]{-1, -1};
 		int32_t _indexBufferIndex[voxel::MeshType_Max]{-1, -1};
 		video::Buffer _vertexBuffer[voxel::MeshType_Max];
+		/** the vertex buffer contains @c voxel::PackedVoxelVertex instances (cubic meshes only) */
+		bool _packed[voxel::MeshType_Max]{false, false};
+		/**
+		 * 16 bit indices are used if all vertices of the volume can be addressed with them - or if the vertices are
+		 * packed, the packed chunks are drawn with a base vertex then
+		 */
+		uint8_t _indexSize[voxel::MeshType_Max]{sizeof(voxel::IndexType), sizeof(voxel::IndexType)};
+		/**
+		 * the index ranges of the chunks for every detail level - empty if the whole index buffer is drawn at once
+		 */
+		ChunkLods _chunkLods[voxel::MeshType_Max];
+		/** the amount of detail levels in the chunk ranges */
+		uint8_t _lods[voxel::MeshType_Max]{1, 1};
 
 		uint32_t indices(voxel::MeshType type) const {
-			return _vertexBuffer[type].elements(_indexBufferIndex[type], 1, sizeof(voxel::IndexType));
+			return _vertexBuffer[type].elements(_indexBufferIndex[type], 1, _indexSize[type]);
 		}
 
 		bool hasData() const {
 			return indices(voxel::MeshType_Opaque) > 0 || indices(voxel::MeshType_Transparency) > 0;
 		}
 	};
-	core::Array<State, voxel::MAX_VOLUMES> _state{};
+	/**
+	 * @brief The buffers of the volume slots of the mesh state - allocated on the first mesh upload of a slot
+	 */
+	core::DynamicArray<State *> _state;
+	/** the culling results of the last render pass - indexed by the volume slot */
+	core::DynamicArray<bool> _culled;
 	core::SharedPtr<voxel::MeshState> _meshState;
 
 	uint64_t _paletteHash = 0;
@@ -84,6 +107,12 @@ protected:
 
 	alignas(16) shader::VoxelData::FragData _voxelShaderFragData;
 	alignas(16) shader::VoxelData::VertData _voxelShaderVertData;
+	alignas(16) shader::VoxelData::InstancesData _voxelShaderInstancesData;
+	InstanceBatcher _opaqueBatcher;
+	InstanceBatcher _transparentBatcher;
+	/** the selected detail level of every chunk of the current batch */
+	core::DynamicArray<uint8_t> _selectedLods;
+	IndexRanges _indexRanges;
 
 	shader::VoxelShader &_voxelShader;
 	shader::VoxelnormShader &_voxelNormShader;
@@ -93,14 +122,46 @@ protected:
 
 	core::VarPtr _shadowMap;
 	core::VarPtr _bloom;
+	core::VarPtr _meshLodDistance;
 
 	void updatePalette(int idx);
 	bool updateBufferForVolume(int idx, voxel::MeshType type);
+	void setupVertexAttributes(State &state, voxel::MeshType type, bool normals, bool packed);
 	void deleteMesh(int idx, voxel::MeshType meshType);
 	void deleteMeshes(int idx);
 	void updateCulling(int idx, const video::Camera &camera);
+	/**
+	 * @brief Uploads the per instance data of the given batch into the instances uniform buffer
+	 */
+	void uploadInstances(const InstanceBatcher &batcher, const InstanceBatcher::Batch &batch);
+	void renderBatch(RenderContext &renderContext, const video::Camera &camera, const InstanceBatcher &batcher,
+					 const InstanceBatcher::Batch &batch, voxel::MeshType type, bool normals);
+	/**
+	 * @brief Selects the detail level of every chunk by the distance of the closest instance of the batch to the
+	 * camera
+	 * @return The index ranges to draw - the whole index buffer if there are no detail levels
+	 */
+	const IndexRanges &indexRanges(const State &state, voxel::MeshType type, const video::Camera &camera,
+								   const InstanceBatcher &batcher, const InstanceBatcher::Batch &batch);
+	/**
+	 * @brief Issues the instanced draw calls for the given batch - the buffers and uniforms must already be bound
+	 */
+	void drawBatch(RenderContext &renderContext, const video::Camera &camera, const State &state,
+				   const InstanceBatcher &batcher, const InstanceBatcher::Batch &batch, voxel::MeshType type);
+
+	State *state(int idx);
+	const State *state(int idx) const;
+	/**
+	 * @return The state of the given slot - the buffers are created if the slot doesn't have a state yet
+	 */
+	State *createState(int idx);
+	void deleteState(int idx);
+	/**
+	 * @return The amount of indices of the given mesh type in the buffers of the given slot
+	 */
+	uint32_t indices(int idx, voxel::MeshType type) const;
 
-	bool initStateBuffers();
+	bool initStateBuffers(State &state);
 	void shutdownStateBuffers();
 	bool resetStateBuffers();
 	/**
@@ -131,6 +131,7 @@ void SceneGraphRenderer::update() {
 
 void SceneGraphRenderer::scheduleRegionExtraction(scenegraph::SceneGraphNode &node, const voxel::Region &region) {
 	_volumeRenderer.scheduleRegionExtraction(getVolumeId(node), region);
+	nodeChanged(node.id());
 }
 
 void SceneGraphRenderer::setAmbientColor(const glm::vec3 &color) {
@@ -148,135 +149,210 @@ void SceneGraphRenderer::shutdown() {
 
 void SceneGraphRenderer::clear() {
 	_volumeRenderer.clear();
+	markDirty();
 }
 
 void SceneGraphRenderer::nodeRemove(int nodeId) {
 	const int id = getVolumeId(nodeId);
-	if (id < 0 || id >= voxel::MAX_VOLUMES) {
+	if (id < 0) {
 		return;
 	}
 	_volumeRenderer.resetVolume(id);
+	// the node might still exist with a new volume
+	nodeChanged(nodeId);
 }
 
 bool SceneGraphRenderer::isVisible(int nodeId) const {
 	const int id = getVolumeId(nodeId);
-	if (id < 0 || id >= voxel::MAX_VOLUMES) {
+	if (id < 0) {
 		return false;
 	}
 	return _volumeRenderer.isVisible(id);
 }
 
-void SceneGraphRenderer::prepare(const RenderContext &renderContext) {
-	core_assert_always(renderContext.sceneGraph != nullptr);
+bool SceneGraphRenderer::PrepareState::operator==(const PrepareState &other) const {
+	return sceneGraph == other.sceneGraph && changeCounter == other.changeCounter && frame == other.frame &&
+		   activeNode == other.activeNode && hideInactive == other.hideInactive &&
+		   grayInactive == other.grayInactive && sceneMode == other.sceneMode && onlyModels == other.onlyModels;
+}
+
+void SceneGraphRenderer::nodeChanged(int nodeId) {
+	_dirtyNodes.insert(nodeId);
+}
+
+void SceneGraphRenderer::markDirty() {
+	_preparedValid = false;
+}
+
+void SceneGraphRenderer::prepareModelNode(const RenderContext &renderContext, scenegraph::SceneGraphNode &node) {
 	const scenegraph::SceneGraph &sceneGraph = *renderContext.sceneGraph;
-	const scenegraph::FrameIndex frame = renderContext.frame;
-	const bool hideInactive = renderContext.hideInactive;
-	const bool grayInactive = renderContext.grayInactive;
-	const bool sceneMode = renderContext.sceneMode;
-	// remove those volumes that are no longer part of the scene graph
-	for (int i = 0; i < voxel::MAX_VOLUMES; ++i) {
-		const int nodeId = getNodeId(i);
-		if (!sceneGraph.hasNode(nodeId)) {
-			_volumeRenderer.resetVolume(nodeId);
+	const voxel::MeshStatePtr &meshState = _volumeRenderer.meshState();
+	const int activeNode = sceneGraph.activeNode();
+	const int id = getVolumeId(node);
+	const voxel::RawVolume *v = meshState->volume(id);
+	_volumeRenderer.setVolume(id, node, true);
+	const voxel::Region &region = node.region();
+	if (v != node.volume()) {
+		_volumeRenderer.scheduleRegionExtraction(id, region);
+	}
+	if (renderContext.sceneMode) {
+		const scenegraph::FrameTransform &transform = sceneGraph.transformForFrame(node, renderContext.frame);
+		const int negative = (int)std::signbit(transform.scale.x) + (int)std::signbit(transform.scale.y) +
+							 (int)std::signbit(transform.scale.z);
+		if (negative == 1 || negative == 3) {
+			meshState->setCullFace(id, video::Face::Front);
+		} else {
+			meshState->setCullFace(id, video::Face::Back);
 		}
+		const glm::mat4 worldMatrix = transform.worldMatrix();
+		const glm::vec3 maxs = worldMatrix * glm::vec4(region.getUpperCorner(), 1.0f);
+		const glm::vec3 mins = worldMatrix * glm::vec4(region.getLowerCorner(), 1.0f);
+		const glm::vec3 pivot = transform.scale * node.pivot() * glm::vec3(region.getDimensionsInVoxels());
+		meshState->setModelMatrix(id, worldMatrix, pivot, mins, maxs);
+	} else {
+		meshState->setCullFace(id, video::Face::Back);
+		meshState->setModelMatrix(id, glm::mat4(1.0f), glm::vec3(0.0f), region.getLowerCorner(),
+								  region.getUpperCorner());
 	}
-	_cameras.clear();
+	if (renderContext.hideInactive) {
+		meshState->hide(id, id != activeNode);
+	} else {
+		meshState->hide(id, !node.visible());
+	}
+	if (renderContext.grayInactive) {
+		meshState->gray(id, id != activeNode);
+	} else {
+		meshState->gray(id, false);
+	}
+}
 
+void SceneGraphRenderer::prepareReferences(const RenderContext &renderContext) {
 	const voxel::MeshStatePtr &meshState = _volumeRenderer.meshState();
-
+	meshState->resetReferences();
+	if (!renderContext.sceneMode) {
+		return;
+	}
+	const scenegraph::SceneGraph &sceneGraph = *renderContext.sceneGraph;
 	const int activeNode = sceneGraph.activeNode();
-	for (auto entry : sceneGraph.nodes()) {
-		scenegraph::SceneGraphNode &node = entry->value;
-		if (renderContext.onlyModels && !node.isModelNode()) {
-			continue;
-		}
-
-		if (node.type() == scenegraph::SceneGraphNodeType::Camera) {
-			const scenegraph::SceneGraphNodeCamera &cameraNode = scenegraph::toCameraNode(node);
-			if (!cameraNode.visible()) {
-				continue;
-			}
-			const glm::ivec2 size(cameraNode.width(), cameraNode.height());
-			video::Camera camera = toCamera(size, cameraNode);
-			_cameras.push_back(camera);
-			continue;
-		} else if (node.type() != scenegraph::SceneGraphNodeType::Model) {
+	for (int nodeId : _referenceNodes) {
+		if (!sceneGraph.hasNode(nodeId)) {
 			continue;
 		}
-
+		const scenegraph::SceneGraphNode &node = sceneGraph.node(nodeId);
 		const int id = getVolumeId(node);
-		if (id >= voxel::MAX_VOLUMES) {
-			continue;
-		}
-		const voxel::RawVolume *v = meshState->volume(id);
-		_volumeRenderer.setVolume(id, node, true);
-		const voxel::Region &region = node.region();
-		if (v != node.volume()) {
-			_volumeRenderer.scheduleRegionExtraction(id, region);
-		}
-		if (sceneMode) {
-			const scenegraph::FrameTransform &transform = sceneGraph.transformForFrame(node, frame);
-			const int negative = (int)std::signbit(transform.scale.x) + (int)std::signbit(transform.scale.y) +
-								 (int)std::signbit(transform.scale.z);
-			if (negative == 1 || negative == 3) {
-				meshState->setCullFace(id, video::Face::Front);
-			} else {
-				meshState->setCullFace(id, video::Face::Back);
-			}
-			const glm::mat4 worldMatrix = transform.worldMatrix();
-			const glm::vec3 maxs = worldMatrix * glm::vec4(region.getUpperCorner(), 1.0f);
-			const glm::vec3 mins = worldMatrix * glm::vec4(region.getLowerCorner(), 1.0f);
-			const glm::vec3 pivot = transform.scale * node.pivot() * glm::vec3(region.getDimensionsInVoxels());
-			meshState->setModelMatrix(id, worldMatrix, pivot, mins, maxs);
-		} else {
-			meshState->setCullFace(id, video::Face::Back);
-			meshState->setModelMatrix(id, glm::mat4(1.0f), glm::vec3(0.0f), region.getLowerCorner(),
-												  region.getUpperCorner());
-		}
-		if (hideInactive) {
+		const int referencedId = getVolumeId(node.reference());
+		meshState->setReference(id, referencedId);
+		const scenegraph::FrameTransform &transform = sceneGraph.transformForFrame(node, renderContext.frame);
+		const voxel::Region region = sceneGraph.resolveRegion(node);
+		const glm::mat4 worldMatrix = transform.worldMatrix();
+		const glm::vec3 maxs = worldMatrix * glm::vec4(region.getUpperCorner(), 1.0f);
+		const glm::vec3 mins = worldMatrix * glm::vec4(region.getLowerCorner(), 1.0f);
+		const glm::vec3 pivot = transform.scale * node.pivot() * glm::vec3(region.getDimensionsInVoxels());
+		meshState->setModelMatrix(id, worldMatrix, pivot, mins, maxs);
+		if (renderContext.hideInactive) {
 			meshState->hide(id, id != activeNode);
 		} else {
 			meshState->hide(id, !node.visible());
 		}
-		if (grayInactive) {
+		if (renderContext.grayInactive) {
 			meshState->gray(id, id != activeNode);
 		} else {
 			meshState->gray(id, false);
 		}
 	}
+}
 
-	meshState->resetReferences();
-	if (sceneMode) {
-		for (auto entry : sceneGraph.nodes()) {
-			const scenegraph::SceneGraphNode &node = entry->second;
-			if (!node.isReference()) {
-				continue;
-			}
-			const int id = getVolumeId(node);
-			if (id >= voxel::MAX_VOLUMES) {
-				continue;
-			}
-			const int referencedId = getVolumeId(node.reference());
-			meshState->setReference(id, referencedId);
-			const scenegraph::FrameTransform &transform = sceneGraph.transformForFrame(node, frame);
-			const voxel::Region region = sceneGraph.resolveRegion(node);
-			const glm::mat4 worldMatrix = transform.worldMatrix();
-			const glm::vec3 maxs = worldMatrix * glm::vec4(region.getUpperCorner(), 1.0f);
-			const glm::vec3 mins = worldMatrix * glm::vec4(region.getLowerCorner(), 1.0f);
-			const glm::vec3 pivot =
-				transform.scale * node.pivot() * glm::vec3(region.getDimensionsInVoxels());
-			meshState->setModelMatrix(id, worldMatrix, pivot, mins, maxs);
-			if (hideInactive) {
-				meshState->hide(id, id != activeNode);
-			} else {
-				meshState->hide(id, !node.visible());
-			}
-			if (grayInactive) {
-				meshState->gray(id, id != activeNode);
-			} else {
-				meshState->gray(id, false);
+void SceneGraphRenderer::prepareCameras(const RenderContext &renderContext) {
+	_cameras.clear();
+	if (renderContext.onlyModels) {
+		return;
+	}
+	const scenegraph::SceneGraph &sceneGraph = *renderContext.sceneGraph;
+	for (auto iter = sceneGraph.begin(scenegraph::SceneGraphNodeType::Camera); iter != sceneGraph.end(); ++iter) {
+		const scenegraph::SceneGraphNodeCamera &cameraNode = scenegraph::toCameraNode(*iter);
+		if (!cameraNode.visible()) {
+			continue;
+		}
+		const glm::ivec2 size(cameraNode.width(), cameraNode.height());
+		_cameras.push_back(toCamera(size, cameraNode));
+	}
+}
+
+void SceneGraphRenderer::prepareAll(const RenderContext &renderContext) {
+	const scenegraph::SceneGraph &sceneGraph = *renderContext.sceneGraph;
+	const voxel::MeshStatePtr &meshState = _volumeRenderer.meshState();
+	// remove those volumes that are no longer part of the scene graph - only the slots in use are checked
+	for (int i = meshState->volumeSlots() - 1; i >= 0; --i) {
+		if (!meshState->hasVolumeData(i)) {
+			continue;
+		}
+		const int nodeId = getNodeId(i);
+		if (!sceneGraph.hasNode(nodeId)) {
+			_volumeRenderer.resetVolume(i);
+		}
+	}
+
+	_referenceNodes.clear();
+	for (auto entry : sceneGraph.nodes()) {
+		scenegraph::SceneGraphNode &node = entry->value;
+		if (node.type() == scenegraph::SceneGraphNodeType::Model) {
+			prepareModelNode(renderContext, node);
+		} else if (node.isReference()) {
+			_referenceNodes.push_back(node.id());
+		}
+	}
+	prepareReferences(renderContext);
+	prepareCameras(renderContext);
+}
+
+void SceneGraphRenderer::prepare(const RenderContext &renderContext) {
+	core_assert_always(renderContext.sceneGraph != nullptr);
+	const scenegraph::SceneGraph &sceneGraph = *renderContext.sceneGraph;
+	PrepareState state;
+	state.sceneGraph = &sceneGraph;
+	state.changeCounter = sceneGraph.changeCounter();
+	// the frame only matters for the transforms in scene mode
+	state.frame = renderContext.sceneMode ? renderContext.frame : 0;
+	state.activeNode = sceneGraph.activeNode();
+	state.hideInactive = renderContext.hideInactive;
+	state.grayInactive = renderContext.grayInactive;
+	state.sceneMode = renderContext.sceneMode;
+	state.onlyModels = renderContext.onlyModels;
+	if (!_preparedValid || !(state == _prepared)) {
+		prepareAll(renderContext);
+		_prepared = state;
+		_preparedValid = true;
+		_dirtyNodes.clear();
+		return;
+	}
+	if (_dirtyNodes.empty()) {
+		return;
+	}
+
+	// only the nodes that changed since the last pass are updated
+	const voxel::MeshStatePtr &meshState = _volumeRenderer.meshState();
+	bool camerasChanged = false;
+	for (auto entry : _dirtyNodes) {
+		const int nodeId = entry->first;
+		if (!sceneGraph.hasNode(nodeId)) {
+			const int id = getVolumeId(nodeId);
+			if (id >= 0 && meshState->hasVolumeData(id)) {
+				_volumeRenderer.resetVolume(id);
 			}
+			continue;
 		}
+		scenegraph::SceneGraphNode &node = sceneGraph.node(nodeId);
+		if (node.type() == scenegraph::SceneGraphNodeType::Model) {
+			prepareModelNode(renderContext, node);
+		} else if (node.type() == scenegraph::SceneGraphNodeType::Camera) {
+			camerasChanged = true;
+		}
+	}
+	_dirtyNodes.clear();
+	// a reference depends on the referenced node - the references are cheap to update, so they are always updated
+	prepareReferences(renderContext);
+	if (camerasChanged) {
+		prepareCameras(renderContext);
 	}
 }
 
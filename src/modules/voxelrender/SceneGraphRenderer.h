@@ -6,6 +6,7 @@
 
 #include "RawVolumeRenderer.h"
 #include "core/collection/DynamicArray.h"
+#include "core/collection/DynamicSet.h"
 #include "render/CameraFrustum.h"
 #include "scenegraph/SceneGraphNode.h"
 #include "video/Camera.h"
@@ -38,6 +39,36 @@ protected:
 	RawVolumeRenderer _volumeRenderer;
 	render::CameraFrustum _cameraRenderer;
 	core::DynamicArray<video::Camera> _cameras;
+
+	/**
+	 * @brief The render context values and the scene graph state of the last full prepare pass - if any of them
+	 * changes, all nodes are prepared again
+	 */
+	struct PrepareState {
+		const scenegraph::SceneGraph *sceneGraph = nullptr;
+		uint32_t changeCounter = 0u;
+		scenegraph::FrameIndex frame = 0;
+		int activeNode = InvalidNodeId;
+		bool hideInactive = false;
+		bool grayInactive = false;
+		bool sceneMode = false;
+		bool onlyModels = false;
+
+		bool operator==(const PrepareState &other) const;
+	};
+	PrepareState _prepared;
+	bool _preparedValid = false;
+	/**
+	 * @brief The nodes that changed since the last prepare pass - only these are updated if the @c PrepareState is
+	 * still the same
+	 */
+	core::DynamicSet<int> _dirtyNodes;
+	core::DynamicArray<int> _referenceNodes;
+
+	void prepareModelNode(const RenderContext &renderContext, scenegraph::SceneGraphNode &node);
+	void prepareReferences(const RenderContext &renderContext);
+	void prepareCameras(const RenderContext &renderContext);
+	void prepareAll(const RenderContext &renderContext);
 	void prepare(const RenderContext &renderContext);
 
 public:
@@ -52,6 +83,18 @@ public:
 	void setDiffuseColor(const glm::vec3 &color);
 
 	void nodeRemove(int nodeId);
+	/**
+	 * @brief Updates the render state of the given node with the next render call
+	 *
+	 * Changes of the hierarchy, the key frames and the transforms are detected with
+	 * @c scenegraph::SceneGraph::changeCounter() - this must be called for the node property changes that the scene
+	 * graph doesn't know about - e.g. the visibility.
+	 */
+	void nodeChanged(int nodeId);
+	/**
+	 * @brief Updates the render state of all nodes with the next render call
+	 */
+	void markDirty();
 	bool isVisible(int nodeId) const;
 
 	void scheduleRegionExtraction(scenegraph::SceneGraphNode &node, const voxel::Region &region);
@@ -21,6 +21,23 @@ inline video::Attribute getPositionVertexAttribute(uint32_t bufferIndex, uint32_
 	return attrib;
 }
 
+/**
+ * @brief The shorts of the @c voxel::PackedVoxelVertex are converted to float - the shader input stays the same
+ */
+inline video::Attribute getPackedPositionVertexAttribute(uint32_t bufferIndex, uint32_t attributeLocation,
+														 int components) {
+	static_assert(offsetof(voxel::PackedVoxelVertex, y) == offsetof(voxel::PackedVoxelVertex, x) + sizeof(int16_t),
+				  "Layout change of PackedVoxelVertex without change in upload");
+	video::Attribute attrib;
+	attrib.bufferIndex = (int32_t)bufferIndex;
+	attrib.location = (int32_t)attributeLocation;
+	attrib.stride = sizeof(voxel::PackedVoxelVertex);
+	attrib.size = components;
+	attrib.type = video::mapType<decltype(voxel::PackedVoxelVertex::x)>();
+	attrib.offset = offsetof(voxel::PackedVoxelVertex, x);
+	return attrib;
+}
+
 inline video::Attribute getNormalVertexAttribute(uint32_t bufferIndex, uint32_t attributeLocation, int components) {
 	video::Attribute attrib;
 	attrib.bufferIndex = (int32_t)bufferIndex;
@@ -50,4 +67,22 @@ inline video::Attribute getInfoVertexAttribute(uint32_t bufferIndex, uint32_t at
 	return attrib;
 }
 
+/**
+ * @note we are uploading multiple bytes at once here
+ */
+inline video::Attribute getPackedInfoVertexAttribute(uint32_t bufferIndex, uint32_t attributeLocation,
+													 int components) {
+	static_assert(offsetof(voxel::PackedVoxelVertex, info) < offsetof(voxel::PackedVoxelVertex, colorIndex),
+				  "Layout change of PackedVoxelVertex without change in upload");
+	video::Attribute attrib;
+	attrib.bufferIndex = (int32_t)bufferIndex;
+	attrib.location = (int32_t)attributeLocation;
+	attrib.stride = sizeof(voxel::PackedVoxelVertex);
+	attrib.size = components;
+	attrib.type = video::mapType<decltype(voxel::PackedVoxelVertex::info)>();
+	attrib.typeIsInt = true;
+	attrib.offset = offsetof(voxel::PackedVoxelVertex, info);
+	return attrib;
+}
+
 }
@@ -0,0 +1,9 @@
+#define MAXINSTANCES 64
+$constant MaxInstances MAXINSTANCES
+
+// the per instance data of an instanced draw call - indexed by gl_InstanceID
+layout(std140) uniform u_instances {
+	mat4 u_model[MAXINSTANCES];
+	// the xyz components are the pivot - the w component is 1.0 for grayed instances
+	vec4 u_pivot[MAXINSTANCES];
+};
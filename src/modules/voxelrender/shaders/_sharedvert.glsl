@@ -4,11 +4,10 @@ layout(std140) uniform u_vert {
 	vec4 u_materialcolor[MATERIALCOLORS];
 	vec4 u_glowcolor[MATERIALCOLORS];
 	mat4 u_viewprojection;
-	mat4 u_model;
-	vec3 u_pivot;
-	int u_gray;
 };
 
+#include "_instances.glsl"
+
 $out vec4 v_pos;
 $out vec3 v_normal;
 $out vec4 v_color;
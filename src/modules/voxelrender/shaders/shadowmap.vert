@@ -6,12 +6,11 @@ $in vec3 a_pos;
 
 layout(std140) uniform u_block {
 	mat4 u_lightviewprojection;
-	mat4 u_model;
-	vec3 u_pivot;
-	int u_padding;
 };
 
+#include "_instances.glsl"
+
 void main() {
-	vec4 worldpos = u_model * vec4(a_pos - u_pivot, 1.0f);
+	vec4 worldpos = u_model[gl_InstanceID] * vec4(a_pos - u_pivot[gl_InstanceID].xyz, 1.0f);
 	gl_Position = u_lightviewprojection * worldpos;
 }
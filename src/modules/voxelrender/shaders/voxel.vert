@@ -10,7 +10,7 @@ void main(void) {
 	uint a_ao = (a_info[0] & 3u);
 	uint a_flags = ((a_info[0] & ~3u) >> 2u);
 	uint a_colorindex = a_info[1];
-	v_pos = u_model * vec4(a_pos - u_pivot, 1.0);
+	v_pos = u_model[gl_InstanceID] * vec4(a_pos - u_pivot[gl_InstanceID].xyz, 1.0);
 
 	int materialColorIndex = int(a_colorindex);
 	vec4 materialColor = u_materialcolor[materialColorIndex];
@@ -23,7 +23,7 @@ void main(void) {
 	if ((a_flags & FLAGBLOOM) != 0u)
 		v_flags |= FLAGBLOOM;
 
-	if (u_gray != 0) {
+	if (u_pivot[gl_InstanceID].w != 0.0) {
 		float gray = (0.21 * materialColor.r + 0.72 * materialColor.g + 0.07 * materialColor.b) / 3.0;
 		v_color = vec4(gray, gray, gray, materialColor.a);
 	} else {
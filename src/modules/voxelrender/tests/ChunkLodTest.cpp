@@ -0,0 +1,97 @@
+/**
+ * @file
+ */
+
+#include "voxelrender/ChunkLod.h"
+#include "app/tests/AbstractTest.h"
+
+namespace voxelrender {
+
+class ChunkLodTest : public app::AbstractTest {
+protected:
+	/**
+	 * @brief Lays out the chunks like the renderer does - all chunks of a level follow each other
+	 */
+	static ChunkLods layout(int chunks, uint32_t indicesPerChunk) {
+		ChunkLods lods;
+		lods.resize(chunks);
+		uint32_t offset = 0u;
+		for (int lod = 0; lod < voxel::MeshState::MaxLods; ++lod) {
+			for (int i = 0; i < chunks; ++i) {
+				lods[i].offset[lod] = offset;
+				lods[i].count[lod] = indicesPerChunk;
+				offset += indicesPerChunk;
+			}
+		}
+		return lods;
+	}
+};
+
+TEST_F(ChunkLodTest, testSelectLod) {
+	EXPECT_EQ(0, selectLod(0.0f, 100.0f));
+	EXPECT_EQ(0, selectLod(99.0f, 100.0f));
+	EXPECT_EQ(1, selectLod(100.0f, 100.0f));
+	EXPECT_EQ(1, selectLod(199.0f, 100.0f));
+	EXPECT_EQ(2, selectLod(200.0f, 100.0f));
+	EXPECT_EQ(3, selectLod(400.0f, 100.0f));
+	EXPECT_EQ(3, selectLod(100000.0f, 100.0f));
+	EXPECT_EQ(1, selectLod(100000.0f, 100.0f, 2));
+}
+
+TEST_F(ChunkLodTest, testSelectLodDisabled) {
+	EXPECT_EQ(0, selectLod(100000.0f, 0.0f));
+}
+
+TEST_F(ChunkLodTest, testSameLodIsOneRange) {
+	const ChunkLods chunks = layout(4, 6u);
+	const uint8_t lods[] = {2, 2, 2, 2};
+	IndexRanges ranges;
+	buildIndexRanges(chunks, lods, ranges);
+	ASSERT_EQ(1u, ranges.size());
+	EXPECT_EQ(48u, ranges[0].offset);
+	EXPECT_EQ(24u, ranges[0].count);
+}
+
+TEST_F(ChunkLodTest, testMixedLods) {
+	const ChunkLods chunks = layout(4, 6u);
+	const uint8_t lods[] = {0, 0, 1, 1};
+	IndexRanges ranges;
+	buildIndexRanges(chunks, lods, ranges);
+	ASSERT_EQ(2u, ranges.size());
+	EXPECT_EQ(0u, ranges[0].offset);
+	EXPECT_EQ(12u, ranges[0].count);
+	EXPECT_EQ(36u, ranges[1].offset);
+	EXPECT_EQ(12u, ranges[1].count);
+}
+
+TEST_F(ChunkLodTest, testEmptyChunksAreSkipped) {
+	ChunkLods chunks = layout(3, 6u);
+	chunks[1].count[0] = 0u;
+	const uint8_t lods[] = {0, 0, 0};
+	IndexRanges ranges;
+	buildIndexRanges(chunks, lods, ranges);
+	ASSERT_EQ(2u, ranges.size());
+	EXPECT_EQ(0u, ranges[0].offset);
+	EXPECT_EQ(6u, ranges[0].count);
+	EXPECT_EQ(12u, ranges[1].offset);
+	EXPECT_EQ(6u, ranges[1].count);
+}
+
+TEST_F(ChunkLodTest, testBaseVertexSplitsRanges) {
+	ChunkLods chunks = layout(3, 6u);
+	chunks[0].baseVertex[0] = 0;
+	chunks[1].baseVertex[0] = 0;
+	chunks[2].baseVertex[0] = 40000;
+	const uint8_t lods[] = {0, 0, 0};
+	IndexRanges ranges;
+	buildIndexRanges(chunks, lods, ranges);
+	ASSERT_EQ(2u, ranges.size());
+	EXPECT_EQ(0u, ranges[0].offset);
+	EXPECT_EQ(12u, ranges[0].count);
+	EXPECT_EQ(0, ranges[0].baseVertex);
+	EXPECT_EQ(12u, ranges[1].offset);
+	EXPECT_EQ(6u, ranges[1].count);
+	EXPECT_EQ(40000, ranges[1].baseVertex);
+}
+
+} // namespace voxelrender
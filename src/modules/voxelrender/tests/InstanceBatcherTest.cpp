@@ -0,0 +1,129 @@
+/**
+ * @file
+ */
+
+#include "voxelrender/InstanceBatcher.h"
+#include "app/tests/AbstractTest.h"
+#include <glm/ext/matrix_transform.hpp>
+
+namespace voxelrender {
+
+class InstanceBatcherTest : public app::AbstractTest {
+protected:
+	static glm::mat4 translate(float x) {
+		return glm::translate(glm::mat4(1.0f), glm::vec3(x, 0.0f, 0.0f));
+	}
+};
+
+TEST_F(InstanceBatcherTest, testEmpty) {
+	InstanceBatcher batcher;
+	batcher.build(64);
+	EXPECT_EQ(0, batcher.size());
+	EXPECT_TRUE(batcher.batches().empty());
+}
+
+TEST_F(InstanceBatcherTest, testGroupByBuffer) {
+	InstanceBatcher batcher;
+	// a model node in slot 0 and 1 - slots 2 to 4 are references to slot 0
+	batcher.add(0, video::Face::Back, translate(0.0f), glm::vec3(0.0f), false);
+	batcher.add(1, video::Face::Back, translate(1.0f), glm::vec3(0.0f), false);
+	batcher.add(0, video::Face::Back, translate(2.0f), glm::vec3(0.0f), false);
+	batcher.add(0, video::Face::Back, translate(3.0f), glm::vec3(0.0f), true);
+	batcher.add(0, video::Face::Back, translate(4.0f), glm::vec3(0.0f), false);
+	batcher.build(64);
+	EXPECT_EQ(5, batcher.size());
+
+	const InstanceBatcher::Batches &batches = batcher.batches();
+	ASSERT_EQ(2u, batches.size());
+	EXPECT_EQ(0, batches[0].bufferIndex);
+	EXPECT_EQ(4, batches[0].amount);
+	EXPECT_EQ(1, batches[1].bufferIndex);
+	EXPECT_EQ(1, batches[1].amount);
+
+	// the instances of a batch keep the order they were added in
+	const InstanceBatcher::Instance *instances = batcher.instances(batches[0]);
+	EXPECT_FLOAT_EQ(0.0f, instances[0].model[3].x);
+	EXPECT_FLOAT_EQ(2.0f, instances[1].model[3].x);
+	EXPECT_FLOAT_EQ(3.0f, instances[2].model[3].x);
+	EXPECT_FLOAT_EQ(4.0f, instances[3].model[3].x);
+	EXPECT_FLOAT_EQ(1.0f, batcher.instances(batches[1])[0].model[3].x);
+}
+
+TEST_F(InstanceBatcherTest, testInstanceData) {
+	InstanceBatcher batcher;
+	batcher.add(3, video::Face::Back, translate(5.0f), glm::vec3(1.0f, 2.0f, 3.0f), true);
+	batcher.add(3, video::Face::Back, translate(6.0f), glm::vec3(4.0f, 5.0f, 6.0f), false);
+	batcher.build(64);
+	ASSERT_EQ(1u, batcher.batches().size());
+	const InstanceBatcher::Instance *instances = batcher.instances(batcher.batches()[0]);
+	EXPECT_EQ(glm::vec4(1.0f, 2.0f, 3.0f, 1.0f), instances[0].pivot);
+	EXPECT_EQ(glm::vec4(4.0f, 5.0f, 6.0f, 0.0f), instances[1].pivot);
+	EXPECT_EQ(translate(5.0f), instances[0].model);
+	EXPECT_EQ(translate(6.0f), instances[1].model);
+}
+
+TEST_F(InstanceBatcherTest, testSplitByCullFace) {
+	InstanceBatcher batcher;
+	batcher.add(0, video::Face::Back, translate(0.0f), glm::vec3(0.0f), false);
+	batcher.add(0, video::Face::Front, translate(1.0f), glm::vec3(0.0f), false);
+	batcher.add(0, video::Face::Back, translate(2.0f), glm::vec3(0.0f), false);
+	batcher.build(64);
+	const InstanceBatcher::Batches &batches = batcher.batches();
+	ASSERT_EQ(2u, batches.size());
+	EXPECT_EQ(video::Face::Front, batches[0].cullFace);
+	EXPECT_EQ(1, batches[0].amount);
+	EXPECT_EQ(video::Face::Back, batches[1].cullFace);
+	EXPECT_EQ(2, batches[1].amount);
+}
+
+TEST_F(InstanceBatcherTest, testMaxInstances) {
+	InstanceBatcher batcher;
+	for (int i = 0; i < 10; ++i) {
+		batcher.add(0, video::Face::Back, translate((float)i), glm::vec3(0.0f), false);
+	}
+	batcher.build(4);
+	const InstanceBatcher::Batches &batches = batcher.batches();
+	ASSERT_EQ(3u, batches.size());
+	EXPECT_EQ(4, batches[0].amount);
+	EXPECT_EQ(4, batches[1].amount);
+	EXPECT_EQ(2, batches[2].amount);
+	EXPECT_EQ(0, batches[0].offset);
+	EXPECT_EQ(4, batches[1].offset);
+	EXPECT_EQ(8, batches[2].offset);
+	EXPECT_FLOAT_EQ(9.0f, batcher.instances(batches[2])[1].model[3].x);
+}
+
+TEST_F(InstanceBatcherTest, testKeepOrder) {
+	InstanceBatcher batcher;
+	// back to front sorted transparent meshes - only neighbours may be merged
+	batcher.add(0, video::Face::Back, translate(0.0f), glm::vec3(0.0f), false);
+	batcher.add(0, video::Face::Back, translate(1.0f), glm::vec3(0.0f), false);
+	batcher.add(1, video::Face::Back, translate(2.0f), glm::vec3(0.0f), false);
+	batcher.add(0, video::Face::Back, translate(3.0f), glm::vec3(0.0f), false);
+	batcher.build(64, true);
+	const InstanceBatcher::Batches &batches = batcher.batches();
+	ASSERT_EQ(3u, batches.size());
+	EXPECT_EQ(0, batches[0].bufferIndex);
+	EXPECT_EQ(2, batches[0].amount);
+	EXPECT_EQ(1, batches[1].bufferIndex);
+	EXPECT_EQ(1, batches[1].amount);
+	EXPECT_EQ(0, batches[2].bufferIndex);
+	EXPECT_EQ(1, batches[2].amount);
+	EXPECT_FLOAT_EQ(3.0f, batcher.instances(batches[2])[0].model[3].x);
+}
+
+TEST_F(InstanceBatcherTest, testClear) {
+	InstanceBatcher batcher;
+	batcher.add(0, video::Face::Back, translate(0.0f), glm::vec3(0.0f), false);
+	batcher.build(64);
+	ASSERT_EQ(1u, batcher.batches().size());
+	batcher.clear();
+	EXPECT_EQ(0, batcher.size());
+	EXPECT_TRUE(batcher.batches().empty());
+	batcher.add(2, video::Face::Back, translate(0.0f), glm::vec3(0.0f), false);
+	batcher.build(64);
+	ASSERT_EQ(1u, batcher.batches().size());
+	EXPECT_EQ(2, batcher.batches()[0].bufferIndex);
+}
+
+} // namespace voxelrender
@@ -18,6 +18,8 @@
 #include "voxelformat/VolumeFormat.h"
 #include "palette/PaletteLookup.h"
 #include "voxel/RawVolumeWrapper.h"
+#include "app/Async.h"
+#include "core/collection/DynamicArray.h"
 
 namespace voxelutil {
 
@@ -49,100 +51,202 @@ int importHeightMaxHeight(const image::ImagePtr &image, bool alpha) {
 	return maxHeight;
 }
 
-void importColoredHeightmap(voxel::RawVolumeWrapper& volume, palette::PaletteLookup &palLookup, const image::ImagePtr& image, const voxel::Voxel &underground) {
-	const int imageWidth = image->width();
-	const int imageHeight = image->height();
-	const voxel::Region& region = volume.region();
-	const int volumeHeight = region.getHeightInVoxels();
+/**
+ * @brief The image pixel that belongs to the given column of the volume
+ */
+static inline core::RGBA heightmapPixel(const image::ImagePtr &image, int x, int z, const glm::vec2 &step) {
+	return image->colorAt((int)((float)x * step.x), (int)((float)z * step.y));
+}
+
+/**
+ * @brief Fills a column of a heightmap - only the surface voxel is placed if the underground is air
+ * @param setVoxel Called with the y coordinate relative to the lower corner of the volume region
+ */
+template<class SetVoxel>
+static inline void heightmapColumn(int height, int volumeHeight, const voxel::Voxel &underground,
+								   const voxel::Voxel &surface, SetVoxel &&setVoxel) {
+	if (voxel::isAir(underground.getMaterial())) {
+		if (height >= 1 && height <= volumeHeight) {
+			setVoxel(height - 1, surface);
+		}
+		return;
+	}
+	const int maxY = core_min(height, volumeHeight);
+	for (int y = 0; y < maxY; ++y) {
+		setVoxel(y, y < height - 1 ? underground : surface);
+	}
+}
+
+/**
+ * @brief Imports a heightmap into the columns of the given region
+ *
+ * The rows are processed in bands - the columns of a band are computed in parallel (including the palette lookups)
+ * and then handed to @c writeColumn on the calling thread. This keeps the write order intact for volume wrappers
+ * that are not thread safe.
+ *
+ * @param column Computes the height and the surface voxel for a column - called as
+ * @c column(palLookup,x,z,surface) with a palette lookup that is only used by the calling thread
+ */
+template<class Column, class WriteColumn>
+static void importHeightmapColumns(const voxel::Region &region, const palette::Palette &palette, Column &&column,
+								   WriteColumn &&writeColumn) {
 	const int volumeWidth = region.getWidthInVoxels();
 	const int volumeDepth = region.getDepthInVoxels();
-	const glm::ivec3& mins = region.getLowerCorner();
-	const float stepWidthY = (float)imageHeight / (float)volumeDepth;
-	const float stepWidthX = (float)imageWidth / (float)volumeWidth;
-	const float scaleHeight = (float)volumeHeight / (float)255.0f;
-	float imageY = 0.0f;
-	for (int z = 0; z < volumeDepth; ++z, imageY += stepWidthY) {
-		float imageX = 0.0f;
-		for (int x = 0; x < volumeWidth; ++x, imageX += stepWidthX) {
-			const core::RGBA heightmapPixel = image->colorAt((int)imageX, (int)imageY);
-			const uint8_t heightValue = (uint8_t)(glm::round((float)(heightmapPixel.a) * scaleHeight));
-
-			if (voxel::isAir(underground.getMaterial())) {
-				const glm::ivec3 pos(x, heightValue - 1, z);
-				const glm::ivec3 regionPos = mins + pos;
-				if (!region.containsPoint(regionPos)) {
-					continue;
-				}
-				const uint8_t palidx = palLookup.findClosestIndex(core::RGBA(heightmapPixel.r, heightmapPixel.g, heightmapPixel.b));
-				const voxel::Voxel voxel = voxel::createVoxel(palLookup.palette(), palidx);
-				volume.setVoxel(regionPos, voxel);
-			} else {
-				for (int y = 0; y < heightValue; ++y) {
-					const glm::ivec3 pos(x, y, z);
-					const glm::ivec3 regionPos = mins + pos;
-					if (!region.containsPoint(regionPos)) {
-						continue;
-					}
-					voxel::Voxel voxel;
-					if (y < heightValue - 1) {
-						voxel = underground;
-					} else {
-						const uint8_t palidx = palLookup.findClosestIndex(core::RGBA(heightmapPixel.r, heightmapPixel.g, heightmapPixel.b));
-						voxel = voxel::createVoxel(palLookup.palette(), palidx);
-					}
-					volume.setVoxel(regionPos, voxel);
+	const int bandRows = core_max(1, (1 << 20) / volumeWidth);
+	core::DynamicArray<int> heights;
+	core::DynamicArray<voxel::Voxel> surfaces;
+	heights.resize((size_t)volumeWidth * core_min(bandRows, volumeDepth));
+	surfaces.resize(heights.size());
+	for (int band = 0; band < volumeDepth; band += bandRows) {
+		const int bandEnd = core_min(band + bandRows, volumeDepth);
+		app::for_parallel(band, bandEnd, [&](int start, int end) {
+			palette::PaletteLookup palLookup(palette);
+			for (int z = start; z < end; ++z) {
+				const size_t row = (size_t)(z - band) * volumeWidth;
+				for (int x = 0; x < volumeWidth; ++x) {
+					heights[row + x] = column(palLookup, x, z, surfaces[row + x]);
 				}
 			}
+		});
+		for (int z = band; z < bandEnd; ++z) {
+			const size_t row = (size_t)(z - band) * volumeWidth;
+			for (int x = 0; x < volumeWidth; ++x) {
+				writeColumn(x, z, heights[row + x], surfaces[row + x]);
+			}
 		}
 	}
 }
 
+/**
+ * @brief Imports a heightmap into the columns of the given volume - the rows are split into slabs along the z axis
+ * that are computed and written in parallel
+ */
+template<class Column>
+static void importHeightmapColumns(voxel::RawVolume &volume, const palette::Palette &palette,
+								   const voxel::Voxel &underground, Column &&column) {
+	const voxel::Region &region = volume.region();
+	const int volumeWidth = region.getWidthInVoxels();
+	const int volumeHeight = region.getHeightInVoxels();
+	const glm::ivec3 &mins = region.getLowerCorner();
+	volume.detach();
+	app::for_parallel(0, region.getDepthInVoxels(), [&](int start, int end) {
+		palette::PaletteLookup palLookup(palette);
+		voxel::RawVolume::Sampler sampler(volume);
+		for (int z = start; z < end; ++z) {
+			for (int x = 0; x < volumeWidth; ++x) {
+				voxel::Voxel surface;
+				const int height = column(palLookup, x, z, surface);
+				sampler.setPosition(mins.x + x, mins.y, mins.z + z);
+				int samplerY = 0;
+				heightmapColumn(height, volumeHeight, underground, surface, [&](int y, const voxel::Voxel &voxel) {
+					sampler.movePositiveY(y - samplerY);
+					samplerY = y;
+					sampler.setVoxel(voxel);
+				});
+			}
+		}
+	});
+}
+
+void importColoredHeightmap(voxel::RawVolumeWrapper& volume, palette::PaletteLookup &palLookup, const image::ImagePtr& image, const voxel::Voxel &underground) {
+	const voxel::Region& region = volume.region();
+	const int volumeHeight = region.getHeightInVoxels();
+	const glm::ivec3& mins = region.getLowerCorner();
+	const glm::vec2 step((float)image->width() / (float)region.getWidthInVoxels(),
+						 (float)image->height() / (float)region.getDepthInVoxels());
+	const float scaleHeight = (float)volumeHeight / (float)255.0f;
+	const palette::Palette &palette = palLookup.palette();
+	importHeightmapColumns(
+		region, palette,
+		[&](palette::PaletteLookup &lookup, int x, int z, voxel::Voxel &surface) {
+			const core::RGBA pixel = heightmapPixel(image, x, z, step);
+			const uint8_t palidx = lookup.findClosestIndex(core::RGBA(pixel.r, pixel.g, pixel.b));
+			surface = voxel::createVoxel(palette, palidx);
+			return (int)(uint8_t)(glm::round((float)(pixel.a) * scaleHeight));
+		},
+		[&](int x, int z, int height, const voxel::Voxel &surface) {
+			heightmapColumn(height, volumeHeight, underground, surface, [&](int y, const voxel::Voxel &voxel) {
+				volume.setVoxel(mins.x + x, mins.y + y, mins.z + z, voxel);
+			});
+		});
+}
+
+void importColoredHeightmap(voxel::RawVolume &volume, const palette::Palette &palette, const image::ImagePtr &image,
+							const voxel::Voxel &underground) {
+	const voxel::Region &region = volume.region();
+	const glm::vec2 step((float)image->width() / (float)region.getWidthInVoxels(),
+						 (float)image->height() / (float)region.getDepthInVoxels());
+	const float scaleHeight = (float)region.getHeightInVoxels() / (float)255.0f;
+	importHeightmapColumns(volume, palette, underground,
+						   [&](palette::PaletteLookup &lookup, int x, int z, voxel::Voxel &surface) {
+							   const core::RGBA pixel = heightmapPixel(image, x, z, step);
+							   const uint8_t palidx = lookup.findClosestIndex(core::RGBA(pixel.r, pixel.g, pixel.b));
+							   surface = voxel::createVoxel(palette, palidx);
+							   return (int)(uint8_t)(glm::round((float)(pixel.a) * scaleHeight));
+						   });
+}
+
 void importHeightmap(voxel::RawVolumeWrapper& volume, const image::ImagePtr& image, const voxel::Voxel &underground, const voxel::Voxel &surface) {
-	const int imageWidth = image->width();
-	const int imageHeight = image->height();
 	const voxel::Region& region = volume.region();
 	const int volumeHeight = region.getHeightInVoxels();
-	const int volumeWidth = region.getWidthInVoxels();
-	const int volumeDepth = region.getDepthInVoxels();
 	const glm::ivec3& mins = region.getLowerCorner();
-	const float stepWidthY = (float)imageHeight / (float)volumeDepth;
-	const float stepWidthX = (float)imageWidth / (float)volumeWidth;
-	Log::debug("stepwidth: %f %f", stepWidthX, stepWidthY);
+	const glm::vec2 step((float)image->width() / (float)region.getWidthInVoxels(),
+						 (float)image->height() / (float)region.getDepthInVoxels());
+	Log::debug("stepwidth: %f %f", step.x, step.y);
 	const int maxImageHeight = importHeightMaxHeight(image, true);
 	const float scaleHeight = (float)volumeHeight / (float)maxImageHeight;
-	float imageY = 0.0f;
-	// TODO: use a volume sampler
-	for (int z = 0; z < volumeDepth; ++z, imageY += stepWidthY) {
-		float imageX = 0.0f;
-		for (int x = 0; x < volumeWidth; ++x, imageX += stepWidthX) {
-			const core::RGBA heightmapPixel = image->colorAt((int)imageX, (int)imageY);
-			const uint8_t heightValue = (uint8_t)(glm::round((float)(heightmapPixel.r) * scaleHeight));
+	importHeightmapColumns(
+		region, voxel::getPalette(),
+		[&](palette::PaletteLookup &, int x, int z, voxel::Voxel &columnSurface) {
+			const core::RGBA pixel = heightmapPixel(image, x, z, step);
+			columnSurface = surface;
+			return (int)(uint8_t)(glm::round((float)(pixel.r) * scaleHeight));
+		},
+		[&](int x, int z, int height, const voxel::Voxel &columnSurface) {
+			heightmapColumn(height, volumeHeight, underground, columnSurface, [&](int y, const voxel::Voxel &voxel) {
+				volume.setVoxel(mins.x + x, mins.y + y, mins.z + z, voxel);
+			});
+		});
+}
+
+void importHeightmap(voxel::RawVolume &volume, const image::ImagePtr &image, const voxel::Voxel &underground,
+					 const voxel::Voxel &surface) {
+	const voxel::Region &region = volume.region();
+	const glm::vec2 step((float)image->width() / (float)region.getWidthInVoxels(),
+						 (float)image->height() / (float)region.getDepthInVoxels());
+	const int maxImageHeight = importHeightMaxHeight(image, true);
+	const float scaleHeight = (float)region.getHeightInVoxels() / (float)maxImageHeight;
+	importHeightmapColumns(volume, voxel::getPalette(), underground,
+						   [&](palette::PaletteLookup &, int x, int z, voxel::Voxel &columnSurface) {
+							   const core::RGBA pixel = heightmapPixel(image, x, z, step);
+							   columnSurface = surface;
+							   return (int)(uint8_t)(glm::round((float)(pixel.r) * scaleHeight));
+						   });
+}
 
-			if (voxel::isAir(underground.getMaterial())) {
-				const glm::ivec3 pos(x, heightValue - 1, z);
-				const glm::ivec3 regionPos = mins + pos;
-				if (!region.containsPoint(regionPos)) {
+/**
+ * @brief Maps the colors of all image pixels to palette indices in one pass - the rows are mapped in parallel and
+ * every worker uses its own lookup cache
+ * @return One palette index per pixel in row-major order - the value for fully transparent pixels is undefined
+ */
+static core::DynamicArray<uint8_t> paletteIndices(const image::Image *image, const palette::Palette &palette) {
+	const int imageWidth = image->width();
+	core::DynamicArray<uint8_t> indices;
+	indices.resize((size_t)imageWidth * image->height());
+	app::for_parallel(0, image->height(), [&](int start, int end) {
+		palette::PaletteLookup palLookup(palette);
+		for (int y = start; y < end; ++y) {
+			uint8_t *row = indices.data() + (size_t)y * imageWidth;
+			for (int x = 0; x < imageWidth; ++x) {
+				const core::RGBA data = image->colorAt(x, y);
+				if (data.a == 0) {
 					continue;
 				}
-				volume.setVoxel(regionPos, surface);
-			} else {
-				for (int y = 0; y < heightValue; ++y) {
-					const glm::ivec3 pos(x, y, z);
-					const glm::ivec3 regionPos = mins + pos;
-					if (!region.containsPoint(regionPos)) {
-						continue;
-					}
-					voxel::Voxel voxel;
-					if (y < heightValue - 1) {
-						voxel = underground;
-					} else {
-						voxel = surface;
-					}
-					volume.setVoxel(regionPos, voxel);
-				}
+				row[x] = palLookup.findClosestIndex(data);
 			}
 		}
-	}
+	});
+	return indices;
 }
 
 voxel::RawVolume* importAsPlane(const image::ImagePtr& image, uint8_t thickness) {
@@ -180,20 +284,25 @@ voxel::RawVolume* importAsPlane(const image::Image *image, const palette::Palett
 	}
 	Log::info("Import image as plane: w(%i), h(%i), d(%i)", imageWidth, imageHeight, thickness);
 	const voxel::Region region(0, 0, 0, imageWidth - 1, imageHeight - 1, thickness - 1);
+	const core::DynamicArray<uint8_t> &indices = paletteIndices(image, palette);
 	voxel::RawVolume* volume = new voxel::RawVolume(region);
-	for (int x = 0; x < imageWidth; ++x) {
-		for (int y = 0; y < imageHeight; ++y) {
-			const core::RGBA data = image->colorAt(x, y);
-			if (data.a == 0) {
-				continue;
-			}
-			const uint8_t index = palette.getClosestMatch(data);
-			const voxel::Voxel voxel = voxel::createVoxel(palette, index);
-			for (int z = 0; z < thickness; ++z) {
-				volume->setVoxel(x, (imageHeight - 1) - y, z, voxel);
+	// every image row is a slab of the volume
+	app::for_parallel(0, imageHeight, [&](int start, int end) {
+		voxel::RawVolume::Sampler sampler(volume);
+		for (int y = start; y < end; ++y) {
+			for (int x = 0; x < imageWidth; ++x) {
+				if (image->colorAt(x, y).a == 0) {
+					continue;
+				}
+				const voxel::Voxel voxel = voxel::createVoxel(palette, indices[(size_t)y * imageWidth + x]);
+				sampler.setPosition(x, (imageHeight - 1) - y, 0);
+				for (int z = 0; z < thickness; ++z) {
+					sampler.setVoxel(voxel);
+					sampler.movePositiveZ();
+				}
 			}
 		}
-	}
+	});
 	return volume;
 }
 
@@ -240,37 +349,45 @@ voxel::RawVolume* importAsVolume(const image::ImagePtr& image, const image::Imag
 	}
 	Log::info("Import image as volume: w(%i), h(%i), d(%i)", imageWidth, imageHeight, volumeDepth);
 	const voxel::Region region(0, 0, 0, imageWidth - 1, imageHeight - 1, volumeDepth - 1);
-	palette::PaletteLookup palLookup(palette);
+	// an empty palette is replaced by the lookup
+	const palette::PaletteLookup palLookup(palette);
+	const core::DynamicArray<uint8_t> &indices = paletteIndices(image.get(), palLookup.palette());
 	voxel::RawVolume* volume = new voxel::RawVolume(region);
-	voxel::RawVolumeWrapper wrapper(volume);
-	for (int x = 0; x < imageWidth; ++x) {
-		for (int y = 0; y < imageHeight; ++y) {
-			const core::RGBA data = image->colorAt(x, y);
-			if (data.a == 0) {
-				continue;
-			}
-			const glm::vec4& color = core::Color::fromRGBA(data);
-			const uint8_t index = palLookup.findClosestIndex(color);
-			const voxel::Voxel voxel = voxel::createVoxel(palLookup.palette(), index);
-			const core::RGBA heightdata = heightmap->colorAt(x, y);
-			const float thickness = (float)heightdata.r;
-			const float maxthickness = maxDepth;
-			const float height = thickness * maxthickness / 255.0f;
-			if (bothSides) {
-				const int heighti = (int)glm::ceil(height/ 2.0f);
-				const int minZ = maxDepth - heighti;
-				const int maxZ = maxDepth + heighti;
-				for (int z = minZ; z <= maxZ; ++z) {
-					wrapper.setVoxel(x, region.getUpperY() - y, z, voxel);
+	// every image row is a slab of the volume
+	app::for_parallel(0, imageHeight, [&](int start, int end) {
+		voxel::RawVolume::Sampler sampler(volume);
+		for (int y = start; y < end; ++y) {
+			for (int x = 0; x < imageWidth; ++x) {
+				if (image->colorAt(x, y).a == 0) {
+					continue;
+				}
+				const voxel::Voxel voxel = voxel::createVoxel(palLookup.palette(), indices[(size_t)y * imageWidth + x]);
+				const core::RGBA heightdata = heightmap->colorAt(x, y);
+				const float thickness = (float)heightdata.r;
+				const float maxthickness = maxDepth;
+				const float height = thickness * maxthickness / 255.0f;
+				int minZ;
+				int maxZ;
+				if (bothSides) {
+					const int heighti = (int)glm::ceil(height / 2.0f);
+					minZ = maxDepth - heighti;
+					maxZ = maxDepth + heighti;
+				} else {
+					const int heighti = (int)glm::ceil(height);
+					minZ = region.getLowerZ();
+					maxZ = region.getLowerZ() + heighti - 1;
 				}
-			} else {
-				const int heighti = (int)glm::ceil(height);
-				for (int z = region.getLowerZ(); z < region.getLowerZ() + heighti; ++z) {
-					wrapper.setVoxel(x, region.getUpperY() - y, z, voxel);
+				// the wrapper skipped the positions outside of the region
+				minZ = core_max(minZ, region.getLowerZ());
+				maxZ = core_min(maxZ, region.getUpperZ());
+				sampler.setPosition(x, region.getUpperY() - y, minZ);
+				for (int z = minZ; z <= maxZ; ++z) {
+					sampler.setVoxel(voxel);
+					sampler.movePositiveZ();
 				}
 			}
 		}
-	}
+	});
 	return volume;
 }
 
@@ -21,9 +21,22 @@ namespace voxelutil {
 
 /**
  * @brief Import a heightmap with rgb being the surface color and alpha channel being the height
+ * @note The colors are mapped in parallel - the voxels are written on the calling thread because the wrapper might
+ * not be thread safe
  */
 void importColoredHeightmap(voxel::RawVolumeWrapper& volume, palette::PaletteLookup &palLookup, const image::ImagePtr& image, const voxel::Voxel &underground);
+/**
+ * @brief Import a heightmap with rgb being the surface color and alpha channel being the height
+ * @note The columns of the volume are computed and written in parallel
+ */
+void importColoredHeightmap(voxel::RawVolume &volume, const palette::Palette &palette, const image::ImagePtr &image,
+							const voxel::Voxel &underground);
 void importHeightmap(voxel::RawVolumeWrapper& volume, const image::ImagePtr& image, const voxel::Voxel &underground, const voxel::Voxel &surface);
+/**
+ * @note The columns of the volume are computed and written in parallel
+ */
+void importHeightmap(voxel::RawVolume &volume, const image::ImagePtr &image, const voxel::Voxel &underground,
+					 const voxel::Voxel &surface);
 int importHeightMaxHeight(const image::ImagePtr &image, bool alpha);
 voxel::RawVolume* importAsPlane(const image::ImagePtr& image, const palette::Palette &palette, uint8_t thickness = 1);
 voxel::RawVolume* importAsPlane(const image::ImagePtr& image, uint8_t thickness = 1);
@@ -87,4 +87,16 @@ PickResult pickVoxel(const VolumeType* volData, const glm::vec3& v3dStart, const
 	return functor._result;
 }
 
+/**
+ * @brief Pick the first solid voxel along a vector and skip the empty areas of the volume
+ * @sa voxel::OccupancyPyramid
+ */
+template<typename VolumeType>
+PickResult pickVoxel(const VolumeType* volData, const voxel::OccupancyPyramid &occupancy, const glm::vec3& v3dStart, const glm::vec3& v3dDirectionAndLength, const voxel::Voxel& emptyVoxelExample) {
+	core_trace_scoped(pickVoxel);
+	RaycastPickingFunctor<VolumeType> functor(emptyVoxelExample);
+	raycastWithDirection(volData, occupancy, v3dStart, v3dDirectionAndLength, functor);
+	return functor._result;
+}
+
 }
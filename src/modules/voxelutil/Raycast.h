@@ -5,10 +5,12 @@
 #pragma once
 
 #include "core/Trace.h"
+#include "voxel/OccupancyPyramid.h"
 #include "voxel/RawVolume.h"
 #include "core/Common.h"
 #include <glm/ext/scalar_constants.hpp>
 #include <glm/common.hpp>
+#include <float.h>
 
 namespace voxelutil {
 namespace RaycastResults {
@@ -193,6 +195,180 @@ inline RaycastResult raycastWithEndpointsVolume(voxel::RawVolume* volData, const
 	return raycastWithEndpoints(volData, v3dStart, v3dEnd, callback);
 }
 
+/**
+ * Cast a ray through a volume by specifying the start and end positions and skip empty areas of the volume
+ *
+ * This works like the raycast without the @c voxel::OccupancyPyramid, but the ray is clipped to the volume region
+ * (extended by one voxel to still report the first invalid position when leaving the volume) and whenever the ray
+ * enters a brick that is flagged as empty in the @a occupancy pyramid, it directly jumps to the last voxel of that
+ * brick along the ray. This means that the @a callback is not called for every voxel the ray passes through, but
+ * only for the voxels of occupied bricks and the voxels where the ray leaves an empty brick.
+ *
+ * @note The @a occupancy must be up to date with the volume data. If the region of the pyramid doesn't match the
+ * volume region, this falls back to the voxel-by-voxel raycast.
+ *
+ * @param volData The volume to pass the ray though
+ * @param occupancy The occupancy pyramid of the volume
+ * @param v3dStart The start position in the volume
+ * @param v3dEnd The end position in the volume
+ * @param callback The callback to call for each visited voxel
+ *
+ * @return A RaycastResults designating whether the ray hit anything or not
+ */
+template<typename Callback, class Volume>
+RaycastResult raycastWithEndpoints(Volume *volData, const voxel::OccupancyPyramid &occupancy,
+								   const glm::vec3 &v3dStart, const glm::vec3 &v3dEnd, Callback &&callback) {
+	if (!occupancy.isValid() || occupancy.region() != volData->region()) {
+		return raycastWithEndpoints(volData, v3dStart, v3dEnd, core::forward<Callback>(callback));
+	}
+	core_trace_scoped(raycastWithEndpointsOccupancy);
+	typename Volume::Sampler sampler(volData);
+
+	voxel::Region bounds = occupancy.region();
+	bounds.grow(1);
+
+	const glm::vec3 delta = v3dEnd - v3dStart;
+	const glm::vec3 dist = glm::abs(delta);
+	glm::ivec3 step(0);
+	glm::vec3 deltat(FLT_MAX);
+	for (int i = 0; i < 3; ++i) {
+		if (dist[i] >= glm::epsilon<float>()) {
+			step[i] = delta[i] > 0.0f ? 1 : -1;
+			deltat[i] = 1.0f / dist[i];
+		}
+	}
+	const glm::ivec3 cellEnd(glm::floor(v3dEnd));
+
+	// the ray parameter at which the ray leaves the given cell on each axis
+	auto boundaries = [&](const glm::ivec3 &cell) {
+		glm::vec3 t(FLT_MAX);
+		for (int i = 0; i < 3; ++i) {
+			if (step[i] == 1) {
+				t[i] = ((float)cell[i] + 1.0f - v3dStart[i]) * deltat[i];
+			} else if (step[i] == -1) {
+				t[i] = (v3dStart[i] - (float)cell[i]) * deltat[i];
+			}
+		}
+		return t;
+	};
+	// the cell on the ray at the given parameter - clamped to the given region
+	auto cellAt = [&](float t, const voxel::Region &region) {
+		const glm::ivec3 cell(glm::floor(v3dStart + delta * t));
+		return glm::clamp(cell, region.getLowerCorner(), region.getUpperCorner());
+	};
+
+	glm::ivec3 cell(glm::floor(v3dStart));
+	if (!bounds.containsPoint(cell)) {
+		// slab test to find the entry point of the ray into the volume bounds
+		const glm::vec3 mins = bounds.getLowerCornerf();
+		const glm::vec3 maxs = bounds.getUpperCornerf() + 1.0f;
+		float tEnter = 0.0f;
+		float tLeave = 1.0f;
+		for (int i = 0; i < 3; ++i) {
+			if (step[i] == 0) {
+				if (v3dStart[i] < mins[i] || v3dStart[i] >= maxs[i]) {
+					return RaycastResults::Completed;
+				}
+				continue;
+			}
+			float t0 = (mins[i] - v3dStart[i]) / delta[i];
+			float t1 = (maxs[i] - v3dStart[i]) / delta[i];
+			if (t0 > t1) {
+				core::exchange(t0, t1);
+			}
+			tEnter = core_max(tEnter, t0);
+			tLeave = core_min(tLeave, t1);
+		}
+		if (tEnter > tLeave) {
+			return RaycastResults::Completed;
+		}
+		cell = cellAt(tEnter, bounds);
+	}
+	glm::vec3 tNext = boundaries(cell);
+	sampler.setPosition(cell);
+	if (step == glm::ivec3(0)) {
+		return callback(sampler) ? RaycastResults::Completed : RaycastResults::Interupted;
+	}
+
+	voxel::Region skipped = voxel::Region::InvalidRegion;
+	for (;;) {
+		if (!callback(sampler)) {
+			return RaycastResults::Interupted;
+		}
+
+		if (tNext.x <= tNext.y && tNext.x <= tNext.z) {
+			if (cell.x == cellEnd.x) {
+				break;
+			}
+			tNext.x += deltat.x;
+			cell.x += step.x;
+			if (step.x == 1) {
+				sampler.movePositiveX();
+			} else {
+				sampler.moveNegativeX();
+			}
+		} else if (tNext.y <= tNext.z) {
+			if (cell.y == cellEnd.y) {
+				break;
+			}
+			tNext.y += deltat.y;
+			cell.y += step.y;
+			if (step.y == 1) {
+				sampler.movePositiveY();
+			} else {
+				sampler.moveNegativeY();
+			}
+		} else {
+			if (cell.z == cellEnd.z) {
+				break;
+			}
+			tNext.z += deltat.z;
+			cell.z += step.z;
+			if (step.z == 1) {
+				sampler.movePositiveZ();
+			} else {
+				sampler.moveNegativeZ();
+			}
+		}
+
+		// the bounds are convex - once we left them, the ray can't enter them again
+		if (!bounds.containsPoint(cell)) {
+			break;
+		}
+
+		const int level = occupancy.emptyLevel(cell);
+		if (level < 0) {
+			continue;
+		}
+		const voxel::Region &brick = occupancy.brickRegion(level, cell);
+		if (brick == skipped) {
+			// we already jumped to the last voxel of this brick
+			continue;
+		}
+		skipped = brick;
+		glm::ivec3 lastCell;
+		for (int i = 0; i < 3; ++i) {
+			lastCell[i] = step[i] == -1 ? brick.getLowerCorner()[i] : brick.getUpperCorner()[i];
+		}
+		const glm::vec3 tExit = boundaries(lastCell);
+		const float t = core_min(tExit.x, core_min(tExit.y, tExit.z));
+		if (t >= 1.0f) {
+			// the end of the ray is inside the empty brick
+			cell = glm::clamp(cellEnd, brick.getLowerCorner(), brick.getUpperCorner());
+			sampler.setPosition(cell);
+			if (!callback(sampler)) {
+				return RaycastResults::Interupted;
+			}
+			break;
+		}
+		cell = cellAt(t, brick);
+		tNext = boundaries(cell);
+		sampler.setPosition(cell);
+	}
+
+	return RaycastResults::Completed;
+}
+
 /**
  * Cast a ray through a volume by specifying the start and a direction
  *
@@ -223,4 +399,18 @@ RaycastResult raycastWithDirection(Volume* volData, const glm::vec3& v3dStart, c
 	return raycastWithEndpoints<Callback, Volume>(volData, v3dStart, v3dEnd, core::forward<Callback>(callback));
 }
 
+/**
+ * Cast a ray through a volume by specifying the start and a direction and skip empty areas of the volume
+ *
+ * @sa raycastWithEndpoints() for the details about the @c voxel::OccupancyPyramid usage
+ */
+template<typename Callback, class Volume>
+RaycastResult raycastWithDirection(Volume *volData, const voxel::OccupancyPyramid &occupancy,
+								   const glm::vec3 &v3dStart, const glm::vec3 &v3dDirectionAndLength,
+								   Callback &&callback) {
+	const glm::vec3 v3dEnd = v3dStart + v3dDirectionAndLength;
+	return raycastWithEndpoints<Callback, Volume>(volData, occupancy, v3dStart, v3dEnd,
+												  core::forward<Callback>(callback));
+}
+
 }
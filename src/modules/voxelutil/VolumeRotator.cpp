@@ -3,15 +3,17 @@
  */
 
 #include "VolumeRotator.h"
+#include "app/Async.h"
+#include "core/ArrayLength.h"
 #include "core/Assert.h"
 #include "core/GLM.h"
 #include "core/Log.h"
+#include "core/Trace.h"
 #include "math/AABB.h"
 #include "math/Axis.h"
 #include "math/Math.h"
 #include "palette/Palette.h"
 #include "voxel/RawVolume.h"
-#include "voxel/RawVolumeWrapper.h"
 #include "voxel/Region.h"
 #include "voxel/Voxel.h"
 #include "voxelutil/VoxelUtil.h"
@@ -20,6 +22,48 @@
 
 namespace voxelutil {
 
+/**
+ * @brief Sample the source volume for a single target voxel
+ * @param[in] srcPos The position in the source volume that the center of the target voxel maps to
+ * @param[in] offsets The source space offsets of the sub samples relative to the center
+ */
+static voxel::Voxel sampleMajority(const voxel::RawVolume *srcVolume, const glm::vec3 &srcPos,
+								   const glm::vec3 (&offsets)[8]) {
+	voxel::Voxel samples[lengthof(offsets)];
+	int counts[lengthof(offsets)];
+	int n = 0;
+	int solid = 0;
+	for (int i = 0; i < lengthof(offsets); ++i) {
+		const voxel::Voxel &voxel = srcVolume->voxel(glm::ivec3(glm::floor(srcPos + offsets[i])));
+		if (voxel::isAir(voxel.getMaterial())) {
+			continue;
+		}
+		++solid;
+		int j = 0;
+		for (; j < n; ++j) {
+			if (samples[j].isSame(voxel)) {
+				++counts[j];
+				break;
+			}
+		}
+		if (j == n) {
+			samples[n] = voxel;
+			counts[n] = 1;
+			++n;
+		}
+	}
+	if (solid * 2 < lengthof(offsets)) {
+		return voxel::Voxel();
+	}
+	int best = 0;
+	for (int j = 1; j < n; ++j) {
+		if (counts[j] > counts[best]) {
+			best = j;
+		}
+	}
+	return samples[best];
+}
+
 /**
  * @param[in] srcVolume The RawVolume to rotate
  * @param[in] angles The angles for the x, y and z axis given in degrees
@@ -27,39 +71,54 @@ namespace voxelutil {
  * memory.
  */
 voxel::RawVolume *rotateVolume(const voxel::RawVolume *srcVolume, const palette::Palette &palette,
-							   const glm::ivec3 &angles, const glm::vec3 &normalizedPivot) {
-	// TODO: implement sampling http://www.leptonica.org/rotation.html
+							   const glm::ivec3 &angles, const glm::vec3 &normalizedPivot, RotationFilter filter) {
+	core_trace_scoped(RotateVolume);
 	const float pitch = glm::radians((float)angles.x);
 	const float yaw = glm::radians((float)angles.y);
 	const float roll = glm::radians((float)angles.z);
 	const glm::mat4 &mat = glm::eulerAngleXYZ(pitch, yaw, roll);
+	const glm::mat4 &inverseMat = glm::transpose(mat);
 	const voxel::Region srcRegion = srcVolume->region();
 
 	const glm::vec3 pivot(normalizedPivot * glm::vec3(srcRegion.getDimensionsInVoxels()));
 	const voxel::Region &destRegion = srcRegion.rotate(mat, pivot);
 	voxel::RawVolume *destVolume = new voxel::RawVolume(destRegion);
-	voxel::RawVolumeWrapper destVolumeWrapper(destVolume);
 
-	voxel::RawVolume::Sampler srcSampler(srcVolume);
-	srcSampler.setPosition(srcRegion.getLowerCorner());
-	for (int32_t z = srcRegion.getLowerZ(); z <= srcRegion.getUpperZ(); ++z) {
-		voxel::RawVolume::Sampler srcSampler2 = srcSampler;
-		for (int32_t y = srcRegion.getLowerY(); y <= srcRegion.getUpperY(); ++y) {
-			voxel::RawVolume::Sampler srcSampler3 = srcSampler2;
-			for (int32_t x = srcRegion.getLowerX(); x <= srcRegion.getUpperX(); ++x) {
-				const voxel::Voxel voxel = srcSampler3.voxel();
-				if (!voxel::isAir(voxel.getMaterial())) {
-					const glm::vec3 srcPos(x, y, z);
-					const glm::vec3 &destPos = math::transform(mat, srcPos, pivot);
-					const glm::ivec3 &destPosFloor = glm::floor(destPos);
-					destVolumeWrapper.setVoxel(destPosFloor, voxel);
+	// moving one voxel along the x axis of the target volume moves by this amount in the source volume
+	const glm::vec3 srcStepX(inverseMat[0]);
+	glm::vec3 offsets[8];
+	for (int i = 0; i < lengthof(offsets); ++i) {
+		const glm::vec3 offset((i & 1) ? 0.25f : -0.25f, (i & 2) ? 0.25f : -0.25f, (i & 4) ? 0.25f : -0.25f);
+		offsets[i] = glm::mat3(inverseMat) * offset;
+	}
+
+	const glm::ivec3 &mins = destRegion.getLowerCorner();
+	const glm::ivec3 &maxs = destRegion.getUpperCorner();
+	app::for_parallel(mins.z, maxs.z + 1, [&](int start, int end) {
+		voxel::RawVolume::Sampler destSampler(destVolume);
+		for (int32_t z = start; z < end; ++z) {
+			for (int32_t y = mins.y; y <= maxs.y; ++y) {
+				// the center of the target voxel mapped into the source volume
+				glm::vec3 srcPos = math::transform(inverseMat, glm::vec3(mins.x, y, z) + 0.5f, pivot);
+				destSampler.setPosition(mins.x, y, z);
+				for (int32_t x = mins.x; x <= maxs.x; ++x) {
+					if (filter == RotationFilter::Nearest) {
+						const voxel::Voxel &voxel = srcVolume->voxel(glm::ivec3(glm::floor(srcPos)));
+						if (!voxel::isAir(voxel.getMaterial())) {
+							destSampler.setVoxel(voxel);
+						}
+					} else {
+						const voxel::Voxel &voxel = sampleMajority(srcVolume, srcPos, offsets);
+						if (!voxel::isAir(voxel.getMaterial())) {
+							destSampler.setVoxel(voxel);
+						}
+					}
+					srcPos += srcStepX;
+					destSampler.movePositiveX();
 				}
-				srcSampler3.movePositiveX();
 			}
-			srcSampler2.movePositiveY();
 		}
-		srcSampler.movePositiveZ();
-	}
+	});
 	return destVolume;
 }
 
@@ -18,11 +18,24 @@ class Palette;
 
 namespace voxelutil {
 
+enum class RotationFilter {
+	/** the source voxel at the center of the target voxel is used */
+	Nearest,
+	/**
+	 * the target voxel is sampled at several positions and the voxel is only set if at least half of the samples hit
+	 * a solid voxel - the most frequent of them is used
+	 */
+	Majority
+};
+
 /**
  * @brief Rotate the given volume by the given angles in degree
+ *
+ * Every voxel of the target volume is mapped back into the source volume - this avoids holes in the target volume
+ * that a forward mapping of the source voxels would produce.
  */
 voxel::RawVolume *rotateVolume(const voxel::RawVolume *source, const palette::Palette &palette, const glm::ivec3 &angles,
-									  const glm::vec3 &normalizedPivot);
+							   const glm::vec3 &normalizedPivot, RotationFilter filter = RotationFilter::Majority);
 /**
  * @brief Rotate the given volume on the given axis by 90 degree. This method does not lose any voxels
  * @note The volume size might differ
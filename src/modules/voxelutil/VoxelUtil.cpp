@@ -3,6 +3,7 @@
  */
 
 #include "VoxelUtil.h"
+#include "core/Algorithm.h"
 #include "core/GLM.h"
 #include "core/Log.h"
 #include "core/collection/Array3DView.h"
@@ -578,6 +579,58 @@ int extrudePlane(voxel::RawVolumeWrapper &in, const glm::ivec3 &pos, voxel::Face
 	return voxelutil::walkPlane(in, pos, face, -1, check, exec, thickness);
 }
 
+int extrudePlane(const voxel::RawVolume &volume, const glm::ivec3 &pos, voxel::FaceNames face,
+				 const voxel::Voxel &groundVoxel, const voxel::Voxel &newPlaneVoxel, int thickness,
+				 const ExtrudePlaceCallback &canPlace, const ExtrudeSpanCallback &writeSpan) {
+	const math::Axis axis = voxel::faceToAxis(face);
+	if (axis == math::Axis::None) {
+		return -1;
+	}
+	const int idx = math::getIndexForAxis(axis);
+	const int walkOffset = voxel::isNegativeFace(face) ? -1 : 1;
+	auto check = [&](const voxel::RawVolume &volume, const glm::ivec3 &p, voxel::FaceNames direction) {
+		return checkExtrudeFunc(volume, p, direction, pos, groundVoxel, newPlaneVoxel);
+	};
+	core::DynamicArray<glm::ivec3> layer;
+	auto exec = [&](const voxel::RawVolume &, const glm::ivec3 &p) {
+		if (!canPlace(p)) {
+			return false;
+		}
+		layer.push_back(p);
+		return true;
+	};
+	int n = 0;
+	glm::ivec3 layerPos = pos;
+	for (int i = 0; i < thickness; ++i) {
+		layer.clear();
+		if (voxelutil::walkPlane(volume, layerPos, face, -1, check, exec, 1) <= 0) {
+			break;
+		}
+		core::sort(layer.begin(), layer.end(), [](const glm::ivec3 &a, const glm::ivec3 &b) {
+			if (a.z != b.z) {
+				return a.z < b.z;
+			}
+			if (a.y != b.y) {
+				return a.y < b.y;
+			}
+			return a.x < b.x;
+		});
+		size_t start = 0;
+		for (size_t j = 1; j <= layer.size(); ++j) {
+			const glm::ivec3 &first = layer[start];
+			if (j < layer.size() && layer[j].z == first.z && layer[j].y == first.y &&
+				layer[j].x == layer[j - 1].x + 1) {
+				continue;
+			}
+			writeSpan(first.x, layer[j - 1].x, first.y, first.z);
+			start = j;
+		}
+		n += (int)layer.size();
+		layerPos[idx] += walkOffset;
+	}
+	return n;
+}
+
 int fillPlane(voxel::RawVolumeWrapper &in, const image::ImagePtr &image, const voxel::Voxel &searchedVoxel,
 			  const glm::ivec3 &position, voxel::FaceNames face) {
 	palette::PaletteLookup palLookup;
@@ -8,6 +8,7 @@
 #include "voxel/Face.h"
 #include "voxel/Voxel.h"
 #include "voxelutil/Connectivity.h"
+#include <functional>
 #include <glm/fwd.hpp>
 
 namespace voxel {
@@ -90,6 +91,30 @@ int extrudePlane(voxel::RawVolumeWrapper &in, const glm::ivec3 &pos, voxel::Face
 voxel::Region extrudePlaneRegion(const voxel::RawVolume &volume, const glm::ivec3 &pos, voxel::FaceNames face,
 								 const voxel::Voxel &groundVoxel, const voxel::Voxel &newPlaneVoxel, int thickness);
 
+/**
+ * @return @c true if the extrusion may place a voxel at the given position
+ */
+using ExtrudePlaceCallback = std::function<bool(const glm::ivec3 &pos)>;
+/**
+ * @brief Sets the new plane voxel from @c x0 to @c x1 (inclusive)
+ */
+using ExtrudeSpanCallback = std::function<void(int x0, int x1, int y, int z)>;
+
+/**
+ * @brief Same as @c extrudePlane() - but the voxels of every layer are handed over as x spans instead of being set one
+ * by one.
+ *
+ * The layer is walked first and the spans are written before the next layer is walked, as the next layer is growing on
+ * top of the written voxels.
+ *
+ * @param canPlace Checks whether a voxel can be placed - the walk doesn't continue at positions that are rejected
+ * @param writeSpan Has to set the given span to @c newPlaneVoxel in @c volume
+ * @return The amount of placed voxels
+ */
+int extrudePlane(const voxel::RawVolume &volume, const glm::ivec3 &pos, voxel::FaceNames face,
+				 const voxel::Voxel &groundVoxel, const voxel::Voxel &newPlaneVoxel, int thickness,
+				 const ExtrudePlaceCallback &canPlace, const ExtrudeSpanCallback &writeSpan);
+
 /**
  * @brief Erases a plane in a voxel volume.
  *
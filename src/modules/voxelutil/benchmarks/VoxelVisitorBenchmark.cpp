@@ -8,20 +8,28 @@
 
 class VoxelVisitorBenchmark : public app::AbstractBenchmark {
 protected:
-	voxel::RawVolume v{voxel::Region{-20, 20}};
+	voxel::RawVolume *v = nullptr;
 public:
 	void SetUp(::benchmark::State &state) override {
 		app::AbstractBenchmark::SetUp(state);
+		const voxel::VolumeLayout layout = (voxel::VolumeLayout)state.range(1);
+		v = new voxel::RawVolume(voxel::Region{-20, 20}, layout);
 
 		const voxel::Voxel voxel = voxel::createVoxel(voxel::VoxelType::Generic, 1);
-		v.setVoxel(0, 0, 0, voxel);
-		v.setVoxel(0, 0, 2, voxel);
-		v.setVoxel(0, 2, 2, voxel);
-		v.setVoxel(2, 2, 2, voxel);
-		v.setVoxel(0, 2, 0, voxel);
-		v.setVoxel(2, 0, 0, voxel);
-		v.setVoxel(2, 0, 2, voxel);
-		v.setVoxel(2, 2, 0, voxel);
+		v->setVoxel(0, 0, 0, voxel);
+		v->setVoxel(0, 0, 2, voxel);
+		v->setVoxel(0, 2, 2, voxel);
+		v->setVoxel(2, 2, 2, voxel);
+		v->setVoxel(0, 2, 0, voxel);
+		v->setVoxel(2, 0, 0, voxel);
+		v->setVoxel(2, 0, 2, voxel);
+		v->setVoxel(2, 2, 0, voxel);
+	}
+
+	void TearDown(::benchmark::State &state) override {
+		delete v;
+		v = nullptr;
+		app::AbstractBenchmark::TearDown(state);
 	}
 };
 
@@ -33,11 +41,12 @@ static void visitOrder(voxelutil::VisitorOrder order, const voxel::RawVolume &v)
 
 BENCHMARK_DEFINE_F(VoxelVisitorBenchmark, Visit)(benchmark::State &state) {
 	for (auto _ : state) {
-		const voxelutil::VisitorOrder order = (voxelutil::VisitorOrder)(state.range());
-		visitOrder(order, v);
+		const voxelutil::VisitorOrder order = (voxelutil::VisitorOrder)(state.range(0));
+		visitOrder(order, *v);
 	}
 }
 
-BENCHMARK_REGISTER_F(VoxelVisitorBenchmark, Visit)->DenseRange(0, (int)(voxelutil::VisitorOrder::Max)-1);
+BENCHMARK_REGISTER_F(VoxelVisitorBenchmark, Visit)->ArgsProduct({benchmark::CreateDenseRange(0, (int)(voxelutil::VisitorOrder::Max)-1, 1),
+				   benchmark::CreateDenseRange(0, (int)(voxel::VolumeLayout::Max)-1, 1)});
 
 BENCHMARK_MAIN();
@@ -3,13 +3,86 @@
  */
 
 #include "app/tests/AbstractTest.h"
+#include "core/tests/TestColorHelper.h"
 #include "voxelutil/ImageUtils.h"
+#include "voxel/MaterialColor.h"
 #include "voxel/RawVolume.h"
+#include "voxel/RawVolumeWrapper.h"
+#include "palette/PaletteLookup.h"
 #include "core/ScopedPtr.h"
 
 namespace voxelutil {
 
 class ImageUtilsTest: public app::AbstractTest {
+protected:
+	// the closest palette colors of the opaque pixels #263238 and #f44336 in test-heightmap.png
+	const core::RGBA darkColor{0x37, 0x3c, 0x38};
+	const core::RGBA redColor{0xf7, 0x5c, 0x2f};
+
+	void expectSameVoxels(const voxel::RawVolume &expected, const voxel::RawVolume &volume) {
+		const voxel::Region &region = expected.region();
+		for (int z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+			for (int y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+				for (int x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+					const voxel::Voxel &e = expected.voxel(x, y, z);
+					const voxel::Voxel &v = volume.voxel(x, y, z);
+					ASSERT_TRUE(e.isSame(v)) << "Voxel mismatch at " << x << ":" << y << ":" << z;
+				}
+			}
+		}
+	}
+
+	int countVoxels(const voxel::RawVolume &volume) {
+		const voxel::Region &region = volume.region();
+		int count = 0;
+		for (int z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+			for (int y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+				for (int x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+					if (!voxel::isAir(volume.voxel(x, y, z).getMaterial())) {
+						++count;
+					}
+				}
+			}
+		}
+		return count;
+	}
+
+	/**
+	 * @brief Expects the heightmap column at x and z to be @c height voxels high with the @c underground voxels below
+	 * the surface voxel
+	 * @return The surface voxel of the column
+	 */
+	voxel::Voxel expectColumn(const voxel::RawVolume &volume, int x, int z, int height,
+							  const voxel::Voxel &underground) {
+		const voxel::Region &region = volume.region();
+		for (int y = 0; y < height - 1; ++y) {
+			EXPECT_TRUE(underground.isSame(volume.voxel(x, y, z))) << "Underground mismatch at " << x << ":" << y << ":"
+																	<< z;
+		}
+		for (int y = height; y <= region.getUpperY(); ++y) {
+			EXPECT_TRUE(voxel::isAir(volume.voxel(x, y, z).getMaterial())) << "Expected air at " << x << ":" << y
+																			<< ":" << z;
+		}
+		if (height <= 0) {
+			return voxel::Voxel();
+		}
+		const voxel::Voxel &surface = volume.voxel(x, height - 1, z);
+		EXPECT_FALSE(voxel::isAir(surface.getMaterial())) << "Missing surface at " << x << ":" << height - 1 << ":"
+														  << z;
+		return surface;
+	}
+
+	/**
+	 * @brief Expects the voxels from @c minZ to @c maxZ at x and y to be solid and to have the palette color @c rgba
+	 */
+	void expectDepth(const voxel::RawVolume &volume, const palette::Palette &palette, int x, int y, int minZ,
+					 int maxZ, const core::RGBA &rgba) {
+		for (int z = minZ; z <= maxZ; ++z) {
+			const voxel::Voxel &voxel = volume.voxel(x, y, z);
+			ASSERT_FALSE(voxel::isAir(voxel.getMaterial())) << "Expected a voxel at " << x << ":" << y << ":" << z;
+			EXPECT_EQ(rgba, palette.color(voxel.getColor())) << x << ":" << y << ":" << z;
+		}
+	}
 };
 
 TEST_F(ImageUtilsTest, testImportAsPlane) {
@@ -21,6 +94,18 @@ TEST_F(ImageUtilsTest, testImportAsPlane) {
 	EXPECT_EQ(img->width(), volume->width());
 	EXPECT_EQ(img->height(), volume->height());
 	EXPECT_EQ(depth, volume->depth());
+	const voxel::Voxel &voxel = volume->voxel(0, img->height() - 1, depth - 1);
+	EXPECT_EQ(img->colorAt(0, 0).a != 0, !voxel::isAir(voxel.getMaterial()));
+
+	// the image has 1879 opaque pixels - the image rows are flipped to the y axis of the volume
+	EXPECT_EQ(1879 * depth, countVoxels(*volume));
+	const palette::Palette &palette = voxel::getPalette();
+	// pixel 21:0 is #7a6d68
+	expectDepth(*volume, palette, 21, 73, 0, depth - 1, core::RGBA(0x72, 0x63, 0x6e));
+	// pixel 13:3 is #2d2824
+	expectDepth(*volume, palette, 13, 70, 0, depth - 1, core::RGBA(0x22, 0x22, 0x22));
+	// the transparent pixel 20:0
+	EXPECT_TRUE(voxel::isAir(volume->voxel(20, 73, 0).getMaterial()));
 }
 
 TEST_F(ImageUtilsTest, testImportAsVolume) {
@@ -32,6 +117,19 @@ TEST_F(ImageUtilsTest, testImportAsVolume) {
 	EXPECT_EQ(img->width(), volume->width());
 	EXPECT_EQ(img->height(), volume->height());
 	EXPECT_EQ(depth * 2 + 1, volume->depth());
+
+	// the depth map value 171 is 171 * 10 / 255 = 6.7 voxels deep - ceil(6.7 / 2) = 4 voxels on both sides of the
+	// center z = 10. A depth map value of 0 only places the center voxel.
+	EXPECT_EQ(4 * 9 + 4 * 1, countVoxels(*volume));
+	const palette::Palette &palette = voxel::getPalette();
+	expectDepth(*volume, palette, 7, 0, 6, 14, redColor);
+	expectDepth(*volume, palette, 6, 0, 6, 14, redColor);
+	expectDepth(*volume, palette, 7, 1, 6, 14, redColor);
+	expectDepth(*volume, palette, 7, 2, 6, 14, redColor);
+	expectDepth(*volume, palette, 5, 0, 10, 10, darkColor);
+	expectDepth(*volume, palette, 6, 1, 10, 10, darkColor);
+	expectDepth(*volume, palette, 6, 2, 10, 10, darkColor);
+	expectDepth(*volume, palette, 7, 3, 10, 10, darkColor);
 }
 
 TEST_F(ImageUtilsTest, testImportAsVolume2) {
@@ -43,6 +141,64 @@ TEST_F(ImageUtilsTest, testImportAsVolume2) {
 	EXPECT_EQ(img->width(), volume->width());
 	EXPECT_EQ(img->height(), volume->height());
 	EXPECT_EQ(depth, volume->depth());
+
+	// the depth map value 171 is ceil(171 * 9 / 255) = 7 voxels deep - a depth map value of 0 places nothing
+	EXPECT_EQ(4 * 7, countVoxels(*volume));
+	const palette::Palette &palette = voxel::getPalette();
+	expectDepth(*volume, palette, 7, 0, 0, 6, redColor);
+	expectDepth(*volume, palette, 6, 0, 0, 6, redColor);
+	expectDepth(*volume, palette, 7, 1, 0, 6, redColor);
+	expectDepth(*volume, palette, 7, 2, 0, 6, redColor);
+}
+
+TEST_F(ImageUtilsTest, testImportHeightmap) {
+	const image::ImagePtr& img = image::loadImage("test-heightmap.png");
+	ASSERT_TRUE(img->isLoaded()) << "Failed to load image: " << img->name();
+	const voxel::Region region(0, 0, 0, img->width() - 1, 31, img->height() - 1);
+	const voxel::Voxel dirt = voxel::createVoxel(voxel::VoxelType::Generic, 1);
+	const voxel::Voxel grass = voxel::createVoxel(voxel::VoxelType::Generic, 2);
+	for (const voxel::Voxel &underground : {dirt, voxel::Voxel()}) {
+		voxel::RawVolume expected(region);
+		voxel::RawVolumeWrapper wrapper(&expected);
+		importHeightmap(wrapper, img, underground, grass);
+		voxel::RawVolume volume(region);
+		importHeightmap(volume, img, underground, grass);
+		expectSameVoxels(expected, volume);
+
+		// the red channel is the height - the max alpha value is 255, so 38 is round(38 * 32 / 255) = 5 voxels high
+		// and 244 is round(244 * 32 / 255) = 31 voxels high
+		const bool air = voxel::isAir(underground.getMaterial());
+		EXPECT_EQ(air ? 8 : 4 * 5 + 4 * 31, countVoxels(volume));
+		EXPECT_TRUE(grass.isSame(expectColumn(volume, 7, 4, 5, underground)));
+		EXPECT_TRUE(grass.isSame(expectColumn(volume, 5, 7, 5, underground)));
+		EXPECT_TRUE(grass.isSame(expectColumn(volume, 7, 5, 31, underground)));
+		EXPECT_TRUE(grass.isSame(expectColumn(volume, 6, 7, 31, underground)));
+		expectColumn(volume, 0, 0, 0, underground);
+		expectColumn(volume, 6, 4, 0, underground);
+	}
+}
+
+TEST_F(ImageUtilsTest, testImportColoredHeightmap) {
+	const image::ImagePtr& img = image::loadImage("test-heightmap.png");
+	ASSERT_TRUE(img->isLoaded()) << "Failed to load image: " << img->name();
+	const voxel::Region region(0, 0, 0, img->width() - 1, 31, img->height() - 1);
+	const voxel::Voxel dirt = voxel::createVoxel(voxel::VoxelType::Generic, 1);
+	palette::PaletteLookup palLookup;
+	voxel::RawVolume expected(region);
+	voxel::RawVolumeWrapper wrapper(&expected);
+	importColoredHeightmap(wrapper, palLookup, img, dirt);
+	voxel::RawVolume volume(region);
+	importColoredHeightmap(volume, palLookup.palette(), img, dirt);
+	expectSameVoxels(expected, volume);
+
+	// the alpha channel is the height - every opaque pixel has an alpha of 255 and fills the whole column
+	EXPECT_EQ(8 * 32, countVoxels(volume));
+	const palette::Palette &palette = palLookup.palette();
+	EXPECT_EQ(darkColor, palette.color(expectColumn(volume, 7, 4, 32, dirt).getColor()));
+	EXPECT_EQ(darkColor, palette.color(expectColumn(volume, 5, 7, 32, dirt).getColor()));
+	EXPECT_EQ(redColor, palette.color(expectColumn(volume, 7, 5, 32, dirt).getColor()));
+	EXPECT_EQ(redColor, palette.color(expectColumn(volume, 7, 7, 32, dirt).getColor()));
+	expectColumn(volume, 0, 0, 0, dirt);
 }
 
 }
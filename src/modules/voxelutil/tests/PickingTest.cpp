@@ -3,9 +3,11 @@
  */
 
 #include "app/tests/AbstractTest.h"
+#include "voxel/OccupancyPyramid.h"
 #include "voxel/RawVolume.h"
 #include "voxelutil/Picking.h"
 #include "core/GLM.h"
+#include "math/Random.h"
 
 namespace voxelutil {
 
@@ -21,4 +23,43 @@ TEST_F(PickingTest, testPicking) {
 	ASSERT_EQ(glm::ivec3(0, 1, 0), result.previousPosition);
 }
 
+TEST_F(PickingTest, testPickingOccupancy) {
+	voxel::RawVolume v(voxel::Region(glm::ivec3(0), glm::ivec3(100)));
+	v.setVoxel(glm::ivec3(0), voxel::createVoxel(voxel::VoxelType::Generic, 0));
+	const voxel::OccupancyPyramid occupancy(v);
+	const PickResult& result = pickVoxel(&v, occupancy, glm::vec3(0.5f, 99.5f, 0.5f), glm::down() * 200.0f, voxel::Voxel());
+	ASSERT_TRUE(result.didHit);
+	ASSERT_EQ(glm::ivec3(0), result.hitVoxel);
+	ASSERT_TRUE(result.validPreviousPosition);
+	ASSERT_EQ(glm::ivec3(0, 1, 0), result.previousPosition);
+}
+
+TEST_F(PickingTest, testPickingOccupancyMatchesRaycast) {
+	const voxel::Region region(glm::ivec3(-10), glm::ivec3(53));
+	voxel::RawVolume v(region);
+	math::Random random(42);
+	for (int i = 0; i < 200; ++i) {
+		v.setVoxel(region.getRandomPosition(random), voxel::createVoxel(voxel::VoxelType::Generic, 1));
+	}
+	const voxel::OccupancyPyramid occupancy(v);
+	int hits = 0;
+	for (int i = 0; i < 500; ++i) {
+		const glm::vec3 start(random.randomf(-100.0f, 100.0f), random.randomf(-100.0f, 100.0f), random.randomf(-100.0f, 100.0f));
+		const glm::vec3 target(region.getRandomPosition(random));
+		const glm::vec3 dir = (target + 0.5f - start) * 2.0f;
+		const PickResult &expected = pickVoxel(&v, start, dir, voxel::Voxel());
+		const PickResult &result = pickVoxel(&v, occupancy, start, dir, voxel::Voxel());
+		ASSERT_EQ(expected.didHit, result.didHit) << "ray " << i;
+		if (expected.didHit) {
+			++hits;
+			ASSERT_EQ(expected.hitVoxel, result.hitVoxel) << "ray " << i;
+			ASSERT_EQ(expected.validPreviousPosition, result.validPreviousPosition) << "ray " << i;
+			if (expected.validPreviousPosition) {
+				ASSERT_EQ(expected.previousPosition, result.previousPosition) << "ray " << i;
+			}
+		}
+	}
+	EXPECT_GT(hits, 0);
+}
+
 }
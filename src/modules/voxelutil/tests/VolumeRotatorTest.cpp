@@ -11,6 +11,7 @@
 #include "voxel/RawVolume.h"
 #include "voxel/Voxel.h"
 #include "voxel/tests/VoxelPrinter.h"
+#include "voxelutil/VolumeVisitor.h"
 
 namespace glm {
 ::std::ostream &operator<<(::std::ostream &os, const ivec3 &v) {
@@ -116,4 +117,67 @@ TEST_F(VolumeRotatorTest, testRotateAxisY45) {
 									 << " " << region;
 }
 
+TEST_F(VolumeRotatorTest, testRotateVolumeIdentity) {
+	const voxel::Region region(0, 5);
+	voxel::RawVolume volume(region);
+	for (int i = 0; i <= 5; ++i) {
+		volume.setVoxel(i, i, 5 - i, voxel::createVoxel(voxel::VoxelType::Generic, i + 1));
+	}
+	for (RotationFilter filter : {RotationFilter::Nearest, RotationFilter::Majority}) {
+		core::ScopedPtr<voxel::RawVolume> rotated(
+			voxelutil::rotateVolume(&volume, voxel::getPalette(), glm::ivec3(0), glm::vec3(0.5f), filter));
+		ASSERT_EQ(region, rotated->region());
+		for (int i = 0; i <= 5; ++i) {
+			EXPECT_EQ(i + 1, rotated->voxel(i, i, 5 - i).getColor()) << "filter " << (int)filter;
+		}
+		EXPECT_EQ(6, visitVolume(*rotated, EmptyVisitor())) << "filter " << (int)filter;
+	}
+}
+
+TEST_F(VolumeRotatorTest, testRotateVolumeNoHoles) {
+	const voxel::Region region(0, 19);
+	voxel::RawVolume volume(region);
+	const voxel::Region filled(glm::ivec3(2, 0, 2), glm::ivec3(17, 19, 17));
+	for (int z = filled.getLowerZ(); z <= filled.getUpperZ(); ++z) {
+		for (int y = filled.getLowerY(); y <= filled.getUpperY(); ++y) {
+			for (int x = filled.getLowerX(); x <= filled.getUpperX(); ++x) {
+				volume.setVoxel(x, y, z, voxel::createVoxel(voxel::VoxelType::Generic, 1));
+			}
+		}
+	}
+	const int srcVoxels = visitVolume(volume, EmptyVisitor());
+	for (RotationFilter filter : {RotationFilter::Nearest, RotationFilter::Majority}) {
+		core::ScopedPtr<voxel::RawVolume> rotated(
+			voxelutil::rotateVolume(&volume, voxel::getPalette(), glm::ivec3(0, 45, 0), glm::vec3(0.5f), filter));
+		// the center column of the rotated box must be completely filled
+		const glm::ivec3 &center = rotated->region().getCenter();
+		for (int y = 0; y <= 19; ++y) {
+			for (int d = -4; d <= 4; ++d) {
+				EXPECT_TRUE(voxel::isBlocked(rotated->voxel(center.x + d, y, center.z).getMaterial()))
+					<< "hole at " << glm::ivec3(center.x + d, y, center.z) << " filter " << (int)filter;
+			}
+		}
+		const int rotatedVoxels = visitVolume(*rotated, EmptyVisitor());
+		EXPECT_NEAR(srcVoxels, rotatedVoxels, srcVoxels / 10) << "filter " << (int)filter;
+	}
+}
+
+TEST_F(VolumeRotatorTest, testRotateVolume90) {
+	const voxel::Region region(glm::ivec3(0), glm::ivec3(3, 5, 7));
+	voxel::RawVolume volume(region);
+	volume.setVoxel(0, 0, 0, voxel::createVoxel(voxel::VoxelType::Generic, 1));
+	volume.setVoxel(3, 5, 7, voxel::createVoxel(voxel::VoxelType::Generic, 2));
+	volume.setVoxel(1, 2, 3, voxel::createVoxel(voxel::VoxelType::Generic, 3));
+	core::ScopedPtr<voxel::RawVolume> rotated(
+		voxelutil::rotateVolume(&volume, voxel::getPalette(), glm::ivec3(0, 0, 90), glm::vec3(0.5f)));
+	const glm::ivec3 &dim = rotated->region().getDimensionsInVoxels();
+	EXPECT_EQ(glm::ivec3(6, 4, 8), dim);
+	EXPECT_EQ(3, visitVolume(*rotated, EmptyVisitor()));
+	// rolling by 90 degrees around the pivot (2, 3, 4) maps the voxel (x, y) to (5 - y, x + 1) - just like the region
+	EXPECT_EQ(glm::ivec3(0, 1, 0), rotated->region().getLowerCorner());
+	EXPECT_EQ(1, rotated->voxel(5, 1, 0).getColor()) << *rotated;
+	EXPECT_EQ(2, rotated->voxel(0, 4, 7).getColor()) << *rotated;
+	EXPECT_EQ(3, rotated->voxel(3, 2, 3).getColor()) << *rotated;
+}
+
 } // namespace voxelutil
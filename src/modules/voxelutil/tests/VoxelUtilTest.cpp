@@ -80,6 +80,46 @@ TEST_F(VoxelUtilTest, testExtrudePlanePositiveY) {
 	EXPECT_EQ(8, voxelutil::visitVolume(v, [&](int, int, int, const voxel::Voxel &) {}));
 }
 
+TEST_F(VoxelUtilTest, testExtrudePlaneSpans) {
+	voxel::Region region(0, 7);
+	voxel::RawVolume expected(region);
+	const voxel::Voxel groundVoxel = voxel::createVoxel(voxel::VoxelType::Generic, 2);
+	const voxel::Voxel newPlaneVoxel = voxel::createVoxel(voxel::VoxelType::Generic, 3);
+	// an L with a gap - the walk must not connect the two parts
+	for (int x = 0; x <= 5; ++x) {
+		expected.setVoxel(x, 0, 0, groundVoxel);
+		expected.setVoxel(x, 0, 1, groundVoxel);
+	}
+	expected.setVoxel(5, 0, 2, groundVoxel);
+	expected.setVoxel(5, 0, 3, groundVoxel);
+	expected.setVoxel(7, 0, 3, groundVoxel);
+	voxel::RawVolume actual(expected);
+
+	voxel::RawVolumeWrapper wrapper(&expected);
+	const int n = voxelutil::extrudePlane(wrapper, glm::ivec3(1, 1, 0), voxel::FaceNames::PositiveY, groundVoxel,
+										  newPlaneVoxel, 3);
+	EXPECT_EQ(3 * 14, n);
+
+	int spans = 0;
+	// the same rules as RawVolumeWrapper::setVoxel()
+	auto canPlace = [&](const glm::ivec3 &pos) { return region.containsPoint(pos); };
+	auto writeSpan = [&](int x0, int x1, int y, int z) {
+		for (int x = x0; x <= x1; ++x) {
+			actual.setVoxel(x, y, z, newPlaneVoxel);
+		}
+		++spans;
+	};
+	EXPECT_EQ(n, voxelutil::extrudePlane(actual, glm::ivec3(1, 1, 0), voxel::FaceNames::PositiveY, groundVoxel,
+										 newPlaneVoxel, 3, canPlace, writeSpan));
+	// one span per row of each layer
+	EXPECT_EQ(3 * 4, spans);
+	voxelutil::visitVolume(expected, [&](int x, int y, int z, const voxel::Voxel &voxel) {
+		EXPECT_TRUE(voxel.isSame(actual.voxel(x, y, z))) << x << ":" << y << ":" << z;
+	});
+	EXPECT_EQ(voxelutil::visitVolume(expected, voxelutil::EmptyVisitor()),
+			  voxelutil::visitVolume(actual, voxelutil::EmptyVisitor()));
+}
+
 TEST_F(VoxelUtilTest, testOverridePlanePositiveY) {
 	voxel::Region region(0, 2);
 	voxel::RawVolume v(region);
@@ -24,14 +24,12 @@
 #include "io/Stream.h"
 #include "io/ZipArchive.h"
 #include "palette/Palette.h"
-#include "palette/PaletteLookup.h"
 #include "scenegraph/SceneGraph.h"
 #include "scenegraph/SceneGraphNode.h"
 #include "scenegraph/SceneGraphUtil.h"
 #include "voxel/ChunkMesh.h"
 #include "voxel/MaterialColor.h"
 #include "voxel/RawVolume.h"
-#include "voxel/RawVolumeWrapper.h"
 #include "voxel/Region.h"
 #include "voxel/SurfaceExtractor.h"
 #include "voxel/Voxel.h"
@@ -84,6 +82,10 @@ app::AppState VoxConvert::onConstruct() {
 	registerArg("--wildcard")
 		.setShort("-w")
 		.setDescription("Allow to specify input file filter if --input is a directory");
+	registerArg("--memory-limit")
+		.setDefaultValue("1024")
+		.setDescription("Stream the models of the input files in batches of the given size in megabytes into "
+						"numbered output files. Only some formats support this");
 	registerArg("--merge").setShort("-m").setDescription("Merge models into one volume");
 	registerArg("--mirror").setDescription("Mirror by the given axis (x, y or z)");
 	registerArg("--output")
@@ -334,6 +336,9 @@ app::AppState VoxConvert::onInit() {
 	_splitModels = hasArg("--split");
 	_printSceneGraph = hasArg("--json");
 	_resizeModels = hasArg("--resize");
+	if (hasArg("--memory-limit")) {
+		_memoryLimit = (size_t)core_max(1, getArgVal("--memory-limit").toInt()) * 1024u * 1024u;
+	}
 
 	Log::info("Options");
 	if (inputIsMesh || outputIsMesh) {
@@ -376,6 +381,9 @@ app::AppState VoxConvert::onInit() {
 	Log::info("* export palette:    - %s", (_exportPalette ? "true" : "false"));
 	Log::info("* export models:     - %s", (_exportModels ? "true" : "false"));
 	Log::info("* resize models:     - %s", (_resizeModels ? "true" : "false"));
+	if (_memoryLimit > 0u) {
+		Log::info("* memory limit:      - %i MB", (int)(_memoryLimit / 1024u / 1024u));
+	}
 
 	if (core::Var::getSafe(cfg::MetricFlavor)->strVal().empty()) {
 		Log::info(
@@ -414,6 +422,20 @@ app::AppState VoxConvert::onInit() {
 		return app::AppState::InitFailure;
 	}
 
+	if (_memoryLimit > 0u) {
+		if (outfiles.empty()) {
+			Log::error("Streaming the models needs an output file");
+			return app::AppState::InitFailure;
+		}
+		if (_mergeModels || _exportModels || hasArg("--slice") || hasArg("--filter") ||
+			hasArg("--filter-property")) {
+			Log::error("--merge, --export-models, --slice and the model filters can't be used with --memory-limit");
+			return app::AppState::InitFailure;
+		}
+	}
+	_outfiles = outfiles;
+	_scriptParameters = scriptParameters;
+
 	const io::ArchivePtr &fsArchive = io::openFilesystemArchive(filesystem());
 	scenegraph::SceneGraph sceneGraph;
 	for (const core::String &infile : infiles) {
@@ -489,6 +511,10 @@ app::AppState VoxConvert::onInit() {
 		if (_exportPalette) {
 			return state;
 		}
+		if (_streamedBatches > 0) {
+			Log::info("Wrote %i batches", _streamedBatches);
+			return state;
+		}
 		Log::error("No valid input found in the scenegraph to operate on.");
 		return app::AppState::InitFailure;
 	}
@@ -529,7 +555,21 @@ app::AppState VoxConvert::onInit() {
 				Log::error("Could not open target file: %s", outfile.c_str());
 				return app::AppState::InitFailure;
 			}
-			exportModelsIntoSingleObjects(sceneGraph, infiles[0], outputFile ? outputFile->extension() : "");
+			if (outputFile->extension() == "zip") {
+				// the models are saved in the format of the input file and compressed into a single archive
+				io::FileStream outputStream(outputFile);
+				io::ZipArchivePtr zipArchive = io::createZipArchive(&outputStream);
+				if (!zipArchive) {
+					return app::AppState::InitFailure;
+				}
+				exportModelsIntoSingleObjects(sceneGraph, infiles[0], "", zipArchive);
+				if (!zipArchive->flush()) {
+					Log::error("Failed to write the zip archive %s", outfile.c_str());
+					return app::AppState::InitFailure;
+				}
+				continue;
+			}
+			exportModelsIntoSingleObjects(sceneGraph, infiles[0], outputFile->extension());
 		}
 		return state;
 	}
@@ -549,42 +589,7 @@ app::AppState VoxConvert::onInit() {
 		sceneGraph.emplace(core::move(node));
 	}
 
-	if (_scaleModels) {
-		scale(sceneGraph);
-	}
-
-	if (_resizeModels) {
-		resize(getArgIvec3("--resize"), sceneGraph);
-	}
-
-	if (_mirrorModels) {
-		mirror(getArgVal("--mirror"), sceneGraph);
-	}
-
-	if (_rotateModels) {
-		rotate(getArgVal("--rotate"), sceneGraph);
-	}
-
-	if (_translateModels) {
-		translate(getArgIvec3("--translate"), sceneGraph);
-	}
-
-	if (!scriptParameters.empty()) {
-		const core::String &color = getArgVal("--scriptcolor");
-		script(scriptParameters, sceneGraph, color.toInt());
-	}
-
-	if (_cropModels) {
-		crop(sceneGraph);
-	}
-
-	if (_surfaceOnly) {
-		removeNonSurfaceVoxels(sceneGraph);
-	}
-
-	if (_splitModels) {
-		split(getArgIvec3("--split"), sceneGraph);
-	}
+	transform(sceneGraph);
 
 	for (const core::String &outfile : outfiles) {
 		const core::String &ext = core::string::extractExtension(outfile);
@@ -662,16 +667,16 @@ bool VoxConvert::handleInputFile(const core::String &infile, const io::ArchivePt
 					  maxHeight);
 			voxel::Region region(0, 0, 0, image->width() - 1, maxHeight - 1, image->height() - 1);
 			voxel::RawVolume *volume = new voxel::RawVolume(region);
-			voxel::RawVolumeWrapper wrapper(volume);
 			scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
 			const voxel::Voxel dirtVoxel = voxel::createVoxel(voxel::VoxelType::Generic, 1);
 			if (coloredHeightmap) {
-				palette::PaletteLookup palLookup;
-				voxelutil::importColoredHeightmap(wrapper, palLookup, image, dirtVoxel);
-				node.setPalette(palLookup.palette());
+				palette::Palette palette;
+				palette.nippon();
+				voxelutil::importColoredHeightmap(*volume, palette, image, dirtVoxel);
+				node.setPalette(palette);
 			} else {
 				const voxel::Voxel grassVoxel = voxel::createVoxel(voxel::VoxelType::Generic, 2);
-				voxelutil::importHeightmap(wrapper, image, dirtVoxel, grassVoxel);
+				voxelutil::importHeightmap(*volume, image, dirtVoxel, grassVoxel);
 			}
 			node.setVolume(volume, true);
 			node.setName(core::string::extractFilename(infile));
@@ -713,11 +718,19 @@ bool VoxConvert::handleInputFile(const core::String &infile, const io::ArchivePt
 		scenegraph::SceneGraph newSceneGraph;
 		voxelformat::LoadContext loadCtx;
 		loadCtx.monitor = printProgress;
+		if (_memoryLimit > 0u) {
+			loadCtx.memoryLimit = _memoryLimit;
+			loadCtx.flush = [this](scenegraph::SceneGraph &graph) { return flushModels(graph); };
+		}
 		io::FileDescription fileDesc;
 		fileDesc.set(infile);
 		if (!voxelformat::loadFormat(fileDesc, archive, newSceneGraph, loadCtx)) {
 			return false;
 		}
+		if (loadCtx.flushed > 0) {
+			// the input was streamed - the remaining models are written into their own batch, too
+			return flushModels(newSceneGraph);
+		}
 
 		int parent = sceneGraph.root().id();
 		if (multipleInputs) {
@@ -755,7 +768,7 @@ static bool hasUniqueModelNames(const scenegraph::SceneGraph &sceneGraph) {
 }
 
 void VoxConvert::exportModelsIntoSingleObjects(scenegraph::SceneGraph &sceneGraph, const core::String &inputfile,
-											   const core::String &ext) {
+											   const core::String &ext, const io::ArchivePtr &archive) {
 	Log::info("Export models into single objects");
 	int id = 0;
 	voxelformat::SaveContext saveCtx;
@@ -770,9 +783,14 @@ void VoxConvert::exportModelsIntoSingleObjects(scenegraph::SceneGraph &sceneGrap
 		scenegraph::SceneGraphNode newNode;
 		scenegraph::copyNode(node, newNode, false);
 		newSceneGraph.emplace(core::move(newNode));
-		const core::String &filename = getFilenameForModelName(inputfile, node.name(), ext, id, uniqueNames);
-		const io::ArchivePtr &archive = io::openFilesystemArchive(io::filesystem());
-		if (voxelformat::saveFormat(newSceneGraph, filename, nullptr, archive, saveCtx)) {
+		core::String filename = getFilenameForModelName(inputfile, node.name(), ext, id, uniqueNames);
+		io::ArchivePtr targetArchive = archive;
+		if (targetArchive) {
+			filename = core::string::extractFilenameWithExtension(filename);
+		} else {
+			targetArchive = io::openFilesystemArchive(io::filesystem());
+		}
+		if (voxelformat::saveFormat(newSceneGraph, filename, nullptr, targetArchive, saveCtx)) {
 			Log::info(" .. %s", filename.c_str());
 		} else {
 			Log::error(" .. %s", filename.c_str());
@@ -788,6 +806,74 @@ glm::ivec3 VoxConvert::getArgIvec3(const core::String &name) {
 	return t;
 }
 
+void VoxConvert::transform(scenegraph::SceneGraph &sceneGraph) {
+	if (_scaleModels) {
+		scale(sceneGraph);
+	}
+
+	if (_resizeModels) {
+		resize(getArgIvec3("--resize"), sceneGraph);
+	}
+
+	if (_mirrorModels) {
+		mirror(getArgVal("--mirror"), sceneGraph);
+	}
+
+	if (_rotateModels) {
+		rotate(getArgVal("--rotate"), sceneGraph);
+	}
+
+	if (_translateModels) {
+		translate(getArgIvec3("--translate"), sceneGraph);
+	}
+
+	if (!_scriptParameters.empty()) {
+		const core::String &color = getArgVal("--scriptcolor");
+		script(_scriptParameters, sceneGraph, color.toInt());
+	}
+
+	if (_cropModels) {
+		crop(sceneGraph);
+	}
+
+	if (_surfaceOnly) {
+		removeNonSurfaceVoxels(sceneGraph);
+	}
+
+	if (_splitModels) {
+		split(getArgIvec3("--split"), sceneGraph);
+	}
+}
+
+bool VoxConvert::flushModels(scenegraph::SceneGraph &sceneGraph) {
+	scenegraph::SceneGraph batch;
+	scenegraph::addSceneGraphNodes(batch, sceneGraph, batch.root().id());
+	sceneGraph.clear();
+	if (batch.empty()) {
+		return true;
+	}
+	transform(batch);
+	const int batchIdx = _streamedBatches++;
+	for (const core::String &outfile : _outfiles) {
+		const core::String &ext = core::string::extractExtension(outfile);
+		const core::String &filename =
+			core::string::format("%s-%i.%s", core::string::stripExtension(outfile).c_str(), batchIdx, ext.c_str());
+		if (!hasArg("--force") && filesystem()->open(filename)->exists()) {
+			Log::error("Given output file '%s' already exists", filename.c_str());
+			return false;
+		}
+		voxelformat::SaveContext saveCtx;
+		const io::ArchivePtr &archive = io::openFilesystemArchive(io::filesystem());
+		if (!voxelformat::saveFormat(batch, filename, nullptr, archive, saveCtx)) {
+			Log::error("Failed to write to output file '%s'", filename.c_str());
+			return false;
+		}
+		Log::info("Wrote output file %s with %i models", filename.c_str(),
+				  (int)batch.size(scenegraph::SceneGraphNodeType::Model));
+	}
+	return true;
+}
+
 void VoxConvert::split(const glm::ivec3 &size, scenegraph::SceneGraph &sceneGraph) {
 	Log::info("split volumes at %i:%i:%i", size.x, size.y, size.z);
 	const scenegraph::SceneGraph::MergedVolumePalette &merged = sceneGraph.merge();
@@ -943,7 +1029,7 @@ VoxConvert::NodeStats VoxConvert::sceneGraphJsonNode_r(const scenegraph::SceneGr
 			voxel::createContext(type, node.volume(), node.region(), node.palette(), mesh, {0, 0, 0}, mergeQuads,
 								 reuseVertices, ambientOcclusion);
 
-		voxel::extractSurface(ctx);
+		voxel::extractSurfaceParallel(ctx);
 		const size_t vertices = mesh.mesh[0].getNoOfVertices() + mesh.mesh[1].getNoOfVertices();
 		const size_t indices = mesh.mesh[0].getNoOfIndices() + mesh.mesh[1].getNoOfIndices();
 		Log::printf(",\"mesh\": {");
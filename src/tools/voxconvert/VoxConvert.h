@@ -40,6 +40,12 @@ private:
 	bool _printSceneGraph = false;
 	bool _resizeModels = false;
 
+	/** if not @c 0 the models are streamed in batches of this amount of bytes of voxel data to the output files */
+	size_t _memoryLimit = 0u;
+	int _streamedBatches = 0;
+	core::DynamicArray<core::String> _outfiles;
+	core::String _scriptParameters;
+
 	struct NodeStats {
 		int voxels = 0;
 		int vertices = 0;
@@ -82,8 +88,22 @@ protected:
 	void sceneGraphJson(const scenegraph::SceneGraph& sceneGraph, bool printMeshDetails) const;
 	void filterModels(scenegraph::SceneGraph& sceneGraph);
 	void filterModelsByProperty(scenegraph::SceneGraph& sceneGraph, const core::String &property, const core::String &value);
-	void exportModelsIntoSingleObjects(scenegraph::SceneGraph& sceneGraph, const core::String &inputfile, const core::String &ext);
+	/**
+	 * @param[in] archive If given, the models are written as entries of this archive instead of files next to the
+	 * input file
+	 */
+	void exportModelsIntoSingleObjects(scenegraph::SceneGraph &sceneGraph, const core::String &inputfile,
+									   const core::String &ext, const io::ArchivePtr &archive = {});
 	void split(const glm::ivec3 &size, scenegraph::SceneGraph& sceneGraph);
+	/**
+	 * @brief Apply all the model modifications that were given on the command line
+	 */
+	void transform(scenegraph::SceneGraph& sceneGraph);
+	/**
+	 * @brief Take over the model nodes of a scene graph that is still loading, transform them and write them into
+	 * their own output files.
+	 */
+	bool flushModels(scenegraph::SceneGraph& sceneGraph);
 public:
 	VoxConvert(const io::FilesystemPtr& filesystem, const core::TimeProviderPtr& timeProvider);
 
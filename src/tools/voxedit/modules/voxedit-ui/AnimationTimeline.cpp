@@ -186,6 +186,9 @@ bool AnimationTimeline::update(const char *sequencerTitle, double deltaFrameSeco
 		if (maxFrame <= 0) {
 			_play = false;
 		} else {
+			// the whole animation is evaluated once and only looked up during the playback
+			const scenegraph::SceneGraph &sceneGraph = _sceneMgr->sceneGraph();
+			sceneGraph.bakeAnimation(sceneGraph.activeAnimation());
 			// TODO: anim fps
 			currentFrame = (currentFrame + 1) % maxFrame;
 			_sceneMgr->setCurrentFrame(currentFrame);
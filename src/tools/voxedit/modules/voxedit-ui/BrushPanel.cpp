@@ -91,6 +91,30 @@ void BrushPanel::addMirrorPlanes(command::CommandExecutionListener &listener, Br
 	ImGui::PopID();
 }
 
+bool BrushPanel::selectModeRadioButton(const char *title, SelectMode mode, const char *arg,
+									  command::CommandExecutionListener &listener) {
+	const Modifier &modifier = _sceneMgr->modifier();
+	if (ImGui::RadioButton(title, modifier.selectMode() == mode)) {
+		const core::String cmd = core::String::format("selectmode %s", arg);
+		command::executeCommands(cmd, &listener);
+		return true;
+	}
+	return false;
+}
+
+void BrushPanel::addSelectModes(command::CommandExecutionListener &listener) {
+	ImGui::PushID("##selectmodes");
+	selectModeRadioButton(_("Add"), SelectMode::Add, "add", listener);
+	ImGui::TooltipTextUnformatted(_("Add the region to the selection"));
+	ImGui::SameLine();
+	selectModeRadioButton(_("Subtract"), SelectMode::Subtract, "subtract", listener);
+	ImGui::TooltipTextUnformatted(_("Remove the region from the selection"));
+	ImGui::SameLine();
+	selectModeRadioButton(_("Intersect"), SelectMode::Intersect, "intersect", listener);
+	ImGui::TooltipTextUnformatted(_("Only keep the selected voxels inside the region"));
+	ImGui::PopID();
+}
+
 void BrushPanel::stampBrushUseSelection(scenegraph::SceneGraphNode &node, palette::Palette &palette,
 								   command::CommandExecutionListener &listener) {
 	Modifier &modifier = _sceneMgr->modifier();
@@ -403,6 +427,7 @@ void BrushPanel::brushSettings(command::CommandExecutionListener &listener) {
 			ImGui::TextWrappedUnformatted(_("Click on a voxel to pick the color"));
 		} else if (modifier.isMode(ModifierType::Select)) {
 			ImGui::TextWrappedUnformatted(_("Select areas of voxels"));
+			addSelectModes(listener);
 		}
 	}
 }
@@ -8,6 +8,7 @@
 #include "ui/Panel.h"
 #include "math/Axis.h"
 #include "scenegraph/SceneGraphNode.h"
+#include "voxedit-util/modifier/Selection.h"
 
 namespace command {
 struct CommandExecutionListener;
@@ -33,6 +34,9 @@ private:
 	void addShapes(command::CommandExecutionListener &listener);
 	void addMirrorPlanes(command::CommandExecutionListener &listener, Brush &brush);
 	bool mirrorAxisRadioButton(const char *title, math::Axis type, command::CommandExecutionListener &listener, Brush &brush);
+	void addSelectModes(command::CommandExecutionListener &listener);
+	bool selectModeRadioButton(const char *title, SelectMode mode, const char *arg,
+							   command::CommandExecutionListener &listener);
 
 	void stampBrushUseSelection(scenegraph::SceneGraphNode &node, palette::Palette &palette,
 								   command::CommandExecutionListener &listener);
@@ -41,6 +41,8 @@ void fileDialogOptions(video::OpenFileMode mode, const io::FormatDescription *de
 			if (*desc == voxelformat::gltf()) {
 				ImGui::CheckboxVar("KHR_materials_pbrSpecularGlossiness", cfg::VoxFormatGLTF_KHR_materials_pbrSpecularGlossiness);
 				ImGui::CheckboxVar("KHR_materials_specular", cfg::VoxFormatGLTF_KHR_materials_specular);
+				ImGui::CheckboxVar("KHR_mesh_quantization", cfg::VoxFormatGLTF_KHR_mesh_quantization);
+				ImGui::CheckboxVar("EXT_meshopt_compression", cfg::VoxFormatGLTF_EXT_meshopt_compression);
 			}
 			ImGui::CheckboxVar(_("Export materials"), cfg::VoxFormatWithMaterials);
 		} else if (mode == video::OpenFileMode::Open) {
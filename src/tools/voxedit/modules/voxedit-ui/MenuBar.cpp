@@ -126,6 +126,10 @@ bool MenuBar::update(ui::IMGUIApp *app, command::CommandExecutionListener &liste
 				static const core::Array<core::String, (int)voxel::SurfaceExtractionType::Max> meshModes = {
 					_("Cubes"), _("Marching cubes")};
 				ImGui::ComboVar(_("Mesh mode"), cfg::VoxelMeshMode, meshModes);
+				ImGui::CheckboxVar(_("Chunk level of detail"), cfg::VoxelMeshLod);
+				ImGui::BeginDisabled(!core::Var::get(cfg::VoxelMeshLod)->boolVal());
+				ImGui::InputVarFloat(_("Level of detail distance"), cfg::VoxelMeshLodDistance);
+				ImGui::EndDisabled();
 				ImGui::InputVarInt(_("Model animation speed"), cfg::VoxEditAnimationSpeed);
 				ImGui::InputVarInt(_("Autosave delay in seconds"), cfg::VoxEditAutoSaveSeconds);
 				ImGui::InputVarInt(_("Viewports"), cfg::VoxEditViewports, 1, 1);
@@ -363,6 +363,10 @@ void Viewport::menuBarView(command::CommandExecutionListener *listener) {
 			}
 			ImGui::EndCombo();
 		}
+		ImGui::Text(_("Draw calls: %u"), _renderContext.drawCalls);
+		ImGui::TooltipText(_("Nodes that share a mesh (like references) are rendered with one draw call\n"
+							 "Rendered instances: %u"),
+						   _renderContext.instances);
 		MenuBar::viewportOptions();
 		ImGui::EndMenu();
 	}
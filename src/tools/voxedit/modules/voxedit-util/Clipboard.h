@@ -4,14 +4,20 @@
 
 #pragma once
 
-#include "modifier/Selection.h"
+#include "voxel/BitVolume.h"
 #include "voxel/VoxelData.h"
 
 namespace voxedit {
 namespace tool {
 
-voxel::VoxelData copy(const voxel::VoxelData &voxelData, const Selections &selections);
-voxel::VoxelData cut(voxel::VoxelData &voxelData, const Selections &selections, voxel::Region &modifiedRegion);
+/**
+ * @brief Copies the selected voxels into a new volume that covers the bounds of the selection
+ */
+voxel::VoxelData copy(const voxel::VoxelData &voxelData, const voxel::BitVolume &selection);
+/**
+ * @brief Copies the selected voxels and removes them from the given volume
+ */
+voxel::VoxelData cut(voxel::VoxelData &voxelData, const voxel::BitVolume &selection, voxel::Region &modifiedRegion);
 void paste(voxel::VoxelData &out, const voxel::VoxelData &in, const glm::ivec3 &referencePosition,
 		   voxel::Region &modifiedRegion);
 
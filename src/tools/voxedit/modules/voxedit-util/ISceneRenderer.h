@@ -40,6 +40,11 @@ public:
 	}
 	virtual void removeNode(int nodeId) {
 	}
+	/**
+	 * @brief Node properties that the scene graph doesn't track were changed - e.g. the visibility
+	 */
+	virtual void nodeChanged(int nodeId) {
+	}
 	/**
 	 * @brief Before calling this, make sure to set the SceneGraph pointer in the RenderContext
 	 */
@@ -423,17 +423,6 @@ bool SceneManager::save(const io::FileDescription& file, bool autosave) {
 	return false;
 }
 
-static void mergeIfNeeded(scenegraph::SceneGraph &newSceneGraph) {
-	if (newSceneGraph.size() > voxel::MAX_VOLUMES) {
-		const scenegraph::SceneGraph::MergedVolumePalette &merged = newSceneGraph.merge();
-		newSceneGraph.clear();
-		scenegraph::SceneGraphNode newNode;
-		newNode.setVolume(merged.first, true);
-		newNode.setPalette(merged.second);
-		newSceneGraph.emplace(core::move(newNode));
-	}
-}
-
 bool SceneManager::import(const core::String& file) {
 	if (file.empty()) {
 		Log::error("Can't import model: No file given");
@@ -448,7 +437,6 @@ bool SceneManager::import(const core::String& file) {
 		Log::error("Failed to load %s", file.c_str());
 		return false;
 	}
-	mergeIfNeeded(newSceneGraph);
 
 	scenegraph::SceneGraphNode groupNode(scenegraph::SceneGraphNodeType::Group);
 	groupNode.setName(core::string::extractFilename(file));
@@ -490,7 +478,6 @@ bool SceneManager::importDirectory(const core::String& directory, const io::Form
 		if (!voxelformat::loadFormat(fileDesc, archive, newSceneGraph, loadCtx)) {
 			Log::error("Failed to load %s", e.fullPath.c_str());
 		} else {
-			mergeIfNeeded(newSceneGraph);
 			for (auto iter = newSceneGraph.beginModel(); iter != newSceneGraph.end(); ++iter) {
 				scenegraph::SceneGraphNode &node = *iter;
 				state |= moveNodeToSceneGraph(node, importGroupNodeId) != InvalidNodeId;
@@ -513,7 +500,6 @@ bool SceneManager::load(const io::FileDescription& file) {
 		scenegraph::SceneGraph newSceneGraph;
 		voxelformat::LoadContext loadCtx;
 		voxelformat::loadFormat(file, archive, newSceneGraph, loadCtx);
-		mergeIfNeeded(newSceneGraph);
 		/**
 		 * @todo stuff that happens in MeshState::scheduleRegionExtraction() and
 		 * MeshState::runScheduledExtractions() should happen here
@@ -530,7 +516,6 @@ bool SceneManager::load(const io::FileDescription& file, const uint8_t *data, si
 	archive->add(file.name, data, size);
 	voxelformat::LoadContext loadCtx;
 	voxelformat::loadFormat(file, archive, newSceneGraph, loadCtx);
-	mergeIfNeeded(newSceneGraph);
 	if (loadSceneGraph(core::move(newSceneGraph))) {
 		_needAutoSave = false;
 		_dirty = false;
@@ -565,6 +550,9 @@ void SceneManager::modified(int nodeId, const voxel::Region& modifiedRegion, boo
 	}
 	if (modifiedRegion.isValid()) {
 		_sceneRenderer->updateNodeRegion(nodeId, modifiedRegion, renderRegionMillis);
+		if (_occupancyVolume != nullptr && _occupancyVolume == volume(nodeId)) {
+			_occupancy.update(*_occupancyVolume, modifiedRegion);
+		}
 	}
 	markDirty();
 	resetLastTrace();
@@ -1036,8 +1024,8 @@ bool SceneManager::saveSelection(const io::FileDescription& file) {
 }
 
 bool SceneManager::copy() {
-	const Selections& selections = _modifierFacade.selections();
-	if (selections.empty()) {
+	const voxel::BitVolume &selection = _modifierFacade.selectionMask();
+	if (selection.empty()) {
 		return false;
 	}
 	const int nodeId = activeNode();
@@ -1046,7 +1034,7 @@ bool SceneManager::copy() {
 		return false;
 	}
 	voxel::VoxelData voxelData(node.volume(), node.palette(), false);
-	_copy = voxedit::tool::copy(voxelData, selections);
+	_copy = voxedit::tool::copy(voxelData, selection);
 	return _copy;
 }
 
@@ -1087,8 +1075,8 @@ bool SceneManager::paste(const glm::ivec3& pos) {
 }
 
 bool SceneManager::cut() {
-	const Selections& selections = _modifierFacade.selections();
-	if (selections.empty()) {
+	const voxel::BitVolume &selection = _modifierFacade.selectionMask();
+	if (selection.empty()) {
 		Log::debug("Nothing selected - failed to cut");
 		return false;
 	}
@@ -1099,7 +1087,7 @@ bool SceneManager::cut() {
 	}
 	voxel::Region modifiedRegion;
 	voxel::VoxelData voxelData(node.volume(), node.palette(), false);
-	_copy = voxedit::tool::cut(voxelData, selections, modifiedRegion);
+	_copy = voxedit::tool::cut(voxelData, selection, modifiedRegion);
 	if (!_copy) {
 		Log::debug("Failed to cut");
 		return false;
@@ -1223,6 +1211,7 @@ void SceneManager::resetSceneState() {
 	}
 	_dirty = false;
 	_result = voxelutil::PickResult();
+	_occupancyVolume = nullptr;
 	_modifierFacade.setCursorVoxel(voxel::createVoxel(node.palette(), 0));
 	setCursorPosition(cursorPosition(), true);
 	setReferencePosition(node.region().getCenter());
@@ -1417,6 +1406,7 @@ bool SceneManager::setSceneGraphNodeVolume(scenegraph::SceneGraphNode &node, vox
 	node.setVolume(volume, true);
 	// the old volume pointer might no longer be used
 	_sceneRenderer->removeNode(node.id());
+	_occupancyVolume = nullptr;
 
 	const voxel::Region& region = volume->region();
 	updateGridRenderer(region);
@@ -2118,41 +2108,41 @@ void SceneManager::construct() {
 	command::Command::registerCommand("nodetogglevisible", [&](const command::CmdArgs &args) {
 		const int nodeId = args.size() > 0 ? core::string::toInt(args[0]) : activeNode();
 		if (scenegraph::SceneGraphNode *node = sceneGraphNode(nodeId)) {
-			node->setVisible(!node->visible());
+			setNodeVisible(*node, !node->visible());
 		}
 	}).setHelp(_("Toggle the visible state of a node")).setArgumentCompleter(nodeCompleter(_sceneGraph));
 
 	command::Command::registerCommand("showall", [&] (const command::CmdArgs& args) {
 		for (auto iter = _sceneGraph.beginAll(); iter != _sceneGraph.end(); ++iter) {
 			scenegraph::SceneGraphNode &node = *iter;
-			node.setVisible(true);
+			setNodeVisible(node, true);
 		}
 	}).setHelp(_("Show all nodes"));
 
 	command::Command::registerCommand("hideall", [&](const command::CmdArgs &args) {
 		for (auto iter = _sceneGraph.beginAll(); iter != _sceneGraph.end(); ++iter) {
 			scenegraph::SceneGraphNode &node = *iter;
-			node.setVisible(false);
+			setNodeVisible(node, false);
 		}
 	}).setHelp(_("Hide all nodes"));
 
 	command::Command::registerCommand("nodeshowallchildren", [&] (const command::CmdArgs& args) {
 		const int nodeId = args.size() > 0 ? core::string::toInt(args[0]) : activeNode();
-		_sceneGraph.visitChildren(nodeId, true, [] (scenegraph::SceneGraphNode &node) {
-			node.setVisible(true);
+		_sceneGraph.visitChildren(nodeId, true, [this] (scenegraph::SceneGraphNode &node) {
+			setNodeVisible(node, true);
 		});
 		if (scenegraph::SceneGraphNode *node = sceneGraphNode(nodeId)) {
-			node->setVisible(true);
+			setNodeVisible(*node, true);
 		}
 	}).setHelp(_("Show all children nodes"));
 
 	command::Command::registerCommand("nodehideallchildren", [&](const command::CmdArgs &args) {
 		const int nodeId = args.size() > 0 ? core::string::toInt(args[0]) : activeNode();
-		_sceneGraph.visitChildren(nodeId, true, [] (scenegraph::SceneGraphNode &node) {
-			node.setVisible(false);
+		_sceneGraph.visitChildren(nodeId, true, [this] (scenegraph::SceneGraphNode &node) {
+			setNodeVisible(node, false);
 		});
 		if (scenegraph::SceneGraphNode *node = sceneGraphNode(nodeId)) {
-			node->setVisible(false);
+			setNodeVisible(*node, false);
 		}
 	}).setHelp(_("Hide all children nodes"));
 
@@ -2161,10 +2151,10 @@ void SceneManager::construct() {
 		for (auto iter = _sceneGraph.beginAll(); iter != _sceneGraph.end(); ++iter) {
 			scenegraph::SceneGraphNode &node = *iter;
 			if (node.id() == nodeId) {
-				node.setVisible(true);
+				setNodeVisible(node, true);
 				continue;
 			}
-			node.setVisible(false);
+			setNodeVisible(node, false);
 		}
 	}).setHelp(_("Hide all model nodes except the active one")).setArgumentCompleter(nodeCompleter(_sceneGraph));
 
@@ -2363,7 +2353,8 @@ bool SceneManager::runScript(const core::String& luaCode, const core::DynamicArr
 	}
 	const int nodeId = _sceneGraph.activeNode();
 	const voxel::Region &region = _sceneGraph.resolveRegion(_sceneGraph.node(nodeId));
-	if (!_luaApi.exec(luaCode, _sceneGraph, nodeId, region, _modifierFacade.cursorVoxel(), dirtyRegion, args)) {
+	if (!_luaApi.exec(luaCode, _sceneGraph, nodeId, region, _modifierFacade.cursorVoxel(), dirtyRegion, args,
+					  &_modifierFacade.selectionMask())) {
 		return false;
 	}
 	if (dirtyRegion.isValid()) {
@@ -2396,7 +2387,7 @@ void SceneManager::animate(double nowSeconds) {
 
 	scenegraph::SceneGraphNode &prev = _sceneGraph.node(_currentAnimationNodeId);
 	if (prev.isAnyModelNode()) {
-		prev.setVisible(false);
+		setNodeVisible(prev, false);
 	}
 
 	_currentAnimationNodeId = _sceneGraph.nextModelNode(_currentAnimationNodeId);
@@ -2409,7 +2400,7 @@ void SceneManager::animate(double nowSeconds) {
 	}
 	scenegraph::SceneGraphNode &node = _sceneGraph.node(_currentAnimationNodeId);
 	if (node.isAnyModelNode()) {
-		node.setVisible(true);
+		setNodeVisible(node, true);
 	}
 	if (_animationResetCamera) {
 		command::Command::execute("resetcamera");
@@ -2736,7 +2727,7 @@ bool SceneManager::mouseRayTrace(bool force) {
 	const math::Axis lockedAxis = _modifierFacade.lockedAxis();
 	// TODO: we could optionally limit the raycast to the selection
 
-	voxelutil::raycastWithDirection(v, ray.origin, dirWithLength, [&] (voxel::RawVolume::Sampler& sampler) {
+	auto callback = [&] (voxel::RawVolume::Sampler& sampler) {
 		if (!_result.firstValidPosition && sampler.currentPositionValid()) {
 			_result.firstPosition = sampler.position();
 			_result.firstValidPosition = true;
@@ -2778,7 +2769,18 @@ bool SceneManager::mouseRayTrace(bool force) {
 			return false;
 		}
 		return true;
-	});
+	};
+
+	if (lockedAxis != math::Axis::None) {
+		// the trace must visit every voxel to find the plane of the locked axis
+		voxelutil::raycastWithDirection(v, ray.origin, dirWithLength, callback);
+	} else {
+		if (_occupancyVolume != v) {
+			_occupancy.build(*v);
+			_occupancyVolume = v;
+		}
+		voxelutil::raycastWithDirection(v, _occupancy, ray.origin, dirWithLength, callback);
+	}
 
 	if (_result.firstInvalidPosition) {
 		_result.hitFace = voxel::raycastFaceDetection(ray.origin, ray.direction, _result.hitVoxel, 0.0f, 1.0f);
@@ -3077,12 +3079,17 @@ bool SceneManager::nodeRename(scenegraph::SceneGraphNode &node, const core::Stri
 	return true;
 }
 
+void SceneManager::setNodeVisible(scenegraph::SceneGraphNode &node, bool visible) {
+	node.setVisible(visible);
+	_sceneRenderer->nodeChanged(node.id());
+}
+
 bool SceneManager::nodeSetVisible(int nodeId, bool visible) {
 	if (scenegraph::SceneGraphNode *node = sceneGraphNode(nodeId)) {
-		node->setVisible(visible);
+		setNodeVisible(*node, visible);
 		if (node->type() == scenegraph::SceneGraphNodeType::Group) {
-			_sceneGraph.visitChildren(nodeId, true, [visible] (scenegraph::SceneGraphNode &node) {
-				node.setVisible(visible);
+			_sceneGraph.visitChildren(nodeId, true, [this, visible] (scenegraph::SceneGraphNode &node) {
+				setNodeVisible(node, visible);
 			});
 		}
 		return true;
@@ -3132,6 +3139,7 @@ bool SceneManager::nodeRemove(scenegraph::SceneGraphNode &node, bool recursive)
 		return false;
 	}
 	_sceneRenderer->removeNode(nodeId);
+	_occupancyVolume = nullptr;
 	if (_sceneGraph.empty()) {
 		const voxel::Region region(glm::ivec3(0), glm::ivec3(31));
 		scenegraph::SceneGraphNode newNode(scenegraph::SceneGraphNodeType::Model);
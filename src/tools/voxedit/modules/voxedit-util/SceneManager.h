@@ -20,6 +20,7 @@
 #include "util/Movement.h"
 #include "voxedit-util/Clipboard.h"
 #include "voxedit-util/modifier/IModifierRenderer.h"
+#include "voxel/OccupancyPyramid.h"
 #include "voxel/RawVolume.h"
 #include "voxel/Voxel.h"
 #include "voxelformat/Format.h"
@@ -115,6 +116,12 @@ private:
 	command::ActionButton _zoomOut;
 
 	voxelutil::PickResult _result;
+	/**
+	 * The occupancy of the volume the mouse ray trace was last executed on - this allows the trace to skip the
+	 * empty areas of large volumes. It's updated for every modification that is passed to @c modified()
+	 */
+	voxel::OccupancyPyramid _occupancy;
+	const voxel::RawVolume *_occupancyVolume = nullptr;
 
 	/**
 	 * @note This might return @c nullptr in the case where the active node is no model node
@@ -141,12 +148,20 @@ private:
 	void updateGridRenderer(const voxel::Region &region);
 	void updateDirtyRendererStates();
 	void zoom(video::Camera &camera, float level) const;
+
+protected:
 	bool mouseRayTrace(bool force);
 	void updateCursor();
+	/**
+	 * @return The id of the model node that is hit by the mouse ray - or @c InvalidNodeId
+	 * @note The active node is not taken into account
+	 */
 	int traceScene();
-
-protected:
 	bool setSceneGraphNodeVolume(scenegraph::SceneGraphNode &node, voxel::RawVolume *volume);
+	/**
+	 * @brief Changes the visibility and lets the renderer know about it - the scene graph doesn't track it
+	 */
+	void setNodeVisible(scenegraph::SceneGraphNode &node, bool visible);
 	bool loadSceneGraph(scenegraph::SceneGraph &&sceneGraph);
 	int activeNode() const;
 
@@ -266,6 +266,10 @@ void SceneRenderer::removeNode(int nodeId) {
 	_volumeRenderer.nodeRemove(nodeId);
 }
 
+void SceneRenderer::nodeChanged(int nodeId) {
+	_volumeRenderer.nodeChanged(nodeId);
+}
+
 void SceneRenderer::update() {
 	_gridRenderer.setRenderAABB(_showAABB->boolVal());
 	_gridRenderer.setRenderGrid(_showGrid->boolVal());
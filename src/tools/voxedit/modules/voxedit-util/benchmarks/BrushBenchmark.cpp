@@ -0,0 +1,113 @@
+/**
+ * @file
+ * @brief Box fills of a 256x256x256 volume through the modifier volume wrapper
+ */
+
+#include "app/benchmark/AbstractBenchmark.h"
+#include "scenegraph/SceneGraph.h"
+#include "scenegraph/SceneGraphNode.h"
+#include "voxedit-util/modifier/ModifierVolumeWrapper.h"
+#include "voxedit-util/modifier/brush/ShapeBrush.h"
+#include "voxel/BitVolume.h"
+#include "voxel/RawVolume.h"
+
+namespace voxedit {
+
+class BrushBenchmark : public app::AbstractBenchmark {
+protected:
+	const voxel::Region _region{0, 255};
+	voxel::RawVolume *_volume = nullptr;
+	scenegraph::SceneGraph _sceneGraph;
+	scenegraph::SceneGraphNode _node{scenegraph::SceneGraphNodeType::Model};
+	int _color = 0;
+
+	// the override modifier writes every voxel - the color changes with every iteration to not skip the same voxels
+	voxel::Voxel nextVoxel() {
+		_color = (_color + 1) % 255;
+		return voxel::createVoxel(voxel::VoxelType::Generic, _color + 1);
+	}
+
+	void fillShape(ModifierVolumeWrapper &wrapper, const voxel::Voxel &voxel) {
+		ShapeBrush brush;
+		brush.init();
+		BrushContext brushContext;
+		brushContext.cursorVoxel = voxel;
+		brushContext.cursorFace = voxel::FaceNames::PositiveY;
+		brushContext.modifierType = wrapper.modifierType();
+		brushContext.cursorPosition = _region.getLowerCorner();
+		brush.start(brushContext);
+		brushContext.cursorPosition = _region.getUpperCorner();
+		brush.step(brushContext);
+		brush.preExecute(brushContext, wrapper.volume());
+		brush.execute(_sceneGraph, wrapper, brushContext);
+		brush.postExecute(brushContext);
+		brush.shutdown();
+	}
+
+	void reportVoxels(benchmark::State &state) {
+		const glm::ivec3 &dim = _region.getDimensionsInVoxels();
+		state.counters["voxels_per_second"] = benchmark::Counter(
+			(double)state.iterations() * dim.x * dim.y * dim.z, benchmark::Counter::kIsRate);
+	}
+
+public:
+	void SetUp(::benchmark::State &state) override {
+		app::AbstractBenchmark::SetUp(state);
+		_volume = new voxel::RawVolume(_region);
+		_node.setVolume(_volume, false);
+	}
+
+	void TearDown(::benchmark::State &state) override {
+		_node.setVolume(nullptr, false);
+		delete _volume;
+		_volume = nullptr;
+		app::AbstractBenchmark::TearDown(state);
+	}
+};
+
+// the previous code path: one virtual setVoxel call with all the checks per voxel
+BENCHMARK_DEFINE_F(BrushBenchmark, FillPerVoxel)(benchmark::State &state) {
+	for (auto _ : state) {
+		ModifierVolumeWrapper wrapper(_node, ModifierType::Override);
+		const voxel::Voxel voxel = nextVoxel();
+		for (int z = _region.getLowerZ(); z <= _region.getUpperZ(); ++z) {
+			for (int y = _region.getLowerY(); y <= _region.getUpperY(); ++y) {
+				for (int x = _region.getLowerX(); x <= _region.getUpperX(); ++x) {
+					wrapper.setVoxel(x, y, z, voxel);
+				}
+			}
+		}
+		voxel::Region dirtyRegion = wrapper.dirtyRegion();
+		benchmark::DoNotOptimize(dirtyRegion);
+	}
+	reportVoxels(state);
+}
+
+BENCHMARK_DEFINE_F(BrushBenchmark, FillShapeBrush)(benchmark::State &state) {
+	for (auto _ : state) {
+		ModifierVolumeWrapper wrapper(_node, ModifierType::Override);
+		fillShape(wrapper, nextVoxel());
+		voxel::Region dirtyRegion = wrapper.dirtyRegion();
+		benchmark::DoNotOptimize(dirtyRegion);
+	}
+	reportVoxels(state);
+}
+
+BENCHMARK_DEFINE_F(BrushBenchmark, FillShapeBrushSelection)(benchmark::State &state) {
+	voxel::BitVolume selection;
+	selection.add(voxel::Region(glm::ivec3(0), glm::ivec3(127, 255, 255)));
+	selection.add(voxel::Region(glm::ivec3(130, 10, 10), glm::ivec3(250, 200, 200)));
+	for (auto _ : state) {
+		ModifierVolumeWrapper wrapper(_node, ModifierType::Override, &selection);
+		fillShape(wrapper, nextVoxel());
+		voxel::Region dirtyRegion = wrapper.dirtyRegion();
+		benchmark::DoNotOptimize(dirtyRegion);
+	}
+	reportVoxels(state);
+}
+
+BENCHMARK_REGISTER_F(BrushBenchmark, FillPerVoxel)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(BrushBenchmark, FillShapeBrush)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(BrushBenchmark, FillShapeBrushSelection)->Unit(benchmark::kMillisecond);
+
+} // namespace voxedit
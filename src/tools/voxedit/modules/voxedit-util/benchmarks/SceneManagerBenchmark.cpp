@@ -0,0 +1,262 @@
+/**
+ * @file
+ * @brief Replays camera and mouse paths through the scene manager trace and modifier code without a renderer
+ */
+
+#include "app/benchmark/AbstractBenchmark.h"
+#include "core/Algorithm.h"
+#include "core/TimeProvider.h"
+#include "core/collection/DynamicArray.h"
+#include "scenegraph/SceneGraph.h"
+#include "scenegraph/SceneGraphNode.h"
+#include "video/Camera.h"
+#include "voxedit-util/Config.h"
+#include "voxedit-util/ISceneRenderer.h"
+#include "voxedit-util/SceneManager.h"
+#include "voxedit-util/modifier/IModifierRenderer.h"
+#include "voxel/RawVolume.h"
+#include "voxel/SurfaceExtractor.h"
+#include <glm/trigonometric.hpp>
+
+namespace voxedit {
+
+class SceneManagerBenchmarkEx : public SceneManager {
+public:
+	SceneManagerBenchmarkEx(const core::TimeProviderPtr &timeProvider, const io::FilesystemPtr &filesystem,
+							const SceneRendererPtr &sceneRenderer, const ModifierRendererPtr &modifierRenderer)
+		: SceneManager(timeProvider, filesystem, sceneRenderer, modifierRenderer) {
+	}
+	bool loadForBenchmark(scenegraph::SceneGraph &&sceneGraph) {
+		return loadSceneGraph(core::move(sceneGraph));
+	}
+	int traceSceneForBenchmark() {
+		return traceScene();
+	}
+};
+
+/**
+ * @brief A key of a recorded camera and mouse path - the frames between the keys are interpolated
+ */
+struct PathKey {
+	// camera rotation around the scene center in degree
+	float yaw;
+	float pitch;
+	// camera distance in multiples of the scene size
+	float distance;
+	// normalized mouse position in the viewport
+	glm::vec2 mouse;
+};
+
+// orbit around the scene while sweeping the mouse over the terrain - the last key is the first one to close the loop
+static const PathKey CameraPath[] = {
+	{30.0f, 35.0f, 1.2f, {0.50f, 0.50f}}, {60.0f, 40.0f, 1.1f, {0.30f, 0.60f}},
+	{95.0f, 30.0f, 0.9f, {0.70f, 0.55f}}, {140.0f, 55.0f, 1.0f, {0.45f, 0.35f}},
+	{190.0f, 25.0f, 1.4f, {0.20f, 0.70f}}, {250.0f, 45.0f, 0.8f, {0.60f, 0.45f}},
+	{300.0f, 60.0f, 1.0f, {0.85f, 0.65f}}, {390.0f, 35.0f, 1.2f, {0.50f, 0.50f}}};
+static const int FramesPerKey = 30;
+static const glm::ivec2 ViewportSize(1280, 720);
+
+struct PathFrame {
+	glm::vec3 cameraPos;
+	glm::ivec2 mouse;
+};
+
+class SceneManagerBenchmark : public app::AbstractBenchmark {
+protected:
+	core::SharedPtr<SceneManagerBenchmarkEx> _sceneMgr;
+	video::Camera _camera;
+	core::DynamicArray<PathFrame> _frames;
+	core::DynamicArray<double> _frameMicros;
+	glm::vec3 _center{0.0f};
+	double _nowSeconds = 0.0;
+
+	static voxel::RawVolume *createTerrain(const voxel::Region &region) {
+		voxel::RawVolume *v = new voxel::RawVolume(region);
+		const glm::ivec3 &mins = region.getLowerCorner();
+		const glm::ivec3 dim = region.getDimensionsInVoxels();
+		for (int x = 0; x < dim.x; ++x) {
+			for (int z = 0; z < dim.z; ++z) {
+				const float h = 0.5f + 0.25f * glm::sin((float)x * 0.11f) + 0.2f * glm::cos((float)z * 0.07f);
+				const int height = glm::clamp((int)(h * (float)dim.y), 1, dim.y);
+				const voxel::Voxel voxel = voxel::createVoxel(voxel::VoxelType::Generic, 1 + (x + z) % 8);
+				for (int y = 0; y < height; ++y) {
+					v->setVoxel(mins.x + x, mins.y + y, mins.z + z, voxel);
+				}
+			}
+		}
+		return v;
+	}
+
+	/**
+	 * @brief Creates a 2x2 grid of terrain model nodes with the given size
+	 */
+	void loadScene(int size) {
+		scenegraph::SceneGraph sceneGraph;
+		for (int i = 0; i < 4; ++i) {
+			const glm::ivec3 mins((i % 2) * size, 0, (i / 2) * size);
+			const voxel::Region region(mins, mins + glm::ivec3(size - 1, size / 2 - 1, size - 1));
+			scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
+			node.setVolume(createTerrain(region), true);
+			node.setName(core::string::format("terrain %i", i));
+			sceneGraph.emplace(core::move(node));
+		}
+		_sceneMgr->loadForBenchmark(core::move(sceneGraph));
+		_sceneMgr->nodeActivate(_sceneMgr->sceneGraph().firstModelNode()->id());
+		_center = glm::vec3((float)size, (float)size / 4.0f, (float)size);
+		buildFrames((float)size * 2.0f);
+	}
+
+	void buildFrames(float sceneSize) {
+		_frames.clear();
+		for (int k = 0; k < lengthof(CameraPath) - 1; ++k) {
+			const PathKey &from = CameraPath[k];
+			const PathKey &to = CameraPath[k + 1];
+			for (int i = 0; i < FramesPerKey; ++i) {
+				const float t = (float)i / (float)FramesPerKey;
+				const float yaw = glm::radians(glm::mix(from.yaw, to.yaw, t));
+				const float pitch = glm::radians(glm::mix(from.pitch, to.pitch, t));
+				const float distance = glm::mix(from.distance, to.distance, t) * sceneSize;
+				const glm::vec3 dir(glm::cos(pitch) * glm::sin(yaw), glm::sin(pitch), glm::cos(pitch) * glm::cos(yaw));
+				const glm::vec2 mouse = glm::mix(from.mouse, to.mouse, t) * glm::vec2(ViewportSize);
+				_frames.push_back({_center + dir * distance, glm::ivec2(mouse)});
+			}
+		}
+	}
+
+	void applyFrame(const PathFrame &frame) {
+		_camera.setWorldPosition(frame.cameraPos);
+		_camera.lookAt(_center);
+		_camera.update(0.0);
+		_sceneMgr->setMousePos(frame.mouse.x, frame.mouse.y);
+		_sceneMgr->setActiveCamera(&_camera);
+	}
+
+	/**
+	 * @brief Replays all frames of the path and records the latency of every frame
+	 */
+	template<class FUNC>
+	void replay(FUNC &&func) {
+		const double resolution = (double)core::TimeProvider::highResTimeResolution();
+		for (const PathFrame &frame : _frames) {
+			const uint64_t start = core::TimeProvider::highResTime();
+			applyFrame(frame);
+			func();
+			_nowSeconds += 1.0 / 60.0;
+			_sceneMgr->update(_nowSeconds);
+			const uint64_t end = core::TimeProvider::highResTime();
+			_frameMicros.push_back((double)(end - start) * 1000000.0 / resolution);
+		}
+	}
+
+	void reportPercentiles(benchmark::State &state) {
+		if (_frameMicros.empty()) {
+			return;
+		}
+		core::sort(_frameMicros.begin(), _frameMicros.end(), core::Less<double>());
+		auto percentile = [&](double p) {
+			const size_t idx = (size_t)(p * (double)(_frameMicros.size() - 1));
+			return _frameMicros[idx];
+		};
+		state.counters["p50_us"] = percentile(0.5);
+		state.counters["p90_us"] = percentile(0.9);
+		state.counters["p99_us"] = percentile(0.99);
+		state.counters["max_us"] = _frameMicros.back();
+		state.counters["frames_per_second"] =
+			benchmark::Counter((double)_frameMicros.size(), benchmark::Counter::kIsRate);
+	}
+
+public:
+	void SetUp(::benchmark::State &state) override {
+		app::AbstractBenchmark::SetUp(state);
+		const auto timeProvider = core::make_shared<core::TimeProvider>();
+		const auto sceneRenderer = core::make_shared<ISceneRenderer>();
+		const auto modifierRenderer = core::make_shared<IModifierRenderer>();
+		_sceneMgr = core::make_shared<SceneManagerBenchmarkEx>(timeProvider, _benchmarkApp->filesystem(),
+															   sceneRenderer, modifierRenderer);
+		core::Var::get(cfg::VoxEditShowgrid, "true");
+		core::Var::get(cfg::VoxEditShowlockedaxis, "true");
+		core::Var::get(cfg::VoxEditRendershadow, "true");
+		core::Var::get(cfg::VoxEditGridsize, "1");
+		core::Var::get(cfg::VoxelMeshMode, core::string::toString((int)voxel::SurfaceExtractionType::Cubic));
+		core::Var::get(cfg::VoxelMeshSize, "64", core::CV_READONLY);
+		core::Var::get(cfg::VoxEditShowaabb, "");
+		core::Var::get(cfg::VoxEditShowBones, "");
+		core::Var::get(cfg::VoxEditGrayInactive, "");
+		core::Var::get(cfg::VoxEditHideInactive, "");
+		core::Var::get(cfg::VoxEditLastPalette, "");
+		core::Var::get(cfg::VoxEditModificationDismissMillis, "0");
+		// no autosaves while replaying the paths
+		core::Var::get(cfg::VoxEditAutoSaveSeconds, "0");
+		_sceneMgr->construct();
+		if (!_sceneMgr->init()) {
+			state.SkipWithError("Failed to initialize the scene manager");
+			return;
+		}
+		_camera.setSize(ViewportSize);
+		_camera.setFarPlane(5000.0f);
+		_frameMicros.clear();
+		_nowSeconds = 0.0;
+		loadScene((int)state.range(0));
+
+		Modifier &modifier = _sceneMgr->modifier();
+		modifier.setCursorVoxel(voxel::createVoxel(voxel::VoxelType::Generic, 1));
+		modifier.setBrushType(BrushType::Shape);
+		modifier.setModifierType(ModifierType::Place);
+	}
+
+	void TearDown(::benchmark::State &state) override {
+		_sceneMgr->shutdown();
+		_sceneMgr.release();
+		app::AbstractBenchmark::TearDown(state);
+	}
+};
+
+// hovering in edit mode: mouse ray trace, cursor update and the brush preview of a single voxel placement
+BENCHMARK_DEFINE_F(SceneManagerBenchmark, EditModeTrace)(benchmark::State &state) {
+	Modifier &modifier = _sceneMgr->modifier();
+	modifier.shapeBrush().setSingleMode();
+	palette::Palette &palette = _sceneMgr->activePalette();
+	for (auto _ : state) {
+		replay([&]() {
+			_sceneMgr->trace(false);
+			_sceneMgr->modifier().updateBrushPreview(palette);
+		});
+	}
+	reportPercentiles(state);
+}
+
+// dragging a shape in edit mode: the brush preview volume is regenerated whenever the cursor moves
+BENCHMARK_DEFINE_F(SceneManagerBenchmark, EditModeDrag)(benchmark::State &state) {
+	Modifier &modifier = _sceneMgr->modifier();
+	palette::Palette &palette = _sceneMgr->activePalette();
+	for (auto _ : state) {
+		applyFrame(_frames.front());
+		_sceneMgr->trace(false, true);
+		modifier.start();
+		replay([&]() {
+			_sceneMgr->trace(false);
+			_sceneMgr->modifier().updateBrushPreview(palette);
+		});
+		modifier.stop();
+	}
+	reportPercentiles(state);
+}
+
+// hovering in scene mode: picking the model node under the mouse cursor
+BENCHMARK_DEFINE_F(SceneManagerBenchmark, SceneModeTrace)(benchmark::State &state) {
+	for (auto _ : state) {
+		replay([&]() {
+			int nodeId = _sceneMgr->traceSceneForBenchmark();
+			benchmark::DoNotOptimize(nodeId);
+		});
+	}
+	reportPercentiles(state);
+}
+
+BENCHMARK_REGISTER_F(SceneManagerBenchmark, EditModeTrace)->Arg(32)->Arg(128)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(SceneManagerBenchmark, EditModeDrag)->Arg(32)->Arg(128)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(SceneManagerBenchmark, SceneModeTrace)->Arg(32)->Arg(128)->Unit(benchmark::kMillisecond);
+
+} // namespace voxedit
+
+BENCHMARK_MAIN();
@@ -45,6 +45,23 @@ void Modifier::construct() {
 		setModifierType(ModifierType::Select);
 	}).setHelp(_("Change the modifier type to 'select'"));
 
+	command::Command::registerCommand("selectmode", [&](const command::CmdArgs &args) {
+		if (args.empty()) {
+			Log::info("Usage: selectmode [add|subtract|intersect]");
+			return;
+		}
+		if (args[0] == "add") {
+			setSelectMode(SelectMode::Add);
+		} else if (args[0] == "subtract") {
+			setSelectMode(SelectMode::Subtract);
+		} else if (args[0] == "intersect") {
+			setSelectMode(SelectMode::Intersect);
+		} else {
+			Log::warn("Unknown select mode: %s", args[0].c_str());
+		}
+	}).setHelp(_("Change how new selections are combined with the current selection"))
+		.setArgumentCompleter(command::valueCompleter({"add", "subtract", "intersect"}));
+
 	command::Command::registerCommand("actioncolorpicker", [&](const command::CmdArgs &args) {
 		setModifierType(ModifierType::ColorPicker);
 	}).setHelp(_("Change the modifier type to 'color picker'"));
@@ -156,6 +173,7 @@ void Modifier::update(double nowSeconds) {
 
 void Modifier::reset() {
 	unselect();
+	_selectMode = SelectMode::Add;
 	_brushContext.gridResolution = 1;
 	_brushContext.cursorPosition = glm::ivec3(0);
 	_brushContext.cursorFace = voxel::FaceNames::Max;
@@ -198,12 +216,35 @@ void Modifier::invert(const voxel::Region &region) {
 	if (!_selectionValid) {
 		select(region.getLowerCorner(), region.getUpperCorner());
 	} else {
-		// TODO:
+		_selectionMask.invert(region);
+		updateSelections();
+	}
+}
+
+void Modifier::subtract(const voxel::Region &region) {
+	if (_locked || !_selectionValid || !region.isValid()) {
+		return;
 	}
+	_selectionMask.subtract(region);
+	updateSelections();
+}
+
+void Modifier::intersect(const voxel::Region &region) {
+	if (_locked || !_selectionValid || !region.isValid()) {
+		return;
+	}
+	_selectionMask.intersect(region);
+	updateSelections();
+}
+
+void Modifier::updateSelections() {
+	_selectionMask.regions(_selections);
+	_selectionValid = !_selections.empty();
 }
 
 void Modifier::unselect() {
 	_selections.clear();
+	_selectionMask.clear();
 	_selectionValid = false;
 }
 
@@ -216,6 +257,7 @@ bool Modifier::select(const glm::ivec3 &mins, const glm::ivec3 &maxs) {
 		return false;
 	}
 	_selectionValid = true;
+	_selectionMask.add(sel);
 	for (size_t i = 0; i < _selections.size(); ++i) {
 		const Selection &s = _selections[i];
 		if (s.containsRegion(sel)) {
@@ -311,7 +353,13 @@ bool Modifier::execute(scenegraph::SceneGraph &sceneGraph, scenegraph::SceneGrap
 		const glm::ivec3 &mins = region.getLowerCorner();
 		const glm::ivec3 &maxs = region.getUpperCorner();
 		Log::debug("select mode mins: %i:%i:%i, maxs: %i:%i:%i", mins.x, mins.y, mins.z, maxs.x, maxs.y, maxs.z);
-		select(mins, maxs);
+		if (_selectMode == SelectMode::Subtract) {
+			subtract(region);
+		} else if (_selectMode == SelectMode::Intersect) {
+			intersect(region);
+		} else {
+			select(mins, maxs);
+		}
 		if (_selectionValid) {
 			callback(accumulate(_selections), _brushContext.modifierType, false);
 		}
@@ -399,7 +447,7 @@ bool Modifier::executeBrush(scenegraph::SceneGraph &sceneGraph, scenegraph::Scen
 							ModifierType modifierType, const voxel::Voxel &voxel,
 							const Callback &callback) {
 	if (Brush *brush = currentBrush()) {
-		ModifierVolumeWrapper wrapper(node, modifierType, _selections);
+		ModifierVolumeWrapper wrapper(node, modifierType, &_selectionMask);
 		voxel::Voxel prevVoxel = _brushContext.cursorVoxel;
 		glm::ivec3 prevCursorPos = _brushContext.cursorPosition;
 		if (brush->brushClamping()) {
@@ -20,6 +20,7 @@
 #include "voxedit-util/modifier/brush/ShapeBrush.h"
 #include "voxedit-util/modifier/brush/StampBrush.h"
 #include "voxedit-util/modifier/brush/TextBrush.h"
+#include "voxel/BitVolume.h"
 #include "voxel/Face.h"
 #include "voxel/RawVolume.h"
 #include "voxel/RawVolumeWrapper.h"
@@ -42,7 +43,12 @@ public:
 
 protected:
 	Selections _selections;
+	/**
+	 * @brief The voxels of all selections - the membership test doesn't depend on the amount of selections
+	 */
+	voxel::BitVolume _selectionMask;
 	bool _selectionValid = false;
+	SelectMode _selectMode = SelectMode::Add;
 	bool _selectStartPositionValid = false;
 	bool _locked = false;
 	/**
@@ -78,6 +84,10 @@ protected:
 		const voxel::Voxel &voxel, const Callback &callback = [](const voxel::Region &, ModifierType, bool) {});
 
 	voxel::Region calcSelectionRegion() const;
+	/**
+	 * @brief Rebuilds the selection boxes from the selection mask after voxels were removed from the selection
+	 */
+	void updateSelections();
 
 public:
 	Modifier(SceneManager *sceneMgr);
@@ -108,7 +118,18 @@ public:
 	virtual bool select(const glm::ivec3 &mins, const glm::ivec3 &maxs);
 	virtual void unselect();
 	virtual void invert(const voxel::Region &region);
+	/**
+	 * @brief Remove the given region from the current selection
+	 */
+	virtual void subtract(const voxel::Region &region);
+	/**
+	 * @brief Reduce the current selection to the given region
+	 */
+	virtual void intersect(const voxel::Region &region);
+	SelectMode selectMode() const;
+	void setSelectMode(SelectMode mode);
 	const Selections &selections() const;
+	const voxel::BitVolume &selectionMask() const;
 
 	ModifierType modifierType() const;
 	ModifierType setModifierType(ModifierType type);
@@ -289,8 +310,20 @@ inline const glm::ivec3 &Modifier::cursorPosition() const {
 	return _brushContext.cursorPosition;
 }
 
+inline SelectMode Modifier::selectMode() const {
+	return _selectMode;
+}
+
+inline void Modifier::setSelectMode(SelectMode mode) {
+	_selectMode = mode;
+}
+
 inline const Selections &Modifier::selections() const {
 	return _selections;
 }
 
+inline const voxel::BitVolume &Modifier::selectionMask() const {
+	return _selectionMask;
+}
+
 } // namespace voxedit
@@ -108,6 +108,18 @@ void ModifierFacade::updateBrushVolumePreview(palette::Palette &activePalette) {
 	}
 }
 
+bool ModifierFacade::updateBrushPreview(palette::Palette &activePalette) {
+	Brush *brush = currentBrush();
+	if (brush == nullptr || !brush->active()) {
+		return false;
+	}
+	if (brush->dirty()) {
+		updateBrushVolumePreview(activePalette);
+		brush->markClean();
+	}
+	return true;
+}
+
 void ModifierFacade::render(const video::Camera &camera, palette::Palette &activePalette) {
 	if (_locked) {
 		return;
@@ -150,11 +162,7 @@ void ModifierFacade::render(const video::Camera &camera, palette::Palette &activ
 		return;
 	}
 
-	if (brush && brush->active()) {
-		if (brush->dirty()) {
-			updateBrushVolumePreview(activePalette);
-			brush->markClean();
-		}
+	if (updateBrushPreview(activePalette)) {
 		video::polygonOffset(glm::vec3(-0.1f));
 		_modifierRenderer->renderBrushVolume(camera);
 		video::polygonOffset(glm::vec3(0.0f));
@@ -25,6 +25,11 @@ public:
 	ModifierFacade(SceneManager *sceneMgr, const ModifierRendererPtr &modifierRenderer);
 	bool init() override;
 	void shutdown() override;
+	/**
+	 * @brief Regenerates the preview volume of the current brush if it is active and dirty
+	 * @return @c false if there is no active brush that needs a preview
+	 */
+	bool updateBrushPreview(palette::Palette &activePalette);
 	void render(const video::Camera &camera, palette::Palette &activePalette);
 };
 
@@ -7,6 +7,7 @@
 #include "ModifierType.h"
 #include "Selection.h"
 #include "scenegraph/SceneGraphNode.h"
+#include "voxel/BitVolume.h"
 #include "voxel/RawVolumeWrapper.h"
 
 namespace voxedit {
@@ -15,13 +16,13 @@ namespace voxedit {
  * @brief A wrapper for a @c voxel::RawVolume that performs a sanity check for
  * the @c setVoxel() call and uses the @c ModifierType value to perform the
  * desired action for the @c setVoxel() call.
- * The sanity check also includes the @c Selections that are used to limit the
+ * The sanity check also includes the selection mask that is used to limit the
  * area of the @c voxel::RawVolume that is affected by the @c setVoxel() call.
  */
 class ModifierVolumeWrapper : public voxel::RawVolumeWrapper {
 private:
 	using Super = voxel::RawVolumeWrapper;
-	const Selections _selections;
+	const voxel::BitVolume *_selection;
 	const ModifierType _modifierType;
 	scenegraph::SceneGraphNode &_node;
 
@@ -34,15 +35,51 @@ private:
 		if (!_region.containsPoint(x, y, z)) {
 			return true;
 		}
-		if (_selections.empty()) {
+		if (_selection == nullptr) {
 			return false;
 		}
-		return !contains(_selections, x, y, z);
+		return !_selection->contains(x, y, z);
+	}
+
+	/**
+	 * @brief Applies the modifier type to all voxels of the given span - the span must already be clipped to the
+	 * region and the selection
+	 */
+	bool writeSpan(int x0, int x1, int y, int z, const voxel::Voxel &placeVoxel) {
+		voxel::RawVolume::Sampler sampler(_volume);
+		sampler.setPosition(x0, y, z);
+		int dirtyX0 = x1 + 1;
+		int dirtyX1 = x0 - 1;
+		for (int x = x0; x <= x1; ++x, sampler.movePositiveX()) {
+			const voxel::Voxel &existingVoxel = sampler.voxel();
+			// paint only touches existing voxels - place only fills air
+			if (!_force && voxel::isAir(existingVoxel.getMaterial()) == _paint) {
+				continue;
+			}
+			if (existingVoxel.isSame(placeVoxel)) {
+				continue;
+			}
+			sampler.setVoxel(placeVoxel);
+			dirtyX0 = core_min(dirtyX0, x);
+			dirtyX1 = x;
+		}
+		if (dirtyX0 > dirtyX1) {
+			return false;
+		}
+		addDirtyRegion(voxel::Region(dirtyX0, y, z, dirtyX1, y, z));
+		return true;
 	}
 
 public:
-	ModifierVolumeWrapper(scenegraph::SceneGraphNode &node, ModifierType modifierType, const Selections &selections = {})
-		: Super(node.volume()), _selections(selections), _modifierType(modifierType), _node(node) {
+	/**
+	 * @param selection The voxels that may be modified - @c nullptr or an empty mask allows to modify all voxels
+	 */
+	ModifierVolumeWrapper(scenegraph::SceneGraphNode &node, ModifierType modifierType,
+						  const voxel::BitVolume *selection = nullptr)
+		: Super(node.volume()), _selection(selection), _modifierType(modifierType), _node(node) {
+		if (_selection != nullptr && _selection->empty()) {
+			_selection = nullptr;
+		}
 		_erase = _modifierType == ModifierType::Erase;
 		_override = _modifierType == ModifierType::Override;
 		_paint = _modifierType == ModifierType::Paint;
@@ -68,7 +105,11 @@ public:
 		}
 	}
 
-	bool setVoxel(int x, int y, int z, const voxel::Voxel &voxel) override {
+	/**
+	 * @return @c true if @c setVoxel() would accept the given position for the modifier type, the region and the
+	 * selection
+	 */
+	bool canSetVoxel(int x, int y, int z) const {
 		if (!_force) {
 			const voxel::Voxel existingVoxel = this->voxel(x, y, z);
 			const bool empty = voxel::isAir(existingVoxel.getMaterial());
@@ -80,14 +121,76 @@ public:
 				return false;
 			}
 		}
+		return !skip(x, y, z);
+	}
+
+	bool setVoxel(int x, int y, int z, const voxel::Voxel &voxel) override {
+		if (!canSetVoxel(x, y, z)) {
+			return false;
+		}
 		voxel::Voxel placeVoxel = voxel;
 		if (_erase) {
 			placeVoxel = voxel::createVoxel(voxel::VoxelType::Air, 0);
 		}
-		if (skip(x, y, z)) {
+		return Super::setVoxel(x, y, z, placeVoxel);
+	}
+
+	/**
+	 * @brief Sets the voxels from @c x0 to @c x1 (inclusive) - the modifier type, the region and the selection are
+	 * only checked once for the whole span instead of once per voxel
+	 * @return @c true if at least one voxel was modified
+	 */
+	bool setVoxelSpan(int x0, int x1, int y, int z, const voxel::Voxel &voxel) {
+		if (!_region.containsPointInY(y) || !_region.containsPointInZ(z)) {
 			return false;
 		}
-		return Super::setVoxel(x, y, z, placeVoxel);
+		x0 = core_max(x0, _region.getLowerX());
+		x1 = core_min(x1, _region.getUpperX());
+		if (x0 > x1) {
+			return false;
+		}
+		const voxel::Voxel placeVoxel = _erase ? voxel::createVoxel(voxel::VoxelType::Air, 0) : voxel;
+		if (_selection == nullptr) {
+			return writeSpan(x0, x1, y, z, placeVoxel);
+		}
+		bool modified = false;
+		_selection->visitSpan(x0, x1, y, z, [&](int runX0, int runX1) {
+			modified |= writeSpan(runX0, runX1, y, z, placeVoxel);
+		});
+		return modified;
+	}
+
+	/**
+	 * @brief Sets all voxels of the given region span by span
+	 */
+	void fill(const voxel::Region &region, const voxel::Voxel &voxel) {
+		voxel::Region clipped = region;
+		if (!clipped.cropTo(_region)) {
+			return;
+		}
+		if (_selection != nullptr) {
+			const voxel::Voxel placeVoxel = _erase ? voxel::createVoxel(voxel::VoxelType::Air, 0) : voxel;
+			_selection->visitSpans(clipped, [&](int x0, int x1, int y, int z) { writeSpan(x0, x1, y, z, placeVoxel); });
+			return;
+		}
+		for (int z = clipped.getLowerZ(); z <= clipped.getUpperZ(); ++z) {
+			for (int y = clipped.getLowerY(); y <= clipped.getUpperY(); ++y) {
+				setVoxelSpan(clipped.getLowerX(), clipped.getUpperX(), y, z, voxel);
+			}
+		}
+	}
+
+	using Super::setVoxels;
+	/**
+	 * @brief Hides the per voxel version of @c voxel::RawVolumeWrapper to let the shape generators emit spans
+	 */
+	bool setVoxels(int x, int y, int z, int nx, int nz, const voxel::Voxel *voxels, int amount) {
+		for (int k = 0; k < nz; ++k) {
+			for (int ny = 0; ny < amount; ++ny) {
+				setVoxelSpan(x, x + nx - 1, y + ny, z + k, voxels[ny]);
+			}
+		}
+		return true;
 	}
 };
 
@@ -12,14 +12,19 @@ namespace voxedit {
 using Selection = voxel::Region;
 using Selections = core::DynamicArray<Selection>;
 
-inline bool contains(const Selections &selections, int x, int y, int z) {
-	for (const Selection &sel : selections) {
-		if (sel.containsPoint(x, y, z)) {
-			return true;
-		}
-	}
-	return false;
-}
+/**
+ * @brief How a new selection region is combined with the existing selection
+ */
+enum class SelectMode : uint8_t {
+	/** add the region to the selection */
+	Add,
+	/** remove the region from the selection */
+	Subtract,
+	/** only keep the part of the selection that is inside the region */
+	Intersect,
+
+	Max
+};
 
 inline voxel::Region accumulate(const Selections &selections) {
 	if (selections.empty()) {
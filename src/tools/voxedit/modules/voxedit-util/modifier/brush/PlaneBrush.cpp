@@ -92,7 +92,11 @@ void PlaneBrush::generate(scenegraph::SceneGraph &sceneGraph, ModifierVolumeWrap
 		_aabbFace = context.cursorFace;
 	}
 	if (context.modifierType == ModifierType::Place) {
-		voxelutil::extrudePlane(wrapper, _initialPlanePos, _aabbFace, _hitVoxel, context.cursorVoxel, thickness);
+		// every layer is walked first and then written span by span
+		auto canPlace = [&](const glm::ivec3 &pos) { return wrapper.canSetVoxel(pos.x, pos.y, pos.z); };
+		auto writeSpan = [&](int x0, int x1, int y, int z) { wrapper.setVoxelSpan(x0, x1, y, z, context.cursorVoxel); };
+		voxelutil::extrudePlane(*wrapper.volume(), _initialPlanePos, _aabbFace, _hitVoxel, context.cursorVoxel,
+								thickness, canPlace, writeSpan);
 	} else if (context.modifierType == ModifierType::Erase) {
 		// TODO: support erasing more than one voxel - support thickness
 		voxelutil::erasePlane(wrapper, _initialPlanePos, _aabbFace, _hitVoxel);
@@ -85,7 +85,7 @@ void ShapeBrush::generate(scenegraph::SceneGraph &sceneGraph, ModifierVolumeWrap
 	const voxel::Voxel &voxel = context.cursorVoxel;
 	switch (_shapeType) {
 	case ShapeType::AABB:
-		voxelgenerator::shape::createCubeNoCenter(wrapper, region.getLowerCorner(), dimensions, voxel);
+		wrapper.fill(region, voxel);
 		break;
 	case ShapeType::Torus: {
 		const double minorRadius = size / 5.0;
@@ -106,6 +106,74 @@ TEST_F(ModifierTest, testModifierSelection) {
 	modifier.shutdown();
 }
 
+TEST_F(ModifierTest, testModifierSelectModes) {
+	const voxel::Region region(-10, 10);
+	voxel::RawVolume volume(region);
+
+	SceneManager mgr(core::make_shared<core::TimeProvider>(), _testApp->filesystem(),
+					 core::make_shared<ISceneRenderer>(), core::make_shared<IModifierRenderer>());
+	Modifier modifier(&mgr);
+	ASSERT_TRUE(modifier.init());
+	select(volume, modifier, glm::ivec3(-3), glm::ivec3(3));
+
+	modifier.setSelectMode(SelectMode::Subtract);
+	prepare(modifier, glm::ivec3(0), glm::ivec3(3), ModifierType::Select, BrushType::None);
+	scenegraph::SceneGraph sceneGraph;
+	scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
+	node.setVolume(&volume, false);
+	int executed = 0;
+	EXPECT_TRUE(modifier.execute(sceneGraph, node, [&](const voxel::Region &, ModifierType, bool) { ++executed; }));
+	modifier.stop();
+	EXPECT_EQ(1, executed);
+	const voxel::BitVolume &mask = modifier.selectionMask();
+	EXPECT_TRUE(mask.contains(-3, -3, -3));
+	EXPECT_TRUE(mask.contains(-1, 3, 3));
+	EXPECT_FALSE(mask.contains(0, 0, 0));
+	EXPECT_FALSE(mask.contains(3, 3, 3));
+	EXPECT_EQ(voxel::Region(glm::ivec3(-3), glm::ivec3(3)), accumulate(modifier.selections()));
+
+	modifier.setSelectMode(SelectMode::Intersect);
+	prepare(modifier, glm::ivec3(-1), glm::ivec3(1), ModifierType::Select, BrushType::None);
+	EXPECT_TRUE(modifier.execute(sceneGraph, node, [&](const voxel::Region &, ModifierType, bool) { ++executed; }));
+	modifier.stop();
+	EXPECT_EQ(2, executed);
+	EXPECT_TRUE(mask.contains(-1, -1, -1));
+	EXPECT_FALSE(mask.contains(-2, -2, -2));
+	EXPECT_FALSE(mask.contains(1, 1, 1));
+	EXPECT_EQ(voxel::Region(glm::ivec3(-1), glm::ivec3(1)), accumulate(modifier.selections()));
+
+	modifier.intersect(voxel::Region(glm::ivec3(5), glm::ivec3(6)));
+	EXPECT_TRUE(mask.empty());
+	EXPECT_TRUE(modifier.selections().empty());
+	modifier.shutdown();
+}
+
+TEST_F(ModifierTest, testModifierInvertSelection) {
+	const voxel::Region region(-10, 10);
+	voxel::RawVolume volume(region);
+
+	SceneManager mgr(core::make_shared<core::TimeProvider>(), _testApp->filesystem(),
+					 core::make_shared<ISceneRenderer>(), core::make_shared<IModifierRenderer>());
+	Modifier modifier(&mgr);
+	ASSERT_TRUE(modifier.init());
+	select(volume, modifier, glm::ivec3(-1), glm::ivec3(1));
+	modifier.invert(region);
+	const voxel::BitVolume &mask = modifier.selectionMask();
+	EXPECT_FALSE(mask.contains(0, 0, 0));
+	EXPECT_FALSE(mask.contains(1, 1, 1));
+	EXPECT_TRUE(mask.contains(2, 0, 0));
+	EXPECT_TRUE(mask.contains(-10, -10, -10));
+	EXPECT_TRUE(mask.contains(10, 10, 10));
+	EXPECT_EQ(region, accumulate(modifier.selections()));
+	for (const Selection &sel : modifier.selections()) {
+		EXPECT_FALSE(voxel::intersects(sel, voxel::Region(glm::ivec3(-1), glm::ivec3(1))));
+	}
+
+	modifier.invert(region);
+	EXPECT_EQ(voxel::Region(glm::ivec3(-1), glm::ivec3(1)), accumulate(modifier.selections()));
+	modifier.shutdown();
+}
+
 TEST_F(ModifierTest, testClamp) {
 	scenegraph::SceneGraph sceneGraph;
 	SceneManager mgr(core::make_shared<core::TimeProvider>(), _testApp->filesystem(),
@@ -0,0 +1,105 @@
+/**
+ * @file
+ */
+
+#include "voxedit-util/modifier/ModifierVolumeWrapper.h"
+#include "app/tests/AbstractTest.h"
+#include "scenegraph/SceneGraphNode.h"
+#include "voxel/BitVolume.h"
+#include "voxel/RawVolume.h"
+
+namespace voxedit {
+
+class ModifierVolumeWrapperTest : public app::AbstractTest {
+protected:
+	const voxel::Region _region{0, 15};
+
+	// every second column is solid to get mixed spans for all modifier types
+	void prepare(voxel::RawVolume &volume) {
+		const voxel::Voxel existing = voxel::createVoxel(voxel::VoxelType::Generic, 2);
+		for (int z = 0; z < 16; ++z) {
+			for (int y = 0; y < 16; ++y) {
+				for (int x = 0; x < 16; x += 2) {
+					volume.setVoxel(x, y, z, existing);
+				}
+			}
+		}
+	}
+
+	/**
+	 * @brief Fills the same region with spans and with single voxels and compares the results
+	 */
+	void testSpan(ModifierType modifierType, const voxel::BitVolume *selection) {
+		const voxel::Voxel voxel = voxel::createVoxel(voxel::VoxelType::Generic, 1);
+		const voxel::Region fillRegion(glm::ivec3(-3, 2, 4), glm::ivec3(12, 9, 20));
+
+		voxel::RawVolume spanVolume(_region);
+		prepare(spanVolume);
+		scenegraph::SceneGraphNode spanNode(scenegraph::SceneGraphNodeType::Model);
+		spanNode.setVolume(&spanVolume, false);
+		ModifierVolumeWrapper spanWrapper(spanNode, modifierType, selection);
+		spanWrapper.fill(fillRegion, voxel);
+
+		voxel::RawVolume voxelVolume(_region);
+		prepare(voxelVolume);
+		scenegraph::SceneGraphNode voxelNode(scenegraph::SceneGraphNodeType::Model);
+		voxelNode.setVolume(&voxelVolume, false);
+		ModifierVolumeWrapper voxelWrapper(voxelNode, modifierType, selection);
+		for (int z = fillRegion.getLowerZ(); z <= fillRegion.getUpperZ(); ++z) {
+			for (int y = fillRegion.getLowerY(); y <= fillRegion.getUpperY(); ++y) {
+				for (int x = fillRegion.getLowerX(); x <= fillRegion.getUpperX(); ++x) {
+					voxelWrapper.setVoxel(x, y, z, voxel);
+				}
+			}
+		}
+
+		EXPECT_EQ(voxelWrapper.dirtyRegion(), spanWrapper.dirtyRegion());
+		for (int z = _region.getLowerZ(); z <= _region.getUpperZ(); ++z) {
+			for (int y = _region.getLowerY(); y <= _region.getUpperY(); ++y) {
+				for (int x = _region.getLowerX(); x <= _region.getUpperX(); ++x) {
+					ASSERT_EQ(voxelVolume.voxel(x, y, z), spanVolume.voxel(x, y, z)) << x << ":" << y << ":" << z;
+				}
+			}
+		}
+	}
+};
+
+TEST_F(ModifierVolumeWrapperTest, testSpanPlace) {
+	testSpan(ModifierType::Place, nullptr);
+}
+
+TEST_F(ModifierVolumeWrapperTest, testSpanErase) {
+	testSpan(ModifierType::Erase, nullptr);
+}
+
+TEST_F(ModifierVolumeWrapperTest, testSpanOverride) {
+	testSpan(ModifierType::Override, nullptr);
+}
+
+TEST_F(ModifierVolumeWrapperTest, testSpanPaint) {
+	testSpan(ModifierType::Paint, nullptr);
+}
+
+TEST_F(ModifierVolumeWrapperTest, testSpanSelection) {
+	voxel::BitVolume selection;
+	selection.add(voxel::Region(glm::ivec3(1, 0, 0), glm::ivec3(5, 15, 15)));
+	selection.add(voxel::Region(glm::ivec3(9, 3, 6), glm::ivec3(13, 7, 9)));
+	selection.set(3, 4, 5, false);
+	testSpan(ModifierType::Place, &selection);
+	testSpan(ModifierType::Override, &selection);
+}
+
+TEST_F(ModifierVolumeWrapperTest, testSpanOutside) {
+	voxel::RawVolume volume(_region);
+	scenegraph::SceneGraphNode node(scenegraph::SceneGraphNodeType::Model);
+	node.setVolume(&volume, false);
+	ModifierVolumeWrapper wrapper(node, ModifierType::Place);
+	const voxel::Voxel voxel = voxel::createVoxel(voxel::VoxelType::Generic, 1);
+	EXPECT_FALSE(wrapper.setVoxelSpan(-10, -1, 0, 0, voxel));
+	EXPECT_FALSE(wrapper.setVoxelSpan(0, 15, 16, 0, voxel));
+	EXPECT_FALSE(wrapper.dirtyRegion().isValid());
+	EXPECT_TRUE(wrapper.setVoxelSpan(-10, 30, 0, 0, voxel));
+	EXPECT_EQ(voxel::Region(glm::ivec3(0, 0, 0), glm::ivec3(15, 0, 0)), wrapper.dirtyRegion());
+}
+
+} // namespace voxedit